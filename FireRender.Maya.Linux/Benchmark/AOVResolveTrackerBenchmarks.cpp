@@ -0,0 +1,219 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "Context/AOVResolveTracker.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	const int AOVCount = 8;
+	const int DisplayedAOV = 0;
+	const int PassCount = 32;
+	const int ImageSide = 512;
+
+	// Resolve copies the raw frame buffer into the resolved one, as the tone mapping resolve does on CPU
+	class StandInFrameBuffers : public AOVResolveTracker::FrameBufferSource
+	{
+	public:
+		explicit StandInFrameBuffers(int side) :
+			m_raw(AOVCount, BenchmarkScenes::MakeImage(side, side, 4, 11)),
+			m_resolved(AOVCount, std::vector<float>(size_t(side) * side * 4)),
+			m_resolveCount(0),
+			m_readbackCount(0),
+			m_resolvesPerAOV(AOVCount, 0)
+		{
+		}
+
+		void ResolveAOV(int aov) override
+		{
+			std::memcpy(m_resolved[aov].data(), m_raw[aov].data(), m_raw[aov].size() * sizeof(float));
+			m_resolveCount++;
+			m_resolvesPerAOV[aov]++;
+		}
+
+		void Read(int aov, std::vector<float>& pixels)
+		{
+			std::memcpy(pixels.data(), m_resolved[aov].data(), pixels.size() * sizeof(float));
+			m_readbackCount++;
+		}
+
+		std::vector<std::vector<float>> m_raw;
+		std::vector<std::vector<float>> m_resolved;
+		int m_resolveCount;
+		int m_readbackCount;
+		std::vector<int> m_resolvesPerAOV;
+	};
+
+	// Production render with NorthStar: each pass the buffer callback and RenderFullFrame both read
+	// the render view AOV, RenderFullFrame used to read every enabled AOV.
+	void ReadPass(StandInFrameBuffers& buffers, AOVResolveTracker* tracker, std::vector<std::vector<float>>& pixels, const void* consumer)
+	{
+		auto read = [&](int aov)
+		{
+			AOVResolveTracker::ReadbackTicket ticket;
+
+			if (tracker)
+			{
+				if (!tracker->BeginReadback(consumer, aov, 0, ticket))
+					return;
+
+				tracker->Resolve(aov, buffers);
+			}
+			else
+			{
+				buffers.ResolveAOV(aov);
+			}
+
+			buffers.Read(aov, pixels[aov]);
+
+			if (tracker)
+				tracker->EndReadback(ticket);
+		};
+
+		// buffer available callback
+		read(DisplayedAOV);
+
+		// RenderFullFrame
+		for (int aov = 0; aov < AOVCount; aov++)
+		{
+			if (tracker && !tracker->IsSubscribed(aov))
+				continue;
+
+			read(aov);
+		}
+	}
+
+	// Passes of a render, then all AOVs once the render is finished
+	void RenderPasses(StandInFrameBuffers& buffers, AOVResolveTracker* tracker, std::vector<std::vector<float>>& pixels, const void* consumer)
+	{
+		for (int pass = 0; pass < PassCount; pass++)
+		{
+			if (tracker)
+				tracker->AdvanceGeneration();
+
+			ReadPass(buffers, tracker, pixels, consumer);
+		}
+
+		for (int aov = 0; tracker && aov < AOVCount; aov++)
+		{
+			AOVResolveTracker::ReadbackTicket ticket;
+
+			if (tracker->BeginReadback(consumer, aov, 0, ticket))
+			{
+				tracker->Resolve(aov, buffers);
+				buffers.Read(aov, pixels[aov]);
+				tracker->EndReadback(ticket);
+			}
+		}
+	}
+
+	void RunPasses(Benchmark::State& state, bool tracked)
+	{
+		StandInFrameBuffers buffers(ImageSide);
+		AOVResolveTracker tracker;
+		std::vector<std::vector<float>> pixels(AOVCount, std::vector<float>(size_t(ImageSide) * ImageSide * 4));
+
+		const void* consumer = &pixels;
+		tracker.Subscribe(consumer, DisplayedAOV);
+
+		state.Start();
+		RenderPasses(buffers, tracked ? &tracker : nullptr, pixels, consumer);
+		state.Stop();
+
+		state.SetCounter("resolves", double(buffers.m_resolveCount));
+		state.SetCounter("readbacks", double(buffers.m_readbackCount));
+	}
+}
+
+BENCHMARK("AOVResolve/everyAOVEveryRead", [](Benchmark::State& state)
+{
+	RunPasses(state, false);
+});
+
+BENCHMARK("AOVResolve/tracked", [](Benchmark::State& state)
+{
+	RunPasses(state, true);
+});
+
+TEST("AOVResolve/oncePerFrameForConsumers", [](Benchmark::State& state)
+{
+	const int side = 16;
+
+	StandInFrameBuffers buffers(side);
+	AOVResolveTracker tracker;
+	std::vector<std::vector<float>> pixels(AOVCount, std::vector<float>(size_t(side) * side * 4));
+
+	const void* consumer = &pixels;
+	tracker.Subscribe(consumer, DisplayedAOV);
+
+	RenderPasses(buffers, &tracker, pixels, consumer);
+
+	// the displayed AOV is resolved and read once per pass although it is read twice,
+	// the others only once the render is finished
+	CHECK(buffers.m_resolvesPerAOV[DisplayedAOV] == PassCount);
+
+	for (int aov = 0; aov < AOVCount; aov++)
+	{
+		if (aov != DisplayedAOV)
+			CHECK(buffers.m_resolvesPerAOV[aov] == 1);
+	}
+
+	CHECK(buffers.m_readbackCount == PassCount + AOVCount - 1);
+	CHECK(pixels[AOVCount - 1] == buffers.m_raw[AOVCount - 1]);
+
+	// a second consumer of the same frame doesn't resolve again
+	int otherConsumer = 0;
+	AOVResolveTracker::ReadbackTicket ticket;
+
+	CHECK(tracker.BeginReadback(&otherConsumer, DisplayedAOV, 0, ticket));
+	CHECK(!tracker.Resolve(DisplayedAOV, buffers));
+	tracker.EndReadback(ticket);
+
+	CHECK(buffers.m_resolvesPerAOV[DisplayedAOV] == PassCount);
+});
+
+TEST("AOVResolve/failedReadRetried", [](Benchmark::State& state)
+{
+	AOVResolveTracker tracker;
+	int consumer = 0;
+
+	AOVResolveTracker::ReadbackTicket ticket;
+
+	// the read failed and wasn't ended: the pixels aren't current
+	CHECK(tracker.BeginReadback(&consumer, DisplayedAOV, 7, ticket));
+	CHECK(tracker.BeginReadback(&consumer, DisplayedAOV, 7, ticket));
+
+	tracker.EndReadback(ticket);
+	CHECK(!tracker.BeginReadback(&consumer, DisplayedAOV, 7, ticket));
+
+	// another request is read again
+	CHECK(tracker.BeginReadback(&consumer, DisplayedAOV, 8, ticket));
+
+	// a read which ends after the frame moved on is stale
+	tracker.AdvanceGeneration();
+	CHECK(tracker.BeginReadback(&consumer, DisplayedAOV, 7, ticket));
+	tracker.AdvanceGeneration();
+	tracker.EndReadback(ticket);
+	CHECK(tracker.BeginReadback(&consumer, DisplayedAOV, 7, ticket));
+
+	tracker.EndReadback(ticket);
+	CHECK(!tracker.BeginReadback(&consumer, DisplayedAOV, 7, ticket));
+
+	// recreated frame buffers are read again
+	tracker.Invalidate(DisplayedAOV);
+	CHECK(tracker.BeginReadback(&consumer, DisplayedAOV, 7, ticket));
+});
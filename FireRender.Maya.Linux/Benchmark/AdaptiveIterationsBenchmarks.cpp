@@ -0,0 +1,193 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "Context/AdaptiveIterations.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Simulated render call: fixed per call overhead (readback, display) plus a cost per iteration with jitter
+	struct SimulatedScene
+	{
+		double callOverheadMs;
+		double iterationMs;
+	};
+
+	const SimulatedScene LightScene = { 4.0, 0.5 };
+	const SimulatedScene HeavyScene = { 4.0, 30.0 };
+
+	// 4 ms overhead, 1 ms per iteration, no smoothing: doubling from 1 to 32, then the fitting count.
+	// At 35 iterations a call takes 39 ms and floor(40 / (39 / 35)) = 35 keeps it there.
+	const SimulatedScene RampScene = { 4.0, 1.0 };
+	const int RampIterations[] = { 1, 2, 4, 8, 16, 32, 35, 35, 35 };
+
+	// Calls which follow a scene or camera change, the rest continue accumulating
+	bool IsInteraction(int call)
+	{
+		// camera is dragged for 30 calls, then the view is left alone for 100 calls
+		return call % 130 < 30;
+	}
+
+	enum class Mode
+	{
+		Fixed,			// one iteration per call
+		PowerOf2,		// 1, 2, 4 ... 32 after each restart
+		Adaptive
+	};
+
+	void Simulate(Benchmark::State& state, const SimulatedScene& scene, Mode mode)
+	{
+		const int CallCount = 1300;
+
+		AdaptiveIterations::Settings settings;
+		AdaptiveIterations::State controller;
+		BenchmarkScenes::Random random(5);
+
+		int powerOf2 = 1;
+		double totalMs = 0.0;
+		double worstInteractionMs = 0.0;
+		double idleIterations = 0.0;
+
+		state.Start();
+
+		for (int call = 0; call < CallCount; call++)
+		{
+			bool interaction = IsInteraction(call);
+
+			if (interaction)
+			{
+				controller = AdaptiveIterations::Interact(settings, controller);
+				powerOf2 = 1;
+			}
+
+			int iterations = 1;
+			if (mode == Mode::PowerOf2)
+				iterations = powerOf2;
+			else if (mode == Mode::Adaptive)
+				iterations = controller.iterations;
+
+			double jitter = 0.8 + 0.4 * random.NextFloat();
+			double callMs = scene.callOverheadMs + iterations * scene.iterationMs * jitter;
+
+			controller.iterations = iterations;
+			controller = AdaptiveIterations::Update(settings, controller, callMs);
+			powerOf2 = std::min(powerOf2 * 2, 32);
+
+			totalMs += callMs;
+
+			if (interaction)
+				worstInteractionMs = std::max(worstInteractionMs, callMs);
+			else
+				idleIterations += iterations;
+		}
+
+		state.Stop();
+
+		state.SetCounter("meanRefreshMs", totalMs / CallCount);
+		state.SetCounter("worstInteractionMs", worstInteractionMs);
+		state.SetCounter("idleIterationsPerSecond", idleIterations * 1000.0 / totalMs);
+	}
+
+	// Timing of one call without jitter
+	double CallMilliseconds(const SimulatedScene& scene, int iterations)
+	{
+		return scene.callOverheadMs + iterations * scene.iterationMs;
+	}
+}
+
+TEST("AdaptiveIterations/rampsUpToTarget", [](Benchmark::State& state)
+{
+	AdaptiveIterations::Settings settings;
+	settings.smoothing = 1.0;
+
+	AdaptiveIterations::State controller;
+
+	for (int expected : RampIterations)
+	{
+		CHECK(controller.iterations == expected);
+		controller = AdaptiveIterations::Update(settings, controller, CallMilliseconds(RampScene, controller.iterations));
+		CHECK(CallMilliseconds(RampScene, controller.iterations) <= settings.targetMilliseconds);
+	}
+
+	// interaction restarts from the minimum but keeps the estimate, so the ramp is bounded by growth only
+	controller = AdaptiveIterations::Interact(settings, controller);
+	CHECK(controller.iterations == settings.minIterations);
+	CHECK(controller.millisecondsPerIteration > 0.0);
+
+	controller = AdaptiveIterations::Update(settings, controller, CallMilliseconds(RampScene, controller.iterations));
+	CHECK(controller.iterations == 2);
+});
+
+TEST("AdaptiveIterations/limits", [](Benchmark::State& state)
+{
+	AdaptiveIterations::Settings settings;
+	AdaptiveIterations::State controller;
+
+	// cheap scene saturates at maxIterations
+	for (int call = 0; call < 20; call++)
+		controller = AdaptiveIterations::Update(settings, controller, CallMilliseconds(LightScene, controller.iterations));
+
+	CHECK(controller.iterations == settings.maxIterations);
+
+	// heavy scene never goes above one iteration even though a single one is over target
+	controller = AdaptiveIterations::State();
+	for (int call = 0; call < 20; call++)
+	{
+		controller = AdaptiveIterations::Update(settings, controller, CallMilliseconds(HeavyScene, controller.iterations));
+		CHECK(controller.iterations == settings.minIterations);
+	}
+
+	// zero time per call: growth limit still applies
+	controller = AdaptiveIterations::State();
+	controller = AdaptiveIterations::Update(settings, controller, 0.0);
+	CHECK(controller.iterations == 2);
+
+	// invalid measurements leave the state alone
+	controller.iterations = 8;
+	controller.millisecondsPerIteration = 3.0;
+	AdaptiveIterations::State unchanged = AdaptiveIterations::Update(settings, controller, -1.0);
+	CHECK(unchanged.iterations == 8 && unchanged.millisecondsPerIteration == 3.0);
+
+	unchanged = AdaptiveIterations::Update(settings, controller, std::nan(""));
+	CHECK(unchanged.iterations == 8 && unchanged.millisecondsPerIteration == 3.0);
+});
+
+TEST("AdaptiveIterations/slowCallsCorrectAtOnce", [](Benchmark::State& state)
+{
+	AdaptiveIterations::Settings settings;
+
+	// 32 iterations at 1 ms each, then the scene becomes 10 times heavier
+	AdaptiveIterations::State controller;
+	controller.iterations = 32;
+	controller.millisecondsPerIteration = 1.0;
+
+	controller = AdaptiveIterations::Update(settings, controller, 320.0);
+	CHECK(controller.millisecondsPerIteration == 10.0);
+	CHECK(controller.iterations == 4);
+
+	// getting cheaper again is smoothed: 10 + 0.5 * (2 - 10) = 6 ms, floor(40 / 6) = 6 iterations
+	controller = AdaptiveIterations::Update(settings, controller, 8.0);
+	CHECK(controller.millisecondsPerIteration == 6.0);
+	CHECK(controller.iterations == 6);
+});
+
+BENCHMARK("AdaptiveIterations/lightFixed", [](Benchmark::State& state) { Simulate(state, LightScene, Mode::Fixed); });
+BENCHMARK("AdaptiveIterations/lightPowerOf2", [](Benchmark::State& state) { Simulate(state, LightScene, Mode::PowerOf2); });
+BENCHMARK("AdaptiveIterations/lightAdaptive", [](Benchmark::State& state) { Simulate(state, LightScene, Mode::Adaptive); });
+BENCHMARK("AdaptiveIterations/heavyFixed", [](Benchmark::State& state) { Simulate(state, HeavyScene, Mode::Fixed); });
+BENCHMARK("AdaptiveIterations/heavyPowerOf2", [](Benchmark::State& state) { Simulate(state, HeavyScene, Mode::PowerOf2); });
+BENCHMARK("AdaptiveIterations/heavyAdaptive", [](Benchmark::State& state) { Simulate(state, HeavyScene, Mode::Adaptive); });
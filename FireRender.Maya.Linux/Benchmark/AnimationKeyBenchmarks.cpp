@@ -0,0 +1,308 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "AnimationKeyReduction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	const int AnimatedTransformCount = 2000;
+	const int FrameCount = 240;
+	const double FramesPerSecond = 24.0;
+
+	struct Track
+	{
+		std::vector<float> times;
+		std::vector<float> values;
+		int components;
+		float restValue[4];
+	};
+
+	// Per transform: keyed translation, rotation and scale curves with overlapping key times,
+	// the way AnimationExporter sees them before sampling
+	std::vector<AnimationKeys::TimeKey> MakeCurveKeys(BenchmarkScenes::Random& random)
+	{
+		std::vector<AnimationKeys::TimeKey> keys;
+
+		for (unsigned int track = 0; track < 3; track++)
+		{
+			for (int curve = 0; curve < 3; curve++)
+			{
+				int step = 1 + int(random.Next() % 8);
+
+				for (int frame = 0; frame <= FrameCount; frame += step)
+					keys.push_back({ frame / FramesPerSecond, 1u << track });
+			}
+		}
+
+		return keys;
+	}
+
+	// Every frame sampled: a third of tracks constant at rest, a third linear, a third smooth motion
+	std::vector<Track> MakeSampledTracks(int transformCount, uint32_t seed)
+	{
+		BenchmarkScenes::Random random(seed);
+		std::vector<Track> tracks;
+
+		for (int i = 0; i < transformCount * 3; i++)
+		{
+			Track track;
+			track.components = (i % 3 == 1) ? 4 : 3;
+
+			int kind = int(random.Next() % 3);
+			float phase = random.NextFloat();
+
+			for (int c = 0; c < 4; c++)
+				track.restValue[c] = random.NextFloat();
+
+			for (int frame = 0; frame <= FrameCount; frame++)
+			{
+				float t = float(frame / FramesPerSecond);
+				track.times.push_back(t);
+
+				for (int c = 0; c < track.components; c++)
+				{
+					float value = track.restValue[c];
+
+					if (kind == 1)
+						value += 0.5f * t;
+					else if (kind == 2)
+						value += std::sin(2.0f * t + phase + c);
+
+					track.values.push_back(value);
+				}
+			}
+
+			tracks.push_back(track);
+		}
+
+		return tracks;
+	}
+
+	// Same loop as AnimationExporter::ReduceAndAddAnimations
+	void ReduceTracks(std::vector<Track>& tracks, std::vector<char>& keepTrack)
+	{
+		const int trackCount = int(tracks.size());
+		keepTrack.assign(trackCount, 0);
+
+#pragma omp parallel for schedule(dynamic, 8)
+		for (int i = 0; i < trackCount; i++)
+		{
+			Track& track = tracks[i];
+
+			keepTrack[i] = AnimationKeys::ReduceTrack(track.times, track.values, track.components,
+				track.restValue, 1e-5f) == AnimationKeys::TrackReduction::Keep;
+		}
+	}
+
+	// Largest difference between the original keys and linear interpolation of the reduced track,
+	// -1 if reduced keys are not a subset of the original ones or the end keys were dropped
+	double MaxReductionError(const Track& original, const Track& reduced)
+	{
+		const int components = original.components;
+
+		if (reduced.times.size() < 2 ||
+			reduced.times.front() != original.times.front() ||
+			reduced.times.back() != original.times.back())
+		{
+			return -1.0;
+		}
+
+		double maxError = 0.0;
+		size_t segment = 0;
+
+		for (size_t key = 0; key < original.times.size(); key++)
+		{
+			double t = original.times[key];
+
+			while (segment + 2 < reduced.times.size() && reduced.times[segment + 1] <= t)
+				segment++;
+
+			double t0 = reduced.times[segment];
+			double t1 = reduced.times[segment + 1];
+			double s = (t - t0) / (t1 - t0);
+
+			for (int c = 0; c < components; c++)
+			{
+				double v0 = reduced.values[segment * components + c];
+				double v1 = reduced.values[(segment + 1) * components + c];
+				double v = original.values[key * components + c];
+
+				// kept keys must carry their original values
+				if ((t == t0 && v != v0) || (t == t1 && v != v1))
+					return -1.0;
+
+				maxError = std::max(maxError, std::fabs(v0 + (v1 - v0) * s - v));
+			}
+		}
+
+		return maxError;
+	}
+
+	Track MakeTrack(int components, int keyCount)
+	{
+		Track track;
+		track.components = components;
+		std::fill(track.restValue, track.restValue + 4, 0.0f);
+
+		for (int key = 0; key < keyCount; key++)
+			track.times.push_back(float(key / FramesPerSecond));
+
+		track.values.assign(size_t(keyCount) * components, 0.0f);
+
+		return track;
+	}
+}
+
+TEST("AnimationKeys/reductionErrorBound", [](Benchmark::State& state)
+{
+	const float tolerance = 1e-3f;
+
+	std::vector<Track> tracks = MakeSampledTracks(200, 11);
+	size_t inputKeys = 0;
+	size_t keptKeys = 0;
+
+	for (const Track& original : tracks)
+	{
+		Track reduced = original;
+		AnimationKeys::ReduceLinear(reduced.times, reduced.values, reduced.components, tolerance);
+
+		CHECK(reduced.values.size() == reduced.times.size() * reduced.components);
+
+		double maxError = MaxReductionError(original, reduced);
+		CHECK(maxError >= 0.0);
+
+		// slopes are computed in double from float keys, allow for float rounding of the values
+		CHECK(maxError <= tolerance * (1.0 + 1e-4) + 1e-6);
+
+		inputKeys += original.times.size();
+		keptKeys += reduced.times.size();
+	}
+
+	// the smooth tracks still need most keys, linear and constant ones collapse to two
+	CHECK(keptKeys < inputKeys / 2);
+});
+
+TEST("AnimationKeys/reduceTrackCases", [](Benchmark::State& state)
+{
+	// constant at rest: dropped
+	Track track = MakeTrack(3, 10);
+	CHECK(AnimationKeys::ReduceTrack(track.times, track.values, 3, track.restValue, 1e-5f) == AnimationKeys::TrackReduction::Drop);
+
+	// constant away from rest: kept as the two end keys
+	track = MakeTrack(3, 10);
+	std::fill(track.values.begin(), track.values.end(), 2.0f);
+	CHECK(AnimationKeys::ReduceTrack(track.times, track.values, 3, track.restValue, 1e-5f) == AnimationKeys::TrackReduction::Keep);
+	CHECK(track.times.size() == 2);
+	CHECK(track.values.size() == 6);
+
+	// no rest value: constant tracks are always kept
+	track = MakeTrack(3, 10);
+	CHECK(AnimationKeys::ReduceTrack(track.times, track.values, 3, nullptr, 1e-5f) == AnimationKeys::TrackReduction::Keep);
+	CHECK(track.times.size() == 2);
+
+	// a corner in one component of a quaternion track keeps exactly the corner key
+	track = MakeTrack(4, 9);
+	for (int key = 0; key < 9; key++)
+		track.values[key * 4 + 2] = float(4 - std::abs(key - 4));
+
+	Track original = track;
+	AnimationKeys::ReduceLinear(track.times, track.values, 4, 1e-5f);
+	CHECK(track.times.size() == 3);
+	CHECK(track.times[1] == original.times[4]);
+	CHECK(MaxReductionError(original, track) <= 1e-5);
+
+	// NaN keys are never interpolated over
+	track = MakeTrack(1, 5);
+	track.values[2] = std::numeric_limits<float>::quiet_NaN();
+	AnimationKeys::ReduceLinear(track.times, track.values, 1, 1e-5f);
+	CHECK(track.times.size() >= 3);
+	CHECK(std::find(track.times.begin(), track.times.end(), float(2 / FramesPerSecond)) != track.times.end());
+});
+
+TEST("AnimationKeys/sortAndMergeMasks", [](Benchmark::State& state)
+{
+	std::vector<AnimationKeys::TimeKey> keys;
+	keys.push_back({ 2.0, 1u });
+	keys.push_back({ 1.0, 2u });
+	keys.push_back({ 2.0 + AnimationKeys::TimeEpsilon * 0.5, 4u });
+	keys.push_back({ 1.0, 1u });
+	keys.push_back({ 0.5, 4u });
+
+	AnimationKeys::SortAndMerge(keys);
+
+	CHECK(keys.size() == 3);
+	CHECK(keys[0].time == 0.5 && keys[0].trackMask == 4u);
+	CHECK(keys[1].time == 1.0 && keys[1].trackMask == 3u);
+	CHECK(keys[2].time == 2.0 && keys[2].trackMask == 5u);
+});
+
+BENCHMARK("AnimationKeys/sortAndMerge", [](Benchmark::State& state)
+{
+	BenchmarkScenes::Random random(3);
+
+	std::vector<std::vector<AnimationKeys::TimeKey>> transforms;
+	for (int i = 0; i < AnimatedTransformCount; i++)
+		transforms.push_back(MakeCurveKeys(random));
+
+	size_t inputKeys = 0;
+	size_t uniqueKeys = 0;
+
+	state.Start();
+	for (auto& keys : transforms)
+	{
+		inputKeys += keys.size();
+		AnimationKeys::SortAndMerge(keys);
+		uniqueKeys += keys.size();
+	}
+	state.Stop();
+
+	state.SetCounter("inputKeys", double(inputKeys));
+	state.SetCounter("uniqueKeys", double(uniqueKeys));
+});
+
+BENCHMARK("AnimationKeys/reduceTracks", [](Benchmark::State& state)
+{
+	std::vector<Track> tracks = MakeSampledTracks(AnimatedTransformCount, 4);
+
+	size_t inputKeys = 0;
+	for (const Track& track : tracks)
+		inputKeys += track.times.size();
+
+	const int trackCount = int(tracks.size());
+	std::vector<char> keepTrack;
+
+	state.Start();
+	ReduceTracks(tracks, keepTrack);
+	state.Stop();
+
+	size_t keptTracks = 0;
+	size_t keptKeys = 0;
+	for (int i = 0; i < trackCount; i++)
+	{
+		if (!keepTrack[i])
+			continue;
+
+		keptTracks++;
+		keptKeys += tracks[i].times.size();
+	}
+
+	state.SetCounter("inputKeys", double(inputKeys));
+	state.SetCounter("keptTracks", double(keptTracks));
+	state.SetCounter("keptKeys", double(keptKeys));
+});
@@ -0,0 +1,88 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+	/** Passed to each benchmark body. Only the code between Start and Stop is timed,
+		scene setup goes before Start. Counters are printed next to the timing.
+		Failed checks are reported with their location and make the run exit with non-zero status. */
+	class State
+	{
+	public:
+		typedef std::chrono::steady_clock Clock;
+
+		void Start() { m_start = Clock::now(); }
+		void Stop() { m_elapsed += Clock::now() - m_start; }
+
+		void SetCounter(const std::string& name, double value);
+
+		void Check(bool condition, const char* expression, const char* file, int line);
+		size_t Failures() const { return m_failures; }
+
+		double ElapsedMs() const { return std::chrono::duration<double, std::milli>(m_elapsed).count(); }
+
+		const std::vector<std::pair<std::string, double>>& Counters() const { return m_counters; }
+
+	private:
+		Clock::time_point m_start;
+		Clock::duration m_elapsed = Clock::duration::zero();
+
+		std::vector<std::pair<std::string, double>> m_counters;
+		size_t m_failures = 0;
+	};
+
+	typedef std::function<void(State&)> Function;
+
+	struct Entry
+	{
+		std::string name;
+		Function function;
+
+		// run once and not timed, see TEST
+		bool isTest;
+	};
+
+	std::vector<Entry>& Registry();
+
+	struct Registrar
+	{
+		Registrar(const char* name, Function function, bool isTest = false)
+		{
+			Registry().push_back({ name, function, isTest });
+		}
+	};
+
+	// Keeps the optimizer from dropping results of benchmarked code
+	void DoNotOptimize(const void* p);
+}
+
+#define BENCHMARK_CONCAT2(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT2(a, b)
+
+// Registers benchmark body: BENCHMARK("group/name", [](Benchmark::State& state) { ... });
+#define BENCHMARK(name, function) \
+	static Benchmark::Registrar BENCHMARK_CONCAT(s_benchmarkRegistrar, __LINE__)(name, function)
+
+// Registers a correctness test, run by "benchmark -t" and by ctest: TEST("group/name", [](Benchmark::State& state) { ... });
+#define TEST(name, function) \
+	static Benchmark::Registrar BENCHMARK_CONCAT(s_testRegistrar, __LINE__)(name, function, true)
+
+// Usable in BENCHMARK and TEST bodies, the state parameter must be named "state"
+#define CHECK(condition) \
+	state.Check(bool(condition), #condition, __FILE__, __LINE__)
@@ -0,0 +1,139 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "BenchmarkScenes.h"
+
+#include <cmath>
+#include <string>
+
+namespace BenchmarkScenes
+{
+
+Mesh MakeGridMesh(int resolution, uint32_t seed)
+{
+	Random random(seed);
+	Mesh mesh;
+
+	const int side = resolution + 1;
+	const float step = 1.0f / resolution;
+
+	mesh.points.reserve(side * side * 3);
+	mesh.u.reserve(side * side);
+	mesh.v.reserve(side * side);
+
+	for (int y = 0; y < side; y++)
+	{
+		for (int x = 0; x < side; x++)
+		{
+			float height = 0.05f * (random.NextFloat() - 0.5f);
+
+			mesh.points.push_back(x * step - 0.5f);
+			mesh.points.push_back(height);
+			mesh.points.push_back(y * step - 0.5f);
+
+			mesh.u.push_back(x * step);
+			mesh.v.push_back(y * step);
+		}
+	}
+
+	// Maya meshes usually carry per-face-vertex normals, hence the normal count equals face-vertex count
+	mesh.polygonCounts.assign(resolution * resolution, 4);
+	mesh.polygonConnects.reserve(resolution * resolution * 4);
+
+	for (int y = 0; y < resolution; y++)
+	{
+		for (int x = 0; x < resolution; x++)
+		{
+			int i0 = y * side + x;
+			int quad[4] = { i0, i0 + 1, i0 + side + 1, i0 + side };
+
+			for (int idx : quad)
+			{
+				mesh.polygonConnects.push_back(idx);
+				mesh.uvIds.push_back(idx);
+
+				float nx = 0.1f * (random.NextFloat() - 0.5f);
+				float nz = 0.1f * (random.NextFloat() - 0.5f);
+				float len = std::sqrt(nx * nx + 1.0f + nz * nz);
+
+				mesh.normalIds.push_back(int(mesh.normals.size() / 3));
+				mesh.normals.push_back(nx / len);
+				mesh.normals.push_back(1.0f / len);
+				mesh.normals.push_back(nz / len);
+			}
+		}
+	}
+
+	return mesh;
+}
+
+Scene MakeScene(int meshCount, int meshResolution, int hierarchyDepth, uint32_t seed)
+{
+	Random random(seed);
+	Scene scene;
+
+	scene.meshes.reserve(meshCount);
+
+	for (int i = 0; i < meshCount; i++)
+	{
+		scene.meshes.push_back(MakeGridMesh(meshResolution, random.Next()));
+
+		// chain of groups above each mesh, shared between neighbouring meshes
+		int parent = -1;
+		for (int level = 0; level < hierarchyDepth; level++)
+		{
+			DagPath group;
+			group.parent = parent;
+			group.fullPathName = (parent >= 0 ? scene.dagPaths[parent].fullPathName : std::string()) + "|group" + std::to_string(level) + "_" + std::to_string(i);
+			group.localMatrix[12] = random.NextFloat() - 0.5f;
+			group.localMatrix[13] = random.NextFloat() - 0.5f;
+			group.localMatrix[14] = random.NextFloat() - 0.5f;
+
+			scene.dagPaths.push_back(group);
+			parent = int(scene.dagPaths.size()) - 1;
+		}
+
+		DagPath shape;
+		shape.parent = parent;
+		shape.fullPathName = (parent >= 0 ? scene.dagPaths[parent].fullPathName : std::string()) + "|mesh" + std::to_string(i);
+		shape.meshIndex = i;
+
+		scene.dagPaths.push_back(shape);
+	}
+
+	return scene;
+}
+
+std::vector<float> MakeImage(int width, int height, int channels, uint32_t seed)
+{
+	Random random(seed);
+	std::vector<float> pixels((size_t) width * height * channels);
+
+	size_t idx = 0;
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			for (int c = 0; c < channels; c++)
+			{
+				float gradient = 0.5f * (float(x) / width + float(y + c) / height);
+				float value = gradient + 0.1f * (random.NextFloat() - 0.5f);
+
+				pixels[idx++] = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+			}
+		}
+	}
+
+	return pixels;
+}
+
+}
@@ -0,0 +1,93 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/** Reproducible benchmark scenes.
+	Everything is generated from an explicit seed with a fixed generator (not std distributions,
+	which differ between standard libraries), so a scene is identical on every machine. */
+namespace BenchmarkScenes
+{
+	class Random
+	{
+	public:
+		explicit Random(uint32_t seed) : m_state(seed ? seed : 1u) {}
+
+		uint32_t Next()
+		{
+			// xorshift32
+			m_state ^= m_state << 13;
+			m_state ^= m_state >> 17;
+			m_state ^= m_state << 5;
+			return m_state;
+		}
+
+		// uniform in [0, 1)
+		float NextFloat() { return (Next() >> 8) * (1.0f / 16777216.0f); }
+
+	private:
+		uint32_t m_state;
+	};
+
+	/** Mesh data in the layout MFnMesh hands it out (getRawPoints, getRawNormals, getVertices,
+		getNormalIds, getUVs, getAssignedUVs), so code fed from it sees realistic memory access. */
+	struct Mesh
+	{
+		std::vector<float> points;			// xyz per vertex
+		std::vector<float> normals;			// xyz per normal
+		std::vector<float> u;
+		std::vector<float> v;
+
+		std::vector<int> polygonCounts;		// vertex count per polygon
+		std::vector<int> polygonConnects;	// vertex index per face-vertex
+		std::vector<int> normalIds;			// normal index per face-vertex
+		std::vector<int> uvIds;				// uv index per face-vertex
+
+		int numVertices() const { return int(points.size() / 3); }
+		int numNormals() const { return int(normals.size() / 3); }
+		int numUVs() const { return int(u.size()); }
+		int numPolygons() const { return int(polygonCounts.size()); }
+		int numFaceVertices() const { return int(polygonConnects.size()); }
+
+		const float* getRawPoints() const { return points.data(); }
+		const float* getRawNormals() const { return normals.data(); }
+	};
+
+	// A node in DAG with its local transform; parent is the index in the owning array, -1 for world
+	struct DagPath
+	{
+		std::string fullPathName;
+		int parent = -1;
+		std::array<double, 16> localMatrix = { { 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 } };
+		int meshIndex = -1;
+	};
+
+	struct Scene
+	{
+		std::vector<Mesh> meshes;
+		std::vector<DagPath> dagPaths;
+	};
+
+	// Displaced grid of resolution x resolution quads with per-face-vertex normals and uvs
+	Mesh MakeGridMesh(int resolution, uint32_t seed);
+
+	// meshCount grids under a transform hierarchy of the given depth
+	Scene MakeScene(int meshCount, int meshResolution, int hierarchyDepth, uint32_t seed);
+
+	// Smooth gradient with noise, channels interleaved, values in [0, 1]
+	std::vector<float> MakeImage(int width, int height, int channels, uint32_t seed);
+}
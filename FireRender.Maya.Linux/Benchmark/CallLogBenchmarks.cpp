@@ -0,0 +1,254 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+#include "CallLogReplay.h"
+
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	using frw::CallLog::Call;
+
+	const int ShapeCount = 5000;
+	const int MaterialInputs = 16;
+	const int Frames = 8;
+
+	struct SyntheticCall
+	{
+		Call call;
+		uint64_t timeUs;
+		const void* object;
+		const void* target;
+		uint64_t key;
+		uint64_t bytes;
+	};
+
+	/** Call stream of a scene sync followed by a few rendered frames and a partial rebuild,
+		the way frw issues it. Objects are elements of a vector, so their addresses stand in for
+		RPR handles; deleted meshes are recreated at the same address like reused allocations. */
+	std::vector<SyntheticCall> MakeSyntheticStream(std::vector<char>& objects)
+	{
+		BenchmarkScenes::Random random(7);
+		std::vector<SyntheticCall> calls;
+
+		objects.assign(ShapeCount * 3 + 4, 0);
+		const void* context = &objects[0];
+		const void* scene = &objects[1];
+		const void* frameBuffer = &objects[2];
+		const void* resolved = &objects[3];
+
+		uint64_t timeUs = 0;
+
+		auto add = [&](Call call, const void* object, const void* target, uint64_t key, uint64_t bytes)
+		{
+			timeUs += random.Next() % 100;
+			calls.push_back({ call, timeUs, object, target, key, bytes });
+		};
+
+		add(Call::CreateFrameBuffer, context, frameBuffer, 0, 1920 * 1080 * 4 * sizeof(float));
+		add(Call::CreateFrameBuffer, context, resolved, 0, 1920 * 1080 * 4 * sizeof(float));
+
+		for (int i = 0; i < ShapeCount; i++)
+		{
+			const void* shape = &objects[4 + i * 3];
+			const void* material = &objects[5 + i * 3];
+			const void* texture = &objects[6 + i * 3];
+
+			add(Call::CreateMesh, context, shape, 0, 1000 + random.Next() % 100000);
+			add(Call::CreateMaterialNode, context, material, 2, 0);
+			add(Call::CreateImage, context, texture, 0, 4 * 256 * 256);
+
+			for (int key = 0; key < MaterialInputs; key++)
+			{
+				if (key == 0)
+					add(Call::SetMaterialNodeInput, material, texture, key, sizeof(void*));
+				else
+					add(Call::SetMaterialNodeInput, material, nullptr, key, 4 * sizeof(float));
+			}
+
+			add(Call::SetShapeMaterial, shape, material, 0, 0);
+			add(Call::SetTransform, shape, nullptr, 0, 16 * sizeof(float));
+			add(Call::SetParameter, shape, nullptr, 0x415, 4);
+			add(Call::SceneAttach, scene, shape, 0, 0);
+		}
+
+		for (int frame = 0; frame < Frames; frame++)
+		{
+			add(Call::ClearFrameBuffer, frameBuffer, nullptr, 0, 0);
+			add(Call::Render, context, nullptr, 0, 0);
+			add(Call::ResolveFrameBuffer, frameBuffer, resolved, 0, 0);
+		}
+
+		// every 10th mesh is rebuilt
+		for (int i = 0; i < ShapeCount; i += 10)
+		{
+			const void* shape = &objects[4 + i * 3];
+
+			add(Call::SceneDetach, scene, shape, 0, 0);
+			add(Call::ObjectDelete, shape, nullptr, 0, 0);
+			add(Call::CreateMesh, context, shape, 0, 1000 + random.Next() % 100000);
+			add(Call::SceneAttach, scene, shape, 0, 0);
+		}
+
+		return calls;
+	}
+
+	void WriteStream(const std::vector<SyntheticCall>& calls, std::ostream& out)
+	{
+		frw::CallLog::Writer writer(out);
+
+		for (const SyntheticCall& c : calls)
+			writer.Write(c.call, c.timeUs, c.object, c.target, c.key, c.bytes);
+	}
+
+	typedef std::unordered_map<uint64_t, const void*> HandlesById;
+
+	// Number of differences between the replayed statistics and the stream
+	size_t CountMismatches(const std::vector<SyntheticCall>& calls, const CallLogReplay::Stats& stats, const NullContext& context)
+	{
+		CallLogReplay::Stats expected;
+
+		for (const SyntheticCall& c : calls)
+		{
+			expected.calls[size_t(c.call)]++;
+			expected.bytes[size_t(c.call)] += c.bytes;
+		}
+
+		size_t mismatches = 0;
+
+		for (size_t i = 0; i < expected.calls.size(); i++)
+		{
+			mismatches += expected.calls[i] != stats.calls[i];
+			mismatches += expected.bytes[i] != stats.bytes[i];
+		}
+
+		mismatches += stats.records != calls.size();
+		mismatches += stats.recordedUs != (calls.empty() ? 0 : calls.back().timeUs);
+		mismatches += context.TotalCalls() != calls.size();
+		mismatches += context.Bytes(NullContext::Call::CreateMesh) != expected.bytes[size_t(Call::CreateMesh)];
+
+		return mismatches;
+	}
+}
+
+BENCHMARK("CallLog/write", [](Benchmark::State& state)
+{
+	std::vector<char> objects;
+	std::vector<SyntheticCall> calls = MakeSyntheticStream(objects);
+
+	std::ostringstream out;
+
+	state.Start();
+	WriteStream(calls, out);
+	state.Stop();
+
+	state.SetCounter("records", double(calls.size()));
+	state.SetCounter("bytesPerRecord", double(out.str().size()) / calls.size());
+});
+
+BENCHMARK("CallLog/roundTrip", [](Benchmark::State& state)
+{
+	std::vector<char> objects;
+	std::vector<SyntheticCall> calls = MakeSyntheticStream(objects);
+
+	std::stringstream log;
+	WriteStream(calls, log);
+
+	NullContext context;
+	CallLogReplay::Stats stats;
+
+	state.Start();
+	frw::CallLog::Reader reader(log);
+	bool valid = CallLogReplay::Replay(reader, context, stats);
+	state.Stop();
+
+	size_t mismatches = valid ? CountMismatches(calls, stats, context) : 0;
+
+	state.SetCounter("records", double(stats.records));
+	state.SetCounter("mismatches", valid ? double(mismatches) : -1.0);
+});
+
+TEST("CallLog/replayMatchesRecord", [](Benchmark::State& state)
+{
+	std::vector<char> objects;
+	std::vector<SyntheticCall> calls = MakeSyntheticStream(objects);
+
+	std::stringstream log;
+	WriteStream(calls, log);
+	std::string bytes = log.str();
+
+	// every record reads back as written, an id always stands for the same handle
+	{
+		std::istringstream in(bytes);
+		frw::CallLog::Reader reader(in);
+		CHECK(reader.IsValid());
+
+		HandlesById handles;
+		frw::CallLog::Record record;
+		uint64_t timeUs = 0;
+		size_t index = 0;
+		size_t mismatches = 0;
+
+		while (reader.Next(record) && index < calls.size())
+		{
+			const SyntheticCall& c = calls[index++];
+			timeUs += record.timeDeltaUs;
+
+			mismatches += record.call != c.call || timeUs != c.timeUs || record.key != c.key || record.bytes != c.bytes;
+			mismatches += (record.object != 0) != (c.object != nullptr) || (record.target != 0) != (c.target != nullptr);
+			mismatches += record.object && handles.emplace(record.object, c.object).first->second != c.object;
+			mismatches += record.target && handles.emplace(record.target, c.target).first->second != c.target;
+		}
+
+		CHECK(index == calls.size());
+		CHECK(mismatches == 0);
+		CHECK(!reader.Next(record));
+	}
+
+	// replay issues the same calls and leaves the objects alive which the stream didn't delete
+	{
+		std::istringstream in(bytes);
+		frw::CallLog::Reader reader(in);
+		NullContext context;
+		CallLogReplay::Stats stats;
+
+		CHECK(CallLogReplay::Replay(reader, context, stats));
+		CHECK(CountMismatches(calls, stats, context) == 0);
+		CHECK(context.LiveObjects() == size_t(ShapeCount) * 3 + 2);
+	}
+
+	// a truncated last record is dropped
+	{
+		std::istringstream in(bytes.substr(0, bytes.size() - 1));
+		frw::CallLog::Reader reader(in);
+		NullContext context;
+		CallLogReplay::Stats stats;
+
+		CHECK(CallLogReplay::Replay(reader, context, stats));
+		CHECK(stats.records == calls.size() - 1);
+	}
+
+	// anything else is not replayed
+	{
+		std::istringstream in("not a call log");
+		frw::CallLog::Reader reader(in);
+		NullContext context;
+		CallLogReplay::Stats stats;
+
+		CHECK(!CallLogReplay::Replay(reader, context, stats));
+		CHECK(context.TotalCalls() == 0);
+	}
+});
@@ -0,0 +1,118 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "CallLogReplay.h"
+
+#include <unordered_map>
+
+namespace CallLogReplay
+{
+
+bool Replay(frw::CallLog::Reader& reader, NullContext& context, Stats& stats)
+{
+	using frw::CallLog::Call;
+
+	stats = Stats();
+
+	if (!reader.IsValid())
+		return false;
+
+	// Payloads aren't recorded, the null backend only needs a non-null pointer and the size
+	static const float payload = 0.0f;
+
+	std::unordered_map<uint64_t, NullContext::Handle> handles;
+
+	auto getHandle = [&handles](uint64_t id) -> NullContext::Handle
+	{
+		auto it = handles.find(id);
+		return it != handles.end() ? it->second : nullptr;
+	};
+
+	frw::CallLog::Record record;
+
+	while (reader.Next(record))
+	{
+		stats.records++;
+		stats.recordedUs += record.timeDeltaUs;
+		stats.calls[size_t(record.call)]++;
+		stats.bytes[size_t(record.call)] += record.bytes;
+
+		NullContext::Handle object = getHandle(record.object);
+
+		switch (record.call)
+		{
+		case Call::CreateMesh:
+			handles[record.target] = context.CreateMesh(&payload, size_t(record.bytes), 1,
+				nullptr, 0, 0, nullptr, 0, 0, nullptr, 0, nullptr, 0, nullptr, 0, nullptr, 0);
+			break;
+
+		case Call::CreateImage:
+			handles[record.target] = context.CreateImage(size_t(record.bytes), 1, 1, 1, record.bytes ? &payload : nullptr);
+			break;
+
+		case Call::CreateFrameBuffer:
+			handles[record.target] = context.CreateFrameBuffer(size_t(record.bytes / sizeof(float)), 1, 1);
+			break;
+
+		case Call::CreateMaterialNode:
+			handles[record.target] = context.CreateMaterialNode(int(record.key));
+			break;
+
+		case Call::CreateLight:
+			handles[record.target] = context.CreateLight(int(record.key));
+			break;
+
+		case Call::SetParameter:
+		case Call::SetShapeMaterial:
+		case Call::ClearFrameBuffer:
+			context.SetParameter(object, int(record.key), size_t(record.bytes));
+			break;
+
+		case Call::SetTransform:
+			context.SetTransform(object, nullptr);
+			break;
+
+		case Call::SetMaterialNodeInput:
+			context.SetMaterialNodeInput(object, int(record.key), size_t(record.bytes));
+			break;
+
+		// scene creation isn't recorded, so the scene handle is null and only the load is replayed
+		case Call::SceneAttach:
+			context.Attach(object, getHandle(record.target));
+			break;
+
+		case Call::SceneDetach:
+			context.Detach(object, getHandle(record.target));
+			break;
+
+		case Call::ObjectDelete:
+			context.Delete(object);
+			handles.erase(record.object);
+			break;
+
+		case Call::Render:
+			context.Render();
+			break;
+
+		case Call::ResolveFrameBuffer:
+			context.ResolveFrameBuffer(object, getHandle(record.target));
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	return true;
+}
+
+}
@@ -0,0 +1,37 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include "NullContext.h"
+
+#include "frCallRecorder.h"
+
+#include <array>
+#include <cstdint>
+
+/** Feeds a call log recorded by frw::CallRecorder into NullContext,
+	so the load of a recorded sync can be examined without Maya and a GPU. */
+namespace CallLogReplay
+{
+	struct Stats
+	{
+		size_t records = 0;
+		uint64_t recordedUs = 0;	// time span of the recording
+
+		std::array<size_t, size_t(frw::CallLog::Call::Count)> calls = {};
+		std::array<uint64_t, size_t(frw::CallLog::Call::Count)> bytes = {};
+	};
+
+	// Returns false if the stream is not a call log
+	bool Replay(frw::CallLog::Reader& reader, NullContext& context, Stats& stats);
+}
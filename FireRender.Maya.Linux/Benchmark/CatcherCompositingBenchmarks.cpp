@@ -0,0 +1,220 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "Context/CatcherCompositing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	const unsigned int FrameWidth = 1920;
+	const unsigned int FrameHeight = 1080;
+
+	// Region as in RenderRegion, rows counted from the bottom
+	const unsigned int RegionLeft = 200;
+	const unsigned int RegionTop = 999;
+	const unsigned int RegionWidth = 1500;
+	const unsigned int RegionHeight = 900;
+
+	const float ShadowColor[3] = { 0.1f, 0.2f, 0.3f };
+	const float BackgroundColor[3] = { 0.9f, 1.0f, 0.8f };
+	const float ShadowTransparency = 0.75f;
+	const float BackgroundTransparency = 0.5f;
+
+	typedef std::vector<float> Image;
+
+	// Stand-in of CompositeWrapper: every operation materializes a full frame RGBA image like rprCompositeCompute
+	Image Constant(float r, float g, float b, float a)
+	{
+		Image image(size_t(FrameWidth) * FrameHeight * 4);
+
+		for (size_t i = 0; i < image.size(); i += 4)
+		{
+			image[i + 0] = r;
+			image[i + 1] = g;
+			image[i + 2] = b;
+			image[i + 3] = a;
+		}
+
+		return image;
+	}
+
+	Image Constant(float value) { return Constant(value, value, value, value); }
+
+	template <typename Op>
+	Image Apply(const Image& a, const Image& b, Op op)
+	{
+		Image result(a.size());
+
+		for (size_t i = 0; i < a.size(); i++)
+			result[i] = op(a[i], b[i]);
+
+		return result;
+	}
+
+	Image operator+(const Image& a, const Image& b) { return Apply(a, b, [](float x, float y) { return x + y; }); }
+	Image operator-(const Image& a, const Image& b) { return Apply(a, b, [](float x, float y) { return x - y; }); }
+	Image operator*(const Image& a, const Image& b) { return Apply(a, b, [](float x, float y) { return x * y; }); }
+	Image Min(const Image& a, const Image& b) { return Apply(a, b, [](float x, float y) { return std::min(x, y); }); }
+
+	struct Inputs
+	{
+		Image color = BenchmarkScenes::MakeImage(FrameWidth, FrameHeight, 4, 31);
+		Image opacity = BenchmarkScenes::MakeImage(FrameWidth, FrameHeight, 4, 32);
+		Image background = BenchmarkScenes::MakeImage(FrameWidth, FrameHeight, 4, 33);
+		Image shadowCatcher = BenchmarkScenes::MakeImage(FrameWidth, FrameHeight, 4, 34);
+		Image reflectionCatcher = BenchmarkScenes::MakeImage(FrameWidth, FrameHeight, 4, 35);
+	};
+
+	// FireRenderContext::composite*CatcherOutput, followed by the region copy of doOutputFromComposites
+	Image CompositeChain(const Inputs& in, bool shadow, bool reflection)
+	{
+		Image noAlpha = Constant(1.0f, 1.0f, 1.0f, 0.0f);
+		Image shadowColor = Constant(ShadowColor[0], ShadowColor[1], ShadowColor[2], 1.0f);
+		Image const1 = Constant(1.0f);
+		Image shadowTransp = Constant(ShadowTransparency);
+		Image backgroundTransp = Constant(BackgroundTransparency);
+		Image backgroundColor = Constant(BackgroundColor[0], BackgroundColor[1], BackgroundColor[2], 1.0f);
+
+		Image res;
+
+		if (shadow && reflection)
+		{
+			Image step1 = noAlpha * in.opacity + noAlpha * in.shadowCatcher * shadowTransp * (const1 - shadowColor);
+			Image step2 = const1 - Min(step1, const1);
+			Image step3 = in.color * (noAlpha * in.opacity + in.reflectionCatcher);
+			res = in.background * backgroundTransp * backgroundColor * step2 + step3;
+		}
+		else if (shadow)
+		{
+			Image step1 = noAlpha * in.opacity + noAlpha * in.shadowCatcher * shadowTransp * (const1 - shadowColor);
+			Image step2 = const1 - Min(step1, const1);
+			res = in.background * backgroundTransp * backgroundColor * step2 + noAlpha * in.color * in.opacity;
+		}
+		else
+		{
+			Image step1 = const1 - noAlpha * in.opacity;
+			Image step2 = in.background * backgroundTransp * backgroundColor * step1;
+			res = step2 + in.color * (noAlpha * in.opacity + in.reflectionCatcher);
+		}
+
+		Image region(size_t(RegionWidth) * RegionHeight * 4);
+
+		for (unsigned int y = 0; y < RegionHeight; y++)
+		{
+			size_t sourceIndex = (size_t(FrameHeight - (RegionTop - y) - 1) * FrameWidth + RegionLeft) * 4;
+			std::memcpy(&region[size_t(y) * RegionWidth * 4], &res[sourceIndex], sizeof(float) * RegionWidth * 4);
+		}
+
+		return region;
+	}
+
+	bool CompositeFused(const Inputs& in, bool shadow, bool reflection, Image& region)
+	{
+		CatcherCompositing::Request request;
+		request.inputs[CatcherCompositing::Color] = in.color.data();
+		request.inputs[CatcherCompositing::Opacity] = in.opacity.data();
+		request.inputs[CatcherCompositing::Background] = in.background.data();
+		request.inputs[CatcherCompositing::ShadowCatcher] = shadow ? in.shadowCatcher.data() : nullptr;
+		request.inputs[CatcherCompositing::ReflectionCatcher] = reflection ? in.reflectionCatcher.data() : nullptr;
+		request.sourceWidth = FrameWidth;
+		request.sourceHeight = FrameHeight;
+		request.left = RegionLeft;
+		request.top = RegionTop;
+		request.width = RegionWidth;
+		request.height = RegionHeight;
+		request.destination = region.data();
+
+		for (int c = 0; c < 3; c++)
+		{
+			request.shadowColor[c] = ShadowColor[c];
+			request.backgroundColor[c] = BackgroundColor[c];
+		}
+
+		request.shadowTransparency = ShadowTransparency;
+		request.backgroundTransparency = BackgroundTransparency;
+
+		return CatcherCompositing::Composite(request);
+	}
+
+	// Largest difference of the color and of the alpha channels
+	void MaxErrors(const Image& result, const Image& expected, double& color, double& alpha)
+	{
+		color = 0.0;
+		alpha = 0.0;
+
+		for (size_t i = 0; i < result.size(); i++)
+		{
+			double& error = (i % 4 == 3) ? alpha : color;
+			error = std::max(error, double(std::fabs(result[i] - expected[i])));
+		}
+	}
+}
+
+BENCHMARK("CatcherCompositing/compositeChain", [](Benchmark::State& state)
+{
+	Inputs inputs;
+
+	state.Start();
+	Image region = CompositeChain(inputs, true, true);
+	state.Stop();
+
+	state.SetCounter("MPixels", RegionWidth * RegionHeight / 1e6);
+});
+
+BENCHMARK("CatcherCompositing/fused", [](Benchmark::State& state)
+{
+	Inputs inputs;
+	Image region(size_t(RegionWidth) * RegionHeight * 4);
+
+	state.Start();
+	CompositeFused(inputs, true, true, region);
+	state.Stop();
+
+	state.SetCounter("MPixels", RegionWidth * RegionHeight / 1e6);
+});
+
+// Constant factors are folded, so the kernel matches the chains up to float rounding
+TEST("CatcherCompositing/fusedMatchesChain", [](Benchmark::State& state)
+{
+	Inputs inputs;
+	Image region(size_t(RegionWidth) * RegionHeight * 4);
+	double colorError = 0.0;
+	double alphaError = 0.0;
+
+	// shadow catcher
+	CHECK(CompositeFused(inputs, true, false, region));
+	MaxErrors(region, CompositeChain(inputs, true, false), colorError, alphaError);
+	CHECK(colorError < 1e-5);
+	CHECK(alphaError < 1e-5);
+
+	// reflection catcher, its alpha adds color alpha * catcher alpha
+	CHECK(CompositeFused(inputs, false, true, region));
+	MaxErrors(region, CompositeChain(inputs, false, true), colorError, alphaError);
+	CHECK(colorError < 1e-5);
+	CHECK(alphaError < 1e-5);
+
+	// both catchers
+	CHECK(CompositeFused(inputs, true, true, region));
+	MaxErrors(region, CompositeChain(inputs, true, true), colorError, alphaError);
+	CHECK(colorError < 1e-5);
+	CHECK(alphaError < 1e-5);
+
+	// without a catcher there is nothing to composite
+	CHECK(!CompositeFused(inputs, false, false, region));
+});
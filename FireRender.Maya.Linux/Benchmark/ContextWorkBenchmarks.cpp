@@ -0,0 +1,527 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+#include "NullContext.h"
+
+#include "Context/ContextWorkTracer.h"
+#include "frWrap.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	const int TracedObjectCount = 100000;
+
+	// Same guarding as in FireRenderContext: event data is only prepared when tracing is on
+	void SimulateSync(const BenchmarkScenes::Scene& scene, const void* owner, ContextWorkTracer& tracer)
+	{
+		if (ContextWorkTracer::IsEnabled())
+			tracer.Begin(owner, "sync", "Sync");
+
+		for (size_t i = 0; i < scene.dagPaths.size(); i++)
+		{
+			if (!ContextWorkTracer::IsEnabled())
+				continue;
+
+			const auto& dagPath = scene.dagPaths[i];
+
+			tracer.Begin(owner, "sync", dagPath.fullPathName, dagPath.meshIndex >= 0 ? "mesh" : "transform", (long long) i, (long long) scene.dagPaths.size());
+			tracer.End(owner, "sync", dagPath.fullPathName);
+		}
+
+		if (ContextWorkTracer::IsEnabled())
+			tracer.End(owner, "sync", "Sync");
+	}
+
+	// Pushes scene meshes through frw the way the single shader translator does: raw points and normals,
+	// per-face-vertex indices and per-polygon vertex counts
+	void UploadScene(const BenchmarkScenes::Scene& scene, frw::Context& context, frw::Scene& frScene)
+	{
+		for (const auto& dagPath : scene.dagPaths)
+		{
+			if (dagPath.meshIndex < 0)
+				continue;
+
+			const BenchmarkScenes::Mesh& mesh = scene.meshes[dagPath.meshIndex];
+
+			std::vector<float> uvs;
+			uvs.reserve(mesh.u.size() * 2);
+
+			for (size_t i = 0; i < mesh.u.size(); i++)
+			{
+				uvs.push_back(mesh.u[i]);
+				uvs.push_back(mesh.v[i]);
+			}
+
+			frw::Shape shape = context.CreateMesh(
+				mesh.getRawPoints(), mesh.numVertices(), 3 * sizeof(float),
+				mesh.getRawNormals(), mesh.numNormals(), 3 * sizeof(float),
+				uvs.data(), mesh.numUVs(), 2 * sizeof(float),
+				mesh.polygonConnects.data(), sizeof(int),
+				mesh.normalIds.data(), sizeof(int),
+				mesh.uvIds.data(), sizeof(int),
+				mesh.polygonCounts.data(), mesh.polygonCounts.size());
+
+			float matrix[16];
+			for (int i = 0; i < 16; i++)
+				matrix[i] = float(dagPath.localMatrix[i]);
+
+			shape.SetTransform(matrix);
+			frScene.Attach(shape);
+		}
+	}
+}
+
+BENCHMARK("ContextWorkTracer/disabled", [](Benchmark::State& state)
+{
+	ContextWorkTracer& tracer = ContextWorkTracer::Instance();
+	tracer.Disable();
+	tracer.Clear();
+
+	BenchmarkScenes::Scene scene = BenchmarkScenes::MakeScene(TracedObjectCount / 4, 1, 3, 1);
+
+	state.Start();
+	SimulateSync(scene, &scene, tracer);
+	state.Stop();
+
+	state.SetCounter("events", double(tracer.GetEvents().size()));
+});
+
+BENCHMARK("ContextWorkTracer/enabled", [](Benchmark::State& state)
+{
+	ContextWorkTracer& tracer = ContextWorkTracer::Instance();
+	tracer.Enable(std::string());
+	tracer.Clear();
+
+	BenchmarkScenes::Scene scene = BenchmarkScenes::MakeScene(TracedObjectCount / 4, 1, 3, 1);
+
+	state.Start();
+	SimulateSync(scene, &scene, tracer);
+
+	std::ostringstream json;
+	tracer.WriteJson(json);
+	state.Stop();
+
+	state.SetCounter("events", double(tracer.GetEvents().size()));
+	state.SetCounter("jsonBytes", double(json.str().size()));
+
+	tracer.Disable();
+	tracer.Clear();
+});
+
+BENCHMARK("NullContext/uploadScene", [](Benchmark::State& state)
+{
+	BenchmarkScenes::Scene scene = BenchmarkScenes::MakeScene(256, 64, 3, 2);
+	NullContext nullContext;
+	frw::Context context(nullContext.GetHandle(), false);
+	frw::Scene frScene = context.CreateScene();
+
+	state.Start();
+	UploadScene(scene, context, frScene);
+	state.Stop();
+
+	state.SetCounter("calls", double(nullContext.TotalCalls()));
+	state.SetCounter("meshBytes", double(nullContext.Bytes(NullContext::Call::CreateMesh)));
+});
+
+TEST("NullContext/frwSceneRoundTrip", [](Benchmark::State& state)
+{
+	BenchmarkScenes::Scene scene = BenchmarkScenes::MakeScene(16, 4, 2, 3);
+
+	size_t meshCount = 0;
+	for (const auto& dagPath : scene.dagPaths)
+		meshCount += dagPath.meshIndex >= 0;
+
+	NullContext nullContext;
+
+	{
+		frw::Context context(nullContext.GetHandle(), false);
+		frw::Scene frScene = context.CreateScene();
+
+		UploadScene(scene, context, frScene);
+
+		CHECK(nullContext.Calls("rprContextCreateMesh") == meshCount);
+		CHECK(nullContext.Calls("rprShapeSetTransform") == meshCount);
+		CHECK(nullContext.Calls("rprSceneAttachShape") == meshCount);
+
+		// the scene lists are answered by the backend, frw maps them back to its objects
+		std::list<frw::Shape> shapes = frScene.GetShapes();
+		CHECK(shapes.size() == meshCount);
+		CHECK(!shapes.empty() && shapes.front().GetFaceCount() == scene.meshes[0].numPolygons());
+		CHECK(!shapes.empty() && !shapes.front().IsInstance());
+
+		frScene.DetachShapes();
+		CHECK(nullContext.Calls("rprSceneDetachShape") == meshCount);
+		CHECK(frScene.GetShapes().empty());
+	}
+
+	// every object frw created was deleted through rprObjectDelete
+	CHECK(nullContext.LiveObjects() == 0);
+	CHECK(nullContext.Calls("rprObjectDelete") == meshCount + 1);
+});
+
+namespace
+{
+	struct JsonValue
+	{
+		enum Type
+		{
+			Null,
+			Bool,
+			Number,
+			String,
+			Array,
+			Object
+		};
+
+		Type type = Null;
+		double number = 0.0;
+		std::string text;
+
+		// array items or object member values, keys holds the member names
+		std::vector<JsonValue> items;
+		std::vector<std::string> keys;
+
+		const JsonValue* Member(const std::string& key) const
+		{
+			for (size_t i = 0; i < keys.size(); i++)
+			{
+				if (keys[i] == key)
+					return &items[i];
+			}
+
+			return nullptr;
+		}
+	};
+
+	// Strict parser of the JSON the tracer writes, fails on anything malformed or trailing
+	class JsonParser
+	{
+	public:
+		explicit JsonParser(const std::string& text) : m_text(text), m_pos(0) {}
+
+		bool ParseDocument(JsonValue& value)
+		{
+			if (!ParseValue(value))
+				return false;
+
+			SkipSpace();
+			return m_pos == m_text.size();
+		}
+
+	private:
+		void SkipSpace()
+		{
+			while (m_pos < m_text.size() && (m_text[m_pos] == ' ' || m_text[m_pos] == '\n' || m_text[m_pos] == '\r' || m_text[m_pos] == '\t'))
+				m_pos++;
+		}
+
+		bool Consume(char c)
+		{
+			SkipSpace();
+
+			if (m_pos < m_text.size() && m_text[m_pos] == c)
+			{
+				m_pos++;
+				return true;
+			}
+
+			return false;
+		}
+
+		bool ConsumeWord(const char* word)
+		{
+			std::string expected(word);
+
+			if (m_text.compare(m_pos, expected.size(), expected) != 0)
+				return false;
+
+			m_pos += expected.size();
+			return true;
+		}
+
+		bool ParseString(std::string& result)
+		{
+			if (!Consume('"'))
+				return false;
+
+			while (m_pos < m_text.size())
+			{
+				char c = m_text[m_pos++];
+
+				if (c == '"')
+					return true;
+
+				if (static_cast<unsigned char>(c) < 0x20)
+					return false;
+
+				if (c != '\\')
+				{
+					result += c;
+					continue;
+				}
+
+				if (m_pos >= m_text.size())
+					return false;
+
+				char escaped = m_text[m_pos++];
+
+				switch (escaped)
+				{
+				case '"': result += '"'; break;
+				case '\\': result += '\\'; break;
+				case '/': result += '/'; break;
+				case 'b': result += '\b'; break;
+				case 'f': result += '\f'; break;
+				case 'n': result += '\n'; break;
+				case 'r': result += '\r'; break;
+				case 't': result += '\t'; break;
+				case 'u':
+				{
+					if (m_pos + 4 > m_text.size())
+						return false;
+
+					std::string hex = m_text.substr(m_pos, 4);
+					if (hex.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)
+						return false;
+
+					// the tracer only escapes control characters
+					result += char(std::strtol(hex.c_str(), nullptr, 16));
+					m_pos += 4;
+					break;
+				}
+				default:
+					return false;
+				}
+			}
+
+			return false;
+		}
+
+		bool ParseValue(JsonValue& value)
+		{
+			SkipSpace();
+
+			if (m_pos >= m_text.size())
+				return false;
+
+			char c = m_text[m_pos];
+
+			if (c == '{')
+			{
+				m_pos++;
+				value.type = JsonValue::Object;
+
+				if (Consume('}'))
+					return true;
+
+				do
+				{
+					std::string key;
+					JsonValue member;
+
+					if (!ParseString(key) || !Consume(':') || !ParseValue(member))
+						return false;
+
+					value.keys.push_back(key);
+					value.items.push_back(member);
+				} while (Consume(','));
+
+				return Consume('}');
+			}
+
+			if (c == '[')
+			{
+				m_pos++;
+				value.type = JsonValue::Array;
+
+				if (Consume(']'))
+					return true;
+
+				do
+				{
+					JsonValue item;
+
+					if (!ParseValue(item))
+						return false;
+
+					value.items.push_back(item);
+				} while (Consume(','));
+
+				return Consume(']');
+			}
+
+			if (c == '"')
+			{
+				value.type = JsonValue::String;
+				return ParseString(value.text);
+			}
+
+			if (ConsumeWord("true") || ConsumeWord("false"))
+			{
+				value.type = JsonValue::Bool;
+				return true;
+			}
+
+			if (ConsumeWord("null"))
+				return true;
+
+			const char* start = m_text.c_str() + m_pos;
+			char* end = nullptr;
+			value.number = std::strtod(start, &end);
+
+			if (end == start)
+				return false;
+
+			value.type = JsonValue::Number;
+			m_pos += size_t(end - start);
+			return true;
+		}
+
+		const std::string& m_text;
+		size_t m_pos;
+	};
+
+	bool ParseTraceFile(const std::filesystem::path& path, JsonValue& trace)
+	{
+		std::ifstream file(path, std::ios::binary);
+		std::stringstream text;
+		text << file.rdbuf();
+
+		std::string json = text.str();
+		return JsonParser(json).ParseDocument(trace);
+	}
+
+	size_t CountEvents(const JsonValue& trace, const std::string& phase)
+	{
+		const JsonValue* events = trace.Member("traceEvents");
+		size_t count = 0;
+
+		for (const JsonValue& event : events ? events->items : std::vector<JsonValue>())
+		{
+			const JsonValue* ph = event.Member("ph");
+			if (ph && ph->text == phase)
+				count++;
+		}
+
+		return count;
+	}
+}
+
+TEST("ContextWorkTracer/flushAppendsValidJson", [](Benchmark::State& state)
+{
+	std::filesystem::path path = std::filesystem::temp_directory_path() / "rpr_context_work_trace.json";
+	std::filesystem::remove(path);
+
+	ContextWorkTracer& tracer = ContextWorkTracer::Instance();
+	tracer.Clear();
+	tracer.Enable(path.string());
+
+	int owner = 0;
+
+	// names with characters which have to be escaped
+	tracer.SetOwnerName(&owner, "IPR \"main\"");
+	tracer.Begin(&owner, "sync", "Sync", "mesh", -1, 2);
+	tracer.Begin(&owner, "sync", "pCube1\\shape\n\t", "mesh", 0, 2);
+	tracer.End(&owner, "sync", "pCube1\\shape\n\t");
+	tracer.End(&owner, "sync", "Sync");
+
+	CHECK(tracer.Flush());
+	CHECK(tracer.GetEvents().empty());
+
+	JsonValue first;
+	CHECK(ParseTraceFile(path, first));
+	CHECK(CountEvents(first, "B") == 2);
+	CHECK(CountEvents(first, "E") == 2);
+	CHECK(CountEvents(first, "M") == 1);
+
+	// nothing new is still a valid file
+	CHECK(tracer.Flush());
+
+	tracer.Instant(&owner, "render", "Render start", -1, 16);
+	tracer.Complete(&owner, "render", "Render", 5);
+	CHECK(tracer.Flush());
+
+	tracer.Disable();
+
+	JsonValue trace;
+	CHECK(ParseTraceFile(path, trace));
+	CHECK(trace.Member("displayTimeUnit") && trace.Member("displayTimeUnit")->text == "ms");
+	CHECK(CountEvents(trace, "B") == 2);
+	CHECK(CountEvents(trace, "E") == 2);
+	CHECK(CountEvents(trace, "i") == 1);
+	CHECK(CountEvents(trace, "X") == 1);
+	CHECK(CountEvents(trace, "M") == 1);
+
+	const JsonValue* events = trace.Member("traceEvents");
+	CHECK(events && events->items.size() == 7);
+
+	if (events && events->items.size() == 7)
+	{
+		const JsonValue& processName = events->items[0];
+		CHECK(processName.Member("args") && processName.Member("args")->Member("name") &&
+			processName.Member("args")->Member("name")->text == "IPR \"main\"");
+
+		const JsonValue& objectSync = events->items[2];
+		CHECK(objectSync.Member("name") && objectSync.Member("name")->text == "pCube1\\shape\n\t");
+		CHECK(objectSync.Member("args") && objectSync.Member("args")->Member("index") &&
+			objectSync.Member("args")->Member("index")->number == 0.0);
+
+		const JsonValue& render = events->items[6];
+		CHECK(render.Member("dur") && render.Member("dur")->number == 5000.0);
+	}
+
+	std::error_code error;
+	std::filesystem::remove(path, error);
+});
+
+TEST("ContextWorkTracer/unwritableOutputStopsTracing", [](Benchmark::State& state)
+{
+	ContextWorkTracer& tracer = ContextWorkTracer::Instance();
+	int owner = 0;
+
+	std::vector<std::string> paths = { (std::filesystem::temp_directory_path() / "rpr_no_such_directory" / "trace.json").string() };
+
+	// opens, but every write fails
+	if (std::filesystem::exists("/dev/full"))
+		paths.push_back("/dev/full");
+
+	for (const std::string& path : paths)
+	{
+		tracer.Clear();
+		tracer.Enable(path);
+
+		tracer.Begin(&owner, "sync", "Sync");
+		tracer.End(&owner, "sync", "Sync");
+		CHECK(tracer.GetEvents().size() == 2);
+
+		CHECK(!tracer.Flush());
+
+		// the events are dropped and nothing more is recorded
+		CHECK(!ContextWorkTracer::IsEnabled());
+		CHECK(tracer.GetEvents().empty());
+
+		tracer.Begin(&owner, "sync", "Sync");
+		CHECK(tracer.GetEvents().empty());
+	}
+
+	tracer.Disable();
+	tracer.Clear();
+});
@@ -0,0 +1,258 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "Translators/DeformationMotionCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <unordered_map>
+
+namespace
+{
+	const int DeformingMeshCount = 64;
+	const int MeshResolution = 32;
+	const int MotionSamples = 4;
+
+	/** Stands in for Maya: moving to a time deforms every mesh of the scene,
+		as a global time change re-evaluates the whole rig, reading a mesh only copies it. */
+	class MockEvaluator : public DeformationMotionCache::Evaluator
+	{
+	public:
+		explicit MockEvaluator(const BenchmarkScenes::Scene& scene) :
+			m_scene(scene),
+			m_timeChanges(0)
+		{
+			m_deformed.resize(scene.meshes.size());
+		}
+
+		virtual void SetTime(double time) override
+		{
+			m_timeChanges++;
+
+			for (size_t i = 0; i < m_scene.meshes.size(); i++)
+			{
+				const std::vector<float>& points = m_scene.meshes[i].points;
+				std::vector<float>& deformed = m_deformed[i];
+
+				deformed.resize(points.size());
+
+				for (size_t p = 0; p < points.size(); p += 3)
+				{
+					float wave = 0.1f * std::sin(float(time) + points[p] * 4.0f);
+
+					deformed[p] = points[p];
+					deformed[p + 1] = points[p + 1] + wave;
+					deformed[p + 2] = points[p + 2];
+				}
+			}
+		}
+
+		virtual bool ReadMesh(const std::string& meshPath, std::vector<float>& points, std::vector<float>& normals) override
+		{
+			m_reads[meshPath]++;
+
+			size_t index = std::stoul(meshPath.substr(meshPath.rfind("mesh") + 4));
+
+			points.insert(points.end(), m_deformed[index].begin(), m_deformed[index].end());
+			normals.insert(normals.end(), m_scene.meshes[index].normals.begin(), m_scene.meshes[index].normals.end());
+
+			return true;
+		}
+
+		size_t TimeChanges() const { return m_timeChanges; }
+
+		size_t Reads(const std::string& meshPath) const
+		{
+			auto it = m_reads.find(meshPath);
+			return it != m_reads.end() ? it->second : 0;
+		}
+
+	private:
+		const BenchmarkScenes::Scene& m_scene;
+		std::vector<std::vector<float>> m_deformed;
+		std::unordered_map<std::string, size_t> m_reads;
+		size_t m_timeChanges;
+	};
+
+	std::vector<double> SampleTimes()
+	{
+		return DeformationMotionCache::ShutterSampleTimes(1.0, MotionSamples);
+	}
+
+	std::vector<std::string> MeshPaths(const BenchmarkScenes::Scene& scene)
+	{
+		std::vector<std::string> paths;
+
+		for (const auto& dagPath : scene.dagPaths)
+		{
+			if (dagPath.meshIndex >= 0)
+				paths.push_back(dagPath.fullPathName);
+		}
+
+		return paths;
+	}
+}
+
+BENCHMARK("DeformationMotionCache/perMesh", [](Benchmark::State& state)
+{
+	BenchmarkScenes::Scene scene = BenchmarkScenes::MakeScene(DeformingMeshCount, MeshResolution, 2, 5);
+	std::vector<std::string> paths = MeshPaths(scene);
+	MockEvaluator evaluator(scene);
+
+	size_t sampledMeshes = 0;
+
+	// previous behaviour: every mesh moves the timeline through all samples and back
+	state.Start();
+	for (const std::string& path : paths)
+	{
+		DeformationMotionCache cache;
+		cache.SetSampleTimes(SampleTimes());
+		cache.Request(path);
+		cache.Evaluate(evaluator);
+		evaluator.SetTime(1.0);
+
+		sampledMeshes += cache.Find(path) != nullptr ? 1 : 0;
+	}
+	state.Stop();
+
+	state.SetCounter("meshes", double(sampledMeshes));
+	state.SetCounter("timeChanges", double(evaluator.TimeChanges()));
+});
+
+BENCHMARK("DeformationMotionCache/batched", [](Benchmark::State& state)
+{
+	BenchmarkScenes::Scene scene = BenchmarkScenes::MakeScene(DeformingMeshCount, MeshResolution, 2, 5);
+	std::vector<std::string> paths = MeshPaths(scene);
+	MockEvaluator evaluator(scene);
+
+	size_t sampledMeshes = 0;
+
+	state.Start();
+	DeformationMotionCache cache;
+	cache.SetSampleTimes(SampleTimes());
+
+	for (const std::string& path : paths)
+		cache.Request(path);
+
+	cache.Evaluate(evaluator);
+
+	for (const std::string& path : paths)
+		sampledMeshes += cache.Find(path) != nullptr ? 1 : 0;
+	state.Stop();
+
+	state.SetCounter("meshes", double(sampledMeshes));
+	state.SetCounter("timeChanges", double(evaluator.TimeChanges()));
+});
+
+TEST("DeformationMotionCache/sampleTimesMatchShutter", [](Benchmark::State& state)
+{
+	for (unsigned int sampleCount = 2; sampleCount <= 8; sampleCount++)
+	{
+		std::vector<double> times = DeformationMotionCache::ShutterSampleTimes(12.0, sampleCount);
+
+		CHECK(times.size() == sampleCount);
+
+		// one frame from the current time, evenly spaced
+		for (unsigned int i = 0; i < times.size(); i++)
+			CHECK(std::abs(times[i] - (12.0 + double(i) / (sampleCount - 1))) < 1e-12);
+
+		CHECK(!times.empty() && times.front() == 12.0 && times.back() == 13.0);
+	}
+
+	CHECK(DeformationMotionCache::ShutterSampleTimes(12.0, 1).empty());
+	CHECK(DeformationMotionCache::ShutterSampleTimes(12.0, 0).empty());
+});
+
+TEST("DeformationMotionCache/samplesMatchPerSampleEvaluation", [](Benchmark::State& state)
+{
+	BenchmarkScenes::Scene scene = BenchmarkScenes::MakeScene(8, 4, 2, 5);
+	std::vector<std::string> paths = MeshPaths(scene);
+	MockEvaluator evaluator(scene);
+
+	DeformationMotionCache cache;
+	cache.SetSampleTimes(SampleTimes());
+
+	for (const std::string& path : paths)
+		cache.Request(path);
+
+	CHECK(cache.Evaluate(evaluator) == MotionSamples);
+
+	// each sample of the batch equals the mesh evaluated alone at the sample time
+	MockEvaluator reference(scene);
+
+	for (const std::string& path : paths)
+	{
+		const DeformationMotionCache::MeshSamples* samples = cache.Find(path);
+		CHECK(samples != nullptr);
+
+		if (!samples)
+			continue;
+
+		CHECK(evaluator.Reads(path) == MotionSamples);
+		CHECK(samples->points.size() == samples->pointCount * 3 * MotionSamples);
+		CHECK(samples->normals.size() == samples->normalCount * 3 * MotionSamples);
+
+		for (int sample = 0; sample < MotionSamples; sample++)
+		{
+			std::vector<float> points;
+			std::vector<float> normals;
+
+			reference.SetTime(SampleTimes()[sample]);
+			reference.ReadMesh(path, points, normals);
+
+			size_t pointOffset = sample * samples->pointCount * 3;
+			size_t normalOffset = sample * samples->normalCount * 3;
+
+			CHECK(points.size() == samples->pointCount * 3);
+			CHECK(std::equal(points.begin(), points.end(), samples->points.begin() + pointOffset));
+			CHECK(std::equal(normals.begin(), normals.end(), samples->normals.begin() + normalOffset));
+		}
+	}
+});
+
+TEST("DeformationMotionCache/staticMeshSingleSample", [](Benchmark::State& state)
+{
+	BenchmarkScenes::Scene scene = BenchmarkScenes::MakeScene(4, 4, 2, 5);
+	std::vector<std::string> paths = MeshPaths(scene);
+	MockEvaluator evaluator(scene);
+
+	DeformationMotionCache cache;
+	cache.SetSampleTimes(SampleTimes());
+
+	// without a deformer the mesh is not read over the shutter, the translator exports its single current sample
+	cache.MarkStatic(paths[0]);
+	cache.Request(paths[0]);
+
+	for (size_t i = 1; i < paths.size(); i++)
+		cache.Request(paths[i]);
+
+	cache.Evaluate(evaluator);
+
+	CHECK(cache.GetState(paths[0]) == DeformationMotionCache::MeshState::Static);
+	CHECK(cache.Find(paths[0]) == nullptr);
+	CHECK(evaluator.Reads(paths[0]) == 0);
+	CHECK(cache.GetState(paths[1]) == DeformationMotionCache::MeshState::Sampled);
+
+	// no deformation blur below two samples: nothing is evaluated
+	DeformationMotionCache single;
+	single.SetSampleTimes(DeformationMotionCache::ShutterSampleTimes(1.0, 1));
+	single.Request(paths[1]);
+
+	MockEvaluator singleEvaluator(scene);
+	CHECK(single.Evaluate(singleEvaluator) == 0);
+	CHECK(singleEvaluator.Reads(paths[1]) == 0);
+	CHECK(single.Find(paths[1]) == nullptr);
+});
@@ -0,0 +1,319 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "Context/DirtyObjectStaging.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// Slider drag on a rig: every tick dirties the same few controls many times
+	const int ObjectCount = 64;
+	const int CallbacksPerThread = 250000;
+	const int ThreadCount = 4;
+
+	// bytes between two objects, about the size of a mesh translator
+	const size_t ObjectSize = 256;
+
+	// Objects are only used as keys, never dereferenced
+	std::vector<FireRenderObject*> MakeObjects(std::vector<char>& storage, size_t count = ObjectCount)
+	{
+		storage.resize(count * ObjectSize);
+
+		std::vector<FireRenderObject*> objects;
+		for (size_t i = 0; i < count; i++)
+			objects.push_back(reinterpret_cast<FireRenderObject*>(&storage[i * ObjectSize]));
+
+		return objects;
+	}
+
+	// The context dirty list, as filled by setDirtyObject
+	struct DirtyList
+	{
+		std::mutex mutex;
+		std::map<FireRenderObject*, std::weak_ptr<void>> objects;
+		long long lockCount = 0;
+
+		void Add(FireRenderObject* object)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			lockCount++;
+			objects[object];
+		}
+	};
+
+	// plugs dirtied when a transform is selected and moved in the viewport
+	const char* const DirtiedAttributes[] =
+	{
+		"translateX", "isHistoricallyInteresting", "matrix", "objectColorRGB", "worldMatrix",
+		"displayLocalAxis", "visibility", "overrideColorRGB", "drawOverride", "uiTreatment"
+	};
+
+	const int DirtiedAttributeCount = int(sizeof(DirtiedAttributes) / sizeof(DirtiedAttributes[0]));
+
+	template <class Callback>
+	void RunStorm(const std::vector<FireRenderObject*>& objects, Callback callback, int callbacksPerThread = CallbacksPerThread)
+	{
+		std::vector<std::thread> threads;
+
+		for (int t = 0; t < ThreadCount; t++)
+		{
+			threads.emplace_back([&objects, &callback, t, callbacksPerThread]()
+			{
+				BenchmarkScenes::Random random(t + 1);
+
+				for (int i = 0; i < callbacksPerThread; i++)
+					callback(objects[random.Next() % objects.size()]);
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+
+	// The same callbacks on one thread straight into the dirty list
+	void RunSerial(const std::vector<FireRenderObject*>& objects, DirtyList& dirtyList, int callbacksPerThread)
+	{
+		for (int t = 0; t < ThreadCount; t++)
+		{
+			BenchmarkScenes::Random random(t + 1);
+
+			for (int i = 0; i < callbacksPerThread; i++)
+				dirtyList.Add(objects[random.Next() % objects.size()]);
+		}
+	}
+
+	bool SameObjects(const DirtyList& dirtyList, const std::vector<FireRenderObject*>& staged)
+	{
+		std::set<FireRenderObject*> unique(staged.begin(), staged.end());
+
+		if (unique.size() != staged.size() || unique.size() != dirtyList.objects.size())
+			return false;
+
+		for (const auto& it : dirtyList.objects)
+		{
+			if (unique.count(it.first) == 0)
+				return false;
+		}
+
+		return true;
+	}
+}
+
+BENCHMARK("DirtyObjects/callbackStormDirect", [](Benchmark::State& state)
+{
+	std::vector<char> storage;
+	std::vector<FireRenderObject*> objects = MakeObjects(storage);
+	DirtyList dirtyList;
+
+	state.Start();
+	RunStorm(objects, [&dirtyList](FireRenderObject* object) { dirtyList.Add(object); });
+	state.Stop();
+
+	state.SetCounter("callbacks", double(ThreadCount) * CallbacksPerThread);
+	state.SetCounter("locks", double(dirtyList.lockCount));
+	state.SetCounter("dirtyObjects", double(dirtyList.objects.size()));
+});
+
+BENCHMARK("DirtyObjects/callbackStormStaged", [](Benchmark::State& state)
+{
+	std::vector<char> storage;
+	std::vector<FireRenderObject*> objects = MakeObjects(storage);
+	DirtyList dirtyList;
+	DirtyObjectStaging staging;
+
+	state.Start();
+	RunStorm(objects, [&staging](FireRenderObject* object) { staging.Stage(object); });
+
+	// refresh tick, as FireRenderContext::FlushDirtyObjects
+	std::vector<FireRenderObject*> staged;
+	staging.Flush(staged);
+	{
+		std::lock_guard<std::mutex> lock(dirtyList.mutex);
+		dirtyList.lockCount++;
+
+		for (FireRenderObject* object : staged)
+			dirtyList.objects[object];
+	}
+	state.Stop();
+
+	state.SetCounter("callbacks", double(ThreadCount) * CallbacksPerThread);
+	state.SetCounter("locks", double(dirtyList.lockCount));
+	state.SetCounter("dirtyObjects", double(dirtyList.objects.size()));
+	state.SetCounter("pendingAfterFlush", staging.HasPending() ? 1.0 : 0.0);
+});
+
+BENCHMARK("DirtyObjects/attributeFilter", [](Benchmark::State& state)
+{
+	const int Count = 1000000;
+	int ignored = 0;
+
+	state.Start();
+	for (int i = 0; i < Count; i++)
+	{
+		if (DirtyObjectStaging::IsIgnoredAttribute(DirtiedAttributes[i % DirtiedAttributeCount]))
+			ignored++;
+	}
+	state.Stop();
+
+	state.SetCounter("ignored%", 100.0 * ignored / Count);
+});
+
+TEST("DirtyObjects/stagedEqualsSerial", [](Benchmark::State& state)
+{
+	// more objects than callbacks, so the dirty set is a part of them, and fewer than fit into the table
+	const int callbacks = 400;
+	std::vector<char> storage;
+	std::vector<FireRenderObject*> objects = MakeObjects(storage, 20000);
+
+	DirtyList serial;
+	RunSerial(objects, serial, callbacks);
+
+	DirtyObjectStaging staging;
+	RunStorm(objects, [&staging](FireRenderObject* object) { staging.Stage(object); }, callbacks);
+
+	CHECK(staging.HasPending());
+
+	std::vector<FireRenderObject*> staged;
+	staging.Flush(staged);
+
+	CHECK(SameObjects(serial, staged));
+	CHECK(!staging.HasPending());
+
+	// nothing is left for the next refresh
+	std::vector<FireRenderObject*> next;
+	staging.Flush(next);
+	CHECK(next.empty());
+
+	// the direct path locks the dirty list per callback, the staged one never
+	CHECK(serial.lockCount == ThreadCount * callbacks);
+	CHECK(staging.OverflowLockCount() == 0);
+});
+
+TEST("DirtyObjects/flushDuringStorm", [](Benchmark::State& state)
+{
+	const int callbacks = 50000;
+	std::vector<char> storage;
+	std::vector<FireRenderObject*> objects = MakeObjects(storage, 1000);
+
+	DirtyList serial;
+	RunSerial(objects, serial, callbacks);
+
+	// refreshes while callbacks arrive, every object staged comes out of some flush
+	DirtyObjectStaging staging;
+	std::vector<FireRenderObject*> flushed;
+	std::atomic<bool> storming(true);
+	int flushes = 0;
+
+	std::thread refresh([&]()
+	{
+		while (storming.load())
+		{
+			staging.Flush(flushed);
+			flushes++;
+		}
+	});
+
+	RunStorm(objects, [&staging](FireRenderObject* object) { staging.Stage(object); }, callbacks);
+	storming.store(false);
+	refresh.join();
+
+	staging.Flush(flushed);
+
+	std::set<FireRenderObject*> unique(flushed.begin(), flushed.end());
+	std::vector<FireRenderObject*> uniqueObjects(unique.begin(), unique.end());
+
+	CHECK(flushes > 0);
+	CHECK(SameObjects(serial, uniqueObjects));
+	CHECK(!staging.HasPending());
+	CHECK(staging.OverflowLockCount() == 0);
+});
+
+TEST("DirtyObjects/overflowAndDiscard", [](Benchmark::State& state)
+{
+	std::vector<char> storage;
+	std::vector<FireRenderObject*> objects = MakeObjects(storage, DirtyObjectStaging::SlotCount * 2);
+
+	DirtyObjectStaging staging;
+
+	// more objects than slots, twice, the rest goes through the overflow list
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (FireRenderObject* object : objects)
+			staging.Stage(object);
+	}
+
+	CHECK(staging.OverflowLockCount() > 0);
+	CHECK(staging.OverflowLockCount() < 2 * objects.size());
+
+	// destroyed objects don't come out, whether in the table or in the overflow list
+	staging.Discard(objects.front());
+	staging.Discard(objects.back());
+
+	std::vector<FireRenderObject*> staged;
+	staging.Flush(staged);
+
+	std::set<FireRenderObject*> unique(staged.begin(), staged.end());
+	CHECK(unique.size() == staged.size());
+	CHECK(staged.size() == objects.size() - 2);
+	CHECK(unique.count(objects.front()) == 0 && unique.count(objects.back()) == 0);
+	CHECK(!staging.HasPending());
+
+	// a discarded slot doesn't hide the object when it is staged again
+	size_t locks = staging.OverflowLockCount();
+	staging.Stage(objects[1]);
+	staging.Discard(objects[1]);
+	staging.Stage(objects[1]);
+
+	staged.clear();
+	staging.Flush(staged);
+	CHECK(staged.size() == 1 && staged[0] == objects[1]);
+	CHECK(staging.OverflowLockCount() == locks);
+});
+
+TEST("DirtyObjects/displayOnlyPlugsSkipped", [](Benchmark::State& state)
+{
+	// drawing and outliner state of a moved transform
+	CHECK(DirtyObjectStaging::IsIgnoredAttribute("isHistoricallyInteresting"));
+	CHECK(DirtyObjectStaging::IsIgnoredAttribute("objectColorRGB"));
+	CHECK(DirtyObjectStaging::IsIgnoredAttribute("displayLocalAxis"));
+	CHECK(DirtyObjectStaging::IsIgnoredAttribute("overrideColorRGB"));
+	CHECK(DirtyObjectStaging::IsIgnoredAttribute("uiTreatment"));
+	CHECK(DirtyObjectStaging::IsIgnoredAttribute("backfaceCulling"));
+	CHECK(DirtyObjectStaging::IsIgnoredAttribute("wireColorRGB"));
+
+	// anything which can change the render
+	CHECK(!DirtyObjectStaging::IsIgnoredAttribute("translateX"));
+	CHECK(!DirtyObjectStaging::IsIgnoredAttribute("matrix"));
+	CHECK(!DirtyObjectStaging::IsIgnoredAttribute("worldMatrix"));
+	CHECK(!DirtyObjectStaging::IsIgnoredAttribute("visibility"));
+	CHECK(!DirtyObjectStaging::IsIgnoredAttribute("drawOverride"));
+	CHECK(!DirtyObjectStaging::IsIgnoredAttribute("overrideEnabled"));
+	CHECK(!DirtyObjectStaging::IsIgnoredAttribute(""));
+	CHECK(!DirtyObjectStaging::IsIgnoredAttribute(nullptr));
+
+	// half of the plugs of the benchmark storm
+	int ignored = 0;
+	for (const char* name : DirtiedAttributes)
+		ignored += DirtyObjectStaging::IsIgnoredAttribute(name);
+
+	CHECK(ignored == 5);
+});
@@ -0,0 +1,247 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "Lights/IES/IESProfileCache.h"
+
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+	// a stage with many fixtures using a few photometric profiles
+	const int LightCount = 400;
+	const int ProfileCount = 4;
+
+	// angles of a typical type C profile
+	const int VerticalAngles = 181;
+	const int HorizontalAngles = 73;
+
+	const size_t PointsPerPolyline = 32;
+
+	// LM-63 file with a seeded candela distribution
+	void WriteProfile(const std::filesystem::path& path, uint32_t seed)
+	{
+		BenchmarkScenes::Random random(seed);
+
+		std::ofstream file(path);
+		file << "IESNA:LM-63-2002\n[TEST] benchmark fixture " << seed << "\nTILT=NONE\n";
+		file << "1 -1 1 " << VerticalAngles << " " << HorizontalAngles << " 1 2 0.3 0.3 0\n1 1 0\n";
+
+		for (int i = 0; i < VerticalAngles; i++)
+			file << i * 180.0 / (VerticalAngles - 1) << (i + 1 < VerticalAngles ? " " : "\n");
+
+		for (int i = 0; i < HorizontalAngles; i++)
+			file << i * 360.0 / (HorizontalAngles - 1) << (i + 1 < HorizontalAngles ? " " : "\n");
+
+		for (int h = 0; h < HorizontalAngles; h++)
+		{
+			for (int v = 0; v < VerticalAngles; v++)
+				file << 1000.0f * (0.5f + random.NextFloat()) << (v + 1 < VerticalAngles ? " " : "\n");
+		}
+	}
+
+	// Stands in for IESProcessor and CalculateIESLightRepresentation: reads all values,
+	// normalizes the profile text and builds the web of one polyline per horizontal angle
+	std::shared_ptr<IESProfileCache::Profile> LoadProfile(const std::wstring& path)
+	{
+		auto profile = std::make_shared<IESProfileCache::Profile>();
+
+		std::ifstream file{ std::filesystem::path(path) };
+		std::string line;
+
+		while (std::getline(file, line) && line.rfind("TILT=", 0) != 0)
+		{
+		}
+
+		std::vector<double> values;
+		double value;
+
+		while (file >> value)
+			values.push_back(value);
+
+		if (values.size() < 13)
+		{
+			profile->errorMessage = "Invalid data in ies file";
+			return profile;
+		}
+
+		size_t verticalCount = size_t(values[3]);
+		size_t horizontalCount = size_t(values[4]);
+		const double* vertical = &values[13];
+		const double* horizontal = vertical + verticalCount;
+		const double* candela = horizontal + horizontalCount;
+
+		if (values.size() < 13 + verticalCount + horizontalCount + verticalCount * horizontalCount)
+		{
+			profile->errorMessage = "Unexpected end of ies file";
+			return profile;
+		}
+
+		std::ostringstream data;
+		for (double v : values)
+			data << v << " ";
+
+		profile->isParsed = true;
+		profile->iesData = data.str();
+
+		double maxCandela = 0.0;
+		for (size_t i = 0; i < verticalCount * horizontalCount; i++)
+			maxCandela = std::max(maxCandela, candela[i]);
+
+		const double toRadians = 3.14159265358979 / 180.0;
+		size_t step = std::max<size_t>(1, verticalCount / PointsPerPolyline);
+
+		for (size_t h = 0; h < horizontalCount; h++)
+		{
+			unsigned int first = unsigned(profile->vertices.size() / 3);
+
+			for (size_t v = 0; v < verticalCount; v += step)
+			{
+				double r = 0.05 * candela[h * verticalCount + v] / maxCandela;
+				double theta = vertical[v] * toRadians;
+				double phi = horizontal[h] * toRadians;
+
+				profile->vertices.insert(profile->vertices.end(), {
+					float(r * std::sin(theta) * std::cos(phi)),
+					float(r * std::sin(theta) * std::sin(phi)),
+					float(-r * std::cos(theta)) });
+			}
+
+			unsigned int last = unsigned(profile->vertices.size() / 3);
+			for (unsigned int i = first; i + 1 < last; i++)
+				profile->indices.insert(profile->indices.end(), { i, i + 1 });
+		}
+
+		profile->hasRepresentation = true;
+
+		return profile;
+	}
+
+	struct ProfileFixture
+	{
+		std::filesystem::path directory;
+		std::vector<std::wstring> paths;
+
+		ProfileFixture()
+		{
+			directory = std::filesystem::temp_directory_path() / "rpr_ies_profile_cache_benchmark";
+			std::filesystem::remove_all(directory);
+			std::filesystem::create_directories(directory);
+
+			for (int i = 0; i < ProfileCount; i++)
+			{
+				std::filesystem::path path = directory / ("fixture" + std::to_string(i) + ".ies");
+				WriteProfile(path, 71 + i);
+				paths.push_back(path.wstring());
+			}
+		}
+
+		~ProfileFixture()
+		{
+			std::error_code error;
+			std::filesystem::remove_all(directory, error);
+		}
+
+		const std::wstring& LightProfile(int light) const { return paths[light % ProfileCount]; }
+	};
+
+	bool SameProfile(const IESProfileCache::Profile& a, const IESProfileCache::Profile& b)
+	{
+		return a.isParsed == b.isParsed && a.iesData == b.iesData && a.vertices == b.vertices && a.indices == b.indices;
+	}
+}
+
+// Former behaviour: every light and every locator parses its file
+BENCHMARK("IESProfileCache/parsePerLight", [](Benchmark::State& state)
+{
+	ProfileFixture fixture;
+	std::vector<std::shared_ptr<const IESProfileCache::Profile>> lights(LightCount);
+
+	state.Start();
+	for (int i = 0; i < LightCount; i++)
+		lights[i] = LoadProfile(fixture.LightProfile(i));
+	state.Stop();
+
+	state.SetCounter("parses", double(LightCount));
+	state.SetCounter("webVertices", double(lights[0]->vertices.size() / 3));
+});
+
+BENCHMARK("IESProfileCache/shared", [](Benchmark::State& state)
+{
+	ProfileFixture fixture;
+	IESProfileCache cache(LoadProfile);
+	std::vector<std::shared_ptr<const IESProfileCache::Profile>> lights(LightCount);
+
+	state.Start();
+	for (int i = 0; i < LightCount; i++)
+		lights[i] = cache.Get(fixture.LightProfile(i));
+	state.Stop();
+
+	state.SetCounter("parses", double(cache.LoadCount()));
+});
+
+TEST("IESProfileCache/sharedEqualsFreshParse", [](Benchmark::State& state)
+{
+	ProfileFixture fixture;
+	IESProfileCache cache(LoadProfile);
+	std::vector<std::shared_ptr<const IESProfileCache::Profile>> lights(LightCount);
+
+	for (int i = 0; i < LightCount; i++)
+		lights[i] = cache.Get(fixture.LightProfile(i));
+
+	// one parse per file
+	CHECK(cache.LoadCount() == size_t(ProfileCount));
+
+	// lights of one file hold the same profile
+	int mismatches = 0;
+	for (int i = 0; i < LightCount; i++)
+		mismatches += lights[i] != lights[i % ProfileCount];
+
+	CHECK(mismatches == 0);
+
+	// equal to a fresh parse of the file
+	for (int i = 0; i < ProfileCount; i++)
+		CHECK(SameProfile(*lights[i], *LoadProfile(fixture.paths[i])));
+
+	CHECK(lights[0]->isParsed);
+	CHECK(lights[0] != lights[1]);
+});
+
+TEST("IESProfileCache/editedFileReparsed", [](Benchmark::State& state)
+{
+	ProfileFixture fixture;
+	IESProfileCache cache(LoadProfile);
+
+	auto before = cache.Get(fixture.paths[0]);
+	CHECK(cache.LoadCount() == 1);
+
+	// another distribution of another size, the file must be parsed again
+	WriteProfile(fixture.paths[0], 997);
+
+	auto after = cache.Get(fixture.paths[0]);
+	auto again = cache.Get(fixture.paths[0]);
+
+	CHECK(cache.LoadCount() == 2);
+	CHECK(!SameProfile(*before, *after));
+	CHECK(SameProfile(*after, *LoadProfile(fixture.paths[0])));
+	CHECK(after == again);
+
+	// lights still holding the old profile keep it intact
+	CHECK(before->isParsed);
+
+	CHECK(!cache.Get(fixture.directory.wstring() + L"/missing.ies")->isParsed);
+});
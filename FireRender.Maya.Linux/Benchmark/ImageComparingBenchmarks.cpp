@@ -0,0 +1,234 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "ImageComparingMetrics.h"
+
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	// 8K UHD
+	const int Width = 7680;
+	const int Height = 4320;
+
+	void RunCompare(Benchmark::State& state, bool computeSsim, double rmseThreshold)
+	{
+		static const std::vector<float> image1 = BenchmarkScenes::MakeImage(Width, Height, 4, 1);
+		static const std::vector<float> image2 = BenchmarkScenes::MakeImage(Width, Height, 4, 2);
+
+		ImageComparing::Params params;
+		params.computeSsim = computeSsim;
+		params.rmseThreshold = rmseThreshold;
+
+		ImageComparing::Result result;
+
+		state.Start();
+		ImageComparing::Compare(image1.data(), image2.data(), Width, Height, 4, params, result);
+		state.Stop();
+
+		state.SetCounter("rmse*1e4", result.rmse * 1e4);
+		state.SetCounter("exceeded", result.thresholdExceeded ? 1 : 0);
+	}
+
+	bool Near(double a, double b)
+	{
+		return std::fabs(a - b) < 1e-9;
+	}
+
+	// 5x2 single channel, second row identical. Width 5 covers both the lane loop and the tail.
+	// Differences 0.5, 0.25, 0.25, 0.5, 1: SSE 1.625, SAE 2.5 over 10 samples.
+	const float RampDiff[] = { 0.5f, 0.25f, 0.25f, 0.5f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+	const float RampZero[10] = {};
+
+	// 2x2 checkers of opposite phase
+	const float CheckerA[] = { 0.0f, 1.0f, 0.0f, 1.0f };
+	const float CheckerB[] = { 1.0f, 0.0f, 1.0f, 0.0f };
+
+	const float NanRow[] = { 0.0f, std::numeric_limits<float>::quiet_NaN(), 0.0f, 0.0f, 0.0f };
+
+	ImageComparing::Result CompareRamp(double rmseThreshold, double maxErrorThreshold)
+	{
+		ImageComparing::Params params;
+		params.rmseThreshold = rmseThreshold;
+		params.maxErrorThreshold = maxErrorThreshold;
+
+		ImageComparing::Result result;
+		ImageComparing::Compare(RampZero, RampDiff, 5, 2, 1, params, result);
+
+		return result;
+	}
+}
+
+TEST("ImageComparing/identical", [](Benchmark::State& state)
+{
+	std::vector<float> image = BenchmarkScenes::MakeImage(13, 7, 4, 1);
+
+	ImageComparing::Result result;
+	CHECK(ImageComparing::Compare(image.data(), image.data(), 13, 7, 4, ImageComparing::Params(), result));
+	CHECK(!result.thresholdExceeded);
+	CHECK(result.rmse == 0.0);
+	CHECK(result.channels.size() == 4);
+
+	for (const ImageComparing::ChannelMetrics& channel : result.channels)
+	{
+		CHECK(channel.meanAbsError == 0.0);
+		CHECK(channel.rmse == 0.0);
+		CHECK(channel.maxError == 0.0);
+		CHECK(std::isinf(channel.psnr) && channel.psnr > 0.0);
+		CHECK(Near(channel.ssim, 1.0));
+	}
+});
+
+TEST("ImageComparing/singleChannelErrors", [](Benchmark::State& state)
+{
+	ImageComparing::Result result = CompareRamp(-1.0, -1.0);
+	CHECK(!result.thresholdExceeded);
+	CHECK(result.channels.size() == 1);
+
+	const ImageComparing::ChannelMetrics& channel = result.channels[0];
+	CHECK(Near(channel.meanAbsError, 0.25));
+	CHECK(Near(channel.rmse, std::sqrt(0.1625)));
+	CHECK(channel.maxError == 1.0);
+	CHECK(Near(channel.psnr, 10.0 * std::log10(1.0 / 0.1625)));
+	CHECK(Near(result.rmse, std::sqrt(0.1625)));
+});
+
+TEST("ImageComparing/perChannelErrors", [](Benchmark::State& state)
+{
+	// 3x3 RGBA of 0.5, blue is 0.75 in the second image; one SSIM block covers the image
+	std::vector<float> image1(3 * 3 * 4, 0.5f);
+	std::vector<float> image2 = image1;
+	for (size_t i = 2; i < image2.size(); i += 4)
+		image2[i] = 0.75f;
+
+	ImageComparing::Result result;
+	CHECK(ImageComparing::Compare(image1.data(), image2.data(), 3, 3, 4, ImageComparing::Params(), result));
+
+	const ImageComparing::ChannelMetrics& blue = result.channels[2];
+	CHECK(Near(blue.meanAbsError, 0.25));
+	CHECK(Near(blue.rmse, 0.25));
+	CHECK(Near(blue.maxError, 0.25));
+	CHECK(Near(blue.psnr, 10.0 * std::log10(16.0)));
+
+	// zero variance, so SSIM reduces to the luminance term (2 * 0.5 * 0.75 + c1) / (0.5^2 + 0.75^2 + c1)
+	CHECK(Near(blue.ssim, (0.75 + 1e-4) / (0.8125 + 1e-4)));
+
+	for (unsigned int c = 0; c < 4; c++)
+	{
+		if (c == 2)
+			continue;
+
+		CHECK(result.channels[c].rmse == 0.0);
+		CHECK(result.channels[c].maxError == 0.0);
+		CHECK(Near(result.channels[c].ssim, 1.0));
+	}
+
+	// only a quarter of all samples differ
+	CHECK(Near(result.rmse, 0.125));
+});
+
+TEST("ImageComparing/anticorrelatedSsim", [](Benchmark::State& state)
+{
+	ImageComparing::Params params;
+	params.ssimBlockSize = 2;
+
+	ImageComparing::Result result;
+	CHECK(ImageComparing::Compare(CheckerA, CheckerB, 2, 2, 1, params, result));
+
+	// equal means and variances 0.25, covariance -0.25: SSIM is (2 * -0.25 + c2) / (0.25 + 0.25 + c2)
+	CHECK(Near(result.channels[0].ssim, (-0.5 + 9e-4) / (0.5 + 9e-4)));
+	CHECK(result.channels[0].maxError == 1.0);
+	CHECK(Near(result.channels[0].rmse, 1.0));
+});
+
+TEST("ImageComparing/genericChannelCount", [](Benchmark::State& state)
+{
+	// 2x1 image with 5 channels, channel 3 of the second pixel differs by 0.5
+	std::vector<float> image1(2 * 5, 0.25f);
+	std::vector<float> image2 = image1;
+	image2[5 + 3] = 0.75f;
+
+	ImageComparing::Params params;
+	params.computeSsim = false;
+
+	ImageComparing::Result result;
+	CHECK(ImageComparing::Compare(image1.data(), image2.data(), 2, 1, 5, params, result));
+	CHECK(result.channels.size() == 5);
+
+	for (unsigned int c = 0; c < 5; c++)
+	{
+		const ImageComparing::ChannelMetrics& channel = result.channels[c];
+
+		CHECK(Near(channel.meanAbsError, c == 3 ? 0.25 : 0.0));
+		CHECK(Near(channel.rmse, c == 3 ? std::sqrt(0.125) : 0.0));
+		CHECK(Near(channel.maxError, c == 3 ? 0.5 : 0.0));
+	}
+
+	CHECK(Near(result.rmse, std::sqrt(0.25 / 10.0)));
+});
+
+TEST("ImageComparing/nanIsInfiniteError", [](Benchmark::State& state)
+{
+	ImageComparing::Result result;
+	CHECK(ImageComparing::Compare(NanRow, RampZero, 5, 1, 1, ImageComparing::Params(), result));
+	CHECK(std::isinf(result.channels[0].maxError));
+	CHECK(std::isinf(result.channels[0].rmse));
+	CHECK(std::isinf(result.rmse));
+});
+
+TEST("ImageComparing/thresholds", [](Benchmark::State& state)
+{
+	// RMSE is sqrt(0.1625) ~ 0.403, max error is 1
+	ImageComparing::Result result = CompareRamp(0.5, -1.0);
+	CHECK(!result.thresholdExceeded);
+	CHECK(Near(result.rmse, std::sqrt(0.1625)));
+
+	result = CompareRamp(0.1, -1.0);
+	CHECK(result.thresholdExceeded);
+
+	// max error has to be strictly above the threshold
+	result = CompareRamp(-1.0, 1.0);
+	CHECK(!result.thresholdExceeded);
+
+	result = CompareRamp(-1.0, 0.75);
+	CHECK(result.thresholdExceeded);
+
+	// exceeding either one stops the comparison
+	result = CompareRamp(0.5, 0.75);
+	CHECK(result.thresholdExceeded);
+});
+
+TEST("ImageComparing/invalidSize", [](Benchmark::State& state)
+{
+	ImageComparing::Result result;
+	CHECK(!ImageComparing::Compare(RampZero, RampDiff, 0, 2, 1, ImageComparing::Params(), result));
+	CHECK(!ImageComparing::Compare(RampZero, RampDiff, 5, 2, 0, ImageComparing::Params(), result));
+});
+
+BENCHMARK("ImageComparing/8K_RGBA_errors", [](Benchmark::State& state)
+{
+	RunCompare(state, false, -1.0);
+});
+
+BENCHMARK("ImageComparing/8K_RGBA_errors_ssim", [](Benchmark::State& state)
+{
+	RunCompare(state, true, -1.0);
+});
+
+BENCHMARK("ImageComparing/8K_RGBA_early_exit", [](Benchmark::State& state)
+{
+	RunCompare(state, true, 0.001);
+});
@@ -0,0 +1,264 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+
+#include "MayaStandardNodesSupport/LayeredTextureBlend.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+	/** Stand-in for RPR values: numbers that remember whether they are constant or come from a node */
+	struct TestValue
+	{
+		TestValue(double s = 0.0) : isConstant(true)
+		{
+			std::fill(c, c + 3, float(s));
+		}
+
+		TestValue(float r, float g, float b, bool constant) : isConstant(constant)
+		{
+			c[0] = r;
+			c[1] = g;
+			c[2] = b;
+		}
+
+		float c[3];
+		bool isConstant;
+	};
+
+	class TestOps
+	{
+	public:
+		typedef TestValue Value;
+
+		Value Mul(const Value& a, const Value& b) const { return Apply(a, b, [](float x, float y) { return x * y; }); }
+		Value Add(const Value& a, const Value& b) const { return Apply(a, b, [](float x, float y) { return x + y; }); }
+		Value Sub(const Value& a, const Value& b) const { return Apply(a, b, [](float x, float y) { return x - y; }); }
+		Value Max(const Value& a, const Value& b) const { return Apply(a, b, [](float x, float y) { return std::max(x, y); }); }
+		Value Min(const Value& a, const Value& b) const { return Apply(a, b, [](float x, float y) { return std::min(x, y); }); }
+		Value Abs(const Value& a) const { return Apply(a, a, [](float x, float) { return std::fabs(x); }); }
+
+		bool IsConstant(const Value& v) const { return v.isConstant; }
+		bool IsZero(const Value& v) const { return v.isConstant && v.c[0] == 0.0f && v.c[1] == 0.0f && v.c[2] == 0.0f; }
+		bool IsOne(const Value& v) const { return v.isConstant && v.c[0] == 1.0f && v.c[1] == 1.0f && v.c[2] == 1.0f; }
+
+	private:
+		template <typename Op>
+		static Value Apply(const Value& a, const Value& b, Op op)
+		{
+			return Value(op(a.c[0], b.c[0]), op(a.c[1], b.c[1]), op(a.c[2], b.c[2]), a.isConstant && b.isConstant);
+		}
+	};
+
+	typedef LayeredTextureBlend::Layer<TestValue> TestLayer;
+	typedef LayeredTextureBlend::BlendMode BlendMode;
+
+	const int ModeCount = int(BlendMode::Illuminate) + 1;
+
+	// exact 0 and 1 exercise culling
+	const float TestAlphas[] = { 0.0f, 0.35f, 1.0f };
+
+	float MaxDifference(const TestValue& a, const TestValue& b)
+	{
+		float result = 0.0f;
+		for (int c = 0; c < 3; c++)
+			result = std::max(result, std::fabs(a.c[c] - b.c[c]));
+
+		return result;
+	}
+
+	TestLayer MakeLayer(BlendMode mode, const TestValue& color, float alpha)
+	{
+		TestLayer layer;
+		layer.mode = mode;
+		layer.color = color;
+		layer.alpha = TestValue(alpha);
+		layer.isVisible = true;
+		return layer;
+	}
+
+	// Reference: every visible layer blended bottom up with BlendColor / BlendAlpha, no culling or folding
+	TestValue BlendSequentially(const std::vector<TestLayer>& layers, bool isColor)
+	{
+		TestOps ops;
+		TestValue result = isColor ? TestValue(0.0) : TestValue(1.0);
+
+		for (auto layer = layers.rbegin(); layer != layers.rend(); layer++)
+		{
+			if (!layer->isVisible)
+				continue;
+
+			result = isColor ? LayeredTextureBlend::BlendColor(ops, result, *layer) : LayeredTextureBlend::BlendAlpha(ops, result, *layer);
+		}
+
+		return result;
+	}
+
+	std::vector<BlendMode> Modes(const std::vector<TestLayer>& layers)
+	{
+		std::vector<BlendMode> modes;
+		for (const TestLayer& layer : layers)
+			modes.push_back(layer.mode);
+
+		return modes;
+	}
+}
+
+TEST("LayeredTexture/foldedConstantsMatchBlend", [](Benchmark::State& state)
+{
+	TestOps ops;
+	TestValue color(0.8f, 0.25f, 0.5f, true);
+	std::vector<TestValue> backgrounds(3, TestValue(0.0));
+	backgrounds[1] = TestValue(0.3f, 0.9f, 0.6f, false);
+	backgrounds[2] = TestValue(1.0);
+
+	for (int mode = 0; mode < ModeCount; mode++)
+	{
+		BlendMode blendMode = BlendMode(mode);
+		bool dependsOnBackground = blendMode == BlendMode::Difference || blendMode == BlendMode::Lighten || blendMode == BlendMode::Darken;
+
+		for (float alpha : TestAlphas)
+		{
+			TestLayer layer = MakeLayer(blendMode, color, alpha);
+
+			TestValue colorScale;
+			TestValue colorOffset;
+			bool colorFolded = LayeredTextureBlend::GetConstantBlend(ops, layer, true, colorScale, colorOffset);
+			CHECK(colorFolded == !dependsOnBackground);
+
+			TestValue alphaScale;
+			TestValue alphaOffset;
+			CHECK(LayeredTextureBlend::GetConstantBlend(ops, layer, false, alphaScale, alphaOffset));
+
+			for (const TestValue& background : backgrounds)
+			{
+				if (colorFolded)
+				{
+					TestValue folded = ops.Add(ops.Mul(background, colorScale), colorOffset);
+					CHECK(MaxDifference(folded, LayeredTextureBlend::BlendColor(ops, background, layer)) < 1e-6f);
+				}
+
+				TestValue folded = ops.Add(ops.Mul(background, alphaScale), alphaOffset);
+				CHECK(MaxDifference(folded, LayeredTextureBlend::BlendAlpha(ops, background, layer)) < 1e-6f);
+			}
+		}
+	}
+});
+
+TEST("LayeredTexture/nodeInputsAreNotFolded", [](Benchmark::State& state)
+{
+	TestOps ops;
+	TestValue scale;
+	TestValue offset;
+
+	for (int mode = 0; mode < ModeCount; mode++)
+	{
+		BlendMode blendMode = BlendMode(mode);
+		bool blendsAlpha = blendMode == BlendMode::None || blendMode == BlendMode::Over || blendMode == BlendMode::In || blendMode == BlendMode::Out;
+
+		TestLayer nodeColor = MakeLayer(blendMode, TestValue(0.5f, 0.5f, 0.5f, false), 0.5f);
+		CHECK(!LayeredTextureBlend::GetConstantBlend(ops, nodeColor, true, scale, offset));
+
+		TestLayer nodeAlpha = MakeLayer(blendMode, TestValue(0.5), 0.5f);
+		nodeAlpha.alpha.isConstant = false;
+		CHECK(!LayeredTextureBlend::GetConstantBlend(ops, nodeAlpha, true, scale, offset));
+
+		// colour blend modes pass the alpha through whatever it is
+		CHECK(LayeredTextureBlend::GetConstantBlend(ops, nodeAlpha, false, scale, offset) == !blendsAlpha);
+	}
+});
+
+TEST("LayeredTexture/cullLayers", [](Benchmark::State& state)
+{
+	TestOps ops;
+	TestValue red(1.0f, 0.0f, 0.0f, true);
+	TestValue node(0.2f, 0.4f, 0.6f, false);
+
+	// hidden and transparent layers are removed, everything under an opaque Over is dropped
+	std::vector<TestLayer> layers;
+	layers.push_back(MakeLayer(BlendMode::Add, red, 0.5f));
+	layers.push_back(MakeLayer(BlendMode::Multiply, node, 0.0f));
+	layers.push_back(MakeLayer(BlendMode::Difference, node, 0.7f));
+	layers.back().isVisible = false;
+	layers.push_back(MakeLayer(BlendMode::Lighten, node, 0.7f));
+	layers.push_back(MakeLayer(BlendMode::Over, red, 1.0f));
+	layers.push_back(MakeLayer(BlendMode::Darken, node, 0.5f));
+
+	std::vector<TestLayer> culled = LayeredTextureBlend::Cull(ops, layers);
+	std::vector<BlendMode> expected;
+	expected.push_back(BlendMode::Add);
+	expected.push_back(BlendMode::Lighten);
+	expected.push_back(BlendMode::None);
+	CHECK(Modes(culled) == expected);
+	CHECK(MaxDifference(culled.back().color, red) == 0.0f);
+
+	// In with alpha 0 clears everything below it
+	layers[3] = MakeLayer(BlendMode::In, node, 0.0f);
+	culled = LayeredTextureBlend::Cull(ops, layers);
+	expected.pop_back();
+	expected.back() = BlendMode::None;
+	CHECK(Modes(culled) == expected);
+	CHECK(ops.IsZero(culled.back().color) && ops.IsZero(culled.back().alpha));
+
+	// alpha from a node can't be culled
+	layers[1].alpha.isConstant = false;
+	layers[3] = MakeLayer(BlendMode::Over, red, 1.0f);
+	layers[3].alpha.isConstant = false;
+	culled = LayeredTextureBlend::Cull(ops, layers);
+	CHECK(culled.size() == 4);
+	CHECK(culled[2].mode == BlendMode::Over);
+	CHECK(culled[3].mode == BlendMode::None);
+
+	// a None layer hides everything below it
+	layers[0].mode = BlendMode::None;
+	culled = LayeredTextureBlend::Cull(ops, layers);
+	CHECK(culled.size() == 1);
+	CHECK(culled[0].mode == BlendMode::None);
+});
+
+TEST("LayeredTexture/processMatchesSequentialBlend", [](Benchmark::State& state)
+{
+	TestOps ops;
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::uniform_int_distribution<int> modes(0, ModeCount - 1);
+
+	float maxDifference = 0.0f;
+
+	for (int stack = 0; stack < 2000; stack++)
+	{
+		std::vector<TestLayer> layers(1 + stack % 8);
+
+		for (TestLayer& layer : layers)
+		{
+			layer.mode = BlendMode(modes(random));
+			layer.color = TestValue(unit(random), unit(random), unit(random), unit(random) < 0.7f);
+
+			layer.alpha = unit(random) < 0.5f ? TestValue(TestAlphas[random() % 3]) : TestValue(unit(random));
+			layer.alpha.isConstant = unit(random) < 0.8f;
+			layer.isVisible = unit(random) < 0.9f;
+		}
+
+		for (int isColor = 0; isColor < 2; isColor++)
+		{
+			TestValue processed = LayeredTextureBlend::Process(ops, LayeredTextureBlend::Cull(ops, layers), isColor != 0);
+			maxDifference = std::max(maxDifference, MaxDifference(processed, BlendSequentially(layers, isColor != 0)));
+		}
+	}
+
+	CHECK(maxDifference < 1e-5f);
+});
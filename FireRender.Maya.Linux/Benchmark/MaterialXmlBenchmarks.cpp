@@ -0,0 +1,352 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "MaterialXmlParser.h"
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <regex>
+#include <set>
+#include <sstream>
+
+namespace
+{
+	// a material library export with many node graphs, small enough for the former reader
+	const int NodeCount = 3000;
+	const int ParamsPerNode = 8;
+
+	// images used all over the graphs
+	const int ImageCount = 24;
+
+	const char* const NodeTypes[] = { "UBER", "IMAGE_TEXTURE", "INPUT_TEXTURE", "ARITHMETIC", "BLEND_VALUE", "NORMAL_MAP" };
+
+	std::string ImageName(int image)
+	{
+		return "maps/texture" + std::to_string(image) + ".png";
+	}
+
+	std::string MakeDocument(int nodeCount, uint32_t seed)
+	{
+		BenchmarkScenes::Random random(seed);
+
+		std::ostringstream xml;
+		xml << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
+		xml << "<material name=\"Synthetic\" version_rpr=\"1036a0\">\n";
+		xml << "    <description></description>\n";
+
+		for (int i = 0; i < nodeCount; i++)
+		{
+			const char* type = NodeTypes[random.Next() % 6];
+			xml << "    <node name=\"node" << i << "\" type=\"" << type << "\">\n";
+
+			for (int p = 0; p < ParamsPerNode; p++)
+			{
+				xml << "        <param name=\"input" << p << "\" ";
+
+				uint32_t kind = random.Next() % 8;
+				if (kind == 0 && i + 1 < nodeCount)
+					xml << "type=\"connection\" value=\"node" << i + 1 + random.Next() % std::min(8, nodeCount - i - 1) << "\"";
+				else if (kind == 1)
+					xml << "type=\"file_path\" value=\"" << ImageName(random.Next() % ImageCount) << "\"";
+				else if (kind == 2)
+					xml << "type=\"uint\" value=\"" << random.Next() % 16 << "\"";
+				else
+					xml << "type=\"float4\" value=\"" << random.NextFloat() << ", " << random.NextFloat() << ", " << random.NextFloat() << ", 1\"";
+
+				xml << "/>\n";
+			}
+
+			xml << "    </node>\n";
+		}
+
+		xml << "</material>\n";
+
+		return xml.str();
+	}
+
+	// Former reader: regular expressions over the rest of the document, which is copied after each tag
+	void ParseWithRegex(std::string text, MaterialXml::Document& document)
+	{
+		std::regex nodeReg("<[^<^>]*>");
+		std::regex nameReg("[^<][^>\\s/]+");
+		std::regex attributesReg("[\\S]+=\".*?\"");
+		std::regex attributeReg("[^=?>\"]+");
+
+		std::smatch nodeMatch;
+		while (std::regex_search(text, nodeMatch, nodeReg))
+		{
+			std::string value = nodeMatch[0];
+			std::smatch nameMatch;
+			std::regex_search(value, nameMatch, nameReg);
+
+			std::string name = nameMatch.str();
+			std::string attributes = nameMatch.suffix().str();
+			std::map<std::string, std::string> atts;
+
+			for (auto i = std::sregex_iterator(attributes.begin(), attributes.end(), attributesReg); i != std::sregex_iterator(); ++i)
+			{
+				std::string att = i->str();
+				std::vector<std::string> split;
+				for (auto j = std::sregex_iterator(att.begin(), att.end(), attributeReg); j != std::sregex_iterator(); ++j)
+					split.push_back(j->str());
+
+				atts[split[0]] = split.size() == 2 ? split[1] : "";
+			}
+
+			if (name == "node")
+			{
+				document.nodes.emplace_back();
+				document.nodes.back().name = atts.at("name");
+				document.nodes.back().type = atts.at("type");
+			}
+			else if (name == "param" && !document.nodes.empty())
+			{
+				document.nodes.back().params.push_back({ atts.at("name"), atts.at("type"), atts.at("value") });
+			}
+
+			text = nodeMatch.suffix().str();
+		}
+	}
+
+	bool SameNodes(const MaterialXml::Document& a, const MaterialXml::Document& b)
+	{
+		if (a.nodes.size() != b.nodes.size())
+			return false;
+
+		for (size_t i = 0; i < a.nodes.size(); i++)
+		{
+			const MaterialXml::Node& na = a.nodes[i];
+			const MaterialXml::Node& nb = b.nodes[i];
+
+			if (na.name != nb.name || na.type != nb.type || na.params.size() != nb.params.size())
+				return false;
+
+			for (size_t p = 0; p < na.params.size(); p++)
+			{
+				if (na.params[p].name != nb.params[p].name || na.params[p].type != nb.params[p].type || na.params[p].value != nb.params[p].value)
+					return false;
+			}
+		}
+
+		return true;
+	}
+
+	// File path values of the document, each name once as in FireRenderXmlImportCmd::findImageFiles
+	std::vector<std::string> UniqueImageNames(const MaterialXml::Document& document, int& references)
+	{
+		std::vector<std::string> names;
+		std::set<std::string> unique;
+		references = 0;
+
+		for (const MaterialXml::Node& node : document.nodes)
+		{
+			for (const MaterialXml::Param& param : node.params)
+			{
+				if (param.type != "file_path")
+					continue;
+
+				references++;
+				if (unique.insert(param.value).second)
+					names.push_back(param.value);
+			}
+		}
+
+		return names;
+	}
+
+	struct LibraryFixture
+	{
+		std::filesystem::path directory;
+
+		LibraryFixture()
+		{
+			directory = std::filesystem::temp_directory_path() / "rpr_material_xml_benchmark";
+			std::filesystem::remove_all(directory);
+			std::filesystem::create_directories(directory / "maps");
+
+			// every other image is in the shared maps directory next to the material folder
+			std::filesystem::create_directories(directory / "material");
+			for (int i = 0; i < ImageCount; i++)
+			{
+				std::filesystem::path folder = i % 2 ? directory : directory / "material";
+				std::filesystem::create_directories(folder / "maps");
+				std::ofstream(folder / ImageName(i)) << "image";
+			}
+		}
+
+		~LibraryFixture()
+		{
+			std::error_code error;
+			std::filesystem::remove_all(directory, error);
+		}
+	};
+}
+
+BENCHMARK("MaterialXml/parseRegex", [](Benchmark::State& state)
+{
+	std::string text = MakeDocument(NodeCount, 5);
+	MaterialXml::Document document;
+
+	state.Start();
+	ParseWithRegex(text, document);
+	state.Stop();
+
+	state.SetCounter("nodes", double(document.nodes.size()));
+	state.SetCounter("KB", double(text.size()) / 1024.0);
+});
+
+BENCHMARK("MaterialXml/parse", [](Benchmark::State& state)
+{
+	std::string text = MakeDocument(NodeCount, 5);
+	MaterialXml::Document document;
+	std::string error;
+
+	state.Start();
+	bool parsed = MaterialXml::Parse(text, document, error);
+	state.Stop();
+
+	MaterialXml::Document reference;
+	ParseWithRegex(text, reference);
+
+	state.SetCounter("parsed", parsed ? 1.0 : 0.0);
+	state.SetCounter("nodes", double(document.nodes.size()));
+	state.SetCounter("sameAsRegex", SameNodes(document, reference) ? 1.0 : 0.0);
+});
+
+// Sizes only reachable with the single pass reader
+BENCHMARK("MaterialXml/parseLarge", [](Benchmark::State& state)
+{
+	std::string text = MakeDocument(NodeCount * 100, 6);
+	MaterialXml::Document document;
+	std::string error;
+
+	state.Start();
+	bool parsed = MaterialXml::Parse(text, document, error);
+	state.Stop();
+
+	state.SetCounter("parsed", parsed ? 1.0 : 0.0);
+	state.SetCounter("nodes", double(document.nodes.size()));
+	state.SetCounter("MB", double(text.size()) / (1024.0 * 1024.0));
+});
+
+BENCHMARK("MaterialXml/findImages", [](Benchmark::State& state)
+{
+	LibraryFixture fixture;
+	std::string text = MakeDocument(NodeCount, 5);
+	MaterialXml::Document document;
+	std::string error;
+	MaterialXml::Parse(text, document, error);
+
+	std::string directory = (fixture.directory / "material").string() + "/";
+
+	std::vector<std::string> directories;
+	directories.push_back(directory);
+	directories.push_back(directory + "../");
+
+	state.Start();
+	int references = 0;
+	std::vector<std::string> names = UniqueImageNames(document, references);
+	std::vector<std::string> paths = MaterialXml::FindFiles(names, directories);
+	state.Stop();
+
+	int found = 0;
+	for (const std::string& path : paths)
+		found += path.empty() ? 0 : 1;
+
+	state.SetCounter("references", double(references));
+	state.SetCounter("lookups", double(names.size()));
+	state.SetCounter("found", double(found));
+});
+
+BENCHMARK("MaterialXml/malformed", [](Benchmark::State& state)
+{
+	std::string text = MakeDocument(64, 7);
+	MaterialXml::Document document;
+	std::string unclosed;
+	std::string noType;
+	std::string truncated;
+
+	state.Start();
+	bool parsedUnclosed = MaterialXml::Parse(text.substr(0, text.rfind("</node>")), document, unclosed);
+	bool parsedNoType = MaterialXml::Parse("<material name=\"m\"><node name=\"a\"></node></material>", document, noType);
+	bool parsedTruncated = MaterialXml::Parse(text.substr(0, text.size() / 2) + "<param name", document, truncated);
+	state.Stop();
+
+	state.SetCounter("rejected", double(!parsedUnclosed + !parsedNoType + !parsedTruncated));
+});
+
+TEST("MaterialXml/parseMatchesRegex", [](Benchmark::State& state)
+{
+	// the regex reference is quadratic in the document size
+	const int testNodes = NodeCount / 10;
+	std::string text = MakeDocument(testNodes, 5);
+	MaterialXml::Document document;
+	std::string error;
+
+	CHECK(MaterialXml::Parse(text, document, error));
+	CHECK(error.empty());
+
+	MaterialXml::Document reference;
+	ParseWithRegex(text, reference);
+
+	CHECK(document.nodes.size() == size_t(testNodes));
+	CHECK(SameNodes(document, reference));
+
+	// unclosed node, node without type, truncated tag
+	CHECK(!MaterialXml::Parse(text.substr(0, text.rfind("</node>")), document, error));
+	CHECK(!MaterialXml::Parse("<material name=\"m\"><node name=\"a\"></node></material>", document, error));
+	CHECK(!MaterialXml::Parse(text.substr(0, text.size() / 2) + "<param name", document, error));
+	CHECK(!error.empty());
+});
+
+TEST("MaterialXml/imagesLocatedOnce", [](Benchmark::State& state)
+{
+	LibraryFixture fixture;
+	std::string text = MakeDocument(NodeCount, 5);
+	MaterialXml::Document document;
+	std::string error;
+	CHECK(MaterialXml::Parse(text, document, error));
+
+	std::string directory = (fixture.directory / "material").string() + "/";
+
+	// one lookup per image, however many params use it
+	int references = 0;
+	std::vector<std::string> names = UniqueImageNames(document, references);
+
+	CHECK(names.size() == size_t(ImageCount));
+	CHECK(references > ImageCount);
+
+	// and a name which exists nowhere, and one given as full path
+	std::string fullPath = (fixture.directory / ImageName(1)).string();
+	names.push_back("maps/missing.png");
+	names.push_back(fullPath);
+
+	std::vector<std::string> paths = MaterialXml::FindFiles(names, { directory, directory + "../" });
+	CHECK(paths.size() == names.size());
+
+	// even images are next to the material, odd ones in the shared maps directory
+	int misplaced = 0;
+	for (int i = 0; i < ImageCount; i++)
+	{
+		int image = std::stoi(names[i].substr(std::string("maps/texture").size()));
+		std::string expected = (image % 2 ? directory + "../" : directory) + names[i];
+		misplaced += paths[i] != expected;
+	}
+
+	CHECK(misplaced == 0);
+	CHECK(paths[ImageCount].empty());
+	CHECK(paths[ImageCount + 1] == fullPath);
+});
@@ -0,0 +1,452 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "Translators/MeshCompaction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	const int MeshResolution = 512;
+	const unsigned int CacheSize = 16;
+
+	/** Mesh laid out as the single shader translator passes it: Maya per-face-vertex normals
+		(equal on smooth edges), a hard crease down the middle, a uv seam across it and every
+		seventh quad split into triangles. Faces are in Maya order, row by row. */
+	struct TranslatedMesh
+	{
+		// deformation motion samples one after another
+		std::vector<float> positions;
+		unsigned int positionSamples = 1;
+
+		std::vector<float> normals;
+		std::vector<float> uvs;
+
+		std::vector<int> positionIndices;
+		std::vector<int> normalIndices;
+		std::vector<int> uvIndices;
+		std::vector<int> faceVertexCounts;
+
+		MeshCompaction::Input MakeInput() const
+		{
+			MeshCompaction::Input input;
+			input.positions = positions.data();
+			input.positionCount = positions.size() / (3 * positionSamples);
+			input.positionSamples = positionSamples;
+			input.normals = normals.data();
+			input.normalCount = normals.size() / 3;
+			input.uvs.push_back(uvs.data());
+			input.uvCounts.push_back(uvs.size() / 2);
+			input.uvIndices.push_back(uvIndices.data());
+			input.positionIndices = positionIndices.data();
+			input.normalIndices = normalIndices.data();
+			input.faceVertexCounts = faceVertexCounts.data();
+			input.faceCount = faceVertexCounts.size();
+			return input;
+		}
+	};
+
+	void SmoothNormal(float x, float y, float* normal)
+	{
+		float dx = 0.3f * std::cos(6.0f * x) * std::cos(4.0f * y);
+		float dy = -0.2f * std::sin(6.0f * x) * std::sin(4.0f * y);
+		float length = std::sqrt(dx * dx + 1.0f + dy * dy);
+
+		normal[0] = -dx / length;
+		normal[1] = 1.0f / length;
+		normal[2] = -dy / length;
+	}
+
+	TranslatedMesh MakeTranslatedMesh(int resolution, float normalNoise, uint32_t seed)
+	{
+		BenchmarkScenes::Random random(seed);
+		TranslatedMesh mesh;
+
+		const int side = resolution + 1;
+		const float step = 1.0f / resolution;
+
+		for (int y = 0; y < side; y++)
+		{
+			for (int x = 0; x < side; x++)
+			{
+				mesh.positions.push_back(x * step);
+				mesh.positions.push_back(0.05f * std::sin(6.0f * x * step) * std::cos(4.0f * y * step));
+				mesh.positions.push_back(y * step);
+
+				mesh.uvs.push_back(x * step);
+				mesh.uvs.push_back(y * step);
+			}
+		}
+
+		// second copy of the seam row, mapped to the bottom of the other uv shell
+		const int seamRow = resolution / 2;
+		const int seamUV = int(mesh.uvs.size() / 2);
+
+		for (int x = 0; x < side; x++)
+		{
+			mesh.uvs.push_back(x * step);
+			mesh.uvs.push_back(0.0f);
+		}
+
+		auto addCorner = [&](int x, int y, bool rightOfCrease, bool belowSeam)
+		{
+			float normal[3];
+			SmoothNormal(x * step, y * step, normal);
+
+			if (rightOfCrease && x == resolution / 2)
+			{
+				normal[0] = -normal[0];
+			}
+
+			mesh.positionIndices.push_back(y * side + x);
+			mesh.uvIndices.push_back(!belowSeam && y == seamRow ? seamUV + x : y * side + x);
+
+			mesh.normalIndices.push_back(int(mesh.normals.size() / 3));
+			for (int i = 0; i < 3; i++)
+			{
+				mesh.normals.push_back(normal[i] + normalNoise * (random.NextFloat() - 0.5f));
+			}
+		};
+
+		for (int y = 0; y < resolution; y++)
+		{
+			for (int x = 0; x < resolution; x++)
+			{
+				bool rightOfCrease = x >= resolution / 2;
+				bool belowSeam = y < seamRow;
+
+				if ((y * resolution + x) % 7 == 0)
+				{
+					addCorner(x, y, rightOfCrease, belowSeam);
+					addCorner(x + 1, y, rightOfCrease, belowSeam);
+					addCorner(x + 1, y + 1, rightOfCrease, belowSeam);
+					addCorner(x, y, rightOfCrease, belowSeam);
+					addCorner(x + 1, y + 1, rightOfCrease, belowSeam);
+					addCorner(x, y + 1, rightOfCrease, belowSeam);
+					mesh.faceVertexCounts.push_back(3);
+					mesh.faceVertexCounts.push_back(3);
+				}
+				else
+				{
+					addCorner(x, y, rightOfCrease, belowSeam);
+					addCorner(x + 1, y, rightOfCrease, belowSeam);
+					addCorner(x + 1, y + 1, rightOfCrease, belowSeam);
+					addCorner(x, y + 1, rightOfCrease, belowSeam);
+					mesh.faceVertexCounts.push_back(4);
+				}
+			}
+		}
+
+		return mesh;
+	}
+
+	// Vertex cache misses per triangle of a FIFO cache, polygons counted as triangle fans
+	double AverageCacheMissRatio(const std::vector<int>& indices, const std::vector<int>& faceVertexCounts, const std::vector<int>& faceOrder, size_t vertexCount)
+	{
+		std::vector<size_t> faceStarts(faceVertexCounts.size() + 1, 0);
+		for (size_t face = 0; face < faceVertexCounts.size(); face++)
+			faceStarts[face + 1] = faceStarts[face] + faceVertexCounts[face];
+
+		std::vector<size_t> cachedAt(vertexCount, 0);
+		size_t time = CacheSize + 1;
+		size_t misses = 0;
+		size_t triangles = 0;
+
+		for (int face : faceOrder)
+		{
+			for (size_t i = faceStarts[face]; i < faceStarts[face + 1]; i++)
+			{
+				int vertex = indices[i];
+
+				if (time - cachedAt[vertex] > CacheSize)
+				{
+					cachedAt[vertex] = time++;
+					misses++;
+				}
+			}
+
+			triangles += faceVertexCounts[face] - 2;
+		}
+
+		return triangles > 0 ? double(misses) / triangles : 0.0;
+	}
+
+	// Compacted indices laid out in input face order, faceOrder maps output faces to input faces
+	std::vector<int> IndicesInInputOrder(const MeshCompaction::Mesh& mesh, std::vector<int>& faceVertexCounts)
+	{
+		size_t faceCount = mesh.faceOrder.size();
+		std::vector<size_t> outputStarts(faceCount + 1, 0);
+		std::vector<int> outputFace(faceCount);
+
+		for (size_t face = 0; face < faceCount; face++)
+		{
+			outputStarts[face + 1] = outputStarts[face] + mesh.faceVertexCounts[face];
+			outputFace[mesh.faceOrder[face]] = int(face);
+		}
+
+		std::vector<int> indices;
+		indices.reserve(mesh.indices.size());
+		faceVertexCounts.resize(faceCount);
+
+		for (size_t face = 0; face < faceCount; face++)
+		{
+			int output = outputFace[face];
+			indices.insert(indices.end(), mesh.indices.begin() + outputStarts[output], mesh.indices.begin() + outputStarts[output + 1]);
+			faceVertexCounts[face] = mesh.faceVertexCounts[output];
+		}
+
+		return indices;
+	}
+
+	const std::vector<int>& PositionIndices(const MeshCompaction::Mesh& mesh)
+	{
+		return mesh.positionIndices.empty() ? mesh.indices : mesh.positionIndices;
+	}
+
+	// Material of each input face, one of a few
+	std::vector<int> MakeFaceMaterials(const TranslatedMesh& source)
+	{
+		std::vector<int> materials(source.faceVertexCounts.size());
+
+		for (size_t face = 0; face < materials.size(); face++)
+			materials[face] = int(face % 3);
+
+		return materials;
+	}
+
+	/** Face-vertices whose positions of every sample, normal, uv or face material differ from the input,
+		rebuilt from the compacted arrays in output order. Quantized normals are compared within maxNormalError. */
+	size_t CountMismatches(const TranslatedMesh& source, const std::vector<int>& faceMaterials,
+		const MeshCompaction::Mesh& mesh, const std::vector<int>& compactedMaterials, float* maxNormalError)
+	{
+		std::vector<size_t> inputStarts(source.faceVertexCounts.size() + 1, 0);
+		for (size_t face = 0; face < source.faceVertexCounts.size(); face++)
+			inputStarts[face + 1] = inputStarts[face] + source.faceVertexCounts[face];
+
+		if (mesh.faceOrder.size() != source.faceVertexCounts.size() || compactedMaterials.size() != mesh.faceOrder.size() ||
+			mesh.indices.size() != source.positionIndices.size() || PositionIndices(mesh).size() != source.positionIndices.size())
+		{
+			return source.positionIndices.size();
+		}
+
+		const std::vector<int>& positionIndices = PositionIndices(mesh);
+		const size_t sourcePositionCount = source.positions.size() / (3 * source.positionSamples);
+
+		size_t mismatches = 0;
+		size_t corner = 0;
+		*maxNormalError = 0.0f;
+
+		for (size_t outputFace = 0; outputFace < mesh.faceOrder.size(); outputFace++)
+		{
+			int face = mesh.faceOrder[outputFace];
+
+			if (mesh.faceVertexCounts[outputFace] != source.faceVertexCounts[face])
+				return source.positionIndices.size();
+
+			bool sameMaterial = compactedMaterials[outputFace] == faceMaterials[face];
+
+			for (size_t i = inputStarts[face]; i < inputStarts[face + 1]; i++, corner++)
+			{
+				size_t vertex = size_t(mesh.indices[corner]);
+				size_t position = size_t(positionIndices[corner]);
+
+				bool same = sameMaterial;
+
+				for (unsigned int sample = 0; sample < source.positionSamples; sample++)
+				{
+					const float* expected = &source.positions[3 * (sourcePositionCount * sample + size_t(source.positionIndices[i]))];
+					const float* actual = &mesh.positions[3 * (mesh.positionCount * sample + position)];
+
+					same = same && std::memcmp(expected, actual, 3 * sizeof(float)) == 0;
+				}
+
+				const float* uv = &source.uvs[2 * size_t(source.uvIndices[i])];
+				same = same && std::memcmp(uv, &mesh.uvs[0][2 * vertex], 2 * sizeof(float)) == 0;
+
+				const float* normal = &source.normals[3 * size_t(source.normalIndices[i])];
+
+				float normalError = 0.0f;
+				for (int c = 0; c < 3; c++)
+					normalError = std::max(normalError, std::fabs(normal[c] - mesh.normals[3 * vertex + c]));
+
+				*maxNormalError = std::max(*maxNormalError, normalError);
+
+				if (!same || (mesh.packedNormals.empty() && normalError != 0.0f))
+					mismatches++;
+			}
+		}
+
+		return mismatches;
+	}
+
+	void RunCompaction(Benchmark::State& state, float normalNoise, bool quantizeNormals, bool keepPositions)
+	{
+		TranslatedMesh source = MakeTranslatedMesh(MeshResolution, normalNoise, 11);
+		MeshCompaction::Input input = source.MakeInput();
+
+		MeshCompaction::Options options;
+		options.quantizeNormals = quantizeNormals;
+		options.keepPositions = keepPositions;
+		options.cacheSize = CacheSize;
+
+		MeshCompaction::Mesh mesh;
+
+		state.Start();
+		bool result = MeshCompaction::Compact(input, options, mesh);
+		state.Stop();
+
+		CHECK(result);
+		if (!result)
+			return;
+
+		// the cache sees positions when they are indexed on their own
+		MeshCompaction::Mesh cacheMesh = mesh;
+		cacheMesh.indices = PositionIndices(mesh);
+
+		std::vector<int> inputOrderCounts;
+		std::vector<int> inputOrderIndices = IndicesInInputOrder(cacheMesh, inputOrderCounts);
+
+		std::vector<int> identity(inputOrderCounts.size());
+		for (size_t face = 0; face < identity.size(); face++)
+			identity[face] = int(face);
+
+		std::vector<int> faceMaterials = MakeFaceMaterials(source);
+		std::vector<int> compactedMaterials = faceMaterials;
+		MeshCompaction::RemapFaceData(mesh, compactedMaterials);
+
+		float maxNormalError = 0.0f;
+		size_t mismatches = CountMismatches(source, faceMaterials, mesh, compactedMaterials, &maxNormalError);
+		size_t cacheVertexCount = std::max(mesh.vertexCount, mesh.positionCount);
+
+		state.SetCounter("faceVertices", double(source.positionIndices.size()));
+		state.SetCounter("vertices", double(mesh.vertexCount));
+		state.SetCounter("points", double(mesh.positionCount));
+		state.SetCounter("inputBytes", double(MeshCompaction::InputBytes(input)));
+		state.SetCounter("meshBytes", double(MeshCompaction::MeshBytes(mesh)));
+		state.SetCounter("missesPer1000TrianglesInput", 1000.0 * AverageCacheMissRatio(inputOrderIndices, inputOrderCounts, identity, cacheVertexCount));
+		state.SetCounter("missesPer1000TrianglesOutput", 1000.0 * AverageCacheMissRatio(cacheMesh.indices, mesh.faceVertexCounts, identity, cacheVertexCount));
+		state.SetCounter("mismatches", double(mismatches));
+		state.SetCounter("maxNormalErrorPpm", 1e6 * maxNormalError);
+
+		CHECK(mismatches == 0);
+		CHECK(maxNormalError < 1e-4f);
+	}
+
+	// Compacts a small mesh with the given options and rebuilds every face-vertex from the result
+	void CheckLossless(Benchmark::State& state, const TranslatedMesh& source, const MeshCompaction::Options& options)
+	{
+		MeshCompaction::Input input = source.MakeInput();
+		MeshCompaction::Mesh mesh;
+
+		CHECK(MeshCompaction::Compact(input, options, mesh));
+
+		std::vector<int> faceMaterials = MakeFaceMaterials(source);
+		std::vector<int> compactedMaterials = faceMaterials;
+		MeshCompaction::RemapFaceData(mesh, compactedMaterials);
+
+		float maxNormalError = 0.0f;
+		CHECK(CountMismatches(source, faceMaterials, mesh, compactedMaterials, &maxNormalError) == 0);
+		CHECK(maxNormalError == 0.0f);
+
+		// every output face is one input face
+		std::vector<int> faces = mesh.faceOrder;
+		std::sort(faces.begin(), faces.end());
+		for (size_t face = 0; face < faces.size(); face++)
+			CHECK(faces[face] == int(face));
+
+		CHECK(mesh.positions.size() == 3 * mesh.positionCount * source.positionSamples);
+		CHECK(mesh.normals.size() == 3 * mesh.vertexCount);
+		CHECK(mesh.uvs.size() == 1 && mesh.uvs[0].size() == 2 * mesh.vertexCount);
+		CHECK(MeshCompaction::MeshBytes(mesh) < MeshCompaction::InputBytes(input));
+
+		const size_t sourcePositionCount = source.positions.size() / (3 * source.positionSamples);
+
+		// points are split at the seam and the crease unless they are kept
+		if (options.keepPositions)
+			CHECK(mesh.positionCount == sourcePositionCount);
+		else
+			CHECK(mesh.positionCount > sourcePositionCount);
+	}
+}
+
+BENCHMARK("MeshCompaction/smooth", [](Benchmark::State& state)
+{
+	RunCompaction(state, 0.0f, false, false);
+});
+
+// Points are not split, as the single shader translator uploads them
+BENCHMARK("MeshCompaction/smoothKeepPositions", [](Benchmark::State& state)
+{
+	RunCompaction(state, 0.0f, false, true);
+});
+
+// Normals recomputed per face differ by float noise and only weld after quantization
+BENCHMARK("MeshCompaction/noisyNormals", [](Benchmark::State& state)
+{
+	RunCompaction(state, 1e-6f, false, false);
+});
+
+BENCHMARK("MeshCompaction/noisyNormalsQuantized", [](Benchmark::State& state)
+{
+	RunCompaction(state, 1e-6f, true, false);
+});
+
+TEST("MeshCompaction/lossless", [](Benchmark::State& state)
+{
+	TranslatedMesh source = MakeTranslatedMesh(16, 0.0f, 3);
+
+	MeshCompaction::Options options;
+	CheckLossless(state, source, options);
+
+	options.keepPositions = true;
+	CheckLossless(state, source, options);
+
+	options.reorderFaces = false;
+	CheckLossless(state, source, options);
+
+	options.keepPositions = false;
+	CheckLossless(state, source, options);
+});
+
+TEST("MeshCompaction/losslessMotionSamples", [](Benchmark::State& state)
+{
+	TranslatedMesh source = MakeTranslatedMesh(16, 0.0f, 5);
+
+	// second deformation sample moves every point differently
+	size_t pointCount = source.positions.size() / 3;
+	for (size_t i = 0; i < 3 * pointCount; i++)
+		source.positions.push_back(source.positions[i] + 0.001f * float(i % 7));
+
+	source.positionSamples = 2;
+
+	MeshCompaction::Options options;
+	CheckLossless(state, source, options);
+
+	options.keepPositions = true;
+	CheckLossless(state, source, options);
+});
+
+TEST("MeshCompaction/invalidInput", [](Benchmark::State& state)
+{
+	TranslatedMesh source = MakeTranslatedMesh(4, 0.0f, 7);
+	source.uvIndices[5] = int(source.uvs.size() / 2);
+
+	MeshCompaction::Mesh mesh;
+	CHECK(!MeshCompaction::Compact(source.MakeInput(), MeshCompaction::Options(), mesh));
+	CHECK(mesh.indices.empty() && mesh.positions.empty());
+});
@@ -0,0 +1,164 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "Lights/PhysicalLight/MeshLightArea.h"
+
+#include <cmath>
+
+namespace
+{
+	const int EmitterResolution = 512;
+
+	// light tweaks between two geometry changes of the emitter
+	const int LightUpdates = 100;
+
+	// rotation about z with scale 3 and translation, and the same with scale (3, 1, 0.5)
+	const double UniformMatrix[4][4] = {
+		{ 0.0, 3.0, 0.0, 0.0 },
+		{ -3.0, 0.0, 0.0, 0.0 },
+		{ 0.0, 0.0, 3.0, 0.0 },
+		{ 5.0, 1.0, -2.0, 1.0 } };
+
+	const double NonUniformMatrix[4][4] = {
+		{ 0.0, 3.0, 0.0, 0.0 },
+		{ -1.0, 0.0, 0.0, 0.0 },
+		{ 0.0, 0.0, 0.5, 0.0 },
+		{ 5.0, 1.0, -2.0, 1.0 } };
+
+	std::vector<int> Triangulate(const BenchmarkScenes::Mesh& mesh)
+	{
+		std::vector<int> triangles;
+		triangles.reserve(mesh.numPolygons() * 6);
+
+		for (int face = 0; face < mesh.numPolygons(); face++)
+		{
+			const int* quad = &mesh.polygonConnects[4 * face];
+			int faceTriangles[6] = { quad[0], quad[1], quad[2], quad[0], quad[2], quad[3] };
+			triangles.insert(triangles.end(), faceTriangles, faceTriangles + 6);
+		}
+
+		return triangles;
+	}
+
+	// Same computation as the former per-polygon walk: every triangle is transformed and summed
+	// (that summed in float, which drifts by a few parts per million over half a million triangles)
+	double ReferenceArea(const BenchmarkScenes::Mesh& mesh, const std::vector<int>& triangles, const double matrix[4][4])
+	{
+		double area = 0.0;
+
+		for (size_t i = 0; i < triangles.size(); i += 3)
+		{
+			double edges[2][3];
+
+			for (int e = 0; e < 2; e++)
+			{
+				const float* p0 = &mesh.points[3 * triangles[i]];
+				const float* p = &mesh.points[3 * triangles[i + 1 + e]];
+
+				for (int c = 0; c < 3; c++)
+				{
+					edges[e][c] = (p[0] - p0[0]) * matrix[0][c] + (p[1] - p0[1]) * matrix[1][c] + (p[2] - p0[2]) * matrix[2][c];
+				}
+			}
+
+			double x = edges[0][1] * edges[1][2] - edges[0][2] * edges[1][1];
+			double y = edges[0][2] * edges[1][0] - edges[0][0] * edges[1][2];
+			double z = edges[0][0] * edges[1][1] - edges[0][1] * edges[1][0];
+
+			area += std::sqrt(x * x + y * y + z * z) / 2.0;
+		}
+
+		return area;
+	}
+
+	// parts per billion
+	double RelativeDifference(double value, double reference)
+	{
+		return std::fabs(value - reference) / reference * 1e9;
+	}
+}
+
+BENCHMARK("MeshLightArea/perTriangle", [](Benchmark::State& state)
+{
+	BenchmarkScenes::Mesh mesh = BenchmarkScenes::MakeGridMesh(EmitterResolution, 11);
+	std::vector<int> triangles = Triangulate(mesh);
+
+	double area = 0.0;
+
+	state.Start();
+	for (int update = 0; update < LightUpdates; update++)
+	{
+		area = ReferenceArea(mesh, triangles, NonUniformMatrix);
+	}
+	state.Stop();
+
+	state.SetCounter("triangles", double(triangles.size() / 3));
+	state.SetCounter("area", area);
+});
+
+BENCHMARK("MeshLightArea/uniformScale", [](Benchmark::State& state)
+{
+	BenchmarkScenes::Mesh mesh = BenchmarkScenes::MakeGridMesh(EmitterResolution, 11);
+	std::vector<int> triangles = Triangulate(mesh);
+
+	double area = 0.0;
+
+	state.Start();
+	auto cached = MeshLightArea::BuildTriangles(mesh.getRawPoints(), triangles.data(), triangles.size() / 3);
+	for (int update = 0; update < LightUpdates; update++)
+	{
+		area = MeshLightArea::GetArea(*cached, UniformMatrix);
+	}
+	state.Stop();
+
+	state.SetCounter("area", area);
+	state.SetCounter("diffPpb", RelativeDifference(area, ReferenceArea(mesh, triangles, UniformMatrix)));
+});
+
+BENCHMARK("MeshLightArea/nonUniformScale", [](Benchmark::State& state)
+{
+	BenchmarkScenes::Mesh mesh = BenchmarkScenes::MakeGridMesh(EmitterResolution, 11);
+	std::vector<int> triangles = Triangulate(mesh);
+
+	double area = 0.0;
+
+	state.Start();
+	auto cached = MeshLightArea::BuildTriangles(mesh.getRawPoints(), triangles.data(), triangles.size() / 3);
+	for (int update = 0; update < LightUpdates; update++)
+	{
+		area = MeshLightArea::GetArea(*cached, NonUniformMatrix);
+	}
+	state.Stop();
+
+	state.SetCounter("area", area);
+	state.SetCounter("diffPpb", RelativeDifference(area, ReferenceArea(mesh, triangles, NonUniformMatrix)));
+});
+
+TEST("MeshLightArea/matchesPerTriangle", [](Benchmark::State& state)
+{
+	BenchmarkScenes::Mesh mesh = BenchmarkScenes::MakeGridMesh(EmitterResolution, 11);
+	std::vector<int> triangles = Triangulate(mesh);
+
+	auto cached = MeshLightArea::BuildTriangles(mesh.getRawPoints(), triangles.data(), triangles.size() / 3);
+
+	// below one part per million
+	CHECK(RelativeDifference(MeshLightArea::GetArea(*cached, UniformMatrix), ReferenceArea(mesh, triangles, UniformMatrix)) < 1000.0);
+	CHECK(RelativeDifference(MeshLightArea::GetArea(*cached, NonUniformMatrix), ReferenceArea(mesh, triangles, NonUniformMatrix)) < 1000.0);
+
+	// the cache stays valid across transforms, going back gives the same area
+	double first = MeshLightArea::GetArea(*cached, UniformMatrix);
+	MeshLightArea::GetArea(*cached, NonUniformMatrix);
+	CHECK(MeshLightArea::GetArea(*cached, UniformMatrix) == first);
+});
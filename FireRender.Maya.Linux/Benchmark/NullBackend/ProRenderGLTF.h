@@ -0,0 +1,22 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+// glTF export extension of the RPR C API, see RadeonProRender.h
+
+#include "RadeonProRender.h"
+
+extern "C"
+{
+	rpr_status rprGLTF_AddExtraLightParameter(rpr_light light, const rpr_char* parameterName, int value);
+}
@@ -0,0 +1,620 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+/** Subset of the RPR C API used by frWrap.h, for headless builds without the RPR SDK.
+	Types and entry points have the signatures of the SDK; the entry points are implemented
+	by NullRpr.cpp on top of NullContext, which counts calls and bytes instead of rendering.
+	Constant values only have to be distinct within a group, nothing interprets them. */
+
+#include <cstddef>
+#include <cstdint>
+
+#define RPR_VERSION_MAJOR_MINOR_REVISION 0x00200209
+
+typedef int rpr_int;
+typedef unsigned int rpr_uint;
+typedef float rpr_float;
+typedef char rpr_char;
+typedef rpr_uint rpr_bool;
+typedef long long rpr_longlong;
+typedef rpr_int rpr_status;
+
+typedef void* rpr_context;
+typedef void* rpr_camera;
+typedef void* rpr_shape;
+typedef void* rpr_light;
+typedef void* rpr_scene;
+typedef void* rpr_image;
+typedef void* rpr_buffer;
+typedef void* rpr_framebuffer;
+typedef void* rpr_material_system;
+typedef void* rpr_material_node;
+typedef void* rpr_post_effect;
+typedef void* rpr_curve;
+typedef void* rpr_grid;
+typedef void* rpr_hetero_volume;
+
+typedef rpr_uint rpr_context_info;
+typedef rpr_uint rpr_parameter_info;
+typedef rpr_uint rpr_camera_mode;
+typedef rpr_uint rpr_shape_info;
+typedef rpr_uint rpr_shape_type;
+typedef rpr_uint rpr_mesh_info;
+typedef rpr_uint rpr_image_info;
+typedef rpr_uint rpr_scene_info;
+typedef rpr_uint rpr_component_type;
+typedef rpr_uint rpr_material_system_type;
+typedef rpr_uint rpr_material_node_info;
+typedef rpr_uint rpr_material_node_input_info;
+typedef rpr_uint rpr_material_node_type;
+typedef rpr_uint rpr_material_node_input;
+typedef rpr_uint rpr_post_effect_type;
+typedef rpr_uint rpr_aov;
+typedef rpr_uint rpr_curve_parameter;
+typedef rpr_uint rpr_environment_override;
+typedef rpr_uint rpr_grid_indices_topology;
+typedef rpr_uint rpr_subdiv_boundary_interfop_type;
+typedef rpr_uint rpr_buffer_element_type;
+
+struct rpr_framebuffer_format
+{
+	rpr_uint num_components;
+	rpr_component_type type;
+};
+
+typedef rpr_framebuffer_format rpr_image_format;
+
+struct rpr_framebuffer_desc
+{
+	rpr_uint fb_width;
+	rpr_uint fb_height;
+};
+
+struct rpr_image_desc
+{
+	rpr_uint image_width;
+	rpr_uint image_height;
+	rpr_uint image_depth;
+	rpr_uint image_row_pitch;
+	rpr_uint image_slice_pitch;
+};
+
+struct rpr_buffer_desc
+{
+	rpr_uint nb_element;
+	rpr_buffer_element_type element_type;
+	rpr_uint element_channel_size;
+};
+
+struct rpr_render_statistics
+{
+	rpr_longlong gpumem_usage;
+	rpr_longlong gpumem_total;
+	rpr_longlong gpumem_max_allocation;
+	rpr_longlong sysmem_usage;
+};
+
+// rpr_status
+#define RPR_SUCCESS 0
+#define RPR_ERROR_COMPUTE_API_NOT_SUPPORTED -1
+#define RPR_ERROR_OUT_OF_SYSTEM_MEMORY -2
+#define RPR_ERROR_OUT_OF_VIDEO_MEMORY -3
+#define RPR_ERROR_INVALID_LIGHTPATH_EXPR -5
+#define RPR_ERROR_INVALID_IMAGE -6
+#define RPR_ERROR_INVALID_AA_METHOD -7
+#define RPR_ERROR_UNSUPPORTED_IMAGE_FORMAT -8
+#define RPR_ERROR_INVALID_GL_TEXTURE -9
+#define RPR_ERROR_INVALID_CL_IMAGE -10
+#define RPR_ERROR_INVALID_OBJECT -11
+#define RPR_ERROR_INVALID_PARAMETER -12
+#define RPR_ERROR_INVALID_TAG -13
+#define RPR_ERROR_INVALID_LIGHT -14
+#define RPR_ERROR_INVALID_CONTEXT -15
+#define RPR_ERROR_UNIMPLEMENTED -16
+#define RPR_ERROR_INVALID_API_VERSION -17
+#define RPR_ERROR_INTERNAL_ERROR -18
+#define RPR_ERROR_IO_ERROR -19
+#define RPR_ERROR_UNSUPPORTED_SHADER_PARAMETER_TYPE -20
+#define RPR_ERROR_MATERIAL_STACK_OVERFLOW -21
+#define RPR_ERROR_INVALID_PARAMETER_TYPE -22
+#define RPR_ERROR_UNSUPPORTED -23
+#define RPR_ERROR_ABORTED -29
+
+// rpr_parameter_info
+#define RPR_PARAMETER_NAME 0x1201
+#define RPR_PARAMETER_NAME_STRING 0x1202
+#define RPR_PARAMETER_TYPE 0x1203
+#define RPR_PARAMETER_DESCRIPTION 0x1204
+#define RPR_PARAMETER_VALUE 0x1205
+
+// parameter types
+#define RPR_PARAMETER_TYPE_FLOAT 0x1
+#define RPR_PARAMETER_TYPE_FLOAT2 0x2
+#define RPR_PARAMETER_TYPE_FLOAT3 0x3
+#define RPR_PARAMETER_TYPE_FLOAT4 0x4
+#define RPR_PARAMETER_TYPE_IMAGE 0x5
+#define RPR_PARAMETER_TYPE_STRING 0x6
+#define RPR_PARAMETER_TYPE_SHADER 0x7
+#define RPR_PARAMETER_TYPE_UINT 0x8
+
+// rpr_context_info
+#define RPR_CONTEXT_CREATION_FLAGS 0x102
+#define RPR_CONTEXT_CACHE_PATH 0x103
+#define RPR_CONTEXT_RENDER_STATUS 0x104
+#define RPR_CONTEXT_RENDER_STATISTICS 0x105
+#define RPR_CONTEXT_DEVICE_COUNT 0x106
+#define RPR_CONTEXT_PARAMETER_COUNT 0x107
+#define RPR_CONTEXT_ACTIVE_PLUGIN 0x108
+#define RPR_CONTEXT_SCENE 0x109
+#define RPR_CONTEXT_AO_RAY_COUNT 0x10F
+#define RPR_CONTEXT_RADIANCE_CLAMP 0x113
+#define RPR_CONTEXT_IMAGE_FILTER_TYPE 0x11A
+#define RPR_CONTEXT_IMAGE_FILTER_BOX_RADIUS 0x11B
+#define RPR_CONTEXT_IMAGE_FILTER_GAUSSIAN_RADIUS 0x11C
+#define RPR_CONTEXT_IMAGE_FILTER_TRIANGLE_RADIUS 0x11D
+#define RPR_CONTEXT_IMAGE_FILTER_MITCHELL_RADIUS 0x11E
+#define RPR_CONTEXT_IMAGE_FILTER_LANCZOS_RADIUS 0x11F
+#define RPR_CONTEXT_IMAGE_FILTER_BLACKMANHARRIS_RADIUS 0x120
+#define RPR_CONTEXT_TONE_MAPPING_TYPE 0x121
+#define RPR_CONTEXT_TONE_MAPPING_LINEAR_SCALE 0x122
+#define RPR_CONTEXT_TONE_MAPPING_PHOTO_LINEAR_SENSITIVITY 0x123
+#define RPR_CONTEXT_TONE_MAPPING_PHOTO_LINEAR_EXPOSURE 0x124
+#define RPR_CONTEXT_TONE_MAPPING_PHOTO_LINEAR_FSTOP 0x125
+#define RPR_CONTEXT_TONE_MAPPING_REINHARD02_PRE_SCALE 0x126
+#define RPR_CONTEXT_TONE_MAPPING_REINHARD02_POST_SCALE 0x127
+#define RPR_CONTEXT_TONE_MAPPING_REINHARD02_BURN 0x128
+#define RPR_CONTEXT_MAX_RECURSION 0x129
+#define RPR_CONTEXT_RAY_CAST_EPISLON 0x12A
+#define RPR_CONTEXT_RENDER_MODE 0x12B
+#define RPR_CONTEXT_ROUGHNESS_CAP 0x12C
+#define RPR_CONTEXT_DISPLAY_GAMMA 0x12D
+#define RPR_CONTEXT_MATERIAL_STACK_SIZE 0x12E
+#define RPR_CONTEXT_CLIPPING_PLANE 0x12F
+#define RPR_CONTEXT_GPU0_NAME 0x130
+#define RPR_CONTEXT_GPU1_NAME 0x131
+#define RPR_CONTEXT_GPU2_NAME 0x132
+#define RPR_CONTEXT_GPU3_NAME 0x133
+#define RPR_CONTEXT_CPU_NAME 0x134
+#define RPR_CONTEXT_GPU4_NAME 0x135
+#define RPR_CONTEXT_GPU5_NAME 0x136
+#define RPR_CONTEXT_GPU6_NAME 0x137
+#define RPR_CONTEXT_GPU7_NAME 0x138
+#define RPR_CONTEXT_TRACING_ENABLED 0x13C
+#define RPR_CONTEXT_TRACING_PATH 0x13D
+#define RPR_CONTEXT_TEXTURE_GAMMA 0x13E
+#define RPR_CONTEXT_PDF_THRESHOLD 0x13F
+#define RPR_CONTEXT_RENDER_UPDATE_CALLBACK_FUNC 0x140
+#define RPR_CONTEXT_RENDER_UPDATE_CALLBACK_DATA 0x141
+#define RPR_CONTEXT_X_FLIP 0x143
+#define RPR_CONTEXT_Y_FLIP 0x144
+#define RPR_CONTEXT_ACTIVE_PIXEL_COUNT 0x14A
+#define RPR_CONTEXT_LAST_ERROR_MESSAGE 0x14B
+
+// rpr_camera_mode
+#define RPR_CAMERA_MODE_PERSPECTIVE 0x1
+#define RPR_CAMERA_MODE_ORTHOGRAPHIC 0x2
+#define RPR_CAMERA_MODE_LATITUDE_LONGITUDE_360 0x3
+#define RPR_CAMERA_MODE_LATITUDE_LONGITUDE_STEREO 0x4
+#define RPR_CAMERA_MODE_CUBEMAP 0x5
+#define RPR_CAMERA_MODE_CUBEMAP_STEREO 0x6
+
+// rpr_shape_info
+#define RPR_SHAPE_TYPE 0x1401
+#define RPR_SHAPE_MOTION_TRANSFORMS_COUNT 0x1406
+#define RPR_SHAPE_MOTION_TRANSFORMS 0x1407
+#define RPR_SHAPE_LINEAR_MOTION 0x1408
+#define RPR_SHAPE_ANGULAR_MOTION 0x1409
+#define RPR_SHAPE_OBJECT_ID 0x140B
+#define RPR_SHAPE_LIGHTGROUP_ID 0x1414
+#define RPR_SHAPE_CONTOUR_IGNORE 0x141E
+#define RPR_SHAPE_VISIBILITY_PRIMARY_ONLY_FLAG 0x140C
+#define RPR_SHAPE_VISIBILITY_SHADOW 0x140D
+#define RPR_SHAPE_VISIBILITY_REFLECTION 0x140E
+#define RPR_SHAPE_VISIBILITY_REFRACTION 0x140F
+#define RPR_SHAPE_VISIBILITY_LIGHT 0x1410
+#define RPR_SHAPE_VISIBILITY_GLOSSY_REFLECTION 0x1415
+#define RPR_SHAPE_VISIBILITY_GLOSSY_REFRACTION 0x1416
+
+// rpr_shape_type
+#define RPR_SHAPE_TYPE_MESH 0x1
+#define RPR_SHAPE_TYPE_INSTANCE 0x2
+
+// rpr_mesh_info
+#define RPR_MESH_POLYGON_COUNT 0x501
+
+// rpr_curve_parameter
+#define RPR_CURVE_VISIBILITY_PRIMARY_ONLY_FLAG 0x830
+#define RPR_CURVE_VISIBILITY_SHADOW 0x831
+#define RPR_CURVE_VISIBILITY_REFLECTION 0x832
+#define RPR_CURVE_VISIBILITY_REFRACTION 0x833
+#define RPR_CURVE_VISIBILITY_LIGHT 0x834
+#define RPR_CURVE_VISIBILITY_GLOSSY_REFLECTION 0x835
+#define RPR_CURVE_VISIBILITY_GLOSSY_REFRACTION 0x836
+#define RPR_CURVE_VISIBILITY_DIFFUSE 0x837
+
+// light types
+#define RPR_LIGHT_TYPE_POINT 0x1
+#define RPR_LIGHT_TYPE_DIRECTIONAL 0x2
+#define RPR_LIGHT_TYPE_SPOT 0x3
+#define RPR_LIGHT_TYPE_ENVIRONMENT 0x4
+#define RPR_LIGHT_TYPE_SKY 0x5
+#define RPR_LIGHT_TYPE_IES 0x6
+#define RPR_LIGHT_TYPE_SPHERE 0x7
+#define RPR_LIGHT_TYPE_DISK 0x8
+
+// rpr_environment_override
+#define RPR_ENVIRONMENT_LIGHT_OVERRIDE_REFLECTION 0x711
+#define RPR_ENVIRONMENT_LIGHT_OVERRIDE_REFRACTION 0x712
+#define RPR_ENVIRONMENT_LIGHT_OVERRIDE_TRANSPARENCY 0x713
+#define RPR_ENVIRONMENT_LIGHT_OVERRIDE_BACKGROUND 0x714
+
+// rpr_image_info
+#define RPR_IMAGE_FORMAT 0x301
+
+// rpr_scene_info
+#define RPR_SCENE_SHAPE_COUNT 0x701
+#define RPR_SCENE_LIGHT_COUNT 0x702
+#define RPR_SCENE_SHAPE_LIST 0x704
+#define RPR_SCENE_LIGHT_LIST 0x705
+
+// rpr_component_type
+#define RPR_COMPONENT_TYPE_UINT8 0x1
+#define RPR_COMPONENT_TYPE_FLOAT16 0x2
+#define RPR_COMPONENT_TYPE_FLOAT32 0x3
+
+// rpr_grid_indices_topology
+#define RPR_GRID_INDICES_TOPOLOGY_I_U64 0x950
+
+// rpr_aov
+#define RPR_AOV_COLOR 0x0
+
+// rpr_tonemapping_operator
+#define RPR_TONEMAPPING_OPERATOR_NONE 0x0
+#define RPR_TONEMAPPING_OPERATOR_LINEAR 0x1
+#define RPR_TONEMAPPING_OPERATOR_PHOTOLINEAR 0x2
+#define RPR_TONEMAPPING_OPERATOR_AUTOLINEAR 0x3
+#define RPR_TONEMAPPING_OPERATOR_MAXWHITE 0x4
+#define RPR_TONEMAPPING_OPERATOR_REINHARD02 0x5
+
+// rpr_post_effect_type
+#define RPR_POST_EFFECT_TONE_MAP 0x0
+#define RPR_POST_EFFECT_WHITE_BALANCE 0x1
+#define RPR_POST_EFFECT_SIMPLE_TONEMAP 0x2
+#define RPR_POST_EFFECT_NORMALIZATION 0x3
+#define RPR_POST_EFFECT_GAMMA_CORRECTION 0x4
+
+// rpr_material_node_info
+#define RPR_MATERIAL_NODE_SYSTEM 0x1101
+#define RPR_MATERIAL_NODE_TYPE 0x1102
+#define RPR_MATERIAL_NODE_INPUT_COUNT 0x1103
+
+// rpr_material_node_input_info
+#define RPR_MATERIAL_NODE_INPUT_NAME 0x1103
+#define RPR_MATERIAL_NODE_INPUT_NAME_STRING 0x1104
+#define RPR_MATERIAL_NODE_INPUT_DESCRIPTION 0x1105
+#define RPR_MATERIAL_NODE_INPUT_VALUE 0x1106
+#define RPR_MATERIAL_NODE_INPUT_TYPE 0x1107
+
+// material node input types
+#define RPR_MATERIAL_NODE_INPUT_TYPE_FLOAT4 0x1
+#define RPR_MATERIAL_NODE_INPUT_TYPE_UINT 0x2
+#define RPR_MATERIAL_NODE_INPUT_TYPE_NODE 0x3
+#define RPR_MATERIAL_NODE_INPUT_TYPE_IMAGE 0x4
+
+// rpr_material_node_type
+#define RPR_MATERIAL_NODE_DIFFUSE 0x1
+#define RPR_MATERIAL_NODE_MICROFACET 0x2
+#define RPR_MATERIAL_NODE_REFLECTION 0x3
+#define RPR_MATERIAL_NODE_REFRACTION 0x4
+#define RPR_MATERIAL_NODE_MICROFACET_REFRACTION 0x5
+#define RPR_MATERIAL_NODE_TRANSPARENT 0x6
+#define RPR_MATERIAL_NODE_EMISSIVE 0x7
+#define RPR_MATERIAL_NODE_WARD 0x8
+#define RPR_MATERIAL_NODE_ADD 0x9
+#define RPR_MATERIAL_NODE_BLEND 0xA
+#define RPR_MATERIAL_NODE_ARITHMETIC 0xB
+#define RPR_MATERIAL_NODE_FRESNEL 0xC
+#define RPR_MATERIAL_NODE_NORMAL_MAP 0xD
+#define RPR_MATERIAL_NODE_IMAGE_TEXTURE 0xE
+#define RPR_MATERIAL_NODE_NOISE2D_TEXTURE 0xF
+#define RPR_MATERIAL_NODE_DOT_TEXTURE 0x10
+#define RPR_MATERIAL_NODE_GRADIENT_TEXTURE 0x11
+#define RPR_MATERIAL_NODE_CHECKER_TEXTURE 0x12
+#define RPR_MATERIAL_NODE_CONSTANT_TEXTURE 0x13
+#define RPR_MATERIAL_NODE_INPUT_LOOKUP 0x14
+#define RPR_MATERIAL_NODE_BLEND_VALUE 0x16
+#define RPR_MATERIAL_NODE_PASSTHROUGH 0x17
+#define RPR_MATERIAL_NODE_ORENNAYAR 0x18
+#define RPR_MATERIAL_NODE_FRESNEL_SCHLICK 0x19
+#define RPR_MATERIAL_NODE_DIFFUSE_REFRACTION 0x1B
+#define RPR_MATERIAL_NODE_BUMP_MAP 0x1C
+#define RPR_MATERIAL_NODE_VOLUME 0x1D
+#define RPR_MATERIAL_NODE_UBERV2 0x1E
+#define RPR_MATERIAL_NODE_UV_PROCEDURAL 0x1F
+#define RPR_MATERIAL_NODE_BUFFER_SAMPLER 0x20
+#define RPR_MATERIAL_NODE_UV_TRIPLANAR 0x21
+#define RPR_MATERIAL_NODE_AO_MAP 0x22
+#define RPR_MATERIAL_NODE_TOON_CLOSURE 0x2C
+#define RPR_MATERIAL_NODE_TOON_RAMP 0x2D
+#define RPR_MATERIAL_NODE_RGB_TO_HSV 0x2F
+#define RPR_MATERIAL_NODE_HSV_TO_RGB 0x30
+
+// rpr_material_node_input
+#define RPR_MATERIAL_INPUT_COLOR 0x0
+#define RPR_MATERIAL_INPUT_COLOR0 0x1
+#define RPR_MATERIAL_INPUT_COLOR1 0x2
+#define RPR_MATERIAL_INPUT_NORMAL 0x3
+#define RPR_MATERIAL_INPUT_UV 0x4
+#define RPR_MATERIAL_INPUT_DATA 0x5
+#define RPR_MATERIAL_INPUT_ROUGHNESS 0x6
+#define RPR_MATERIAL_INPUT_IOR 0x7
+#define RPR_MATERIAL_INPUT_ROUGHNESS_X 0x8
+#define RPR_MATERIAL_INPUT_ROUGHNESS_Y 0x9
+#define RPR_MATERIAL_INPUT_ROTATION 0xA
+#define RPR_MATERIAL_INPUT_WEIGHT 0xB
+#define RPR_MATERIAL_INPUT_OP 0xC
+#define RPR_MATERIAL_INPUT_INVEC 0xD
+#define RPR_MATERIAL_INPUT_UV_SCALE 0xE
+#define RPR_MATERIAL_INPUT_VALUE 0xF
+#define RPR_MATERIAL_INPUT_REFLECTANCE 0x10
+#define RPR_MATERIAL_INPUT_SCALE 0x11
+#define RPR_MATERIAL_INPUT_SCATTERING 0x12
+#define RPR_MATERIAL_INPUT_ABSORBTION 0x13
+#define RPR_MATERIAL_INPUT_EMISSION 0x14
+#define RPR_MATERIAL_INPUT_G 0x15
+#define RPR_MATERIAL_INPUT_MULTISCATTER 0x16
+#define RPR_MATERIAL_INPUT_UV_TYPE 0x1C
+#define RPR_MATERIAL_INPUT_RADIUS 0x1D
+#define RPR_MATERIAL_INPUT_SIDE 0x1E
+#define RPR_MATERIAL_INPUT_OFFSET 0x1F
+#define RPR_MATERIAL_INPUT_ZAXIS 0x20
+#define RPR_MATERIAL_INPUT_XAXIS 0x21
+#define RPR_MATERIAL_INPUT_ORIGIN 0x22
+#define RPR_MATERIAL_INPUT_THRESHOLD 0x23
+#define RPR_MATERIAL_INPUT_UBER_DIFFUSE_COLOR 0x910
+#define RPR_MATERIAL_INPUT_UBER_DIFFUSE_NORMAL 0x913
+#define RPR_MATERIAL_INPUT_UBER_SHEEN 0x940
+#define RPR_MATERIAL_INPUT_UBER_REFRACTION_COLOR 0x920
+#define RPR_MATERIAL_INPUT_UBER_REFRACTION_WEIGHT 0x921
+#define RPR_MATERIAL_INPUT_UBER_REFRACTION_ROUGHNESS 0x922
+#define RPR_MATERIAL_INPUT_UBER_REFRACTION_IOR 0x923
+#define RPR_MATERIAL_INPUT_UBER_REFRACTION_NORMAL 0x924
+#define RPR_MATERIAL_INPUT_UBER_COATING_COLOR 0x930
+#define RPR_MATERIAL_INPUT_UBER_COATING_WEIGHT 0x931
+#define RPR_MATERIAL_INPUT_UBER_COATING_NORMAL 0x934
+#define RPR_MATERIAL_INPUT_UBER_TRANSPARENCY 0x950
+#define RPR_MATERIAL_INPUT_UBER_FRESNEL_SCHLICK_APPROXIMATION 0x960
+
+// arithmetic operators
+#define RPR_MATERIAL_NODE_OP_ADD 0x0
+#define RPR_MATERIAL_NODE_OP_SUB 0x1
+#define RPR_MATERIAL_NODE_OP_MUL 0x2
+#define RPR_MATERIAL_NODE_OP_DIV 0x3
+#define RPR_MATERIAL_NODE_OP_SIN 0x4
+#define RPR_MATERIAL_NODE_OP_COS 0x5
+#define RPR_MATERIAL_NODE_OP_TAN 0x6
+#define RPR_MATERIAL_NODE_OP_SELECT_X 0x7
+#define RPR_MATERIAL_NODE_OP_SELECT_Y 0x8
+#define RPR_MATERIAL_NODE_OP_SELECT_Z 0x9
+#define RPR_MATERIAL_NODE_OP_COMBINE 0xA
+#define RPR_MATERIAL_NODE_OP_DOT3 0xB
+#define RPR_MATERIAL_NODE_OP_CROSS3 0xC
+#define RPR_MATERIAL_NODE_OP_LENGTH3 0xD
+#define RPR_MATERIAL_NODE_OP_NORMALIZE3 0xE
+#define RPR_MATERIAL_NODE_OP_POW 0xF
+#define RPR_MATERIAL_NODE_OP_ACOS 0x10
+#define RPR_MATERIAL_NODE_OP_ASIN 0x11
+#define RPR_MATERIAL_NODE_OP_ATAN 0x12
+#define RPR_MATERIAL_NODE_OP_AVERAGE_XYZ 0x13
+#define RPR_MATERIAL_NODE_OP_AVERAGE 0x14
+#define RPR_MATERIAL_NODE_OP_MIN 0x15
+#define RPR_MATERIAL_NODE_OP_MAX 0x16
+#define RPR_MATERIAL_NODE_OP_FLOOR 0x17
+#define RPR_MATERIAL_NODE_OP_MOD 0x18
+#define RPR_MATERIAL_NODE_OP_ABS 0x19
+#define RPR_MATERIAL_NODE_OP_SELECT_W 0x1A
+
+// lookup values
+#define RPR_MATERIAL_NODE_LOOKUP_UV 0x0
+#define RPR_MATERIAL_NODE_LOOKUP_N 0x1
+#define RPR_MATERIAL_NODE_LOOKUP_P 0x2
+#define RPR_MATERIAL_NODE_LOOKUP_INVEC 0x3
+#define RPR_MATERIAL_NODE_LOOKUP_OUTVEC 0x4
+#define RPR_MATERIAL_NODE_LOOKUP_UV1 0x5
+#define RPR_MATERIAL_NODE_LOOKUP_P_LOCAL 0x6
+#define RPR_MATERIAL_NODE_LOOKUP_VERTEX_VALUE0 0x7
+#define RPR_MATERIAL_NODE_LOOKUP_VERTEX_VALUE1 0x8
+#define RPR_MATERIAL_NODE_LOOKUP_VERTEX_VALUE2 0x9
+#define RPR_MATERIAL_NODE_LOOKUP_VERTEX_VALUE3 0xA
+#define RPR_MATERIAL_NODE_LOOKUP_SHAPE_RANDOM_COLOR 0xB
+
+// uv projection types
+#define RPR_MATERIAL_NODE_UVTYPE_PLANAR 0x0
+#define RPR_MATERIAL_NODE_UVTYPE_CYLINDICAL 0x1
+#define RPR_MATERIAL_NODE_UVTYPE_SPHERICAL 0x2
+#define RPR_MATERIAL_NODE_UVTYPE_PROJECT 0x3
+
+extern "C"
+{
+	// context
+	rpr_status rprContextGetInfo(rpr_context context, rpr_context_info context_info, size_t size, void* data, size_t* size_ret);
+	rpr_status rprContextGetParameterInfo(rpr_context context, int param_idx, rpr_parameter_info parameter_info, size_t size, void* data, size_t* size_ret);
+	rpr_status rprContextSetParameterByKey1u(rpr_context context, rpr_context_info in_input, rpr_uint x);
+	rpr_status rprContextSetParameterByKey1f(rpr_context context, rpr_context_info in_input, rpr_float x);
+	rpr_status rprContextSetParameterByKey3f(rpr_context context, rpr_context_info in_input, rpr_float x, rpr_float y, rpr_float z);
+	rpr_status rprContextSetParameterByKey4f(rpr_context context, rpr_context_info in_input, rpr_float x, rpr_float y, rpr_float z, rpr_float w);
+	rpr_status rprContextSetParameterByKeyPtr(rpr_context context, rpr_context_info in_input, void* value);
+	rpr_status rprContextSetParameterByKeyString(rpr_context context, rpr_context_info in_input, rpr_char const* value);
+	rpr_status rprContextSetAOV(rpr_context context, rpr_aov aov, rpr_framebuffer frame_buffer);
+	rpr_status rprContextSetScene(rpr_context context, rpr_scene scene);
+	rpr_status rprContextRender(rpr_context context);
+	rpr_status rprContextRenderTile(rpr_context context, rpr_uint xmin, rpr_uint xmax, rpr_uint ymin, rpr_uint ymax);
+	rpr_status rprContextAbortRender(rpr_context context);
+	rpr_status rprContextResolveFrameBuffer(rpr_context context, rpr_framebuffer src_frame_buffer, rpr_framebuffer dst_frame_buffer, rpr_bool noDisplayGamma);
+	rpr_status rprContextAttachPostEffect(rpr_context context, rpr_post_effect effect);
+	rpr_status rprContextDetachPostEffect(rpr_context context, rpr_post_effect effect);
+
+	rpr_status rprContextCreateScene(rpr_context context, rpr_scene* out_scene);
+	rpr_status rprContextCreateCamera(rpr_context context, rpr_camera* out_camera);
+	rpr_status rprContextCreateMaterialSystem(rpr_context context, rpr_material_system_type type, rpr_material_system* out_matsys);
+	rpr_status rprContextCreatePostEffect(rpr_context context, rpr_post_effect_type type, rpr_post_effect* out_effect);
+	rpr_status rprContextCreateImage(rpr_context context, rpr_image_format const format, rpr_image_desc const* image_desc, void const* data, rpr_image* out_image);
+	rpr_status rprContextCreateImageFromFile(rpr_context context, rpr_char const* path, rpr_image* out_image);
+	rpr_status rprContextCreateBuffer(rpr_context context, rpr_buffer_desc const* buffer_desc, void const* data, rpr_buffer* out_buffer);
+	rpr_status rprContextCreateFrameBuffer(rpr_context context, rpr_framebuffer_format const format, rpr_framebuffer_desc const* fb_desc, rpr_framebuffer* out_fb);
+	rpr_status rprContextCreateMesh(rpr_context context,
+		rpr_float const* vertices, size_t num_vertices, rpr_int vertex_stride,
+		rpr_float const* normals, size_t num_normals, rpr_int normal_stride,
+		rpr_float const* texcoords, size_t num_texcoords, rpr_int texcoord_stride,
+		rpr_int const* vertex_indices, rpr_int vidx_stride,
+		rpr_int const* normal_indices, rpr_int nidx_stride,
+		rpr_int const* texcoord_indices, rpr_int tidx_stride,
+		rpr_int const* num_face_vertices, size_t num_faces, rpr_shape* out_mesh);
+	rpr_status rprContextCreateMeshEx2(rpr_context context,
+		rpr_float const* vertices, size_t num_vertices, rpr_int vertex_stride,
+		rpr_float const* normals, size_t num_normals, rpr_int normal_stride,
+		rpr_int const* perVertexFlag, size_t num_perVertexFlags, rpr_int perVertexFlag_stride,
+		rpr_int numberOfTexCoordLayers, rpr_float const** texcoords, size_t const* num_texcoords, rpr_int const* texcoord_stride,
+		rpr_int const* vertex_indices, rpr_int vidx_stride,
+		rpr_int const* normal_indices, rpr_int nidx_stride,
+		rpr_int const** texcoord_indices, rpr_int const* tidx_stride,
+		rpr_int const* num_face_vertices, size_t num_faces, rpr_mesh_info const* mesh_properties, rpr_shape* out_mesh);
+	rpr_status rprContextCreateInstance(rpr_context context, rpr_shape shape, rpr_shape* out_instance);
+	rpr_status rprContextCreateCurve(rpr_context context, rpr_curve* out_curve,
+		size_t num_controlPoints, rpr_float const* controlPointsData, rpr_int controlPointsStride,
+		size_t num_indices, rpr_uint curveCount, rpr_uint const* indicesData,
+		rpr_float const* radius, rpr_float const* textureUV, rpr_int const* segmentPerCurve, rpr_uint creationFlag_tapered);
+	rpr_status rprContextCreateGrid(rpr_context context, rpr_grid* out_grid,
+		size_t gridSizeX, size_t gridSizeY, size_t gridSizeZ,
+		void const* indicesList, size_t numberOfIndices, rpr_grid_indices_topology indicesListTopology,
+		void const* gridData, size_t gridDataSizeByte, rpr_uint gridDataTopology);
+	rpr_status rprContextCreateHeteroVolume(rpr_context context, rpr_hetero_volume* out_heteroVolume);
+	rpr_status rprContextCreatePointLight(rpr_context context, rpr_light* out_light);
+	rpr_status rprContextCreateSpotLight(rpr_context context, rpr_light* out_light);
+	rpr_status rprContextCreateDirectionalLight(rpr_context context, rpr_light* out_light);
+	rpr_status rprContextCreateEnvironmentLight(rpr_context context, rpr_light* out_light);
+	rpr_status rprContextCreateIESLight(rpr_context context, rpr_light* out_light);
+	rpr_status rprContextCreateSphereLight(rpr_context context, rpr_light* out_light);
+	rpr_status rprContextCreateDiskLight(rpr_context context, rpr_light* out_light);
+
+	// objects
+	rpr_status rprObjectDelete(void* obj);
+	rpr_status rprObjectSetName(void* node, rpr_char const* name);
+
+	// camera
+	rpr_status rprCameraSetMode(rpr_camera camera, rpr_camera_mode mode);
+	rpr_status rprCameraSetLinearMotion(rpr_camera camera, rpr_float x, rpr_float y, rpr_float z);
+	rpr_status rprCameraSetAngularMotion(rpr_camera camera, rpr_float x, rpr_float y, rpr_float z, rpr_float w);
+
+	// shape
+	rpr_status rprShapeGetInfo(rpr_shape shape, rpr_shape_info info, size_t size, void* data, size_t* size_ret);
+	rpr_status rprMeshGetInfo(rpr_shape mesh, rpr_mesh_info mesh_info, size_t size, void* data, size_t* size_ret);
+	rpr_status rprShapeSetTransform(rpr_shape shape, rpr_bool transpose, rpr_float const* transform);
+	rpr_status rprShapeSetMotionTransform(rpr_shape shape, rpr_bool transpose, rpr_float const* transform, rpr_uint timeIndex);
+	rpr_status rprShapeSetMotionTransformCount(rpr_shape shape, rpr_uint nbTransforms);
+	rpr_status rprShapeSetLinearMotion(rpr_shape shape, rpr_float x, rpr_float y, rpr_float z);
+	rpr_status rprShapeSetAngularMotion(rpr_shape shape, rpr_float x, rpr_float y, rpr_float z, rpr_float w);
+	rpr_status rprShapeSetVisibility(rpr_shape shape, rpr_bool visible);
+	rpr_status rprShapeSetVisibilityFlag(rpr_shape shape, rpr_shape_info visibilityFlag, rpr_bool visible);
+	rpr_status rprShapeSetObjectID(rpr_shape shape, rpr_uint objectID);
+	rpr_status rprShapeSetLightGroupID(rpr_shape shape, rpr_uint lightGroupID);
+	rpr_status rprShapeSetContourIgnore(rpr_shape shape, rpr_bool ignoreInContour);
+	rpr_status rprShapeSetShadowCatcher(rpr_shape shape, rpr_bool shadowCatcher);
+	rpr_status rprShapeSetReflectionCatcher(rpr_shape shape, rpr_bool reflectionCatcher);
+	rpr_status rprShapeSetMaterial(rpr_shape shape, rpr_material_node material);
+	rpr_status rprShapeSetMaterialFaces(rpr_shape shape, rpr_material_node node, rpr_int* face_indices, size_t num_faces);
+	rpr_status rprShapeSetVolumeMaterial(rpr_shape shape, rpr_material_node node);
+	rpr_status rprShapeSetDisplacementMaterial(rpr_shape shape, rpr_material_node materialNode);
+	rpr_status rprShapeSetDisplacementScale(rpr_shape shape, rpr_float minscale, rpr_float maxscale);
+	rpr_status rprShapeSetSubdivisionFactor(rpr_shape shape, rpr_uint factor);
+	rpr_status rprShapeSetSubdivisionAutoRatioCap(rpr_shape shape, rpr_float autoRatioCap);
+	rpr_status rprShapeSetSubdivisionCreaseWeight(rpr_shape shape, rpr_float factor);
+	rpr_status rprShapeSetSubdivisionBoundaryInterop(rpr_shape shape, rpr_subdiv_boundary_interfop_type type);
+	rpr_status rprShapeAutoAdaptSubdivisionFactor(rpr_shape shape, rpr_framebuffer framebuffer, rpr_camera camera, rpr_int factor);
+	rpr_status rprShapeSetVertexValue(rpr_shape in_shape, rpr_int setIndex, rpr_int const* indices, rpr_float const* values, rpr_int indicesCount);
+	rpr_status rprShapeSetHeteroVolume(rpr_shape shape, rpr_hetero_volume heteroVolume);
+
+	// curve
+	rpr_status rprCurveSetTransform(rpr_curve curve, rpr_bool transpose, rpr_float const* transform);
+	rpr_status rprCurveSetMaterial(rpr_curve curve, rpr_material_node material);
+	rpr_status rprCurveSetVisibilityFlag(rpr_curve curve, rpr_curve_parameter visibilityFlag, rpr_bool visible);
+
+	// lights
+	rpr_status rprLightSetTransform(rpr_light light, rpr_bool transpose, rpr_float const* transform);
+	rpr_status rprLightSetGroupId(rpr_light light, rpr_uint groupId);
+	rpr_status rprPointLightSetRadiantPower3f(rpr_light light, rpr_float r, rpr_float g, rpr_float b);
+	rpr_status rprSpotLightSetRadiantPower3f(rpr_light light, rpr_float r, rpr_float g, rpr_float b);
+	rpr_status rprSpotLightSetConeShape(rpr_light light, rpr_float iangle, rpr_float oangle);
+	rpr_status rprDirectionalLightSetRadiantPower3f(rpr_light light, rpr_float r, rpr_float g, rpr_float b);
+	rpr_status rprSphereLightSetRadiantPower3f(rpr_light light, rpr_float r, rpr_float g, rpr_float b);
+	rpr_status rprSphereLightSetRadius(rpr_light light, rpr_float radius);
+	rpr_status rprDiskLightSetRadiantPower3f(rpr_light light, rpr_float r, rpr_float g, rpr_float b);
+	rpr_status rprDiskLightSetRadius(rpr_light light, rpr_float radius);
+	rpr_status rprDiskLightSetAngle(rpr_light light, rpr_float angle);
+	rpr_status rprIESLightSetRadiantPower3f(rpr_light light, rpr_float r, rpr_float g, rpr_float b);
+	rpr_status rprIESLightSetImageFromFile(rpr_light env_light, rpr_char const* imagePath, rpr_int nx, rpr_int ny);
+	rpr_status rprIESLightSetImageFromIESdata(rpr_light env_light, rpr_char const* iesData, rpr_int nx, rpr_int ny);
+	rpr_status rprEnvironmentLightSetImage(rpr_light env_light, rpr_image image);
+	rpr_status rprEnvironmentLightSetIntensityScale(rpr_light env_light, rpr_float intensity_scale);
+	rpr_status rprEnvironmentLightAttachPortal(rpr_scene scene, rpr_light env_light, rpr_shape portal);
+	rpr_status rprEnvironmentLightDetachPortal(rpr_scene scene, rpr_light env_light, rpr_shape portal);
+	rpr_status rprEnvironmentLightSetEnvironmentLightOverride(rpr_light in_ibl, rpr_environment_override overrideType, rpr_light in_iblOverride);
+
+	// volumes
+	rpr_status rprHeteroVolumeSetTransform(rpr_hetero_volume heteroVolume, rpr_bool transpose, rpr_float const* transform);
+	rpr_status rprHeteroVolumeSetDensityGrid(rpr_hetero_volume heteroVolume, rpr_grid grid);
+	rpr_status rprHeteroVolumeSetDensityLookup(rpr_hetero_volume heteroVolume, rpr_float const* ptr, rpr_uint n);
+	rpr_status rprHeteroVolumeSetAlbedoGrid(rpr_hetero_volume heteroVolume, rpr_grid grid);
+	rpr_status rprHeteroVolumeSetAlbedoLookup(rpr_hetero_volume heteroVolume, rpr_float const* ptr, rpr_uint n);
+	rpr_status rprHeteroVolumeSetEmissionGrid(rpr_hetero_volume heteroVolume, rpr_grid grid);
+	rpr_status rprHeteroVolumeSetEmissionLookup(rpr_hetero_volume heteroVolume, rpr_float const* ptr, rpr_uint n);
+
+	// images and frame buffers
+	rpr_status rprImageGetInfo(rpr_image image, rpr_image_info image_info, size_t size, void* data, size_t* size_ret);
+	rpr_status rprImageSetGamma(rpr_image image, rpr_float gamma);
+	rpr_status rprImageSetOcioColorspace(rpr_image image, rpr_char const* ocioColorspace);
+	rpr_status rprImageSetUDIM(rpr_image imageUdimRoot, rpr_uint tileIndex, rpr_image imageTile);
+	rpr_status rprFrameBufferClear(rpr_framebuffer frame_buffer);
+	rpr_status rprFrameBufferSaveToFile(rpr_framebuffer frame_buffer, rpr_char const* file_path);
+
+	// scene
+	rpr_status rprSceneGetInfo(rpr_scene scene, rpr_scene_info info, size_t size, void* data, size_t* size_ret);
+	rpr_status rprSceneClear(rpr_scene scene);
+	rpr_status rprSceneAttachShape(rpr_scene scene, rpr_shape shape);
+	rpr_status rprSceneDetachShape(rpr_scene scene, rpr_shape shape);
+	rpr_status rprSceneAttachLight(rpr_scene scene, rpr_light light);
+	rpr_status rprSceneDetachLight(rpr_scene scene, rpr_light light);
+	rpr_status rprSceneAttachCurve(rpr_scene scene, rpr_curve curve);
+	rpr_status rprSceneDetachCurve(rpr_scene scene, rpr_curve curve);
+	rpr_status rprSceneAttachHeteroVolume(rpr_scene scene, rpr_hetero_volume heteroVolume);
+	rpr_status rprSceneDetachHeteroVolume(rpr_scene scene, rpr_hetero_volume heteroVolume);
+	rpr_status rprSceneSetCamera(rpr_scene scene, rpr_camera camera);
+	rpr_status rprSceneSetBackgroundImage(rpr_scene scene, rpr_image image);
+	rpr_status rprSceneSetEnvironmentLight(rpr_scene scene, rpr_light light);
+
+	// material system
+	rpr_status rprMaterialSystemCreateNode(rpr_material_system in_matsys, rpr_material_node_type in_type, rpr_material_node* out_node);
+	rpr_status rprMaterialNodeGetInfo(rpr_material_node in_node, rpr_material_node_info in_info, size_t in_size, void* in_data, size_t* out_size);
+	rpr_status rprMaterialNodeGetInputInfo(rpr_material_node in_node, rpr_int in_input_idx, rpr_material_node_input_info in_info, size_t in_size, void* in_data, size_t* out_size);
+	rpr_status rprMaterialNodeSetID(rpr_material_node in_node, rpr_uint id);
+	rpr_status rprMaterialNodeSetInputFByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_float in_value_x, rpr_float in_value_y, rpr_float in_value_z, rpr_float in_value_w);
+	rpr_status rprMaterialNodeSetInputUByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_uint in_value);
+	rpr_status rprMaterialNodeSetInputNByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_material_node in_input_node);
+	rpr_status rprMaterialNodeSetInputImageDataByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_image image);
+	rpr_status rprMaterialNodeSetInputBufferDataByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_buffer buffer);
+
+	// post effects
+	rpr_status rprPostEffectSetParameter1u(rpr_post_effect effect, rpr_char const* name, rpr_uint x);
+	rpr_status rprPostEffectSetParameter1f(rpr_post_effect effect, rpr_char const* name, rpr_float x);
+}
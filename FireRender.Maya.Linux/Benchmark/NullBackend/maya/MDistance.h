@@ -0,0 +1,54 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+/** Headless stand-in for the Maya distance. The UI unit is centimeters, the Maya default. */
+class MDistance
+{
+public:
+	enum Unit
+	{
+		kInvalid,
+		kInches,
+		kFeet,
+		kYards,
+		kMiles,
+		kMillimeters,
+		kCentimeters,
+		kKilometers,
+		kMeters
+	};
+
+	MDistance(double value, Unit unit) : m_value(value), m_unit(unit) {}
+
+	static Unit uiUnit() { return kCentimeters; }
+
+	double asMeters() const
+	{
+		switch (m_unit)
+		{
+		case kInches: return m_value * 0.0254;
+		case kFeet: return m_value * 0.3048;
+		case kYards: return m_value * 0.9144;
+		case kMiles: return m_value * 1609.344;
+		case kMillimeters: return m_value * 0.001;
+		case kCentimeters: return m_value * 0.01;
+		case kKilometers: return m_value * 1000.0;
+		default: return m_value;
+		}
+	}
+
+private:
+	double m_value;
+	Unit m_unit;
+};
@@ -0,0 +1,50 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+/** Headless stand-in for the Maya string, only what frWrap.h and FireRenderError.h use */
+
+#include <string>
+
+class MString
+{
+public:
+	MString() {}
+	MString(const char* text) : m_text(text ? text : "") {}
+
+	const char* asChar() const { return m_text.c_str(); }
+	unsigned int length() const { return (unsigned int) m_text.size(); }
+
+	MString& operator+=(const MString& other)
+	{
+		m_text += other.m_text;
+		return *this;
+	}
+
+	MString operator+(const MString& other) const
+	{
+		MString result(*this);
+		result += other;
+		return result;
+	}
+
+	bool operator==(const MString& other) const { return m_text == other.m_text; }
+
+private:
+	std::string m_text;
+};
+
+inline MString operator+(const char* text, const MString& string)
+{
+	return MString(text) + string;
+}
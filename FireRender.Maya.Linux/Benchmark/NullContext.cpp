@@ -0,0 +1,277 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "NullContext.h"
+
+#include <cstring>
+
+NullContext::NullContext()
+{
+	m_self.context = this;
+	m_self.kind = Kind::Context;
+
+	Reset();
+}
+
+NullContext::~NullContext()
+{
+	for (Object* object : m_objects)
+		delete object;
+}
+
+void NullContext::Record(Call call, size_t bytes)
+{
+	m_calls[size_t(call)]++;
+	m_bytes[size_t(call)] += bytes;
+}
+
+NullContext::Handle NullContext::NewObject(Kind kind, unsigned int type)
+{
+	Object* object = new Object();
+	object->context = this;
+	object->kind = kind;
+	object->type = type;
+
+	m_objects.insert(object);
+
+	return object;
+}
+
+NullContext::Handle NullContext::CreateMesh(const float* vertices, size_t numVertices, int vertexStride,
+	const float* normals, size_t numNormals, int normalStride,
+	const float* texcoords, size_t numTexcoords, int texcoordStride,
+	const int* vertexIndices, int vertexIndexStride,
+	const int* normalIndices, int normalIndexStride,
+	const int* texcoordIndices, int texcoordIndexStride,
+	const int* numFaceVertices, size_t numFaces)
+{
+	// strides are in bytes, same as in rprContextCreateMesh
+	size_t bytes = 0;
+
+	if (vertices)
+		bytes += numVertices * vertexStride;
+
+	if (normals)
+		bytes += numNormals * normalStride;
+
+	if (texcoords)
+		bytes += numTexcoords * texcoordStride;
+
+	size_t indexCount = 0;
+
+	if (numFaceVertices)
+	{
+		for (size_t i = 0; i < numFaces; i++)
+			indexCount += numFaceVertices[i];
+
+		bytes += numFaces * sizeof(int);
+	}
+
+	if (vertexIndices)
+		bytes += indexCount * vertexIndexStride;
+
+	if (normalIndices)
+		bytes += indexCount * normalIndexStride;
+
+	if (texcoordIndices)
+		bytes += indexCount * texcoordIndexStride;
+
+	return CreateShape(0, numFaces, bytes);
+}
+
+NullContext::Handle NullContext::CreateShape(unsigned int shapeType, size_t numFaces, size_t payloadBytes)
+{
+	Record(Call::CreateMesh, payloadBytes);
+
+	Handle shape = NewObject(Kind::Shape, shapeType);
+	Get(shape)->faceCount = numFaces;
+
+	return shape;
+}
+
+NullContext::Handle NullContext::CreateImage(size_t width, size_t height, size_t channels, size_t bytesPerChannel, const void* data)
+{
+	Record(Call::CreateImage, data ? width * height * channels * bytesPerChannel : 0);
+	return NewObject(Kind::Image);
+}
+
+NullContext::Handle NullContext::CreateFrameBuffer(size_t width, size_t height, size_t channels)
+{
+	Record(Call::CreateFrameBuffer, width * height * channels * sizeof(float));
+	return NewObject(Kind::FrameBuffer);
+}
+
+NullContext::Handle NullContext::CreateMaterialNode(int type)
+{
+	Record(Call::CreateMaterialNode, 0);
+	return NewObject(Kind::MaterialNode, (unsigned int) type);
+}
+
+NullContext::Handle NullContext::CreateLight(int type)
+{
+	Record(Call::CreateLight, 0);
+	return NewObject(Kind::Light, (unsigned int) type);
+}
+
+NullContext::Handle NullContext::CreateObject(Kind kind, size_t payloadBytes)
+{
+	Record(Call::CreateObject, payloadBytes);
+	return NewObject(kind);
+}
+
+void NullContext::SetParameter(Handle /*object*/, int /*key*/, size_t payloadBytes)
+{
+	Record(Call::SetParameter, payloadBytes);
+}
+
+void NullContext::SetTransform(Handle /*object*/, const float* /*matrix*/)
+{
+	Record(Call::SetTransform, 16 * sizeof(float));
+}
+
+void NullContext::SetMaterialNodeInput(Handle /*node*/, int /*key*/, size_t payloadBytes)
+{
+	Record(Call::SetMaterialNodeInput, payloadBytes);
+}
+
+void NullContext::Attach(Handle scene, Handle object)
+{
+	Record(Call::SceneAttach, 0);
+
+	if (scene && object)
+		Get(scene)->attached.push_back(object);
+}
+
+void NullContext::Detach(Handle scene, Handle object)
+{
+	Record(Call::SceneDetach, 0);
+
+	if (!scene)
+		return;
+
+	std::vector<Handle>& attached = Get(scene)->attached;
+
+	for (size_t i = 0; i < attached.size(); i++)
+	{
+		if (attached[i] == object)
+		{
+			attached.erase(attached.begin() + i);
+			break;
+		}
+	}
+}
+
+bool NullContext::Delete(Handle object)
+{
+	Record(Call::ObjectDelete, 0);
+
+	if (object == &m_self)
+		return true;
+
+	auto it = m_objects.find(Get(object));
+
+	if (it == m_objects.end())
+		return false;
+
+	delete *it;
+	m_objects.erase(it);
+
+	return true;
+}
+
+void NullContext::Render()
+{
+	Record(Call::Render, 0);
+}
+
+void NullContext::ResolveFrameBuffer(Handle /*src*/, Handle /*dst*/)
+{
+	Record(Call::ResolveFrameBuffer, 0);
+}
+
+void NullContext::GetFrameBufferData(Handle /*frameBuffer*/, void* data, size_t size)
+{
+	if (data)
+		memset(data, 0, size);
+
+	Record(Call::GetFrameBufferData, size);
+}
+
+void NullContext::GetInfo(Handle /*object*/, size_t size)
+{
+	Record(Call::GetInfo, size);
+}
+
+size_t NullContext::Calls(const char* entryPoint) const
+{
+	for (const auto& it : m_entryPoints)
+	{
+		if (strcmp(it.first, entryPoint) == 0)
+			return it.second;
+	}
+
+	return 0;
+}
+
+size_t NullContext::TotalCalls() const
+{
+	size_t total = 0;
+
+	for (size_t calls : m_calls)
+		total += calls;
+
+	return total;
+}
+
+size_t NullContext::TotalBytes() const
+{
+	size_t total = 0;
+
+	for (size_t bytes : m_bytes)
+		total += bytes;
+
+	return total;
+}
+
+void NullContext::Reset()
+{
+	m_calls.fill(0);
+	m_bytes.fill(0);
+	m_entryPoints.clear();
+}
+
+const char* NullContext::CallName(Call call)
+{
+	static const char* names[] =
+	{
+		"CreateMesh",
+		"CreateImage",
+		"CreateFrameBuffer",
+		"CreateMaterialNode",
+		"CreateLight",
+		"CreateObject",
+		"SetParameter",
+		"SetTransform",
+		"SetMaterialNodeInput",
+		"SceneAttach",
+		"SceneDetach",
+		"ObjectDelete",
+		"Render",
+		"ResolveFrameBuffer",
+		"GetFrameBufferData",
+		"GetInfo"
+	};
+
+	static_assert(sizeof(names) / sizeof(names[0]) == size_t(Call::Count), "Call names are out of sync with Call enum");
+
+	return names[size_t(call)];
+}
@@ -0,0 +1,162 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/** Render backend which does nothing but count.
+
+	It sits behind the RPR C API: NullRpr.cpp implements the rpr* entry points frWrap.h calls
+	on top of it, so frw::Context(nullContext.GetHandle(), false) runs the production wrappers
+	headless. Calls are counted per entry point and grouped by kind with the payload size,
+	so the amount of data a sync hands to the backend can be compared between changes.
+	Not thread safe, same as one RPR context. */
+class NullContext
+{
+public:
+	// rpr_context, rpr_shape, rpr_material_node... of this backend
+	typedef void* Handle;
+
+	enum class Call
+	{
+		CreateMesh = 0,
+		CreateImage,
+		CreateFrameBuffer,
+		CreateMaterialNode,
+		CreateLight,
+		CreateObject,
+		SetParameter,
+		SetTransform,
+		SetMaterialNodeInput,
+		SceneAttach,
+		SceneDetach,
+		ObjectDelete,
+		Render,
+		ResolveFrameBuffer,
+		GetFrameBufferData,
+		GetInfo,
+
+		Count
+	};
+
+	enum class Kind
+	{
+		Context,
+		Scene,
+		Shape,
+		Light,
+		Image,
+		FrameBuffer,
+		MaterialNode,
+		Other
+	};
+
+	// What a handle points to
+	struct Object
+	{
+		NullContext* context = nullptr;
+		Kind kind = Kind::Other;
+		unsigned int type = 0;			// node, light or shape type
+		size_t faceCount = 0;			// of meshes
+		std::vector<Handle> attached;	// shapes and lights of scenes
+	};
+
+public:
+	NullContext();
+	~NullContext();
+
+	NullContext(const NullContext&) = delete;
+	NullContext& operator=(const NullContext&) = delete;
+
+	// rpr_context of this backend, it is not deleted by rprObjectDelete
+	Handle GetHandle() { return &m_self; }
+
+	// Object behind a handle created by any NullContext, null for null
+	static Object* Get(Handle handle) { return static_cast<Object*>(handle); }
+
+	Handle CreateMesh(const float* vertices, size_t numVertices, int vertexStride,
+		const float* normals, size_t numNormals, int normalStride,
+		const float* texcoords, size_t numTexcoords, int texcoordStride,
+		const int* vertexIndices, int vertexIndexStride,
+		const int* normalIndices, int normalIndexStride,
+		const int* texcoordIndices, int texcoordIndexStride,
+		const int* numFaceVertices, size_t numFaces);
+
+	// Mesh of which the caller computed the payload size, and instances (0 bytes)
+	Handle CreateShape(unsigned int shapeType, size_t numFaces, size_t payloadBytes);
+
+	Handle CreateImage(size_t width, size_t height, size_t channels, size_t bytesPerChannel, const void* data);
+	Handle CreateFrameBuffer(size_t width, size_t height, size_t channels);
+	Handle CreateMaterialNode(int type);
+	Handle CreateLight(int type);
+
+	// Scenes, cameras, material systems, buffers, curves, volumes and post effects
+	Handle CreateObject(Kind kind, size_t payloadBytes = 0);
+
+	void SetParameter(Handle object, int key, size_t payloadBytes);
+	void SetTransform(Handle object, const float* matrix);
+	void SetMaterialNodeInput(Handle node, int key, size_t payloadBytes);
+
+	// The scene may be null when only the load is replayed
+	void Attach(Handle scene, Handle object);
+	void Detach(Handle scene, Handle object);
+
+	// False for a handle which isn't a live object of this context
+	bool Delete(Handle object);
+
+	void Render();
+	void ResolveFrameBuffer(Handle src, Handle dst);
+
+	// Fills the caller buffer with zeros, as if pixels were read back
+	void GetFrameBufferData(Handle frameBuffer, void* data, size_t size);
+
+	void GetInfo(Handle object, size_t size);
+
+	// NullRpr.cpp counts every entry point it runs by name
+	void CountEntryPoint(const char* name) { m_entryPoints[name]++; }
+
+	// Calls of an RPR entry point, e.g. Calls("rprShapeSetTransform")
+	size_t Calls(const char* entryPoint) const;
+
+	size_t Calls(Call call) const { return m_calls[size_t(call)]; }
+	size_t Bytes(Call call) const { return m_bytes[size_t(call)]; }
+
+	size_t TotalCalls() const;
+	size_t TotalBytes() const;
+
+	// Objects created and not deleted yet
+	size_t LiveObjects() const { return m_objects.size(); }
+
+	// Clears the counters, live objects stay valid
+	void Reset();
+
+	static const char* CallName(Call call);
+
+private:
+	void Record(Call call, size_t bytes);
+	Handle NewObject(Kind kind, unsigned int type = 0);
+
+private:
+	std::array<size_t, size_t(Call::Count)> m_calls;
+	std::array<size_t, size_t(Call::Count)> m_bytes;
+
+	// keyed by __func__ of the entry points, which is unique per function
+	std::unordered_map<const char*, size_t> m_entryPoints;
+
+	Object m_self;
+	std::unordered_set<Object*> m_objects;
+};
@@ -0,0 +1,970 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+// RPR C API entry points of the null backend, see NullBackend/RadeonProRender.h.
+// Every entry point is counted by name; creation, setters and attachments are also recorded
+// by kind with their payload size. Queries answer from what the backend tracks (scene lists,
+// shape types, face counts) and zero the rest.
+
+#include "NullContext.h"
+
+#include "FireRenderError.h"
+
+#include <RadeonProRender.h>
+#include <RadeonProRender_GL.h>
+#include <ProRenderGLTF.h>
+
+#include <cstring>
+
+namespace
+{
+	NullContext* Count(void* handle, const char* entryPoint)
+	{
+		NullContext::Object* object = NullContext::Get(handle);
+
+		if (!object)
+			return nullptr;
+
+		object->context->CountEntryPoint(entryPoint);
+		return object->context;
+	}
+
+	template <class T>
+	rpr_status Create(NullContext::Handle handle, T* out)
+	{
+		if (!out)
+			return RPR_ERROR_INVALID_PARAMETER;
+
+		*out = handle;
+		return RPR_SUCCESS;
+	}
+
+	// Answers a query with a value the backend knows
+	template <class T>
+	rpr_status Answer(const T& value, size_t size, void* data, size_t* size_ret)
+	{
+		if (data)
+		{
+			if (size < sizeof(T))
+				return RPR_ERROR_INVALID_PARAMETER;
+
+			memcpy(data, &value, sizeof(T));
+		}
+
+		if (size_ret)
+			*size_ret = sizeof(T);
+
+		return RPR_SUCCESS;
+	}
+
+	// Answers a query the backend has nothing for with zeros
+	rpr_status AnswerZeros(size_t size, void* data, size_t* size_ret)
+	{
+		if (data)
+			memset(data, 0, size);
+
+		if (size_ret)
+			*size_ret = data ? size : 0;
+
+		return RPR_SUCCESS;
+	}
+
+	rpr_status AnswerAttached(const NullContext::Object& scene, NullContext::Kind kind, bool list, size_t size, void* data, size_t* size_ret)
+	{
+		std::vector<void*> items;
+
+		for (void* item : scene.attached)
+		{
+			if (NullContext::Get(item)->kind == kind)
+				items.push_back(item);
+		}
+
+		if (!list)
+			return Answer(size_t(items.size()), size, data, size_ret);
+
+		size_t bytes = items.size() * sizeof(void*);
+
+		if (data)
+		{
+			if (size < bytes)
+				return RPR_ERROR_INVALID_PARAMETER;
+
+			memcpy(data, items.data(), bytes);
+		}
+
+		if (size_ret)
+			*size_ret = bytes;
+
+		return RPR_SUCCESS;
+	}
+
+	size_t IndexCount(rpr_int const* num_face_vertices, size_t num_faces)
+	{
+		size_t count = 0;
+
+		for (size_t i = 0; num_face_vertices && i < num_faces; i++)
+			count += num_face_vertices[i];
+
+		return count;
+	}
+
+	size_t ComponentSize(rpr_component_type type)
+	{
+		switch (type)
+		{
+		case RPR_COMPONENT_TYPE_UINT8: return 1;
+		case RPR_COMPONENT_TYPE_FLOAT16: return 2;
+		default: return 4;
+		}
+	}
+}
+
+#define NULL_RPR_CONTEXT(handle) \
+	NullContext* nullContext = Count(handle, __func__); \
+	if (!nullContext) \
+		return RPR_ERROR_INVALID_OBJECT
+
+extern "C"
+{
+
+// context
+
+rpr_status rprContextGetInfo(rpr_context context, rpr_context_info /*context_info*/, size_t size, void* data, size_t* size_ret)
+{
+	NULL_RPR_CONTEXT(context);
+	nullContext->GetInfo(context, size);
+	return AnswerZeros(size, data, size_ret);
+}
+
+rpr_status rprContextGetParameterInfo(rpr_context context, int /*param_idx*/, rpr_parameter_info /*parameter_info*/, size_t size, void* data, size_t* size_ret)
+{
+	NULL_RPR_CONTEXT(context);
+	nullContext->GetInfo(context, size);
+	return AnswerZeros(size, data, size_ret);
+}
+
+// A null context sets process wide parameters (tracing), which the null backend accepts and ignores
+#define NULL_RPR_CONTEXT_PARAMETER(context) \
+	if (!context) \
+		return RPR_SUCCESS; \
+	NULL_RPR_CONTEXT(context)
+
+rpr_status rprContextSetParameterByKey1u(rpr_context context, rpr_context_info in_input, rpr_uint /*x*/)
+{
+	NULL_RPR_CONTEXT_PARAMETER(context);
+	nullContext->SetParameter(context, int(in_input), sizeof(rpr_uint));
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextSetParameterByKey1f(rpr_context context, rpr_context_info in_input, rpr_float /*x*/)
+{
+	NULL_RPR_CONTEXT_PARAMETER(context);
+	nullContext->SetParameter(context, int(in_input), sizeof(rpr_float));
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextSetParameterByKey3f(rpr_context context, rpr_context_info in_input, rpr_float /*x*/, rpr_float /*y*/, rpr_float /*z*/)
+{
+	NULL_RPR_CONTEXT_PARAMETER(context);
+	nullContext->SetParameter(context, int(in_input), 3 * sizeof(rpr_float));
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextSetParameterByKey4f(rpr_context context, rpr_context_info in_input, rpr_float /*x*/, rpr_float /*y*/, rpr_float /*z*/, rpr_float /*w*/)
+{
+	NULL_RPR_CONTEXT_PARAMETER(context);
+	nullContext->SetParameter(context, int(in_input), 4 * sizeof(rpr_float));
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextSetParameterByKeyPtr(rpr_context context, rpr_context_info in_input, void* /*value*/)
+{
+	NULL_RPR_CONTEXT_PARAMETER(context);
+	nullContext->SetParameter(context, int(in_input), sizeof(void*));
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextSetParameterByKeyString(rpr_context context, rpr_context_info in_input, rpr_char const* value)
+{
+	NULL_RPR_CONTEXT_PARAMETER(context);
+	nullContext->SetParameter(context, int(in_input), value ? strlen(value) : 0);
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextSetAOV(rpr_context context, rpr_aov aov, rpr_framebuffer /*frame_buffer*/)
+{
+	NULL_RPR_CONTEXT(context);
+	nullContext->SetParameter(context, int(aov), sizeof(rpr_framebuffer));
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextSetScene(rpr_context context, rpr_scene /*scene*/)
+{
+	NULL_RPR_CONTEXT(context);
+	nullContext->SetParameter(context, RPR_CONTEXT_SCENE, sizeof(rpr_scene));
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextRender(rpr_context context)
+{
+	NULL_RPR_CONTEXT(context);
+	nullContext->Render();
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextRenderTile(rpr_context context, rpr_uint /*xmin*/, rpr_uint /*xmax*/, rpr_uint /*ymin*/, rpr_uint /*ymax*/)
+{
+	NULL_RPR_CONTEXT(context);
+	nullContext->Render();
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextAbortRender(rpr_context context)
+{
+	NULL_RPR_CONTEXT(context);
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextResolveFrameBuffer(rpr_context context, rpr_framebuffer src_frame_buffer, rpr_framebuffer dst_frame_buffer, rpr_bool /*noDisplayGamma*/)
+{
+	NULL_RPR_CONTEXT(context);
+	nullContext->ResolveFrameBuffer(src_frame_buffer, dst_frame_buffer);
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextAttachPostEffect(rpr_context context, rpr_post_effect effect)
+{
+	NULL_RPR_CONTEXT(context);
+	nullContext->Attach(nullptr, effect);
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextDetachPostEffect(rpr_context context, rpr_post_effect effect)
+{
+	NULL_RPR_CONTEXT(context);
+	nullContext->Detach(nullptr, effect);
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextCreateScene(rpr_context context, rpr_scene* out_scene)
+{
+	NULL_RPR_CONTEXT(context);
+	return Create(nullContext->CreateObject(NullContext::Kind::Scene), out_scene);
+}
+
+rpr_status rprContextCreateCamera(rpr_context context, rpr_camera* out_camera)
+{
+	NULL_RPR_CONTEXT(context);
+	return Create(nullContext->CreateObject(NullContext::Kind::Other), out_camera);
+}
+
+rpr_status rprContextCreateMaterialSystem(rpr_context context, rpr_material_system_type /*type*/, rpr_material_system* out_matsys)
+{
+	NULL_RPR_CONTEXT(context);
+	return Create(nullContext->CreateObject(NullContext::Kind::Other), out_matsys);
+}
+
+rpr_status rprContextCreatePostEffect(rpr_context context, rpr_post_effect_type /*type*/, rpr_post_effect* out_effect)
+{
+	NULL_RPR_CONTEXT(context);
+	return Create(nullContext->CreateObject(NullContext::Kind::Other), out_effect);
+}
+
+rpr_status rprContextCreateImage(rpr_context context, rpr_image_format const format, rpr_image_desc const* image_desc, void const* data, rpr_image* out_image)
+{
+	NULL_RPR_CONTEXT(context);
+
+	size_t width = image_desc ? image_desc->image_width : 0;
+	size_t height = image_desc ? image_desc->image_height : 0;
+
+	return Create(nullContext->CreateImage(width, height, format.num_components, ComponentSize(format.type), data), out_image);
+}
+
+rpr_status rprContextCreateImageFromFile(rpr_context context, rpr_char const* /*path*/, rpr_image* out_image)
+{
+	NULL_RPR_CONTEXT(context);
+
+	// pixels are read by the backend, the payload is unknown
+	return Create(nullContext->CreateImage(0, 0, 0, 0, nullptr), out_image);
+}
+
+rpr_status rprContextCreateBuffer(rpr_context context, rpr_buffer_desc const* buffer_desc, void const* data, rpr_buffer* out_buffer)
+{
+	NULL_RPR_CONTEXT(context);
+
+	size_t bytes = data && buffer_desc ? size_t(buffer_desc->nb_element) * buffer_desc->element_channel_size * sizeof(rpr_float) : 0;
+
+	return Create(nullContext->CreateObject(NullContext::Kind::Other, bytes), out_buffer);
+}
+
+rpr_status rprContextCreateFrameBuffer(rpr_context context, rpr_framebuffer_format const format, rpr_framebuffer_desc const* fb_desc, rpr_framebuffer* out_fb)
+{
+	NULL_RPR_CONTEXT(context);
+
+	if (!fb_desc)
+		return RPR_ERROR_INVALID_PARAMETER;
+
+	return Create(nullContext->CreateFrameBuffer(fb_desc->fb_width, fb_desc->fb_height, format.num_components), out_fb);
+}
+
+rpr_status rprContextCreateMesh(rpr_context context,
+	rpr_float const* vertices, size_t num_vertices, rpr_int vertex_stride,
+	rpr_float const* normals, size_t num_normals, rpr_int normal_stride,
+	rpr_float const* texcoords, size_t num_texcoords, rpr_int texcoord_stride,
+	rpr_int const* vertex_indices, rpr_int vidx_stride,
+	rpr_int const* normal_indices, rpr_int nidx_stride,
+	rpr_int const* texcoord_indices, rpr_int tidx_stride,
+	rpr_int const* num_face_vertices, size_t num_faces, rpr_shape* out_mesh)
+{
+	NULL_RPR_CONTEXT(context);
+
+	rpr_shape shape = nullContext->CreateMesh(
+		vertices, num_vertices, vertex_stride,
+		normals, num_normals, normal_stride,
+		texcoords, num_texcoords, texcoord_stride,
+		vertex_indices, vidx_stride,
+		normal_indices, nidx_stride,
+		texcoord_indices, tidx_stride,
+		num_face_vertices, num_faces);
+
+	NullContext::Get(shape)->type = RPR_SHAPE_TYPE_MESH;
+
+	return Create(shape, out_mesh);
+}
+
+rpr_status rprContextCreateMeshEx2(rpr_context context,
+	rpr_float const* vertices, size_t num_vertices, rpr_int vertex_stride,
+	rpr_float const* normals, size_t num_normals, rpr_int normal_stride,
+	rpr_int const* perVertexFlag, size_t num_perVertexFlags, rpr_int perVertexFlag_stride,
+	rpr_int numberOfTexCoordLayers, rpr_float const** texcoords, size_t const* num_texcoords, rpr_int const* texcoord_stride,
+	rpr_int const* vertex_indices, rpr_int vidx_stride,
+	rpr_int const* normal_indices, rpr_int nidx_stride,
+	rpr_int const** texcoord_indices, rpr_int const* tidx_stride,
+	rpr_int const* num_face_vertices, size_t num_faces, rpr_mesh_info const* /*mesh_properties*/, rpr_shape* out_mesh)
+{
+	NULL_RPR_CONTEXT(context);
+
+	size_t indexCount = IndexCount(num_face_vertices, num_faces);
+	size_t bytes = num_faces * sizeof(rpr_int);
+
+	if (vertices)
+		bytes += num_vertices * vertex_stride;
+
+	if (normals)
+		bytes += num_normals * normal_stride;
+
+	if (perVertexFlag)
+		bytes += num_perVertexFlags * perVertexFlag_stride;
+
+	if (vertex_indices)
+		bytes += indexCount * vidx_stride;
+
+	if (normal_indices)
+		bytes += indexCount * nidx_stride;
+
+	for (rpr_int layer = 0; layer < numberOfTexCoordLayers; layer++)
+	{
+		if (texcoords && texcoords[layer])
+			bytes += num_texcoords[layer] * texcoord_stride[layer];
+
+		if (texcoord_indices && texcoord_indices[layer])
+			bytes += indexCount * tidx_stride[layer];
+	}
+
+	return Create(nullContext->CreateShape(RPR_SHAPE_TYPE_MESH, num_faces, bytes), out_mesh);
+}
+
+rpr_status rprContextCreateInstance(rpr_context context, rpr_shape shape, rpr_shape* out_instance)
+{
+	NULL_RPR_CONTEXT(context);
+
+	if (!shape)
+		return RPR_ERROR_INVALID_OBJECT;
+
+	return Create(nullContext->CreateShape(RPR_SHAPE_TYPE_INSTANCE, NullContext::Get(shape)->faceCount, 0), out_instance);
+}
+
+rpr_status rprContextCreateCurve(rpr_context context, rpr_curve* out_curve,
+	size_t num_controlPoints, rpr_float const* /*controlPointsData*/, rpr_int controlPointsStride,
+	size_t num_indices, rpr_uint curveCount, rpr_uint const* /*indicesData*/,
+	rpr_float const* radius, rpr_float const* textureUV, rpr_int const* /*segmentPerCurve*/, rpr_uint /*creationFlag_tapered*/)
+{
+	NULL_RPR_CONTEXT(context);
+
+	size_t bytes = num_controlPoints * controlPointsStride + num_indices * sizeof(rpr_uint) + curveCount * sizeof(rpr_int);
+
+	if (radius)
+		bytes += curveCount * sizeof(rpr_float);
+
+	if (textureUV)
+		bytes += curveCount * 2 * sizeof(rpr_float);
+
+	return Create(nullContext->CreateObject(NullContext::Kind::Other, bytes), out_curve);
+}
+
+rpr_status rprContextCreateGrid(rpr_context context, rpr_grid* out_grid,
+	size_t /*gridSizeX*/, size_t /*gridSizeY*/, size_t /*gridSizeZ*/,
+	void const* /*indicesList*/, size_t numberOfIndices, rpr_grid_indices_topology /*indicesListTopology*/,
+	void const* /*gridData*/, size_t gridDataSizeByte, rpr_uint /*gridDataTopology*/)
+{
+	NULL_RPR_CONTEXT(context);
+	return Create(nullContext->CreateObject(NullContext::Kind::Other, numberOfIndices * sizeof(uint64_t) + gridDataSizeByte), out_grid);
+}
+
+rpr_status rprContextCreateHeteroVolume(rpr_context context, rpr_hetero_volume* out_heteroVolume)
+{
+	NULL_RPR_CONTEXT(context);
+	return Create(nullContext->CreateObject(NullContext::Kind::Other), out_heteroVolume);
+}
+
+#define NULL_RPR_CREATE_LIGHT(name, type) \
+	rpr_status name(rpr_context context, rpr_light* out_light) \
+	{ \
+		NULL_RPR_CONTEXT(context); \
+		return Create(nullContext->CreateLight(type), out_light); \
+	}
+
+NULL_RPR_CREATE_LIGHT(rprContextCreatePointLight, RPR_LIGHT_TYPE_POINT)
+NULL_RPR_CREATE_LIGHT(rprContextCreateSpotLight, RPR_LIGHT_TYPE_SPOT)
+NULL_RPR_CREATE_LIGHT(rprContextCreateDirectionalLight, RPR_LIGHT_TYPE_DIRECTIONAL)
+NULL_RPR_CREATE_LIGHT(rprContextCreateEnvironmentLight, RPR_LIGHT_TYPE_ENVIRONMENT)
+NULL_RPR_CREATE_LIGHT(rprContextCreateIESLight, RPR_LIGHT_TYPE_IES)
+NULL_RPR_CREATE_LIGHT(rprContextCreateSphereLight, RPR_LIGHT_TYPE_SPHERE)
+NULL_RPR_CREATE_LIGHT(rprContextCreateDiskLight, RPR_LIGHT_TYPE_DISK)
+
+rpr_status rprContextCreateFramebufferFromGLTexture2D(rpr_context context, rpr_GLenum /*target*/, rpr_GLint /*miplevel*/, rpr_GLuint /*texture*/, rpr_framebuffer* /*out_fb*/)
+{
+	NULL_RPR_CONTEXT(context);
+
+	// there is no GL in a headless run
+	return RPR_ERROR_UNSUPPORTED;
+}
+
+// objects
+
+rpr_status rprObjectDelete(void* obj)
+{
+	NULL_RPR_CONTEXT(obj);
+	return nullContext->Delete(obj) ? RPR_SUCCESS : RPR_ERROR_INVALID_OBJECT;
+}
+
+rpr_status rprObjectSetName(void* node, rpr_char const* /*name*/)
+{
+	NULL_RPR_CONTEXT(node);
+	return RPR_SUCCESS;
+}
+
+// Setters of one value: counted as a parameter with its size
+#define NULL_RPR_SET(handle, key, bytes) \
+	NULL_RPR_CONTEXT(handle); \
+	nullContext->SetParameter(handle, int(key), bytes); \
+	return RPR_SUCCESS
+
+#define NULL_RPR_SET_TRANSFORM(handle, transform) \
+	NULL_RPR_CONTEXT(handle); \
+	nullContext->SetTransform(handle, transform); \
+	return RPR_SUCCESS
+
+// camera
+
+rpr_status rprCameraSetMode(rpr_camera camera, rpr_camera_mode mode)
+{
+	NULL_RPR_SET(camera, mode, sizeof(mode));
+}
+
+rpr_status rprCameraSetLinearMotion(rpr_camera camera, rpr_float /*x*/, rpr_float /*y*/, rpr_float /*z*/)
+{
+	NULL_RPR_SET(camera, 0, 3 * sizeof(rpr_float));
+}
+
+rpr_status rprCameraSetAngularMotion(rpr_camera camera, rpr_float /*x*/, rpr_float /*y*/, rpr_float /*z*/, rpr_float /*w*/)
+{
+	NULL_RPR_SET(camera, 0, 4 * sizeof(rpr_float));
+}
+
+// shape
+
+rpr_status rprShapeGetInfo(rpr_shape shape, rpr_shape_info info, size_t size, void* data, size_t* size_ret)
+{
+	NULL_RPR_CONTEXT(shape);
+	nullContext->GetInfo(shape, size);
+
+	if (info == RPR_SHAPE_TYPE)
+		return Answer(rpr_shape_type(NullContext::Get(shape)->type), size, data, size_ret);
+
+	return AnswerZeros(size, data, size_ret);
+}
+
+rpr_status rprMeshGetInfo(rpr_shape mesh, rpr_mesh_info mesh_info, size_t size, void* data, size_t* size_ret)
+{
+	NULL_RPR_CONTEXT(mesh);
+	nullContext->GetInfo(mesh, size);
+
+	if (mesh_info == RPR_MESH_POLYGON_COUNT)
+		return Answer(NullContext::Get(mesh)->faceCount, size, data, size_ret);
+
+	return AnswerZeros(size, data, size_ret);
+}
+
+rpr_status rprShapeSetTransform(rpr_shape shape, rpr_bool /*transpose*/, rpr_float const* transform)
+{
+	NULL_RPR_SET_TRANSFORM(shape, transform);
+}
+
+rpr_status rprShapeSetMotionTransform(rpr_shape shape, rpr_bool /*transpose*/, rpr_float const* /*transform*/, rpr_uint /*timeIndex*/)
+{
+	NULL_RPR_SET(shape, RPR_SHAPE_MOTION_TRANSFORMS, 16 * sizeof(rpr_float));
+}
+
+rpr_status rprShapeSetMotionTransformCount(rpr_shape shape, rpr_uint /*nbTransforms*/)
+{
+	NULL_RPR_SET(shape, RPR_SHAPE_MOTION_TRANSFORMS_COUNT, sizeof(rpr_uint));
+}
+
+rpr_status rprShapeSetLinearMotion(rpr_shape shape, rpr_float /*x*/, rpr_float /*y*/, rpr_float /*z*/)
+{
+	NULL_RPR_SET(shape, RPR_SHAPE_LINEAR_MOTION, 3 * sizeof(rpr_float));
+}
+
+rpr_status rprShapeSetAngularMotion(rpr_shape shape, rpr_float /*x*/, rpr_float /*y*/, rpr_float /*z*/, rpr_float /*w*/)
+{
+	NULL_RPR_SET(shape, RPR_SHAPE_ANGULAR_MOTION, 4 * sizeof(rpr_float));
+}
+
+rpr_status rprShapeSetVisibility(rpr_shape shape, rpr_bool /*visible*/)
+{
+	NULL_RPR_SET(shape, 0, sizeof(rpr_bool));
+}
+
+rpr_status rprShapeSetVisibilityFlag(rpr_shape shape, rpr_shape_info visibilityFlag, rpr_bool /*visible*/)
+{
+	NULL_RPR_SET(shape, visibilityFlag, sizeof(rpr_bool));
+}
+
+rpr_status rprShapeSetObjectID(rpr_shape shape, rpr_uint /*objectID*/)
+{
+	NULL_RPR_SET(shape, RPR_SHAPE_OBJECT_ID, sizeof(rpr_uint));
+}
+
+rpr_status rprShapeSetLightGroupID(rpr_shape shape, rpr_uint /*lightGroupID*/)
+{
+	NULL_RPR_SET(shape, RPR_SHAPE_LIGHTGROUP_ID, sizeof(rpr_uint));
+}
+
+rpr_status rprShapeSetContourIgnore(rpr_shape shape, rpr_bool /*ignoreInContour*/)
+{
+	NULL_RPR_SET(shape, RPR_SHAPE_CONTOUR_IGNORE, sizeof(rpr_bool));
+}
+
+rpr_status rprShapeSetShadowCatcher(rpr_shape shape, rpr_bool /*shadowCatcher*/)
+{
+	NULL_RPR_SET(shape, 0, sizeof(rpr_bool));
+}
+
+rpr_status rprShapeSetReflectionCatcher(rpr_shape shape, rpr_bool /*reflectionCatcher*/)
+{
+	NULL_RPR_SET(shape, 0, sizeof(rpr_bool));
+}
+
+rpr_status rprShapeSetMaterial(rpr_shape shape, rpr_material_node /*material*/)
+{
+	NULL_RPR_SET(shape, 0, sizeof(rpr_material_node));
+}
+
+rpr_status rprShapeSetMaterialFaces(rpr_shape shape, rpr_material_node /*node*/, rpr_int* /*face_indices*/, size_t num_faces)
+{
+	NULL_RPR_SET(shape, 0, sizeof(rpr_material_node) + num_faces * sizeof(rpr_int));
+}
+
+rpr_status rprShapeSetVolumeMaterial(rpr_shape shape, rpr_material_node /*node*/)
+{
+	NULL_RPR_SET(shape, 0, sizeof(rpr_material_node));
+}
+
+rpr_status rprShapeSetDisplacementMaterial(rpr_shape shape, rpr_material_node /*materialNode*/)
+{
+	NULL_RPR_SET(shape, 0, sizeof(rpr_material_node));
+}
+
+rpr_status rprShapeSetDisplacementScale(rpr_shape shape, rpr_float /*minscale*/, rpr_float /*maxscale*/)
+{
+	NULL_RPR_SET(shape, 0, 2 * sizeof(rpr_float));
+}
+
+rpr_status rprShapeSetSubdivisionFactor(rpr_shape shape, rpr_uint /*factor*/)
+{
+	NULL_RPR_SET(shape, 0, sizeof(rpr_uint));
+}
+
+rpr_status rprShapeSetSubdivisionAutoRatioCap(rpr_shape shape, rpr_float /*autoRatioCap*/)
+{
+	NULL_RPR_SET(shape, 0, sizeof(rpr_float));
+}
+
+rpr_status rprShapeSetSubdivisionCreaseWeight(rpr_shape shape, rpr_float /*factor*/)
+{
+	NULL_RPR_SET(shape, 0, sizeof(rpr_float));
+}
+
+rpr_status rprShapeSetSubdivisionBoundaryInterop(rpr_shape shape, rpr_subdiv_boundary_interfop_type /*type*/)
+{
+	NULL_RPR_SET(shape, 0, sizeof(rpr_uint));
+}
+
+rpr_status rprShapeAutoAdaptSubdivisionFactor(rpr_shape shape, rpr_framebuffer /*framebuffer*/, rpr_camera /*camera*/, rpr_int /*factor*/)
+{
+	NULL_RPR_SET(shape, 0, sizeof(rpr_int));
+}
+
+rpr_status rprShapeSetVertexValue(rpr_shape in_shape, rpr_int setIndex, rpr_int const* /*indices*/, rpr_float const* /*values*/, rpr_int indicesCount)
+{
+	NULL_RPR_SET(in_shape, setIndex, size_t(indicesCount) * (sizeof(rpr_int) + sizeof(rpr_float)));
+}
+
+rpr_status rprShapeSetHeteroVolume(rpr_shape shape, rpr_hetero_volume /*heteroVolume*/)
+{
+	NULL_RPR_SET(shape, 0, sizeof(rpr_hetero_volume));
+}
+
+// curve
+
+rpr_status rprCurveSetTransform(rpr_curve curve, rpr_bool /*transpose*/, rpr_float const* transform)
+{
+	NULL_RPR_SET_TRANSFORM(curve, transform);
+}
+
+rpr_status rprCurveSetMaterial(rpr_curve curve, rpr_material_node /*material*/)
+{
+	NULL_RPR_SET(curve, 0, sizeof(rpr_material_node));
+}
+
+rpr_status rprCurveSetVisibilityFlag(rpr_curve curve, rpr_curve_parameter visibilityFlag, rpr_bool /*visible*/)
+{
+	NULL_RPR_SET(curve, visibilityFlag, sizeof(rpr_bool));
+}
+
+// lights
+
+rpr_status rprLightSetTransform(rpr_light light, rpr_bool /*transpose*/, rpr_float const* transform)
+{
+	NULL_RPR_SET_TRANSFORM(light, transform);
+}
+
+rpr_status rprLightSetGroupId(rpr_light light, rpr_uint /*groupId*/)
+{
+	NULL_RPR_SET(light, 0, sizeof(rpr_uint));
+}
+
+#define NULL_RPR_SET_POWER(name) \
+	rpr_status name(rpr_light light, rpr_float /*r*/, rpr_float /*g*/, rpr_float /*b*/) \
+	{ \
+		NULL_RPR_SET(light, 0, 3 * sizeof(rpr_float)); \
+	}
+
+NULL_RPR_SET_POWER(rprPointLightSetRadiantPower3f)
+NULL_RPR_SET_POWER(rprSpotLightSetRadiantPower3f)
+NULL_RPR_SET_POWER(rprDirectionalLightSetRadiantPower3f)
+NULL_RPR_SET_POWER(rprSphereLightSetRadiantPower3f)
+NULL_RPR_SET_POWER(rprDiskLightSetRadiantPower3f)
+NULL_RPR_SET_POWER(rprIESLightSetRadiantPower3f)
+
+rpr_status rprSpotLightSetConeShape(rpr_light light, rpr_float /*iangle*/, rpr_float /*oangle*/)
+{
+	NULL_RPR_SET(light, 0, 2 * sizeof(rpr_float));
+}
+
+rpr_status rprSphereLightSetRadius(rpr_light light, rpr_float /*radius*/)
+{
+	NULL_RPR_SET(light, 0, sizeof(rpr_float));
+}
+
+rpr_status rprDiskLightSetRadius(rpr_light light, rpr_float /*radius*/)
+{
+	NULL_RPR_SET(light, 0, sizeof(rpr_float));
+}
+
+rpr_status rprDiskLightSetAngle(rpr_light light, rpr_float /*angle*/)
+{
+	NULL_RPR_SET(light, 0, sizeof(rpr_float));
+}
+
+rpr_status rprIESLightSetImageFromFile(rpr_light env_light, rpr_char const* imagePath, rpr_int /*nx*/, rpr_int /*ny*/)
+{
+	NULL_RPR_SET(env_light, 0, imagePath ? strlen(imagePath) : 0);
+}
+
+rpr_status rprIESLightSetImageFromIESdata(rpr_light env_light, rpr_char const* iesData, rpr_int /*nx*/, rpr_int /*ny*/)
+{
+	NULL_RPR_SET(env_light, 0, iesData ? strlen(iesData) : 0);
+}
+
+rpr_status rprEnvironmentLightSetImage(rpr_light env_light, rpr_image /*image*/)
+{
+	NULL_RPR_SET(env_light, 0, sizeof(rpr_image));
+}
+
+rpr_status rprEnvironmentLightSetIntensityScale(rpr_light env_light, rpr_float /*intensity_scale*/)
+{
+	NULL_RPR_SET(env_light, 0, sizeof(rpr_float));
+}
+
+rpr_status rprEnvironmentLightAttachPortal(rpr_scene /*scene*/, rpr_light env_light, rpr_shape /*portal*/)
+{
+	NULL_RPR_SET(env_light, 0, sizeof(rpr_shape));
+}
+
+rpr_status rprEnvironmentLightDetachPortal(rpr_scene /*scene*/, rpr_light env_light, rpr_shape /*portal*/)
+{
+	NULL_RPR_SET(env_light, 0, sizeof(rpr_shape));
+}
+
+rpr_status rprEnvironmentLightSetEnvironmentLightOverride(rpr_light in_ibl, rpr_environment_override overrideType, rpr_light /*in_iblOverride*/)
+{
+	NULL_RPR_SET(in_ibl, overrideType, sizeof(rpr_light));
+}
+
+// volumes
+
+rpr_status rprHeteroVolumeSetTransform(rpr_hetero_volume heteroVolume, rpr_bool /*transpose*/, rpr_float const* transform)
+{
+	NULL_RPR_SET_TRANSFORM(heteroVolume, transform);
+}
+
+rpr_status rprHeteroVolumeSetDensityGrid(rpr_hetero_volume heteroVolume, rpr_grid /*grid*/)
+{
+	NULL_RPR_SET(heteroVolume, 0, sizeof(rpr_grid));
+}
+
+rpr_status rprHeteroVolumeSetDensityLookup(rpr_hetero_volume heteroVolume, rpr_float const* /*ptr*/, rpr_uint n)
+{
+	NULL_RPR_SET(heteroVolume, 0, n * 3 * sizeof(rpr_float));
+}
+
+rpr_status rprHeteroVolumeSetAlbedoGrid(rpr_hetero_volume heteroVolume, rpr_grid /*grid*/)
+{
+	NULL_RPR_SET(heteroVolume, 0, sizeof(rpr_grid));
+}
+
+rpr_status rprHeteroVolumeSetAlbedoLookup(rpr_hetero_volume heteroVolume, rpr_float const* /*ptr*/, rpr_uint n)
+{
+	NULL_RPR_SET(heteroVolume, 0, n * 3 * sizeof(rpr_float));
+}
+
+rpr_status rprHeteroVolumeSetEmissionGrid(rpr_hetero_volume heteroVolume, rpr_grid /*grid*/)
+{
+	NULL_RPR_SET(heteroVolume, 0, sizeof(rpr_grid));
+}
+
+rpr_status rprHeteroVolumeSetEmissionLookup(rpr_hetero_volume heteroVolume, rpr_float const* /*ptr*/, rpr_uint n)
+{
+	NULL_RPR_SET(heteroVolume, 0, n * 3 * sizeof(rpr_float));
+}
+
+// images and frame buffers
+
+rpr_status rprImageGetInfo(rpr_image image, rpr_image_info /*image_info*/, size_t size, void* data, size_t* size_ret)
+{
+	NULL_RPR_CONTEXT(image);
+	nullContext->GetInfo(image, size);
+	return AnswerZeros(size, data, size_ret);
+}
+
+rpr_status rprImageSetGamma(rpr_image image, rpr_float /*gamma*/)
+{
+	NULL_RPR_SET(image, 0, sizeof(rpr_float));
+}
+
+rpr_status rprImageSetOcioColorspace(rpr_image image, rpr_char const* ocioColorspace)
+{
+	NULL_RPR_SET(image, 0, ocioColorspace ? strlen(ocioColorspace) : 0);
+}
+
+rpr_status rprImageSetUDIM(rpr_image imageUdimRoot, rpr_uint tileIndex, rpr_image /*imageTile*/)
+{
+	NULL_RPR_SET(imageUdimRoot, tileIndex, sizeof(rpr_image));
+}
+
+rpr_status rprFrameBufferClear(rpr_framebuffer frame_buffer)
+{
+	NULL_RPR_SET(frame_buffer, 0, 0);
+}
+
+rpr_status rprFrameBufferSaveToFile(rpr_framebuffer frame_buffer, rpr_char const* /*file_path*/)
+{
+	NULL_RPR_CONTEXT(frame_buffer);
+
+	// nothing is rendered, so nothing is written
+	return RPR_ERROR_UNSUPPORTED;
+}
+
+// scene
+
+rpr_status rprSceneGetInfo(rpr_scene scene, rpr_scene_info info, size_t size, void* data, size_t* size_ret)
+{
+	NULL_RPR_CONTEXT(scene);
+	nullContext->GetInfo(scene, size);
+
+	const NullContext::Object& object = *NullContext::Get(scene);
+
+	switch (info)
+	{
+	case RPR_SCENE_SHAPE_COUNT: return AnswerAttached(object, NullContext::Kind::Shape, false, size, data, size_ret);
+	case RPR_SCENE_LIGHT_COUNT: return AnswerAttached(object, NullContext::Kind::Light, false, size, data, size_ret);
+	case RPR_SCENE_SHAPE_LIST: return AnswerAttached(object, NullContext::Kind::Shape, true, size, data, size_ret);
+	case RPR_SCENE_LIGHT_LIST: return AnswerAttached(object, NullContext::Kind::Light, true, size, data, size_ret);
+	default: return AnswerZeros(size, data, size_ret);
+	}
+}
+
+rpr_status rprSceneClear(rpr_scene scene)
+{
+	NULL_RPR_CONTEXT(scene);
+
+	NullContext::Get(scene)->attached.clear();
+	return RPR_SUCCESS;
+}
+
+#define NULL_RPR_ATTACH(name, type) \
+	rpr_status name(rpr_scene scene, type object) \
+	{ \
+		NULL_RPR_CONTEXT(scene); \
+		nullContext->Attach(scene, object); \
+		return RPR_SUCCESS; \
+	}
+
+#define NULL_RPR_DETACH(name, type) \
+	rpr_status name(rpr_scene scene, type object) \
+	{ \
+		NULL_RPR_CONTEXT(scene); \
+		nullContext->Detach(scene, object); \
+		return RPR_SUCCESS; \
+	}
+
+NULL_RPR_ATTACH(rprSceneAttachShape, rpr_shape)
+NULL_RPR_DETACH(rprSceneDetachShape, rpr_shape)
+NULL_RPR_ATTACH(rprSceneAttachLight, rpr_light)
+NULL_RPR_DETACH(rprSceneDetachLight, rpr_light)
+NULL_RPR_ATTACH(rprSceneAttachCurve, rpr_curve)
+NULL_RPR_DETACH(rprSceneDetachCurve, rpr_curve)
+NULL_RPR_ATTACH(rprSceneAttachHeteroVolume, rpr_hetero_volume)
+NULL_RPR_DETACH(rprSceneDetachHeteroVolume, rpr_hetero_volume)
+
+rpr_status rprSceneSetCamera(rpr_scene scene, rpr_camera /*camera*/)
+{
+	NULL_RPR_SET(scene, 0, sizeof(rpr_camera));
+}
+
+rpr_status rprSceneSetBackgroundImage(rpr_scene scene, rpr_image /*image*/)
+{
+	NULL_RPR_SET(scene, 0, sizeof(rpr_image));
+}
+
+rpr_status rprSceneSetEnvironmentLight(rpr_scene scene, rpr_light /*light*/)
+{
+	NULL_RPR_SET(scene, 0, sizeof(rpr_light));
+}
+
+// material system
+
+rpr_status rprMaterialSystemCreateNode(rpr_material_system in_matsys, rpr_material_node_type in_type, rpr_material_node* out_node)
+{
+	NULL_RPR_CONTEXT(in_matsys);
+	return Create(nullContext->CreateMaterialNode(int(in_type)), out_node);
+}
+
+rpr_status rprMaterialNodeGetInfo(rpr_material_node in_node, rpr_material_node_info in_info, size_t in_size, void* in_data, size_t* out_size)
+{
+	NULL_RPR_CONTEXT(in_node);
+	nullContext->GetInfo(in_node, in_size);
+
+	if (in_info == RPR_MATERIAL_NODE_TYPE)
+		return Answer(rpr_material_node_type(NullContext::Get(in_node)->type), in_size, in_data, out_size);
+
+	return AnswerZeros(in_size, in_data, out_size);
+}
+
+rpr_status rprMaterialNodeGetInputInfo(rpr_material_node in_node, rpr_int /*in_input_idx*/, rpr_material_node_input_info /*in_info*/, size_t in_size, void* in_data, size_t* out_size)
+{
+	NULL_RPR_CONTEXT(in_node);
+	nullContext->GetInfo(in_node, in_size);
+	return AnswerZeros(in_size, in_data, out_size);
+}
+
+rpr_status rprMaterialNodeSetID(rpr_material_node in_node, rpr_uint /*id*/)
+{
+	NULL_RPR_SET(in_node, 0, sizeof(rpr_uint));
+}
+
+#define NULL_RPR_SET_INPUT(node, key, bytes) \
+	NULL_RPR_CONTEXT(node); \
+	nullContext->SetMaterialNodeInput(node, int(key), bytes); \
+	return RPR_SUCCESS
+
+rpr_status rprMaterialNodeSetInputFByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_float /*in_value_x*/, rpr_float /*in_value_y*/, rpr_float /*in_value_z*/, rpr_float /*in_value_w*/)
+{
+	NULL_RPR_SET_INPUT(in_node, in_input, 4 * sizeof(rpr_float));
+}
+
+rpr_status rprMaterialNodeSetInputUByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_uint /*in_value*/)
+{
+	NULL_RPR_SET_INPUT(in_node, in_input, sizeof(rpr_uint));
+}
+
+rpr_status rprMaterialNodeSetInputNByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_material_node /*in_input_node*/)
+{
+	NULL_RPR_SET_INPUT(in_node, in_input, sizeof(rpr_material_node));
+}
+
+rpr_status rprMaterialNodeSetInputImageDataByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_image /*image*/)
+{
+	NULL_RPR_SET_INPUT(in_node, in_input, sizeof(rpr_image));
+}
+
+rpr_status rprMaterialNodeSetInputBufferDataByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_buffer /*buffer*/)
+{
+	NULL_RPR_SET_INPUT(in_node, in_input, sizeof(rpr_buffer));
+}
+
+// post effects
+
+rpr_status rprPostEffectSetParameter1u(rpr_post_effect effect, rpr_char const* /*name*/, rpr_uint /*x*/)
+{
+	NULL_RPR_SET(effect, 0, sizeof(rpr_uint));
+}
+
+rpr_status rprPostEffectSetParameter1f(rpr_post_effect effect, rpr_char const* /*name*/, rpr_float /*x*/)
+{
+	NULL_RPR_SET(effect, 0, sizeof(rpr_float));
+}
+
+// glTF export
+
+rpr_status rprGLTF_AddExtraLightParameter(rpr_light light, const rpr_char* /*parameterName*/, int /*value*/)
+{
+	NULL_RPR_CONTEXT(light);
+	return RPR_SUCCESS;
+}
+
+}
+
+// FireRenderError.cpp shows Maya dialogs, a headless run reports failures by status and exception only
+
+bool checkStatus(rpr_int status, const MString /*message*/, bool /*showDialog*/)
+{
+	return status == RPR_SUCCESS;
+}
+
+void checkStatusThrow(rpr_int status, const MString message)
+{
+	if (status != RPR_SUCCESS)
+		throw FireRenderException(status, message);
+}
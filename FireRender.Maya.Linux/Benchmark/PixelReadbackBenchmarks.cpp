@@ -0,0 +1,207 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "Context/PixelReadback.h"
+#include "HalfFloat.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	const unsigned int FrameWidth = 3840;
+	const unsigned int FrameHeight = 2160;
+
+	// Region of a production render, rows counted from the bottom as in RenderRegion
+	const unsigned int RegionLeft = 400;
+	const unsigned int RegionTop = 1999;
+	const unsigned int RegionWidth = 3000;
+	const unsigned int RegionHeight = 1800;
+
+	// zeros, normals, the largest half, the smallest normal and denormal half
+	const float ExactHalves[] = { 0.0f, -0.0f, 1.0f, -2.5f, 0.5f, 65504.0f, 6.1035156e-05f, 5.9604645e-08f };
+
+	struct Pixel
+	{
+		float r, g, b, a;
+	};
+
+	// FireRenderContext::copyPixels before the fused kernel
+	void CopyPixels(Pixel* dest, const Pixel* source, unsigned int sourceWidth, unsigned int sourceHeight)
+	{
+		for (unsigned int y = 0; y < RegionHeight; y++)
+		{
+			unsigned int sourceIndex = (sourceHeight - (RegionTop - y) - 1) * sourceWidth + RegionLeft;
+			std::memcpy(&dest[y * RegionWidth], &source[sourceIndex], sizeof(Pixel) * RegionWidth);
+		}
+	}
+
+	// Crop of color and opacity, opacity to alpha, then the render view flip as separate passes
+	void MultiPass(const std::vector<Pixel>& color, const std::vector<Pixel>& opacity,
+		std::vector<Pixel>& cropped, std::vector<Pixel>& opacityCropped, std::vector<Pixel>& flipped)
+	{
+		CopyPixels(opacityCropped.data(), opacity.data(), FrameWidth, FrameHeight);
+		CopyPixels(cropped.data(), color.data(), FrameWidth, FrameHeight);
+
+		for (size_t i = 0; i < cropped.size(); i++)
+			cropped[i].a = opacityCropped[i].r;
+
+		for (unsigned int y = 0; y < RegionHeight; y++)
+			std::copy(&cropped[y * RegionWidth], &cropped[(y + 1) * RegionWidth], &flipped[(RegionHeight - y - 1) * RegionWidth]);
+	}
+
+	PixelReadback::Request MakeRequest(const std::vector<Pixel>& color, const std::vector<Pixel>& opacity, void* destination,
+		PixelReadback::OutputType outputType = PixelReadback::OutputType::Float)
+	{
+		PixelReadback::Request request;
+		request.source = &color[0].r;
+		request.sourceWidth = FrameWidth;
+		request.sourceHeight = FrameHeight;
+		request.opacity = &opacity[0].r;
+		request.left = RegionLeft;
+		request.top = RegionTop;
+		request.width = RegionWidth;
+		request.height = RegionHeight;
+		request.flipRows = true;
+		request.destination = destination;
+		request.outputType = outputType;
+
+		return request;
+	}
+
+	std::vector<Pixel> MakePixels(uint32_t seed)
+	{
+		std::vector<float> image = BenchmarkScenes::MakeImage(FrameWidth, FrameHeight, 4, seed);
+		std::vector<Pixel> pixels(size_t(FrameWidth) * FrameHeight);
+		std::memcpy(pixels.data(), image.data(), image.size() * sizeof(float));
+
+		return pixels;
+	}
+}
+
+BENCHMARK("PixelReadback/multiPass", [](Benchmark::State& state)
+{
+	std::vector<Pixel> color = MakePixels(21);
+	std::vector<Pixel> opacity = MakePixels(22);
+
+	std::vector<Pixel> cropped(RegionWidth * RegionHeight);
+	std::vector<Pixel> opacityCropped(RegionWidth * RegionHeight);
+	std::vector<Pixel> flipped(RegionWidth * RegionHeight);
+
+	state.Start();
+	MultiPass(color, opacity, cropped, opacityCropped, flipped);
+	state.Stop();
+
+	state.SetCounter("MPixels", RegionWidth * RegionHeight / 1e6);
+});
+
+BENCHMARK("PixelReadback/fused", [](Benchmark::State& state)
+{
+	std::vector<Pixel> color = MakePixels(21);
+	std::vector<Pixel> opacity = MakePixels(22);
+
+	std::vector<Pixel> result(RegionWidth * RegionHeight);
+
+	state.Start();
+	PixelReadback::Read(MakeRequest(color, opacity, result.data()));
+	state.Stop();
+
+	state.SetCounter("MPixels", RegionWidth * RegionHeight / 1e6);
+});
+
+BENCHMARK("PixelReadback/fusedHalf", [](Benchmark::State& state)
+{
+	std::vector<Pixel> color = MakePixels(21);
+	std::vector<Pixel> opacity = MakePixels(22);
+
+	std::vector<uint16_t> result(size_t(RegionWidth) * RegionHeight * 4);
+
+	state.Start();
+	PixelReadback::Read(MakeRequest(color, opacity, result.data(), PixelReadback::OutputType::Half));
+	state.Stop();
+
+	state.SetCounter("MPixels", RegionWidth * RegionHeight / 1e6);
+});
+
+TEST("PixelReadback/fusedMatchesMultiPass", [](Benchmark::State& state)
+{
+	std::vector<Pixel> color = MakePixels(21);
+	std::vector<Pixel> opacity = MakePixels(22);
+
+	std::vector<Pixel> result(RegionWidth * RegionHeight);
+	CHECK(PixelReadback::Read(MakeRequest(color, opacity, result.data())));
+
+	std::vector<Pixel> cropped(RegionWidth * RegionHeight);
+	std::vector<Pixel> opacityCropped(RegionWidth * RegionHeight);
+	std::vector<Pixel> flipped(RegionWidth * RegionHeight);
+	MultiPass(color, opacity, cropped, opacityCropped, flipped);
+
+	// bit for bit
+	CHECK(std::memcmp(result.data(), flipped.data(), result.size() * sizeof(Pixel)) == 0);
+});
+
+TEST("PixelReadback/halfMatchesMultiPass", [](Benchmark::State& state)
+{
+	std::vector<Pixel> color = MakePixels(21);
+	std::vector<Pixel> opacity = MakePixels(22);
+
+	std::vector<uint16_t> result(size_t(RegionWidth) * RegionHeight * 4);
+	CHECK(PixelReadback::Read(MakeRequest(color, opacity, result.data(), PixelReadback::OutputType::Half)));
+
+	std::vector<Pixel> cropped(RegionWidth * RegionHeight);
+	std::vector<Pixel> opacityCropped(RegionWidth * RegionHeight);
+	std::vector<Pixel> flipped(RegionWidth * RegionHeight);
+	MultiPass(color, opacity, cropped, opacityCropped, flipped);
+
+	// within the half precision rounding of the float chain
+	const float* expected = &flipped[0].r;
+	size_t outOfTolerance = 0;
+
+	for (size_t i = 0; i < result.size(); i++)
+	{
+		float difference = std::fabs(HalfFloat::ToFloat(result[i]) - expected[i]);
+		outOfTolerance += difference > std::fabs(expected[i]) * (1.0f / 2048.0f) + 1e-7f;
+	}
+
+	CHECK(outOfTolerance == 0);
+
+	// values representable as half survive the round trip exactly
+	for (float value : ExactHalves)
+		CHECK(HalfFloat::ToFloat(HalfFloat::FromFloat(value)) == value);
+
+	CHECK(HalfFloat::FromFloat(1e6f) == 0x7c00);
+	CHECK(HalfFloat::FromFloat(1.0f + 1.0f / 4096.0f) == HalfFloat::FromFloat(1.0f));	// ties to even
+});
+
+TEST("PixelReadback/inPlaceOnlyAsFloat", [](Benchmark::State& state)
+{
+	std::vector<float> frame(4 * 16 * 8, 0.25f);
+
+	PixelReadback::Request request;
+	request.source = frame.data();
+	request.sourceWidth = 16;
+	request.sourceHeight = 8;
+	request.top = 7;
+	request.width = 16;
+	request.height = 8;
+	request.destination = frame.data();
+
+	CHECK(PixelReadback::Read(request));
+
+	// half pixels would overwrite source pixels before they are read
+	request.outputType = PixelReadback::OutputType::Half;
+	CHECK(!PixelReadback::Read(request));
+});
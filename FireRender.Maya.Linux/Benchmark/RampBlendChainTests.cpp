@@ -0,0 +1,242 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+
+#include "MayaStandardNodesSupport/RampBlendChain.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	/** Recording stand-in for the RPR node creation of the ramp converter.
+		Nodes are kept in a list and can be evaluated for a ramp lookup value:
+		blends behave as RPR blend nodes with the weight clamped to [0, 1],
+		buffers pick the element the clamped lookup scaled to the last element points to. */
+	class RecordingBuilder
+	{
+	public:
+		typedef int Value;
+
+		enum Kind
+		{
+			InputNode,
+			BlendNode,
+			BufferNode
+		};
+
+		struct Node
+		{
+			Kind kind;
+			size_t entryIndex;
+			int a;
+			int b;
+			std::vector<float> values;
+		};
+
+		explicit RecordingBuilder(const std::vector<RampBlendChain::Entry>& entries) : m_entries(entries) {}
+
+		Value Input(size_t entryIndex)
+		{
+			return Add(Node{ InputNode, entryIndex, -1, -1, std::vector<float>() });
+		}
+
+		Value Blend(const Value& a, const Value& b)
+		{
+			return Add(Node{ BlendNode, 0, a, b, std::vector<float>() });
+		}
+
+		Value Baked(const std::vector<float>& values)
+		{
+			return Add(Node{ BufferNode, 0, -1, -1, values });
+		}
+
+		size_t Count(Kind kind) const
+		{
+			return size_t(std::count_if(m_nodes.begin(), m_nodes.end(), [kind](const Node& node) { return node.kind == kind; }));
+		}
+
+		void Evaluate(Value value, float lookup, float* rgba) const
+		{
+			const Node& node = m_nodes[value];
+			float weight = std::min(std::max(lookup, 0.0f), 1.0f);
+
+			if (node.kind == InputNode)
+			{
+				// connected entries stand in with their colour
+				for (int c = 0; c < 3; c++)
+					rgba[c] = m_entries[node.entryIndex].color[c];
+
+				rgba[3] = 0.0f;
+			}
+			else if (node.kind == BlendNode)
+			{
+				float a[4];
+				float b[4];
+				Evaluate(node.a, lookup, a);
+				Evaluate(node.b, lookup, b);
+
+				for (int c = 0; c < 4; c++)
+					rgba[c] = a[c] * (1.0f - weight) + b[c] * weight;
+			}
+			else
+			{
+				size_t element = size_t(std::lround(weight * (RampBlendChain::BufferSize - 1)));
+
+				for (int c = 0; c < 4; c++)
+					rgba[c] = node.values[4 * element + c];
+			}
+		}
+
+	private:
+		Value Add(const Node& node)
+		{
+			m_nodes.push_back(node);
+			return Value(m_nodes.size() - 1);
+		}
+
+		const std::vector<RampBlendChain::Entry>& m_entries;
+		std::vector<Node> m_nodes;
+	};
+
+	// Chain the converter created before baking: a blend node per entry after the first
+	void EvaluateBlendNodes(const std::vector<RampBlendChain::Entry>& entries, size_t count, float lookup, float* rgba)
+	{
+		if (count == 1)
+		{
+			for (int c = 0; c < 3; c++)
+				rgba[c] = entries[0].color[c];
+
+			rgba[3] = 0.0f;
+			return;
+		}
+
+		float weight = std::min(std::max(lookup, 0.0f), 1.0f);
+		float rest[4];
+		EvaluateBlendNodes(entries, count - 1, lookup, rest);
+
+		for (int c = 0; c < 3; c++)
+			rgba[c] = entries[count - 1].color[c] * (1.0f - weight) + rest[c] * weight;
+
+		rgba[3] = rest[3] * weight;
+	}
+
+	std::vector<RampBlendChain::Entry> MakeEntries(size_t count, const std::vector<size_t>& connected)
+	{
+		std::vector<RampBlendChain::Entry> entries(count);
+
+		for (size_t idx = 0; idx < count; idx++)
+		{
+			entries[idx].color[0] = 0.1f * float(idx);
+			entries[idx].color[1] = 1.0f - 0.07f * float(idx);
+			entries[idx].color[2] = float(idx % 3) / 3.0f;
+		}
+
+		for (size_t idx : connected)
+			entries[idx].isConstant = false;
+
+		return entries;
+	}
+
+	// Lookups at every buffer element, outside of [0, 1] and at the corner of a circular ramp
+	std::vector<float> MakeLookups()
+	{
+		std::vector<float> lookups;
+
+		for (unsigned int idx = 0; idx < RampBlendChain::BufferSize; idx++)
+			lookups.push_back((1.0f / (RampBlendChain::BufferSize - 1)) * idx);
+
+		lookups.push_back(-0.5f);
+		lookups.push_back(1.2f);
+		lookups.push_back(std::sqrt(2.0f));
+
+		return lookups;
+	}
+
+	size_t CountValueMismatches(const RecordingBuilder& builder, RecordingBuilder::Value root, const std::vector<RampBlendChain::Entry>& entries)
+	{
+		size_t mismatches = 0;
+
+		for (float lookup : MakeLookups())
+		{
+			float built[4];
+			float expected[4];
+			builder.Evaluate(root, lookup, built);
+			EvaluateBlendNodes(entries, entries.size(), lookup, expected);
+
+			if (!std::equal(built, built + 4, expected))
+				mismatches++;
+		}
+
+		return mismatches;
+	}
+}
+
+TEST("RampBlendChain/constantInnerEndIsBaked", [](Benchmark::State& state)
+{
+	// node connected to the last of 9 entries, the 8 before it are constant
+	std::vector<size_t> connected(1, 8);
+	std::vector<RampBlendChain::Entry> entries = MakeEntries(9, connected);
+
+	RecordingBuilder builder(entries);
+	RecordingBuilder::Value root = RampBlendChain::Build(builder, entries, entries.size());
+
+	CHECK(builder.Count(RecordingBuilder::BufferNode) == 1);
+	CHECK(builder.Count(RecordingBuilder::BlendNode) == 1);
+	CHECK(builder.Count(RecordingBuilder::InputNode) == 1);
+	CHECK(CountValueMismatches(builder, root, entries) == 0);
+});
+
+TEST("RampBlendChain/connectedInnerEndIsNotBaked", [](Benchmark::State& state)
+{
+	std::vector<size_t> connected;
+	connected.push_back(0);
+	connected.push_back(4);
+	std::vector<RampBlendChain::Entry> entries = MakeEntries(6, connected);
+
+	RecordingBuilder builder(entries);
+	RecordingBuilder::Value root = RampBlendChain::Build(builder, entries, entries.size());
+
+	CHECK(builder.Count(RecordingBuilder::BufferNode) == 0);
+	CHECK(builder.Count(RecordingBuilder::BlendNode) == 5);
+	CHECK(builder.Count(RecordingBuilder::InputNode) == 6);
+	CHECK(CountValueMismatches(builder, root, entries) == 0);
+});
+
+TEST("RampBlendChain/shortConstantChainIsNotBaked", [](Benchmark::State& state)
+{
+	std::vector<size_t> connected(1, 2);
+	std::vector<RampBlendChain::Entry> entries = MakeEntries(3, connected);
+
+	RecordingBuilder builder(entries);
+	RecordingBuilder::Value root = RampBlendChain::Build(builder, entries, entries.size());
+
+	CHECK(builder.Count(RecordingBuilder::BufferNode) == 0);
+	CHECK(builder.Count(RecordingBuilder::BlendNode) == 2);
+	CHECK(CountValueMismatches(builder, root, entries) == 0);
+});
+
+TEST("RampBlendChain/bakedAlphaIsZero", [](Benchmark::State& state)
+{
+	std::vector<RampBlendChain::Entry> entries = MakeEntries(5, std::vector<size_t>());
+	std::vector<float> values = RampBlendChain::Bake(entries, entries.size());
+
+	CHECK(values.size() == 4 * RampBlendChain::BufferSize);
+
+	bool alphaIsZero = true;
+	for (unsigned int idx = 0; idx < RampBlendChain::BufferSize; idx++)
+		alphaIsZero = alphaIsZero && values[4 * idx + 3] == 0.0f;
+
+	CHECK(alphaIsZero);
+});
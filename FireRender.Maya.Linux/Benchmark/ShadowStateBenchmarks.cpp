@@ -0,0 +1,242 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+#include "NullContext.h"
+
+#include "frWrap.h"
+
+#include <vector>
+
+namespace
+{
+	const int MaterialCount = 2000;
+	const int FloatInputs = 12;
+	const int NodeInputs = 4;
+	const int ShapeCount = 2000;
+	const int Resyncs = 4;
+
+	struct SyncScene
+	{
+		std::vector<frw::ValueNode> materials;
+		std::vector<frw::ValueNode> textures;
+		std::vector<frw::Shape> shapes;
+	};
+
+	SyncScene CreateScene(frw::Context& context, frw::MaterialSystem& materialSystem)
+	{
+		SyncScene scene;
+
+		for (int i = 0; i < MaterialCount; i++)
+		{
+			scene.materials.emplace_back(materialSystem, frw::ValueTypeArithmetic);
+			scene.textures.emplace_back(materialSystem, frw::ValueTypeArithmetic);
+		}
+
+		for (int i = 0; i < ShapeCount; i++)
+			scene.shapes.push_back(context.CreateMesh(nullptr, 0, 0, nullptr, 0, 0, nullptr, 0, 0, nullptr, 0, nullptr, 0, nullptr, 0, nullptr, 0));
+
+		return scene;
+	}
+
+	// Full translation of every material and shape, as done on each refresh of a dirty node;
+	// changedEvery > 0 changes one value of every n-th object
+	void Sync(SyncScene& scene, int pass, int changedEvery)
+	{
+		BenchmarkScenes::Random random(1);
+
+		for (size_t i = 0; i < scene.materials.size(); i++)
+		{
+			bool changed = changedEvery > 0 && i % changedEvery == 0;
+
+			for (int key = 0; key < FloatInputs; key++)
+			{
+				float value = random.NextFloat();
+				if (changed && key == 0)
+					value += float(pass);
+
+				scene.materials[i].SetValue(key, frw::Value(value, value, value, 1.0f));
+			}
+
+			for (int key = 0; key < NodeInputs; key++)
+				scene.materials[i].SetValue(FloatInputs + key, scene.textures[(i + key) % scene.textures.size()]);
+		}
+
+		for (size_t i = 0; i < scene.shapes.size(); i++)
+		{
+			float matrix[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+			matrix[12] = random.NextFloat();
+
+			if (changedEvery > 0 && i % changedEvery == 0)
+				matrix[13] = float(pass);
+
+			scene.shapes[i].SetTransform(matrix);
+		}
+	}
+
+	size_t ForwardedSetterCalls(const NullContext& nullContext)
+	{
+		return nullContext.Calls("rprMaterialNodeSetInputFByKey") + nullContext.Calls("rprMaterialNodeSetInputNByKey") +
+			nullContext.Calls("rprShapeSetTransform");
+	}
+
+	void RunResyncs(Benchmark::State& state, bool shadowEnabled, int changedEvery)
+	{
+		frw::ShadowState::SetEnabled(shadowEnabled);
+		frw::ShadowState::ResetCounters();
+
+		NullContext nullContext;
+		frw::Context context(nullContext.GetHandle(), false);
+		frw::MaterialSystem materialSystem(context);
+		SyncScene scene = CreateScene(context, materialSystem);
+
+		Sync(scene, 0, changedEvery);
+		nullContext.Reset();
+
+		state.Start();
+		for (int pass = 1; pass <= Resyncs; pass++)
+			Sync(scene, pass, changedEvery);
+		state.Stop();
+
+		state.SetCounter("forwarded", double(ForwardedSetterCalls(nullContext)));
+		state.SetCounter("skipped", double(frw::ShadowState::GetSkippedCount()));
+
+		frw::ShadowState::SetEnabled(true);
+	}
+
+	// Gives a wrapper another RPR handle the way frw objects created empty get theirs
+	class RehandledShape : public frw::Shape
+	{
+	public:
+		explicit RehandledShape(const frw::Shape& shape) : frw::Shape(shape) {}
+
+		void Rehandle(void* handle) { m->Attach(handle); }
+	};
+
+	const float Identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+	const float Moved[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 1, 2, 3, 1 };
+}
+
+BENCHMARK("ShadowState/unchanged/disabled", [](Benchmark::State& state)
+{
+	RunResyncs(state, false, 0);
+});
+
+BENCHMARK("ShadowState/unchanged/enabled", [](Benchmark::State& state)
+{
+	RunResyncs(state, true, 0);
+});
+
+BENCHMARK("ShadowState/onePercentChanged/enabled", [](Benchmark::State& state)
+{
+	RunResyncs(state, true, 100);
+});
+
+TEST("ShadowState/redundantSettersSkipped", [](Benchmark::State& state)
+{
+	frw::ShadowState::SetEnabled(true);
+	frw::ShadowState::ResetCounters();
+
+	NullContext nullContext;
+	frw::Context context(nullContext.GetHandle(), false);
+	frw::MaterialSystem materialSystem(context);
+
+	frw::Shape shape = context.CreateMesh(nullptr, 0, 0, nullptr, 0, 0, nullptr, 0, 0, nullptr, 0, nullptr, 0, nullptr, 0, nullptr, 0);
+	frw::ValueNode material(materialSystem, frw::ValueTypeArithmetic);
+	frw::ValueNode texture(materialSystem, frw::ValueTypeArithmetic);
+
+	shape.SetTransform(Identity);
+	shape.SetTransform(Identity);
+	CHECK(nullContext.Calls("rprShapeSetTransform") == 1);
+
+	shape.SetTransform(Moved);
+	CHECK(nullContext.Calls("rprShapeSetTransform") == 2);
+
+	material.SetValue(RPR_MATERIAL_INPUT_COLOR0, frw::Value(1, 2, 3, 4));
+	material.SetValue(RPR_MATERIAL_INPUT_COLOR0, frw::Value(1, 2, 3, 4));
+	CHECK(nullContext.Calls("rprMaterialNodeSetInputFByKey") == 1);
+
+	material.SetValue(RPR_MATERIAL_INPUT_COLOR1, texture);
+	material.SetValue(RPR_MATERIAL_INPUT_COLOR1, texture);
+	CHECK(nullContext.Calls("rprMaterialNodeSetInputNByKey") == 1);
+
+	// another value type on the same input is sent, even with the same bytes
+	material.SetValueInt(RPR_MATERIAL_INPUT_COLOR0, 0);
+	CHECK(nullContext.Calls("rprMaterialNodeSetInputUByKey") == 1);
+
+	CHECK(frw::ShadowState::GetSkippedCount() == 3);
+
+	// disabled, every call is forwarded
+	frw::ShadowState::SetEnabled(false);
+	shape.SetTransform(Moved);
+	material.SetValue(RPR_MATERIAL_INPUT_COLOR1, texture);
+	frw::ShadowState::SetEnabled(true);
+
+	CHECK(nullContext.Calls("rprShapeSetTransform") == 3);
+	CHECK(nullContext.Calls("rprMaterialNodeSetInputNByKey") == 2);
+	CHECK(frw::ShadowState::GetSkippedCount() == 3);
+});
+
+TEST("ShadowState/handleChangeClears", [](Benchmark::State& state)
+{
+	frw::ShadowState::SetEnabled(true);
+
+	NullContext nullContext;
+	frw::Context context(nullContext.GetHandle(), false);
+
+	RehandledShape shape(context.CreateMesh(nullptr, 0, 0, nullptr, 0, 0, nullptr, 0, 0, nullptr, 0, nullptr, 0, nullptr, 0, nullptr, 0));
+
+	shape.SetTransform(Identity);
+	shape.SetTransform(Identity);
+	CHECK(nullContext.Calls("rprShapeSetTransform") == 1);
+
+	// the new RPR object has none of the values of the old one
+	shape.Rehandle(nullContext.CreateShape(0, 1, 0));
+	CHECK(nullContext.Calls("rprObjectDelete") == 1);
+
+	shape.SetTransform(Identity);
+	CHECK(nullContext.Calls("rprShapeSetTransform") == 2);
+
+	shape.SetTransform(Identity);
+	CHECK(nullContext.Calls("rprShapeSetTransform") == 2);
+});
+
+TEST("ShadowState/forgetResends", [](Benchmark::State& state)
+{
+	frw::ShadowState::SetEnabled(true);
+
+	NullContext nullContext;
+	frw::Context context(nullContext.GetHandle(), false);
+
+	frw::Shape shape = context.CreateMesh(nullptr, 0, 0, nullptr, 0, 0, nullptr, 0, 0, nullptr, 0, nullptr, 0, nullptr, 0, nullptr, 0);
+
+	shape.SetVisibilityFlag(RPR_SHAPE_VISIBILITY_SHADOW, false);
+	shape.SetVisibilityFlag(RPR_SHAPE_VISIBILITY_SHADOW, false);
+	CHECK(nullContext.Calls("rprShapeSetVisibilityFlag") == 1);
+
+	// overall visibility overrides the flags, so they are forgotten and sent again
+	shape.SetVisibility(true);
+	CHECK(nullContext.Calls("rprShapeSetVisibility") == 1);
+
+	shape.SetVisibilityFlag(RPR_SHAPE_VISIBILITY_SHADOW, false);
+	CHECK(nullContext.Calls("rprShapeSetVisibilityFlag") == 2);
+
+	// a transposed matrix forgets the other layout
+	shape.SetTransform(Identity, false);
+	shape.SetTransform(Identity, true);
+	shape.SetTransform(Identity, false);
+	CHECK(nullContext.Calls("rprShapeSetTransform") == 3);
+
+	shape.SetTransform(Identity, false);
+	CHECK(nullContext.Calls("rprShapeSetTransform") == 3);
+});
@@ -0,0 +1,182 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "SharedPayload.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// 100 frames of an animated scene: static meshes and images, animated transforms,
+	// one deforming mesh and a few animated material parameters
+	const int FrameCount = 100;
+	const int StaticMeshCount = 40;
+	const int StaticMeshBytes = 256 * 1024;
+	const int ImageBytes = 2 * 1024 * 1024;
+	const int AnimatedObjectCount = 40;
+	const int DeformingMeshBytes = 192 * 1024;
+
+	void AppendRandom(std::string& out, size_t size, uint32_t seed)
+	{
+		BenchmarkScenes::Random random(seed);
+
+		for (size_t i = 0; i < size; i += 4)
+		{
+			uint32_t value = random.Next();
+
+			for (size_t b = 0; b < 4 && i + b < size; b++)
+				out.push_back(char(value >> (8 * b)));
+		}
+	}
+
+	// Stand-in for rprsExport: objects are written one after another in a fixed order,
+	// with animated values between static blocks. Mesh and image data is divided by scale.
+	std::string SerializeFrame(int frame, int scale = 1)
+	{
+		std::string out;
+		out.reserve(16 * 1024 * 1024 / scale);
+
+		out += "RPRS";
+		AppendRandom(out, ImageBytes / scale, 7);
+
+		for (int i = 0; i < StaticMeshCount; i++)
+		{
+			out += "mesh" + std::to_string(i);
+			AppendRandom(out, StaticMeshBytes / scale, 100 + i);
+
+			// transform and a material parameter next to the mesh data
+			if (i < AnimatedObjectCount)
+			{
+				out += "xform";
+				AppendRandom(out, 64, uint32_t(frame * 1000 + i + 1));
+			}
+		}
+
+		out += "deforming";
+		AppendRandom(out, DeformingMeshBytes / scale, uint32_t(frame + 1));
+
+		out += "camera";
+		AppendRandom(out, 128, uint32_t(frame + 50000));
+
+		return out;
+	}
+
+	// The round trip test writes and unpacks every frame, its scene is smaller
+	const int TestScale = 4;
+
+	// frames over stored bytes of the test scene, the data is seeded so it is always 4.14
+	const double MinDedupRatio = 4.0;
+
+	std::filesystem::path ManifestPath(const std::filesystem::path& directory, int frame)
+	{
+		return directory / ("scene" + std::to_string(frame) + "." + SharedPayload::ManifestExtension);
+	}
+}
+
+BENCHMARK("SharedPayload/sequenceWrite", [](Benchmark::State& state)
+{
+	std::stringstream payload;
+	SharedPayload::Writer writer(payload, "scene.rprpayload");
+	bool written = true;
+
+	// frames are serialized one at a time as in the export command, only storing is timed
+	for (int frame = 0; frame < FrameCount; frame++)
+	{
+		std::istringstream frameStream(SerializeFrame(frame));
+		std::ostringstream manifest;
+
+		state.Start();
+		written = writer.WriteFrame(frameStream, manifest) && written;
+		state.Stop();
+	}
+
+	const SharedPayload::Stats& stats = writer.GetStats();
+
+	state.SetCounter("written", written ? 1.0 : 0.0);
+	state.SetCounter("framesMB", stats.frameBytes / (1024.0 * 1024.0));
+	state.SetCounter("storedMB", (stats.payloadBytes + stats.manifestBytes) / (1024.0 * 1024.0));
+	state.SetCounter("dedupRatio", stats.Ratio());
+});
+
+TEST("SharedPayload/sequenceRoundTrip", [](Benchmark::State& state)
+{
+	// files as the export command writes them: one payload and a manifest per frame
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "rpr_shared_payload_test";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+
+	std::filesystem::path payloadPath = directory / "scene.rprpayload";
+	bool written = true;
+	SharedPayload::Stats stats;
+	std::vector<SharedPayload::ChunkId> hashes;
+
+	{
+		std::ofstream payload(payloadPath, std::ios::binary | std::ios::trunc);
+		SharedPayload::Writer writer(payload, payloadPath.filename().u8string());
+
+		for (int frame = 0; frame < FrameCount; frame++)
+		{
+			std::string bytes = SerializeFrame(frame, TestScale);
+			hashes.push_back(SharedPayload::Hash(bytes.data(), bytes.size()));
+
+			std::istringstream frameStream(bytes);
+			std::ofstream manifest(ManifestPath(directory, frame), std::ios::binary | std::ios::trunc);
+
+			written = writer.WriteFrame(frameStream, manifest) && written;
+		}
+
+		stats = writer.GetStats();
+	}
+
+	CHECK(written);
+
+	// every frame unpacks into a file identical to the exported one, compared by its 128 bit hash
+	int restored = 0;
+	std::ifstream payload(payloadPath, std::ios::binary);
+
+	for (int frame = 0; frame < FrameCount; frame++)
+	{
+		std::filesystem::path framePath = directory / ("scene" + std::to_string(frame) + ".rpr");
+
+		{
+			std::ifstream manifest(ManifestPath(directory, frame), std::ios::binary);
+			std::ofstream frameFile(framePath, std::ios::binary | std::ios::trunc);
+
+			payload.clear();
+			if (!SharedPayload::ReadFrame(manifest, payload, frameFile))
+				continue;
+		}
+
+		std::ifstream frameFile(framePath, std::ios::binary);
+		std::string bytes((std::istreambuf_iterator<char>(frameFile)), std::istreambuf_iterator<char>());
+
+		SharedPayload::ChunkId hash = SharedPayload::Hash(bytes.data(), bytes.size());
+		restored += hash.hash1 == hashes[frame].hash1 && hash.hash2 == hashes[frame].hash2;
+	}
+
+	CHECK(restored == FrameCount);
+
+	// the static 3 MB are stored once, per frame only the deforming mesh and the chunks around transforms
+	CHECK(stats.frameBytes == SerializeFrame(0, TestScale).size() * FrameCount);
+	CHECK(stats.Ratio() > MinDedupRatio);
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+});
@@ -0,0 +1,304 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "Translators/TessellationCache.h"
+
+#include <memory>
+#include <string>
+
+namespace
+{
+	const int SmoothedMeshCount = 64;
+	const int MeshResolution = 32;
+	const int SmoothLevel = 2;
+
+	// IPR session: every pass dirties all shapes, as a shading group or transform edit does,
+	// every fourth pass also moves points of one shape
+	const int EditPasses = 40;
+	const int GeometryEditInterval = 4;
+
+	struct SmoothedMesh : public TessellationCache::Payload
+	{
+		std::vector<float> points;
+		std::vector<int> polygonConnects;
+
+		virtual size_t Size() const override { return points.size() * sizeof(float) + polygonConnects.size() * sizeof(int); }
+	};
+
+	/** Stands in for polySmooth: every quad is split 4^level times with bilinear interpolation,
+		then each new point is relaxed towards the centre of its quad. */
+	std::shared_ptr<SmoothedMesh> Smooth(const BenchmarkScenes::Mesh& mesh, int level)
+	{
+		auto result = std::make_shared<SmoothedMesh>();
+
+		const int side = 1 << level;
+		const float step = 1.0f / side;
+
+		result->points.reserve(size_t(mesh.numPolygons()) * (side + 1) * (side + 1) * 3);
+		result->polygonConnects.reserve(size_t(mesh.numPolygons()) * side * side * 4);
+
+		for (int face = 0; face < mesh.numPolygons(); face++)
+		{
+			const float* corners[4];
+			for (int c = 0; c < 4; c++)
+				corners[c] = &mesh.points[3 * mesh.polygonConnects[4 * face + c]];
+
+			float centre[3];
+			for (int k = 0; k < 3; k++)
+				centre[k] = 0.25f * (corners[0][k] + corners[1][k] + corners[2][k] + corners[3][k]);
+
+			int base = int(result->points.size() / 3);
+
+			for (int y = 0; y <= side; y++)
+			{
+				for (int x = 0; x <= side; x++)
+				{
+					float s = x * step;
+					float t = y * step;
+
+					for (int k = 0; k < 3; k++)
+					{
+						float p = (1 - s) * (1 - t) * corners[0][k] + s * (1 - t) * corners[1][k] + s * t * corners[2][k] + (1 - s) * t * corners[3][k];
+						result->points.push_back(p + 0.1f * (centre[k] - p));
+					}
+				}
+			}
+
+			for (int y = 0; y < side; y++)
+			{
+				for (int x = 0; x < side; x++)
+				{
+					int i0 = base + y * (side + 1) + x;
+
+					result->polygonConnects.push_back(i0);
+					result->polygonConnects.push_back(i0 + 1);
+					result->polygonConnects.push_back(i0 + side + 2);
+					result->polygonConnects.push_back(i0 + side + 1);
+				}
+			}
+		}
+
+		return result;
+	}
+
+	// Same inputs as MeshTranslator::GetTessellationKey hashes for the geometry of a smoothed mesh
+	TessellationCache::Key MakeGeometryKey(const BenchmarkScenes::Mesh& mesh)
+	{
+		TessellationCache::KeyBuilder builder;
+
+		builder.Add(mesh.points.data(), mesh.points.size() * sizeof(float));
+		builder.Add(mesh.normals.data(), mesh.normals.size() * sizeof(float));
+		builder.Add(mesh.polygonCounts.data(), mesh.polygonCounts.size() * sizeof(int));
+		builder.Add(mesh.polygonConnects.data(), mesh.polygonConnects.size() * sizeof(int));
+		builder.Add(mesh.normalIds.data(), mesh.normalIds.size() * sizeof(int));
+		builder.Add(mesh.u.data(), mesh.u.size() * sizeof(float));
+		builder.Add(mesh.v.data(), mesh.v.size() * sizeof(float));
+		builder.Add(mesh.uvIds.data(), mesh.uvIds.size() * sizeof(int));
+
+		return builder.Get();
+	}
+
+	TessellationCache::Key MakeKey(const TessellationCache::Key& geometryKey, int level)
+	{
+		TessellationCache::KeyBuilder builder;
+
+		builder.Add(std::string("smoothed"));
+		builder.Add("-dv " + std::to_string(level));
+		builder.Add(&geometryKey, sizeof(geometryKey));
+
+		return builder.Get();
+	}
+
+	// Runs the edit passes, returns the number of smoothing runs
+	size_t RunSession(BenchmarkScenes::Scene& scene, TessellationCache* cache, size_t& pointCount)
+	{
+		size_t smoothCount = 0;
+		pointCount = 0;
+
+		// shapes keep their geometry key until they are dirtied
+		std::vector<TessellationCache::Key> geometryKeys(scene.meshes.size());
+		std::vector<char> isGeometryKeyValid(scene.meshes.size(), 0);
+
+		for (int pass = 0; pass < EditPasses; pass++)
+		{
+			if (pass % GeometryEditInterval == GeometryEditInterval - 1)
+			{
+				size_t editedIndex = pass % scene.meshes.size();
+				scene.meshes[editedIndex].points[1] += 0.01f;
+				isGeometryKeyValid[editedIndex] = 0;
+			}
+
+			for (size_t meshIndex = 0; meshIndex < scene.meshes.size(); meshIndex++)
+			{
+				const BenchmarkScenes::Mesh& mesh = scene.meshes[meshIndex];
+
+				std::shared_ptr<const TessellationCache::Payload> smoothed;
+				TessellationCache::Key key;
+
+				if (cache)
+				{
+					if (!isGeometryKeyValid[meshIndex])
+					{
+						geometryKeys[meshIndex] = MakeGeometryKey(mesh);
+						isGeometryKeyValid[meshIndex] = 1;
+					}
+
+					key = MakeKey(geometryKeys[meshIndex], SmoothLevel);
+					smoothed = cache->Find(key);
+				}
+
+				if (!smoothed)
+				{
+					smoothed = Smooth(mesh, SmoothLevel);
+					smoothCount++;
+
+					if (cache)
+						cache->Insert(key, smoothed);
+				}
+
+				pointCount += static_cast<const SmoothedMesh&>(*smoothed).points.size() / 3;
+			}
+		}
+
+		return smoothCount;
+	}
+
+	struct SizedPayload : public ContentCache::Payload
+	{
+		explicit SizedPayload(size_t size) : size(size) {}
+
+		size_t size;
+
+		virtual size_t Size() const override { return size; }
+	};
+
+	ContentCache::Key MakeIndexKey(int index)
+	{
+		ContentCache::KeyBuilder builder;
+		builder.AddValue(index);
+
+		return builder.Get();
+	}
+}
+
+TEST("ContentCache/leastRecentlyUsedEviction", [](Benchmark::State& state)
+{
+	ContentCache cache(300);
+
+	for (int i = 0; i < 3; i++)
+		cache.Insert(MakeIndexKey(i), std::make_shared<SizedPayload>(100));
+
+	// touching the oldest entry makes the second one the next to go
+	CHECK(cache.Find(MakeIndexKey(0)) != nullptr);
+
+	cache.Insert(MakeIndexKey(3), std::make_shared<SizedPayload>(100));
+	CHECK(cache.Find(MakeIndexKey(1)) == nullptr);
+	CHECK(cache.Find(MakeIndexKey(0)) != nullptr);
+	CHECK(cache.Find(MakeIndexKey(2)) != nullptr);
+	CHECK(cache.Find(MakeIndexKey(3)) != nullptr);
+
+	ContentCache::Stats stats = cache.GetStats();
+	CHECK(stats.entryCount == 3);
+	CHECK(stats.size == 300);
+	CHECK(stats.hits == 4);
+	CHECK(stats.misses == 1);
+
+	// replacing an entry accounts for the new size only
+	cache.Insert(MakeIndexKey(3), std::make_shared<SizedPayload>(50));
+	CHECK(cache.GetStats().size == 250);
+
+	// payloads over the budget are not kept
+	cache.Insert(MakeIndexKey(4), std::make_shared<SizedPayload>(301));
+	CHECK(cache.Find(MakeIndexKey(4)) == nullptr);
+	CHECK(cache.GetStats().entryCount == 3);
+
+	// shrinking keeps the most recently used entries
+	cache.SetBudget(100);
+	CHECK(cache.GetStats().size == 50);
+	CHECK(cache.Find(MakeIndexKey(3)) != nullptr);
+	CHECK(cache.Find(MakeIndexKey(0)) == nullptr);
+
+	cache.Clear();
+	CHECK(cache.GetStats().entryCount == 0);
+	CHECK(cache.GetStats().size == 0);
+});
+
+TEST("ContentCache/keysFollowOrder", [](Benchmark::State& state)
+{
+	ContentCache::KeyBuilder ab;
+	ab.AddValue(1);
+	ab.AddValue(2);
+
+	ContentCache::KeyBuilder ba;
+	ba.AddValue(2);
+	ba.AddValue(1);
+
+	ContentCache::KeyBuilder ab2;
+	ab2.AddValue(1);
+	ab2.AddValue(2);
+
+	CHECK(ab.Get() == ab2.Get());
+	CHECK(!(ab.Get() == ba.Get()));
+});
+
+BENCHMARK("TessellationCache/uncached", [](Benchmark::State& state)
+{
+	BenchmarkScenes::Scene scene = BenchmarkScenes::MakeScene(SmoothedMeshCount, MeshResolution, 1, 7);
+	size_t pointCount = 0;
+
+	state.Start();
+	size_t smoothCount = RunSession(scene, nullptr, pointCount);
+	state.Stop();
+
+	state.SetCounter("smoothRuns", double(smoothCount));
+	state.SetCounter("points", double(pointCount));
+});
+
+BENCHMARK("TessellationCache/cached", [](Benchmark::State& state)
+{
+	BenchmarkScenes::Scene scene = BenchmarkScenes::MakeScene(SmoothedMeshCount, MeshResolution, 1, 7);
+	TessellationCache cache;
+	size_t pointCount = 0;
+
+	state.Start();
+	size_t smoothCount = RunSession(scene, &cache, pointCount);
+	state.Stop();
+
+	TessellationCache::Stats stats = cache.GetStats();
+
+	state.SetCounter("smoothRuns", double(smoothCount));
+	state.SetCounter("points", double(pointCount));
+	state.SetCounter("hits", double(stats.hits));
+	state.SetCounter("cachedMB", double(stats.size >> 20));
+});
+
+BENCHMARK("TessellationCache/evictions", [](Benchmark::State& state)
+{
+	// budget of about a quarter of the scene: shapes are visited in turn, which is the worst case
+	// for least recently used eviction, every shape is smoothed again but memory stays within the budget
+	BenchmarkScenes::Scene scene = BenchmarkScenes::MakeScene(SmoothedMeshCount, MeshResolution, 1, 7);
+	TessellationCache cache(SmoothedMeshCount * size_t(MeshResolution * MeshResolution) * (16 * 4 + 25 * 12) / 4);
+	size_t pointCount = 0;
+
+	state.Start();
+	size_t smoothCount = RunSession(scene, &cache, pointCount);
+	state.Stop();
+
+	TessellationCache::Stats stats = cache.GetStats();
+
+	state.SetCounter("smoothRuns", double(smoothCount));
+	state.SetCounter("entries", double(stats.entryCount));
+	state.SetCounter("cachedMB", double(stats.size >> 20));
+});
@@ -0,0 +1,320 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "TextureDiskCache.h"
+
+#include <RadeonProRender.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+	// 4K RGBA texture, the payload is kept as uploaded to RPR
+	const unsigned int TextureSize = 4096;
+	const unsigned int Channels = 4;
+
+	struct CacheFixture
+	{
+		std::filesystem::path directory;
+		TextureDiskCache::Key key;
+		TextureDiskCache::ImageDesc desc;
+		std::vector<uint8_t> pixels;
+
+		CacheFixture()
+		{
+			directory = std::filesystem::temp_directory_path() / "rpr_texture_disk_cache_benchmark";
+			std::filesystem::remove_all(directory);
+			std::filesystem::create_directories(directory);
+
+			// stands in for the source file, only its time stamp and size go into the key
+			std::string source = (directory / "texture.png").string();
+			std::ofstream(source) << "texture";
+
+			TextureDiskCache::Instance().Configure(directory.string(), 1ull << 30);
+			TextureDiskCache::MakeKey(source, "sRGB", "mtexture", key);
+
+			std::vector<float> image = BenchmarkScenes::MakeImage(TextureSize, TextureSize, Channels, 39);
+			pixels.resize(image.size());
+
+			for (size_t i = 0; i < image.size(); i++)
+				pixels[i] = uint8_t(image[i] * 255.0f + 0.5f);
+
+			desc.width = TextureSize;
+			desc.height = TextureSize;
+			desc.channels = Channels;
+			desc.rowPitch = TextureSize * Channels;
+		}
+
+		~CacheFixture()
+		{
+			TextureDiskCache::Instance().Configure(std::string(), 0);
+
+			std::error_code error;
+			std::filesystem::remove_all(directory, error);
+		}
+	};
+}
+
+BENCHMARK("TextureDiskCache/store4K", [](Benchmark::State& state)
+{
+	CacheFixture fixture;
+
+	state.Start();
+	bool stored = TextureDiskCache::Instance().Store(fixture.key, fixture.desc, fixture.pixels.data());
+	state.Stop();
+
+	state.SetCounter("stored", stored ? 1.0 : 0.0);
+	state.SetCounter("MB", double(fixture.pixels.size()) / (1024.0 * 1024.0));
+});
+
+BENCHMARK("TextureDiskCache/load4K", [](Benchmark::State& state)
+{
+	CacheFixture fixture;
+	TextureDiskCache::Instance().Store(fixture.key, fixture.desc, fixture.pixels.data());
+
+	// the image is created from the mapping, which copies the pixels once
+	std::vector<uint8_t> uploaded(fixture.pixels.size());
+	bool loaded = false;
+
+	state.Start();
+	{
+		TextureDiskCache::Entry entry;
+		loaded = TextureDiskCache::Instance().Load(fixture.key, entry) && entry.PixelsSize() == uploaded.size();
+
+		if (loaded)
+			std::memcpy(uploaded.data(), entry.Pixels(), uploaded.size());
+	}
+	state.Stop();
+
+	state.SetCounter("loaded", loaded ? 1.0 : 0.0);
+	state.SetCounter("identical", loaded && uploaded == fixture.pixels ? 1.0 : 0.0);
+});
+
+BENCHMARK("TextureDiskCache/decodeStandIn4K", [](Benchmark::State& state)
+{
+	// what a miss costs without the file read: producing the pixels and converting them into the upload format
+	std::vector<float> image;
+	std::vector<uint8_t> converted;
+
+	state.Start();
+	image = BenchmarkScenes::MakeImage(TextureSize, TextureSize, Channels, 39);
+	converted.resize(image.size());
+
+	for (size_t i = 0; i < image.size(); i++)
+		converted[i] = uint8_t(image[i] * 255.0f + 0.5f);
+	state.Stop();
+
+	state.SetCounter("MB", double(converted.size()) / (1024.0 * 1024.0));
+});
+
+namespace
+{
+	// small entries in a fresh cache directory of the given size
+	struct SmallEntries
+	{
+		std::filesystem::path directory;
+		std::string source;
+		TextureDiskCache::ImageDesc desc;
+		std::vector<uint8_t> pixels;
+
+		explicit SmallEntries(unsigned long long maxBytes)
+		{
+			directory = std::filesystem::temp_directory_path() / "rpr_texture_disk_cache_trim";
+			std::filesystem::remove_all(directory);
+			std::filesystem::create_directories(directory);
+
+			source = (directory / "texture.png").string();
+			std::ofstream(source) << "texture";
+
+			TextureDiskCache::Instance().Configure(directory.string(), maxBytes);
+
+			desc.width = 64;
+			desc.height = 64;
+			desc.channels = Channels;
+			desc.rowPitch = desc.width * Channels;
+			pixels.assign(size_t(desc.rowPitch) * desc.height, 128);
+		}
+
+		~SmallEntries()
+		{
+			TextureDiskCache::Instance().Configure(std::string(), 0);
+
+			std::error_code error;
+			std::filesystem::remove_all(directory, error);
+		}
+
+		TextureDiskCache::Key Key(int index) const
+		{
+			TextureDiskCache::Key key;
+			TextureDiskCache::MakeKey(source, "sRGB", "level" + std::to_string(index), key);
+			return key;
+		}
+
+		unsigned long long EntryBytes(size_t& count) const
+		{
+			unsigned long long total = 0;
+			count = 0;
+
+			for (const auto& file : std::filesystem::directory_iterator(directory))
+			{
+				if (file.path().extension() == TextureDiskCache::Extension())
+				{
+					total += std::filesystem::file_size(file.path());
+					count++;
+				}
+			}
+
+			return total;
+		}
+	};
+}
+
+TEST("TextureDiskCache/storeKeepsSizeLimit", [](Benchmark::State& state)
+{
+	// room for three entries of 64x64 RGBA and their headers
+	SmallEntries entries(3 * (64 * 64 * Channels + 1024));
+
+	bool stored = true;
+	for (int index = 0; index < 10; index++)
+		stored = TextureDiskCache::Instance().Store(entries.Key(index), entries.desc, entries.pixels.data()) && stored;
+
+	CHECK(stored);
+
+	size_t count = 0;
+	unsigned long long bytes = entries.EntryBytes(count);
+
+	CHECK(count == 3);
+	CHECK(bytes <= 3 * (64 * 64 * Channels + 1024));
+
+	TextureDiskCache::Entry entry;
+	CHECK(TextureDiskCache::Instance().Load(entries.Key(9), entry));
+});
+
+BENCHMARK("TextureDiskCache/store1000Small", [](Benchmark::State& state)
+{
+	// stores within the size don't scan the directory, which grows with every entry
+	SmallEntries entries(1ull << 30);
+
+	std::vector<TextureDiskCache::Key> keys;
+	for (int index = 0; index < 1000; index++)
+		keys.push_back(entries.Key(index));
+
+	state.Start();
+	for (const TextureDiskCache::Key& key : keys)
+		TextureDiskCache::Instance().Store(key, entries.desc, entries.pixels.data());
+	state.Stop();
+
+	size_t count = 0;
+	entries.EntryBytes(count);
+	state.SetCounter("entries", double(count));
+});
+
+TEST("TextureDiskCache/payloadRoundTrip", [](Benchmark::State& state)
+{
+	SmallEntries entries(1ull << 30);
+
+	// half float RGB rows padded to 16 bytes, every byte distinct within a row
+	TextureDiskCache::ImageDesc desc;
+	desc.width = 37;
+	desc.height = 23;
+	desc.channels = 3;
+	desc.componentType = RPR_COMPONENT_TYPE_FLOAT16;
+	desc.rowPitch = (desc.width * desc.channels * 2 + 15) & ~15u;
+
+	std::vector<uint8_t> pixels(size_t(desc.rowPitch) * desc.height);
+	for (size_t i = 0; i < pixels.size(); i++)
+		pixels[i] = uint8_t(i * 7 + i / 251);
+
+	TextureDiskCache::Key key = entries.Key(0);
+	CHECK(TextureDiskCache::Instance().Store(key, desc, pixels.data()));
+
+	{
+		TextureDiskCache::Entry entry;
+		CHECK(TextureDiskCache::Instance().Load(key, entry));
+
+		CHECK(entry.Desc().width == desc.width);
+		CHECK(entry.Desc().height == desc.height);
+		CHECK(entry.Desc().channels == desc.channels);
+		CHECK(entry.Desc().componentType == desc.componentType);
+		CHECK(entry.Desc().rowPitch == desc.rowPitch);
+		CHECK(entry.PixelsSize() == pixels.size());
+		CHECK(entry.Pixels() != nullptr && std::memcmp(entry.Pixels(), pixels.data(), pixels.size()) == 0);
+	}
+
+	// another format of the same source is another entry
+	TextureDiskCache::Entry missing;
+	CHECK(!TextureDiskCache::Instance().Load(entries.Key(1), missing));
+	CHECK(missing.Pixels() == nullptr);
+});
+
+TEST("TextureDiskCache/keyFollowsSource", [](Benchmark::State& state)
+{
+	SmallEntries entries(1ull << 30);
+
+	TextureDiskCache::Key stored = entries.Key(0);
+	CHECK(TextureDiskCache::Instance().Store(stored, entries.desc, entries.pixels.data()));
+
+	// unchanged source, same entry
+	TextureDiskCache::Key same = entries.Key(0);
+	CHECK(same.ToString() == stored.ToString());
+
+	TextureDiskCache::Entry entry;
+	CHECK(TextureDiskCache::Instance().Load(same, entry));
+
+	// the source was saved again, size unchanged
+	std::filesystem::path source = entries.source;
+	std::filesystem::last_write_time(source, std::filesystem::last_write_time(source) + std::chrono::seconds(10));
+
+	TextureDiskCache::Key touched = entries.Key(0);
+	CHECK(touched.fileSize == stored.fileSize);
+	CHECK(touched.modificationTime != stored.modificationTime);
+	CHECK(TextureDiskCache::Instance().EntryPath(touched) != TextureDiskCache::Instance().EntryPath(stored));
+
+	TextureDiskCache::Entry touchedEntry;
+	CHECK(!TextureDiskCache::Instance().Load(touched, touchedEntry));
+
+	// the source was edited and got larger, time stamp restored
+	auto time = std::filesystem::last_write_time(source);
+	std::ofstream(source, std::ios::app) << " edited";
+	std::filesystem::last_write_time(source, time);
+
+	TextureDiskCache::Key resized = entries.Key(0);
+	CHECK(resized.modificationTime == touched.modificationTime);
+	CHECK(resized.fileSize != touched.fileSize);
+	CHECK(TextureDiskCache::Instance().EntryPath(resized) != TextureDiskCache::Instance().EntryPath(touched));
+
+	TextureDiskCache::Entry resizedEntry;
+	CHECK(!TextureDiskCache::Instance().Load(resized, resizedEntry));
+
+	// no key without a source
+	TextureDiskCache::Key none;
+	CHECK(!TextureDiskCache::MakeKey((entries.directory / "missing.png").string(), "sRGB", "level0", none));
+});
+
+TEST("TextureDiskCache/storedEntriesCount", [](Benchmark::State& state)
+{
+	SmallEntries entries(1ull << 30);
+
+	for (int index = 0; index < 100; index++)
+		CHECK(TextureDiskCache::Instance().Store(entries.Key(index), entries.desc, entries.pixels.data()));
+
+	size_t count = 0;
+	entries.EntryBytes(count);
+	CHECK(count == 100);
+});
@@ -0,0 +1,226 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "TextureResolution.h"
+
+#include <cmath>
+#include <cstdint>
+
+namespace
+{
+	// 8K RGBA texture in a 1920x1080 viewport with the default 2K cap
+	const unsigned int TextureSize = 8192;
+	const unsigned int Channels = 4;
+
+	std::vector<uint8_t> MakeTexture()
+	{
+		std::vector<float> image = BenchmarkScenes::MakeImage(TextureSize, TextureSize, Channels, 21);
+		std::vector<uint8_t> texture(image.size());
+
+		for (size_t i = 0; i < image.size(); i++)
+			texture[i] = uint8_t(image[i] * 255.0f + 0.5f);
+
+		return texture;
+	}
+
+	double Mean(const uint8_t* data, size_t count)
+	{
+		double sum = 0.0;
+		for (size_t i = 0; i < count; i++)
+			sum += data[i];
+
+		return sum / count;
+	}
+}
+
+BENCHMARK("TextureResolution/downsample8Kto2K", [](Benchmark::State& state)
+{
+	std::vector<uint8_t> texture = MakeTexture();
+
+	TextureResolution::Policy policy;
+	policy.interactive = true;
+	policy.screenCoverage = 1920;
+
+	unsigned int limit = TextureResolution::SelectLimit(policy);
+	unsigned int level = TextureResolution::SelectLevel(TextureSize, TextureSize, limit, limit);
+
+	unsigned int width = 0;
+	unsigned int height = 0;
+	TextureResolution::LevelSize(TextureSize, TextureSize, level, width, height);
+
+	TextureResolution::ImageData source;
+	source.data = texture.data();
+	source.width = TextureSize;
+	source.height = TextureSize;
+	source.channels = Channels;
+
+	std::vector<uint8_t> reduced(size_t(width) * height * Channels);
+
+	state.Start();
+	TextureResolution::Downsample(source, width, height, reduced.data());
+	state.Stop();
+
+	state.SetCounter("level", level);
+	state.SetCounter("fullMB", double(texture.size()) / (1024.0 * 1024.0));
+	state.SetCounter("uploadMB", double(reduced.size()) / (1024.0 * 1024.0));
+	state.SetCounter("meanError*1e3", std::fabs(Mean(texture.data(), texture.size()) - Mean(reduced.data(), reduced.size())) * 1e3);
+});
+
+BENCHMARK("TextureResolution/zoomedInFullResolution", [](Benchmark::State& state)
+{
+	// 85 mm lens on the same viewport needs more than twice the cap
+	TextureResolution::Policy policy;
+	policy.interactive = true;
+	policy.screenCoverage = unsigned(1920 * TextureResolution::Magnification(2.0 * std::atan(18.0 / 85.0)));
+
+	state.Start();
+	unsigned int limit = TextureResolution::SelectLimit(policy);
+	state.Stop();
+
+	state.SetCounter("coverage", policy.screenCoverage);
+	state.SetCounter("limit", limit);
+});
+
+TEST("TextureResolution/rowDownsamplerMatchesDownsample", [](Benchmark::State& state)
+{
+	// odd sizes give footprints shared by two destination rows and columns
+	const unsigned int sourceWidth = 301;
+	const unsigned int sourceHeight = 257;
+	std::vector<float> image = BenchmarkScenes::MakeImage(sourceWidth, sourceHeight, 3, 5);
+
+	TextureResolution::ImageData source;
+	source.data = image.data();
+	source.width = sourceWidth;
+	source.height = sourceHeight;
+	source.channels = 3;
+	source.type = TextureResolution::ComponentType::Float;
+
+	for (unsigned int level = 1; level <= 3; level++)
+	{
+		unsigned int width = 0;
+		unsigned int height = 0;
+		TextureResolution::LevelSize(sourceWidth + level, sourceHeight - level, level, width, height);
+
+		std::vector<float> expected(size_t(width) * height * 3);
+		CHECK(TextureResolution::Downsample(source, width, height, expected.data()));
+
+		std::vector<float> streamed(expected.size(), -1.0f);
+		TextureResolution::RowDownsampler downsampler(sourceWidth, sourceHeight, 3, TextureResolution::ComponentType::Float, width, height, streamed.data());
+		CHECK(downsampler.IsValid());
+
+		for (unsigned int y = 0; y < sourceHeight; y++)
+		{
+			CHECK(!downsampler.IsComplete());
+			downsampler.AddRow(&image[size_t(y) * sourceWidth * 3]);
+		}
+
+		CHECK(downsampler.IsComplete());
+		CHECK(streamed == expected);
+	}
+
+	TextureResolution::RowDownsampler upscale(4, 4, 3, TextureResolution::ComponentType::Float, 8, 8, image.data());
+	CHECK(!upscale.IsValid());
+});
+
+TEST("TextureResolution/limitFollowsCoverage", [](Benchmark::State& state)
+{
+	TextureResolution::Policy policy;
+	policy.interactive = true;
+
+	// the smallest power of 2 covering the screen, between 256 and the cap
+	policy.screenCoverage = 100;
+	CHECK(TextureResolution::SelectLimit(policy) == 256);
+
+	policy.screenCoverage = 300;
+	CHECK(TextureResolution::SelectLimit(policy) == 512);
+
+	policy.screenCoverage = 1920;
+	CHECK(TextureResolution::SelectLimit(policy) == 2048);
+
+	// capped up to twice the cap, full resolution past it
+	policy.screenCoverage = 4096;
+	CHECK(TextureResolution::SelectLimit(policy) == 2048);
+
+	policy.screenCoverage = 4097;
+	CHECK(TextureResolution::SelectLimit(policy) == 0);
+
+	// unknown coverage gives the cap, final renders and a zero cap full resolution
+	policy.screenCoverage = 0;
+	CHECK(TextureResolution::SelectLimit(policy) == 2048);
+
+	policy.screenCoverage = 300;
+	policy.interactive = false;
+	CHECK(TextureResolution::SelectLimit(policy) == 0);
+
+	policy.interactive = true;
+	policy.maxSize = 0;
+	CHECK(TextureResolution::SelectLimit(policy) == 0);
+
+	// an 8K texture under the 2K limit is loaded at level 2, non square ones by the longer side
+	CHECK(TextureResolution::SelectLevel(TextureSize, TextureSize, 2048, 2048) == 2);
+	CHECK(TextureResolution::SelectLevel(TextureSize, 1024, 2048, 2048) == 2);
+	CHECK(TextureResolution::SelectLevel(1000, 1000, 2048, 2048) == 0);
+	CHECK(TextureResolution::SelectLevel(TextureSize, TextureSize, 0, 0) == 0);
+});
+
+TEST("TextureResolution/coverageFollowsCamera", [](Benchmark::State& state)
+{
+	const double referenceFieldOfView = 2.0 * std::atan(18.0 / 35.0);
+	const double telephotoFieldOfView = 2.0 * std::atan(18.0 / 85.0);
+
+	CHECK(std::fabs(TextureResolution::Magnification(referenceFieldOfView) - 1.0) < 1e-9);
+	CHECK(TextureResolution::Magnification(telephotoFieldOfView) > 2.0);
+
+	// bounds of radius 1 fill the view at distance 1 / tan(fov / 2), twice as large at half the distance
+	const double framed = 1.0 / std::tan(telephotoFieldOfView / 2.0);
+	CHECK(std::fabs(TextureResolution::Magnification(telephotoFieldOfView, 1.0, framed) - 1.0) < 1e-9);
+	CHECK(std::fabs(TextureResolution::Magnification(telephotoFieldOfView, 1.0, framed / 2.0) - 2.0) < 1e-9);
+
+	// inside the bounding sphere the magnification stops growing
+	CHECK(TextureResolution::Magnification(referenceFieldOfView, 1.0, 0.5) == TextureResolution::Magnification(referenceFieldOfView, 1.0, 1.0));
+
+	// unknown bounds fall back to the lens alone
+	CHECK(TextureResolution::Magnification(telephotoFieldOfView, 0.0, 10.0) == TextureResolution::Magnification(telephotoFieldOfView));
+
+	// dollying in on the same lens raises the limit of a 1920 pixel wide view
+	TextureResolution::Policy policy;
+	policy.interactive = true;
+
+	unsigned int previous = 1;
+	bool increasing = true;
+
+	for (double distance : { 40.0, 20.0, 10.0, 4.0, 2.0 })
+	{
+		policy.screenCoverage = unsigned(1920 * TextureResolution::Magnification(referenceFieldOfView, 1.0, distance));
+		unsigned int limit = TextureResolution::SelectLimit(policy);
+
+		// full resolution is the largest limit
+		unsigned int size = limit == 0 ? ~0u : limit;
+		increasing = increasing && size >= previous;
+		previous = size;
+	}
+
+	CHECK(increasing);
+
+	policy.screenCoverage = unsigned(1920 * TextureResolution::Magnification(referenceFieldOfView, 1.0, 40.0));
+	CHECK(TextureResolution::SelectLimit(policy) == 256);
+
+	policy.screenCoverage = unsigned(1920 * TextureResolution::Magnification(referenceFieldOfView, 1.0, 2.0));
+	CHECK(TextureResolution::SelectLimit(policy) == 2048);
+
+	// the telephoto lens close up needs full resolution
+	policy.screenCoverage = unsigned(1920 * TextureResolution::Magnification(telephotoFieldOfView, 1.0, 2.0));
+	CHECK(TextureResolution::SelectLimit(policy) == 0);
+});
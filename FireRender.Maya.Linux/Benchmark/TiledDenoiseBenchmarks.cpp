@@ -0,0 +1,257 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "Context/TiledDenoise.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	const unsigned int FrameWidth = 1920;
+	const unsigned int FrameHeight = 1080;
+	const unsigned int Overlap = 32;
+
+	// color, normal, depth and albedo, as the LWR denoiser gets
+	const int InputCount = 4;
+
+	// Stand-in for the denoiser: box blur of the first input, radius within the discarded overlap margin.
+	// Samples past the image edge repeat the edge pixels, the same as padded tiles do, so a seam-free
+	// tiled result equals the whole frame result with and without padding.
+	const int BlurRadius = int(Overlap / 4);
+
+	// Largest difference between tiled and whole frame blur; both sum the same pixels in the same order
+	const float BlurTolerance = 1e-6f;
+
+	bool BoxBlur(const TiledDenoise::Tile& tile, const std::vector<float*>& inputs, float* output)
+	{
+		const int width = int(tile.width);
+		const int height = int(tile.height);
+		const float* source = inputs[0];
+		const float weight = 1.0f / (2 * BlurRadius + 1);
+
+		std::vector<float> rows(size_t(width) * height * 4);
+
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					float sum = 0.0f;
+					for (int i = x - BlurRadius; i <= x + BlurRadius; i++)
+						sum += source[(size_t(y) * width + std::min(std::max(i, 0), width - 1)) * 4 + c];
+
+					rows[(size_t(y) * width + x) * 4 + c] = sum * weight;
+				}
+			}
+		}
+
+		for (int y = 0; y < height; y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					float sum = 0.0f;
+					for (int i = y - BlurRadius; i <= y + BlurRadius; i++)
+						sum += rows[(size_t(std::min(std::max(i, 0), height - 1)) * width + x) * 4 + c];
+
+					output[(size_t(y) * width + x) * 4 + c] = sum * weight;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	bool Identity(const TiledDenoise::Tile& tile, const std::vector<float*>& inputs, float* output)
+	{
+		std::copy(inputs[0], inputs[0] + size_t(tile.width) * tile.height * 4, output);
+		return true;
+	}
+
+	float MaxDifference(const std::vector<float>& a, const std::vector<float>& b)
+	{
+		float maxDifference = 0.0f;
+
+		for (size_t i = 0; i < a.size(); i++)
+			maxDifference = std::max(maxDifference, std::fabs(a[i] - b[i]));
+
+		return maxDifference;
+	}
+
+	void Run(Benchmark::State& state, const TiledDenoise::TileFilter& filter, size_t memoryBudget, unsigned int concurrency)
+	{
+		std::vector<std::vector<float>> images;
+		std::vector<const float*> inputs;
+
+		for (int i = 0; i < InputCount; i++)
+			images.push_back(BenchmarkScenes::MakeImage(FrameWidth, FrameHeight, 4, 11 + i));
+
+		for (const std::vector<float>& image : images)
+			inputs.push_back(image.data());
+
+		// working memory of a tile: inputs and output
+		const size_t bytesPerPixel = (InputCount + 1) * 4 * sizeof(float);
+
+		TiledDenoise::Layout layout = TiledDenoise::MakeLayout(FrameWidth, FrameHeight, Overlap, bytesPerPixel, memoryBudget, concurrency);
+
+		std::vector<float> output(size_t(FrameWidth) * FrameHeight * 4);
+
+		state.Start();
+		bool result = TiledDenoise::Denoise(layout, inputs, filter, output.data(), concurrency);
+		state.Stop();
+
+		TiledDenoise::Layout whole = TiledDenoise::MakeLayout(FrameWidth, FrameHeight, Overlap, bytesPerPixel, 0);
+
+		std::vector<float> reference(output.size());
+		TiledDenoise::Denoise(whole, inputs, filter, reference.data());
+
+		size_t peakTilePixels = 0;
+		for (const TiledDenoise::Tile& tile : layout.tiles)
+			peakTilePixels = std::max(peakTilePixels, size_t(tile.width) * tile.height);
+
+		state.SetCounter("ok", result ? 1.0 : 0.0);
+		state.SetCounter("tiles", double(layout.tiles.size()));
+		state.SetCounter("peakMB", double(peakTilePixels * bytesPerPixel * concurrency) / (1024.0 * 1024.0));
+		state.SetCounter("frameMB", double(size_t(FrameWidth) * FrameHeight * bytesPerPixel) / (1024.0 * 1024.0));
+		state.SetCounter("maxDiff*1e6", MaxDifference(output, reference) * 1e6);
+	}
+}
+
+BENCHMARK("TiledDenoise/identity/wholeFrame", [](Benchmark::State& state)
+{
+	Run(state, Identity, 0, 1);
+});
+
+BENCHMARK("TiledDenoise/identity/tiles16MB", [](Benchmark::State& state)
+{
+	Run(state, Identity, 16u << 20, 1);
+});
+
+BENCHMARK("TiledDenoise/boxBlur/wholeFrame", [](Benchmark::State& state)
+{
+	Run(state, BoxBlur, 0, 1);
+});
+
+BENCHMARK("TiledDenoise/boxBlur/tiles16MB", [](Benchmark::State& state)
+{
+	Run(state, BoxBlur, 16u << 20, 1);
+});
+
+BENCHMARK("TiledDenoise/boxBlur/tiles16MBx4", [](Benchmark::State& state)
+{
+	Run(state, BoxBlur, 16u << 20, 4);
+});
+
+namespace
+{
+	const unsigned int SmallFrameWidth = 300;
+	const unsigned int SmallFrameHeight = 200;
+
+	// bytes of a 100 x 100 pixel tile with one input
+	const size_t SmallTileBytes = 2 * 4 * sizeof(float) * 100 * 100;
+
+	// Blur of the first input through the layout against the blur of the whole frame
+	float BlurDifference(const std::vector<const float*>& inputs, const TiledDenoise::Layout& layout, unsigned int concurrency)
+	{
+		TiledDenoise::Layout whole = TiledDenoise::MakeLayout(SmallFrameWidth, SmallFrameHeight, Overlap, 0, 0);
+
+		std::vector<float> reference(size_t(SmallFrameWidth) * SmallFrameHeight * 4);
+		TiledDenoise::Denoise(whole, inputs, BoxBlur, reference.data());
+
+		std::vector<float> output(reference.size());
+
+		if (!TiledDenoise::Denoise(layout, inputs, BoxBlur, output.data(), concurrency))
+			return 1.0f;
+
+		return MaxDifference(output, reference);
+	}
+}
+
+TEST("TiledDenoise/boxBlurTilesMatchWholeFrame", [](Benchmark::State& state)
+{
+	std::vector<std::vector<float>> images;
+	std::vector<const float*> inputs;
+
+	for (int i = 0; i < InputCount; i++)
+		images.push_back(BenchmarkScenes::MakeImage(SmallFrameWidth, SmallFrameHeight, 4, 41 + i));
+
+	for (const std::vector<float>& image : images)
+		inputs.push_back(image.data());
+
+	TiledDenoise::Layout layout = TiledDenoise::MakeLayout(SmallFrameWidth, SmallFrameHeight, Overlap, SmallTileBytes / (100 * 100), SmallTileBytes);
+	CHECK(layout.IsTiled());
+
+	CHECK(BlurDifference(inputs, layout, 1) < BlurTolerance);
+	CHECK(BlurDifference(inputs, layout, 3) < BlurTolerance);
+
+	// padded tiles blur the repeated edge pixels like the whole frame blur does past its edge
+	layout.padTiles = true;
+	CHECK(BlurDifference(inputs, layout, 1) < BlurTolerance);
+	CHECK(BlurDifference(inputs, layout, 3) < BlurTolerance);
+
+	// a wider blur than the overlap can hide leaves seams, which the comparison has to see
+	TiledDenoise::Layout narrow = TiledDenoise::MakeLayout(SmallFrameWidth, SmallFrameHeight, BlurRadius / 2, SmallTileBytes / (100 * 100), SmallTileBytes);
+	CHECK(BlurDifference(inputs, narrow, 1) > BlurTolerance);
+});
+
+TEST("TiledDenoise/paddedTiles", [](Benchmark::State& state)
+{
+	std::vector<float> image = BenchmarkScenes::MakeImage(SmallFrameWidth, SmallFrameHeight, 4, 37);
+	std::vector<const float*> inputs(1, image.data());
+
+	// tiles of 100 x 100 pixels, the last column and row are shorter
+	const size_t bytesPerPixel = 2 * 4 * sizeof(float);
+	TiledDenoise::Layout layout = TiledDenoise::MakeLayout(SmallFrameWidth, SmallFrameHeight, Overlap, bytesPerPixel, bytesPerPixel * 100 * 100);
+	layout.padTiles = true;
+
+	CHECK(layout.tileWidth == 100 && layout.tileHeight == 100);
+	CHECK(layout.tiles.back().width < layout.tileWidth && layout.tiles.back().height < layout.tileHeight);
+
+	// every tile has the full size, pixels past the frame edge repeat the last column and row
+	int wrongSizes = 0;
+	int wrongPixels = 0;
+
+	auto filter = [&](const TiledDenoise::Tile& tile, const std::vector<float*>& tileInputs, float* output) -> bool
+	{
+		wrongSizes += tile.width != layout.tileWidth || tile.height != layout.tileHeight;
+
+		for (unsigned int y = 0; y < tile.height; y++)
+		{
+			for (unsigned int x = 0; x < tile.width; x++)
+			{
+				size_t frameX = std::min(tile.x + x, SmallFrameWidth - 1);
+				size_t frameY = std::min(tile.y + y, SmallFrameHeight - 1);
+				const float* expected = image.data() + (frameY * SmallFrameWidth + frameX) * 4;
+				const float* actual = tileInputs[0] + (size_t(y) * tile.width + x) * 4;
+
+				wrongPixels += !std::equal(expected, expected + 4, actual);
+			}
+		}
+
+		return Identity(tile, tileInputs, output);
+	};
+
+	std::vector<float> output(image.size());
+	CHECK(TiledDenoise::Denoise(layout, inputs, filter, output.data()));
+
+	CHECK(wrongSizes == 0);
+	CHECK(wrongPixels == 0);
+
+	// cropped tiles blend back into the frame
+	CHECK(MaxDifference(output, image) < 1e-5f);
+});
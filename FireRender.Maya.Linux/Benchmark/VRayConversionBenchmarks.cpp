@@ -0,0 +1,276 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "ObjectHandleMap.h"
+#include "VRayConversionPlan.h"
+
+#include <algorithm>
+
+namespace
+{
+	// an asset library: shading engines with VRay materials sharing a pool of file textures
+	const int LibraryMaterials = 50000;
+	const int LibraryTextures = 2000;
+
+	// Mock of the network the command indexes: every material has a shading engine, some with members
+	struct MockLibrary
+	{
+		VRayConversion::Index index;
+
+		int unsupported = 0;
+		int textureInputs = 0;
+	};
+
+	MockLibrary MakeLibrary(int materialCount, int textureCount, uint32_t seed)
+	{
+		BenchmarkScenes::Random random(seed);
+		MockLibrary library;
+		VRayConversion::Index& index = library.index;
+
+		VRayConversion::NodeId members = index.AddNode(std::string(), std::string());
+
+		std::vector<VRayConversion::NodeId> textures;
+		for (int i = 0; i < textureCount; i++)
+			textures.push_back(index.AddNode("file" + std::to_string(i), "file"));
+
+		VRayConversion::NodeId animCurve = index.AddNode("animCurveTU1", "animCurveTU");
+
+		for (int i = 0; i < materialCount; i++)
+		{
+			std::string name = "vrayMtl" + std::to_string(i);
+			uint32_t kind = random.Next() % 20;
+
+			VRayConversion::NodeId material;
+
+			if (kind == 0)
+			{
+				material = index.AddNode(name, "VRayBumpMtl");
+				library.unsupported++;
+			}
+			else
+			{
+				material = index.AddNode(name, kind == 1 ? "VRayCarPaintMtl" : "VRayMtl");
+
+				// car paint base colour feeds both diffuse and reflection
+				const char* colorAttribute = kind == 1 ? "bcol" : "dc";
+				index.AddConnection(textures[random.Next() % textureCount], "oc", material, colorAttribute);
+				library.textureInputs += kind == 1 ? 2 : 1;
+
+				if (random.Next() % 4 == 0)
+					index.AddConnection(animCurve, "o", material, "rlca");
+			}
+
+			VRayConversion::NodeId surface = material;
+
+			// wrapped materials are converted under the name of the wrapper
+			if (kind == 2)
+			{
+				surface = index.AddNode(name + "Wrapper", "VRayMtlWrapper");
+				index.AddConnection(material, "oc", surface, "bm");
+			}
+
+			VRayConversion::NodeId shadingEngine = index.AddNode(name + "SG", "shadingEngine");
+			index.AddConnection(surface, "oc", shadingEngine, "ss");
+
+			if (random.Next() % 2 == 0)
+				index.AddConnection(members, std::string(), shadingEngine, "dsm");
+		}
+
+		return library;
+	}
+}
+
+BENCHMARK("VRayConversion/planLibrary", [](Benchmark::State& state)
+{
+	MockLibrary library = MakeLibrary(LibraryMaterials, LibraryTextures, 48);
+
+	state.Start();
+	VRayConversion::Plan plan = VRayConversion::MakePlan(library.index);
+	state.Stop();
+
+	int converted = LibraryMaterials - library.unsupported;
+
+	// each texture output is looked up once, each shader connects or copies every rule
+	CHECK(int(plan.shaders.size()) == converted);
+	CHECK(int(plan.assignments.size()) == converted);
+	CHECK(int(plan.unsupported) == library.unsupported);
+	CHECK(int(plan.upstream.size()) <= LibraryTextures);
+	CHECK(int(plan.upstream.size() + plan.memoizedUpstream) == library.textureInputs);
+	CHECK(int(plan.deletions.size()) == converted);
+
+	// animated attributes are read as values, never connected to the curve
+	int curveConnections = 0;
+	for (const VRayConversion::Shader& shader : plan.shaders)
+	{
+		for (const VRayConversion::Operation& operation : shader.operations)
+		{
+			if (operation.kind == VRayConversion::Operation::Kind::Connect &&
+				library.index.Type(plan.upstream[operation.upstream].node) != "file")
+			{
+				curveConnections++;
+			}
+		}
+	}
+
+	CHECK(curveConnections == 0);
+
+	state.SetCounter("shaders", double(plan.shaders.size()));
+	state.SetCounter("upstream", double(plan.upstream.size()));
+	state.SetCounter("memoizedUpstream", double(plan.memoizedUpstream));
+});
+
+TEST("VRayConversion/mockGraph", [](Benchmark::State& state)
+{
+	using VRayConversion::Operation;
+
+	VRayConversion::Index index;
+	VRayConversion::NodeId members = index.AddNode(std::string(), std::string());
+	VRayConversion::NodeId texture = index.AddNode("file1", "file");
+
+	// one material on two shading engines, once directly and once through a wrapper,
+	// a material of another namespace with the same short name, and a shading engine
+	// with a material that is not converted
+	VRayConversion::NodeId material = index.AddNode("brick", "VRayMtl");
+	VRayConversion::NodeId otherMaterial = index.AddNode("brick", "VRayMtl");
+	VRayConversion::NodeId wrapper = index.AddNode("brickWrapper", "VRayMtlWrapper");
+	VRayConversion::NodeId bump = index.AddNode("bump", "VRayBumpMtl");
+	VRayConversion::NodeId lambert = index.AddNode("lambert1", "lambert");
+
+	CHECK(otherMaterial != material);
+
+	index.AddConnection(texture, "oc", material, "dc");
+	index.AddConnection(texture, "oc", material, "rlc");
+	index.AddConnection(texture, "oc", otherMaterial, "dc");
+	index.AddConnection(material, "oc", wrapper, "bm");
+	index.AddConnection(bump, "oc", wrapper, "rlca");
+
+	std::vector<VRayConversion::NodeId> surfaces;
+	surfaces.push_back(material);
+	surfaces.push_back(material);
+	surfaces.push_back(wrapper);
+	surfaces.push_back(bump);
+	surfaces.push_back(lambert);
+	surfaces.push_back(otherMaterial);
+
+	std::vector<VRayConversion::NodeId> shadingEngines;
+	for (size_t i = 0; i < surfaces.size(); i++)
+	{
+		VRayConversion::NodeId shadingEngine = index.AddNode("SG" + std::to_string(i), "shadingEngine");
+		index.AddConnection(surfaces[i], "oc", shadingEngine, "ss");
+		index.AddConnection(members, std::string(), shadingEngine, "dsm");
+
+		shadingEngines.push_back(shadingEngine);
+	}
+
+	VRayConversion::Plan plan = VRayConversion::MakePlan(index);
+
+	// both materials named brick are converted, each named after itself
+	CHECK(plan.shaders.size() == 2);
+	CHECK(plan.memoizedShaders == 2);
+	CHECK(plan.unsupported == 1);
+
+	if (plan.shaders.size() == 2)
+	{
+		CHECK(plan.shaders[0].source == material);
+		CHECK(plan.shaders[0].type == "RPRUberMaterial");
+		CHECK(plan.shaders[0].name == "brick");
+		CHECK(plan.shaders[1].source == otherMaterial);
+		CHECK(plan.shaders[1].name == "brick");
+
+		// the texture is connected, attributes without inputs are read from the material
+		int connected = 0;
+		for (const Operation& operation : plan.shaders[0].operations)
+		{
+			if (operation.destinationAttribute == "diffuseColor" || operation.destinationAttribute == "reflectColor")
+			{
+				CHECK(operation.kind == Operation::Kind::Connect);
+				connected++;
+			}
+			else if (operation.destinationAttribute == "reflectIOR")
+			{
+				CHECK(operation.kind == Operation::Kind::FromSource);
+				CHECK(operation.sourceAttribute == "rlca");
+			}
+			else if (operation.destinationAttribute == "reflections")
+			{
+				CHECK(operation.kind == Operation::Kind::SetBool);
+				CHECK(operation.value == 1);
+			}
+		}
+
+		CHECK(connected == 2);
+	}
+
+	// the texture output is listed once for its four connections, reflection colour also feeds the coat
+	CHECK(plan.upstream.size() == 1);
+	CHECK(plan.memoizedUpstream == 3);
+
+	if (plan.upstream.size() == 1)
+	{
+		CHECK(plan.upstream[0].node == texture);
+		CHECK(plan.upstream[0].attribute == "oc");
+	}
+
+	// the wrapper is replaced on its shading engine, unsupported materials are left
+	CHECK(plan.assignments.size() == 4);
+
+	if (plan.assignments.size() == 4)
+	{
+		CHECK(plan.assignments[0].shadingEngine == shadingEngines[0] && plan.assignments[0].shader == 0);
+		CHECK(plan.assignments[1].shadingEngine == shadingEngines[1] && plan.assignments[1].shader == 0);
+		CHECK(plan.assignments[2].shadingEngine == shadingEngines[2] && plan.assignments[2].shader == 0);
+		CHECK(plan.assignments[2].material == wrapper && plan.assignments[2].materialAttribute == "oc");
+		CHECK(plan.assignments[3].shadingEngine == shadingEngines[5] && plan.assignments[3].shader == 1);
+	}
+
+	// all converted VRay materials lose their shading engines, the bump material keeps one
+	CHECK(plan.deletions.size() == 3);
+	CHECK(std::count(plan.deletions.begin(), plan.deletions.end(), material) == 1);
+	CHECK(std::count(plan.deletions.begin(), plan.deletions.end(), otherMaterial) == 1);
+	CHECK(std::count(plan.deletions.begin(), plan.deletions.end(), wrapper) == 1);
+});
+
+namespace
+{
+	// handle of the mock graph, distinct nodes may share a hash code like MObjectHandle
+	struct MockHandle
+	{
+		int node;
+
+		unsigned int hashCode() const { return unsigned(node % 4); }
+		bool operator==(const MockHandle& other) const { return node == other.node; }
+	};
+
+	typedef ObjectHandleMap<MockHandle, VRayConversion::NodeId> MockNodeIds;
+}
+
+TEST("VRayConversion/objectHandleMapCollisions", [](Benchmark::State& state)
+{
+	MockNodeIds ids;
+
+	for (int node = 0; node < 16; node++)
+		CHECK(ids.Insert(MockHandle{ node }, node * 10));
+
+	CHECK(ids.Size() == 16);
+	CHECK(!ids.Insert(MockHandle{ 5 }, 0));
+
+	for (int node = 0; node < 16; node++)
+	{
+		const VRayConversion::NodeId* id = ids.Find(MockHandle{ node });
+		CHECK(id && *id == node * 10);
+	}
+
+	CHECK(ids.Find(MockHandle{ 16 }) == nullptr);
+});
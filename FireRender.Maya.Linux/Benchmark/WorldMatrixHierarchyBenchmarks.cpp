@@ -0,0 +1,247 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "Benchmark.h"
+#include "BenchmarkScenes.h"
+
+#include "Context/WorldMatrixHierarchy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	typedef WorldMatrixHierarchy::Matrix Matrix;
+
+	const int HierarchyNodeCount = 100000;
+
+	// Groups directly under the root, one of them is moved
+	const int TopGroupCount = 16;
+
+	Matrix MakeLocal(BenchmarkScenes::Random& random)
+	{
+		double rx = (random.NextFloat() - 0.5) * 0.5;
+		double rz = (random.NextFloat() - 0.5) * 0.5;
+		double scale = 0.9 + 0.2 * random.NextFloat();
+
+		double cx = std::cos(rx);
+		double sx = std::sin(rx);
+		double cz = std::cos(rz);
+		double sz = std::sin(rz);
+
+		// rotation about x, then z, uniform scale and translation in the last row (row vectors)
+		Matrix local = Matrix::Identity();
+		local.m[0][0] = cz * scale;
+		local.m[0][1] = sz * scale;
+		local.m[1][0] = -cx * sz * scale;
+		local.m[1][1] = cx * cz * scale;
+		local.m[1][2] = sx * scale;
+		local.m[2][0] = sx * sz * scale;
+		local.m[2][1] = -sx * cz * scale;
+		local.m[2][2] = cx * scale;
+		local.m[3][0] = (random.NextFloat() - 0.5) * 10.0;
+		local.m[3][1] = (random.NextFloat() - 0.5) * 10.0;
+		local.m[3][2] = (random.NextFloat() - 0.5) * 10.0;
+
+		return local;
+	}
+
+	// A rig like hierarchy: long chains mixed with wide groups, parents always come first
+	struct Hierarchy
+	{
+		std::vector<int> parents;
+		std::vector<Matrix> locals;
+		std::vector<char> inherits;
+
+		// the top group with most nodes below it
+		int movedGroup = 0;
+		std::vector<char> moved;
+		int movedCount = 0;
+	};
+
+	Hierarchy MakeHierarchy(int nodeCount, uint32_t seed)
+	{
+		BenchmarkScenes::Random random(seed);
+		Hierarchy hierarchy;
+
+		for (int i = 0; i < nodeCount; i++)
+		{
+			int parent = WorldMatrixHierarchy::NoNode;
+
+			if (i > 0 && i <= TopGroupCount)
+				parent = 0;
+			else if (i > TopGroupCount)
+			{
+				uint32_t window = random.Next() % 2 == 0 ? 8u : uint32_t(i - 1);
+				parent = i - 1 - int(random.Next() % std::min(window, uint32_t(i - 1)));
+			}
+
+			hierarchy.parents.push_back(parent);
+			hierarchy.locals.push_back(MakeLocal(random));
+			hierarchy.inherits.push_back(random.Next() % 500 != 0);
+		}
+
+		std::vector<int> subtreeSizes(nodeCount, 1);
+		for (int i = nodeCount - 1; i > 0; i--)
+			subtreeSizes[hierarchy.parents[i]] += subtreeSizes[i];
+
+		hierarchy.movedGroup = 1;
+		for (int i = 1; i <= TopGroupCount; i++)
+		{
+			if (subtreeSizes[i] > subtreeSizes[hierarchy.movedGroup])
+				hierarchy.movedGroup = i;
+		}
+
+		hierarchy.moved.resize(nodeCount, 0);
+		for (int i = 0; i < nodeCount; i++)
+		{
+			int parent = hierarchy.parents[i];
+			hierarchy.moved[i] = i == hierarchy.movedGroup || (parent != WorldMatrixHierarchy::NoNode && hierarchy.moved[parent]);
+			hierarchy.movedCount += hierarchy.moved[i];
+		}
+
+		return hierarchy;
+	}
+
+	// What every shape did before: walk its own path up to the root (MDagPath::inclusiveMatrix)
+	Matrix WorldFromChain(const Hierarchy& hierarchy, int node)
+	{
+		Matrix world = hierarchy.locals[node];
+
+		while (hierarchy.inherits[node] && hierarchy.parents[node] != WorldMatrixHierarchy::NoNode)
+		{
+			node = hierarchy.parents[node];
+			world = WorldMatrixHierarchy::Multiply(world, hierarchy.locals[node]);
+		}
+
+		return world;
+	}
+
+	void Build(const Hierarchy& hierarchy, WorldMatrixHierarchy& result)
+	{
+		result.Reserve(hierarchy.parents.size());
+
+		for (size_t i = 0; i < hierarchy.parents.size(); i++)
+			result.Add(hierarchy.parents[i], unsigned(i), hierarchy.locals[i], hierarchy.inherits[i] != 0);
+	}
+
+	void MoveGroup(Hierarchy& hierarchy)
+	{
+		Matrix& local = hierarchy.locals[hierarchy.movedGroup];
+		local.m[3][0] += 25.0;
+		local.m[3][2] -= 10.0;
+	}
+
+	// relative to the translation range of the scene
+	double MaxError(const Hierarchy& hierarchy, const WorldMatrixHierarchy& result)
+	{
+		double maxError = 0.0;
+
+		for (int i = 0; i < int(hierarchy.parents.size()); i++)
+		{
+			Matrix expected = WorldFromChain(hierarchy, i);
+			const Matrix& world = result.World(i);
+
+			for (int row = 0; row < 4; row++)
+			{
+				for (int column = 0; column < 4; column++)
+					maxError = std::max(maxError, std::fabs(expected.m[row][column] - world.m[row][column]));
+			}
+		}
+
+		return maxError;
+	}
+}
+
+BENCHMARK("WorldMatrixHierarchy/moveGroupPerObject", [](Benchmark::State& state)
+{
+	Hierarchy hierarchy = MakeHierarchy(HierarchyNodeCount, 49);
+	MoveGroup(hierarchy);
+
+	std::vector<Matrix> worlds(hierarchy.parents.size());
+
+	state.Start();
+	for (int i = 0; i < int(hierarchy.parents.size()); i++)
+	{
+		if (hierarchy.moved[i])
+			worlds[i] = WorldFromChain(hierarchy, i);
+	}
+	state.Stop();
+
+	state.SetCounter("moved", double(hierarchy.movedCount));
+});
+
+BENCHMARK("WorldMatrixHierarchy/moveGroupPropagate", [](Benchmark::State& state)
+{
+	Hierarchy hierarchy = MakeHierarchy(HierarchyNodeCount, 49);
+
+	WorldMatrixHierarchy result;
+	Build(hierarchy, result);
+	result.Propagate();
+
+	MoveGroup(hierarchy);
+
+	state.Start();
+	result.SetLocal(hierarchy.movedGroup, hierarchy.locals[hierarchy.movedGroup]);
+	size_t recomputed = result.Propagate();
+	state.Stop();
+
+	CHECK(recomputed == size_t(hierarchy.movedCount));
+	CHECK(MaxError(hierarchy, result) <= 1e-9);
+
+	state.SetCounter("moved", double(hierarchy.movedCount));
+	state.SetCounter("recomputed", double(recomputed));
+});
+
+BENCHMARK("WorldMatrixHierarchy/buildAndPropagate", [](Benchmark::State& state)
+{
+	Hierarchy hierarchy = MakeHierarchy(HierarchyNodeCount, 49);
+	MoveGroup(hierarchy);
+
+	WorldMatrixHierarchy result;
+
+	// what the context does for each refresh with moved objects
+	state.Start();
+	Build(hierarchy, result);
+	size_t recomputed = result.Propagate();
+	state.Stop();
+
+	CHECK(recomputed == hierarchy.parents.size());
+	CHECK(MaxError(hierarchy, result) <= 1e-9);
+
+	state.SetCounter("recomputed", double(recomputed));
+});
+
+TEST("WorldMatrixHierarchy/propagateMatchesChains", [](Benchmark::State& state)
+{
+	Hierarchy hierarchy = MakeHierarchy(HierarchyNodeCount, 49);
+
+	WorldMatrixHierarchy result;
+	Build(hierarchy, result);
+
+	CHECK(result.NodeCount() == hierarchy.parents.size());
+	CHECK(result.Propagate() == hierarchy.parents.size());
+	CHECK(MaxError(hierarchy, result) <= 1e-9);
+
+	// only the moved group and everything below it is recomputed
+	MoveGroup(hierarchy);
+	result.SetLocal(hierarchy.movedGroup, hierarchy.locals[hierarchy.movedGroup]);
+
+	CHECK(result.Propagate() == size_t(hierarchy.movedCount));
+	CHECK(MaxError(hierarchy, result) <= 1e-9);
+	CHECK(result.Propagate() == 0);
+
+	// adding a known node again updates it in place
+	CHECK(result.Add(hierarchy.parents[5], 5u, hierarchy.locals[5]) == 5);
+	CHECK(result.NodeCount() == hierarchy.parents.size());
+});
@@ -0,0 +1,145 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+
+// Usage: benchmark [-r repeats] [-t] [name filter]
+// Every registered benchmark whose name contains the filter is run "repeats" times,
+// the median time is reported. Scenes are generated from fixed seeds so numbers
+// are comparable between runs and between changes.
+// Tests run once; with -t only tests run. Exit status is non-zero if any check failed.
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace std;
+
+namespace Benchmark
+{
+	vector<Entry>& Registry()
+	{
+		static vector<Entry> registry;
+		return registry;
+	}
+
+	void State::SetCounter(const string& name, double value)
+	{
+		for (auto& counter : m_counters)
+		{
+			if (counter.first == name)
+			{
+				counter.second = value;
+				return;
+			}
+		}
+
+		m_counters.emplace_back(name, value);
+	}
+
+	void State::Check(bool condition, const char* expression, const char* file, int line)
+	{
+		if (condition)
+			return;
+
+		m_failures++;
+		fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+	}
+
+	namespace
+	{
+		const void* volatile sink = nullptr;
+	}
+
+	void DoNotOptimize(const void* p)
+	{
+		sink = p;
+	}
+}
+
+int main(int argc, const char *argv[])
+{
+	int repeats = 5;
+	const char* filter = "";
+	bool testsOnly = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+		{
+			repeats = max(1, atoi(argv[++i]));
+		}
+		else if (strcmp(argv[i], "-t") == 0)
+		{
+			testsOnly = true;
+		}
+		else
+		{
+			filter = argv[i];
+		}
+	}
+
+	auto& registry = Benchmark::Registry();
+	sort(registry.begin(), registry.end(), [](const Benchmark::Entry& a, const Benchmark::Entry& b) { return a.name < b.name; });
+
+	size_t failures = 0;
+
+	for (const auto& entry : registry)
+	{
+		if (entry.name.find(filter) == string::npos || (testsOnly && !entry.isTest))
+			continue;
+
+		if (entry.isTest)
+		{
+			Benchmark::State state;
+			entry.function(state);
+
+			printf("%-48s %s\n", entry.name.c_str(), state.Failures() == 0 ? "ok" : "FAILED");
+			failures += state.Failures();
+			continue;
+		}
+
+		vector<double> times;
+		Benchmark::State lastState;
+
+		for (int i = 0; i < repeats; i++)
+		{
+			Benchmark::State state;
+			entry.function(state);
+
+			times.push_back(state.ElapsedMs());
+			failures += state.Failures();
+			lastState = state;
+		}
+
+		sort(times.begin(), times.end());
+
+		printf("%-48s median %10.3f ms  min %10.3f ms", entry.name.c_str(), times[times.size() / 2], times.front());
+
+		for (const auto& counter : lastState.Counters())
+		{
+			printf("  %s=%.0f", counter.first.c_str(), counter.second);
+		}
+
+		printf("\n");
+	}
+
+	if (failures > 0)
+	{
+		fprintf(stderr, "%zu checks failed\n", failures);
+		return 1;
+	}
+
+	return 0;
+}
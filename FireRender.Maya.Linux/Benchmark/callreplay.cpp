@@ -0,0 +1,61 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+// Usage: callreplay <call log>
+// Replays a log written by the plugin with RPR_MAYA_CALL_LOG_OUTPUT set into the null backend
+// and prints how many calls of each kind the sync issued and how much data they carried.
+
+#include "CallLogReplay.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+int main(int argc, const char *argv[])
+{
+	if (argc < 2)
+	{
+		printf("Usage: callreplay <call log>\n");
+		return 1;
+	}
+
+	std::ifstream in(argv[1], std::ios::binary);
+	frw::CallLog::Reader reader(in);
+
+	NullContext context;
+	CallLogReplay::Stats stats;
+
+	auto start = std::chrono::steady_clock::now();
+	bool valid = CallLogReplay::Replay(reader, context, stats);
+	auto end = std::chrono::steady_clock::now();
+
+	if (!valid)
+	{
+		printf("%s is not a call log\n", argv[1]);
+		return 1;
+	}
+
+	printf("%-24s %12s %16s\n", "call", "count", "bytes");
+
+	for (size_t i = 0; i < stats.calls.size(); i++)
+	{
+		if (stats.calls[i] == 0)
+			continue;
+
+		printf("%-24s %12zu %16llu\n", frw::CallLog::CallName(frw::CallLog::Call(i)), stats.calls[i], (unsigned long long) stats.bytes[i]);
+	}
+
+	printf("\n%zu records, recorded over %.3f s, replayed in %.3f ms\n", stats.records, stats.recordedUs * 1e-6,
+		std::chrono::duration<double, std::milli>(end - start).count());
+
+	return 0;
+}
@@ -21,6 +21,10 @@ const int COMPONENT_COUNT_SCALE = 3;
 
 const int INPUT_PLUG_COUNT = 3;
 
+// Keys reproducible by linear interpolation within this error are not exported.
+// Applies to translation in meters, rotation quaternion components and scale factors.
+const float KEY_REDUCTION_TOLERANCE = 1e-5f;
+
 AnimationExporter::AnimationExporter(bool gltfExport) :
 	m_IsGLTFExport(gltfExport),
 	m_progressBars(nullptr)
@@ -266,20 +270,10 @@ bool AnimationExporter::IsNeedToSetANameForTransform(const MDagPath& dagPath)
 	return true;
 }
 
-void AnimationExporter::SetTransformationForNode(MObject transform, const char* groupName)
+// Translation (in meters), rotation quaternion and scale, in the order expected by SetTransformGroup
+void GetTransformComponents(const MMatrix& matrix, std::array<float, 10>& arr)
 {
-	MFnDependencyNode fnTransform(transform);
-
-	MPlug matrixPlug = fnTransform.findPlug("matrix");
-
-	MMatrix newMatrix;
-	MObject val;
-
-	matrixPlug.getValue(val);
-	newMatrix = MFnMatrixData(val).matrix();
-	MTransformationMatrix transformMatrix(newMatrix);
-
-	std::array<float, 10> arr;
+	MTransformationMatrix transformMatrix(matrix);
 
 	MVector vecTranslation = transformMatrix.getTranslation(MSpace::kTransform);
 
@@ -307,6 +301,19 @@ void AnimationExporter::SetTransformationForNode(MObject transform, const char*
 	{
 		arr[index++] = (float)scale[i];
 	}
+}
+
+void AnimationExporter::SetTransformationForNode(MObject transform, const char* groupName)
+{
+	MFnDependencyNode fnTransform(transform);
+
+	MPlug matrixPlug = fnTransform.findPlug("matrix");
+
+	MObject val;
+	matrixPlug.getValue(val);
+
+	std::array<float, 10> arr;
+	GetTransformComponents(MFnMatrixData(val).matrix(), arr);
 
 	m_pFunc_SetTransformGroup(groupName, arr.data());
 }
@@ -373,6 +380,52 @@ void AnimationExporter::AnimateGroups(AnimationDataHolderVector& dataHolder)
 
 		ReportProgress((int)(100 * (i + 1) / groupDagPathVector.size()));
 	}
+
+	ReduceAndAddAnimations(dataHolder);
+}
+
+void AnimationExporter::ReduceAndAddAnimations(AnimationDataHolderVector& dataHolder)
+{
+	// Tracks are independent from each other and from Maya, so they are reduced in parallel
+	const int trackCount = (int) dataHolder.size();
+	std::vector<char> keepTrack(trackCount, 0);
+
+#pragma omp parallel for schedule(dynamic, 8)
+	for (int i = 0; i < trackCount; i++)
+	{
+		AnimationDataHolderStruct& track = dataHolder[i];
+
+		keepTrack[i] = AnimationKeys::ReduceTrack(track.m_timePoints, track.m_values, track.componentCount,
+			track.restValue, KEY_REDUCTION_TOLERANCE) == AnimationKeys::TrackReduction::Keep;
+	}
+
+	// RPR calls stay on the calling thread
+	for (int i = 0; i < trackCount; i++)
+	{
+		if (keepTrack[i])
+		{
+			(this->*m_pFunc_AddAnimationTrackToRPR)(dataHolder[i], dataHolder[i].attributeId);
+		}
+	}
+}
+
+unsigned int AnimationExporter::GetTrackBit(int attributeId) const
+{
+	if (attributeId == m_runtimeMoveTypeTranslation)
+	{
+		return 1u << 0;
+	}
+	else if (attributeId == m_runtimeMoveTypeRotation)
+	{
+		return 1u << 1;
+	}
+	else if (attributeId == m_runtimeMoveTypeScale)
+	{
+		return 1u << 2;
+	}
+
+	assert(false);
+	return 0;
 }
 
 MString AnimationExporter::GetAttributeNameById(int id)
@@ -413,7 +466,7 @@ int AnimationExporter::GetOutputComponentCount(int attrId)
 	return 0;
 }
 
-void AnimationExporter::AddTimesFromCurve(const MFnAnimCurve& curve, TimeKeySet& outUniqueTimeKeySet, int attributeId)
+void AnimationExporter::AddTimesFromCurve(const MFnAnimCurve& curve, TimeKeyVector& outTimeKeys, int attributeId)
 {
 	int keyCount = curve.numKeys();
 
@@ -429,34 +482,27 @@ void AnimationExporter::AddTimesFromCurve(const MFnAnimCurve& curve, TimeKeySet&
 			continue;
 		}
 
-		AddOneTimePoint(time, curve, outUniqueTimeKeySet, attributeId, keyIndex);
+		AddOneTimePoint(time, curve, outTimeKeys, attributeId, keyIndex);
 	}
 
 	// Add auto point for the start and end animation point
-	AddOneTimePoint(startTime, curve, outUniqueTimeKeySet, attributeId, 0);
-	AddOneTimePoint(endTime, curve, outUniqueTimeKeySet, attributeId, keyCount - 1);
+	AddOneTimePoint(startTime, curve, outTimeKeys, attributeId, 0);
+	AddOneTimePoint(endTime, curve, outTimeKeys, attributeId, keyCount - 1);
 }
 
-void AnimationExporter::AddOneTimePoint(const MTime time, const MFnAnimCurve& curve, TimeKeySet& outUniqueTimeKeySet, int attributeId, int keyIndex)
+void AnimationExporter::AddOneTimePoint(const MTime time, const MFnAnimCurve& curve, TimeKeyVector& outTimeKeys, int attributeId, int keyIndex)
 {
-	TimeKeyStruct timeKey(time, attributeId);
-
-	TimeKeySet::iterator it = outUniqueTimeKeySet.find(timeKey);
-	if (it != outUniqueTimeKeySet.end())
-	{
-		it->AddNewAttribute(attributeId);
-	}
-	else
-	{
-		it = outUniqueTimeKeySet.insert(timeKey).first;
-	}
+	// Keys are only appended here, duplicates are merged by AnimationKeys::SortAndMerge once all curves are processed
+	unsigned int trackMask = GetTrackBit(attributeId);
 
 	// if we process rotation attribute we should as translation as well because in some complex rotations translation might be changed as well
 	if (attributeId == m_runtimeMoveTypeRotation)
 	{
-		it->AddNewAttribute(m_runtimeMoveTypeTranslation);
+		trackMask |= GetTrackBit(m_runtimeMoveTypeTranslation);
 	}
 
+	outTimeKeys.push_back({ time.as(MTime::kSeconds), trackMask });
+
 	// keys autogeneration for rotation
 	if ((attributeId == m_runtimeMoveTypeRotation) && (keyIndex > 0))
 	{
@@ -470,7 +516,7 @@ void AnimationExporter::AddOneTimePoint(const MTime time, const MFnAnimCurve& cu
 		while (currentValue < maxValue)
 		{
 			MTime additionalTimePoint = prevTime + (maxTime - prevTime) * (currentValue - minValue) / (maxValue - minValue);
-			outUniqueTimeKeySet.insert(TimeKeyStruct(additionalTimePoint, attributeId));
+			outTimeKeys.push_back({ additionalTimePoint.as(MTime::kSeconds), GetTrackBit(attributeId) });
 
 			currentValue += step;
 		}
@@ -555,9 +601,9 @@ void AnimationExporter::ApplyAnimationForTransform(const MDagPath& dagPath, Anim
 
 	MFnAnimCurve tempCurve;
 
-	TimeKeySet uniqueTimeKeys;
+	TimeKeyVector timeKeys;
 
-	// Gather Unique key points
+	// Gather key points of all curves, they are sorted and deduplicated at once afterwards
 	MString componentNames[inputPlugCount] = { "X", "Y", "Z" };
 	for (int attributeId : attrIds)
 	{
@@ -581,90 +627,77 @@ void AnimationExporter::ApplyAnimationForTransform(const MDagPath& dagPath, Anim
 			if (MAnimUtil::findAnimation(plug, curveObj, &status))
 			{
 				tempCurve.setObject(curveObj[0]);
-				AddTimesFromCurve(tempCurve, uniqueTimeKeys, attributeId);
+				AddTimesFromCurve(tempCurve, timeKeys, attributeId);
 			}
 		}
 	}
 
+	AnimationKeys::SortAndMerge(timeKeys);
+
 	MPlug matrixPlug = depNodeTransform.findPlug("matrix", &status);
 
-	size_t keyCount = uniqueTimeKeys.size();
+	// Static transform of the group, tracks which never leave it are dropped later
+	std::array<float, 10> restValues;
+	{
+		MObject val;
+		matrixPlug.getValue(val);
+		GetTransformComponents(MFnMatrixData(val).matrix(), restValues);
+	}
 
-	// this is just for progress reporting
-	size_t dataChunkIndex = 0;
+	size_t firstTrack = dataHolder.size();
+	unsigned int trackBits[attrCount];
+	const int componentOffsets[attrCount] = { 0, COMPONENT_COUNT_TRANSLATION, COMPONENT_COUNT_TRANSLATION + COMPONENT_COUNT_ROTATION };
+	const int componentCounts[attrCount] = { COMPONENT_COUNT_TRANSLATION, COMPONENT_COUNT_ROTATION, COMPONENT_COUNT_SCALE };
 
-	// Export necessary attributes
-	for (int attributeId : attrIds)
+	for (int track = 0; track < attrCount; track++)
 	{
 		dataHolder.emplace(dataHolder.end());
 		AnimationDataHolderStruct& dataHolderStruct = dataHolder.back();
 
-		for (TimeKeySet::iterator it = uniqueTimeKeys.begin(); it != uniqueTimeKeys.end(); it++)
-		{
-			dataChunkIndex++;
-
-			if (!it->DoesAttributeIdPresent(attributeId))
-			{
-				continue;
-			}
-
-			MTime time = it->GetTime();
-			MDGContext dgContext(time);
+		dataHolderStruct.groupName = groupName;
+		dataHolderStruct.attributeId = attrIds[track];
+		dataHolderStruct.componentCount = componentCounts[track];
+		std::copy_n(restValues.begin() + componentOffsets[track], componentCounts[track], dataHolderStruct.restValue);
 
-			MMatrix newMatrix;
-			MObject val;
+		trackBits[track] = GetTrackBit(attrIds[track]);
+	}
 
-			matrixPlug.getValue(val, dgContext);
-			newMatrix = MFnMatrixData(val).matrix();
+	// Export necessary attributes: matrix is evaluated and decomposed once per time point for all tracks
+	std::array<float, 10> values;
 
-			MTransformationMatrix transformMatrix(newMatrix);
+	for (size_t keyIndex = 0; keyIndex < timeKeys.size(); keyIndex++)
+	{
+		const AnimationKeys::TimeKey& key = timeKeys[keyIndex];
 
-			dataHolderStruct.m_timePoints.push_back((float)it->GetTime().as(MTime::Unit::kSeconds));
+		MTime time(key.time, MTime::kSeconds);
+		MDGContext dgContext(time);
 
-			if (attributeId == m_runtimeMoveTypeTranslation)
-			{
-				MVector vec1 = transformMatrix.getTranslation(MSpace::kTransform);
-				//cm to m
-				float coeff = 0.01f;
+		MObject val;
+		matrixPlug.getValue(val, dgContext);
+		GetTransformComponents(MFnMatrixData(val).matrix(), values);
 
-				dataHolderStruct.m_values.push_back((float)vec1.x * coeff);
-				dataHolderStruct.m_values.push_back((float)vec1.y * coeff);
-				dataHolderStruct.m_values.push_back((float)vec1.z * coeff);
-			}
-			else if (attributeId == m_runtimeMoveTypeRotation)
-			{
-				MQuaternion rotation = transformMatrix.rotation();
-				dataHolderStruct.m_values.push_back((float)rotation.x);
-				dataHolderStruct.m_values.push_back((float)rotation.y);
-				dataHolderStruct.m_values.push_back((float)rotation.z);
-				dataHolderStruct.m_values.push_back((float)rotation.w);
-			}
-			else if (attributeId == m_runtimeMoveTypeScale)
+		for (int track = 0; track < attrCount; track++)
+		{
+			if ((key.trackMask & trackBits[track]) == 0)
 			{
-				double scale[3];
-				transformMatrix.getScale(scale, MSpace::kTransform);
-
-				dataHolderStruct.m_values.push_back((float)scale[0]);
-				dataHolderStruct.m_values.push_back((float)scale[1]);
-				dataHolderStruct.m_values.push_back((float)scale[2]);
+				continue;
 			}
 
-			if (m_progressBars != nullptr && m_progressBars->isCancelled())
-			{
-				throw ExportCancelledException();
-			}
+			AnimationDataHolderStruct& dataHolderStruct = dataHolder[firstTrack + track];
 
-			if (dataChunkIndex % 100 == 0)
-			{
-				ReportDataChunk(dataChunkIndex, attrCount * uniqueTimeKeys.size());
-			}
+			dataHolderStruct.m_timePoints.push_back((float)key.time);
+			dataHolderStruct.m_values.insert(dataHolderStruct.m_values.end(),
+				values.begin() + componentOffsets[track], values.begin() + componentOffsets[track] + componentCounts[track]);
 		}
 
-		dataHolderStruct.groupName = groupName;
+		if (m_progressBars != nullptr && m_progressBars->isCancelled())
+		{
+			throw ExportCancelledException();
+		}
 
-		if (dataHolderStruct.m_timePoints.size() > 0)
+		if ((keyIndex + 1) % 100 == 0)
 		{
-			(this->*m_pFunc_AddAnimationTrackToRPR)(dataHolderStruct, attributeId);
+			ReportDataChunk(keyIndex + 1, timeKeys.size());
 		}
 	}
 }
@@ -3,6 +3,7 @@
 #include <maya/MFnAnimCurve.h>
 #include "RenderProgressBars.h"
 #include "Context/FireRenderContext.h"
+#include "AnimationKeyReduction.h"
 
 #include <vector>
 
@@ -28,48 +29,7 @@ class ExportCancelledException
 
 };
 
-class TimeKeyStruct
-{
-public:
-	TimeKeyStruct(MTime time, int attributeId) : m_Time(time)
-	{
-		m_AttributeId.insert(attributeId);
-	}
-
-	bool operator == (const TimeKeyStruct& rhs) const
-	{
-		return m_Time == rhs.m_Time;
-	}
-
-	bool operator < (const TimeKeyStruct& rhs) const
-	{
-		return m_Time < rhs.m_Time;
-	}
-
-
-	// Make modifier as const because of use of mutable m_AttributeId member. It is needed because we need to modify it in a "std::set" container
-	void AddNewAttribute(int attributeId) const
-	{
-		m_AttributeId.insert(attributeId);
-	}
-
-	bool DoesAttributeIdPresent(int attributeId) const
-	{
-		return m_AttributeId.find(attributeId) != m_AttributeId.end();
-	}
-
-	MTime GetTime() const { return m_Time; }
-	const std::set<int>& GetAttributeSetRef() const { return m_AttributeId; }
-
-private:
-	MTime m_Time;
-
-	// Use set of attribute Ids because  RPRGLTF_ANIMATION_MOVEMENTTYPE_TRANSLATION, 
-	// RPRGLTF_ANIMATION_MOVEMENTTYPE_ROTATION, RPRGLTF_ANIMATION_MOVEMENTTYPE_SCALE cannot be combined in a flag mask				
-	mutable std::set<int> m_AttributeId;
-};
-
-typedef std::set<TimeKeyStruct> TimeKeySet;
+typedef std::vector<AnimationKeys::TimeKey> TimeKeyVector;
 
 class AnimationExporter
 {
@@ -89,6 +49,12 @@ private:
 		std::vector<float> m_timePoints;
 		std::vector<float> m_values;
 		MString groupName;
+
+		int attributeId = 0;
+		int componentCount = 0;
+
+		// value of the track in the static transform of the group, see SetTransformationForNode
+		float restValue[4] = {};
 	};
 
 	typedef std::vector<AnimationDataHolderStruct> AnimationDataHolderVector;
@@ -104,6 +70,7 @@ private:
 	MString GetGroupNameForDagPath(MDagPath dagPath, int pop = 0);
 	void AddAnimations(DataHolderStruct& dataHolder, FireRenderContext& context);
 	void AnimateGroups(AnimationDataHolderVector& dataHolder);
+	void ReduceAndAddAnimations(AnimationDataHolderVector& dataHolder);
 	MString GetAttributeNameById(int id);
 
 	void SetTransformationForNode(MObject transform, const char* groupName);
@@ -112,9 +79,11 @@ private:
 	void AssignMeshesAndLights(FireRenderContext& context);
 
 	// addAdditionalKeys param means that we need to add additional keys for Rotation, 
-	void AddTimesFromCurve(const MFnAnimCurve& curve, TimeKeySet& outUniqueTimeKeySet, int attributeId);
+	void AddTimesFromCurve(const MFnAnimCurve& curve, TimeKeyVector& outTimeKeys, int attributeId);
+
+	void AddOneTimePoint(const MTime time, const MFnAnimCurve& curve, TimeKeyVector& outTimeKeys, int attributeId, int keyIndex);
 
-	void AddOneTimePoint(const MTime time, const MFnAnimCurve& curve, TimeKeySet& outUniqueTimeKeySet, int attributeId, int keyIndex);
+	unsigned int GetTrackBit(int attributeId) const;
 
 	int GetOutputComponentCount(int attrId);
 	inline float GetValueForTime(const MPlug& plug, const MFnAnimCurve& curve, const MTime& time);
@@ -0,0 +1,203 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "AnimationKeyReduction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace AnimationKeys
+{
+
+namespace
+{
+	/** Line through the anchor key which stays within tolerance of every key after it.
+		Each passed key limits the allowed slope to an interval, so a candidate end key is
+		checked against all keys between it and the anchor in O(components). */
+	class SlopeWindow
+	{
+	public:
+		SlopeWindow(const std::vector<float>& times, const std::vector<float>& values, int components, float tolerance) :
+			m_times(times),
+			m_values(values),
+			m_components(components),
+			m_tolerance(tolerance),
+			m_anchor(0),
+			m_minSlope(components),
+			m_maxSlope(components)
+		{
+			Reset(0);
+		}
+
+		size_t Anchor() const { return m_anchor; }
+
+		void Reset(size_t anchor)
+		{
+			m_anchor = anchor;
+			std::fill(m_minSlope.begin(), m_minSlope.end(), -std::numeric_limits<double>::infinity());
+			std::fill(m_maxSlope.begin(), m_maxSlope.end(), std::numeric_limits<double>::infinity());
+		}
+
+		// Line from the anchor to the key passes all keys added so far
+		bool Fits(size_t key) const
+		{
+			double dt = double(m_times[key]) - m_times[m_anchor];
+			if (!(dt > 0.0))
+				return false;
+
+			for (int c = 0; c < m_components; c++)
+			{
+				double slope = (double(Value(key, c)) - Value(m_anchor, c)) / dt;
+
+				// written this way to fail on NaN
+				if (!(slope >= m_minSlope[c] && slope <= m_maxSlope[c]))
+					return false;
+			}
+
+			return true;
+		}
+
+		void Add(size_t key)
+		{
+			double dt = double(m_times[key]) - m_times[m_anchor];
+
+			for (int c = 0; c < m_components; c++)
+			{
+				double delta = double(Value(key, c)) - Value(m_anchor, c);
+
+				if (!(dt > 0.0) || delta != delta)
+				{
+					// no line passes a second key at the anchor time or a NaN key, it has to be kept
+					m_minSlope[c] = std::numeric_limits<double>::infinity();
+					m_maxSlope[c] = -std::numeric_limits<double>::infinity();
+					continue;
+				}
+
+				m_minSlope[c] = std::max(m_minSlope[c], (delta - m_tolerance) / dt);
+				m_maxSlope[c] = std::min(m_maxSlope[c], (delta + m_tolerance) / dt);
+			}
+		}
+
+	private:
+		float Value(size_t key, int component) const { return m_values[key * m_components + component]; }
+
+		const std::vector<float>& m_times;
+		const std::vector<float>& m_values;
+		int m_components;
+		double m_tolerance;
+
+		size_t m_anchor;
+		std::vector<double> m_minSlope;
+		std::vector<double> m_maxSlope;
+	};
+}
+
+void SortAndMerge(std::vector<TimeKey>& keys)
+{
+	if (keys.empty())
+		return;
+
+	std::sort(keys.begin(), keys.end(), [](const TimeKey& a, const TimeKey& b) { return a.time < b.time; });
+
+	size_t last = 0;
+	for (size_t i = 1; i < keys.size(); i++)
+	{
+		if (keys[i].time - keys[last].time <= TimeEpsilon)
+		{
+			keys[last].trackMask |= keys[i].trackMask;
+		}
+		else
+		{
+			keys[++last] = keys[i];
+		}
+	}
+
+	keys.resize(last + 1);
+}
+
+bool IsConstant(const std::vector<float>& values, int components, float tolerance)
+{
+	if (components <= 0)
+		return true;
+
+	for (size_t i = components; i < values.size(); i++)
+	{
+		if (!(std::fabs(values[i] - values[i % components]) <= tolerance))
+			return false;
+	}
+
+	return true;
+}
+
+void ReduceLinear(std::vector<float>& times, std::vector<float>& values, int components, float tolerance)
+{
+	size_t count = times.size();
+
+	if (count < 3 || values.size() != count * components)
+		return;
+
+	std::vector<size_t> kept;
+	kept.push_back(0);
+
+	SlopeWindow window(times, values, components, tolerance);
+
+	for (size_t key = 1; key < count; key++)
+	{
+		if (key > window.Anchor() + 1 && !window.Fits(key))
+		{
+			// previous key is the furthest one still reachable by a line from the anchor
+			kept.push_back(key - 1);
+			window.Reset(key - 1);
+		}
+
+		window.Add(key);
+	}
+
+	kept.push_back(count - 1);
+
+	for (size_t i = 0; i < kept.size(); i++)
+	{
+		size_t src = kept[i];
+
+		times[i] = times[src];
+		std::copy(values.begin() + src * components, values.begin() + (src + 1) * components, values.begin() + i * components);
+	}
+
+	times.resize(kept.size());
+	values.resize(kept.size() * components);
+}
+
+TrackReduction ReduceTrack(std::vector<float>& times, std::vector<float>& values, int components,
+	const float* restValue, float tolerance)
+{
+	if (times.empty())
+		return TrackReduction::Drop;
+
+	if (IsConstant(values, components, tolerance) && restValue != nullptr)
+	{
+		bool matchesRest = true;
+		for (int c = 0; c < components; c++)
+		{
+			matchesRest &= std::fabs(values[c] - restValue[c]) <= tolerance;
+		}
+
+		if (matchesRest)
+			return TrackReduction::Drop;
+	}
+
+	ReduceLinear(times, values, components, tolerance);
+
+	return TrackReduction::Keep;
+}
+
+}
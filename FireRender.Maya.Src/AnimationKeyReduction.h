@@ -0,0 +1,52 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <vector>
+
+/** Key time gathering and key reduction for GLTF/RPRS animation export.
+	Has no Maya dependency: times are in seconds, tracks are flat arrays of
+	interleaved components (3 for translation and scale, 4 for rotation quaternion). */
+namespace AnimationKeys
+{
+	struct TimeKey
+	{
+		double time;
+
+		// bit per exported track of a transform the key is needed for
+		unsigned int trackMask;
+	};
+
+	// Keys closer than this (in seconds) are treated as the same time point
+	const double TimeEpsilon = 1e-9;
+
+	// Sorts keys by time and merges the ones with equal time, track masks are combined
+	void SortAndMerge(std::vector<TimeKey>& keys);
+
+	// All keys equal to the first key within tolerance
+	bool IsConstant(const std::vector<float>& values, int components, float tolerance);
+
+	// Removes keys which linear interpolation between kept neighbours reproduces within tolerance
+	// for every component. First and last keys are always kept.
+	void ReduceLinear(std::vector<float>& times, std::vector<float>& values, int components, float tolerance);
+
+	enum class TrackReduction
+	{
+		Keep,
+		Drop	// constant and equal to the rest value, track is not needed at all
+	};
+
+	// Drops constant tracks matching restValue (restValue may be null), reduces the rest
+	TrackReduction ReduceTrack(std::vector<float>& times, std::vector<float>& values, int components,
+		const float* restValue, float tolerance);
+}
@@ -0,0 +1,172 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "ContentCache.h"
+
+#include <cstring>
+
+namespace
+{
+	inline uint64_t Rotl(uint64_t x, int r)
+	{
+		return (x << r) | (x >> (64 - r));
+	}
+
+	inline uint64_t Finalize(uint64_t x)
+	{
+		x ^= x >> 33;
+		x *= 0xFF51AFD7ED558CCDull;
+		x ^= x >> 33;
+		x *= 0xC4CEB9FE1A85EC53ull;
+		x ^= x >> 33;
+		return x;
+	}
+}
+
+void ContentCache::KeyBuilder::Add(const void* data, size_t size)
+{
+	// two lanes over alternating words (MurmurHash3 x64_128 rounds), then chained into the key,
+	// so the same values added in a different order give a different key
+	const uint64_t c1 = 0x87C37B91114253D5ull;
+	const uint64_t c2 = 0x4CF5AD432745937Full;
+
+	const char* bytes = static_cast<const char*>(data);
+
+	uint64_t h1 = m_key.hash1 ^ size;
+	uint64_t h2 = m_key.hash2 + 0x9E3779B97F4A7C15ull;
+
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16)
+	{
+		uint64_t k1;
+		uint64_t k2;
+		std::memcpy(&k1, bytes + i, sizeof(k1));
+		std::memcpy(&k2, bytes + i + 8, sizeof(k2));
+
+		h1 ^= Rotl(k1 * c1, 31) * c2;
+		h1 = (Rotl(h1, 27) + h2) * 5 + 0x52DCE729;
+
+		h2 ^= Rotl(k2 * c2, 33) * c1;
+		h2 = (Rotl(h2, 31) + h1) * 5 + 0x38495AB5;
+	}
+
+	uint64_t tail[2] = { 0, 0 };
+	if (i < size)
+	{
+		std::memcpy(tail, bytes + i, size - i);
+	}
+
+	h1 ^= Rotl(tail[0] * c1, 31) * c2;
+	h2 ^= Rotl(tail[1] * c2, 33) * c1;
+
+	h1 += h2;
+	h2 += h1;
+	h1 = Finalize(h1);
+	h2 = Finalize(h2);
+	h1 += h2;
+	h2 += h1;
+
+	m_key.hash1 = h1;
+	m_key.hash2 = h2;
+}
+
+ContentCache::ContentCache(size_t budget) :
+	m_budget(budget)
+{
+}
+
+std::shared_ptr<const ContentCache::Payload> ContentCache::Find(const Key& key)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_index.find(key);
+	if (it == m_index.end())
+	{
+		m_misses++;
+		return nullptr;
+	}
+
+	m_hits++;
+	m_entries.splice(m_entries.begin(), m_entries, it->second);
+
+	return it->second->payload;
+}
+
+void ContentCache::Insert(const Key& key, std::shared_ptr<const Payload> payload)
+{
+	if (!payload)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	size_t size = payload->Size();
+
+	auto it = m_index.find(key);
+	if (it != m_index.end())
+	{
+		m_size -= it->second->size;
+		m_entries.erase(it->second);
+		m_index.erase(it);
+	}
+
+	// a result larger than the whole budget would only push everything else out
+	if (size > m_budget)
+		return;
+
+	m_entries.push_front({ key, std::move(payload), size });
+	m_index[key] = m_entries.begin();
+	m_size += size;
+
+	Trim();
+}
+
+void ContentCache::SetBudget(size_t budget)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_budget = budget;
+	Trim();
+}
+
+void ContentCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_index.clear();
+	m_entries.clear();
+	m_size = 0;
+}
+
+ContentCache::Stats ContentCache::GetStats() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	Stats stats;
+	stats.hits = m_hits;
+	stats.misses = m_misses;
+	stats.entryCount = m_entries.size();
+	stats.size = m_size;
+
+	return stats;
+}
+
+void ContentCache::Trim()
+{
+	while (m_size > m_budget && !m_entries.empty())
+	{
+		const Entry& last = m_entries.back();
+
+		m_size -= last.size;
+		m_index.erase(last.key);
+		m_entries.pop_back();
+	}
+}
@@ -0,0 +1,111 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/** Thread safe cache of expensive results addressed by a hash of their inputs.
+	Callers hash everything a result depends on into a 128 bit key, so equal inputs share one
+	result and changed inputs simply miss. Payloads report their size; least recently used
+	entries are dropped when the cache exceeds its budget. */
+class ContentCache
+{
+public:
+	struct Key
+	{
+		uint64_t hash1 = 0;
+		uint64_t hash2 = 0;
+
+		bool operator==(const Key& other) const { return hash1 == other.hash1 && hash2 == other.hash2; }
+	};
+
+	// Hashes inputs of a result into a key
+	class KeyBuilder
+	{
+	public:
+		void Add(const void* data, size_t size);
+		void Add(const std::string& value) { Add(value.data(), value.size()); }
+
+		template <typename T>
+		void AddValue(T value) { Add(&value, sizeof(T)); }
+
+		Key Get() const { return m_key; }
+
+	private:
+		Key m_key;
+	};
+
+	// Cached result, kept alive while the cache or a user holds it
+	class Payload
+	{
+	public:
+		virtual ~Payload() {}
+
+		// Approximate memory used by the payload
+		virtual size_t Size() const = 0;
+	};
+
+	struct Stats
+	{
+		unsigned long long hits = 0;
+		unsigned long long misses = 0;
+		size_t entryCount = 0;
+		size_t size = 0;
+	};
+
+public:
+	explicit ContentCache(size_t budget);
+
+	std::shared_ptr<const Payload> Find(const Key& key);
+	void Insert(const Key& key, std::shared_ptr<const Payload> payload);
+
+	void SetBudget(size_t budget);
+	void Clear();
+
+	Stats GetStats() const;
+
+private:
+	struct KeyHasher
+	{
+		size_t operator()(const Key& key) const { return size_t(key.hash1 ^ (key.hash2 << 1)); }
+	};
+
+	struct Entry
+	{
+		Key key;
+		std::shared_ptr<const Payload> payload;
+		size_t size;
+	};
+
+	typedef std::list<Entry> EntryList;
+
+	void Trim();
+
+	mutable std::mutex m_mutex;
+
+	// most recently used first
+	EntryList m_entries;
+	std::unordered_map<Key, EntryList::iterator, KeyHasher> m_index;
+
+	size_t m_budget;
+	size_t m_size = 0;
+
+	unsigned long long m_hits = 0;
+	unsigned long long m_misses = 0;
+};
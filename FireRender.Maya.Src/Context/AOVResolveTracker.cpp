@@ -0,0 +1,165 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "AOVResolveTracker.h"
+
+AOVResolveTracker::AOVResolveTracker() :
+	m_generation(1)
+{
+}
+
+void AOVResolveTracker::AdvanceGeneration()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_generation++;
+}
+
+void AOVResolveTracker::Invalidate(int aov)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_resolved.erase(aov);
+
+	for (auto it = m_readbacks.begin(); it != m_readbacks.end(); )
+	{
+		if (it->first.second == aov)
+			it = m_readbacks.erase(it);
+		else
+			++it;
+	}
+}
+
+AOVResolveTracker::Generation AOVResolveTracker::GetGeneration() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_generation;
+}
+
+bool AOVResolveTracker::Resolve(int aov, FrameBufferSource& source)
+{
+	Generation generation;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		auto it = m_resolved.find(aov);
+		if (it != m_resolved.end() && it->second == m_generation)
+			return false;
+
+		generation = m_generation;
+	}
+
+	// not under the lock, resolve may take a while; on exception the AOV stays unresolved
+	source.ResolveAOV(aov);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_resolved[aov] = generation;
+
+	return true;
+}
+
+bool AOVResolveTracker::BeginReadback(const void* consumer, int aov, uint64_t requestKey, ReadbackTicket& ticket)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_readbacks.find(ConsumerAOV(consumer, aov));
+
+	if (it != m_readbacks.end() && it->second.generation == m_generation && it->second.requestKey == requestKey)
+		return false;
+
+	ticket.consumer = consumer;
+	ticket.aov = aov;
+	ticket.requestKey = requestKey;
+	ticket.generation = m_generation;
+
+	return true;
+}
+
+void AOVResolveTracker::EndReadback(const ReadbackTicket& ticket)
+{
+	if (!ticket.consumer)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	Readback& readback = m_readbacks[ConsumerAOV(ticket.consumer, ticket.aov)];
+
+	// pixels of a generation which has moved on since are already stale
+	readback.generation = ticket.generation;
+	readback.requestKey = ticket.requestKey;
+}
+
+void AOVResolveTracker::Subscribe(const void* consumer, int aov)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_subscribers[aov].insert(consumer);
+}
+
+void AOVResolveTracker::Unsubscribe(const void* consumer, int aov)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_subscribers.find(aov);
+	if (it == m_subscribers.end())
+		return;
+
+	it->second.erase(consumer);
+
+	if (it->second.empty())
+		m_subscribers.erase(it);
+}
+
+void AOVResolveTracker::UnsubscribeAll(const void* consumer)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (auto it = m_subscribers.begin(); it != m_subscribers.end(); )
+	{
+		it->second.erase(consumer);
+
+		if (it->second.empty())
+			it = m_subscribers.erase(it);
+		else
+			++it;
+	}
+
+	for (auto it = m_readbacks.begin(); it != m_readbacks.end(); )
+	{
+		if (it->first.first == consumer)
+			it = m_readbacks.erase(it);
+		else
+			++it;
+	}
+}
+
+bool AOVResolveTracker::IsSubscribed(int aov) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_subscribers.find(aov) != m_subscribers.end();
+}
+
+std::vector<int> AOVResolveTracker::GetSubscribedAOVs() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::vector<int> aovs;
+	aovs.reserve(m_subscribers.size());
+
+	for (const auto& it : m_subscribers)
+		aovs.push_back(it.first);
+
+	return aovs;
+}
@@ -0,0 +1,99 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+/** Decides which AOVs have to be resolved and read back.
+
+	Each render pass moves the frame generation on. An AOV is resolved at most once per
+	generation, and a consumer (viewport, IPR, render view AOV) reads an AOV at most once per
+	generation for the same request. Consumers subscribe to the AOVs they display, so code
+	which walks all enabled AOVs can skip the ones nobody looks at.
+*/
+class AOVResolveTracker
+{
+public:
+	typedef uint64_t Generation;
+
+	/** Resolves frame buffers of one render context */
+	class FrameBufferSource
+	{
+	public:
+		virtual ~FrameBufferSource() {}
+		virtual void ResolveAOV(int aov) = 0;
+	};
+
+public:
+	AOVResolveTracker();
+
+	// Frame buffers got new samples or were cleared
+	void AdvanceGeneration();
+
+	// Frame buffers of the AOV were recreated
+	void Invalidate(int aov);
+
+	Generation GetGeneration() const;
+
+	// Resolves the AOV through the source unless it was already resolved in this generation.
+	// Returns true if the source was called.
+	bool Resolve(int aov, FrameBufferSource& source);
+
+	// A readback in progress, see BeginReadback
+	struct ReadbackTicket
+	{
+		const void* consumer = nullptr;
+		int aov = 0;
+		uint64_t requestKey = 0;
+		Generation generation = 0;
+	};
+
+	// Returns false if the consumer has already read the AOV in this generation with the same request
+	// (destination, region and compositing options hashed into requestKey), so the pixels it has are current.
+	// Nothing is recorded until the read succeeds and is ended, a failed read is tried again.
+	bool BeginReadback(const void* consumer, int aov, uint64_t requestKey, ReadbackTicket& ticket);
+
+	// The read of the ticket succeeded, its pixels are current for the generation it started in
+	void EndReadback(const ReadbackTicket& ticket);
+
+	void Subscribe(const void* consumer, int aov);
+	void Unsubscribe(const void* consumer, int aov);
+
+	// Also forgets readbacks of the consumer, as its pixels may be gone
+	void UnsubscribeAll(const void* consumer);
+
+	bool IsSubscribed(int aov) const;
+	std::vector<int> GetSubscribedAOVs() const;
+
+private:
+	struct Readback
+	{
+		Generation generation;
+		uint64_t requestKey;
+	};
+
+	typedef std::pair<const void*, int> ConsumerAOV;
+
+	mutable std::mutex m_mutex;
+
+	Generation m_generation;
+
+	std::map<int, Generation> m_resolved;
+	std::map<ConsumerAOV, Readback> m_readbacks;
+	std::map<int, std::set<const void*>> m_subscribers;
+};
@@ -0,0 +1,69 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "AdaptiveIterations.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace AdaptiveIterations
+{
+
+namespace
+{
+	int Clamp(const Settings& settings, double iterations)
+	{
+		int maxIterations = std::max(settings.minIterations, settings.maxIterations);
+
+		if (!(iterations >= settings.minIterations))
+			return settings.minIterations;
+
+		if (iterations >= maxIterations)
+			return maxIterations;
+
+		return int(iterations);
+	}
+}
+
+State Interact(const Settings& settings, const State& state)
+{
+	State result = state;
+	result.iterations = Clamp(settings, settings.minIterations);
+
+	return result;
+}
+
+State Update(const Settings& settings, const State& state, double milliseconds)
+{
+	State result = state;
+
+	if (state.iterations <= 0 || !(milliseconds >= 0.0))
+		return result;
+
+	double measured = milliseconds / state.iterations;
+
+	if (state.millisecondsPerIteration <= 0.0 || measured > state.millisecondsPerIteration)
+		result.millisecondsPerIteration = measured;
+	else
+		result.millisecondsPerIteration = state.millisecondsPerIteration + settings.smoothing * (measured - state.millisecondsPerIteration);
+
+	double fitting = result.millisecondsPerIteration > 0.0 ?
+		std::floor(settings.targetMilliseconds / result.millisecondsPerIteration) : double(settings.maxIterations);
+
+	double growthLimit = std::ceil(state.iterations * std::max(1.0, settings.maxGrowth));
+
+	result.iterations = Clamp(settings, std::min(fitting, growthLimit));
+
+	return result;
+}
+
+}
@@ -0,0 +1,51 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+/** Iterations per interactive render call.
+	Each render call is timed and the iteration count of the next call is chosen so a call
+	takes about the target refresh time: light scenes make fewer round trips, heavy scenes do
+	not stall the viewport. Any interaction drops back to the minimum and the count ramps up
+	again by a bounded factor per call once interaction stops.
+	Functions are pure, the caller keeps the State. */
+namespace AdaptiveIterations
+{
+	struct Settings
+	{
+		double targetMilliseconds = 40.0;
+
+		int minIterations = 1;
+		int maxIterations = 64;
+
+		// iterations of the next call are at most this times the current ones
+		double maxGrowth = 2.0;
+
+		// weight of a new measurement when the cost per iteration goes down;
+		// increases are taken at once so slow calls are corrected in the next call
+		double smoothing = 0.5;
+	};
+
+	struct State
+	{
+		int iterations = 1;
+
+		// estimated cost of one iteration, 0 until the first measurement
+		double millisecondsPerIteration = 0.0;
+	};
+
+	// Scene or camera changed
+	State Interact(const Settings& settings, const State& state);
+
+	// A render call with state.iterations iterations took the given time, returns the state for the next call
+	State Update(const Settings& settings, const State& state, double milliseconds);
+}
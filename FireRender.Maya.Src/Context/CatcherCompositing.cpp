@@ -0,0 +1,133 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "CatcherCompositing.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace CatcherCompositing
+{
+
+namespace
+{
+	const unsigned int Channels = 4;
+
+	struct Constants
+	{
+		// shadowTransparency * (1 - shadowColor)
+		float shadowFactor[3];
+
+		// backgroundTransparency * backgroundColor
+		float backgroundFactor[3];
+		float backgroundAlpha;
+	};
+
+	// Shadow catcher:
+	//   background * (1 - min(opacity + sc * shadowTransp * (1 - shadowColor), 1)) * bgTransp * bgColor + color * opacity
+	// Reflection catcher:
+	//   background * (1 - opacity) * bgTransp * bgColor + color * (opacity + rc)
+	// Both catchers:
+	//   background * (1 - min(opacity + sc * ..., 1)) * bgTransp * bgColor + color * (opacity + rc)
+	// Alpha of the composites is background alpha * bgTransp plus color alpha * rc alpha with the reflection catcher.
+	template <bool Shadow, bool Reflection>
+	void CompositeRow(float* out, const float* color, const float* opacity, const float* background,
+		const float* shadowCatcher, const float* reflectionCatcher, unsigned int width, const Constants& constants)
+	{
+		for (size_t x = 0; x < size_t(width) * Channels; x += Channels)
+		{
+			for (unsigned int c = 0; c < 3; c++)
+			{
+				float coverage = opacity[x + c];
+
+				if (Shadow)
+					coverage = coverage + shadowCatcher[x + c] * constants.shadowFactor[c];
+
+				float backgroundVisibility = 1.0f - (Shadow ? std::min(coverage, 1.0f) : coverage);
+				float colorWeight = Reflection ? opacity[x + c] + reflectionCatcher[x + c] : opacity[x + c];
+
+				out[x + c] = background[x + c] * constants.backgroundFactor[c] * backgroundVisibility + color[x + c] * colorWeight;
+			}
+
+			float alpha = background[x + 3] * constants.backgroundAlpha;
+
+			if (Reflection)
+				alpha = alpha + color[x + 3] * reflectionCatcher[x + 3];
+
+			out[x + 3] = alpha;
+		}
+	}
+
+	template <bool Shadow, bool Reflection>
+	void CompositeRegion(const Request& request, const Constants& constants)
+	{
+		const size_t sourceStride = size_t(request.sourceWidth) * Channels;
+		const size_t destinationStride = size_t(request.width) * Channels;
+
+		// first frame buffer row of the region
+		const size_t firstRow = request.sourceHeight - 1 - request.top;
+
+		const int rowCount = int(request.height);
+
+#pragma omp parallel for schedule(static) if (size_t(request.width) * request.height >= 16 * 1024)
+		for (int y = 0; y < rowCount; y++)
+		{
+			size_t offset = (firstRow + y) * sourceStride + size_t(request.left) * Channels;
+
+			CompositeRow<Shadow, Reflection>(request.destination + size_t(y) * destinationStride,
+				request.inputs[Color] + offset,
+				request.inputs[Opacity] + offset,
+				request.inputs[Background] + offset,
+				Shadow ? request.inputs[ShadowCatcher] + offset : nullptr,
+				Reflection ? request.inputs[ReflectionCatcher] + offset : nullptr,
+				request.width,
+				constants);
+		}
+	}
+}
+
+bool Composite(const Request& request)
+{
+	if (!request.inputs[Color] || !request.inputs[Opacity] || !request.inputs[Background] || !request.destination)
+		return false;
+
+	if (request.width == 0 || request.height == 0 || request.left + request.width > request.sourceWidth ||
+		request.top >= request.sourceHeight || request.height > request.top + 1)
+		return false;
+
+	// Constant composites multiply in the same order as the chains
+	Constants constants;
+
+	for (unsigned int c = 0; c < 3; c++)
+	{
+		constants.shadowFactor[c] = request.shadowTransparency * (1.0f - request.shadowColor[c]);
+		constants.backgroundFactor[c] = request.backgroundTransparency * request.backgroundColor[c];
+	}
+
+	constants.backgroundAlpha = request.backgroundTransparency;
+
+	bool shadow = request.inputs[ShadowCatcher] != nullptr;
+	bool reflection = request.inputs[ReflectionCatcher] != nullptr;
+
+	if (shadow && reflection)
+		CompositeRegion<true, true>(request, constants);
+	else if (shadow)
+		CompositeRegion<true, false>(request, constants);
+	else if (reflection)
+		CompositeRegion<false, true>(request, constants);
+	else
+		return false;
+
+	return true;
+}
+
+}
@@ -0,0 +1,58 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+/** CPU compositing of shadow and reflection catcher AOVs.
+	Produces the image of the RPR composite chains in FireRenderContext, but reads every
+	input pixel once and writes the cropped region directly, without full frame intermediates.
+	Constant factors of the chains are folded, so results match them up to float rounding. */
+namespace CatcherCompositing
+{
+	// RGBA float frame buffers of the same size
+	enum Input
+	{
+		Color,
+		Opacity,
+		Background,
+		ShadowCatcher,
+		ReflectionCatcher,
+		InputCount
+	};
+
+	struct Request
+	{
+		// ShadowCatcher and ReflectionCatcher may be null, the catcher is not composited then
+		const float* inputs[InputCount] = {};
+		unsigned int sourceWidth = 0;
+		unsigned int sourceHeight = 0;
+
+		// Region as in RenderRegion, rows are written in frame buffer order
+		unsigned int left = 0;
+		unsigned int top = 0;
+		unsigned int width = 0;
+		unsigned int height = 0;
+
+		// width * height RGBA floats
+		float* destination = nullptr;
+
+		float shadowColor[3] = { 0.0f, 0.0f, 0.0f };
+		float backgroundColor[3] = { 1.0f, 1.0f, 1.0f };
+
+		// weight minus transparency, as passed to the composites
+		float shadowTransparency = 1.0f;
+		float backgroundTransparency = 1.0f;
+	};
+
+	// Returns false if the request is invalid
+	bool Composite(const Request& request);
+}
@@ -0,0 +1,368 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "ContextWorkTracer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+ContextWorkTracer& ContextWorkTracer::Instance()
+{
+	static ContextWorkTracer instance;
+	return instance;
+}
+
+ContextWorkTracer::ContextWorkTracer() :
+	m_enabled(false),
+	m_startTime(Clock::now()),
+	m_closingOffset(0)
+{
+}
+
+void ContextWorkTracer::EnableFromEnvironment()
+{
+	const char* path = std::getenv("RPR_MAYA_SYNC_TRACE_OUTPUT");
+
+	if (path && path[0] != '\0')
+	{
+		Enable(path);
+	}
+}
+
+void ContextWorkTracer::Enable(const std::string& outputPath)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_outputPath = outputPath;
+	m_closingOffset = 0;
+	m_enabled = true;
+}
+
+void ContextWorkTracer::Disable()
+{
+	m_enabled = false;
+}
+
+void ContextWorkTracer::SetOwnerName(const void* owner, const std::string& name)
+{
+	if (!IsEnabled())
+		return;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	unsigned int processId = GetProcessId(owner);
+
+	m_processNames[processId] = name;
+	m_changedProcessNames[processId] = name;
+}
+
+void ContextWorkTracer::Begin(const void* owner, const char* category, const std::string& name, const std::string& objectType, long long index, long long count)
+{
+	if (!IsEnabled())
+		return;
+
+	Event ev;
+	ev.phase = Phase::Begin;
+	ev.category = category;
+	ev.name = name;
+	ev.objectType = objectType;
+	ev.index = index;
+	ev.count = count;
+
+	Record(std::move(ev), owner);
+}
+
+void ContextWorkTracer::End(const void* owner, const char* category, const std::string& name)
+{
+	if (!IsEnabled())
+		return;
+
+	Event ev;
+	ev.phase = Phase::End;
+	ev.category = category;
+	ev.name = name;
+
+	Record(std::move(ev), owner);
+}
+
+void ContextWorkTracer::Instant(const void* owner, const char* category, const std::string& name, long long index, long long count)
+{
+	if (!IsEnabled())
+		return;
+
+	Event ev;
+	ev.phase = Phase::Instant;
+	ev.category = category;
+	ev.name = name;
+	ev.index = index;
+	ev.count = count;
+
+	Record(std::move(ev), owner);
+}
+
+void ContextWorkTracer::Complete(const void* owner, const char* category, const std::string& name, long long durationMs)
+{
+	if (!IsEnabled())
+		return;
+
+	Event ev;
+	ev.phase = Phase::Complete;
+	ev.category = category;
+	ev.name = name;
+	ev.durationUs = durationMs * 1000;
+
+	Record(std::move(ev), owner);
+}
+
+long long ContextWorkTracer::NowUs() const
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_startTime).count();
+}
+
+unsigned int ContextWorkTracer::GetProcessId(const void* owner)
+{
+	auto it = m_processIds.find(owner);
+
+	if (it != m_processIds.end())
+		return it->second;
+
+	unsigned int id = (unsigned int) m_processIds.size() + 1;
+	m_processIds[owner] = id;
+
+	return id;
+}
+
+unsigned int ContextWorkTracer::GetThreadId(std::thread::id id)
+{
+	auto it = m_threadIds.find(id);
+
+	if (it != m_threadIds.end())
+		return it->second;
+
+	unsigned int tid = (unsigned int) m_threadIds.size() + 1;
+	m_threadIds[id] = tid;
+
+	return tid;
+}
+
+void ContextWorkTracer::Record(Event&& ev, const void* owner)
+{
+	long long now = NowUs();
+	bool shouldFlush = false;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// complete event is reported when it is done, viewer expects its start time
+		ev.timestampUs = (ev.phase == Phase::Complete) ? now - ev.durationUs : now;
+		ev.processId = GetProcessId(owner);
+		ev.threadId = GetThreadId(std::this_thread::get_id());
+
+		m_events.push_back(std::move(ev));
+
+		if (m_events.size() >= MaxBufferedEvents)
+		{
+			if (m_outputPath.empty())
+				m_events.erase(m_events.begin(), m_events.begin() + MaxBufferedEvents / 2);
+			else
+				shouldFlush = true;
+		}
+	}
+
+	if (shouldFlush)
+		Flush();
+}
+
+namespace
+{
+	const char TraceOpening[] = "{\"traceEvents\":[";
+	const char TraceClosing[] = "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+bool ContextWorkTracer::Flush()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_outputPath.empty())
+		return false;
+
+	bool started = m_closingOffset > 0;
+
+	// new events overwrite the closing of the array written by the previous flush
+	std::fstream out;
+
+	if (started)
+	{
+		out.open(m_outputPath, std::ios::in | std::ios::out | std::ios::binary);
+		out.seekp(m_closingOffset);
+	}
+	else
+	{
+		out.open(m_outputPath, std::ios::out | std::ios::trunc | std::ios::binary);
+		out << TraceOpening;
+	}
+
+	if (!out)
+	{
+		StopOnError();
+		return false;
+	}
+
+	WriteEvents(out, !started || m_closingOffset == (long long) (sizeof(TraceOpening) - 1), !started);
+
+	long long closingOffset = (long long) out.tellp();
+	out << TraceClosing;
+	out.flush();
+
+	if (!out.good())
+	{
+		StopOnError();
+		return false;
+	}
+
+	m_closingOffset = closingOffset;
+	m_events.clear();
+	m_changedProcessNames.clear();
+
+	return true;
+}
+
+void ContextWorkTracer::StopOnError()
+{
+	// the output can't take more events: keep what was written last, don't buffer without bound
+	m_enabled = false;
+	m_events.clear();
+	m_events.shrink_to_fit();
+}
+
+void ContextWorkTracer::WriteEscaped(std::ostream& out, const std::string& str)
+{
+	out << '"';
+
+	for (unsigned char c : str)
+	{
+		switch (c)
+		{
+		case '"': out << "\\\""; break;
+		case '\\': out << "\\\\"; break;
+		case '\n': out << "\\n"; break;
+		case '\r': out << "\\r"; break;
+		case '\t': out << "\\t"; break;
+		default:
+			if (c < 0x20)
+			{
+				char buf[8];
+				snprintf(buf, sizeof(buf), "\\u%04x", c);
+				out << buf;
+			}
+			else
+			{
+				out << c;
+			}
+		}
+	}
+
+	out << '"';
+}
+
+void ContextWorkTracer::WriteJson(std::ostream& out) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	out << TraceOpening;
+	WriteEvents(out, true, true);
+	out << TraceClosing;
+}
+
+void ContextWorkTracer::WriteEvents(std::ostream& out, bool first, bool allProcessNames) const
+{
+	auto separator = [&out, &first]()
+	{
+		out << (first ? "\n" : ",\n");
+		first = false;
+	};
+
+	for (const auto& it : allProcessNames ? m_processNames : m_changedProcessNames)
+	{
+		separator();
+		out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << it.first << ",\"tid\":0,\"args\":{\"name\":";
+		WriteEscaped(out, it.second);
+		out << "}}";
+	}
+
+	for (const Event& ev : m_events)
+	{
+		separator();
+
+		out << "{\"name\":";
+		WriteEscaped(out, ev.name);
+		out << ",\"cat\":";
+		WriteEscaped(out, ev.category);
+		out << ",\"ph\":\"" << static_cast<char>(ev.phase) << "\"";
+		out << ",\"ts\":" << ev.timestampUs;
+
+		if (ev.phase == Phase::Complete)
+		{
+			out << ",\"dur\":" << ev.durationUs;
+		}
+		else if (ev.phase == Phase::Instant)
+		{
+			out << ",\"s\":\"t\"";
+		}
+
+		out << ",\"pid\":" << ev.processId << ",\"tid\":" << ev.threadId;
+
+		bool hasArgs = !ev.objectType.empty() || ev.index >= 0 || ev.count >= 0;
+		if (hasArgs)
+		{
+			const char* argSeparator = "";
+			out << ",\"args\":{";
+
+			if (!ev.objectType.empty())
+			{
+				out << "\"type\":";
+				WriteEscaped(out, ev.objectType);
+				argSeparator = ",";
+			}
+
+			if (ev.index >= 0)
+			{
+				out << argSeparator << "\"index\":" << ev.index;
+				argSeparator = ",";
+			}
+
+			if (ev.count >= 0)
+			{
+				out << argSeparator << "\"count\":" << ev.count;
+			}
+
+			out << "}";
+		}
+
+		out << "}";
+	}
+}
+
+std::vector<ContextWorkTracer::Event> ContextWorkTracer::GetEvents() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_events;
+}
+
+void ContextWorkTracer::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_events.clear();
+}
@@ -0,0 +1,134 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** Records sync and render work of the render contexts and writes it as Chrome trace JSON
+	(chrome://tracing, https://ui.perfetto.dev).
+
+	Tracing is off by default. It is switched on by setting RPR_MAYA_SYNC_TRACE_OUTPUT environment
+	variable to the output .json file path before plugin load. While disabled every entry point
+	returns after a single relaxed atomic load, so the hooks can stay in hot code.
+
+	Each traced FireRenderContext gets its own "process" row in the viewer, threads are numbered
+	in the order they were first seen.
+*/
+class ContextWorkTracer
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	enum class Phase : char
+	{
+		Begin = 'B',
+		End = 'E',
+		Complete = 'X',
+		Instant = 'i'
+	};
+
+	struct Event
+	{
+		Phase phase = Phase::Instant;
+		std::string name;
+		std::string category;
+		std::string objectType;
+		long long timestampUs = 0;
+		long long durationUs = 0;
+		unsigned int processId = 0;
+		unsigned int threadId = 0;
+		long long index = -1;
+		long long count = -1;
+	};
+
+public:
+	static ContextWorkTracer& Instance();
+
+	static bool IsEnabled() { return Instance().m_enabled.load(std::memory_order_relaxed); }
+
+	// Reads RPR_MAYA_SYNC_TRACE_OUTPUT and enables tracing if it is set
+	void EnableFromEnvironment();
+
+	void Enable(const std::string& outputPath);
+	void Disable();
+
+	// Registers (or renames) the trace row used for events of the owner
+	void SetOwnerName(const void* owner, const std::string& name);
+
+	void Begin(const void* owner, const char* category, const std::string& name, const std::string& objectType = std::string(), long long index = -1, long long count = -1);
+	void End(const void* owner, const char* category, const std::string& name);
+	void Instant(const void* owner, const char* category, const std::string& name, long long index = -1, long long count = -1);
+
+	// Records an event which finished now and took durationMs
+	void Complete(const void* owner, const char* category, const std::string& name, long long durationMs);
+
+	// Appends recorded events to the output path set in Enable and clears them. The file is valid JSON after each call.
+	// If the output can't be written tracing is disabled and the recorded events are dropped.
+	bool Flush();
+
+	// Writes events recorded since the last flush as a complete trace
+	void WriteJson(std::ostream& out) const;
+
+	std::vector<Event> GetEvents() const;
+	void Clear();
+
+	// Events kept between flushes. When they don't fit they are flushed, or the oldest are dropped if there is no output path.
+	static const size_t MaxBufferedEvents = 1 << 20;
+
+private:
+	ContextWorkTracer();
+
+	ContextWorkTracer(const ContextWorkTracer&) = delete;
+	ContextWorkTracer& operator=(const ContextWorkTracer&) = delete;
+
+	long long NowUs() const;
+
+	// both expect m_mutex to be locked
+	unsigned int GetProcessId(const void* owner);
+	unsigned int GetThreadId(std::thread::id id);
+
+	void Record(Event&& ev, const void* owner);
+
+	// expects m_mutex to be locked, called when the output failed
+	void StopOnError();
+
+	// expects m_mutex to be locked, writes process names changed since the last flush and the events
+	void WriteEvents(std::ostream& out, bool first, bool allProcessNames) const;
+
+	static void WriteEscaped(std::ostream& out, const std::string& str);
+
+private:
+	std::atomic<bool> m_enabled;
+
+	mutable std::mutex m_mutex;
+
+	std::string m_outputPath;
+	Clock::time_point m_startTime;
+
+	std::vector<Event> m_events;
+
+	// output file offset of the closing of the trace events array, 0 until the file is started
+	long long m_closingOffset;
+
+	std::map<const void*, unsigned int> m_processIds;
+	std::map<unsigned int, std::string> m_processNames;
+	std::map<unsigned int, std::string> m_changedProcessNames;
+	std::map<std::thread::id, unsigned int> m_threadIds;
+};
@@ -0,0 +1,249 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "DirtyObjectStaging.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <unordered_set>
+
+struct DirtyObjectStaging::Table
+{
+	// open addressing with linear probing, null is a free slot
+	std::atomic<FireRenderObject*> slots[SlotCount];
+
+	// Stage calls inserting into this table right now
+	std::atomic<unsigned int> stagers;
+
+	Table() : stagers(0)
+	{
+		for (auto& slot : slots)
+			slot.store(nullptr, std::memory_order_relaxed);
+	}
+};
+
+namespace
+{
+	// a slot of a discarded object, never a valid object address
+	FireRenderObject* const Discarded = reinterpret_cast<FireRenderObject*>(uintptr_t(1));
+
+	// slots tried before an object goes to the overflow list
+	const size_t MaxProbes = 32;
+
+	const unsigned int SlotBits = 12;
+	static_assert(size_t(1) << SlotBits == DirtyObjectStaging::SlotCount, "SlotBits don't match SlotCount");
+
+	// Fibonacci hashing, the top bits of the product depend on all bits of the address
+	size_t FirstSlot(FireRenderObject* object)
+	{
+		uint64_t hash = uint64_t(uintptr_t(object)) * 0x9E3779B97F4A7C15ull;
+		return size_t(hash >> (64 - SlotBits));
+	}
+
+	// Sorted for binary search
+	const char* const IgnoredAttributes[] =
+	{
+		"backfaceCulling",
+		"binMembership",
+		"displayBorders",
+		"displayCenter",
+		"displayColors",
+		"displayEdges",
+		"displayHandle",
+		"displayLocalAxis",
+		"displayNormal",
+		"displayRotatePivot",
+		"displayScalePivot",
+		"displayTriangles",
+		"displayUVs",
+		"displayVertices",
+		"ghosting",
+		"hiddenInOutliner",
+		"isHistoricallyInteresting",
+		"normalSize",
+		"objectColor",
+		"objectColorRGB",
+		"outlinerColor",
+		"overrideColor",
+		"overrideColorRGB",
+		"overrideDisplayType",
+		"overrideLevelOfDetail",
+		"overrideRGBColors",
+		"overrideShading",
+		"overrideTexturing",
+		"selectionChildHighlighting",
+		"showManipDefault",
+		"specifiedManipLocation",
+		"uiTreatment",
+		"useObjectColor",
+		"useOutlinerColor",
+		"uvSize",
+		"vertexSize",
+		"wireColorRGB",
+	};
+}
+
+DirtyObjectStaging::DirtyObjectStaging() :
+	m_pending(0),
+	m_overflowLocks(0)
+{
+	m_tables[0] = std::make_unique<Table>();
+	m_tables[1] = std::make_unique<Table>();
+	m_current.store(m_tables[0].get());
+}
+
+DirtyObjectStaging::~DirtyObjectStaging()
+{
+}
+
+void DirtyObjectStaging::Stage(FireRenderObject* object)
+{
+	Table* table = m_current.load();
+
+	// announce the insert, then make sure Flush didn't switch tables in between;
+	// Flush waits for announced inserts before it reads the table
+	for (;;)
+	{
+		table->stagers.fetch_add(1);
+
+		Table* current = m_current.load();
+		if (current == table)
+			break;
+
+		table->stagers.fetch_sub(1);
+		table = current;
+	}
+
+	size_t slot = FirstSlot(object);
+	bool staged = false;
+
+	for (size_t probe = 0; probe < MaxProbes && !staged; probe++, slot = (slot + 1) & (SlotCount - 1))
+	{
+		FireRenderObject* value = table->slots[slot].load(std::memory_order_acquire);
+
+		if (value == nullptr)
+		{
+			if (table->slots[slot].compare_exchange_strong(value, object, std::memory_order_acq_rel))
+			{
+				m_pending.fetch_add(1, std::memory_order_release);
+				staged = true;
+				break;
+			}
+		}
+
+		// already staged, possibly by another thread just now
+		staged = value == object;
+	}
+
+	if (!staged)
+	{
+		std::lock_guard<std::mutex> lock(m_overflowMutex);
+		m_overflowLocks.fetch_add(1, std::memory_order_relaxed);
+
+		m_overflow.push_back(object);
+		m_pending.fetch_add(1, std::memory_order_release);
+	}
+
+	table->stagers.fetch_sub(1);
+}
+
+void DirtyObjectStaging::Discard(FireRenderObject* object)
+{
+	std::lock_guard<std::mutex> lock(m_flushMutex);
+
+	// the other table is empty while no flush runs
+	Table* table = m_current.load();
+	size_t slot = FirstSlot(object);
+
+	for (size_t probe = 0; probe < MaxProbes; probe++, slot = (slot + 1) & (SlotCount - 1))
+	{
+		FireRenderObject* value = object;
+
+		if (table->slots[slot].compare_exchange_strong(value, Discarded, std::memory_order_acq_rel))
+		{
+			m_pending.fetch_sub(1, std::memory_order_release);
+			break;
+		}
+
+		if (value == nullptr)
+			break;
+	}
+
+	std::lock_guard<std::mutex> overflowLock(m_overflowMutex);
+
+	auto end = std::remove(m_overflow.begin(), m_overflow.end(), object);
+	m_pending.fetch_sub(size_t(m_overflow.end() - end), std::memory_order_release);
+	m_overflow.erase(end, m_overflow.end());
+}
+
+void DirtyObjectStaging::Flush(std::vector<FireRenderObject*>& objects)
+{
+	std::lock_guard<std::mutex> lock(m_flushMutex);
+
+	Table* table = m_current.load();
+	m_current.store(table == m_tables[0].get() ? m_tables[1].get() : m_tables[0].get());
+
+	// Stage calls which announced themselves on the previous table before the switch
+	while (table->stagers.load() != 0)
+		std::this_thread::yield();
+
+	size_t first = objects.size();
+	size_t taken = 0;
+
+	for (auto& slot : table->slots)
+	{
+		FireRenderObject* value = slot.load(std::memory_order_acquire);
+
+		if (value == nullptr)
+			continue;
+
+		if (value != Discarded)
+		{
+			objects.push_back(value);
+			taken++;
+		}
+
+		slot.store(nullptr, std::memory_order_relaxed);
+	}
+
+	std::vector<FireRenderObject*> overflow;
+	{
+		std::lock_guard<std::mutex> overflowLock(m_overflowMutex);
+		overflow.swap(m_overflow);
+	}
+
+	taken += overflow.size();
+	m_pending.fetch_sub(taken, std::memory_order_release);
+
+	if (!overflow.empty())
+	{
+		// overflowed objects can be in the table or overflow several times
+		std::unordered_set<FireRenderObject*> unique(objects.begin() + first, objects.end());
+
+		for (FireRenderObject* object : overflow)
+		{
+			if (unique.insert(object).second)
+				objects.push_back(object);
+		}
+	}
+}
+
+bool DirtyObjectStaging::IsIgnoredAttribute(const char* name)
+{
+	if (name == nullptr)
+		return false;
+
+	return std::binary_search(std::begin(IgnoredAttributes), std::end(IgnoredAttributes), name,
+		[](const char* a, const char* b) { return std::strcmp(a, b) < 0; });
+}
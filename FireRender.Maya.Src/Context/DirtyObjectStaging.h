@@ -0,0 +1,77 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class FireRenderObject;
+
+/** Collects objects marked dirty by Maya callbacks between two refreshes.
+
+	Dragging a slider or scrubbing a rig fires thousands of dirty callbacks, mostly for the
+	same few objects. Stage inserts into an open addressing table of atomic slots with a
+	compare and swap, so an object already staged costs a few reads and callbacks never wait
+	for each other or for the dirty list of the context. Flush switches Stage to a second
+	table and takes the objects of the first one, waiting only for Stage calls still on it.
+	Objects which don't fit into the table go to an overflow list behind a mutex.
+	Objects are only used as keys here, they are never dereferenced.
+*/
+class DirtyObjectStaging
+{
+public:
+	// Slots of a table; staging up to about half of it between two flushes takes no lock
+	static const size_t SlotCount = 4096;
+
+	DirtyObjectStaging();
+	~DirtyObjectStaging();
+
+	DirtyObjectStaging(const DirtyObjectStaging&) = delete;
+	DirtyObjectStaging& operator=(const DirtyObjectStaging&) = delete;
+
+	// Can be called from any thread
+	void Stage(FireRenderObject* object);
+
+	// The object is being destroyed, it must not come out of the next flush
+	void Discard(FireRenderObject* object);
+
+	// Appends objects staged since the previous flush, each object once
+	void Flush(std::vector<FireRenderObject*>& objects);
+
+	bool HasPending() const { return m_pending.load(std::memory_order_acquire) > 0; }
+
+	// Times Stage took the overflow mutex because the table was full
+	size_t OverflowLockCount() const { return m_overflowLocks.load(std::memory_order_relaxed); }
+
+	// Attributes which only change how Maya draws or lists a node (wireframe colour, outliner,
+	// component display), changing them never requires a sync. Takes the long attribute name.
+	static bool IsIgnoredAttribute(const char* name);
+
+private:
+	struct Table;
+
+	// Flush and Discard
+	std::mutex m_flushMutex;
+
+	std::unique_ptr<Table> m_tables[2];
+	std::atomic<Table*> m_current;
+
+	std::mutex m_overflowMutex;
+	std::vector<FireRenderObject*> m_overflow;
+
+	std::atomic<size_t> m_pending;
+	std::atomic<size_t> m_overflowLocks;
+};
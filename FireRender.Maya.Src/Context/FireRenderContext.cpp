@@ -21,6 +21,7 @@ limitations under the License.
 #include <maya/MFnMeshData.h>
 #include <maya/MFnMesh.h>
 #include <maya/MFnLight.h>
+#include <maya/MFnCamera.h>
 #include <maya/MSelectionList.h>
 #include <maya/MImage.h>
 #include <maya/MItDag.h>
@@ -30,6 +31,8 @@ limitations under the License.
 #include <maya/MItDependencyNodes.h>
 #include <maya/MUserEventMessage.h>
 #include <maya/MItDependencyGraph.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MFnMatrixData.h>
 
 #include "AutoLock.h"
 #include "VRay.h"
@@ -40,8 +43,18 @@ limitations under the License.
 #include <fstream>
 
 #include "FireRenderThread.h"
+#include "ContextWorkTracer.h"
+#include "PixelReadback.h"
+#include "CatcherCompositing.h"
+#include "TiledDenoise.h"
+#include "WorldMatrixHierarchy.h"
+#include "ObjectHandleMap.h"
+#include "TextureResolution.h"
+#include "TextureDiskCache.h"
+#include "Fnv1a.h"
 #include "FireRenderMaterialSwatchRender.h"
 #include "CompositeWrapper.h"
+#include "Translators/MeshTranslator.h"
 
 #ifdef WIN32 // alembic support is disabled on MAC until alembic build issue on MAC is resolved
 #include "FireRenderGPUCache.h"
@@ -113,6 +126,8 @@ FireRenderContext::FireRenderContext() :
 	m_RenderType(RenderType::Undefined),
 	m_bIsGLTFExport(false),
 	m_IterationsPowerOf2Mode(false),
+	m_textureSizeLimit(0),
+	m_textureSizeLimitSelected(false),
 	m_DisableSetDirtyObjects(false)
 {
 	DebugPrint("FireRenderContext::FireRenderContext()");
@@ -237,6 +252,8 @@ void FireRenderContext::initBuffersForAOV(frw::Context& context, int index, rpr_
 {
 	rpr_framebuffer_format fmt = { 4, RPR_COMPONENT_TYPE_FLOAT32 };
 
+	m_aovResolveTracker.Invalidate(index);
+
 	m.framebufferAOV[index].Reset();
 	m.framebufferAOV_resolved[index].Reset();
 
@@ -319,6 +336,11 @@ bool FireRenderContext::buildScene(bool isViewport, bool glViewport, bool freshe
 
 	m_globals.readFromCurrentScene();
 
+	TextureDiskCache::Instance().Configure(m_globals.textureCachePath.asUTF8(),
+		(unsigned long long) std::max(0, m_globals.textureDiskCacheSize) << 20);
+
+	FireMaya::MeshTranslator::SetCompactionEnabled(m_globals.meshCompaction);
+
 	// Backdoor for enabling aovs in IPR/Viewport
 	if (isInteractive())
 	{
@@ -591,96 +613,154 @@ bool FireRenderContext::setupDenoiserForViewport()
 
 void FireRenderContext::setupDenoiserRAM()
 {
-	bool canCreateAiDenoiser = CanCreateAiDenoiser();
-	bool useOpenImageDenoise = !canCreateAiDenoiser;
-
 	std::uint32_t width = m_useRegion ? (uint32_t)m_region.getWidth() : (uint32_t)m_pixelBuffers[RPR_AOV_COLOR].width();
 	std::uint32_t height = m_useRegion ? (uint32_t)m_region.getHeight() : (uint32_t)m_pixelBuffers[RPR_AOV_COLOR].height();
-	size_t rifImageSize = sizeof(RV_PIXEL) * width * height;
 
 	try
 	{
-		MString mlModelsFolder = GetModelPath();
+		m_denoiserFilter = CreateDenoiserRAM(width, height, [this](int aov) { return m_pixelBuffers[aov].data(); });
+	}
+	catch (std::exception& e)
+	{
+		m_denoiserFilter.reset();
+		ErrorPrint(e.what());
+		MGlobal::displayError("RPR failed to setup denoiser, turning it off.");
+	}
+}
 
-		m_denoiserFilter = std::shared_ptr<ImageFilter>(new ImageFilter(
-			context(), 
-			width,
-			height,
-			mlModelsFolder.asChar()
-		));
+namespace
+{
+	struct DenoiserInput
+	{
+		RifFilterInput input;
+		int aov;
+		float sigma;
+	};
 
-		RifParam p;
+	// Inputs of the RAM denoiser, in the order they are added to the filter
+	std::vector<DenoiserInput> GetDenoiserInputs(const DenoiserSettings& settings)
+	{
+		std::vector<DenoiserInput> inputs;
 
-		switch (m_globals.denoiserSettings.type)
+		switch (settings.type)
 		{
 		case FireRenderGlobals::kBilateral:
-			m_denoiserFilter->CreateFilter(RifFilterType::BilateralDenoise);
-			m_denoiserFilter->AddInput(RifColor, m_pixelBuffers[RPR_AOV_COLOR].data(), rifImageSize, 0.3f);
-			m_denoiserFilter->AddInput(RifNormal, m_pixelBuffers[RPR_AOV_SHADING_NORMAL].data(), rifImageSize, 0.01f);
-			m_denoiserFilter->AddInput(RifWorldCoordinate, m_pixelBuffers[RPR_AOV_WORLD_COORDINATE].data(), rifImageSize, 0.01f);
-
-			p = { RifParamType::RifInt, m_globals.denoiserSettings.radius };
-			m_denoiserFilter->AddParam("radius", p);
+			inputs.push_back({ RifColor, RPR_AOV_COLOR, 0.3f });
+			inputs.push_back({ RifNormal, RPR_AOV_SHADING_NORMAL, 0.01f });
+			inputs.push_back({ RifWorldCoordinate, RPR_AOV_WORLD_COORDINATE, 0.01f });
 			break;
 
 		case FireRenderGlobals::kLWR:
-			m_denoiserFilter->CreateFilter(RifFilterType::LwrDenoise);
-			m_denoiserFilter->AddInput(RifColor, m_pixelBuffers[RPR_AOV_COLOR].data(), rifImageSize, 0.1f);
-			m_denoiserFilter->AddInput(RifNormal, m_pixelBuffers[RPR_AOV_SHADING_NORMAL].data(), rifImageSize, 0.1f);
-			m_denoiserFilter->AddInput(RifDepth, m_pixelBuffers[RPR_AOV_DEPTH].data(), rifImageSize, 0.1f);
-			m_denoiserFilter->AddInput(RifWorldCoordinate, m_pixelBuffers[RPR_AOV_WORLD_COORDINATE].data(), rifImageSize, 0.1f);
-			m_denoiserFilter->AddInput(RifObjectId, m_pixelBuffers[RPR_AOV_OBJECT_ID].data(), rifImageSize, 0.1f);
-			m_denoiserFilter->AddInput(RifTrans, m_pixelBuffers[RPR_AOV_OBJECT_ID].data(), rifImageSize, 0.1f);
-
-			p = { RifParamType::RifInt, m_globals.denoiserSettings.samples };
-			m_denoiserFilter->AddParam("samples", p);
-
-			p = { RifParamType::RifInt,  m_globals.denoiserSettings.filterRadius };
-			m_denoiserFilter->AddParam("halfWindow", p);
-
-			p.mType = RifParamType::RifFloat;
-			p.mData.f = m_globals.denoiserSettings.bandwidth;
-			m_denoiserFilter->AddParam("bandwidth", p);
+			inputs.push_back({ RifColor, RPR_AOV_COLOR, 0.1f });
+			inputs.push_back({ RifNormal, RPR_AOV_SHADING_NORMAL, 0.1f });
+			inputs.push_back({ RifDepth, RPR_AOV_DEPTH, 0.1f });
+			inputs.push_back({ RifWorldCoordinate, RPR_AOV_WORLD_COORDINATE, 0.1f });
+			inputs.push_back({ RifObjectId, RPR_AOV_OBJECT_ID, 0.1f });
+			inputs.push_back({ RifTrans, RPR_AOV_OBJECT_ID, 0.1f });
 			break;
 
 		case FireRenderGlobals::kEAW:
-			m_denoiserFilter->CreateFilter(RifFilterType::EawDenoise);
-			m_denoiserFilter->AddInput(RifColor, m_pixelBuffers[RPR_AOV_COLOR].data(), rifImageSize, m_globals.denoiserSettings.color);
-			m_denoiserFilter->AddInput(RifNormal, m_pixelBuffers[RPR_AOV_SHADING_NORMAL].data(), rifImageSize, m_globals.denoiserSettings.normal);
-			m_denoiserFilter->AddInput(RifDepth, m_pixelBuffers[RPR_AOV_DEPTH].data(), rifImageSize, m_globals.denoiserSettings.depth);
-			m_denoiserFilter->AddInput(RifTrans, m_pixelBuffers[RPR_AOV_OBJECT_ID].data(), rifImageSize, m_globals.denoiserSettings.trans);
-			m_denoiserFilter->AddInput(RifWorldCoordinate, m_pixelBuffers[RPR_AOV_WORLD_COORDINATE].data(), rifImageSize, 0.1f);
-			m_denoiserFilter->AddInput(RifObjectId, m_pixelBuffers[RPR_AOV_OBJECT_ID].data(), rifImageSize, 0.1f);
+			inputs.push_back({ RifColor, RPR_AOV_COLOR, settings.color });
+			inputs.push_back({ RifNormal, RPR_AOV_SHADING_NORMAL, settings.normal });
+			inputs.push_back({ RifDepth, RPR_AOV_DEPTH, settings.depth });
+			inputs.push_back({ RifTrans, RPR_AOV_OBJECT_ID, settings.trans });
+			inputs.push_back({ RifWorldCoordinate, RPR_AOV_WORLD_COORDINATE, 0.1f });
+			inputs.push_back({ RifObjectId, RPR_AOV_OBJECT_ID, 0.1f });
 			break;
 
 		case FireRenderGlobals::kML:
-		{
-			RifFilterType ft = m_globals.denoiserSettings.colorOnly ? RifFilterType::MlDenoiseColorOnly : RifFilterType::MlDenoise;
-			m_denoiserFilter->CreateFilter(ft, useOpenImageDenoise);
-		}
-		m_denoiserFilter->AddInput(RifColor, m_pixelBuffers[RPR_AOV_COLOR].data(), rifImageSize, 0.0f);
+			inputs.push_back({ RifColor, RPR_AOV_COLOR, 0.0f });
 
-		if (!m_globals.denoiserSettings.colorOnly)
-		{
-			m_denoiserFilter->AddInput(RifNormal, m_pixelBuffers[RPR_AOV_SHADING_NORMAL].data(), rifImageSize, 0.0f);
-			m_denoiserFilter->AddInput(RifDepth, m_pixelBuffers[RPR_AOV_DEPTH].data(), rifImageSize, 0.0f);
-			m_denoiserFilter->AddInput(RifAlbedo, m_pixelBuffers[RPR_AOV_DIFFUSE_ALBEDO].data(), rifImageSize, 0.0f);
-		}
-
-		break;
+			if (!settings.colorOnly)
+			{
+				inputs.push_back({ RifNormal, RPR_AOV_SHADING_NORMAL, 0.0f });
+				inputs.push_back({ RifDepth, RPR_AOV_DEPTH, 0.0f });
+				inputs.push_back({ RifAlbedo, RPR_AOV_DIFFUSE_ALBEDO, 0.0f });
+			}
+			break;
 
 		default:
 			assert(false);
 		}
 
-		m_denoiserFilter->AttachFilter();
+		return inputs;
 	}
-	catch (std::exception& e)
+}
+
+std::shared_ptr<ImageFilter> FireRenderContext::CreateDenoiserRAM(std::uint32_t width, std::uint32_t height, std::function<float*(int aov)> inputData)
+{
+	std::shared_ptr<ImageFilter> filter = CreateDenoiserFilterRAM(width, height);
+	AttachDenoiserInputsRAM(*filter, width, height, inputData);
+
+	return filter;
+}
+
+std::shared_ptr<ImageFilter> FireRenderContext::CreateDenoiserFilterRAM(std::uint32_t width, std::uint32_t height)
+{
+	bool canCreateAiDenoiser = CanCreateAiDenoiser();
+	bool useOpenImageDenoise = !canCreateAiDenoiser;
+
+	MString mlModelsFolder = GetModelPath();
+
+	std::shared_ptr<ImageFilter> filter = std::shared_ptr<ImageFilter>(new ImageFilter(
+		context(),
+		width,
+		height,
+		mlModelsFolder.asChar()
+	));
+
+	RifParam p;
+
+	switch (m_globals.denoiserSettings.type)
 	{
-		m_denoiserFilter.reset();
-		ErrorPrint(e.what());
-		MGlobal::displayError("RPR failed to setup denoiser, turning it off.");
+	case FireRenderGlobals::kBilateral:
+		filter->CreateFilter(RifFilterType::BilateralDenoise);
+
+		p = { RifParamType::RifInt, m_globals.denoiserSettings.radius };
+		filter->AddParam("radius", p);
+		break;
+
+	case FireRenderGlobals::kLWR:
+		filter->CreateFilter(RifFilterType::LwrDenoise);
+
+		p = { RifParamType::RifInt, m_globals.denoiserSettings.samples };
+		filter->AddParam("samples", p);
+
+		p = { RifParamType::RifInt,  m_globals.denoiserSettings.filterRadius };
+		filter->AddParam("halfWindow", p);
+
+		p.mType = RifParamType::RifFloat;
+		p.mData.f = m_globals.denoiserSettings.bandwidth;
+		filter->AddParam("bandwidth", p);
+		break;
+
+	case FireRenderGlobals::kEAW:
+		filter->CreateFilter(RifFilterType::EawDenoise);
+		break;
+
+	case FireRenderGlobals::kML:
+	{
+		RifFilterType ft = m_globals.denoiserSettings.colorOnly ? RifFilterType::MlDenoiseColorOnly : RifFilterType::MlDenoise;
+		filter->CreateFilter(ft, useOpenImageDenoise);
 	}
+	break;
+
+	default:
+		assert(false);
+	}
+
+	return filter;
+}
+
+void FireRenderContext::AttachDenoiserInputsRAM(ImageFilter& filter, std::uint32_t width, std::uint32_t height, std::function<float*(int aov)> inputData) const
+{
+	size_t rifImageSize = sizeof(RV_PIXEL) * width * height;
+
+	// inputs of a filter used again replace those of the previous image
+	for (const DenoiserInput& input : GetDenoiserInputs(m_globals.denoiserSettings))
+		filter.AddInput(input.input, inputData(input.aov), rifImageSize, input.sigma);
+
+	filter.AttachFilter();
 }
 
 void FireRenderContext::setupDenoiserFB()
@@ -1066,10 +1146,15 @@ void FireRenderContext::render(bool lock)
 		{
 			m_samplesPerUpdate = 1;
 		}
+
+		// scene or camera changed, keep the interaction responsive
+		m_adaptiveIterations = AdaptiveIterations::Interact(GetAdaptiveIterationsSettings(), m_adaptiveIterations);
 	}
 
+	bool adaptiveIterations = UseAdaptiveIterations();
+
 	// may need to change iteration step
-	int iterationStep = m_samplesPerUpdate;
+	int iterationStep = adaptiveIterations ? m_adaptiveIterations.iterations : int(m_samplesPerUpdate);
 
 	if (!m_completionCriteriaParams.isUnlimitedIterations())
 	{
@@ -1088,16 +1173,39 @@ void FireRenderContext::render(bool lock)
 	progressData.currentIndex = m_currentIteration;
 	progressData.totalCount = m_completionCriteriaParams.completionCriteriaMaxIterations;
 	progressData.currentTimeInMiliseconds = TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), m_workStartTime);
+
+	if (m_currentIteration == 0)
+	{
+		progressData.progressType = ProgressType::RenderStart;
+		TriggerProgressCallback(progressData);
+	}
+
 	progressData.progressType = ProgressType::RenderPassStarted;
 
 	TriggerProgressCallback(progressData);
 
+	TimePoint renderCallStartTime = GetCurrentChronoTime();
+
 	if (m_useRegion)
 		context.RenderTile(m_region.left, m_region.right+1, m_height - m_region.top - 1, m_height - m_region.bottom);
 	else
 		context.Render();
 
-	if (m_IterationsPowerOf2Mode && !m_globals.contourIsEnabled)
+	m_aovResolveTracker.AdvanceGeneration();
+
+	progressData.progressType = ProgressType::RenderPassComplete;
+	TriggerProgressCallback(progressData);
+
+	if (adaptiveIterations)
+	{
+		double renderCallTime = TimeDiffChrono<std::chrono::microseconds>(GetCurrentChronoTime(), renderCallStartTime) / 1000.0;
+
+		AdaptiveIterations::State renderedState = m_adaptiveIterations;
+		renderedState.iterations = iterationStep;
+
+		m_adaptiveIterations = AdaptiveIterations::Update(GetAdaptiveIterationsSettings(), renderedState, renderCallTime);
+	}
+	else if (m_IterationsPowerOf2Mode && !m_globals.contourIsEnabled)
 	{
 		const int maxIterations = 32;
 		if (m_samplesPerUpdate < maxIterations)
@@ -1119,6 +1227,72 @@ void FireRenderContext::render(bool lock)
 	m_cameraAttributeChanged = false;
 }
 
+bool FireRenderContext::UseAdaptiveIterations() const
+{
+	// contours are rendered with a fixed number of iterations
+	return m_interactive && !m_globals.contourIsEnabled && m_globals.viewportTargetRefreshTime > 0.0f;
+}
+
+AdaptiveIterations::Settings FireRenderContext::GetAdaptiveIterationsSettings() const
+{
+	AdaptiveIterations::Settings settings;
+	settings.targetMilliseconds = m_globals.viewportTargetRefreshTime;
+
+	return settings;
+}
+
+bool FireRenderContext::UpdateTextureSizeLimit()
+{
+	double magnification = 1.0;
+
+	MDagPath cameraPath = m_camera.DagPath();
+	if (cameraPath.isValid())
+	{
+		MFnCamera fnCamera(cameraPath);
+
+		if (!fnCamera.isOrtho())
+		{
+			double fieldOfView = fnCamera.horizontalFieldOfView();
+			MPoint eye = fnCamera.eyePoint(MSpace::kWorld);
+
+			// the mesh closest to the camera for its size decides, so dollying in raises the limit too
+			double closest = 0.0;
+
+			for (auto& it : m_sceneObjects)
+			{
+				FireRenderMeshCommon* mesh = dynamic_cast<FireRenderMeshCommon*>(it.second.get());
+				if (!mesh)
+					continue;
+
+				MDagPath meshPath = mesh->DagPath();
+				if (!meshPath.isValid())
+					continue;
+
+				MBoundingBox bounds = MFnDagNode(meshPath).boundingBox();
+				bounds.transformUsing(meshPath.inclusiveMatrix());
+
+				double radius = 0.5 * (bounds.max() - bounds.min()).length();
+				closest = std::max(closest, TextureResolution::Magnification(fieldOfView, radius, eye.distanceTo(bounds.center())));
+			}
+
+			magnification = closest > 0.0 ? closest : TextureResolution::Magnification(fieldOfView);
+		}
+	}
+
+	TextureResolution::Policy policy;
+	policy.interactive = isInteractive();
+	policy.maxSize = (unsigned int) std::max(0, m_globals.interactiveTextureSize);
+	policy.screenCoverage = (unsigned int) (std::max(m_width, m_height) * magnification);
+
+	unsigned int limit = TextureResolution::SelectLimit(policy);
+	bool changed = m_textureSizeLimitSelected && limit != m_textureSizeLimit;
+
+	m_textureSizeLimit = limit;
+	m_textureSizeLimitSelected = true;
+
+	return changed;
+}
+
 void FireRenderContext::setSamplesPerUpdate(int samplesPerUpdate)
 {
 	m_samplesPerUpdate = samplesPerUpdate;
@@ -1369,6 +1543,11 @@ rpr_framebuffer FireRenderContext::frameBufferAOV(int aov) const
 	return m.framebufferAOV[aov].Handle();
 }
 
+void FireRenderContext::ResolveAOV(int aov)
+{
+	m.framebufferAOV[aov].Resolve(m.framebufferAOV_resolved[aov], aov != RPR_AOV_COLOR);
+}
+
 rpr_framebuffer FireRenderContext::frameBufferAOV_Resolved(int aov) {
 	RPR_THREAD_ONLY;
 	frw::FrameBuffer fb;
@@ -1380,8 +1559,8 @@ rpr_framebuffer FireRenderContext::frameBufferAOV_Resolved(int aov) {
 
 	if (needResolve())
 	{
-		//resolve tone mapping
-		m.framebufferAOV[aov].Resolve(m.framebufferAOV_resolved[aov], aov != RPR_AOV_COLOR);
+		// resolve tone mapping, once per rendered frame
+		m_aovResolveTracker.Resolve(aov, *this);
 		fb = m.framebufferAOV_resolved[aov];
 	}
 	else
@@ -1432,7 +1611,7 @@ bool FireRenderContext::ConsiderShadowReflectionCatcherOverride(const ReadFrameB
 		{
 			rifReflectionShadowCatcherOutput(params);
 		}
-		else
+		else if (!cpuCatcherOutput(params, true, true))
 		{
 			compositeReflectionShadowCatcherOutput(params);
 		}
@@ -1445,7 +1624,7 @@ bool FireRenderContext::ConsiderShadowReflectionCatcherOverride(const ReadFrameB
 		{
 			rifShadowCatcherOutput(params);
 		}
-		else
+		else if (!cpuCatcherOutput(params, true, false))
 		{
 			compositeShadowCatcherOutput(params);
 		}
@@ -1458,7 +1637,7 @@ bool FireRenderContext::ConsiderShadowReflectionCatcherOverride(const ReadFrameB
 		{
 			rifReflectionCatcherOutput(params);
 		}
-		else
+		else if (!cpuCatcherOutput(params, false, true))
 		{
 			compositeReflectionCatcherOutput(params);
 		}
@@ -1595,7 +1774,8 @@ RV_PIXEL* FireRenderContext::GetAOVData(const ReadFrameBufferRequestParams& para
 	// Get data from the RPR frame buffer.
 	rpr_framebuffer frameBuffer = frameBufferAOV_Resolved(params.aov);
 	frstatus = rprFrameBufferGetInfo(frameBuffer, RPR_FRAMEBUFFER_DATA, 0, nullptr, &dataSize);
-	checkStatus(frstatus);
+	if (!checkStatus(frstatus))
+		return nullptr;
 
 #ifdef _DEBUG
 #ifdef DUMP_PIXELS_SOURCE
@@ -1614,7 +1794,8 @@ RV_PIXEL* FireRenderContext::GetAOVData(const ReadFrameBufferRequestParams& para
 
 	RV_PIXEL* data = params.UseTempData() ? m_tempData.get() : params.pixels;
 	frstatus = rprFrameBufferGetInfo(frameBuffer, RPR_FRAMEBUFFER_DATA, dataSize, &data[0], nullptr);
-	checkStatus(frstatus);
+	if (!checkStatus(frstatus))
+		return nullptr;
 
 	return data;
 }
@@ -1649,6 +1830,26 @@ void FireRenderContext::ReadOpacityAOV(const ReadFrameBufferRequestParams& param
 	}
 }
 
+const RV_PIXEL* FireRenderContext::ReadOpacitySource(const ReadFrameBufferRequestParams& params)
+{
+	// No need to merge opacity for any FB other then color
+	if (!params.mergeOpacity || params.aov != RPR_AOV_COLOR)
+		return nullptr;
+
+	rpr_framebuffer opacityFrameBuffer = frameBufferAOV_Resolved(RPR_AOV_OPACITY);
+	if (opacityFrameBuffer == nullptr)
+		return nullptr;
+
+	size_t dataSize = (sizeof(RV_PIXEL) * params.PixelCount());
+
+	m_opacityTempData.resize(params.PixelCount());
+
+	rpr_int frstatus = rprFrameBufferGetInfo(opacityFrameBuffer, RPR_FRAMEBUFFER_DATA, dataSize, m_opacityTempData.get(), nullptr);
+	checkStatus(frstatus);
+
+	return m_opacityTempData.get();
+}
+
 void FireRenderContext::CombineOpacity(int aov, RV_PIXEL* pixels, unsigned int area)
 {
 	assert(pixels);
@@ -1661,10 +1862,49 @@ void FireRenderContext::CombineOpacity(int aov, RV_PIXEL* pixels, unsigned int a
 	combineWithOpacity(pixels, area, m_opacityData.get());
 }
 
+bool FireRenderContext::BeginAOVReadback(const ReadFrameBufferRequestParams& params, AOVResolveTracker::ReadbackTicket& ticket)
+{
+	if (!params.consumer)
+		return true;
+
+	// hash of everything which changes the pixels written for the request
+	Fnv1a key;
+
+	unsigned int regionBounds[4] = { params.region.left, params.region.right, params.region.top, params.region.bottom };
+	float compositing[4] = { params.shadowTransp, params.shadowWeight, params.bgTransparency, params.bgWeight };
+	bool flags[2] = { params.mergeOpacity, params.mergeShadowCatcher };
+
+	key.Add(&params.pixels, sizeof(params.pixels));
+	key.Add(&params.width, sizeof(params.width));
+	key.Add(&params.height, sizeof(params.height));
+	key.Add(regionBounds, sizeof(regionBounds));
+	key.Add(params.shadowColor.data(), sizeof(float) * params.shadowColor.size());
+	key.Add(params.bgColor.data(), sizeof(float) * params.bgColor.size());
+	key.Add(compositing, sizeof(compositing));
+	key.Add(flags, sizeof(flags));
+
+	return m_aovResolveTracker.BeginReadback(params.consumer, params.aov, key.Value(), ticket);
+}
+
 RV_PIXEL* FireRenderContext::readFrameBufferSimple(ReadFrameBufferRequestParams& params)
 {
 	RPR_THREAD_ONLY;
 
+	AOVResolveTracker::ReadbackTicket ticket;
+	if (!BeginAOVReadback(params, ticket))
+		return nullptr;
+
+	bool succeeded = false;
+	RV_PIXEL* data = ReadAOVPixels(params, succeeded);
+
+	if (succeeded)
+		m_aovResolveTracker.EndReadback(ticket);
+
+	return data;
+}
+
+RV_PIXEL* FireRenderContext::ReadAOVPixels(ReadFrameBufferRequestParams& params, bool& succeeded)
+{
 	// debug output (if enabled)
 #ifdef DUMP_AOV_SOURCE
 	DebugDumpAOV(params.aov);
@@ -1673,40 +1913,72 @@ RV_PIXEL* FireRenderContext::readFrameBufferSimple(ReadFrameBufferRequestParams&
 	// process shadow and/or reflection catcher logic
 	bool isShadowReflectionCatcherUsed = ConsiderShadowReflectionCatcherOverride(params);
 	if (isShadowReflectionCatcherUsed)
+	{
+		succeeded = true;
 		return nullptr;
+	}
 
 	// load data from AOV
-	return GetAOVData(params);
+	RV_PIXEL* data = GetAOVData(params);
+	succeeded = data != nullptr;
+
+	return data;
 }
 
-void FireRenderContext::readFrameBuffer(ReadFrameBufferRequestParams& params)
+bool FireRenderContext::readFrameBuffer(ReadFrameBufferRequestParams& params)
 {
 	RPR_THREAD_ONLY;
 
-	RV_PIXEL* data = readFrameBufferSimple(params);
+	AOVResolveTracker::ReadbackTicket ticket;
+	if (!BeginAOVReadback(params, ticket))
+		return false;
 
+	bool succeeded = false;
+	RV_PIXEL* data = ReadAOVPixels(params, succeeded);
+
+	// not recorded as read, the consumer reads again
+	if (!succeeded)
+	{
+		return false;
+	}
+
+	// catchers are composited straight into params.pixels
 	if (data == nullptr)
 	{
-		return;
+		m_aovResolveTracker.EndReadback(ticket);
+		return true;
 	}
 
 	// Read opacity AOV if needed
-	ReadOpacityAOV(params);
+	const RV_PIXEL* opacity = ReadOpacitySource(params);
 
-	// Copy the region from the temporary
-	// buffer into supplied pixel memory.
-	// _TODO Investigate if "|| IsDenoiserCreated()" is really necessary?  
-	if (params.UseTempData() || (IsDenoiserCreated()))
+	// Without temporary data the frame buffer is already in the supplied pixel memory,
+	// otherwise crop the region and combine opacity to alpha in one pass.
+	if (data == params.pixels && opacity == nullptr)
 	{
-		copyPixels(params.pixels, data, params.width, params.height, params.region);
+		m_aovResolveTracker.EndReadback(ticket);
+		return true;
 	}
 
-	//combine (Opacity to Alpha)
-	// No need to merge opacity for any FB other then color
-	if (params.mergeOpacity)
-	{
-		CombineOpacity(params.aov, params.pixels, params.region.getArea());
-	}
+	PixelReadback::Request request;
+	request.source = reinterpret_cast<const float*>(data);
+	request.sourceWidth = params.width;
+	request.sourceHeight = params.height;
+	request.opacity = reinterpret_cast<const float*>(opacity);
+	request.left = params.region.left;
+	request.top = params.region.top;
+	request.width = params.region.getWidth();
+	request.height = params.region.getHeight();
+	request.destination = params.pixels;
+
+	bool success = PixelReadback::Read(request);
+	assert(success);
+
+	if (!success)
+		return false;
+
+	m_aovResolveTracker.EndReadback(ticket);
+	return true;
 }
 
 #ifdef _DEBUG
@@ -1723,15 +1995,18 @@ void FireRenderContext::copyPixels(RV_PIXEL* dest, RV_PIXEL* source,
 	unsigned int regionWidth = region.getWidth();
 	unsigned int regionHeight = region.getHeight();
 
-	for (unsigned int y = 0; y < regionHeight; y++)
-	{
-		unsigned int destIndex = y * regionWidth;
-				
-		unsigned int sourceIndex = 
-			(sourceHeight - (region.top - y) - 1) * sourceWidth + region.left;
+	PixelReadback::Request request;
+	request.source = reinterpret_cast<const float*>(source);
+	request.sourceWidth = sourceWidth;
+	request.sourceHeight = sourceHeight;
+	request.left = region.left;
+	request.top = region.top;
+	request.width = regionWidth;
+	request.height = regionHeight;
+	request.destination = dest;
 
-		memcpy(&dest[destIndex], &source[sourceIndex], sizeof(RV_PIXEL) * regionWidth);
-	}
+	bool success = PixelReadback::Read(request);
+	assert(success);
 
 #ifdef _DEBUG
 #ifdef DUMP_PIXELS_SOURCE
@@ -2455,7 +2730,8 @@ void FireRenderContext::setDirty()
 
 bool FireRenderContext::isDirty()
 {
-	return m_dirty || (m_dirtyObjects.size() != 0) || m_cameraDirty || m_tonemappingChanged;
+	return m_dirty || (m_dirtyObjects.size() != 0) || m_dirtyStaging.HasPending() || m_transformDirtyStaging.HasPending() ||
+		m_cameraDirty || m_tonemappingChanged;
 }
 
 bool FireRenderContext::needsRedraw(bool setToFalseOnExit)
@@ -2486,20 +2762,58 @@ void FireRenderContext::setDirtyObject(FireRenderObject* obj)
 		return;
 	}
 
-	// We should skip inactive cameras, because their changes shouldn't affect result image
-	// If ignore this step - image in IPR would redraw when moving different camera in viewport
-	// That image redrawing in IPR causes black square artifats
-	MItDag itDag;
-	MStatus status = itDag.reset(obj->Object(), MItDag::kDepthFirst, MFn::kCamera);
-	CHECK_MSTATUS(status);
-	for (; !itDag.isDone(); itDag.next())
+	// Callback storms only touch the staging buffer of the calling thread,
+	// objects reach the dirty list once per refresh
+	m_dirtyStaging.Stage(obj);
+}
+
+void FireRenderContext::setTransformDirtyObject(FireRenderNode* obj)
+{
+	if (m_DisableSetDirtyObjects)
 	{
 		return;
 	}
 
+	m_transformDirtyStaging.Stage(obj);
+}
+
+void FireRenderContext::forgetDirtyObject(FireRenderObject* obj)
+{
+	if (obj != &m_camera)
+	{
+		m_dirtyStaging.Discard(obj);
+		m_transformDirtyStaging.Discard(obj);
+	}
+}
+
+void FireRenderContext::FlushDirtyObjects()
+{
+	if (!m_dirtyStaging.HasPending())
+		return;
+
+	std::vector<FireRenderObject*> staged;
+	m_dirtyStaging.Flush(staged);
+
+	std::vector<FireRenderObject*> objects;
+	objects.reserve(staged.size());
+
+	for (FireRenderObject* obj : staged)
+	{
+		// We should skip inactive cameras, because their changes shouldn't affect result image
+		// If ignore this step - image in IPR would redraw when moving different camera in viewport
+		// That image redrawing in IPR causes black square artifats
+		MItDag itDag;
+		MStatus status = itDag.reset(obj->Object(), MItDag::kDepthFirst, MFn::kCamera);
+		CHECK_MSTATUS(status);
+
+		if (itDag.isDone())
+			objects.push_back(obj);
+	}
+
 	AutoMutexLock lock(m_dirtyMutex);
 
-	// Find the object in objects list
+	// Find the objects in objects list
+	for (FireRenderObject* obj : objects)
 	{
 		auto it = m_sceneObjects.find(obj->uuid());
 		if (it != m_sceneObjects.end())
@@ -2510,6 +2824,119 @@ void FireRenderContext::setDirtyObject(FireRenderObject* obj)
 	}
 }
 
+namespace
+{
+	WorldMatrixHierarchy::Matrix ToHierarchyMatrix(const MMatrix& matrix)
+	{
+		WorldMatrixHierarchy::Matrix result;
+		matrix.get(result.m);
+
+		return result;
+	}
+
+	typedef ObjectHandleMap<MObjectHandle, unsigned int> TransformKeys;
+
+	// Adds the transforms above the node, root first, and returns the last one.
+	// Transforms are keyed by a number given to each node on first use, hash codes are not unique.
+	WorldMatrixHierarchy::NodeId AddDagPath(WorldMatrixHierarchy& hierarchy, TransformKeys& keys, const MDagPath& dagPath)
+	{
+		std::vector<MObject> path;
+		for (MDagPath it = dagPath; it.length() > 0; it.pop())
+			path.push_back(it.node());
+
+		WorldMatrixHierarchy::NodeId parent = WorldMatrixHierarchy::NoNode;
+
+		for (auto it = path.rbegin(); it != path.rend(); ++it)
+		{
+			if (!it->hasFn(MFn::kTransform))
+				continue;
+
+			MObjectHandle handle(*it);
+			unsigned int key = unsigned(keys.Size());
+			if (const unsigned int* known = keys.Find(handle))
+				key = *known;
+			else
+				keys.Insert(handle, key);
+
+			WorldMatrixHierarchy::NodeId node = hierarchy.Find(parent, key);
+			if (node == WorldMatrixHierarchy::NoNode)
+			{
+				MFnDagNode transform(*it);
+				MMatrix local = transform.transformationMatrix();
+
+				// Maya 2020 and later place transforms relative to an offset matrix
+				MPlug offsetPlug = transform.findPlug("offsetParentMatrix", false);
+				if (!offsetPlug.isNull())
+					local *= MFnMatrixData(offsetPlug.asMObject()).matrix();
+
+				node = hierarchy.Add(parent, key, ToHierarchyMatrix(local), transform.inheritsTransform());
+			}
+
+			parent = node;
+		}
+
+		return parent;
+	}
+}
+
+bool FireRenderContext::FreshenTransforms(bool shouldCalculateHash)
+{
+	if (!m_transformDirtyStaging.HasPending())
+		return false;
+
+	std::vector<FireRenderObject*> staged;
+	m_transformDirtyStaging.Flush(staged);
+
+	std::vector<std::shared_ptr<FireRenderNode>> nodes;
+	{
+		AutoMutexLock lock(m_dirtyMutex);
+
+		for (FireRenderObject* obj : staged)
+		{
+			// objects synced in full pick up their world matrix there
+			if (m_dirtyObjects.find(obj) != m_dirtyObjects.end())
+				continue;
+
+			auto it = m_sceneObjects.find(obj->uuid());
+			if (it == m_sceneObjects.end())
+				continue;
+
+			if (auto node = std::dynamic_pointer_cast<FireRenderNode>(it->second))
+				nodes.push_back(node);
+		}
+	}
+
+	if (nodes.empty())
+		return false;
+
+	// every transform above the moved objects is read and multiplied once
+	WorldMatrixHierarchy hierarchy;
+	TransformKeys keys;
+	std::vector<WorldMatrixHierarchy::NodeId> leaves;
+	leaves.reserve(nodes.size());
+
+	for (const std::shared_ptr<FireRenderNode>& node : nodes)
+	{
+		MDagPath dagPath = node->DagPath();
+		leaves.push_back(dagPath.isValid() ? AddDagPath(hierarchy, keys, dagPath) : WorldMatrixHierarchy::NoNode);
+	}
+
+	hierarchy.Propagate();
+
+	for (size_t i = 0; i < nodes.size(); i++)
+	{
+		MMatrix matrix;
+		if (leaves[i] != WorldMatrixHierarchy::NoNode)
+			matrix = MMatrix(hierarchy.World(leaves[i]).m);
+
+		nodes[i]->FreshenTransform(matrix, shouldCalculateHash);
+	}
+
+	DebugPrint("Transform only update: %d objects, %d transforms", int(nodes.size()), int(hierarchy.NodeCount()));
+
+	return true;
+}
+
 HashValue FireRenderContext::GetStateHash()
 {
 	HashValue hash(size_t(this));
@@ -2538,12 +2965,69 @@ void FireRenderContext::UpdateTimeAndTriggerProgressCallback(ContextWorkProgress
 
 void FireRenderContext::TriggerProgressCallback(const ContextWorkProgressData& syncProgressData)
 {
+	if (ContextWorkTracer::IsEnabled())
+	{
+		TraceProgress(syncProgressData);
+	}
+
 	if (m_WorkProgressCallback)
 	{
 		m_WorkProgressCallback(syncProgressData);
 	}
 }
 
+void FireRenderContext::TraceProgress(const ContextWorkProgressData& syncProgressData)
+{
+	ContextWorkTracer& tracer = ContextWorkTracer::Instance();
+
+	long long index = (long long) syncProgressData.currentIndex;
+	long long count = (long long) syncProgressData.totalCount;
+
+	switch (syncProgressData.progressType)
+	{
+	case ProgressType::SyncStarted:
+	{
+		static const std::map<RenderType, const char*> renderTypeNames =
+		{
+			{ RenderType::Undefined, "Undefined" },
+			{ RenderType::ProductionRender, "Production render" },
+			{ RenderType::IPR, "IPR" },
+			{ RenderType::ViewportRender, "Viewport" },
+			{ RenderType::Thumbnail, "Swatch" }
+		};
+
+		auto it = renderTypeNames.find(GetRenderType());
+		tracer.SetOwnerName(this, it != renderTypeNames.end() ? it->second : "Undefined");
+		tracer.Begin(this, "sync", "Sync", std::string(), -1, count);
+		break;
+	}
+	case ProgressType::ObjectPreSync:
+		tracer.Begin(this, "sync", syncProgressData.objectName, syncProgressData.objectType, index, count);
+		break;
+	case ProgressType::ObjectSyncComplete:
+		tracer.End(this, "sync", syncProgressData.objectName);
+		break;
+	case ProgressType::SyncComplete:
+		tracer.End(this, "sync", "Sync");
+		break;
+	case ProgressType::RenderStart:
+		tracer.Instant(this, "render", "Render start", -1, count);
+		break;
+	case ProgressType::RenderPassStarted:
+		tracer.Begin(this, "render", "Render pass", std::string(), index, count);
+		break;
+	case ProgressType::RenderPassComplete:
+		tracer.End(this, "render", "Render pass");
+		break;
+	case ProgressType::RenderComplete:
+		tracer.Complete(this, "render", "Render", syncProgressData.elapsed);
+		tracer.Flush();
+		break;
+	default:
+		break;
+	}
+}
+
 bool FireRenderContext::Freshen(bool lock, std::function<bool()> cancelled)
 {
 	MAIN_THREAD_ONLY;
@@ -2598,8 +3082,31 @@ bool FireRenderContext::Freshen(bool lock, std::function<bool()> cancelled)
 		m_cameraDirty = false;
 		m_camera.Freshen(shouldCalculateHash);
 		changed = true;
+
+		// zooming in or resizing the view can make limited textures too coarse,
+		// shaders are parsed again and assigned to the meshes, geometry is kept
+		unsigned int previousTextureSizeLimit = m_textureSizeLimit;
+
+		if (UpdateTextureSizeLimit())
+		{
+			if (previousTextureSizeLimit > 0)
+				scope.EvictResizedImages(previousTextureSizeLimit, previousTextureSizeLimit);
+
+			scope.SetCachedShadersDirty();
+
+			for (auto& it : m_sceneObjects)
+			{
+				if (FireRenderMeshCommon* mesh = dynamic_cast<FireRenderMeshCommon*>(it.second.get()))
+					mesh->ProcessShaders();
+			}
+		}
 	}
 
+	FlushDirtyObjects();
+
+	if (FreshenTransforms(shouldCalculateHash))
+		changed = true;
+
 	size_t dirtyObjectsSize = m_dirtyObjects.size();
 
 	ContextWorkProgressData syncProgressData;
@@ -2608,6 +3115,8 @@ bool FireRenderContext::Freshen(bool lock, std::function<bool()> cancelled)
 
 	UpdateTimeAndTriggerProgressCallback(syncProgressData, ProgressType::SyncStarted);
 
+	PrepareDeformationMotionCache();
+
 	while (!m_dirtyObjects.empty())
 	{
 		for (auto it = m_dirtyObjects.begin(); it != m_dirtyObjects.end(); )
@@ -2630,6 +3139,13 @@ bool FireRenderContext::Freshen(bool lock, std::function<bool()> cancelled)
 				changed = true;
 				DebugPrint("Freshing object");
 
+				if (ContextWorkTracer::IsEnabled())
+				{
+					MFnDependencyNode nodeFn(ptr->Object());
+					syncProgressData.objectName = nodeFn.name().asChar();
+					syncProgressData.objectType = nodeFn.typeName().asChar();
+				}
+
 				UpdateTimeAndTriggerProgressCallback(syncProgressData, ProgressType::ObjectPreSync);
 				ptr->Freshen(shouldCalculateHash);
 
@@ -2646,8 +3162,13 @@ bool FireRenderContext::Freshen(bool lock, std::function<bool()> cancelled)
 				DebugPrint("Cancelled freshing null object");
 			}
 		}
+
+		// objects marked dirty while others were freshened are synced in the same refresh
+		FlushDirtyObjects();
 	}
 
+	m_deformationMotionCache.Clear();
+
 	syncProgressData.elapsed = TimeDiffChrono<std::chrono::milliseconds>(GetCurrentChronoTime(), syncStartTime);
 	UpdateTimeAndTriggerProgressCallback(syncProgressData, ProgressType::SyncComplete);
 
@@ -2676,6 +3197,46 @@ bool FireRenderContext::Freshen(bool lock, std::function<bool()> cancelled)
 	return true;
 }
 
+void FireRenderContext::PrepareDeformationMotionCache()
+{
+	m_deformationMotionCache.Clear();
+
+	if (isInteractive() || m_motionSamples < 2)
+	{
+		return;
+	}
+
+	std::vector<std::shared_ptr<FireRenderObject>> dirtyObjects;
+	{
+		AutoMutexLock lock(m_dirtyMutex);
+
+		for (auto& it : m_dirtyObjects)
+		{
+			if (std::shared_ptr<FireRenderObject> ptr = it.second.lock())
+			{
+				dirtyObjects.push_back(ptr);
+			}
+		}
+	}
+
+	std::vector<MString> meshPaths;
+
+	for (const std::shared_ptr<FireRenderObject>& ptr : dirtyObjects)
+	{
+		FireRenderMesh* mesh = dynamic_cast<FireRenderMesh*>(ptr.get());
+
+		if (mesh != nullptr && mesh->IsDeformationMotionBlurEnabled())
+		{
+			meshPaths.push_back(mesh->DagPath().fullPathName());
+		}
+	}
+
+	if (!meshPaths.empty())
+	{
+		FireMaya::MeshTranslator::SampleDeformations(meshPaths, m_motionSamples, m_deformationMotionCache);
+	}
+}
+
 void FireRenderContext::SetState(StateEnum newState)
 {
 	if (m_state == newState)
@@ -3216,6 +3777,65 @@ void FireRenderContext::compositeReflectionShadowCatcherOutput(const ReadFrameBu
 	doOutputFromComposites(params, GetDataSize(frameBufferColor), frameBufferOut);
 }
 
+bool FireRenderContext::cpuCatcherOutput(const ReadFrameBufferRequestParams& params, bool shadowCatcher, bool reflectionCatcher)
+{
+	RPR_THREAD_ONLY;
+
+	const int inputAOVs[CatcherCompositing::InputCount] =
+	{
+		RPR_AOV_COLOR,
+		RPR_AOV_OPACITY,
+		RPR_AOV_BACKGROUND,
+		RPR_AOV_SHADOW_CATCHER,
+		RPR_AOV_REFLECTION_CATCHER
+	};
+
+	size_t dataSize = sizeof(RV_PIXEL) * params.PixelCount();
+
+	CatcherCompositing::Request request;
+
+	// Up to five full frames, freed on return instead of being kept alive between readbacks
+	PixelBuffer inputData[CatcherCompositing::InputCount];
+
+	for (int input = 0; input < CatcherCompositing::InputCount; input++)
+	{
+		if ((input == CatcherCompositing::ShadowCatcher && !shadowCatcher) ||
+			(input == CatcherCompositing::ReflectionCatcher && !reflectionCatcher))
+			continue;
+
+		rpr_framebuffer frameBuffer = frameBufferAOV_Resolved(inputAOVs[input]);
+		if (frameBuffer == nullptr || GetDataSize(frameBuffer) != dataSize)
+			return false;
+
+		PixelBuffer& buffer = inputData[input];
+		buffer.resize(params.PixelCount());
+
+		rpr_int frstatus = rprFrameBufferGetInfo(frameBuffer, RPR_FRAMEBUFFER_DATA, dataSize, buffer.get(), nullptr);
+		checkStatus(frstatus);
+
+		request.inputs[input] = reinterpret_cast<const float*>(buffer.get());
+	}
+
+	request.sourceWidth = params.width;
+	request.sourceHeight = params.height;
+	request.left = params.region.left;
+	request.top = params.region.top;
+	request.width = params.region.getWidth();
+	request.height = params.region.getHeight();
+	request.destination = reinterpret_cast<float*>(params.pixels);
+
+	for (int c = 0; c < 3; c++)
+	{
+		request.shadowColor[c] = params.shadowColor[c];
+		request.backgroundColor[c] = params.bgColor[c];
+	}
+
+	request.shadowTransparency = 1.0f*params.shadowWeight - params.shadowTransp;
+	request.backgroundTransparency = 1.0f*params.bgWeight - params.bgTransparency;
+
+	return CatcherCompositing::Composite(request);
+}
+
 RenderType FireRenderContext::GetRenderType() const
 {
 	return m_RenderType;
@@ -3252,6 +3872,13 @@ bool FireRenderContext::ShouldResizeTexture(unsigned int& max_width, unsigned in
 		return true;
 	}
 
+	if (isInteractive() && m_textureSizeLimit > 0)
+	{
+		max_width = m_textureSizeLimit;
+		max_height = m_textureSizeLimit;
+		return true;
+	}
+
 	return false;
 }
 
@@ -3405,16 +4032,28 @@ std::vector<float> FireRenderContext::DenoiseIntoRAM()
 	}
 
 	std::lock_guard<std::mutex> lock(m_rifLock);
-	bool isDenoiserInitialized = TryCreateDenoiserImageFilters(useRAMBuffer); // will read data from outBuffers if useRAMBuffer == true
-	assert(isDenoiserInitialized);
-	if (!isDenoiserInitialized || !IsDenoiserCreated())
-		return std::vector<float>();
 
-	// run denoiser on cached data
 	std::vector<float> vecData;
 	bool denoiseResult = false;
-	vecData = GetDenoisedData(denoiseResult);
-	assert(denoiseResult);
+
+	if (useRAMBuffer && DenoiseTilesIntoRAM(tempRegion, vecData))
+	{
+		denoiseResult = !vecData.empty();
+	}
+	else
+	{
+		bool isDenoiserInitialized = TryCreateDenoiserImageFilters(useRAMBuffer); // will read data from outBuffers if useRAMBuffer == true
+		assert(isDenoiserInitialized);
+		if (!isDenoiserInitialized || !IsDenoiserCreated())
+			return std::vector<float>();
+
+		// run denoiser on cached data
+		vecData = GetDenoisedData(denoiseResult);
+		assert(denoiseResult);
+	}
+
+	if (!denoiseResult)
+		return std::vector<float>();
 
 	// save denoiser result in RAM buffer
 	RV_PIXEL* data = (RV_PIXEL*)vecData.data();
@@ -3437,6 +4076,100 @@ std::vector<float> FireRenderContext::DenoiseIntoRAM()
 	return vecData;
 }
 
+bool FireRenderContext::DenoiseTilesIntoRAM(const RenderRegion& region, std::vector<float>& result)
+{
+	// pixels shared by neighbouring tiles, a quarter of it on each side is only context for the filter
+	const unsigned int TileOverlap = 64;
+
+	if (m_globals.denoiserSettings.memoryBudget <= 0 || m_pixelBuffers.find(RPR_AOV_COLOR) == m_pixelBuffers.end())
+		return false;
+
+	unsigned int width = region.getWidth();
+	unsigned int height = region.getHeight();
+
+	// only the AOVs the denoiser reads are cut into tiles
+	std::vector<int> aovs;
+	std::vector<const float*> inputs;
+
+	for (const DenoiserInput& input : GetDenoiserInputs(m_globals.denoiserSettings))
+	{
+		auto it = m_pixelBuffers.find(input.aov);
+		if (it == m_pixelBuffers.end() || std::find(aovs.begin(), aovs.end(), input.aov) != aovs.end())
+			continue;
+
+		aovs.push_back(input.aov);
+		inputs.push_back(it->second.data());
+	}
+
+	// tile copies of the inputs and the output, and as much again for the images of the filter
+	size_t bytesPerPixel = 2 * (inputs.size() + 1) * sizeof(RV_PIXEL);
+	size_t memoryBudget = size_t(m_globals.denoiserSettings.memoryBudget) << 20;
+
+	TiledDenoise::Layout layout = TiledDenoise::MakeLayout(width, height, TileOverlap, bytesPerPixel, memoryBudget);
+
+	if (!layout.IsTiled())
+		return false;
+
+	// all tiles get the full tile size, so one filter and its model serve the whole frame
+	layout.padTiles = true;
+
+	// filter of the previous frame has the size of the whole frame
+	m_denoiserFilter.reset();
+
+	std::shared_ptr<ImageFilter> tileFilter;
+
+	try
+	{
+		tileFilter = CreateDenoiserFilterRAM(layout.tileWidth, layout.tileHeight);
+	}
+	catch (std::exception& e)
+	{
+		ErrorPrint(e.what());
+		MGlobal::displayError("RPR failed to denoise in tiles.");
+		result.clear();
+
+		return true;
+	}
+
+	auto filter = [&](const TiledDenoise::Tile& tile, const std::vector<float*>& tileInputs, float* output) -> bool
+	{
+		try
+		{
+			AttachDenoiserInputsRAM(*tileFilter, tile.width, tile.height, [&](int aov)
+			{
+				size_t index = std::find(aovs.begin(), aovs.end(), aov) - aovs.begin();
+				return index < aovs.size() ? tileInputs[index] : nullptr;
+			});
+
+			tileFilter->Run();
+			std::vector<float> data = tileFilter->GetData();
+
+			if (data.size() < size_t(tile.width) * tile.height * 4)
+				return false;
+
+			std::copy(data.begin(), data.begin() + size_t(tile.width) * tile.height * 4, output);
+		}
+		catch (std::exception& e)
+		{
+			ErrorPrint(e.what());
+			return false;
+		}
+
+		return true;
+	};
+
+	result.resize(size_t(width) * height * 4);
+
+	// one tile at a time through the same filter
+	if (!TiledDenoise::Denoise(layout, inputs, filter, result.data()))
+	{
+		MGlobal::displayError("RPR failed to denoise in tiles.");
+		result.clear();
+	}
+
+	return true;
+}
+
 void FireRenderContext::ProcessMergeOpactityFromRAM(RV_PIXEL* data, int bufferWidth, int bufferHeight)
 {
 	if (!camera().GetAlphaMask() || !isAOVEnabled(RPR_AOV_OPACITY))
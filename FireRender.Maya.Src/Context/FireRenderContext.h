@@ -36,6 +36,10 @@ limitations under the License.
 #include <functional>
 
 #include "FireRenderUtils.h"
+#include "Translators/DeformationMotionCache.h"
+#include "AdaptiveIterations.h"
+#include "AOVResolveTracker.h"
+#include "DirtyObjectStaging.h"
 #include "FireRenderContextIFace.h"
 #include <InstancerMASH.h>
 
@@ -104,6 +108,7 @@ struct ContextWorkProgressData
 		SyncComplete,
 		RenderStart,
 		RenderPassStarted,
+		RenderPassComplete,
 		RenderComplete
 	};
 
@@ -111,6 +116,7 @@ struct ContextWorkProgressData
 	size_t currentIndex = 0;
 	size_t totalCount = 0;
 	std::string objectName;
+	std::string objectType; // filled only if context work tracing is enabled
 	long long currentTimeInMiliseconds = 0;
 	long long elapsed = 0;
 
@@ -127,7 +133,7 @@ using ProgressType = ContextWorkProgressData::ProgressType;
 // It also manage all the global callbacks connected to the current scene
 // and the Maya session
 
-class FireRenderContext : public IFireRenderContextInfo
+class FireRenderContext : public IFireRenderContextInfo, private AOVResolveTracker::FrameBufferSource
 {
 public:
 	typedef std::function<void(const ContextWorkProgressData&)> WorkProgressCallback;
@@ -265,6 +271,9 @@ public:
 		bool mergeOpacity;
 		bool mergeShadowCatcher;
 
+		// set to skip the read if the consumer already has pixels of the current frame for the same request
+		const void* consumer;
+
 		ReadFrameBufferRequestParams(const RenderRegion& _region)
 			: pixels(nullptr)
 			, aov(RPR_AOV_MAX)
@@ -279,6 +288,7 @@ public:
 			, region(_region)
 			, mergeOpacity(false)
 			, mergeShadowCatcher(false)
+			, consumer(nullptr)
 		{};
 
 		unsigned int PixelCount(void) const { return (width*height); }
@@ -289,7 +299,8 @@ public:
 	RV_PIXEL* readFrameBufferSimple(ReadFrameBufferRequestParams& params);
 
 	// Read frame buffer pixels and optionally normalize and flip the image.
-	void readFrameBuffer(ReadFrameBufferRequestParams& params);
+	// Returns false if pixels were not written because the consumer already has them.
+	bool readFrameBuffer(ReadFrameBufferRequestParams& params);
 
 	// will process frame as shadow and/or reflection catcher
 	bool ConsiderShadowReflectionCatcherOverride(const ReadFrameBufferRequestParams& params);
@@ -300,11 +311,14 @@ public:
 	// runs denoiser, returns pixel array as float vector if denoiser runs succesfully
 	std::vector<float> GetDenoisedData(bool& result);
 
-	// reads aov directly into internal storage
+	// reads aov directly into internal storage, nullptr if the frame buffer couldn't be read
 	RV_PIXEL* GetAOVData(const ReadFrameBufferRequestParams& params);
 
 	void ReadOpacityAOV(const ReadFrameBufferRequestParams& params);
 
+	// reads the whole opacity frame buffer if the request merges opacity, nullptr otherwise
+	const RV_PIXEL* ReadOpacitySource(const ReadFrameBufferRequestParams& params);
+
 	void CombineOpacity(int aov, RV_PIXEL* pixels, unsigned int area);
 
 	// Composite image for Shadow Catcher, Reflection Catcher and Shadow+Reflection Catcher
@@ -312,6 +326,10 @@ public:
 	virtual void compositeReflectionCatcherOutput(const ReadFrameBufferRequestParams& params);
 	virtual void compositeReflectionShadowCatcherOutput(const ReadFrameBufferRequestParams& params);
 
+	// Composites catchers on CPU in one pass over the AOVs.
+	// Returns false if AOV data could not be read, the RPR composite path is used then.
+	bool cpuCatcherOutput(const ReadFrameBufferRequestParams& params, bool shadowCatcher, bool reflectionCatcher);
+
 	virtual void rifShadowCatcherOutput(const ReadFrameBufferRequestParams& params);
 	virtual void rifReflectionCatcherOutput(const ReadFrameBufferRequestParams& params);
 	virtual void rifReflectionShadowCatcherOutput(const ReadFrameBufferRequestParams& params);
@@ -458,6 +476,12 @@ public:
 	void disableSetDirtyObjects(bool disable);
 	void setDirtyObject(FireRenderObject* obj);
 
+	// Only the world matrix of the node changed, it is updated without a full Freshen
+	void setTransformDirtyObject(FireRenderNode* obj);
+
+	// Called when the object is destroyed, so it isn't taken from staged dirty objects
+	void forgetDirtyObject(FireRenderObject* obj);
+
 	// Check if the context is dirty
 	bool isDirty();
 
@@ -511,6 +535,11 @@ public:
 
 	unsigned int motionSamples() const;
 
+	DeformationMotionCache& GetDeformationMotionCache() { return m_deformationMotionCache; }
+
+	// Resolve generations and consumers of AOVs
+	AOVResolveTracker& GetAOVResolveTracker() { return m_aovResolveTracker; }
+
 	// State flag of the renderer
 	StateEnum GetState() const { return m_state; }
 	void SetState(StateEnum newState);
@@ -671,6 +700,9 @@ protected:
 
 	void TriggerProgressCallback(const ContextWorkProgressData& syncProgressData);
 
+	// Forwards progress event to ContextWorkTracer, should be called only if tracing is enabled
+	void TraceProgress(const ContextWorkProgressData& syncProgressData);
+
 	virtual void OnPreRender() {}
 
 	virtual int GetAOVMaxValue();
@@ -704,8 +736,42 @@ private:
 
 	void setupDenoiserFB(void);
 	void setupDenoiserRAM(void);
+
+	// Throws if the filter can't be created
+	std::shared_ptr<ImageFilter> CreateDenoiserRAM(std::uint32_t width, std::uint32_t height, std::function<float*(int aov)> inputData);
+
+	// Filter of the denoiser type and its parameters, without inputs. Throws if it can't be created.
+	std::shared_ptr<ImageFilter> CreateDenoiserFilterRAM(std::uint32_t width, std::uint32_t height);
+
+	// Adds the inputs the denoiser type reads and attaches the filter, called again for each image of the same size
+	void AttachDenoiserInputsRAM(ImageFilter& filter, std::uint32_t width, std::uint32_t height, std::function<float*(int aov)> inputData) const;
+
+	// Denoises the region from m_pixelBuffers in overlapping tiles if the whole frame exceeds the memory budget.
+	// Returns false if the frame fits and should be denoised at once; result is empty if denoising failed.
+	bool DenoiseTilesIntoRAM(const RenderRegion& region, std::vector<float>& result);
 	void BuildLateinitObjects();
 
+	// Samples all dirty deforming meshes at once before they are synced
+	void PrepareDeformationMotionCache();
+
+	// AOVResolveTracker::FrameBufferSource
+	void ResolveAOV(int aov) override;
+
+	// False if the consumer of the request has already read the AOV in this frame;
+	// the ticket is ended with the tracker once the pixels were read
+	bool BeginAOVReadback(const ReadFrameBufferRequestParams& params, AOVResolveTracker::ReadbackTicket& ticket);
+
+	// readFrameBufferSimple without the readback check; succeeded is false if the frame buffer couldn't be read
+	RV_PIXEL* ReadAOVPixels(ReadFrameBufferRequestParams& params, bool& succeeded);
+
+	// True if iterations per render call follow the target refresh time
+	bool UseAdaptiveIterations() const;
+	AdaptiveIterations::Settings GetAdaptiveIterationsSettings() const;
+
+	// Selects the texture size limit of interactive contexts for the current view and camera.
+	// Returns true if it changed after textures were already loaded with the previous limit.
+	bool UpdateTextureSizeLimit();
+
 private:
 	std::mutex m_rifLock;
 	std::shared_ptr<ImageFilter> m_denoiserFilter;
@@ -715,6 +781,13 @@ private:
 
 	std::atomic<StateEnum> m_state;
 
+	/** Objects marked dirty by callbacks since the last refresh, moved into m_dirtyObjects by FlushDirtyObjects.
+		Declared before scene objects, which discard themselves from it when destroyed. */
+	DirtyObjectStaging m_dirtyStaging;
+
+	/** Objects which only moved, updated by FreshenTransforms unless they are fully dirty as well. */
+	DirtyObjectStaging m_transformDirtyStaging;
+
 	// Render camera
 	FireRenderCamera m_camera;
 
@@ -766,6 +839,11 @@ private:
 	// used for Deformation motion blur only for now
 	unsigned int m_motionSamples;
 
+	// Deformation motion blur samples of meshes synced in one Freshen call
+	DeformationMotionCache m_deformationMotionCache;
+
+	AOVResolveTracker m_aovResolveTracker;
+
 	/** True if the render should be interactive. */
 	bool m_interactive;
 
@@ -784,6 +862,11 @@ private:
 	/** Mutex used for disabling simultaneous access to dirty objects list. */
 	std::mutex m_dirtyMutex;
 
+	void FlushDirtyObjects();
+
+	/** Sets new world matrices of moved objects, computed top-down over their hierarchy. Returns true if any object was updated. */
+	bool FreshenTransforms(bool shouldCalculateHash);
+
 	/** Holds current globals state obtained in previous refresh call. */
 	FireRenderGlobalsData m_globals;
 
@@ -840,6 +923,13 @@ private:
 	// Increasing iterations - 1, 2, 4, 8, etc up to 32 for now
 	bool m_IterationsPowerOf2Mode;
 
+	// Iterations per interactive render call timed against viewportTargetRefreshTime
+	AdaptiveIterations::State m_adaptiveIterations;
+
+	// Longest texture side in viewport and IPR, 0 for full resolution
+	unsigned int m_textureSizeLimit;
+	bool m_textureSizeLimitSelected;
+
 	// Used for deformation motion blur feature. We need to disable dirtying object when perform deformation motion blur operations (switcihng current time which leads to dirty all objects)
 	bool m_DisableSetDirtyObjects;
 
@@ -0,0 +1,121 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "PixelReadback.h"
+
+#include "HalfFloat.h"
+
+#include <cstring>
+
+namespace PixelReadback
+{
+
+namespace
+{
+	const unsigned int Channels = 4;
+
+	inline void StorePixel(float* out, const float* in, float alpha)
+	{
+		out[0] = in[0];
+		out[1] = in[1];
+		out[2] = in[2];
+		out[3] = alpha;
+	}
+
+	inline void StorePixel(uint16_t* out, const float* in, float alpha)
+	{
+		out[0] = HalfFloat::FromFloat(in[0]);
+		out[1] = HalfFloat::FromFloat(in[1]);
+		out[2] = HalfFloat::FromFloat(in[2]);
+		out[3] = HalfFloat::FromFloat(alpha);
+	}
+
+	template <typename Output, bool MergeOpacity>
+	void ReadRow(Output* out, const float* in, const float* opacity, unsigned int width)
+	{
+		for (unsigned int x = 0; x < width; x++)
+		{
+			const float* pixel = in + size_t(x) * Channels;
+			float alpha = MergeOpacity ? opacity[size_t(x) * Channels] : pixel[3];
+
+			StorePixel(out + size_t(x) * Channels, pixel, alpha);
+		}
+	}
+
+	// Plain float rows without opacity are a copy
+	template <>
+	void ReadRow<float, false>(float* out, const float* in, const float*, unsigned int width)
+	{
+		if (out != in)
+			std::memcpy(out, in, sizeof(float) * Channels * width);
+	}
+
+	template <typename Output, bool MergeOpacity>
+	void ReadRegion(const Request& request)
+	{
+		Output* destination = static_cast<Output*>(request.destination);
+
+		const size_t sourceStride = size_t(request.sourceWidth) * Channels;
+		const size_t destinationStride = size_t(request.width) * Channels;
+
+		// first frame buffer row of the region
+		const size_t firstRow = request.sourceHeight - 1 - request.top;
+
+		const int rowCount = int(request.height);
+
+#pragma omp parallel for schedule(static) if (size_t(request.width) * request.height >= 64 * 1024)
+		for (int y = 0; y < rowCount; y++)
+		{
+			size_t sourceOffset = (firstRow + y) * sourceStride + size_t(request.left) * Channels;
+			size_t destinationRow = request.flipRows ? size_t(rowCount - 1 - y) : size_t(y);
+
+			ReadRow<Output, MergeOpacity>(destination + destinationRow * destinationStride,
+				request.source + sourceOffset,
+				MergeOpacity ? request.opacity + sourceOffset : nullptr,
+				request.width);
+		}
+	}
+}
+
+bool Read(const Request& request)
+{
+	if (!request.source || !request.destination || request.width == 0 || request.height == 0)
+		return false;
+
+	if (request.left + request.width > request.sourceWidth || request.top >= request.sourceHeight || request.height > request.top + 1)
+		return false;
+
+	bool inPlace = request.destination == request.source;
+
+	if (inPlace && (request.flipRows || request.outputType != OutputType::Float ||
+		request.width != request.sourceWidth || request.height != request.sourceHeight))
+		return false;
+
+	if (request.outputType == OutputType::Half)
+	{
+		if (request.opacity)
+			ReadRegion<uint16_t, true>(request);
+		else
+			ReadRegion<uint16_t, false>(request);
+	}
+	else
+	{
+		if (request.opacity)
+			ReadRegion<float, true>(request);
+		else
+			ReadRegion<float, false>(request);
+	}
+
+	return true;
+}
+
+}
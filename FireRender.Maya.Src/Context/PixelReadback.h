@@ -0,0 +1,56 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstdint>
+
+/** Single pass readback of RGBA float frame buffer data.
+	Crops the region, replaces alpha by the opacity AOV, orders rows and converts
+	to the output type while touching every source pixel once. Rows are processed
+	in parallel; the inner loops have fixed channel counts so compilers vectorize them. */
+namespace PixelReadback
+{
+	enum class OutputType
+	{
+		Float,
+		Half	// IEEE 754 binary16, for half float textures
+	};
+
+	struct Request
+	{
+		// RGBA floats of the whole frame buffer
+		const float* source = nullptr;
+		unsigned int sourceWidth = 0;
+		unsigned int sourceHeight = 0;
+
+		// Optional RGBA floats of the same size, red channel is written to alpha
+		const float* opacity = nullptr;
+
+		// Region as in RenderRegion: top is counted from the bottom of the frame
+		unsigned int left = 0;
+		unsigned int top = 0;
+		unsigned int width = 0;
+		unsigned int height = 0;
+
+		// Rows are written in frame buffer order by default, reversed if set (render view order)
+		bool flipRows = false;
+
+		// width * height RGBA values of outputType. May be equal to source
+		// if the region covers the whole frame buffer and rows are not flipped.
+		void* destination = nullptr;
+		OutputType outputType = OutputType::Float;
+	};
+
+	// Returns false if the request is invalid
+	bool Read(const Request& request);
+}
@@ -0,0 +1,270 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "TiledDenoise.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace TiledDenoise
+{
+
+namespace
+{
+	const unsigned int Channels = 4;
+
+	struct Span
+	{
+		unsigned int start;
+		unsigned int length;
+	};
+
+	// Spans of tileSize sharing overlap pixels; only the last one may be shorter
+	std::vector<Span> Split(unsigned int size, unsigned int tileSize, unsigned int overlap)
+	{
+		if (tileSize >= size)
+			return { { 0, size } };
+
+		unsigned int step = tileSize - overlap;
+		unsigned int count = (size - overlap + step - 1) / step;
+
+		std::vector<Span> spans;
+		spans.reserve(count);
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			unsigned int start = i * step;
+			spans.push_back({ start, std::min(tileSize, size - start) });
+		}
+
+		return spans;
+	}
+
+	// Weight of pixel t of a tile of the given length along one axis
+	float Weight(unsigned int t, unsigned int length, bool rises, bool falls, unsigned int overlap, unsigned int margin)
+	{
+		const unsigned int fade = overlap - 2 * margin;
+
+		auto rise = [&](unsigned int k) -> float
+		{
+			if (k < margin)
+				return 0.0f;
+
+			if (k >= overlap - margin)
+				return 1.0f;
+
+			return (k - margin + 0.5f) / fade;
+		};
+
+		float weight = 1.0f;
+
+		if (rises && t < overlap)
+			weight = rise(t);
+
+		if (falls && t >= length - overlap)
+			weight *= 1.0f - rise(t - (length - overlap));
+
+		return weight;
+	}
+
+	// Pixels outside the tile, up to the padded size, repeat its last column and row
+	void ExtractTile(const float* frame, unsigned int frameWidth, const Tile& tile, const Tile& padded, float* data)
+	{
+		for (unsigned int y = 0; y < padded.height; y++)
+		{
+			const float* source = frame + (size_t(tile.y + std::min(y, tile.height - 1)) * frameWidth + tile.x) * Channels;
+			float* destination = data + size_t(y) * padded.width * Channels;
+
+			std::memcpy(destination, source, sizeof(float) * tile.width * Channels);
+
+			const float* last = source + size_t(tile.width - 1) * Channels;
+			for (unsigned int x = tile.width; x < padded.width; x++)
+				std::memcpy(destination + size_t(x) * Channels, last, sizeof(float) * Channels);
+		}
+	}
+
+	// Moves the tile pixels of a padded image to the start of the buffer, rows packed to the tile width
+	void CropTile(const Tile& tile, const Tile& padded, float* data)
+	{
+		if (tile.width == padded.width)
+			return;
+
+		for (unsigned int y = 1; y < tile.height; y++)
+			std::memmove(data + size_t(y) * tile.width * Channels, data + size_t(y) * padded.width * Channels, sizeof(float) * tile.width * Channels);
+	}
+
+	void BlendTile(const Layout& layout, const Tile& tile, const float* data, float* frame)
+	{
+		bool hasLeft = tile.x > 0;
+		bool hasRight = tile.x + tile.width < layout.frameWidth;
+		bool hasTop = tile.y > 0;
+		bool hasBottom = tile.y + tile.height < layout.frameHeight;
+
+		std::vector<float> columnWeights(tile.width);
+		for (unsigned int x = 0; x < tile.width; x++)
+			columnWeights[x] = Weight(x, tile.width, hasLeft, hasRight, layout.overlap, layout.margin);
+
+		for (unsigned int y = 0; y < tile.height; y++)
+		{
+			float rowWeight = Weight(y, tile.height, hasTop, hasBottom, layout.overlap, layout.margin);
+			if (rowWeight <= 0.0f)
+				continue;
+
+			const float* source = data + size_t(y) * tile.width * Channels;
+			float* destination = frame + (size_t(tile.y + y) * layout.frameWidth + tile.x) * Channels;
+
+			for (unsigned int x = 0; x < tile.width; x++)
+			{
+				float weight = rowWeight * columnWeights[x];
+
+				for (unsigned int c = 0; c < Channels; c++)
+					destination[x * Channels + c] += weight * source[x * Channels + c];
+			}
+		}
+	}
+
+	struct Worker
+	{
+		std::vector<std::vector<float>> inputs;
+		std::vector<float*> inputPointers;
+		std::vector<float> output;
+	};
+}
+
+Layout MakeLayout(unsigned int frameWidth, unsigned int frameHeight, unsigned int overlap,
+	size_t bytesPerPixel, size_t memoryBudget, unsigned int concurrency)
+{
+	Layout layout;
+	layout.frameWidth = frameWidth;
+	layout.frameHeight = frameHeight;
+	layout.overlap = overlap;
+	layout.margin = overlap / 4;
+
+	size_t framePixels = size_t(frameWidth) * frameHeight;
+	size_t tilePixels = memoryBudget / (std::max<size_t>(bytesPerPixel, 1) * std::max(concurrency, 1u));
+
+	if (memoryBudget == 0 || framePixels <= tilePixels || overlap == 0)
+	{
+		layout.tileWidth = frameWidth;
+		layout.tileHeight = frameHeight;
+		layout.tiles.push_back({ 0, 0, frameWidth, frameHeight });
+		return layout;
+	}
+
+	// fading needs at least one pixel and tiles have to be longer than two overlaps
+	layout.overlap = std::max(overlap, 2 * layout.margin + 1);
+	const unsigned int minSide = 2 * layout.overlap + 1;
+
+	unsigned int side = std::max(minSide, (unsigned int) std::sqrt(double(tilePixels)));
+
+	// full rows if they fit, otherwise square tiles
+	unsigned int tileWidth = std::min(frameWidth, side);
+	unsigned int tileHeight = std::max(minSide, (unsigned int) std::min<size_t>(frameHeight, tilePixels / tileWidth));
+
+	layout.tileWidth = tileWidth;
+	layout.tileHeight = std::min(frameHeight, tileHeight);
+
+	for (const Span& row : Split(frameHeight, tileHeight, layout.overlap))
+	{
+		for (const Span& column : Split(frameWidth, tileWidth, layout.overlap))
+			layout.tiles.push_back({ column.start, row.start, column.length, row.length });
+	}
+
+	return layout;
+}
+
+bool Denoise(const Layout& layout, const std::vector<const float*>& inputs, const TileFilter& filter,
+	float* output, unsigned int concurrency)
+{
+	if (layout.tiles.empty() || !output)
+		return false;
+
+	const size_t framePixels = size_t(layout.frameWidth) * layout.frameHeight;
+
+	std::memset(output, 0, sizeof(float) * Channels * framePixels);
+
+	concurrency = std::max(1u, std::min(concurrency, (unsigned int) layout.tiles.size()));
+	std::vector<Worker> workers(concurrency);
+
+	auto runTile = [&](Worker& worker, const Tile& tile) -> bool
+	{
+		Tile padded = tile;
+		if (layout.padTiles)
+		{
+			padded.width = std::max(tile.width, layout.tileWidth);
+			padded.height = std::max(tile.height, layout.tileHeight);
+		}
+
+		size_t tileValues = size_t(padded.width) * padded.height * Channels;
+
+		worker.inputs.resize(inputs.size());
+		worker.inputPointers.resize(inputs.size());
+
+		for (size_t i = 0; i < inputs.size(); i++)
+		{
+			worker.inputs[i].resize(tileValues);
+			ExtractTile(inputs[i], layout.frameWidth, tile, padded, worker.inputs[i].data());
+			worker.inputPointers[i] = worker.inputs[i].data();
+		}
+
+		worker.output.resize(tileValues);
+
+		if (!filter(padded, worker.inputPointers, worker.output.data()))
+			return false;
+
+		CropTile(tile, padded, worker.output.data());
+
+		return true;
+	};
+
+	for (size_t first = 0; first < layout.tiles.size(); first += concurrency)
+	{
+		size_t batch = std::min<size_t>(concurrency, layout.tiles.size() - first);
+		std::atomic<bool> success(true);
+
+		if (batch == 1)
+		{
+			success = runTile(workers[0], layout.tiles[first]);
+		}
+		else
+		{
+			std::vector<std::thread> threads;
+			threads.reserve(batch);
+
+			for (size_t i = 0; i < batch; i++)
+			{
+				threads.emplace_back([&, i]()
+				{
+					if (!runTile(workers[i], layout.tiles[first + i]))
+						success = false;
+				});
+			}
+
+			for (std::thread& thread : threads)
+				thread.join();
+		}
+
+		if (!success)
+			return false;
+
+		// blending is sequential, tiles of a batch share overlaps
+		for (size_t i = 0; i < batch; i++)
+			BlendTile(layout, layout.tiles[first + i], workers[i].output.data(), output);
+	}
+
+	return true;
+}
+
+}
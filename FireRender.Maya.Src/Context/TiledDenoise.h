@@ -0,0 +1,69 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+/** Denoising of large frames in overlapping tiles.
+	Each tile is filtered on its own, so peak memory is bounded by the tile size instead of the frame.
+	Neighbouring tiles overlap; the outer margin of an overlap only gives the filter context and is
+	dropped, the rest is cross-faded with weights summing to one, so no seams and no weight buffer. */
+namespace TiledDenoise
+{
+	struct Tile
+	{
+		// Frame pixels covered by the tile, overlap included. Rows are counted from the first image row.
+		unsigned int x;
+		unsigned int y;
+		unsigned int width;
+		unsigned int height;
+	};
+
+	struct Layout
+	{
+		unsigned int frameWidth = 0;
+		unsigned int frameHeight = 0;
+
+		// pixels shared by neighbouring tiles and the part of it used only as filter context
+		unsigned int overlap = 0;
+		unsigned int margin = 0;
+
+		// size of the full tiles, only the last row and column of tiles may be smaller
+		unsigned int tileWidth = 0;
+		unsigned int tileHeight = 0;
+
+		// Smaller tiles are padded to the full size by repeating their last column and row,
+		// so the filter always gets images of one size and can be created once
+		bool padTiles = false;
+
+		std::vector<Tile> tiles;
+
+		bool IsTiled() const { return tiles.size() > 1; }
+	};
+
+	// Splits the frame so concurrency tiles of bytesPerPixel working memory fit into memoryBudget.
+	// A zero budget or a frame that fits gives a single tile.
+	Layout MakeLayout(unsigned int frameWidth, unsigned int frameHeight, unsigned int overlap,
+		size_t bytesPerPixel, size_t memoryBudget, unsigned int concurrency = 1);
+
+	// Filters one tile. Inputs and output are tile sized RGBA floats in the order passed to Denoise,
+	// with padded tiles the tile and the images have the full tile size.
+	typedef std::function<bool(const Tile& tile, const std::vector<float*>& inputs, float* output)> TileFilter;
+
+	// Inputs and output are frame sized RGBA floats. Up to concurrency tiles are filtered at once,
+	// the filter has to be thread safe then. Returns false if the filter failed on any tile.
+	bool Denoise(const Layout& layout, const std::vector<const float*>& inputs, const TileFilter& filter,
+		float* output, unsigned int concurrency = 1);
+}
@@ -0,0 +1,121 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "WorldMatrixHierarchy.h"
+
+WorldMatrixHierarchy::Matrix WorldMatrixHierarchy::Matrix::Identity()
+{
+	Matrix matrix = {};
+
+	for (int i = 0; i < 4; i++)
+		matrix.m[i][i] = 1.0;
+
+	return matrix;
+}
+
+WorldMatrixHierarchy::Matrix WorldMatrixHierarchy::Multiply(const Matrix& a, const Matrix& b)
+{
+	Matrix result;
+
+	for (int row = 0; row < 4; row++)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			result.m[row][column] =
+				a.m[row][0] * b.m[0][column] +
+				a.m[row][1] * b.m[1][column] +
+				a.m[row][2] * b.m[2][column] +
+				a.m[row][3] * b.m[3][column];
+		}
+	}
+
+	return result;
+}
+
+unsigned long long WorldMatrixHierarchy::MakeKey(NodeId parent, unsigned int key)
+{
+	return (static_cast<unsigned long long>(static_cast<unsigned int>(parent + 1)) << 32) | key;
+}
+
+WorldMatrixHierarchy::NodeId WorldMatrixHierarchy::Find(NodeId parent, unsigned int key) const
+{
+	auto it = m_keys.find(MakeKey(parent, key));
+
+	return it != m_keys.end() ? it->second : NoNode;
+}
+
+WorldMatrixHierarchy::NodeId WorldMatrixHierarchy::Add(NodeId parent, unsigned int key, const Matrix& local, bool inheritsTransform)
+{
+	NodeId id = NodeId(m_nodes.size());
+
+	auto inserted = m_keys.emplace(MakeKey(parent, key), id);
+	if (!inserted.second)
+	{
+		SetLocal(inserted.first->second, local);
+		return inserted.first->second;
+	}
+
+	Node node;
+	node.parent = parent;
+	node.inheritsTransform = inheritsTransform;
+	node.dirty = true;
+	node.local = local;
+	node.world = local;
+
+	m_nodes.push_back(node);
+	m_hasDirty = true;
+
+	return id;
+}
+
+void WorldMatrixHierarchy::Reserve(size_t nodeCount)
+{
+	m_nodes.reserve(nodeCount);
+	m_keys.reserve(nodeCount);
+}
+
+void WorldMatrixHierarchy::SetLocal(NodeId node, const Matrix& local)
+{
+	m_nodes[node].local = local;
+	m_nodes[node].dirty = true;
+	m_hasDirty = true;
+}
+
+size_t WorldMatrixHierarchy::Propagate()
+{
+	if (!m_hasDirty)
+		return 0;
+
+	size_t recomputed = 0;
+
+	for (Node& node : m_nodes)
+	{
+		// recomputed nodes stay dirty until the pass ends, so their children follow
+		if (!node.dirty && (node.parent == NoNode || !m_nodes[node.parent].dirty))
+			continue;
+
+		if (node.parent != NoNode && node.inheritsTransform)
+			node.world = Multiply(node.local, m_nodes[node.parent].world);
+		else
+			node.world = node.local;
+
+		node.dirty = true;
+		recomputed++;
+	}
+
+	for (Node& node : m_nodes)
+		node.dirty = false;
+
+	m_hasDirty = false;
+
+	return recomputed;
+}
@@ -0,0 +1,76 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/** World matrices of a DAG hierarchy, computed top-down in one pass.
+
+	Moving a group changes the world matrix of everything below it. Instead of every shape
+	walking its own path up to the root, the transforms above the moved objects are added
+	once, parents before children, and each world matrix is the local matrix of the node
+	times the world matrix of its parent. Matrices follow the Maya convention of row vectors.
+*/
+class WorldMatrixHierarchy
+{
+public:
+	typedef int NodeId;
+	static const NodeId NoNode = -1;
+
+	struct Matrix
+	{
+		double m[4][4];
+
+		static Matrix Identity();
+	};
+
+	// Instanced transforms appear once per parent, key identifies the node under its parent
+	// and must be unique among its siblings, a hash code is not
+	NodeId Find(NodeId parent, unsigned int key) const;
+
+	// Parent must be added before, node is dirty until the next propagation
+	NodeId Add(NodeId parent, unsigned int key, const Matrix& local, bool inheritsTransform = true);
+
+	void SetLocal(NodeId node, const Matrix& local);
+
+	void Reserve(size_t nodeCount);
+
+	// Recomputes world matrices of dirty nodes and everything below them, each node once.
+	// Returns the number of recomputed nodes.
+	size_t Propagate();
+
+	const Matrix& World(NodeId node) const { return m_nodes[node].world; }
+	NodeId Parent(NodeId node) const { return m_nodes[node].parent; }
+	size_t NodeCount() const { return m_nodes.size(); }
+
+	static Matrix Multiply(const Matrix& a, const Matrix& b);
+
+private:
+	struct Node
+	{
+		NodeId parent;
+		bool inheritsTransform;
+		bool dirty;
+		Matrix local;
+		Matrix world;
+	};
+
+	static unsigned long long MakeKey(NodeId parent, unsigned int key);
+
+	// ids grow from parents to children, so a linear pass visits parents first
+	std::vector<Node> m_nodes;
+	std::unordered_map<unsigned long long, NodeId> m_keys;
+	bool m_hasDirty = false;
+};
@@ -16,6 +16,8 @@ limitations under the License.
 #include "VRay.h"
 #include "Context/FireRenderContext.h"
 #include "MayaStandardNodesSupport/NodeConverterUtil.h"
+#include "TextureResolution.h"
+#include "TextureDiskCache.h"
 
 #include <maya/MImage.h>
 #include <maya/MPlugArray.h>
@@ -26,8 +28,11 @@ limitations under the License.
 #include <maya/MUuid.h>
 #include <maya/MItDependencyGraph.h>
 #include <maya/MImageFileInfo.h>
+#include <imageio.h>
 #include <FireRenderLayeredTextureUtils.h>
 #include <exception>
+#include <algorithm>
+#include <memory>
 
 #ifdef MAYA2017
 #include "maya/MColorManagementUtilities.h"
@@ -888,11 +893,27 @@ frw::Image FireMaya::Scope::GetImage(MString texturePath, MString colorSpace, co
 
 	std::string key = (texturePath + ":" + colorSpace).asUTF8();
 
+	// viewport and IPR limit the texture size, see TextureResolution
+	unsigned int maxWidth = 0;
+	unsigned int maxHeight = 0;
+	bool shouldResize = false;
+
+	if (const IFireRenderContextInfo* contextInfo = GetIContextInfo())
+	{
+		RenderType renderType = contextInfo->GetRenderType();
+
+		shouldResize = (renderType == RenderType::IPR || renderType == RenderType::ViewportRender) &&
+			contextInfo->ShouldResizeTexture(maxWidth, maxHeight);
+	}
+
+	if (shouldResize)
+		key += ":" + std::to_string(maxWidth) + "x" + std::to_string(maxHeight);
+
 	auto it = m->imageCache.find(key);
 	if (it != m->imageCache.end())
 		return it->second;
 
-	frw::Image retImage = FireRenderThread::RunOnMainThread<frw::Image>([this, texturePath, key, colorSpace, ownerNodeName]() -> frw::Image
+	frw::Image retImage = FireRenderThread::RunOnMainThread<frw::Image>([this, texturePath, key, colorSpace, ownerNodeName, shouldResize, maxWidth, maxHeight]() -> frw::Image
 	{
 		MAIN_THREAD_ONLY; // MTextureManager will not work in other threads
 		DebugPrint("Loading Image: %s in colorSpace: %s", texturePath.asUTF8(), colorSpace.asUTF8());
@@ -901,11 +922,34 @@ frw::Image FireMaya::Scope::GetImage(MString texturePath, MString colorSpace, co
 
 		frw::Image image;
 
-		image = frw::Image(m->context, processedTexturePath.c_str());
+		// reduced interactive textures are kept on disk, so the full resolution file isn't decoded again
+		TextureDiskCache::Key levelKey;
+		bool cacheLevel = shouldResize && TextureDiskCache::Instance().IsEnabled() &&
+			TextureDiskCache::MakeKey(processedTexturePath, colorSpace.asUTF8(), std::to_string(maxWidth) + "x" + std::to_string(maxHeight), levelKey);
+
+		if (cacheLevel)
+		{
+			image = LoadCachedImage(levelKey);
+		}
+
+		if (!image && shouldResize)
+		{
+			image = LoadReducedImage(processedTexturePath, maxWidth, maxHeight, cacheLevel ? &levelKey : nullptr);
+		}
 
 		if (!image)
 		{
-			image = LoadImageUsingMTexture(MString(processedTexturePath.c_str()), colorSpace, ownerNodeName);
+			image = frw::Image(m->context, processedTexturePath.c_str());
+
+			if (!image)
+			{
+				image = LoadImageUsingMTexture(MString(processedTexturePath.c_str()), colorSpace, ownerNodeName);
+			}
+
+			if (image && shouldResize)
+			{
+				image = ResizeImage(image, maxWidth, maxHeight, cacheLevel ? &levelKey : nullptr);
+			}
 		}
 
 		if (image)
@@ -928,6 +972,18 @@ frw::Image FireMaya::Scope::LoadImageUsingMTexture(MString texturePath, MString
 {
 	frw::Image img;
 
+	TextureDiskCache::Key cacheKey;
+	bool useCache = TextureDiskCache::Instance().IsEnabled() &&
+		TextureDiskCache::MakeKey(texturePath.asUTF8(), colorSpace.asUTF8(), "mtexture", cacheKey);
+
+	if (useCache)
+	{
+		img = LoadCachedImage(cacheKey);
+
+		if (img)
+			return img;
+	}
+
 	if (auto renderer = MHWRender::MRenderer::theRenderer())
 	{
 		if (auto textureManager = renderer->getTextureManager())
@@ -973,7 +1029,7 @@ frw::Image FireMaya::Scope::LoadImageUsingMTexture(MString texturePath, MString
 						}
 
 						img = CreateImageInternal(colorSpace, desc.fWidth, desc.fHeight, 
-													srcData, channels, componentSize, rowPitch);
+													srcData, channels, componentSize, rowPitch, false, useCache ? &cacheKey : nullptr);
 
 						texture->freeRawData(rawData_to_free);
 					}
@@ -994,6 +1050,222 @@ frw::Image FireMaya::Scope::LoadImageUsingMTexture(MString texturePath, MString
 	return img;
 }
 
+frw::Image FireMaya::Scope::ResizeImage(frw::Image image, unsigned int maxWidth, unsigned int maxHeight, const TextureDiskCache::Key* cacheKey) const
+{
+	rpr_image_format format = {};
+	rpr_image_desc desc = {};
+
+	if (rprImageGetInfo(image.Handle(), RPR_IMAGE_FORMAT, sizeof(format), &format, nullptr) != RPR_SUCCESS ||
+		rprImageGetInfo(image.Handle(), RPR_IMAGE_DESC, sizeof(desc), &desc, nullptr) != RPR_SUCCESS)
+	{
+		return image;
+	}
+
+	unsigned int level = TextureResolution::SelectLevel(desc.image_width, desc.image_height, maxWidth, maxHeight);
+
+	if (level == 0 || desc.image_depth > 1)
+		return image;
+
+	TextureResolution::ImageData source;
+	size_t componentSize = 0;
+
+	switch (format.type)
+	{
+	case RPR_COMPONENT_TYPE_UINT8:
+		source.type = TextureResolution::ComponentType::UInt8;
+		componentSize = 1;
+		break;
+
+	case RPR_COMPONENT_TYPE_FLOAT16:
+		source.type = TextureResolution::ComponentType::Half;
+		componentSize = 2;
+		break;
+
+	case RPR_COMPONENT_TYPE_FLOAT32:
+		source.type = TextureResolution::ComponentType::Float;
+		componentSize = 4;
+		break;
+
+	default:
+		return image;
+	}
+
+	size_t dataSize = 0;
+	if (rprImageGetInfo(image.Handle(), RPR_IMAGE_DATA, 0, nullptr, &dataSize) != RPR_SUCCESS)
+		return image;
+
+	std::vector<unsigned char> data(dataSize);
+	if (dataSize == 0 || rprImageGetInfo(image.Handle(), RPR_IMAGE_DATA, dataSize, data.data(), nullptr) != RPR_SUCCESS)
+		return image;
+
+	source.data = data.data();
+	source.width = desc.image_width;
+	source.height = desc.image_height;
+	source.channels = format.num_components;
+	source.rowPitch = desc.image_row_pitch ? desc.image_row_pitch : size_t(desc.image_width) * format.num_components * componentSize;
+
+	if (dataSize < source.rowPitch * desc.image_height)
+		return image;
+
+	unsigned int width = 0;
+	unsigned int height = 0;
+	TextureResolution::LevelSize(desc.image_width, desc.image_height, level, width, height);
+
+	rpr_image_desc levelDesc = {};
+	levelDesc.image_width = width;
+	levelDesc.image_height = height;
+	levelDesc.image_row_pitch = width * format.num_components * (rpr_uint) componentSize;
+
+	std::vector<unsigned char> buffer(size_t(levelDesc.image_row_pitch) * height);
+
+	if (!TextureResolution::Downsample(source, width, height, buffer.data()))
+		return image;
+
+	DebugPrint("Image resized from %ux%u to %ux%u", desc.image_width, desc.image_height, width, height);
+
+	if (cacheKey)
+	{
+		StoreCachedImage(*cacheKey, format, levelDesc, buffer.data());
+	}
+
+	return frw::Image(m->context, format, levelDesc, buffer.data());
+}
+
+frw::Image FireMaya::Scope::LoadReducedImage(const std::string& path, unsigned int maxWidth, unsigned int maxHeight, const TextureDiskCache::Key* cacheKey) const
+{
+	std::unique_ptr<OIIO::ImageInput> input(OIIO::ImageInput::create(path));
+	OIIO::ImageSpec spec;
+
+	if (!input || !input->open(path, spec))
+		return frw::Image();
+
+	unsigned int level = TextureResolution::SelectLevel(spec.width, spec.height, maxWidth, maxHeight);
+
+	if (level == 0 || spec.depth > 1 || spec.nchannels <= 0)
+		return frw::Image();
+
+	unsigned int width = 0;
+	unsigned int height = 0;
+	TextureResolution::LevelSize(spec.width, spec.height, level, width, height);
+
+	// mip mapped files (e.g. .tx) store levels, the smallest one still covering the reduced size is decoded
+	int mipLevel = 0;
+	OIIO::ImageSpec mipSpec;
+
+	while (input->seek_subimage(0, mipLevel + 1, mipSpec) && mipSpec.width >= int(width) && mipSpec.height >= int(height))
+	{
+		mipLevel++;
+	}
+
+	if (!input->seek_subimage(0, mipLevel, spec))
+		return frw::Image();
+
+	TextureResolution::ComponentType componentType = TextureResolution::ComponentType::Float;
+	OIIO::TypeDesc readType = OIIO::TypeDesc::FLOAT;
+	rpr_image_format format = {};
+	format.type = RPR_COMPONENT_TYPE_FLOAT32;
+	size_t componentSize = 4;
+
+	if (spec.format == OIIO::TypeDesc::UINT8)
+	{
+		componentType = TextureResolution::ComponentType::UInt8;
+		readType = OIIO::TypeDesc::UINT8;
+		format.type = RPR_COMPONENT_TYPE_UINT8;
+		componentSize = 1;
+	}
+	else if (spec.format == OIIO::TypeDesc::HALF)
+	{
+		componentType = TextureResolution::ComponentType::Half;
+		readType = OIIO::TypeDesc::HALF;
+		format.type = RPR_COMPONENT_TYPE_FLOAT16;
+		componentSize = 2;
+	}
+
+	// RPR images have up to 4 channels
+	format.num_components = std::min(spec.nchannels, 4);
+
+	rpr_image_desc levelDesc = {};
+	levelDesc.image_width = width;
+	levelDesc.image_height = height;
+	levelDesc.image_row_pitch = width * format.num_components * (rpr_uint) componentSize;
+
+	std::vector<unsigned char> buffer(size_t(levelDesc.image_row_pitch) * height);
+
+	TextureResolution::RowDownsampler downsampler(spec.width, spec.height, format.num_components, componentType, width, height, buffer.data());
+
+	if (!downsampler.IsValid())
+		return frw::Image();
+
+	// scanlines are decoded in strips, the full resolution image is never kept in memory
+	const int stripHeight = 64;
+	const size_t rowSize = size_t(spec.width) * format.num_components * componentSize;
+	std::vector<unsigned char> strip(rowSize * stripHeight);
+
+	for (int y = spec.y; y < spec.y + spec.height; y += stripHeight)
+	{
+		int yEnd = std::min(y + stripHeight, spec.y + spec.height);
+
+		if (!input->read_scanlines(y, yEnd, spec.z, 0, int(format.num_components), readType, strip.data()))
+			return frw::Image();
+
+		for (int row = 0; row < yEnd - y; row++)
+			downsampler.AddRow(strip.data() + row * rowSize);
+	}
+
+	input->close();
+
+	if (!downsampler.IsComplete())
+		return frw::Image();
+
+	DebugPrint("Image decoded at %ux%u from %dx%d (file level %d): %s", width, height, spec.width, spec.height, mipLevel, path.c_str());
+
+	if (cacheKey)
+	{
+		StoreCachedImage(*cacheKey, format, levelDesc, buffer.data());
+	}
+
+	return frw::Image(m->context, format, levelDesc, buffer.data());
+}
+
+frw::Image FireMaya::Scope::LoadCachedImage(const TextureDiskCache::Key& key) const
+{
+	TextureDiskCache::Entry entry;
+
+	if (!TextureDiskCache::Instance().Load(key, entry))
+		return frw::Image();
+
+	const TextureDiskCache::ImageDesc& cachedDesc = entry.Desc();
+
+	rpr_image_format format = {};
+	format.num_components = cachedDesc.channels;
+	format.type = cachedDesc.componentType;
+
+	rpr_image_desc desc = {};
+	desc.image_width = cachedDesc.width;
+	desc.image_height = cachedDesc.height;
+	desc.image_row_pitch = cachedDesc.rowPitch;
+
+	DebugPrint("Image loaded from disk cache: %s", key.path.c_str());
+
+	// RPR copies the pixels, the mapping is released right after
+	return frw::Image(m->context, format, desc, entry.Pixels());
+}
+
+void FireMaya::Scope::StoreCachedImage(const TextureDiskCache::Key& key, const rpr_image_format& format, const rpr_image_desc& desc, const void* data) const
+{
+	TextureDiskCache::ImageDesc cachedDesc;
+	cachedDesc.width = desc.image_width;
+	cachedDesc.height = desc.image_height;
+	cachedDesc.channels = format.num_components;
+	cachedDesc.componentType = format.type;
+	cachedDesc.rowPitch = desc.image_row_pitch;
+
+	if (!TextureDiskCache::Instance().Store(key, cachedDesc, data))
+	{
+		DebugPrint("Failed to store image in disk cache: %s", key.path.c_str());
+	}
+}
+
 frw::Image FireMaya::Scope::CreateImageInternal(MString colorSpace, 
 												unsigned int width, 
 												unsigned int height,
@@ -1001,7 +1273,8 @@ frw::Image FireMaya::Scope::CreateImageInternal(MString colorSpace,
 												unsigned int channels,
 												unsigned int componentSize,
 												unsigned int rowPitch,
-												bool flipY) const
+												bool flipY,
+												const TextureDiskCache::Key* cacheKey) const
 {
 	int srcRowPitch = rowPitch;// desc.fBytesPerRow;
 
@@ -1062,6 +1335,12 @@ frw::Image FireMaya::Scope::CreateImageInternal(MString colorSpace,
 	}
 
 	convertColorSpace(colorSpace, format, img_desc, buffer);
+
+	if (cacheKey)
+	{
+		StoreCachedImage(*cacheKey, format, img_desc, buffer.data());
+	}
+
 	return frw::Image(m->context, format, img_desc, buffer.data());
 }
 
@@ -1868,6 +2147,31 @@ void FireMaya::Scope::SetCachedShader(const NodeId& id, frw::Shader shader)
 		m->shaderMap[id] = shader;
 }
 
+void FireMaya::Scope::SetCachedShadersDirty()
+{
+	for (auto& it : m->shaderMap)
+		it.second.SetDirty(true);
+
+	for (auto& it : m->volumeShaderMap)
+		it.second.SetDirty(true);
+}
+
+void FireMaya::Scope::EvictResizedImages(unsigned int maxWidth, unsigned int maxHeight)
+{
+	// same suffix as GetImage appends to the key
+	std::string suffix = ":" + std::to_string(maxWidth) + "x" + std::to_string(maxHeight);
+
+	for (auto it = m->imageCache.begin(); it != m->imageCache.end(); )
+	{
+		const std::string& key = it->first;
+
+		if (key.size() > suffix.size() && key.compare(key.size() - suffix.size(), suffix.size(), suffix) == 0)
+			it = m->imageCache.erase(it);
+		else
+			++it;
+	}
+}
+
 void FireMaya::Scope::SetCachedVolumeShader(const NodeId& id, frw::Shader shader)
 {
 	if (!shader)
@@ -22,6 +22,7 @@ limitations under the License.
 #include <maya/MFnDependencyNode.h>
 #include <maya/MNodeMessage.h>
 #include "Context/FireRenderContextIFace.h"
+#include "TextureDiskCache.h"
 
 class FireRenderMeshCommon;
 
@@ -270,10 +271,22 @@ namespace FireMaya
 			unsigned int channels,
 			unsigned int componentSize,
 			unsigned int rowPitch,
-			bool flipY = false) const;
+			bool flipY = false,
+			const TextureDiskCache::Key* cacheKey = nullptr) const;
 
 		frw::Image LoadImageUsingMTexture(MString texturePath, MString colorSpace, const MString& ownerNodeName) const;
 
+		// Smallest mip level of the image fitting into maxWidth x maxHeight, the image itself if it fits or can't be read
+		frw::Image ResizeImage(frw::Image image, unsigned int maxWidth, unsigned int maxHeight, const TextureDiskCache::Key* cacheKey = nullptr) const;
+
+		// Decodes the file straight into the mip level ResizeImage would select, reading a stored mip level if the file has one.
+		// Returns null if the image fits already or the file can't be read this way.
+		frw::Image LoadReducedImage(const std::string& path, unsigned int maxWidth, unsigned int maxHeight, const TextureDiskCache::Key* cacheKey = nullptr) const;
+
+		// Images created from pixels prepared by the plugin are kept in TextureDiskCache
+		frw::Image LoadCachedImage(const TextureDiskCache::Key& key) const;
+		void StoreCachedImage(const TextureDiskCache::Key& key, const rpr_image_format& format, const rpr_image_desc& desc, const void* data) const;
+
 	public:
 		Scope();
 		~Scope();
@@ -327,6 +340,12 @@ namespace FireMaya
 		frw::Shader GetCachedShader(const NodeId& str) const;
 		void SetCachedShader(const NodeId& str, frw::Shader shader);
 
+		// Cached shaders are parsed again on next request, e.g. to pick up a new texture size limit
+		void SetCachedShadersDirty();
+
+		// Releases images GetImage reduced to maxWidth x maxHeight, e.g. once the texture size limit changed
+		void EvictResizedImages(unsigned int maxWidth, unsigned int maxHeight);
+
 		void Reset();
 		void Init(rpr_context handle, bool destroyMaterialSystemOnDelete = true, bool createScene = true);
 		void CreateScene(void);
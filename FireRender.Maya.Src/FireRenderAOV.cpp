@@ -253,9 +253,11 @@ void FireRenderAOV::readFrameBuffer(FireRenderContext& context)
 	params.shadowTransp = context.m_shadowTransparency;
 	params.bgTransparency = context.m_backgroundTransparency;
 	params.shadowWeight = context.m_shadowWeight;
+	params.consumer = this;
 
-	// process frame buffer
-	context.readFrameBuffer(params);
+	// process frame buffer, pixels are already post processed if nothing changed since the last read
+	if (!context.readFrameBuffer(params))
+		return;
 
 	PostProcess();
 
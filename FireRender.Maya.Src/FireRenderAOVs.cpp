@@ -361,10 +361,15 @@ void FireRenderAOVs::setRenderStamp(const MString& renderStamp)
 }
 
 // -----------------------------------------------------------------------------
-void FireRenderAOVs::readFrameBuffers(FireRenderContext& context)
+void FireRenderAOVs::readFrameBuffers(FireRenderContext& context, bool subscribedOnly)
 {
 	for (auto& aov : m_aovs)
+	{
+		if (subscribedOnly && !context.GetAOVResolveTracker().IsSubscribed(aov.first))
+			continue;
+
 		aov.second->readFrameBuffer(context);
+	}
 }
 
 // -----------------------------------------------------------------------------
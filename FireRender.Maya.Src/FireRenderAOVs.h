@@ -75,8 +75,9 @@ public:
 	/** Free pixels for active AOVs. */
 	void freePixels();
 
-	/** Read the frame buffer pixels for all active AOVs. */
-	void readFrameBuffers(FireRenderContext& context);
+	/** Read the frame buffer pixels for all active AOVs,
+		or only for the ones a consumer has subscribed to in the context. */
+	void readFrameBuffers(FireRenderContext& context, bool subscribedOnly = false);
 
 	/** Write the active AOVs to file. */
 	void writeToFile(const MString& filePath, unsigned int imageFormat, FireRenderAOV::FileWrittenCallback fileWrittenCallback = nullptr);
@@ -27,6 +27,9 @@ limitations under the License.
 #include "maya/MIntArray.h"
 #include "maya/MItDependencyGraph.h"
 #include "maya/MFnAmbientLight.h"
+#include "maya/MFnAttribute.h"
+#include "maya/MNodeClass.h"
+#include "maya/MObjectHandle.h"
 
 #include "FireRenderConvertVRayCmd.h"
 
@@ -35,6 +38,7 @@ limitations under the License.
 #include "Context/FireRenderContext.h"
 #include "FireRenderUtils.h"
 #include "FireRenderMath.h"
+#include "ObjectHandleMap.h"
 #include "VRay.h"
 #include "Translators/Translators.h"
 
@@ -106,7 +110,11 @@ void * FireRenderConvertVRayCmd::creator()
 
 MSyntax FireRenderConvertVRayCmd::newSyntax()
 {
-	return MSyntax();
+	MSyntax syntax;
+
+	CHECK_MSTATUS(syntax.addFlag(kBatchFlag, kBatchFlagLong, MSyntax::kNoArg));
+
+	return syntax;
 }
 
 MDagPathArray FireRenderConvertVRayCmd::GetSelectedObjectsDagPaths()
@@ -187,7 +195,7 @@ FireRenderConvertVRayCmd::FilterVRayObjects(const MDagPathArray & arr)
 }
 
 MDagPathArray
-FireRenderConvertVRayCmd::GetAllSceneVRayObjects()
+FireRenderConvertVRayCmd::GetAllSceneVRayObjects(bool withMaterials)
 {
 	MDagPathArray ret;
 
@@ -213,6 +221,7 @@ FireRenderConvertVRayCmd::GetAllSceneVRayObjects()
 	}
 
 	// 2nd: Find meshes with VRay textures:
+	if (withMaterials)
 	{
 		MItDependencyNodes it(MFn::kMesh);
 
@@ -727,38 +736,18 @@ void FireRenderConvertVRayCmd::AssignMaterialToFaces(MFnDagNode &fnDagNode, cons
 
 MObject FireRenderConvertVRayCmd::ConvertVRayShader(const MFnDependencyNode & shaderNode, MString originalName)
 {
-	MStatus status;
-
-	MTypeId typeId = shaderNode.typeId();
 	auto id = MayaSurfaceId(shaderNode.typeId().id());
 	auto typeName = shaderNode.typeName();
 
-	switch (id)
-	{
-	case VRay::VRayAlSurface:
-		return ConvertVRayAISurfaceShader(shaderNode);
-	case VRay::VRayMtl:
-		return ConvertVRayMtlShader(shaderNode, originalName);
-	case VRay::VRayCarPaintMtl:
-		return ConvertVRayCarPaintShader(shaderNode);
-	case VRay::VRayFastSSS2:
-		return ConvertVRayFastSSS2MtlShader(shaderNode);
-	case VRay::VRayLightMtl:
-		return ConvertVRayLightMtlShader(shaderNode);
-	case VRay::VRayMtlWrapper:
+	if (id == VRay::VRayMtlWrapper)
 		return ConvertVRayMtlWrapperShader(shaderNode, originalName);
-	case VRay::VRayBlendMtl:
-		return ConvertVRayBlendMtlShader(shaderNode, originalName);
-	case VRay::VRayBumpMtl:
-	case VRay::VRayFlakesMtl:
-	case VRay::VRayMeshMaterial:
-	case VRay::VRayMtl2Sided:
-	case VRay::VRayMtlHair3:
-	case VRay::VRayMtlOSL:
-	default:
-		DebugPrint("VRay->RPR Shader: %s [0x%x]", typeName.asUTF8(), id);
-		break;
-	}
+
+	// same mapping as the batch conversion
+	const VRayConversion::ShaderRule* rule = VRayConversion::FindRule(typeName.asUTF8());
+	if (rule)
+		return ConvertVRayShader(*rule, shaderNode, originalName);
+
+	DebugPrint("VRay->RPR Shader: %s [0x%x]", typeName.asUTF8(), id);
 
 	return MObject();
 }
@@ -779,11 +768,15 @@ MStatus FireRenderConvertVRayCmd::doIt(const MArgList & args)
 {
 	MStatus status;
 
-	auto selectedObjects = GetSelectedObjectsDagPaths();
+	MArgDatabase argData(syntax(), args);
+	bool batch = argData.isFlagSet(kBatchFlag);
+
+	// batch mode converts the whole scene, materials are handled separately from lights
+	auto selectedObjects = batch ? MDagPathArray() : GetSelectedObjectsDagPaths();
 
 	auto numberOfSelectedObjects = selectedObjects.length();
 	if (numberOfSelectedObjects == 0)
-		selectedObjects = GetAllSceneVRayObjects();
+		selectedObjects = GetAllSceneVRayObjects(!batch);
 	else
 		selectedObjects = FilterVRayObjects(selectedObjects);
 
@@ -845,6 +838,9 @@ MStatus FireRenderConvertVRayCmd::doIt(const MArgList & args)
 		}
 	}
 
+	if (batch)
+		ConvertVRayMaterialsInBatch(converted, failed);
+
 	/* auto vrayShadersDeleted = */ TryDeleteUnusedVRayMaterials();
 
 	MString message;
@@ -923,6 +919,297 @@ size_t FireRenderConvertVRayCmd::TryDeleteUnusedVRayMaterials()
 	return deleted;
 }
 
+namespace
+{
+	static_assert(FireMaya::Material::Type::kEmissive == 6, "VRayConversionPlan sets the emissive type by value");
+
+	std::string ShortAttributeName(const MPlug& plug)
+	{
+		return MFnAttribute(plug.attribute()).shortName().asUTF8();
+	}
+
+	MPlug FindPlug(const MObject& node, const std::string& attribute)
+	{
+		MStatus status;
+		MPlug plug = MFnDependencyNode(node).findPlug(attribute.c_str(), false, &status);
+
+		if (status.error() || plug.isNull())
+			throw logic_error("Plug can't be found: " + std::string(MFnDependencyNode(node).name().asUTF8()) + "." + attribute);
+
+		return plug;
+	}
+
+	// Numeric values, compounds child by child
+	void QueueCopyValue(MDGModifier& modifier, const MPlug& source, const MPlug& destination)
+	{
+		unsigned int sourceChildren = source.isCompound() ? source.numChildren() : 0;
+		unsigned int destinationChildren = destination.isCompound() ? destination.numChildren() : 0;
+
+		if (destinationChildren == 0)
+		{
+			modifier.newPlugValueFloat(destination, sourceChildren ? source.child(0).asFloat() : source.asFloat());
+			return;
+		}
+
+		for (unsigned int i = 0; i < destinationChildren; i++)
+		{
+			float value = sourceChildren ? source.child(std::min(i, sourceChildren - 1)).asFloat() : source.asFloat();
+			modifier.newPlugValueFloat(destination.child(i), value);
+		}
+	}
+}
+
+void FireRenderConvertVRayCmd::IndexShadingNetwork(VRayConversion::Index& index, std::vector<MObject>& nodes)
+{
+	std::vector<bool> indexedInputs;
+
+	// names are not unique across namespaces, nodes are told apart by identity
+	ObjectHandleMap<MObjectHandle, VRayConversion::NodeId> ids;
+
+	auto addNode = [&](const MObject& object)
+	{
+		MObjectHandle handle(object);
+		if (const VRayConversion::NodeId* known = ids.Find(handle))
+			return *known;
+
+		MFnDependencyNode node(object);
+		VRayConversion::NodeId id = index.AddNode(node.name().asUTF8(), node.typeName().asUTF8());
+		ids.Insert(handle, id);
+
+		nodes.push_back(object);
+		indexedInputs.push_back(false);
+
+		return id;
+	};
+
+	// inputs of VRay materials, recursively for wrapped and blended materials
+	std::function<void(VRayConversion::NodeId)> indexInputs = [&](VRayConversion::NodeId material)
+	{
+		if (indexedInputs[material] || !VRayConversion::IsVRayMaterial(index.Type(material)))
+			return;
+
+		indexedInputs[material] = true;
+
+		MPlugArray plugs;
+		MFnDependencyNode(nodes[material]).getConnections(plugs);
+
+		for (const MPlug& plug : plugs)
+		{
+			MPlugArray sources;
+			if (!plug.connectedTo(sources, true, false))
+				continue;
+
+			for (const MPlug& source : sources)
+			{
+				VRayConversion::NodeId sourceNode = addNode(source.node());
+				index.AddConnection(sourceNode, ShortAttributeName(source), material, ShortAttributeName(plug));
+
+				indexInputs(sourceNode);
+			}
+		}
+	};
+
+	// stands for all set members, only their presence is used
+	VRayConversion::NodeId members = index.AddNode(std::string(), std::string());
+	nodes.push_back(MObject());
+	indexedInputs.push_back(true);
+
+	for (MItDependencyNodes it(MFn::kShadingEngine); !it.isDone(); it.next())
+	{
+		MObject shadingEngineObject = it.item();
+		VRayConversion::NodeId shadingEngine = addNode(shadingEngineObject);
+
+		MFnDependencyNode shadingEngineNode(shadingEngineObject);
+
+		MPlug membersPlug = shadingEngineNode.findPlug("dagSetMembers");
+		if (!membersPlug.isNull() && membersPlug.numConnectedElements() > 0)
+			index.AddConnection(members, std::string(), shadingEngine, "dsm");
+
+		MPlugArray shaders;
+		MPlug surfaceShader = shadingEngineNode.findPlug("surfaceShader");
+		if (surfaceShader.isNull() || !surfaceShader.connectedTo(shaders, true, false) || shaders.length() == 0)
+			continue;
+
+		VRayConversion::NodeId material = addNode(shaders[0].node());
+		index.AddConnection(material, ShortAttributeName(shaders[0]), shadingEngine, "ss");
+
+		indexInputs(material);
+	}
+}
+
+MObject FireRenderConvertVRayCmd::QueueShader(MDGModifier& modifier, const VRayConversion::Shader& shader,
+	const std::vector<MObject>& nodes, const std::vector<MPlug>& upstream)
+{
+	using VRayConversion::Operation;
+	using VRayConversion::Transform;
+
+	// Check everything before the node is queued, so a failing shader leaves nothing behind
+	MNodeClass nodeClass(shader.type.c_str());
+	for (const Operation& operation : shader.operations)
+	{
+		if (nodeClass.attribute(operation.destinationAttribute.c_str()).isNull())
+			throw logic_error("Destination plug can't be found: " + shader.type + "." + operation.destinationAttribute);
+
+		if (operation.kind == Operation::Kind::Connect && upstream[operation.upstream].isNull())
+			throw logic_error("Upstream plug can't be found for: " + operation.destinationAttribute);
+
+		if (operation.kind == Operation::Kind::FromSource)
+			FindPlug(nodes[shader.source], operation.sourceAttribute);
+	}
+
+	MStatus status;
+	MObject shaderNode = modifier.createNode(shader.type.c_str(), &status);
+	if (status.error() || shaderNode.isNull())
+		throw logic_error("Unable to create " + shader.type + " shader");
+
+	if (!shader.name.empty())
+		modifier.renameNode(shaderNode, MString(shader.name.c_str()) + "_RPR");
+
+	for (const Operation& operation : shader.operations)
+	{
+		MPlug destination = FindPlug(shaderNode, operation.destinationAttribute);
+
+		switch (operation.kind)
+		{
+		case Operation::Kind::Connect:
+			modifier.connect(upstream[operation.upstream], destination);
+			break;
+
+		case Operation::Kind::SetBool:
+			modifier.newPlugValueBool(destination, operation.value != 0);
+			break;
+
+		case Operation::Kind::SetInt:
+			modifier.newPlugValueInt(destination, operation.value);
+			break;
+
+		case Operation::Kind::FromSource:
+		{
+			MPlug source = FindPlug(nodes[shader.source], operation.sourceAttribute);
+
+			switch (operation.transform)
+			{
+			case Transform::Copy:
+				QueueCopyValue(modifier, source, destination);
+				break;
+
+			case Transform::OneMinus:
+				modifier.newPlugValueFloat(destination, 1.0f - source.asFloat());
+				break;
+
+			case Transform::Enabled:
+				modifier.newPlugValueBool(destination, source.asFloat() >= std::numeric_limits<float>::epsilon());
+				break;
+
+			case Transform::AsBool:
+				modifier.newPlugValueBool(destination, source.asBool());
+				break;
+
+			case Transform::IorFromReflection:
+				modifier.newPlugValueFloat(destination, (2.0f / (sqrt(source.asFloat()) + 1.0f)) - 1.0f);
+				break;
+			}
+
+			break;
+		}
+		}
+	}
+
+	return shaderNode;
+}
+
+void FireRenderConvertVRayCmd::ConvertVRayMaterialsInBatch(int& converted, int& failed)
+{
+	VRayConversion::Index index;
+	std::vector<MObject> nodes;
+	IndexShadingNetwork(index, nodes);
+
+	VRayConversion::Plan plan = VRayConversion::MakePlan(index);
+
+	DebugPrint("VRay batch conversion: %d shaders, %d upstream plugs, %d assignments, %d unsupported",
+		int(plan.shaders.size()), int(plan.upstream.size()), int(plan.assignments.size()), int(plan.unsupported));
+
+	// textures shared by many materials are looked up once
+	std::vector<MPlug> upstream(plan.upstream.size());
+	for (size_t i = 0; i < plan.upstream.size(); i++)
+	{
+		MStatus status;
+		MPlug plug = MFnDependencyNode(nodes[plan.upstream[i].node]).findPlug(plan.upstream[i].attribute.c_str(), false, &status);
+
+		if (!status.error())
+			upstream[i] = plug;
+	}
+
+	MDGModifier modifier;
+	int queued = 0;
+
+	std::vector<MObject> shaders(plan.shaders.size());
+	for (size_t i = 0; i < plan.shaders.size(); i++)
+	{
+		try
+		{
+			shaders[i] = QueueShader(modifier, plan.shaders[i], nodes, upstream);
+			queued++;
+		}
+		catch (const std::exception& ex)
+		{
+			this->displayError("Failed to convert "_ms + index.Name(plan.shaders[i].source).c_str() + " because of: " + ex.what());
+			failed++;
+		}
+	}
+
+	// shaders created by the modifier are listed like those made by shadingNode -asShader
+	MPlug shaderList = MFnDependencyNode(findDependNode("defaultShaderList1")).findPlug("shaders");
+	if (!shaderList.isNull())
+	{
+		MIntArray indices;
+		shaderList.getExistingArrayAttributeIndices(indices);
+
+		unsigned int next = 0;
+		for (unsigned int i = 0; i < indices.length(); i++)
+			next = std::max(next, unsigned(indices[i]) + 1);
+
+		for (const MObject& shader : shaders)
+		{
+			if (!shader.isNull())
+				modifier.connect(MFnDependencyNode(shader).findPlug("message"), shaderList.elementByLogicalIndex(next++));
+		}
+	}
+
+	std::vector<bool> keep(index.NodeCount(), false);
+	for (const VRayConversion::Assignment& assignment : plan.assignments)
+	{
+		if (shaders[assignment.shader].isNull())
+		{
+			keep[assignment.material] = true;
+			continue;
+		}
+
+		MPlug surfaceShader = MFnDependencyNode(nodes[assignment.shadingEngine]).findPlug("surfaceShader");
+		MPlug material = MFnDependencyNode(nodes[assignment.material]).findPlug(assignment.materialAttribute.c_str());
+
+		modifier.disconnect(material, surfaceShader);
+		modifier.connect(MFnDependencyNode(shaders[assignment.shader]).findPlug("outColor"), surfaceShader);
+	}
+
+	for (VRayConversion::NodeId material : plan.deletions)
+	{
+		if (!keep[material])
+			modifier.deleteNode(nodes[material]);
+	}
+
+	MStatus status = modifier.doIt();
+	if (status.error())
+	{
+		this->displayError("VRay batch conversion failed: "_ms + status.errorString());
+		failed += queued;
+	}
+	else
+	{
+		converted += queued;
+	}
+}
+
 void FireRenderConvertVRayCmd::ExecuteCommand(MString command)
 {
 	DebugPrint("ExecuteCommand: %s", command.asUTF8());
@@ -1132,161 +1419,47 @@ public:
 	}
 };
 
-void DebugDump(const MFnDependencyNode & node)
-{
-	for (auto i = node.attributeCount(); i; i--)
-	{
-		auto attr = node.attribute(i - 1);
-
-		auto type = attr.apiTypeStr();
-
-		auto plug = node.findPlug(attr);
-
-		auto name = plug.name();
-		auto info = plug.info();
-		auto pname = plug.partialName(false, false, false, true, false, false);
-		DebugPrint("%s(%s) [%s]: %s", name.asUTF8(), pname.asUTF8(), type, info.asUTF8());
-	}
-}
-
-MObject FireRenderConvertVRayCmd::ConvertVRayMtlShader(const MFnDependencyNode & originalVRayShader, MString oldName)
-{
-	MStatus status;
-
-	auto shaderNode = CreateShader("RPRUberMaterial", oldName);
-	MFnDependencyNode convertedShader(shaderNode);
-	if (!shaderNode.isNull())
-	{
-		MPlugValueHelper helper(originalVRayShader, shaderNode);
-
-		helper.CopyPlugValue("dc", "diffuseColor");
-
-		helper.SetPlugValue("reflections", true);
-		helper.CopyPlugValue("rlc", "reflectColor");
-		helper.CopyPlugValue("rlca", "reflectIOR");
-		helper.CopyPlugValue("ra", "reflectRoughnessX");
-
-		helper.SetPlugValue("clearCoat", true);
-		helper.CopyPlugValue("rlc", "coatColor");
-		helper.CopyPlugValue("fior", "coatIOR");
-		helper.CopyPlugValue("rrc", "refractColor");
-
-		auto rrcr = helper.GetPlugValue("rrcr").asFloat();
-		helper.SetPlugValue("refraction", rrcr >= std::numeric_limits<float>::epsilon());
-		helper.CopyPlugValue("rrcr", "refractWeight");
-		auto rrg = helper.GetPlugValue("rrg").asFloat();
-		helper.SetPlugValue("refractRoughness", 1.f - rrg);
-		helper.CopyPlugValue("rior", "refractIOR");
-
-		helper.CopyPlugValue("an", "reflectAnisotropy");
-		helper.CopyPlugValue("anr", "reflectAnisotropyRotation");
-
-		auto ssson = helper.GetPlugValue("ssson").asBool();
-		helper.SetPlugValue("sssEnable", ssson);
-		helper.CopyPlugValue("tlc", "sssColor");
-		helper.CopyPlugValue("scdir", "scatteringDirection");
-		helper.CopyPlugValue("sclvl", "sssWeight");
-
-		auto opacity = helper.GetPlugValue("omr").asFloat();
-		helper.SetPlugValue("transparencyLevel", 1.0f - opacity);	// opacity map to transparency color?
-	}
-
-	return shaderNode;
-}
-
-MObject FireRenderConvertVRayCmd::ConvertVRayAISurfaceShader(const MFnDependencyNode & originalVRayShader)
+MObject FireRenderConvertVRayCmd::ConvertVRayShader(const VRayConversion::ShaderRule& rule, const MFnDependencyNode & originalVRayShader, MString oldName)
 {
-	MStatus status;
-
-	auto shaderNode = CreateShader("RPRUberMaterial");
-	MFnDependencyNode convertedShader(shaderNode);
-	if (!shaderNode.isNull())
-	{
-		MPlugValueHelper helper(originalVRayShader, shaderNode);
-
-		helper.CopyPlugValue("diffuse", "diffuseColor");
-
-		helper.CopyPlugValue("diffuseBumpMap", "diffuseNormal");
-
-		helper.SetPlugValue("reflections", true);
-		helper.CopyPlugValue("reflect1", "reflectColor");
-		helper.CopyPlugValue("reflect1IOR", "reflectIOR");
-		helper.CopyPlugValue("reflect1Roughness", "reflectRoughnessX");
-		helper.CopyPlugValue("reflect1BumpMap", "reflectNormal");
-
-		auto opacity = helper.GetPlugValue("opacity").asFloat();
-		helper.SetPlugValue("transparencyLevel", 1.0f - opacity);	// opacity map to transparency color?
-	}
-
+	using VRayConversion::Operation;
+	using VRayConversion::Transform;
 
-	return shaderNode;
-}
+	auto shaderNode = CreateShader(rule.rprType, rule.keepName ? oldName : MString());
 
-MObject FireRenderConvertVRayCmd::ConvertVRayCarPaintShader(const MFnDependencyNode & originalVRayShader)
-{
-	MStatus status;
+	MPlugValueHelper helper(originalVRayShader, shaderNode);
 
-	auto shaderNode = CreateShader("RPRUberMaterial");
-	MFnDependencyNode convertedShader(shaderNode);
-	if (!shaderNode.isNull())
+	for (const VRayConversion::ConstantRule& constant : rule.constants)
 	{
-		MPlugValueHelper helper(originalVRayShader, shaderNode);
-
-		helper.CopyPlugValue("bcol", "diffuseColor");
-
-		helper.CopyPlugValue("bbm", "diffuseNormal");
-
-		helper.SetPlugValue("reflections", true);
-		helper.CopyPlugValue("bcol", "reflectColor");
-
-		auto reflection = helper.GetPlugValue("brfl").asFloat();
-		auto ior = (2.0f / (sqrt(reflection) + 1.0f)) - 1.0f;
-		helper.SetPlugValue("reflectIOR", ior);
-
-		helper.SetPlugValue("clearCoat", true);
-		helper.CopyPlugValue("ctcol", "coatColor");
+		if (constant.kind == Operation::Kind::SetBool)
+			helper.SetPlugValue(constant.destination, constant.value != 0);
+		else
+			helper.SetPlugValue(constant.destination, constant.value);
 	}
 
-
-	return shaderNode;
-}
-
-MObject FireRenderConvertVRayCmd::ConvertVRayFastSSS2MtlShader(const MFnDependencyNode & originalVRayShader)
-{
-	MStatus status;
-
-	auto shaderNode = CreateShader("RPRSubsurfaceMaterial");
-	MFnDependencyNode convertedShader(shaderNode);
-	if (!shaderNode.isNull())
+	for (const VRayConversion::AttributeRule& attribute : rule.attributes)
 	{
-		MPlugValueHelper helper(originalVRayShader, shaderNode);
-
-		helper.CopyPlugValue("df", "surfaceColor");
-		helper.CopyPlugValue("dfa", "surfaceIntensity");
-
-		helper.CopyPlugValue("ssc", "subsurfaceColor");
-
-		helper.CopyPlugValue("scrc", "scatterColor");
-		helper.CopyPlugValue("scrm", "scatterAmount");
-
-		helper.CopyPlugValue("phf", "scatteringDirection");
-	}
+		switch (attribute.transform)
+		{
+		case Transform::Copy:
+			helper.CopyPlugValue(attribute.source, attribute.destination);
+			break;
 
-	return shaderNode;
-}
+		case Transform::OneMinus:
+			helper.SetPlugValue(attribute.destination, 1.0f - helper.GetPlugValue(attribute.source).asFloat());
+			break;
 
-MObject FireRenderConvertVRayCmd::ConvertVRayLightMtlShader(const MFnDependencyNode & originalVRayShader)
-{
-	MStatus status;
+		case Transform::Enabled:
+			helper.SetPlugValue(attribute.destination, helper.GetPlugValue(attribute.source).asFloat() >= std::numeric_limits<float>::epsilon());
+			break;
 
-	auto shaderNode = CreateShader("RPRMaterial");
-	MFnDependencyNode convertedShader(shaderNode);
-	if (!shaderNode.isNull())
-	{
-		MPlugValueHelper helper(originalVRayShader, shaderNode);
-		helper.SetPlugValue("type", (int)FireMaya::Material::Type::kEmissive);
+		case Transform::AsBool:
+			helper.SetPlugValue(attribute.destination, helper.GetPlugValue(attribute.source).asBool());
+			break;
 
-		helper.CopyPlugValue("cl", "color");
+		case Transform::IorFromReflection:
+			helper.SetPlugValue(attribute.destination, (2.0f / (sqrt(helper.GetPlugValue(attribute.source).asFloat()) + 1.0f)) - 1.0f);
+			break;
+		}
 	}
 
 	return shaderNode;
@@ -1308,15 +1481,3 @@ MObject FireRenderConvertVRayCmd::ConvertVRayMtlWrapperShader(const MFnDependenc
 	// It does not look like we can do anything about converting other attributes
 	return shaderNode;
 }
-
-MObject FireRenderConvertVRayCmd::ConvertVRayBlendMtlShader(const MFnDependencyNode & originalVRayShader, MString oldName)
-{
-	MStatus status;
-
-	DebugDump(originalVRayShader);
-
-	auto shaderNode = CreateShader("RPRBlendMaterial");
-
-	// It does not look like we can do anything about converting other attributes
-	return shaderNode;
-}
@@ -21,8 +21,14 @@ limitations under the License.
 #include <maya/MSyntax.h>
 #include <maya/MArgDatabase.h>
 #include <maya/MFnDependencyNode.h>
+#include <maya/MDGModifier.h>
 
 #include "FireRenderUtils.h"
+#include "VRayConversionPlan.h"
+
+// Convert all VRay materials of the scene from one index of the shading network
+#define kBatchFlag "-b"
+#define kBatchFlagLong "-batch"
 
 class FireRenderConvertVRayCmd : public MPxCommand
 {
@@ -44,7 +50,7 @@ public:
 
 private:
 	MDagPathArray GetSelectedObjectsDagPaths();
-	MDagPathArray GetAllSceneVRayObjects();
+	MDagPathArray GetAllSceneVRayObjects(bool withMaterials = true);
 	static MDagPathArray FilterVRayObjects(const MDagPathArray & paths);
 
 private:
@@ -63,19 +69,26 @@ private:
 	void VRayLightDomeShapeConverter(MObject originalVRayObject);
 	bool VRayLightSunShapeConverter(MObject originalVRayObject);
 
-	MObject ConvertVRayMtlShader(const MFnDependencyNode & originalVRayObject, MString oldName);
-	MObject ConvertVRayAISurfaceShader(const MFnDependencyNode & originalVRayObject);
-	MObject ConvertVRayCarPaintShader(const MFnDependencyNode & originalVRayShader);
-	MObject ConvertVRayFastSSS2MtlShader(const MFnDependencyNode & originalVRayShader);
-	MObject ConvertVRayLightMtlShader(const MFnDependencyNode & originalVRayShader);
+	/** Convert a material with the rule the batch conversion uses for its type. */
+	MObject ConvertVRayShader(const VRayConversion::ShaderRule& rule, const MFnDependencyNode & originalVRayShader, MString oldName);
 	MObject ConvertVRayMtlWrapperShader(const MFnDependencyNode & originalVRayObject, MString oldName);
-	MObject ConvertVRayBlendMtlShader(const MFnDependencyNode & originalVRayObject, MString oldName);
 
 	void ExecuteCommand(MString command);
 	MString ExecuteCommandStringResult(MString command);
 	MStringArray ExecuteCommandStringArrayResult(MString command);
 
 	MObject CreateShader(MString type, MString oldName = MString());
+
+	/** Index shading engines of the scene, their materials and material inputs in one pass. */
+	static void IndexShadingNetwork(VRayConversion::Index& index, std::vector<MObject>& nodes);
+
+	/** Convert VRay materials of all shading engines, Maya graph edits are applied with a single modifier. */
+	void ConvertVRayMaterialsInBatch(int& converted, int& failed);
+
+	/** Queue creation of a shader of the plan, throws if it can't be converted. */
+	static MObject QueueShader(MDGModifier& modifier, const VRayConversion::Shader& shader,
+		const std::vector<MObject>& nodes, const std::vector<MPlug>& upstream);
+
 	MObject tryFindAmbientLight();
 	size_t TryDeleteUnusedVRayMaterials();
 };
@@ -30,7 +30,9 @@ limitations under the License.
 #include <maya/MCommonRenderSettingsData.h>
 #include <maya/MFnRenderLayer.h>
 #include "AnimationExporter.h"
+#include "SharedPayload.h"
 
+#include <filesystem>
 #include <fstream>
 #include <regex>
 
@@ -72,6 +74,8 @@ MSyntax FireRenderExportCmd::newSyntax()
 	CHECK_MSTATUS(syntax.addFlag(kCompressionFlag, kCompressionFlagLong, MSyntax::kString));
 	CHECK_MSTATUS(syntax.addFlag(kPadding, kPaddingLong, MSyntax::kString, MSyntax::kLong));
 	CHECK_MSTATUS(syntax.addFlag(kSelectedCamera, kSelectedCameraLong, MSyntax::kString));
+	CHECK_MSTATUS(syntax.addFlag(kSharedPayloadFlag, kSharedPayloadFlagLong, MSyntax::kBoolean));
+	CHECK_MSTATUS(syntax.addFlag(kUnpackFlag, kUnpackFlagLong, MSyntax::kString));
 
 	return syntax;
 }
@@ -307,12 +311,83 @@ unsigned int SetupExportFlags(bool isExportAsSingleFileEnabled, bool isIncludeTe
 	return exportFlags;
 }
 
+std::wstring GetManifestPath(const std::wstring& filePath)
+{
+	std::wstring extension = std::filesystem::u8path(SharedPayload::ManifestExtension).wstring();
+	return std::regex_replace(filePath, std::wregex(L"rpr$"), extension);
+}
+
+// Replaces the exported frame file with its manifest, data is moved into the shared payload
+bool StoreFrameInSharedPayload(SharedPayload::Writer& writer, const std::wstring& filePath)
+{
+	std::filesystem::path framePath(filePath);
+	std::filesystem::path manifestPath(GetManifestPath(filePath));
+
+	{
+		std::ifstream frame(framePath, std::ios::binary);
+		std::ofstream manifest(manifestPath, std::ios::binary | std::ios::trunc);
+
+		if (!frame || !manifest || !writer.WriteFrame(frame, manifest))
+			return false;
+	}
+
+	std::error_code error;
+	return std::filesystem::remove(framePath, error);
+}
+
+MStatus UnpackSharedPayloadFrame(const std::wstring& manifestFilePath, const std::wstring& outputFilePath)
+{
+	std::filesystem::path manifestPath(manifestFilePath);
+	std::ifstream manifest(manifestPath, std::ios::binary);
+
+	std::string payloadName;
+	if (!manifest || !SharedPayload::ReadPayloadName(manifest, payloadName))
+	{
+		MGlobal::displayError("Invalid frame manifest: " + MString(manifestFilePath.c_str()));
+		return MS::kFailure;
+	}
+
+	manifest.seekg(0);
+
+	std::filesystem::path payloadPath = manifestPath.parent_path() / std::filesystem::u8path(payloadName);
+	std::ifstream payload(payloadPath, std::ios::binary);
+	std::ofstream frame(std::filesystem::path(outputFilePath), std::ios::binary | std::ios::trunc);
+
+	if (!payload || !frame || !SharedPayload::ReadFrame(manifest, payload, frame))
+	{
+		MGlobal::displayError("Unable to restore frame from shared payload: " + MString(payloadPath.wstring().c_str()));
+		return MS::kFailure;
+	}
+
+	return MS::kSuccess;
+}
+
 MStatus FireRenderExportCmd::doIt(const MArgList & args)
 {
 	MStatus status;
 
 	MArgDatabase argData(syntax(), args);
 
+	// restores a frame of a sequence exported with shared payload into a regular .rpr file
+	if (argData.isFlagSet(kUnpackFlag))
+	{
+		MString manifestPath;
+		MString outputPath;
+		argData.getFlagArgument(kUnpackFlag, 0, manifestPath);
+
+		if (!argData.isFlagSet(kFilePathFlag))
+		{
+			MGlobal::displayError("File path is missing, use -file flag");
+			return MS::kFailure;
+		}
+
+		argData.getFlagArgument(kFilePathFlag, 0, outputPath);
+
+		return UnpackSharedPayloadFrame(
+			ProcessEnvVarsInFilePath<std::wstring, wchar_t>(manifestPath.asWChar()),
+			ProcessEnvVarsInFilePath<std::wstring, wchar_t>(outputPath.asWChar()));
+	}
+
 	// for the moment, the LoadStore library of RPR only supports the export/import of all scene
 	if (  !argData.isFlagSet(kAllFlag)  )
 	{
@@ -396,6 +471,12 @@ MStatus FireRenderExportCmd::doIt(const MArgList & args)
 		argData.getFlagArgument(kFramesFlag, 4, isIncludeTextureCacheEnabled);
 	}
 
+	bool isSharedPayloadEnabled = false;
+	if (argData.isFlagSet(kSharedPayloadFlag))
+	{
+		argData.getFlagArgument(kSharedPayloadFlag, 0, isSharedPayloadEnabled);
+	}
+
 	MString compressionOption = "None";
 	if (argData.isFlagSet(kCompressionFlag))
 	{
@@ -490,6 +571,31 @@ MStatus FireRenderExportCmd::doIt(const MArgList & args)
 		unsigned int framePadding = 0;
 		argData.getFlagArgument(kPadding, 1, framePadding);
 
+		// static meshes, images and materials are the same in most frames, they are stored once
+		std::ofstream payloadFile;
+		std::unique_ptr<SharedPayload::Writer> payloadWriter;
+
+		if (isSequenceExportEnabled && isSharedPayloadEnabled)
+		{
+			std::filesystem::path payloadPath(fileName + L"." + std::filesystem::u8path(SharedPayload::PayloadExtension).wstring());
+			payloadFile.open(payloadPath, std::ios::binary | std::ios::trunc);
+
+			if (!payloadFile)
+			{
+				MGlobal::displayError("Unable to create shared payload file\n");
+				return MS::kFailure;
+			}
+
+			payloadWriter = std::make_unique<SharedPayload::Writer>(payloadFile, payloadPath.filename().u8string());
+
+			// side files of external file export would stay next to the manifests, outside of the payload
+			if (!isExportAsSingleFileEnabled)
+			{
+				isExportAsSingleFileEnabled = true;
+				MGlobal::displayInfo("Shared payload export stores each frame as a single file\n");
+			}
+		}
+
 		// process each frame
 		for (int frame = firstFrame; frame <= lastFrame; ++frame)
 		{
@@ -540,11 +646,17 @@ MStatus FireRenderExportCmd::doIt(const MArgList & args)
 			rpr_int statusExport = rprsExport(MString(newFilePath.c_str()).asUTF8(), tahoeContextPtr->context(), tahoeContextPtr->scene(),
 				0, 0, 0, 0, 0, 0, SetupExportFlags(isExportAsSingleFileEnabled, isIncludeTextureCacheEnabled, compressionOption));
 			
-			// save config
-			bool res = SaveExportConfig(newFilePath, *tahoeContextPtr, fileName);
-			if (!res)
+			// save config; frames of a shared payload are not .rpr files until they are unpacked,
+			// so the sequence gets one config, named after the payload, instead of one per frame
+			if (!payloadWriter || frame == firstFrame)
 			{
-				MGlobal::displayError("Unable to export render config!\n");
+				std::wstring configFilePath = payloadWriter ? fileName + L".rpr" : newFilePath;
+
+				bool res = SaveExportConfig(configFilePath, *tahoeContextPtr, fileName);
+				if (!res)
+				{
+					MGlobal::displayError("Unable to export render config!\n");
+				}
 			}
 			
 			if (statusExport != RPR_SUCCESS)
@@ -552,6 +664,28 @@ MStatus FireRenderExportCmd::doIt(const MArgList & args)
 				MGlobal::displayError("Unable to export fire render scene\n");
 				return MS::kFailure;
 			}
+
+			if (payloadWriter && !StoreFrameInSharedPayload(*payloadWriter, newFilePath))
+			{
+				MGlobal::displayError("Unable to store frame in shared payload\n");
+				return MS::kFailure;
+			}
+		}
+
+		if (payloadWriter)
+		{
+			const SharedPayload::Stats& stats = payloadWriter->GetStats();
+
+			char message[256];
+			snprintf(message, sizeof(message), "Sequence exported with shared payload: %.1f MB of frames stored in %.1f MB",
+				stats.frameBytes / (1024.0 * 1024.0), (stats.payloadBytes + stats.manifestBytes) / (1024.0 * 1024.0));
+
+			MGlobal::displayInfo(message);
+
+			// only this plugin reads manifests
+			MGlobal::displayInfo("Frames are stored as ." + MString(SharedPayload::ManifestExtension) +
+				" manifests. Restore a frame with \"fireRenderExport -unpack <manifest> -file <frame>.rpr\" before loading it in other RPR tools, "
+				"the render config of the restored frames is " + MString((fileName + L".json").c_str()));
 		}
 
 		return MS::kSuccess;
@@ -32,6 +32,12 @@ limitations under the License.
 #define kPaddingLong "-padding"
 #define kSelectedCamera "-ca"
 #define kSelectedCameraLong "-camera"
+// Sequence frames are written as manifests into one shared payload file. Other RPR tools can't read
+// them, a frame has to be restored into a regular .rpr file with -unpack <manifest> -file <output> first.
+#define kSharedPayloadFlag "-sp"
+#define kSharedPayloadFlagLong "-sharedPayload"
+#define kUnpackFlag "-up"
+#define kUnpackFlagLong "-unpack"
 
 class FireRenderExportCmd : public MPxCommand
 {
@@ -213,6 +213,7 @@ void FireRenderGPUCache::ProcessShaders()
 			continue;
 
 		element.shape.SetShader(nullptr);
+		element.shaders.clear();
 
 		for (unsigned int shaderIdx = 0; shaderIdx < element.shadingEngines.size(); ++shaderIdx)
 		{
@@ -58,7 +58,7 @@ public:
 	static void ShaderDirtyCallback(MObject& node, void* clientData);
 
 	void Rebuild(void);
-	void ProcessShaders(void);
+	virtual void ProcessShaders(void) override;
 
 protected:
 	void ReloadMesh(const MDagPath& meshPath);
@@ -49,6 +49,7 @@ namespace
 		MObject adaptiveTileSize; //hidden attribute
 
 		MObject textureCompression;
+		MObject interactiveTextureSize;
 
 		MObject giClampIrradiance;
 		MObject giClampIrradianceValue;
@@ -126,6 +127,8 @@ namespace
 		MObject denoiserColorOnly;
 		MObject enable16bitCompute;
 
+		MObject denoiserMemoryBudget;
+
 		MObject viewportDenoiseUpscaleEnabled;
 
 		// image saving
@@ -136,6 +139,9 @@ namespace
 		MObject tahoeVersion;
 
 		MObject textureCachePath;
+		MObject textureDiskCacheSize;
+
+		MObject meshCompaction;
 
 		// contour
 		MObject contourIsEnabled;
@@ -188,6 +194,7 @@ namespace
 		MObject renderQuality;
 
 		MObject adaptiveThresholdViewport;
+		MObject targetRefreshTime;
 	}
 
 	bool operator==(const MStringArray& a, const MStringArray& b)
@@ -297,6 +304,13 @@ MStatus FireRenderGlobals::initialize()
 	Attribute::textureCompression = nAttr.create("textureCompression", "texC", MFnNumericData::kBoolean, false, &status);
 	MAKE_INPUT(nAttr);
 
+	// Longest side of textures in viewport and IPR, 0 for full resolution
+	Attribute::interactiveTextureSize = nAttr.create("interactiveTextureSize", "itxs", MFnNumericData::kInt, 2048, &status);
+	MAKE_INPUT(nAttr);
+	nAttr.setMin(0);
+	nAttr.setSoftMax(8192);
+	nAttr.setMax(65536);
+
 	Attribute::giClampIrradiance = nAttr.create("giClampIrradiance", "gici", MFnNumericData::kBoolean, true, &status);
 	MAKE_INPUT(nAttr);
 
@@ -491,6 +505,18 @@ MStatus FireRenderGlobals::initialize()
 	tAttr.setUsedAsFilename(true);
 	addAsGlobalAttribute(tAttr);
 
+	// Size in MB of converted textures kept in the texture cache folder, 0 disables it
+	Attribute::textureDiskCacheSize = nAttr.create("textureDiskCacheSize", "tdcs", MFnNumericData::kInt, 0, &status);
+	MAKE_INPUT(nAttr);
+	nAttr.setMin(0);
+	nAttr.setSoftMax(16384);
+	CHECK_MSTATUS(addAttribute(Attribute::textureDiskCacheSize));
+
+	// Weld normals and uvs and reorder faces of translated meshes before upload
+	Attribute::meshCompaction = nAttr.create("meshCompaction", "mcmp", MFnNumericData::kBoolean, 0, &status);
+	MAKE_INPUT(nAttr);
+	CHECK_MSTATUS(addAttribute(Attribute::meshCompaction));
+
 	MObject switchDetailedLogAttribute = nAttr.create("detailedLog", "rdl", MFnNumericData::kBoolean, 0, &status);
 	MAKE_INPUT(nAttr);
 	nAttr.setStorable(false);
@@ -499,6 +525,7 @@ MStatus FireRenderGlobals::initialize()
 	// Needed for QA and CIS in order to switch on detailed sync and render logs
 
 	CHECK_MSTATUS(addAttribute(Attribute::textureCompression));
+	CHECK_MSTATUS(addAttribute(Attribute::interactiveTextureSize));
 
 	CHECK_MSTATUS(addAttribute(Attribute::giClampIrradiance));
 	CHECK_MSTATUS(addAttribute(Attribute::giClampIrradianceValue));
@@ -980,6 +1007,14 @@ void FireRenderGlobals::createDenoiserAttributes()
 	nAttr.setReadable(false);
 	CHECK_MSTATUS(addAttribute(Attribute::enable16bitCompute));
 
+	// MB, frames needing more are denoised in overlapping tiles; 0 denoises the whole frame at once
+	Attribute::denoiserMemoryBudget = nAttr.create("denoiserMemoryBudget", "dmb", MFnNumericData::kInt, 2048, &status);
+	MAKE_INPUT(nAttr);
+	nAttr.setMin(0);
+	nAttr.setSoftMax(8192);
+	nAttr.setMax(65536);
+	CHECK_MSTATUS(addAttribute(Attribute::denoiserMemoryBudget));
+
 	Attribute::viewportDenoiseUpscaleEnabled = nAttr.create("viewportDenoiseUpscaleEnabled", "vdue", MFnNumericData::kBoolean, true, &status);
 	MAKE_INPUT(nAttr);
 	nAttr.setConnectable(false);
@@ -1150,6 +1185,14 @@ void FireRenderGlobals::createViewportAttributes()
 	nAttr.setMax(1.0);
 
 	CHECK_MSTATUS(addAttribute(ViewportRenderAttributes::adaptiveThresholdViewport));
+
+	// Milliseconds, iterations per viewport update are adapted to it; 0 disables adaptation
+	ViewportRenderAttributes::targetRefreshTime = nAttr.create("viewportTargetRefreshTime", "vtrt", MFnNumericData::kFloat, 40.0, &status);
+	MAKE_INPUT(nAttr);
+	nAttr.setMin(0.0);
+	nAttr.setSoftMax(200.0);
+	nAttr.setMax(10000.0);
+	CHECK_MSTATUS(addAttribute(ViewportRenderAttributes::targetRefreshTime));
 }
 
 /** Return the FR camera mode that matches the given camera type. */
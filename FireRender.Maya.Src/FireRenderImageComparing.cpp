@@ -11,15 +11,22 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ********************************************************************/
 #include "FireRenderImageComparing.h"
+#include "ImageComparingMetrics.h"
 
 #include <RadeonProRender.h> // for get FR_API_VERSION
 #include "common.h"
 #include <sstream>
+#include <vector>
 
 #include <maya/MDoubleArray.h>
 #include <maya/MStringArray.h>
 #include <maya/MImage.h>
 
+#undef min
+#undef max
+
+#include <imageio.h>
+
 void * FireRenderImageComparing::creator()
 {
 	return new FireRenderImageComparing;
@@ -37,6 +44,9 @@ MSyntax FireRenderImageComparing::newSyntax()
 	CHECK_MSTATUS(syntax.addFlag(kImageMixed, kImageMixedLong, MSyntax::kString));
 	CHECK_MSTATUS(syntax.addFlag(kImageBaseLineMixed, kImageBaseLineMixedLong, MSyntax::kString));
 	CHECK_MSTATUS(syntax.addFlag(kRprPluginDetails, kRprPluginDetailsLong, MSyntax::kNoArg));
+	CHECK_MSTATUS(syntax.addFlag(kImageMetrics, kImageMetricsLong, MSyntax::kString, MSyntax::kString));
+	CHECK_MSTATUS(syntax.addFlag(kImageMetricsRmseThreshold, kImageMetricsRmseThresholdLong, MSyntax::kDouble));
+	CHECK_MSTATUS(syntax.addFlag(kImageMetricsMaxErrorThreshold, kImageMetricsMaxErrorThresholdLong, MSyntax::kDouble));
 
 	return syntax;
 }
@@ -96,11 +106,112 @@ float getAvarageDifference(MString imagePath_1, MString imagePath_2) {
 	return -1;
 }
 
+// reads all channels of the image as floats, so HDR values and AOV channels are kept
+bool readFloatImage(const MString& imagePath, std::vector<float>& pixels, unsigned int& width, unsigned int& height, unsigned int& channels)
+{
+	std::string fileName = imagePath.asUTF8();
+
+	OIIO::ImageInput* imgInput = OIIO::ImageInput::create(fileName);
+	if (!imgInput)
+	{
+		return false;
+	}
+
+	OIIO::ImageSpec imgSpec;
+	bool result = imgInput->open(fileName, imgSpec);
+
+	if (result)
+	{
+		width = imgSpec.width;
+		height = imgSpec.height;
+		channels = imgSpec.nchannels;
+
+		pixels.resize(size_t(width) * height * channels);
+		result = imgInput->read_image(OIIO::TypeDesc::FLOAT, pixels.data());
+
+		imgInput->close();
+	}
+
+	delete imgInput;
+
+	return result;
+}
+
+// Result: channel count, 1 if RMSE or max error threshold was exceeded (metrics are then partial) and
+// RMSE, max error, PSNR, SSIM for each channel. -1 if file can't be read, -2 if sizes differ.
+MDoubleArray getImageMetrics(const MString& imagePath_1, const MString& imagePath_2, const ImageComparing::Params& params)
+{
+	MDoubleArray metricsArray;
+
+	std::vector<float> pixels1, pixels2;
+	unsigned int width1 = 0, height1 = 0, channels1 = 0;
+	unsigned int width2 = 0, height2 = 0, channels2 = 0;
+
+	if (!readFloatImage(imagePath_1, pixels1, width1, height1, channels1) ||
+		!readFloatImage(imagePath_2, pixels2, width2, height2, channels2))
+	{
+		metricsArray.append(-1);
+		return metricsArray;
+	}
+
+	if (width1 != width2 || height1 != height2 || channels1 != channels2)
+	{
+		metricsArray.append(-2);
+		return metricsArray;
+	}
+
+	ImageComparing::Result result;
+	if (!ImageComparing::Compare(pixels1.data(), pixels2.data(), width1, height1, channels1, params, result))
+	{
+		metricsArray.append(-1);
+		return metricsArray;
+	}
+
+	metricsArray.append(channels1);
+	metricsArray.append(result.thresholdExceeded ? 1 : 0);
+
+	for (const ImageComparing::ChannelMetrics& channel : result.channels)
+	{
+		metricsArray.append(channel.rmse);
+		metricsArray.append(channel.maxError);
+		metricsArray.append(channel.psnr);
+		metricsArray.append(channel.ssim);
+	}
+
+	return metricsArray;
+}
+
 MStatus FireRenderImageComparing::doIt(const MArgList & args)
 {
 	MStatus status;
 
 	MArgDatabase argData(syntax(), args);
+
+	if (argData.isFlagSet(kImageMetrics))
+	{
+		MString imagePath_1;
+		MString imagePath_2;
+
+		argData.getFlagArgument(kImageMetrics, 0, imagePath_1);
+		argData.getFlagArgument(kImageMetrics, 1, imagePath_2);
+
+		ImageComparing::Params params;
+
+		if (argData.isFlagSet(kImageMetricsRmseThreshold))
+		{
+			argData.getFlagArgument(kImageMetricsRmseThreshold, 0, params.rmseThreshold);
+		}
+
+		if (argData.isFlagSet(kImageMetricsMaxErrorThreshold))
+		{
+			argData.getFlagArgument(kImageMetricsMaxErrorThreshold, 0, params.maxErrorThreshold);
+		}
+
+		setResult(getImageMetrics(imagePath_1, imagePath_2, params));
+
+		return MS::kSuccess;
+	}
+
 	//0: GPU vs BaseLine GPU
 	//1: CPU vs BaseLine CPU
 	//2: Mixed vs BaseLine Mixed
@@ -22,6 +22,9 @@ limitations under the License.
 #define kImageMixed "-iM"
 #define kImageBaseLineMixed "-bM"
 #define kRprPluginDetails "-pD"
+#define kImageMetrics "-iMt"
+#define kImageMetricsRmseThreshold "-iMR"
+#define kImageMetricsMaxErrorThreshold "-iME"
 
 #define kImageGPULong "-imageGPU"
 #define kImageBaseLineGPULong "-baseGPU"
@@ -30,6 +33,9 @@ limitations under the License.
 #define kImageMixedLong "-imageMixed"
 #define kImageBaseLineMixedLong "-baseMixed"
 #define kRprPluginDetailsLong "-rprPluginDetails"
+#define kImageMetricsLong "-imageMetrics"
+#define kImageMetricsRmseThresholdLong "-imageMetricsRmseThreshold"
+#define kImageMetricsMaxErrorThresholdLong "-imageMetricsMaxErrorThreshold"
 
 class FireRenderImageComparing : public MPxCommand
 {
@@ -48,6 +48,7 @@ limitations under the License.
 
 #include "FileSystemUtils.h"
 #include "FireRenderError.h"
+#include "MaterialXmlParser.h"
 
 #include "XMLMaterialExport/XMLMaterialExportCommon.h"
 
@@ -503,10 +504,15 @@ MStatus FireRenderXmlImportCmd::doIt(const MArgList & args)
 		rootNode.name = userDefinedMaterialName;
 	}
 
+	findImageFiles();
+
 	// Parse nodes
 	// - should traverse the node graph starting from root (Uber material node)
 	parseMaterialNode(rootNode);
 
+	m_imageFiles.clear();
+	m_importedImages.clear();
+
 	// Success!
 	return MS::kSuccess;
 }
@@ -837,39 +843,31 @@ void FireRenderXmlImportCmd::parseAttributeParam(MObject shaderNode,
 		}
 		case RPR_MATERIAL_NODE_INPUT_TYPE_IMAGE:
 		{
-			MString newImage = m_directoryPath + MString(attrValue.c_str());
+			// Located by findImageFiles
+			MString newImage = m_imageFiles[attrValue];
 
-			MFileObject fileObject;
-			fileObject.setRawFullName(newImage);
-
-			// Locate the image - either in the material
-			// directory, or in the shared maps directory.
-			if (!fileObject.exists())
+			if (newImage.length() == 0)
 			{
-				newImage = m_directoryPath + "../" + MString(attrValue.c_str());
-				fileObject.setRawFullName(newImage);
-
-				if (!fileObject.exists())
-				{
-					// Try find image by exact input path
-					newImage = MString(attrValue.c_str());
-					fileObject.setRawFullName(newImage);
-
-					if (!fileObject.exists())
-					{
-						// The image was not found in either location.
-						MGlobal::displayError("Unable to find image " + newImage);
-						return;
-					}
-				}
+				// The image was not found in either location.
+				MGlobal::displayError("Unable to find image " + MString(attrValue.c_str()));
+				return;
 			}
 
 			// Import the image if required, or reference it directly
 			// at the location where the material library is installed.
 			if (m_importImages)
 			{
-				MString path = importImageFile(fileObject);
-				attributePlug.setValue(path);
+				// images shared by several nodes are copied once
+				auto imported = m_importedImages.find(attrValue);
+				if (imported == m_importedImages.end())
+				{
+					MFileObject fileObject;
+					fileObject.setRawFullName(newImage);
+
+					imported = m_importedImages.emplace(attrValue, importImageFile(fileObject)).first;
+				}
+
+				attributePlug.setValue(imported->second);
 			}
 			else
 				attributePlug.setValue(newImage);
@@ -887,6 +885,35 @@ void FireRenderXmlImportCmd::parseAttributeParam(MObject shaderNode,
 	}
 }
 
+void FireRenderXmlImportCmd::findImageFiles()
+{
+	m_imageFiles.clear();
+	m_importedImages.clear();
+
+	std::vector<std::string> names;
+	for (const auto& node : nodeGroup)
+	{
+		for (const auto& param : node.second.params)
+		{
+			if (getAttrType(param.second.type) == RPR_MATERIAL_NODE_INPUT_TYPE_IMAGE &&
+				m_imageFiles.emplace(param.second.value, MString()).second)
+			{
+				names.push_back(param.second.value);
+			}
+		}
+	}
+
+	// Locate the images - either in the material
+	// directory, or in the shared maps directory, or by exact input path.
+	std::string directory = m_directoryPath.asChar();
+	std::vector<std::string> paths = MaterialXml::FindFiles(names, { directory, directory + "../" });
+
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		m_imageFiles[names[i]] = paths[i].c_str();
+	}
+}
+
 MString FireRenderXmlImportCmd::importImageFile(const MFileObject& file) const
 {
 	// Get the path to the imported file.
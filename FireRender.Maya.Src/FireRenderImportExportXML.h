@@ -122,8 +122,17 @@ public:
 	/** Get the project source images directory for a material library image file. */
 	MString getSourceImagesDirectory(const MString& filePath) const;
 
+	/** Locate the image files of all nodes at once, before any shading node is created. */
+	void findImageFiles();
+
 private:
 	std::map<std::string, MaterialNode> nodeGroup;
 	MString m_directoryPath;
 	bool m_importImages;
+
+	// image parameter value to the located file, empty if it was not found
+	std::map<std::string, MString> m_imageFiles;
+
+	// image parameter value to the file imported into the project
+	std::map<std::string, MString> m_importedImages;
 };
@@ -609,6 +609,7 @@ void FireRenderIpr::readFrameBuffer()
 	params.bgWeight = m_contextPtr->m_bgWeight;
 	params.bgTransparency = m_contextPtr->m_backgroundTransparency;
 	params.bgColor = m_contextPtr->m_bgColor;
+	params.consumer = this;
 
 	// process frame buffer	
 	m_contextPtr->readFrameBuffer(params);
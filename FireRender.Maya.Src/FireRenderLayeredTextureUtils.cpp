@@ -13,184 +13,54 @@ limitations under the License.
 #pragma once
 #include <FireRenderLayeredTextureUtils.h>
 
+#include <algorithm>
+
 MayaStandardNodeConverters::LayeredTextureConverter::LayeredTextureConverter(const MayaStandardNodeConverters::ConverterParams& params) : BaseConverter(params)
 {
 }
 
-frw::Value MayaStandardNodeConverters::LayeredTextureConverter::ProcessLayers(const std::vector<LayerInfoType>& layers) const
+namespace
 {
-	if (layers.empty())
+	/** LayeredTextureBlend operations on RPR values, constants are folded by the material system */
+	class MaterialSystemOps
 	{
-		return nullptr;
-	}
+	public:
+		typedef frw::Value Value;
 
-	// First node blend with black color.
-	const LayerInfoType& firstLayer = layers.at(layers.size() - 1);
+		explicit MaterialSystemOps(const frw::MaterialSystem& materialSystem) : m_materialSystem(materialSystem) {}
 
-	if (m_params.outPlugName == OUTPUT_COLOR_ATTRIBUTE_NAME)
-	{
-		frw::Value result = BlendColorValueWithLayer({ 0.0, 0.0, 0.0 }, firstLayer);
-		// Reverse order because layers calculated right to left
-		for (auto layer = layers.rbegin() + 1; layer != layers.rend(); layer++)
-		{
-			result = BlendColorValueWithLayer(result, *layer);
-		}
+		Value Mul(const Value& a, const Value& b) const { return m_materialSystem.ValueMul(a, b); }
+		Value Add(const Value& a, const Value& b) const { return m_materialSystem.ValueAdd(a, b); }
+		Value Sub(const Value& a, const Value& b) const { return m_materialSystem.ValueSub(a, b); }
+		Value Max(const Value& a, const Value& b) const { return m_materialSystem.ValueMax(a, b); }
+		Value Min(const Value& a, const Value& b) const { return m_materialSystem.ValueMin(a, b); }
+		Value Abs(const Value& a) const { return m_materialSystem.ValueAbs(a); }
 
-		return m_params.scope.MaterialSystem().ValueClamp(result);
-	}
-	else if (m_params.outPlugName == OUTPUT_ALPHA_ATTRIBUTE_NAME)
-	{
-		frw::Value result = BlendAlphaValueWithLayer({ 1.0 }, firstLayer);
-		// Reverse order because layers calculated right to left
-		for (auto layer = layers.rbegin() + 1; layer != layers.rend(); layer++)
-		{
-			result = BlendAlphaValueWithLayer(result, *layer);
-		}
+		bool IsConstant(const Value& v) const { return v.IsFloat(); }
+		bool IsZero(const Value& v) const { return v.IsFloat() && !v.NonZero(); }
+		bool IsOne(const Value& v) const { return v.IsFloat() && v.x == 1.0f && v.y == 1.0f && v.z == 1.0f; }
 
-		// Can't do clamp here - it resetting alpha to zero, but maybe it isn't necessary
-		return result;
-	}
-	else
-	{
-		return nullptr;
-	}
+	private:
+		const frw::MaterialSystem& m_materialSystem;
+	};
 }
 
-frw::Value MayaStandardNodeConverters::LayeredTextureConverter::BlendColorValueWithLayer(const frw::Value& backgroundValue, const LayerInfoType& foregroundLayer) const
-{
-	switch (foregroundLayer.mode)
-	{
-	case MayaLayeredTextureBlendMode::None:
-		return foregroundLayer.color;
-
-	case MayaLayeredTextureBlendMode::Over:
-	{
-		frw::Value action1 = m_params.scope.MaterialSystem().ValueSub(foregroundLayer.color, backgroundValue);
-		frw::Value action2 = m_params.scope.MaterialSystem().ValueMul(action1, foregroundLayer.alpha);
-		return m_params.scope.MaterialSystem().ValueAdd(backgroundValue, action2);
-	}
-
-	case MayaLayeredTextureBlendMode::In:
-		return m_params.scope.MaterialSystem().ValueMul(backgroundValue, foregroundLayer.alpha);
-
-	case MayaLayeredTextureBlendMode::Out:
-	{
-		frw::Value action1 = m_params.scope.MaterialSystem().ValueSub(1, foregroundLayer.alpha);
-		return m_params.scope.MaterialSystem().ValueMul(backgroundValue, action1);
-	}
-
-	case MayaLayeredTextureBlendMode::Add:
-	{
-		frw::Value action1 = m_params.scope.MaterialSystem().ValueMul(foregroundLayer.color, foregroundLayer.alpha);
-		return m_params.scope.MaterialSystem().ValueAdd(backgroundValue, action1);
-	}
-
-	case MayaLayeredTextureBlendMode::Subtract:
-		return m_params.scope.MaterialSystem().ValueSub(backgroundValue, m_params.scope.MaterialSystem().ValueMul(foregroundLayer.color, foregroundLayer.alpha));
-
-	case MayaLayeredTextureBlendMode::Multiply:
-	{
-		frw::Value action1 = m_params.scope.MaterialSystem().ValueMul(foregroundLayer.color, foregroundLayer.alpha);
-		frw::Value action2 = m_params.scope.MaterialSystem().ValueAdd(action1, 1);
-		frw::Value action3 = m_params.scope.MaterialSystem().ValueSub(action2, foregroundLayer.alpha);
-		return m_params.scope.MaterialSystem().ValueMul(action3, backgroundValue);
-	}
-
-	case MayaLayeredTextureBlendMode::Difference:
-	{
-		frw::Value action1 = m_params.scope.MaterialSystem().ValueSub(foregroundLayer.color, backgroundValue);
-		frw::Value action2 = m_params.scope.MaterialSystem().ValueAbs(action1);
-		frw::Value action3 = m_params.scope.MaterialSystem().ValueMul(action2, foregroundLayer.alpha);
-		frw::Value action4 = m_params.scope.MaterialSystem().ValueSub(1, foregroundLayer.alpha);
-		frw::Value action5 = m_params.scope.MaterialSystem().ValueMul(backgroundValue, action4);
-		return m_params.scope.MaterialSystem().ValueAdd(action3, action5);
-	}
-
-	case MayaLayeredTextureBlendMode::Lighten:
-	{
-		frw::Value action1 = m_params.scope.MaterialSystem().ValueMax(foregroundLayer.color, backgroundValue);
-		frw::Value action2 = m_params.scope.MaterialSystem().ValueMul(action1, foregroundLayer.alpha);
-		frw::Value action3 = m_params.scope.MaterialSystem().ValueSub(1, foregroundLayer.alpha);
-		frw::Value action4 = m_params.scope.MaterialSystem().ValueMul(action3, backgroundValue);
-		return m_params.scope.MaterialSystem().ValueAdd(action2, action4);
-	}
-
-	case MayaLayeredTextureBlendMode::Darken:
-	{
-		frw::Value action1 = m_params.scope.MaterialSystem().ValueMin(foregroundLayer.color, backgroundValue);
-		frw::Value action2 = m_params.scope.MaterialSystem().ValueMul(action1, foregroundLayer.alpha);
-		frw::Value action3 = m_params.scope.MaterialSystem().ValueSub(1, foregroundLayer.alpha);
-		frw::Value action4 = m_params.scope.MaterialSystem().ValueMul(action3, backgroundValue);
-		return m_params.scope.MaterialSystem().ValueAdd(action2, action4);
-	}
-
-	case MayaLayeredTextureBlendMode::Saturate:
-	{
-		frw::Value action1 = m_params.scope.MaterialSystem().ValueMul(foregroundLayer.color, foregroundLayer.alpha);
-		frw::Value action2 = m_params.scope.MaterialSystem().ValueAdd(1, action1);
-		return m_params.scope.MaterialSystem().ValueMul(backgroundValue, action2);
-	}
-
-	case MayaLayeredTextureBlendMode::Desatureate:
-	{
-		frw::Value action1 = m_params.scope.MaterialSystem().ValueMul(foregroundLayer.color, foregroundLayer.alpha);
-		frw::Value action2 = m_params.scope.MaterialSystem().ValueSub(1, action1);
-		return m_params.scope.MaterialSystem().ValueMul(backgroundValue, action2);
-	}
-
-	case MayaLayeredTextureBlendMode::Illuminate:
-	{
-		frw::Value action1 = m_params.scope.MaterialSystem().ValueMul(2, foregroundLayer.color);
-		frw::Value action2 = m_params.scope.MaterialSystem().ValueMul(action1, foregroundLayer.alpha);
-		frw::Value action3 = m_params.scope.MaterialSystem().ValueAdd(action2, 1);
-		frw::Value action4 = m_params.scope.MaterialSystem().ValueSub(action3, foregroundLayer.alpha);
-		return m_params.scope.MaterialSystem().ValueMul(backgroundValue, action4);
-	}
-
-	default:
-		assert(false);
-		return frw::Value();
-	}
-}
-
-frw::Value MayaStandardNodeConverters::LayeredTextureConverter::BlendAlphaValueWithLayer(const frw::Value& backgroundValue, const LayerInfoType& foregroundLayer) const
+frw::Value MayaStandardNodeConverters::LayeredTextureConverter::ProcessLayers(const std::vector<LayerInfoType>& layers) const
 {
-	switch (foregroundLayer.mode)
-	{
-	case MayaLayeredTextureBlendMode::None:
-		return foregroundLayer.alpha;
-
-	case MayaLayeredTextureBlendMode::Over:
+	bool isColorOutput = m_params.outPlugName == OUTPUT_COLOR_ATTRIBUTE_NAME;
+	if (!isColorOutput && m_params.outPlugName != OUTPUT_ALPHA_ATTRIBUTE_NAME)
 	{
-		frw::Value action1 = m_params.scope.MaterialSystem().ValueAdd(backgroundValue, foregroundLayer.alpha);
-		frw::Value action2 = m_params.scope.MaterialSystem().ValueMul(backgroundValue, foregroundLayer.alpha);
-		return m_params.scope.MaterialSystem().ValueSub(action1, action2);
+		return nullptr;
 	}
 
-	case MayaLayeredTextureBlendMode::In:
-		return m_params.scope.MaterialSystem().ValueMul(backgroundValue, foregroundLayer.alpha);
-
-	case MayaLayeredTextureBlendMode::Out:
-	{
-		frw::Value action1 = m_params.scope.MaterialSystem().ValueSub(1, foregroundLayer.alpha);
-		return m_params.scope.MaterialSystem().ValueMul(backgroundValue, action1);
-	}
+	const frw::MaterialSystem& materialSystem = m_params.scope.MaterialSystem();
+	MaterialSystemOps ops(materialSystem);
 
-	case MayaLayeredTextureBlendMode::Add:
-	case MayaLayeredTextureBlendMode::Subtract:
-	case MayaLayeredTextureBlendMode::Multiply:
-	case MayaLayeredTextureBlendMode::Difference:
-	case MayaLayeredTextureBlendMode::Lighten:
-	case MayaLayeredTextureBlendMode::Darken:
-	case MayaLayeredTextureBlendMode::Saturate:
-	case MayaLayeredTextureBlendMode::Desatureate:
-	case MayaLayeredTextureBlendMode::Illuminate:
-		return backgroundValue;
+	// Culled layers leave the background they are blended with, so an empty list still gives a value
+	frw::Value result = LayeredTextureBlend::Process(ops, LayeredTextureBlend::Cull(ops, layers), isColorOutput);
 
-	default:
-		assert(false);
-		return frw::Value();
-	}
+	// Can't clamp alpha - it resetting alpha to zero, but maybe it isn't necessary
+	return isColorOutput ? materialSystem.ValueClamp(result) : result;
 }
 
 MayaStandardNodeConverters::LayeredTextureConverter::LayerInfoType MayaStandardNodeConverters::LayeredTextureConverter::GetLayerInfo(const MPlug& inputsPlug, bool alphaIsLuminance) const
@@ -260,11 +130,13 @@ frw::Value MayaStandardNodeConverters::LayeredTextureConverter::Convert() const
 	for (unsigned int inputIndex = 0; inputIndex < inputsCount; inputIndex++)
 	{
 		MPlug inputsPlug = inputs.elementByPhysicalIndex(inputIndex);
-		LayerInfoType layer = GetLayerInfo(inputsPlug, alphaIsLuminance);
-		if (layer.isVisible)
-		{
-			layers.emplace_back(layer);
-		}
+		layers.emplace_back(GetLayerInfo(inputsPlug, alphaIsLuminance));
+	}
+
+	bool hasVisibleLayers = std::any_of(layers.begin(), layers.end(), [](const LayerInfoType& layer) { return layer.isVisible; });
+	if (!hasVisibleLayers)
+	{
+		return nullptr;
 	}
 
 	return ProcessLayers(layers);
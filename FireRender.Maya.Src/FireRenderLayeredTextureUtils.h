@@ -14,36 +14,15 @@ limitations under the License.
 #include <frWrap.h>
 #include <FireMaya.h>
 #include "MayaStandardNodesSupport/BaseConverter.h"
+#include "MayaStandardNodesSupport/LayeredTextureBlend.h"
 
 namespace MayaStandardNodeConverters
 {
 
 	class LayeredTextureConverter : public BaseConverter
 	{
-		enum class MayaLayeredTextureBlendMode
-		{
-			None,
-			Over,
-			In,
-			Out,
-			Add,
-			Subtract,
-			Multiply,
-			Difference,
-			Lighten,
-			Darken,
-			Saturate,
-			Desatureate,
-			Illuminate
-		};
-
-		struct LayerInfoType
-		{
-			MayaLayeredTextureBlendMode mode;
-			frw::Value color;
-			frw::Value alpha;
-			bool isVisible;
-		};
+		typedef LayeredTextureBlend::BlendMode MayaLayeredTextureBlendMode;
+		typedef LayeredTextureBlend::Layer<frw::Value> LayerInfoType;
 
 		// Output attributes
 		const MString OUTPUT_COLOR_ATTRIBUTE_NAME = "oc";
@@ -69,13 +48,6 @@ namespace MayaStandardNodeConverters
 		/** Iterates through array of LayerInfoType and blends them */
 		frw::Value ProcessLayers(const std::vector<LayerInfoType>& layers) const;
 
-		/**
-			Blends layer with previous calculated value
-			Ignores background alpha value
-		*/
-		frw::Value BlendColorValueWithLayer(const frw::Value& backgroundValue, const LayerInfoType& foregroundLayer) const;
-		frw::Value BlendAlphaValueWithLayer(const frw::Value& backgroundValue, const LayerInfoType& foregroundLayer) const;
-
 		/** Retrieves layer info from the maya plug */
 		LayerInfoType GetLayerInfo(const MPlug& inputsPlug, bool alphaIsLuminance) const;
 	};
@@ -26,6 +26,9 @@ public:
 
 	const FireRenderMesh& GetOriginalFRMeshinstancedObject() const { return m_originalFRMesh; }
 
+	/** Matrix comes from the instancer, not from the DAG path */
+	virtual bool SupportsTransformOnlyUpdate() const final override { return false; }
+
 protected:
 	/** Logic should be changed to not pass DagPath into the function, because it's not used in MASH visibility check */
 	virtual bool IsMeshVisible(const MDagPath& meshPath, const FireRenderContext* context) const final override;
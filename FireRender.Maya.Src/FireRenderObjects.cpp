@@ -80,6 +80,9 @@ FireRenderObject::FireRenderObject(const FireRenderObject& rhs, const std::strin
 FireRenderObject::~FireRenderObject()
 {
 	FireRenderObject::clear();
+
+	if (m.context)
+		m.context->forgetDirtyObject(this);
 }
 
 std::string FireRenderObject::uuid() const
@@ -238,10 +241,38 @@ void FireRenderNode::OnPlugDirty(MObject& node, MPlug &plug)
 
 void FireRenderNode::OnWorldMatrixChanged()
 {
+	// moving a group doesn't rebuild everything below it
+	if (SupportsTransformOnlyUpdate())
+	{
+		context()->setTransformDirtyObject(this);
+		return;
+	}
+
 	m_bIsTransformChanged = true;
 	setDirty();
 }
 
+void FireRenderNode::FreshenTransform(const MMatrix& matrix, bool shouldCalculateHash)
+{
+	UpdateTransform(matrix);
+
+	if (shouldCalculateHash)
+	{
+		m.hash = CalculateHash();
+	}
+}
+
+bool FireRenderNode::IsTransformOnlyPlug(const MPlug& plug) const
+{
+	if (!SupportsTransformOnlyUpdate())
+		return false;
+
+	// dirtied on the shape whenever a transform above it moves, the world matrix callback covers them
+	MString name = MFnAttribute(plug.attribute()).name();
+
+	return name == "worldMatrix" || name == "worldInverseMatrix" || name == "parentMatrix" || name == "parentInverseMatrix";
+}
+
 MMatrix FireRenderNode::GetSelfTransform()
 {
 	return DagPath().inclusiveMatrix();
@@ -402,7 +433,7 @@ void FireRenderObject::RegisterCallbacks()
 
 	if (!m.object.isNull())
 	{
-		AddCallback(MNodeMessage::addNodeDirtyCallback(m.object, NodeDirtyCallback, this));
+		AddCallback(MNodeMessage::addNodeDirtyPlugCallback(m.object, NodeDirtyPlugCallback, this));
 		AddCallback(MNodeMessage::addNodeDirtyPlugCallback(m.object, plugDirty_callback, this));
 		AddCallback(MNodeMessage::addAttributeChangedCallback(m.object, attributeChanged_callback, this));
 		AddCallback(MNodeMessage::addAttributeAddedOrRemovedCallback(m.object, attributeAddedOrRemoved_callback, this));
@@ -433,6 +464,28 @@ void FireRenderObject::NodeDirtyCallback(MObject& node, void* clientData)
 		self->OnNodeDirty();
 }
 
+void FireRenderObject::NodeDirtyPlugCallback(MObject& node, MPlug& plug, void* clientData)
+{
+	if (IsIgnoredPlug(plug))
+		return;
+
+	auto self = static_cast<FireRenderObject*>(clientData);
+	if (self && self->IsTransformOnlyPlug(plug))
+		return;
+
+	DebugPrint("CALLBACK > NodeDirtyCallback(%s)", node.apiTypeStr());
+
+	if (self)
+		self->OnNodeDirty();
+}
+
+bool FireRenderObject::IsIgnoredPlug(const MPlug& plug)
+{
+	MFnAttribute attribute(plug.attribute());
+
+	return DirtyObjectStaging::IsIgnoredAttribute(attribute.name().asChar());
+}
+
 void FireRenderObject::attributeChanged_callback(MNodeMessage::AttributeMessage msg, MPlug& plug, MPlug& otherPlug, void* clientData)
 {
 	if (auto self = static_cast<FireRenderObject*>(clientData))
@@ -487,9 +540,16 @@ void FireRenderObject::SetAllChildrenDirty()
 
 void FireRenderObject::plugDirty_callback(MObject& node, MPlug& plug, void* clientData)
 {
+	if (IsIgnoredPlug(plug))
+		return;
+
+	auto self = static_cast<FireRenderObject*>(clientData);
+	if (self && self->IsTransformOnlyPlug(plug))
+		return;
+
 	DebugPrint("CALLBACK > OnPlugDirty(%s, %s)", node.apiTypeStr(), plug.name().asUTF8());
 
-	if (auto self = static_cast<FireRenderObject*>(clientData))
+	if (self)
 	{
 		self->OnPlugDirty(node, plug);
 	}
@@ -1277,10 +1337,22 @@ bool IsUberEmissive(frw::Shader shader)
 }
 
 void FireRenderMesh::ProcessMesh(const MDagPath& meshPath)
+{
+	ProcessShaders();
+
+	RebuildTransforms();
+
+	// motion blur
+	ProcessMotionBlur(MFnDagNode(Object()));
+
+	setRenderStats(meshPath);
+}
+
+void FireRenderMesh::ProcessShaders()
 {
 	FireRenderContext* context = this->context();
 
-	MFnDependencyNode nodeFn(Object());
+	m.isEmissive = false;
 
 	bool isRPR1 = m.elements.size() > 1;
 	for (int i = 0; i < m.elements.size(); i++) // should be always only 1 for RPR2, but keeping array for now for backward compatibility with RPR1
@@ -1291,6 +1363,7 @@ void FireRenderMesh::ProcessMesh(const MDagPath& meshPath)
 			continue;
 
 		element.shape.SetShader(nullptr);
+		element.shaders.clear();
 
 		unsigned int shaderIdx = isRPR1 ? i : 0;
 		for (; shaderIdx < element.shadingEngines.size(); ++shaderIdx)
@@ -1391,13 +1464,6 @@ void FireRenderMesh::ProcessMesh(const MDagPath& meshPath)
 		}
 
 	}
-
-	RebuildTransforms();
-
-	// motion blur
-	ProcessMotionBlur(MFnDagNode(Object()));
-
-	setRenderStats(meshPath);
 }
 
 void FireRenderMesh::ProcessIBLLight(void)
@@ -1604,12 +1670,12 @@ void FireRenderMesh::GetShapes(std::vector<frw::Shape>& outShapes)
 	MDagPath dagPath = DagPath();
 	if (mainMesh == nullptr)
 	{
-		bool deformationMotionBlurEnabled = IsMotionBlurEnabled(MFnDagNode(dagPath.node())) && TahoeContext::IsGivenContextRPR2(context) && !context->isInteractive();
-		unsigned int motionSamplesCount = deformationMotionBlurEnabled ? context->motionSamples() : 0;
+		unsigned int motionSamplesCount = IsDeformationMotionBlurEnabled() ? context->motionSamples() : 0;
 		//Ignore set objects dirty calls while creating a mesh, because it moght lead to infinite lookps in case if deformtion motion blur is used
 		{
 			ContextSetDirtyObjectAutoLocker locker(*context);
-			outShapes = FireMaya::MeshTranslator::TranslateMesh(context->GetContext(), Object(), m.faceMaterialIndices, motionSamplesCount, dagPath.fullPathName());
+			outShapes = FireMaya::MeshTranslator::TranslateMesh(context->GetContext(), Object(), m.faceMaterialIndices, motionSamplesCount, dagPath.fullPathName(),
+				&context->GetDeformationMotionCache(), &m.geometryKey);
 		}
 
 		m.isMainInstance = true;
@@ -1626,6 +1692,13 @@ void FireRenderMesh::GetShapes(std::vector<frw::Shape>& outShapes)
 	SaveUsedUV(Object());
 }
 
+bool FireRenderMesh::IsDeformationMotionBlurEnabled()
+{
+	FireRenderContext* context = this->context();
+
+	return IsMotionBlurEnabled(MFnDagNode(DagPath().node())) && TahoeContext::IsGivenContextRPR2(context) && !context->isInteractive();
+}
+
 void FireRenderMesh::SaveUsedUV(const MObject& meshNode)
 {
 	if (!meshNode.hasFn(MFn::kMesh))
@@ -1674,12 +1747,11 @@ void FireRenderMesh::SaveUsedUV(const MObject& meshNode)
 
 void FireRenderMesh::RebuildTransforms()
 {
-	MObject node = Object();
-	MFnDagNode meshFn(node);
-	MDagPath meshPath = DagPath();
+	SetShapesTransform(GetSelfTransform());
+}
 
-	MMatrix matrix = GetSelfTransform();
-	
+void FireRenderMesh::SetShapesTransform(const MMatrix& matrix)
+{
 	// convert Maya mesh in cm to m
 	float mfloats[4][4];
 	FireMaya::ScaleMatrixFromCmToMFloats(matrix, mfloats);	
@@ -1693,6 +1765,25 @@ void FireRenderMesh::RebuildTransforms()
 	}
 }
 
+void FireRenderMesh::UpdateTransform(const MMatrix& matrix)
+{
+	SetShapesTransform(matrix);
+
+	// motion is relative to the new position
+	ProcessMotionBlur(MFnDagNode(Object()));
+
+	// portals under an environment light move with the light
+	if (context()->iblLight)
+	{
+		ProcessIBLLight();
+	}
+
+	if (context()->skyLight)
+	{
+		ProcessSkyLight();
+	}
+}
+
 void FireRenderMeshCommon::AssignShadingEngines(const MObjectArray& shadingEngines)
 {
 	for (unsigned int i = 0; i < m.elements.size(); i++)
@@ -1771,6 +1862,7 @@ const std::vector<int>& FireRenderMeshCommon::GetFaceMaterialIndices(void) const
 void FireRenderMesh::OnNodeDirty()
 {
 	m.changed.mesh = true;
+	m.geometryKey.isValid = false;
 	setDirty();
 }
 
@@ -1932,7 +2024,15 @@ void FireRenderLight::Freshen(bool shouldCalculateHash)
 	}
 
 	detachFromScene();
+
+	// area of a mesh light is kept until its mesh is dirtied
+	std::shared_ptr<const MeshLightArea::Triangles> meshArea = m_light.meshArea;
+	MObjectHandle meshAreaNode = m_light.meshAreaNode;
+
 	m_light = FrLight();
+	m_light.meshArea = meshArea;
+	m_light.meshAreaNode = meshAreaNode;
+
 	const MObject& node = Object();
 	const MDagPath& dagPath = DagPath();
 
@@ -2005,6 +2105,39 @@ FireRenderPhysLight::FireRenderPhysLight(FireRenderContext* context, const MDagP
 	FireRenderLight(context, dagPath)
 {}
 
+void FireRenderPhysLight::Freshen(bool shouldCalculateHash)
+{
+	// the emitter mesh depends on the area light shape, so the callbacks follow it
+	RegisterCallbacks();
+	FireRenderLight::Freshen(shouldCalculateHash);
+}
+
+void FireRenderPhysLight::RegisterCallbacks()
+{
+	FireRenderLight::RegisterCallbacks();
+	if (context()->getCallbackCreationDisabled())
+		return;
+
+	MDagPath shapePath;
+	if (PhysicalLightAttributes::GetAreaLightShape(Object()) == PLAMesh && findMeshShapeForMeshPhysicalLight(DagPath(), shapePath))
+	{
+		AddCallback(MNodeMessage::addNodeDirtyCallback(shapePath.node(), MeshDirtyCallback, this));
+	}
+}
+
+void FireRenderPhysLight::OnMeshDirty()
+{
+	GetFrLight().meshArea.reset();
+	setDirty();
+}
+
+void FireRenderPhysLight::MeshDirtyCallback(MObject& node, void* clientData)
+{
+	DebugPrint("CALLBACK > MeshDirtyCallback(%s)", node.apiTypeStr());
+	if (auto self = static_cast<FireRenderPhysLight*>(clientData))
+		self->OnMeshDirty();
+}
+
 //===================
 // Env Light
 //===================
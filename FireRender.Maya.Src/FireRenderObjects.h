@@ -165,6 +165,13 @@ protected:
 	virtual void OnNodeDirty();
 	static void NodeDirtyCallback(MObject& node, void* clientData);
 
+	// Same as NodeDirtyCallback, skips attributes which don't affect rendering
+	static void NodeDirtyPlugCallback(MObject& node, MPlug& plug, void* clientData);
+	static bool IsIgnoredPlug(const MPlug& plug);
+
+	// World space plugs of objects which get their world matrix without a full Freshen
+	virtual bool IsTransformOnlyPlug(const MPlug& plug) const { return false; }
+
 	// attribute changed
 	virtual void attributeChanged(MNodeMessage::AttributeMessage msg, MPlug &plug, MPlug &otherPlug) {}
 	static void attributeChanged_callback(MNodeMessage::AttributeMessage msg, MPlug& plug, MPlug& otherPlug, void* clientData);
@@ -210,6 +217,13 @@ public:
 	virtual void OnWorldMatrixChanged();
 	static void WorldMatrixChangedCallback(MObject& transformNode, MDagMessage::MatrixModifiedFlags& modified, void* clientData);
 
+	// True if a moved object only needs UpdateTransform, world matrices are then
+	// computed by the context for all moved objects at once
+	virtual bool SupportsTransformOnlyUpdate() const { return false; }
+
+	// Update after a move, instead of Freshen
+	void FreshenTransform(const MMatrix& matrix, bool shouldCalculateHash);
+
 	virtual void RegisterCallbacks() override;
 
 	bool IsVisible() { return m_isVisible; }
@@ -252,6 +266,8 @@ protected:
 protected:
 	virtual void UpdateTransform(const MMatrix& matrix) {}
 
+	virtual bool IsTransformOnlyPlug(const MPlug& plug) const override;
+
 	void MarkDirtyTransformRecursive(const MFnTransform& transform);
 	void MarkDirtyAllDirectChildren(const MFnTransform& transform);
 };
@@ -291,6 +307,9 @@ public:
 	void setPrimaryVisibility(bool primaryVisibility);
 	void setContourVisibility(bool contourVisibility);
 
+	// Assigns shaders of the shading engines to the shapes, geometry is kept
+	virtual void ProcessShaders(void) = 0;
+
 protected:
 	// Detach from the scene
 	virtual void detachFromScene() override;
@@ -316,6 +335,10 @@ protected:
 		std::vector<int> faceMaterialIndices;
 		bool isEmissive = false;
 		bool isMainInstance = false;
+
+		// tessellation cache key of the geometry, valid until the mesh node is dirtied
+		FireMaya::MeshTranslator::GeometryKey geometryKey;
+
 		struct
 		{
 			bool mesh = false;
@@ -374,14 +397,23 @@ public:
 	void Rebuild(void);
 	void ReloadMesh(const MDagPath& meshPath);
 	void ProcessMesh(const MDagPath& meshPath);
+	virtual void ProcessShaders(void) override;
 	void ProcessIBLLight(void);
 	void ProcessSkyLight(void);
 	void RebuildTransforms(void);
 
+	virtual bool SupportsTransformOnlyUpdate() const override { return true; }
+
+	// Mesh points are sampled over the shutter interval (RPR2 final render only)
+	bool IsDeformationMotionBlurEnabled(void);
+
 protected:
 	virtual bool IsMeshVisible(const MDagPath& meshPath, const FireRenderContext* context) const;
 	void SaveUsedUV(const MObject& meshNode);
 
+	virtual void UpdateTransform(const MMatrix& matrix) override;
+	void SetShapesTransform(const MMatrix& matrix);
+
 	void SetupObjectId(MObject parentTransform);
 
 private:
@@ -425,6 +457,8 @@ public:
 
 	virtual void Freshen(bool shouldCalculateHash) override;
 
+	virtual bool SupportsTransformOnlyUpdate() const override { return true; }
+
 	// build light for swatch renderer
 	void buildSwatchLight();
 
@@ -459,8 +493,18 @@ public:
 
 	static PLType GetPhysLightType(MObject dagPath);
 
+	virtual bool SupportsTransformOnlyUpdate() const override { return false; }
+
+	virtual void Freshen(bool shouldCalculateHash) override;
+
 protected:
 	virtual bool ShouldUpdateTransformOnly() const;
+
+	// watches the emitter mesh of mesh area lights
+	virtual void RegisterCallbacks() override;
+
+	void OnMeshDirty();
+	static void MeshDirtyCallback(MObject& node, void* clientData);
 };
 
 // Fire render environment light
@@ -892,6 +936,8 @@ public:
 	FireRenderCustomEmitter(FireRenderContext* context, const MDagPath& dagPath);
 
 	void Freshen(bool shouldCalculateHash) override;
+
+	bool SupportsTransformOnlyUpdate() const override { return false; }
 };
 
 bool IsUberEmissive(frw::Shader shader);
@@ -328,6 +328,9 @@ bool FireRenderProduction::Init(int contextWidth, int contextHeight, RenderRegio
 	m_aovs->allocatePixels();
 	m_renderViewAOV = &m_aovs->getRenderViewAOV();
 
+	// Only the displayed AOV is read while rendering, the rest once the render is finished
+	m_contextPtr->GetAOVResolveTracker().Subscribe(this, m_renderViewAOV->id);
+
 	if (showWarningDialog)
 	{
 		rcWarningDialog.show();
@@ -470,6 +473,7 @@ bool FireRenderProduction::stop()
 	if (m_contextPtr)
 	{
 		m_contextPtr->SetState(FireRenderContext::StateExiting);
+		m_contextPtr->GetAOVResolveTracker().UnsubscribeAll(this);
 	}
 
 	stopMayaRender();
@@ -888,6 +892,12 @@ bool FireRenderProduction::RunOnViewportThread()
 				
 				m_contextPtr->m_polycountLastRender = 0;
 
+				{
+					AutoMutexLock contextLock(m_contextLock);
+					AutoMutexLock pixelsLock(m_pixelsLock);
+					m_aovs->readFrameBuffers(*m_contextPtr);
+				}
+
 				DenoiseFromAOVs();
 				stop();
 				m_rendersCount++;
@@ -1074,7 +1084,7 @@ void FireRenderProduction::RenderFullFrame()
 	// Read pixel data for the AOV displayed in the render view.
 	{
 		AutoMutexLock pixelsLock(m_pixelsLock);
-		m_aovs->readFrameBuffers(*m_contextPtr);
+		m_aovs->readFrameBuffers(*m_contextPtr, true);
 
 		FireRenderThread::RunProcOnMainThread([this]()
 		{
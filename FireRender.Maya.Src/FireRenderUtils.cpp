@@ -71,7 +71,11 @@ FireRenderGlobalsData::FireRenderGlobalsData() :
 	adaptiveTileSize(1),
 	adaptiveThreshold(0.0f),
 	adaptiveThresholdViewport(0.0f),
+	viewportTargetRefreshTime(40.0f),
 	textureCompression(false),
+	interactiveTextureSize(2048),
+	textureDiskCacheSize(0),
+	meshCompaction(false),
 	giClampIrradiance(true),
 	giClampIrradianceValue(1.0),
 	samplesPerUpdate(5),
@@ -208,10 +212,18 @@ void FireRenderGlobalsData::readFromCurrentScene()
 		if (!plug.isNull())
 			adaptiveThresholdViewport = plug.asFloat();
 
+		plug = frGlobalsNode.findPlug("viewportTargetRefreshTime");
+		if (!plug.isNull())
+			viewportTargetRefreshTime = plug.asFloat();
+
 		plug = frGlobalsNode.findPlug("textureCompression");
 		if (!plug.isNull())
 			textureCompression = plug.asBool();
 
+		plug = frGlobalsNode.findPlug("interactiveTextureSize");
+		if (!plug.isNull())
+			interactiveTextureSize = plug.asInt();
+
 		plug = frGlobalsNode.findPlug("renderModeViewport");
 		if (!plug.isNull())
 			viewportRenderMode = plug.asInt();
@@ -224,6 +236,14 @@ void FireRenderGlobalsData::readFromCurrentScene()
 		if (!plug.isNull())
 			textureCachePath = plug.asString();
 
+		plug = frGlobalsNode.findPlug("textureDiskCacheSize");
+		if (!plug.isNull())
+			textureDiskCacheSize = plug.asInt();
+
+		plug = frGlobalsNode.findPlug("meshCompaction");
+		if (!plug.isNull())
+			meshCompaction = plug.asBool();
+
 		plug = frGlobalsNode.findPlug("giClampIrradiance");
 		if (!plug.isNull())
 			giClampIrradiance = plug.asBool();
@@ -563,6 +583,10 @@ void FireRenderGlobalsData::readDenoiserParameters(const MFnDependencyNode& frGl
 	if (!plug.isNull())
 		denoiserSettings.enable16bitCompute = plug.asInt() == 1;
 
+	plug = frGlobalsNode.findPlug("denoiserMemoryBudget");
+	if (!plug.isNull())
+		denoiserSettings.memoryBudget = plug.asInt();
+
 	plug = frGlobalsNode.findPlug("viewportDenoiseUpscaleEnabled");
 	if (!plug.isNull())
 		denoiserSettings.viewportDenoiseUpscaleEnabled = plug.asInt() == 1;	
@@ -64,6 +64,7 @@ struct DenoiserSettings
 		trans = 0.0f;
 		colorOnly = false;
 		enable16bitCompute = false;
+		memoryBudget = 0;
 
 		viewportDenoiseUpscaleEnabled = false;
 	}
@@ -81,6 +82,9 @@ struct DenoiserSettings
 	bool colorOnly;
 	bool enable16bitCompute;
 
+	// MB for the working memory of RAM denoising, 0 for no limit
+	int memoryBudget;
+
 	bool viewportDenoiseUpscaleEnabled;
 };
 
@@ -195,13 +199,25 @@ public:
 	float adaptiveThreshold;
 	float adaptiveThresholdViewport;
 
+	// Milliseconds per interactive render call, 0 for a fixed number of iterations
+	float viewportTargetRefreshTime;
+
 	bool textureCompression;
 
+	// Longest side of textures in viewport and IPR, 0 for full resolution
+	int interactiveTextureSize;
+
 	int viewportRenderMode;
 	int renderMode;
 
 	MString textureCachePath;
 
+	// Size in MB of the converted textures disk cache, 0 if disabled
+	int textureDiskCacheSize;
+
+	// Normals and uvs of translated meshes share one index per face-vertex, faces are reordered for cache locality
+	bool meshCompaction;
+
 	// Global Illumination
 	bool giClampIrradiance;
 	float giClampIrradianceValue;
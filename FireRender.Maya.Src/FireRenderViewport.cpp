@@ -807,6 +807,7 @@ void FireRenderViewport::readFrameBuffer(FireMaya::StoredFrame* storedFrame, boo
 	params.mergeOpacity = false;
 	params.shadowColor = m_contextPtr->m_shadowColor;
 	params.shadowTransp = m_contextPtr->m_shadowTransparency;
+	params.consumer = this;
 
 	// Read to a cached frame if supplied.
 	if (storedFrame)
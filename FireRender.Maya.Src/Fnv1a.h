@@ -0,0 +1,47 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/** 64 bit FNV-1a, a fast non cryptographic hash for cache keys */
+class Fnv1a
+{
+public:
+	void Add(const void* data, size_t size)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+		for (size_t i = 0; i < size; i++)
+			m_hash = (m_hash ^ bytes[i]) * Prime;
+	}
+
+	void Add(const std::string& text) { Add(text.data(), text.size()); }
+
+	uint64_t Value() const { return m_hash; }
+
+	static uint64_t Hash(const std::string& text)
+	{
+		Fnv1a hash;
+		hash.Add(text);
+		return hash.Value();
+	}
+
+private:
+	static const uint64_t OffsetBasis = 14695981039346656037ull;
+	static const uint64_t Prime = 1099511628211ull;
+
+	uint64_t m_hash = OffsetBasis;
+};
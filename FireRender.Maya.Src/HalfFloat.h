@@ -0,0 +1,93 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+/** IEEE 754 binary16 conversion with round to nearest even, for half float textures and readback */
+namespace HalfFloat
+{
+	inline uint32_t FloatBits(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+
+	inline float BitsFloat(uint32_t bits)
+	{
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	inline uint16_t FromFloat(float value)
+	{
+		const uint32_t infinityBits = 255u << 23;
+		const uint32_t halfOverflowBits = (127u + 16u) << 23;
+		const uint32_t denormMagicBits = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+		uint32_t bits = FloatBits(value);
+		uint32_t sign = bits & 0x80000000u;
+		bits ^= sign;
+
+		uint16_t result;
+
+		if (bits >= halfOverflowBits)
+		{
+			// NaN stays quiet NaN, everything else too large becomes infinity
+			result = bits > infinityBits ? 0x7e00 : 0x7c00;
+		}
+		else if (bits < (113u << 23))
+		{
+			// denormal or zero: let float addition do the rounding of the shifted mantissa
+			result = uint16_t(FloatBits(BitsFloat(bits) + BitsFloat(denormMagicBits)) - denormMagicBits);
+		}
+		else
+		{
+			uint32_t mantissaOdd = (bits >> 13) & 1;
+
+			bits += (uint32_t(15 - 127) << 23) + 0xfff;
+			bits += mantissaOdd;
+
+			result = uint16_t(bits >> 13);
+		}
+
+		return uint16_t(result | (sign >> 16));
+	}
+
+	inline float ToFloat(uint16_t value)
+	{
+		const uint32_t exponentMask = 0x7c00u << 13;
+
+		uint32_t bits = (value & 0x7fffu) << 13;
+		uint32_t exponent = bits & exponentMask;
+
+		bits += (127u - 15u) << 23;
+
+		if (exponent == exponentMask)
+		{
+			// infinity or NaN
+			bits += (128u - 16u) << 23;
+		}
+		else if (exponent == 0)
+		{
+			// zero or denormal, renormalize
+			bits += 1u << 23;
+			bits = FloatBits(BitsFloat(bits) - BitsFloat(113u << 23));
+		}
+
+		return BitsFloat(bits | (uint32_t(value & 0x8000u) << 16));
+	}
+}
@@ -0,0 +1,336 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "ImageComparingMetrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+namespace ImageComparing
+{
+
+namespace
+{
+	// Pixels handled per inner loop iteration. Inner loops run over Channels * LanePixels
+	// independent accumulators of compile-time size, which compilers turn into SIMD code.
+	const unsigned int LanePixels = 4;
+
+	// Lanes accumulate in float for SIMD throughput and are flushed into doubles
+	// after this many pixels to keep precision on wide images.
+	const unsigned int FlushPixels = 256;
+
+	struct RowAccumulator
+	{
+		double sse;
+		double sae;
+		float maxError;
+	};
+
+	inline float AbsDifference(float a, float b)
+	{
+		float d = std::fabs(a - b);
+
+		// NaN on either side is a regression, never let it pass as zero difference
+		return (d == d) ? d : std::numeric_limits<float>::infinity();
+	}
+
+	template <unsigned int Channels>
+	void ProcessRow(const float* a, const float* b, unsigned int width, RowAccumulator* out)
+	{
+		const unsigned int Lanes = Channels * LanePixels;
+
+		double laneSse[Lanes] = {};
+		double laneSae[Lanes] = {};
+		float laneMax[Lanes] = {};
+
+		unsigned int fullWidth = width - width % LanePixels;
+
+		for (unsigned int chunk = 0; chunk < fullWidth; chunk += FlushPixels)
+		{
+			unsigned int chunkEnd = std::min(chunk + FlushPixels, fullWidth);
+
+			float chunkSse[Lanes] = {};
+			float chunkSae[Lanes] = {};
+
+			for (unsigned int x = chunk; x < chunkEnd; x += LanePixels)
+			{
+				const float* pa = a + size_t(x) * Channels;
+				const float* pb = b + size_t(x) * Channels;
+
+				for (unsigned int i = 0; i < Lanes; i++)
+				{
+					float d = AbsDifference(pa[i], pb[i]);
+
+					chunkSse[i] += d * d;
+					chunkSae[i] += d;
+					laneMax[i] = laneMax[i] > d ? laneMax[i] : d;
+				}
+			}
+
+			for (unsigned int i = 0; i < Lanes; i++)
+			{
+				laneSse[i] += chunkSse[i];
+				laneSae[i] += chunkSae[i];
+			}
+		}
+
+		for (unsigned int i = 0; i < (width - fullWidth) * Channels; i++)
+		{
+			size_t idx = size_t(fullWidth) * Channels + i;
+			float d = AbsDifference(a[idx], b[idx]);
+
+			laneSse[i] += double(d) * d;
+			laneSae[i] += d;
+			laneMax[i] = laneMax[i] > d ? laneMax[i] : d;
+		}
+
+		for (unsigned int c = 0; c < Channels; c++)
+		{
+			out[c] = { 0.0, 0.0, 0.0f };
+
+			for (unsigned int i = c; i < Lanes; i += Channels)
+			{
+				out[c].sse += laneSse[i];
+				out[c].sae += laneSae[i];
+				out[c].maxError = std::max(out[c].maxError, laneMax[i]);
+			}
+		}
+	}
+
+	// Any channel count (AOVs with unusual layouts)
+	void ProcessRowGeneric(const float* a, const float* b, unsigned int width, unsigned int channels, RowAccumulator* out)
+	{
+		for (unsigned int c = 0; c < channels; c++)
+			out[c] = { 0.0, 0.0, 0.0f };
+
+		for (size_t x = 0; x < width; x++)
+		{
+			for (unsigned int c = 0; c < channels; c++)
+			{
+				size_t idx = x * channels + c;
+				float d = AbsDifference(a[idx], b[idx]);
+
+				out[c].sse += double(d) * d;
+				out[c].sae += d;
+				out[c].maxError = std::max(out[c].maxError, d);
+			}
+		}
+	}
+
+	void ProcessRowDispatch(const float* a, const float* b, unsigned int width, unsigned int channels, RowAccumulator* out)
+	{
+		switch (channels)
+		{
+		case 1: ProcessRow<1>(a, b, width, out); break;
+		case 2: ProcessRow<2>(a, b, width, out); break;
+		case 3: ProcessRow<3>(a, b, width, out); break;
+		case 4: ProcessRow<4>(a, b, width, out); break;
+		default: ProcessRowGeneric(a, b, width, channels, out); break;
+		}
+	}
+
+	// Structural similarity of one block of one channel (Wang et al. 2004) with uniform weights
+	double BlockSsim(const float* a, const float* b, unsigned int width, unsigned int channels, unsigned int channel,
+		unsigned int x0, unsigned int y0, unsigned int blockWidth, unsigned int blockHeight, double c1, double c2)
+	{
+		double sumA = 0.0, sumB = 0.0, sumAA = 0.0, sumBB = 0.0, sumAB = 0.0;
+
+		for (unsigned int y = y0; y < y0 + blockHeight; y++)
+		{
+			size_t rowOffset = (size_t(y) * width + x0) * channels + channel;
+
+			for (unsigned int x = 0; x < blockWidth; x++)
+			{
+				double va = a[rowOffset + size_t(x) * channels];
+				double vb = b[rowOffset + size_t(x) * channels];
+
+				sumA += va;
+				sumB += vb;
+				sumAA += va * va;
+				sumBB += vb * vb;
+				sumAB += va * vb;
+			}
+		}
+
+		double n = double(blockWidth) * blockHeight;
+		double meanA = sumA / n;
+		double meanB = sumB / n;
+		double varA = std::max(0.0, sumAA / n - meanA * meanA);
+		double varB = std::max(0.0, sumBB / n - meanB * meanB);
+		double cov = sumAB / n - meanA * meanB;
+
+		return ((2.0 * meanA * meanB + c1) * (2.0 * cov + c2)) /
+			((meanA * meanA + meanB * meanB + c1) * (varA + varB + c2));
+	}
+
+	void AtomicAdd(std::atomic<double>& target, double value)
+	{
+		double expected = target.load(std::memory_order_relaxed);
+		while (!target.compare_exchange_weak(expected, expected + value, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	double Psnr(double mse, double peakValue)
+	{
+		if (mse <= 0.0)
+			return std::numeric_limits<double>::infinity();
+
+		return 10.0 * std::log10(peakValue * peakValue / mse);
+	}
+}
+
+bool Compare(const float* image1, const float* image2,
+	unsigned int width, unsigned int height, unsigned int channels,
+	const Params& params, Result& result)
+{
+	result = Result();
+
+	if (!image1 || !image2 || width == 0 || height == 0 || channels == 0)
+		return false;
+
+	std::vector<RowAccumulator> rows(size_t(height) * channels);
+	std::vector<char> rowProcessed(height, 0);
+
+	const size_t rowStride = size_t(width) * channels;
+	const double sampleCount = double(width) * height * channels;
+	const double mseThreshold = params.rmseThreshold * params.rmseThreshold;
+
+	std::atomic<bool> exceeded(false);
+	std::atomic<double> sseTotal(0.0);
+
+	const int rowCount = int(height);
+
+#pragma omp parallel for schedule(dynamic, 16)
+	for (int y = 0; y < rowCount; y++)
+	{
+		if (exceeded.load(std::memory_order_relaxed))
+			continue;
+
+		RowAccumulator* rowOut = &rows[size_t(y) * channels];
+		ProcessRowDispatch(image1 + y * rowStride, image2 + y * rowStride, width, channels, rowOut);
+		rowProcessed[y] = 1;
+
+		if (params.maxErrorThreshold >= 0.0)
+		{
+			for (unsigned int c = 0; c < channels; c++)
+			{
+				if (rowOut[c].maxError > params.maxErrorThreshold)
+					exceeded = true;
+			}
+		}
+
+		if (params.rmseThreshold >= 0.0)
+		{
+			double rowSse = 0.0;
+			for (unsigned int c = 0; c < channels; c++)
+				rowSse += rowOut[c].sse;
+
+			AtomicAdd(sseTotal, rowSse);
+
+			// remaining rows can only add error, so this is a lower bound of the final MSE
+			if (sseTotal.load(std::memory_order_relaxed) / sampleCount > mseThreshold)
+				exceeded = true;
+		}
+	}
+
+	result.thresholdExceeded = exceeded;
+
+	// reduce in row order to keep results independent of scheduling
+	std::vector<RowAccumulator> totals(channels, RowAccumulator{ 0.0, 0.0, 0.0f });
+	size_t processedRows = 0;
+
+	for (unsigned int y = 0; y < height; y++)
+	{
+		if (!rowProcessed[y])
+			continue;
+
+		processedRows++;
+
+		for (unsigned int c = 0; c < channels; c++)
+		{
+			const RowAccumulator& row = rows[size_t(y) * channels + c];
+
+			totals[c].sse += row.sse;
+			totals[c].sae += row.sae;
+			totals[c].maxError = std::max(totals[c].maxError, row.maxError);
+		}
+	}
+
+	result.channels.resize(channels);
+
+	double pixelCount = double(processedRows) * width;
+	double sseAll = 0.0;
+
+	for (unsigned int c = 0; c < channels; c++)
+	{
+		ChannelMetrics& metrics = result.channels[c];
+
+		double mse = pixelCount > 0.0 ? totals[c].sse / pixelCount : 0.0;
+
+		metrics.meanAbsError = pixelCount > 0.0 ? totals[c].sae / pixelCount : 0.0;
+		metrics.rmse = std::sqrt(mse);
+		metrics.maxError = totals[c].maxError;
+		metrics.psnr = Psnr(mse, params.peakValue);
+
+		sseAll += totals[c].sse;
+	}
+
+	result.rmse = pixelCount > 0.0 ? std::sqrt(sseAll / (pixelCount * channels)) : 0.0;
+
+	if (result.thresholdExceeded || !params.computeSsim || params.ssimBlockSize < 2)
+		return true;
+
+	const unsigned int blockSize = (unsigned int) params.ssimBlockSize;
+	const unsigned int blocksX = (width + blockSize - 1) / blockSize;
+	const int blocksY = int((height + blockSize - 1) / blockSize);
+
+	const double c1 = (0.01 * params.peakValue) * (0.01 * params.peakValue);
+	const double c2 = (0.03 * params.peakValue) * (0.03 * params.peakValue);
+
+	std::vector<double> blockRowSsim(size_t(blocksY) * channels, 0.0);
+
+#pragma omp parallel for schedule(dynamic, 4)
+	for (int by = 0; by < blocksY; by++)
+	{
+		unsigned int y0 = by * blockSize;
+		unsigned int blockHeight = std::min(blockSize, height - y0);
+
+		for (unsigned int bx = 0; bx < blocksX; bx++)
+		{
+			unsigned int x0 = bx * blockSize;
+			unsigned int blockWidth = std::min(blockSize, width - x0);
+
+			for (unsigned int c = 0; c < channels; c++)
+			{
+				blockRowSsim[size_t(by) * channels + c] +=
+					BlockSsim(image1, image2, width, channels, c, x0, y0, blockWidth, blockHeight, c1, c2);
+			}
+		}
+	}
+
+	for (unsigned int c = 0; c < channels; c++)
+	{
+		double sum = 0.0;
+
+		for (int by = 0; by < blocksY; by++)
+			sum += blockRowSsim[size_t(by) * channels + c];
+
+		result.channels[c].ssim = sum / (double(blocksX) * blocksY);
+	}
+
+	return true;
+}
+
+}
@@ -0,0 +1,63 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <vector>
+
+/** Float image comparison used by the image comparing command.
+	Works on interleaved float buffers with any channel count, so HDR renders, alpha
+	and multi-channel AOVs are judged the same way as 8 bit beauty images.
+	Rows are processed in parallel, per-row partial results are reduced in fixed order,
+	so the result does not depend on the number of threads. */
+namespace ImageComparing
+{
+	struct ChannelMetrics
+	{
+		double meanAbsError = 0.0;
+		double rmse = 0.0;
+		double maxError = 0.0;
+		double psnr = 0.0;	// +inf for identical channels
+		double ssim = 1.0;	// mean of per block SSIM
+	};
+
+	struct Params
+	{
+		// value range of the data, used for PSNR and SSIM constants
+		double peakValue = 1.0;
+
+		// side of square SSIM blocks, blocks are not overlapping
+		int ssimBlockSize = 8;
+		bool computeSsim = true;
+
+		// comparison stops as soon as it is known that RMSE over all channels or
+		// max error of any channel will be above the threshold; negative value disables the check
+		double rmseThreshold = -1.0;
+		double maxErrorThreshold = -1.0;
+	};
+
+	struct Result
+	{
+		std::vector<ChannelMetrics> channels;
+
+		// over all channels
+		double rmse = 0.0;
+
+		// comparison was stopped early, metrics are incomplete
+		bool thresholdExceeded = false;
+	};
+
+	// Returns false if sizes are invalid
+	bool Compare(const float* image1, const float* image2,
+		unsigned int width, unsigned int height, unsigned int channels,
+		const Params& params, Result& result);
+}
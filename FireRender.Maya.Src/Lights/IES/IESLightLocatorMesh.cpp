@@ -89,24 +89,19 @@ namespace
 		return nullptr;
 	}
 
-	bool GenerateIESRepresentation(
-		const wchar_t* filename,
-		size_t pointsPerPolyline,
-		float scale,
-		std::vector<MFloatVector>& vertices,
-		std::vector<unsigned int>& indices)
+	std::shared_ptr<IESProfileCache::Profile> LoadIESProfile(const std::wstring& filename)
 	{
-		vertices.clear();
-		indices.clear();
+		const size_t pointsPerPolyline = 32;
+
+		auto profile = std::make_shared<IESProfileCache::Profile>();
 
-		FireRenderError error;
 		IESProcessor processor;
 		IESLightRepresentationParams params;
 		std::vector<std::vector<RadeonProRender::float3>> polylines;
 		params.maxPointsPerPLine = pointsPerPolyline;
-		params.webScale = scale;
+		params.webScale = IES_SCALE_MUL;
 
-		auto parseError = processor.Parse(params.data, filename);
+		auto parseError = processor.Parse(params.data, filename.c_str());
 
 		if (parseError != IESProcessor::ErrorCode::SUCCESS)
 		{
@@ -119,34 +114,32 @@ namespace
 				errorMessage << " (reason: " << errorDescription << ") ";
 			}
 
-			error.set("Parse error", errorMessage.str().c_str(), false, false);
+			profile->errorMessage = errorMessage.str();
+			return profile;
 		}
 
-		if (!error.check())
-		{
-			auto calcError = CalculateIESLightRepresentation(polylines, params);
+		profile->isParsed = true;
+		profile->iesData = processor.ToString(params.data);
 
-			if (calcError != IESLightRepresentationErrorCode::SUCCESS)
-			{
-				std::stringstream errorMessage;
-				const char* errorDescription = DescribeIESError(calcError);
-				errorMessage << "RPR Warning: ies file parsed successfully but failed to build it's representation";
+		auto calcError = CalculateIESLightRepresentation(polylines, params);
 
-				if (errorDescription != nullptr)
-				{
-					errorMessage << " (reason: " << errorDescription << ") ";
-				}
+		if (calcError != IESLightRepresentationErrorCode::SUCCESS)
+		{
+			std::stringstream errorMessage;
+			const char* errorDescription = DescribeIESError(calcError);
+			errorMessage << "RPR Warning: ies file parsed successfully but failed to build it's representation";
 
-				error.set("Show ies form failed", errorMessage.str().c_str());
+			if (errorDescription != nullptr)
+			{
+				errorMessage << " (reason: " << errorDescription << ") ";
 			}
-		}
 
-		if (error.check())
-		{
-			// report failure
-			return false;
+			profile->errorMessage = errorMessage.str();
+			return profile;
 		}
 
+		profile->hasRepresentation = true;
+
 		// Convert polyline to lines
 		for (const auto& polyline : polylines)
 		{
@@ -155,23 +148,39 @@ namespace
 			{
 				const bool duplicateIndex = (nVertex > 0 && nVertex + 1 < verticesCount);
 				const auto& vertex = polyline[nVertex];
-				const unsigned vertexIndex = static_cast<unsigned>(vertices.size());
+				const unsigned vertexIndex = static_cast<unsigned>(profile->vertices.size() / 3);
 
-				indices.insert(indices.end(), duplicateIndex ? 2 : 1, vertexIndex);
-				vertices.emplace_back(vertex.x, vertex.y, vertex.z);
+				profile->indices.insert(profile->indices.end(), duplicateIndex ? 2 : 1, vertexIndex);
+				profile->vertices.insert(profile->vertices.end(), { vertex.x, vertex.y, vertex.z });
 			}
 		}
 
-		// report success
-		return true;
+		return profile;
+	}
+
+	void ReportIESErrors(const IESProfileCache::Profile& profile)
+	{
+		if (profile.errorMessage.empty())
+		{
+			return;
+		}
+
+		FireRenderError error;
+
+		if (!profile.isParsed)
+		{
+			error.set("Parse error", profile.errorMessage.c_str(), false, false);
+		}
+		else
+		{
+			error.set("Show ies form failed", profile.errorMessage.c_str());
+		}
 	}
 
-	void GenerateSphereRepresentation(
-		std::vector<MFloatVector>& vertices,
-		std::vector<unsigned int>& indices)
+	std::shared_ptr<const IESProfileCache::Profile> GenerateSphereRepresentation()
 	{
-		vertices.clear();
-		indices.clear();
+		auto profile = std::make_shared<IESProfileCache::Profile>();
+		profile->hasRepresentation = true;
 
 		// Get the position of the sun.
 		MFloatVector sunPosition(0, 0, 0);
@@ -182,26 +191,33 @@ namespace
 		constexpr size_t sunSphereVertexCount = sunSphereFloatsCount / 3;
 
 		// Reserve memory for vertices
-		vertices.reserve(sunSphereVertexCount);
+		profile->vertices.reserve(sunSphereFloatsCount);
 
 		// Copy vertices
 		for (size_t vertexIdx = 0; vertexIdx < sunSphereVertexCount; vertexIdx++)
 		{
 			const float* p = &lowSpherePoints[vertexIdx * 3];
 
-			vertices.emplace_back(
+			profile->vertices.insert(profile->vertices.end(), {
 				p[0] * 0.5f + sunPosition.x,
 				p[1] * 0.5f + sunPosition.y,
-				p[2] * 0.5f + sunPosition.z);
+				p[2] * 0.5f + sunPosition.z });
 		}
 
 		// Add sun indices using low detail sphere connectivity.
 		constexpr size_t sunSphereIndexCount = StackArraySize(lowSphereWireConnect);
-		indices.resize(sunSphereIndexCount);
-		std::copy(lowSphereWireConnect, lowSphereWireConnect + sunSphereIndexCount, indices.begin());
+		profile->indices.assign(lowSphereWireConnect, lowSphereWireConnect + sunSphereIndexCount);
+
+		return profile;
 	}
 }
 
+IESProfileCache& IESProfileCache::Instance()
+{
+	static IESProfileCache instance(LoadIESProfile);
+	return instance;
+}
+
 bool IESLightLocatorMeshBase::SetFilename(const MString filename, bool forcedUpdate, bool* fileNameChanged)
 {
 	if (fileNameChanged != nullptr)
@@ -220,12 +236,14 @@ bool IESLightLocatorMeshBase::SetFilename(const MString filename, bool forcedUpd
 
 	if (local.empty())
 	{
-		GenerateSphereRepresentation(m_vertices, m_indices);
+		static const std::shared_ptr<const IESProfileCache::Profile> sphere = GenerateSphereRepresentation();
+		m_profile = sphere;
 	}
 	else
 	{
-		const size_t pointsPerPolyline = 32;
-		bool isGenerated = GenerateIESRepresentation(castedName, pointsPerPolyline, IES_SCALE_MUL, m_vertices, m_indices);
+		// Parsed once for all locators and lights using the file
+		m_profile = IESProfileCache::Instance().Get(local);
+		ReportIESErrors(*m_profile);
 	}
 
 	m_filename = filename;
@@ -293,11 +311,11 @@ void IESLightLegacyLocatorMesh::Draw(M3dView& view)
 	glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
 
 	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(3, GL_FLOAT, 0, m_vertices.data());
+	glVertexPointer(3, GL_FLOAT, 0, Vertices());
 
 	glDrawElements(GL_LINES,
-		static_cast<GLsizei>(m_indices.size()),
-		GL_UNSIGNED_INT, m_indices.data());
+		static_cast<GLsizei>(IndexCount()),
+		GL_UNSIGNED_INT, Indices());
 
 	glDisableClientState(GL_VERTEX_ARRAY);
 
@@ -315,8 +333,8 @@ void IESLightLocatorMesh::populateOverrideGeometry(
 	MHWRender::MGeometry &data)
 {
 	// Get the vertex and index counts.
-	unsigned int vertexCount = static_cast<unsigned int>(m_vertices.size());
-	unsigned int indexCount = static_cast<unsigned int>(m_indices.size());
+	unsigned int vertexCount = VertexCount();
+	unsigned int indexCount = IndexCount();
 
 	// Get vertex buffer requirements.
 	auto& vertexBufferDescriptorList = requirements.vertexRequirements();
@@ -358,7 +376,7 @@ void IESLightLocatorMesh::populateOverrideGeometry(
 	// Populate the vertex buffer.
 	if (vertexBuffer && vertices)
 	{
-		memcpy(vertices, m_vertices.data(), sizeof(MFloatVector) * vertexCount);
+		memcpy(vertices, Vertices(), sizeof(MFloatVector) * vertexCount);
 		vertexBuffer->commit(vertices);
 	}
 
@@ -375,7 +393,7 @@ void IESLightLocatorMesh::populateOverrideGeometry(
 
 		if (indices)
 		{
-			memcpy(indices, m_indices.data(), sizeof(unsigned int) * indexCount);
+			memcpy(indices, Indices(), sizeof(unsigned int) * indexCount);
 			indexBuffer->commit(indices);
 		}
 
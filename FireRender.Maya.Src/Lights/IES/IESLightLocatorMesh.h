@@ -19,8 +19,10 @@ limitations under the License.
 #include <maya/MHWGeometryUtilities.h>
 #include <maya/MRenderTargetManager.h>
 
+#include "IESProfileCache.h"
+
 #include <array>
-#include <vector>
+#include <memory>
 
 class IESLightLocatorMeshBase
 {
@@ -28,9 +30,16 @@ public:
 	bool SetFilename(const MString value, bool forcedUpdate, bool* fileNameChanged = nullptr);
 
 protected:
+	unsigned int VertexCount() const { return static_cast<unsigned int>(m_profile->vertices.size() / 3); }
+	const float* Vertices() const { return m_profile->vertices.data(); }
+
+	unsigned int IndexCount() const { return static_cast<unsigned int>(m_profile->indices.size()); }
+	const unsigned int* Indices() const { return m_profile->indices.data(); }
+
 	MString m_filename;
-	std::vector<unsigned int> m_indices;
-	std::vector<MFloatVector> m_vertices;
+
+	// Shared with other locators of the same file, never null
+	std::shared_ptr<const IESProfileCache::Profile> m_profile = std::make_shared<IESProfileCache::Profile>();
 };
 
 /**
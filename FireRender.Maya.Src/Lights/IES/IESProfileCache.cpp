@@ -0,0 +1,79 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "IESProfileCache.h"
+
+#include <filesystem>
+
+IESProfileCache::IESProfileCache(Loader loader) :
+	m_loader(std::move(loader))
+{
+}
+
+std::shared_ptr<const IESProfileCache::Profile> IESProfileCache::Get(const std::wstring& path)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::error_code error;
+	std::filesystem::path filePath(path);
+
+	auto modificationTime = std::filesystem::last_write_time(filePath, error);
+	bool exists = !error;
+
+	unsigned long long fileSize = exists ? (unsigned long long) std::filesystem::file_size(filePath, error) : 0;
+	exists = exists && !error;
+
+	long long time = exists ? (long long) modificationTime.time_since_epoch().count() : 0;
+
+	if (exists)
+	{
+		auto it = m_entries.find(path);
+		if (it != m_entries.end() && it->second.modificationTime == time && it->second.fileSize == fileSize)
+		{
+			return it->second.profile;
+		}
+	}
+
+	m_loadCount++;
+
+	std::shared_ptr<const Profile> profile = m_loader ? m_loader(path) : nullptr;
+	if (!profile)
+	{
+		profile = std::make_shared<Profile>();
+	}
+
+	// missing files are not remembered, the loader reports them on every use
+	if (exists)
+	{
+		m_entries[path] = { time, fileSize, profile };
+	}
+	else
+	{
+		m_entries.erase(path);
+	}
+
+	return profile;
+}
+
+void IESProfileCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_entries.clear();
+}
+
+size_t IESProfileCache::LoadCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return m_loadCount;
+}
@@ -0,0 +1,76 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/** Parsed IES profiles shared by all lights and locators of the session.
+	Stages often use a few profiles on hundreds of fixtures; each file is parsed and its locator web
+	is built once, lights keep a shared reference to the result. Entries are checked against the
+	file modification time and size, so an edited profile is parsed again on next use. */
+class IESProfileCache
+{
+public:
+	struct Profile
+	{
+		// parsing succeeded and iesData is valid
+		bool isParsed = false;
+
+		// profile text as accepted by RPR IES lights
+		std::string iesData;
+
+		// web shown by the locator, xyz per vertex and 2 indices per line
+		bool hasRepresentation = false;
+		std::vector<float> vertices;
+		std::vector<unsigned int> indices;
+
+		// reason of a failure, for the user
+		std::string errorMessage;
+	};
+
+	typedef std::function<std::shared_ptr<Profile>(const std::wstring& path)> Loader;
+
+public:
+	/** Cache parsing profiles with IESProcessor, defined next to the locator mesh that uses it. */
+	static IESProfileCache& Instance();
+
+	explicit IESProfileCache(Loader loader);
+
+	// Never returns null, a profile that failed to load has isParsed false
+	std::shared_ptr<const Profile> Get(const std::wstring& path);
+
+	void Clear();
+
+	// Number of times the loader was called
+	size_t LoadCount() const;
+
+private:
+	struct Entry
+	{
+		long long modificationTime;
+		unsigned long long fileSize;
+		std::shared_ptr<const Profile> profile;
+	};
+
+	Loader m_loader;
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<std::wstring, Entry> m_entries;
+	size_t m_loadCount = 0;
+};
@@ -0,0 +1,164 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "MeshLightArea.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace MeshLightArea
+{
+
+namespace
+{
+	// Triangles per parallel work item, partial sums are reduced in chunk order
+	// to keep results independent of the number of threads
+	const size_t ChunkTriangles = 4096;
+
+	const double UniformScaleTolerance = 1e-6;
+
+	inline void Cross(const double a[3], const double b[3], double out[3])
+	{
+		out[0] = a[1] * b[2] - a[2] * b[1];
+		out[1] = a[2] * b[0] - a[0] * b[2];
+		out[2] = a[0] * b[1] - a[1] * b[0];
+	}
+
+	inline double Dot(const double a[3], const double b[3])
+	{
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+	}
+
+	size_t ChunkCount(size_t triangleCount)
+	{
+		return (triangleCount + ChunkTriangles - 1) / ChunkTriangles;
+	}
+
+	// Returns true if the matrix is a rotation (or reflection) with one scale for all axes
+	bool IsUniformScale(const double matrix[4][4], double& scaleSquared)
+	{
+		double d00 = Dot(matrix[0], matrix[0]);
+		double d11 = Dot(matrix[1], matrix[1]);
+		double d22 = Dot(matrix[2], matrix[2]);
+
+		scaleSquared = (d00 + d11 + d22) / 3.0;
+
+		double tolerance = UniformScaleTolerance * scaleSquared;
+
+		return std::fabs(d00 - scaleSquared) <= tolerance &&
+			std::fabs(d11 - scaleSquared) <= tolerance &&
+			std::fabs(d22 - scaleSquared) <= tolerance &&
+			std::fabs(Dot(matrix[0], matrix[1])) <= tolerance &&
+			std::fabs(Dot(matrix[0], matrix[2])) <= tolerance &&
+			std::fabs(Dot(matrix[1], matrix[2])) <= tolerance;
+	}
+}
+
+std::shared_ptr<Triangles> BuildTriangles(const float* points, const int* triangleVertices, size_t triangleCount)
+{
+	auto result = std::make_shared<Triangles>();
+	result->areaVectors.resize(3 * triangleCount);
+
+	float* areaVectors = result->areaVectors.data();
+
+	const int chunkCount = int(ChunkCount(triangleCount));
+	std::vector<double> chunkAreas(chunkCount, 0.0);
+
+#pragma omp parallel for schedule(dynamic, 4)
+	for (int chunk = 0; chunk < chunkCount; chunk++)
+	{
+		size_t end = std::min(triangleCount, (chunk + 1) * ChunkTriangles);
+		double area = 0.0;
+
+		for (size_t triangle = chunk * ChunkTriangles; triangle < end; triangle++)
+		{
+			const float* p0 = points + 3 * size_t(triangleVertices[3 * triangle]);
+			const float* p1 = points + 3 * size_t(triangleVertices[3 * triangle + 1]);
+			const float* p2 = points + 3 * size_t(triangleVertices[3 * triangle + 2]);
+
+			double edge1[3] = { double(p1[0]) - p0[0], double(p1[1]) - p0[1], double(p1[2]) - p0[2] };
+			double edge2[3] = { double(p2[0]) - p0[0], double(p2[1]) - p0[1], double(p2[2]) - p0[2] };
+
+			double normal[3];
+			Cross(edge1, edge2, normal);
+
+			areaVectors[3 * triangle] = float(normal[0]);
+			areaVectors[3 * triangle + 1] = float(normal[1]);
+			areaVectors[3 * triangle + 2] = float(normal[2]);
+
+			area += std::sqrt(Dot(normal, normal));
+		}
+
+		chunkAreas[chunk] = area;
+	}
+
+	for (double area : chunkAreas)
+	{
+		result->localArea += area;
+	}
+
+	result->localArea /= 2.0;
+
+	return result;
+}
+
+double GetArea(const Triangles& triangles, const double matrix[4][4])
+{
+	double scaleSquared = 1.0;
+	if (IsUniformScale(matrix, scaleSquared))
+	{
+		return triangles.localArea * scaleSquared;
+	}
+
+	// Points are transformed as row vectors, p' = p * M. The cross product of transformed edges
+	// is the cofactor matrix of M applied to the local cross product: its columns are cross products of rows of M.
+	double cofactor[3][3];
+	Cross(matrix[1], matrix[2], cofactor[0]);
+	Cross(matrix[2], matrix[0], cofactor[1]);
+	Cross(matrix[0], matrix[1], cofactor[2]);
+
+	const float* areaVectors = triangles.areaVectors.data();
+	const size_t triangleCount = triangles.areaVectors.size() / 3;
+
+	const int chunkCount = int(ChunkCount(triangleCount));
+	std::vector<double> chunkAreas(chunkCount, 0.0);
+
+#pragma omp parallel for schedule(dynamic, 4)
+	for (int chunk = 0; chunk < chunkCount; chunk++)
+	{
+		size_t end = std::min(triangleCount, (chunk + 1) * ChunkTriangles);
+		double area = 0.0;
+
+		for (size_t triangle = chunk * ChunkTriangles; triangle < end; triangle++)
+		{
+			const float* n = areaVectors + 3 * triangle;
+
+			double x = n[0] * cofactor[0][0] + n[1] * cofactor[1][0] + n[2] * cofactor[2][0];
+			double y = n[0] * cofactor[0][1] + n[1] * cofactor[1][1] + n[2] * cofactor[2][1];
+			double z = n[0] * cofactor[0][2] + n[1] * cofactor[1][2] + n[2] * cofactor[2][2];
+
+			area += std::sqrt(x * x + y * y + z * z);
+		}
+
+		chunkAreas[chunk] = area;
+	}
+
+	double area = 0.0;
+	for (double chunkArea : chunkAreas)
+	{
+		area += chunkArea;
+	}
+
+	return area / 2.0;
+}
+
+}
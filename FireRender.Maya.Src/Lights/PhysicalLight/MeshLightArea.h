@@ -0,0 +1,39 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/** Area of mesh lights, used to normalize their intensity.
+	Triangles of the emitter are reduced once to local space area vectors (edge cross products)
+	which the light keeps until its mesh is dirtied, so light tweaks don't walk the mesh again.
+	The area under a transform is the local area times the squared scale for uniform scales,
+	otherwise the area vectors are transformed by the cofactor matrix and summed in parallel. */
+namespace MeshLightArea
+{
+	struct Triangles
+	{
+		// cross product of the edges of each triangle in local space, xyz; its length is twice the area
+		std::vector<float> areaVectors;
+
+		double localArea = 0.0;
+	};
+
+	// triangleVertices holds 3 point indices per triangle
+	std::shared_ptr<Triangles> BuildTriangles(const float* points, const int* triangleVertices, size_t triangleCount);
+
+	// matrix uses Maya layout (row vectors, translation in the last row), translation is ignored
+	double GetArea(const Triangles& triangles, const double matrix[4][4]);
+}
@@ -15,8 +15,6 @@ limitations under the License.
 #include "FireRenderUtils.h"
 
 #include <math.h>
-#include <maya/MItMeshPolygon.h>
-#include <maya/MPointArray.h>
 
 // Viewport representation
 void FillBuffersForRectangle(GizmoVertexVector& vertices, IndexVector& indices)
@@ -435,11 +433,6 @@ frw::Shape PhysicalLightGeometryUtility::CreateShapeForAreaLight(PLAreaLightShap
 		(int*) &numFaceVertices[0], numFaceVertices.size());
 }
 
-inline float GetAreaBy3Points(const MPoint& point1, const MPoint& point2, const MPoint& point3, const MMatrix& matrix)
-{
-	return (float) (((point2 - point1) * matrix) ^ ((point3 - point1) * matrix)).length() / 2.0f;
-}
-
 float PhysicalLightGeometryUtility::GetAreaOfMeshPrimitive(PLAreaLightShape shapeType, const MMatrix & transformMatrix)
 {
 	MTransformationMatrix trMatrix(transformMatrix);
@@ -474,21 +467,30 @@ float PhysicalLightGeometryUtility::GetAreaOfMeshPrimitive(PLAreaLightShape shap
 	return 0.0f;
 }
 
-float PhysicalLightGeometryUtility::GetAreaOfMesh(const MFnMesh& mesh, const MMatrix & transformMatrix)
+float PhysicalLightGeometryUtility::GetAreaOfMesh(const MFnMesh& mesh, const MMatrix & transformMatrix, std::shared_ptr<const MeshLightArea::Triangles>& triangles)
 {
-	MPointArray points;
-	MIntArray indices;
-	float area = 0.0f;
-
-	for (MItMeshPolygon iter(mesh.object()); !iter.isDone(); iter.next())
+	if (!triangles)
 	{
-		iter.getTriangles(points, indices);
+		MStatus status;
 
-		for (unsigned int i = 0; i < indices.length(); i += 3)
+		const float* points = mesh.getRawPoints(&status);
+		if (points == nullptr || mesh.numVertices() == 0)
 		{
-			area += GetAreaBy3Points(points[i], points[i + 1], points[i + 2], transformMatrix);
+			return 0.0f;
 		}
+
+		MIntArray triangleCounts;
+		MIntArray triangleVertices;
+		mesh.getTriangles(triangleCounts, triangleVertices);
+
+		std::vector<int> vertices(triangleVertices.length());
+		triangleVertices.get(vertices.data());
+
+		triangles = MeshLightArea::BuildTriangles(points, vertices.data(), vertices.size() / 3);
 	}
 
-	return area;
+	double matrix[4][4];
+	transformMatrix.get(matrix);
+
+	return (float) MeshLightArea::GetArea(*triangles, matrix);
 }
@@ -13,6 +13,7 @@ limitations under the License.
 #pragma once
 
 #include "PhysicalLightData.h"
+#include "MeshLightArea.h"
 #include "FireMaya.h"
 #include "FireRenderObjects.h"
 
@@ -45,7 +46,8 @@ public:
 	static bool FillGizmoGeometryForSphereLight(GizmoVertexVector& vertexVector, IndexVector& indexVector, float sphereRadius);
 
 	// Mesh Area calculation
-	static float GetAreaOfMesh(const MFnMesh& mesh, const MMatrix & transformMatrix);
+	// triangles of the mesh are built when empty and reused by the next calls until the caller resets them
+	static float GetAreaOfMesh(const MFnMesh& mesh, const MMatrix & transformMatrix, std::shared_ptr<const MeshLightArea::Triangles>& triangles);
 	static float GetAreaOfMeshPrimitive(PLAreaLightShape shapeType, const MMatrix & transformMatrix);
 
 	// Mesh for RPR engine
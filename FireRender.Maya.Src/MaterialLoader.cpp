@@ -25,6 +25,7 @@ limitations under the License.
 #include "frWrap.h"
 #include "FileSystemUtils.h"
 #include "FireRenderImportExportXML.h"
+#include "MaterialXmlParser.h"
 #include "XMLMaterialExport/XMLMaterialExportCommon.h"
 #include "RPRStringIDMapper.h"
 
@@ -254,160 +255,6 @@ namespace
 		bool top_written; // show is element in top of m_nodes stack already written into xml or not.
 	};
 
-	class XmlReader
-	{
-	public:
-		struct Node
-		{
-			std::string name;
-			std::string text;
-			std::map<string, string> atts;
-			bool is_closing;
-			Node() : name(""), text(""), is_closing(false) {};
-		};
-
-		XmlReader(const std::string& file) noexcept
-			: m_xml_text("")
-			, m_is_open(false)
-			, m_is_end(false)
-			, m_self_closing(false)
-		{
-			std::ifstream doc(file);
-			m_is_open = doc.is_open();
-			m_is_end = !m_is_open;
-			if (m_is_open)
-			{
-				m_xml_text = std::move(std::string((std::istreambuf_iterator<char>(doc)), std::istreambuf_iterator<char>()));
-				next();
-			}
-		}
-
-		bool isOpen() const noexcept
-		{
-			return m_is_open;
-		}
-
-		bool isEnd() const noexcept
-		{
-			return m_is_end;
-		}
-		bool next() noexcept
-		{
-			//root element is closed
-			if (!m_is_open || m_is_end)
-				return false;
-
-			if (m_self_closing)
-			{
-				m_self_closing = false;
-				Node& node = m_nodes.top();
-				node.is_closing = true;
-				return true;
-			}
-
-			try
-			{
-				//remove last node if its closed
-				if (!m_nodes.empty() && m_nodes.top().is_closing)
-					m_nodes.pop();
-
-				//regex for searching XML nodes
-				std::regex node_reg("<[^<^>]*>");
-				std::smatch node_match;
-				m_is_end = !std::regex_search(m_xml_text, node_match, node_reg);
-				if (m_is_end)
-					return !m_is_end;
-
-				if (node_match.size() == 0)
-					Throw("Invalid xml: bad node");
-
-				std::string value = node_match[0];
-				std::regex name_reg("[^<][^>\\s/]+"); //ignoring '<' symbol
-				std::smatch name_match;
-				std::regex_search(value, name_match, name_reg);
-
-				//create new node if this is not closing one
-				if (name_match.str().find('/') == std::string::npos)
-					m_nodes.push(Node());
-
-				Node& node = m_nodes.top();
-				node.name = name_match.str();
-				const std::string ksc_ending = "/>"; //self-closing node ending
-				if (value.size() > ksc_ending.size())
-					m_self_closing = std::equal(ksc_ending.rbegin(), ksc_ending.rend(), value.rbegin());
-
-				if (node.name.find('/') != std::string::npos)
-				{
-					node.is_closing = true;
-					node.name.erase(std::remove(node.name.begin(), node.name.end(), '/')); //remove closing '/'
-				}
-				std::regex att_split_reg("[\\S]+=\".*?\""); //split attributes regex string="string"
-				std::string attributes = name_match.suffix().str();
-				auto att_split_begin = std::sregex_iterator(attributes.begin(), attributes.end(), att_split_reg);
-				auto att_split_end = std::sregex_iterator();
-
-				//parsing attributes
-				for (auto i = att_split_begin; i != att_split_end; ++i)
-				{
-					std::string att = i->str();
-					std::regex att_reg("[^=?>\"]+");
-					auto att_begin = std::sregex_iterator(att.begin(), att.end(), att_reg);
-					auto att_end = std::sregex_iterator();
-					std::vector<std::string> splited_att;
-					splited_att.reserve(2); //should be 2 values
-					for (auto j = att_begin; j != att_end; ++j)
-					{
-						splited_att.push_back(j->str());
-					}
-
-					if (splited_att.size() == 2)
-						node.atts[splited_att[0]] = splited_att[1];
-					else // value="" case
-						node.atts[splited_att[0]] = "";
-				}
-				//cut parsed data
-				m_xml_text = node_match.suffix().str();
-				//looking for node text data
-				size_t pos = m_xml_text.find('<');
-				if (pos != std::string::npos && !m_self_closing)
-				{
-
-					std::string text = "Quick brown fox";
-					std::regex vowel_re("a|e|i|o|u");
-
-					// write the results to an output iterator
-
-					node.text = m_xml_text.substr(0, pos);
-					node.text = std::regex_replace(node.text, std::regex("^[\\s]+"), std::string("")); //removing beginning white-spaces
-					node.text = std::regex_replace(node.text, std::regex("[\\s]+^"), std::string("")); //removing ending white-spaces
-					node.text = std::regex_replace(node.text, std::regex("[\\s]+"), std::string(" ")); //replace multiple white-spaces by single space
-				}
-			}
-			catch (std::exception e)
-			{
-				cout << "Regex exception: " << e.what() << endl;
-				m_is_end = true;
-			}
-			return !m_is_end;
-		}
-
-		const Node& get() const
-		{
-			return m_nodes.top();
-		}
-	private:
-		void Throw(const std::string& msg)
-		{
-			m_is_end = true;
-			throw std::runtime_error(msg);
-		}
-		std::string m_xml_text;
-		bool m_is_open;
-		bool m_is_end;
-		bool m_self_closing;
-		std::stack<Node> m_nodes; //stored previously opened but not closed nodes
-	};
-
 	rpr_material_node CreateMaterial(rpr_material_system sys, const MaterialNode& node, const std::string& name)
 	{
 		rpr_material_node mat = nullptr;
@@ -629,82 +476,57 @@ void ExportMaterials(const std::string& filename, rpr_material_node* materials,
 
 bool ImportMaterials(const std::string& filename, std::map<std::string, MaterialNode> &nodes, std::string& materialName)
 {
-	XmlReader read(filename);
-	if (!read.isOpen())
+	MaterialXml::Document document;
+	std::string error;
+
+	if (!MaterialXml::ParseFile(filename, document, error))
 	{
-		std::cout << "Failed to open file " << filename << std::endl;
+		cout << "MaterialImport error: " << error << endl;
 		return false;
 	}
 
-	MaterialNode* last_node = nullptr;
+	if (!document.version.empty())
+	{
+		std::stringstream version_stream;
+		version_stream << std::hex << document.version;
+		int version;
+		version_stream >> version;
+		if (version != kVersion)
+			std::cout << "Warning: Invalid API version. Expected " << hex << kVersion << "." << std::endl;
+	}
+
+	materialName = document.materialName;
 
 	bool root = true;
-	try
+	for (MaterialXml::Node& node : document.nodes)
 	{
-		while (!read.isEnd())
+		MaterialNode* last_node = &(nodes[node.name]);
+		last_node->name = node.name;
+		last_node->type = node.type;
+		last_node->parsedObject = MObject();
+		last_node->parsed = false;
+		last_node->root = root;
+		root = false;
+
+		// Special handling for input textures: add 2d placement
+		if (last_node->type == "INPUT_TEXTURE")
 		{
-			const XmlReader::Node& node = read.get();
-			if (!node.is_closing)
+			auto placement = &(nodes[Place2dNodeName]);
+
+			if (placement->name.empty())
 			{
-				if (node.name == "node")
-				{
-					auto name = read.get().atts.at("name");
-					last_node = &(nodes[name]);
-					last_node->name = name;
-					last_node->type = read.get().atts.at("type");
-					last_node->parsedObject = MObject();
-					last_node->parsed = false;
-					last_node->root = root;
-					if (root)
-						root = !root;
-					// Special handling for input textures: add 2d placement
-					if (last_node->type == "INPUT_TEXTURE")
-					{
-						auto placement = &(nodes[Place2dNodeName]);
-
-						if (placement->name.empty())
-						{
-							placement->name = Place2dNodeName;
-							placement->root = false;
-							placement->type = "PLACE_2D_TEXTURE";
-							placement->parsedObject = MObject();
-							placement->parsed = false;
-						}
-					}
-				}
-				else if (node.name == "param")
-				{
-					auto param_name = read.get().atts.at("name");
-					auto param_type = read.get().atts.at("type");
-					auto param_value = read.get().atts.at("value");
-					if (last_node != nullptr)
-						last_node->params[param_name] = { param_type, param_value };
-				}
-				else if (node.name == "description")
-				{
-					//TODO: handle description
-					//description = read.get().text;
-				}
-				else if (node.name == "material")
-				{
-					std::stringstream version_stream;
-					version_stream << std::hex << node.atts.at("version_rpr");
-					int version;
-					version_stream >> version;
-					if (version != kVersion)
-						std::cout << "Warning: Invalid API version. Expected " << hex << kVersion << "." << std::endl;
-
-					materialName = node.atts.at("name");
-				}
+				placement->name = Place2dNodeName;
+				placement->root = false;
+				placement->type = "PLACE_2D_TEXTURE";
+				placement->parsedObject = MObject();
+				placement->parsed = false;
 			}
-			read.next();
 		}
+
+		for (MaterialXml::Param& param : node.params)
+			last_node->params[param.name] = { std::move(param.type), std::move(param.value) };
 	}
-	catch (const std::exception& e)
-	{
-		cout << "MaterialImport error: " << e.what() << endl;
-		return false;
-	}
+
 	return true;
 }
 
@@ -0,0 +1,277 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "MaterialXmlParser.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace MaterialXml
+{
+
+namespace
+{
+	struct Tag
+	{
+		size_t begin;
+		size_t end;	// past '>'
+		std::string name;
+		bool isClosing;
+		bool isSelfClosing;
+	};
+
+	bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+	}
+
+	// Next element tag at or after pos, comments, declarations and processing instructions are skipped
+	bool NextTag(const std::string& text, size_t pos, Tag& tag)
+	{
+		for (;;)
+		{
+			pos = text.find('<', pos);
+			if (pos == std::string::npos)
+				return false;
+
+			if (text.compare(pos, 4, "<!--") == 0)
+			{
+				size_t commentEnd = text.find("-->", pos + 4);
+				if (commentEnd == std::string::npos)
+					throw std::runtime_error("Invalid xml: unterminated comment");
+
+				pos = commentEnd + 3;
+				continue;
+			}
+
+			size_t close = text.find('>', pos + 1);
+			if (close == std::string::npos)
+				throw std::runtime_error("Invalid xml: bad node");
+
+			if (text[pos + 1] == '?' || text[pos + 1] == '!')
+			{
+				pos = close + 1;
+				continue;
+			}
+
+			tag.begin = pos;
+			tag.end = close + 1;
+			tag.isClosing = text[pos + 1] == '/';
+			tag.isSelfClosing = !tag.isClosing && text[close - 1] == '/';
+
+			size_t nameBegin = pos + (tag.isClosing ? 2 : 1);
+			size_t nameEnd = nameBegin;
+			while (nameEnd < close && !IsSpace(text[nameEnd]) && text[nameEnd] != '/')
+				nameEnd++;
+
+			tag.name.assign(text, nameBegin, nameEnd - nameBegin);
+			return true;
+		}
+	}
+
+	// Value of an attribute of the tag, quoted with ' or "
+	bool FindAttribute(const std::string& text, const Tag& tag, const char* name, std::string& value)
+	{
+		size_t nameLength = strlen(name);
+		size_t pos = tag.begin + 1 + tag.name.size();
+
+		while (pos < tag.end)
+		{
+			while (pos < tag.end && IsSpace(text[pos]))
+				pos++;
+
+			size_t equal = text.find('=', pos);
+			if (equal == std::string::npos || equal >= tag.end)
+				return false;
+
+			size_t quote = equal + 1;
+			while (quote < tag.end && IsSpace(text[quote]))
+				quote++;
+
+			if (quote >= tag.end || (text[quote] != '"' && text[quote] != '\''))
+				return false;
+
+			size_t valueEnd = text.find(text[quote], quote + 1);
+			if (valueEnd == std::string::npos || valueEnd >= tag.end)
+				return false;
+
+			size_t keyEnd = equal;
+			while (keyEnd > pos && IsSpace(text[keyEnd - 1]))
+				keyEnd--;
+
+			if (keyEnd - pos == nameLength && text.compare(pos, nameLength, name) == 0)
+			{
+				value.assign(text, quote + 1, valueEnd - quote - 1);
+				return true;
+			}
+
+			pos = valueEnd + 1;
+		}
+
+		return false;
+	}
+
+	std::string GetAttribute(const std::string& text, const Tag& tag, const char* name)
+	{
+		std::string value;
+		if (!FindAttribute(text, tag, name, value))
+			throw std::runtime_error("Invalid xml: " + tag.name + " without " + name);
+
+		return value;
+	}
+
+	void ParseNode(const std::string& text, Node& node)
+	{
+		Tag tag;
+		NextTag(text, node.begin, tag);
+
+		node.name = GetAttribute(text, tag, "name");
+		node.type = GetAttribute(text, tag, "type");
+
+		size_t pos = tag.end;
+		while (pos < node.end && NextTag(text, pos, tag) && tag.begin < node.end)
+		{
+			if (!tag.isClosing && tag.name == "param")
+			{
+				Param param;
+				param.name = GetAttribute(text, tag, "name");
+				param.type = GetAttribute(text, tag, "type");
+				param.value = GetAttribute(text, tag, "value");
+
+				node.params.push_back(std::move(param));
+			}
+
+			pos = tag.end;
+		}
+	}
+}
+
+bool Parse(const std::string& text, Document& document, std::string& error)
+{
+	document = Document();
+
+	try
+	{
+		// Index pass: only tag names are read, node contents are skipped
+		Tag tag;
+		size_t pos = 0;
+		const size_t NoNode = size_t(-1);
+		size_t openNode = NoNode;
+
+		while (NextTag(text, pos, tag))
+		{
+			if (tag.name == "node")
+			{
+				if (!tag.isClosing)
+				{
+					document.nodes.emplace_back();
+					document.nodes.back().begin = tag.begin;
+					document.nodes.back().end = tag.end;
+					openNode = tag.isSelfClosing ? NoNode : document.nodes.size() - 1;
+				}
+				else if (openNode != NoNode)
+				{
+					document.nodes[openNode].end = tag.end;
+					openNode = NoNode;
+				}
+			}
+			else if (tag.name == "material" && !tag.isClosing)
+			{
+				document.materialName = GetAttribute(text, tag, "name");
+				FindAttribute(text, tag, "version_rpr", document.version);
+			}
+
+			pos = tag.end;
+		}
+
+		if (openNode != NoNode)
+			throw std::runtime_error("Invalid xml: node " + std::to_string(openNode) + " is not closed");
+	}
+	catch (const std::exception& e)
+	{
+		error = e.what();
+		return false;
+	}
+
+	const int nodeCount = int(document.nodes.size());
+	std::vector<std::string> errors(nodeCount);
+
+#pragma omp parallel for schedule(dynamic, 16)
+	for (int i = 0; i < nodeCount; i++)
+	{
+		try
+		{
+			ParseNode(text, document.nodes[i]);
+		}
+		catch (const std::exception& e)
+		{
+			errors[i] = e.what();
+		}
+	}
+
+	for (const std::string& nodeError : errors)
+	{
+		if (!nodeError.empty())
+		{
+			error = nodeError;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool ParseFile(const std::string& path, Document& document, std::string& error)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+	{
+		error = "Failed to open file " + path;
+		return false;
+	}
+
+	std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	return Parse(text, document, error);
+}
+
+std::vector<std::string> FindFiles(const std::vector<std::string>& names, const std::vector<std::string>& directories)
+{
+	std::vector<std::string> paths(names.size());
+	const int nameCount = int(names.size());
+
+#pragma omp parallel for schedule(dynamic, 1)
+	for (int i = 0; i < nameCount; i++)
+	{
+		std::error_code error;
+
+		for (const std::string& directory : directories)
+		{
+			std::string path = directory + names[i];
+			if (std::filesystem::exists(path, error))
+			{
+				paths[i] = path;
+				break;
+			}
+		}
+
+		if (paths[i].empty() && std::filesystem::exists(names[i], error))
+			paths[i] = names[i];
+	}
+
+	return paths;
+}
+
+}
@@ -0,0 +1,62 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <string>
+#include <vector>
+
+/** Reading of material library XML files.
+	The document is scanned once, recording the offsets of node elements; nodes are then parsed
+	concurrently from their own ranges. Nothing here depends on Maya, nodes are turned into
+	shading nodes by the import command. */
+namespace MaterialXml
+{
+	struct Param
+	{
+		std::string name;
+		std::string type;
+		std::string value;
+	};
+
+	struct Node
+	{
+		std::string name;
+		std::string type;
+
+		// in document order
+		std::vector<Param> params;
+
+		// range of the element in the document
+		size_t begin = 0;
+		size_t end = 0;
+	};
+
+	struct Document
+	{
+		std::string materialName;
+
+		// hex RPR version the material was exported with, empty if not given
+		std::string version;
+
+		// in document order, the first one is the root of the material
+		std::vector<Node> nodes;
+	};
+
+	// Returns false with a message if the document is malformed
+	bool Parse(const std::string& text, Document& document, std::string& error);
+	bool ParseFile(const std::string& path, Document& document, std::string& error);
+
+	// Full path of each file looked up in the directories in order, then as given; empty if not found.
+	// Files are looked up concurrently, each name should be given once.
+	std::vector<std::string> FindFiles(const std::vector<std::string>& names, const std::vector<std::string>& directories);
+}
@@ -0,0 +1,342 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cassert>
+#include <vector>
+
+/** Blending of layeredTexture layers.
+	Layers are ordered from top to bottom and blended bottom up over black colour and alpha 1.
+	All functions take an Ops object providing:
+	typedef Value - constructible from double;
+	Value Mul/Add/Sub/Max/Min(const Value& a, const Value& b), Value Abs(const Value& a);
+	bool IsConstant(const Value& v), bool IsZero(const Value& v), bool IsOne(const Value& v). */
+namespace LayeredTextureBlend
+{
+	// values of the layeredTexture blendMode attribute
+	enum class BlendMode
+	{
+		None,
+		Over,
+		In,
+		Out,
+		Add,
+		Subtract,
+		Multiply,
+		Difference,
+		Lighten,
+		Darken,
+		Saturate,
+		Desatureate,
+		Illuminate
+	};
+
+	template <typename Value>
+	struct Layer
+	{
+		BlendMode mode;
+		Value color;
+		Value alpha;
+		bool isVisible;
+	};
+
+	/** Blends layer colour with the background colour, ignores background alpha */
+	template <typename Ops>
+	typename Ops::Value BlendColor(const Ops& ops, const typename Ops::Value& background, const Layer<typename Ops::Value>& layer)
+	{
+		typedef typename Ops::Value Value;
+
+		switch (layer.mode)
+		{
+		case BlendMode::None:
+			return layer.color;
+
+		case BlendMode::Over:
+			return ops.Add(background, ops.Mul(ops.Sub(layer.color, background), layer.alpha));
+
+		case BlendMode::In:
+			return ops.Mul(background, layer.alpha);
+
+		case BlendMode::Out:
+			return ops.Mul(background, ops.Sub(Value(1.0), layer.alpha));
+
+		case BlendMode::Add:
+			return ops.Add(background, ops.Mul(layer.color, layer.alpha));
+
+		case BlendMode::Subtract:
+			return ops.Sub(background, ops.Mul(layer.color, layer.alpha));
+
+		case BlendMode::Multiply:
+			return ops.Mul(ops.Sub(ops.Add(ops.Mul(layer.color, layer.alpha), Value(1.0)), layer.alpha), background);
+
+		case BlendMode::Difference:
+			return ops.Add(ops.Mul(ops.Abs(ops.Sub(layer.color, background)), layer.alpha), ops.Mul(background, ops.Sub(Value(1.0), layer.alpha)));
+
+		case BlendMode::Lighten:
+			return ops.Add(ops.Mul(ops.Max(layer.color, background), layer.alpha), ops.Mul(ops.Sub(Value(1.0), layer.alpha), background));
+
+		case BlendMode::Darken:
+			return ops.Add(ops.Mul(ops.Min(layer.color, background), layer.alpha), ops.Mul(ops.Sub(Value(1.0), layer.alpha), background));
+
+		case BlendMode::Saturate:
+			return ops.Mul(background, ops.Add(Value(1.0), ops.Mul(layer.color, layer.alpha)));
+
+		case BlendMode::Desatureate:
+			return ops.Mul(background, ops.Sub(Value(1.0), ops.Mul(layer.color, layer.alpha)));
+
+		case BlendMode::Illuminate:
+			return ops.Mul(background, ops.Sub(ops.Add(ops.Mul(ops.Mul(Value(2.0), layer.color), layer.alpha), Value(1.0)), layer.alpha));
+
+		default:
+			assert(false);
+			return background;
+		}
+	}
+
+	/** Blends layer alpha with the background alpha, colour blend modes keep the background alpha */
+	template <typename Ops>
+	typename Ops::Value BlendAlpha(const Ops& ops, const typename Ops::Value& background, const Layer<typename Ops::Value>& layer)
+	{
+		typedef typename Ops::Value Value;
+
+		switch (layer.mode)
+		{
+		case BlendMode::None:
+			return layer.alpha;
+
+		case BlendMode::Over:
+			return ops.Sub(ops.Add(background, layer.alpha), ops.Mul(background, layer.alpha));
+
+		case BlendMode::In:
+			return ops.Mul(background, layer.alpha);
+
+		case BlendMode::Out:
+			return ops.Mul(background, ops.Sub(Value(1.0), layer.alpha));
+
+		default:
+			return background;
+		}
+	}
+
+	/**
+		Returns false if the layer is not constant or its blend is not linear in the background.
+		Otherwise the layer blend equals background * scale + offset, so runs of such layers fold into one.
+	*/
+	template <typename Ops>
+	bool GetConstantBlend(const Ops& ops, const Layer<typename Ops::Value>& layer, bool isColor, typename Ops::Value& scale, typename Ops::Value& offset)
+	{
+		typedef typename Ops::Value Value;
+
+		const Value& alpha = layer.alpha;
+
+		if (!isColor)
+		{
+			switch (layer.mode)
+			{
+			case BlendMode::None:
+			case BlendMode::Over:
+			case BlendMode::In:
+			case BlendMode::Out:
+				break;
+
+			default:
+				// alpha is passed through
+				scale = 1.0;
+				offset = 0.0;
+				return true;
+			}
+
+			if (!ops.IsConstant(alpha))
+			{
+				return false;
+			}
+
+			switch (layer.mode)
+			{
+			case BlendMode::None:
+				scale = 0.0;
+				offset = alpha;
+				return true;
+
+			case BlendMode::Over:
+				scale = ops.Sub(Value(1.0), alpha);
+				offset = alpha;
+				return true;
+
+			case BlendMode::In:
+				scale = alpha;
+				offset = 0.0;
+				return true;
+
+			default:
+				scale = ops.Sub(Value(1.0), alpha);
+				offset = 0.0;
+				return true;
+			}
+		}
+
+		if (!ops.IsConstant(alpha) || !ops.IsConstant(layer.color))
+		{
+			return false;
+		}
+
+		// same expressions as in BlendColor
+		Value colorAlpha = ops.Mul(layer.color, alpha);
+
+		switch (layer.mode)
+		{
+		case BlendMode::None:
+			scale = 0.0;
+			offset = layer.color;
+			return true;
+
+		case BlendMode::Over:
+			scale = ops.Sub(Value(1.0), alpha);
+			offset = colorAlpha;
+			return true;
+
+		case BlendMode::In:
+			scale = alpha;
+			offset = 0.0;
+			return true;
+
+		case BlendMode::Out:
+			scale = ops.Sub(Value(1.0), alpha);
+			offset = 0.0;
+			return true;
+
+		case BlendMode::Add:
+			scale = 1.0;
+			offset = colorAlpha;
+			return true;
+
+		case BlendMode::Subtract:
+			scale = 1.0;
+			offset = ops.Sub(Value(0.0), colorAlpha);
+			return true;
+
+		case BlendMode::Multiply:
+			scale = ops.Sub(ops.Add(colorAlpha, Value(1.0)), alpha);
+			offset = 0.0;
+			return true;
+
+		case BlendMode::Saturate:
+			scale = ops.Add(Value(1.0), colorAlpha);
+			offset = 0.0;
+			return true;
+
+		case BlendMode::Desatureate:
+			scale = ops.Sub(Value(1.0), colorAlpha);
+			offset = 0.0;
+			return true;
+
+		case BlendMode::Illuminate:
+			scale = ops.Sub(ops.Add(ops.Mul(Value(2.0), colorAlpha), Value(1.0)), alpha);
+			offset = 0.0;
+			return true;
+
+		default:
+			// Difference, Lighten and Darken depend on the background value
+			return false;
+		}
+	}
+
+	/**
+		Removes layers that can't change the result: hidden and fully transparent layers and
+		everything under the topmost layer that hides its background, which becomes a None layer
+	*/
+	template <typename Ops>
+	std::vector<Layer<typename Ops::Value>> Cull(const Ops& ops, const std::vector<Layer<typename Ops::Value>>& layers)
+	{
+		typedef typename Ops::Value Value;
+
+		std::vector<Layer<Value>> result;
+		result.reserve(layers.size());
+
+		for (const Layer<Value>& layer : layers)
+		{
+			if (!layer.isVisible)
+			{
+				continue;
+			}
+
+			if (layer.mode == BlendMode::None)
+			{
+				result.push_back(layer);
+				break;
+			}
+
+			bool isTransparent = ops.IsZero(layer.alpha);
+
+			if (layer.mode == BlendMode::Over && ops.IsOne(layer.alpha))
+			{
+				// Over with alpha 1 gives the layer color and alpha 1 whatever is below
+				result.push_back({ BlendMode::None, layer.color, layer.alpha, true });
+				break;
+			}
+
+			if (layer.mode == BlendMode::In && isTransparent)
+			{
+				// In with alpha 0 clears color and alpha
+				result.push_back({ BlendMode::None, Value(0.0), Value(0.0), true });
+				break;
+			}
+
+			// Any other blend mode with alpha 0 gives the background
+			if (isTransparent)
+			{
+				continue;
+			}
+
+			result.push_back(layer);
+		}
+
+		return result;
+	}
+
+	/** Blends all layers, runs of constant layers are folded into one scale and offset. The result is not clamped. */
+	template <typename Ops>
+	typename Ops::Value Process(const Ops& ops, const std::vector<Layer<typename Ops::Value>>& layers, bool isColor)
+	{
+		typedef typename Ops::Value Value;
+
+		// First node blend with black color
+		Value result = isColor ? Value(0.0) : Value(1.0);
+
+		// Run of constant layers accumulated as result * scale + offset
+		Value scale = 1.0;
+		Value offset = 0.0;
+
+		// Reverse order because layers calculated right to left
+		for (auto layer = layers.rbegin(); layer != layers.rend(); layer++)
+		{
+			Value layerScale = 0.0;
+			Value layerOffset = 0.0;
+
+			if (GetConstantBlend(ops, *layer, isColor, layerScale, layerOffset))
+			{
+				scale = ops.Mul(scale, layerScale);
+				offset = ops.Add(ops.Mul(offset, layerScale), layerOffset);
+				continue;
+			}
+
+			result = ops.Add(ops.Mul(result, scale), offset);
+			scale = 1.0;
+			offset = 0.0;
+
+			result = isColor ? BlendColor(ops, result, *layer) : BlendAlpha(ops, result, *layer);
+		}
+
+		return ops.Add(ops.Mul(result, scale), offset);
+	}
+}
@@ -0,0 +1,55 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "RampBlendChain.h"
+
+#include <algorithm>
+
+namespace RampBlendChain
+{
+
+void Evaluate(const std::vector<Entry>& entries, size_t count, float weight, float* rgba)
+{
+	weight = std::min(std::max(weight, 0.0f), 1.0f);
+
+	for (int c = 0; c < 3; c++)
+		rgba[c] = entries[0].color[c];
+
+	rgba[3] = 0.0f;
+
+	// same order of operations as the blend nodes: entry * (1 - weight) + chain * weight
+	for (size_t entryIdx = 1; entryIdx < count; ++entryIdx)
+	{
+		for (int c = 0; c < 3; c++)
+			rgba[c] = entries[entryIdx].color[c] * (1.0f - weight) + rgba[c] * weight;
+	}
+}
+
+std::vector<float> Bake(const std::vector<Entry>& entries, size_t count)
+{
+	std::vector<float> values(4 * BufferSize);
+
+	for (unsigned int idx = 0; idx < BufferSize; ++idx)
+	{
+		// same mapping of buffer elements to ramp positions as in RemapRampControlPoints
+		Evaluate(entries, count, (1.0f / (BufferSize - 1)) * idx, &values[4 * idx]);
+	}
+
+	return values;
+}
+
+bool IsConstant(const std::vector<Entry>& entries, size_t count)
+{
+	return std::all_of(entries.begin(), entries.begin() + count, [](const Entry& entry) { return entry.isConstant; });
+}
+
+}
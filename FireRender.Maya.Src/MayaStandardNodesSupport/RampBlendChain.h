@@ -0,0 +1,64 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/** Blend chain of ramp entries with connected nodes.
+	Entry i is blended with the chain of entries 0..i-1, all blends are weighted by the same
+	ramp lookup. Where the inner end of the chain has only constant colours it is evaluated
+	here and sampled from a buffer instead of creating a blend node per entry. */
+namespace RampBlendChain
+{
+	// size of buffers ramps are baked into
+	const unsigned int BufferSize = 256; // same as in Blender
+
+	// blend chains of constant colours shorter than this are cheaper as blend nodes than as a buffer
+	const size_t MinBakedLength = 3;
+
+	struct Entry
+	{
+		// entries connected to a node don't have a constant colour
+		bool isConstant = true;
+		float color[3] = { 0.0f, 0.0f, 0.0f };
+	};
+
+	// Colour of the first count entries for a ramp lookup value, clamped to [0, 1] as blend weights are.
+	// RGBA, alpha is 0 as for the constant values the blend chain is built of.
+	void Evaluate(const std::vector<Entry>& entries, size_t count, float weight, float* rgba);
+
+	// BufferSize RGBA elements, element i is the chain at weight i / (BufferSize - 1)
+	std::vector<float> Bake(const std::vector<Entry>& entries, size_t count);
+
+	bool IsConstant(const std::vector<Entry>& entries, size_t count);
+
+	/** Builds the chain of the first count entries, count > 0. Builder provides:
+		Value Input(size_t entryIndex) - node or constant of an entry;
+		Value Blend(const Value& a, const Value& b) - blend of a and b weighted by the ramp lookup;
+		Value Baked(const std::vector<float>& rgba) - buffer sampled by the ramp lookup clamped to [0, 1]. */
+	template <typename Builder>
+	typename Builder::Value Build(Builder& builder, const std::vector<Entry>& entries, size_t count)
+	{
+		if (count >= MinBakedLength && IsConstant(entries, count))
+			return builder.Baked(Bake(entries, count));
+
+		if (count == 1)
+			return builder.Input(0);
+
+		typename Builder::Value last = builder.Input(count - 1);
+		typename Builder::Value rest = Build(builder, entries, count - 1);
+
+		return builder.Blend(last, rest);
+	}
+}
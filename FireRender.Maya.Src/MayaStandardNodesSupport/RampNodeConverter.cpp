@@ -14,9 +14,12 @@ limitations under the License.
 #include "FireMaya.h"
 #include "FireRenderUtils.h"
 #include "NodeProcessingUtils.h"
+#include "RampBlendChain.h"
 
 #include <maya/MItDependencyGraph.h>
 
+#include <algorithm>
+
 namespace MayaStandardNodeConverters
 { 
 RampNodeConverter::RampNodeConverter(const ConverterParams& params) : BaseConverter(params)
@@ -262,55 +265,84 @@ static const std::map<RampUVType, RampNodeTreeGenerator> m_rampGenerators = {
 
 using ArithmeticNodesBuffer = std::vector<std::tuple<MString, MObject, MColor>>;
 
-frw::Value GetNodeFromABuffer(
-	const FireMaya::Scope& scope, 
-	ArithmeticNodesBuffer& abuffer)
+// Creates the nodes of RampBlendChain::Build, rampLookup is shared by all of them
+class RampBlendBuilder
 {
-	auto el = abuffer.back();
+public:
+	typedef frw::Value Value;
 
-	if (std::get<MObject>(el) != MObject::kNullObj)
+	RampBlendBuilder(const FireMaya::Scope& scope, const ArithmeticNodesBuffer& abuffer, const frw::ArithmeticNode& rampLookup) :
+		m_scope(scope),
+		m_abuffer(abuffer),
+		m_rampLookup(rampLookup)
 	{
-		return scope.GetValue(std::get<MObject>(el), "out");
 	}
-	else
+
+	Value Input(size_t entryIndex) const
 	{
+		const auto& el = m_abuffer[entryIndex];
+
+		if (std::get<MObject>(el) != MObject::kNullObj)
+		{
+			return m_scope.GetValue(std::get<MObject>(el), "out");
+		}
+
 		MColor color = std::get<MColor>(el);
 		return frw::Value(color.r, color.g, color.b);
 	}
-}
 
-frw::Value GetBlendConvertorRecursive(
-	MObject& shaderNodeObject, 
-	const FireMaya::Scope& scope, 
-	RampUVType rampType,
-	ArithmeticNodesBuffer& abuffer)
-{	
-	// first arithm node input
-	frw::Value firstANode = GetNodeFromABuffer(scope, abuffer);
-	abuffer.pop_back();
-
-	// second arithm node input
-	frw::Value secondANode;
-	if (abuffer.size() != 1)
+	Value Blend(const Value& a, const Value& b) const
+	{
+		return m_scope.MaterialSystem().ValueBlend(
+			/*color0*/ a,
+			/*color1*/ b,
+			/*weight*/ m_rampLookup);
+	}
+
+	Value Baked(const std::vector<float>& values) const
 	{
-		assert(abuffer.size() != 0);
-		secondANode = GetBlendConvertorRecursive(shaderNodeObject, scope, rampType, abuffer);
+		rpr_buffer_desc bufferDesc;
+		bufferDesc.nb_element = RampBlendChain::BufferSize;
+		bufferDesc.element_type = RPR_BUFFER_ELEMENT_TYPE_FLOAT32;
+		bufferDesc.element_channel_size = 4;
+
+		frw::DataBuffer dataBuffer(m_scope.Context(), bufferDesc, values.data());
+
+		frw::BufferNode bufferNode(m_scope.MaterialSystem());
+		bufferNode.SetBuffer(dataBuffer);
+
+		// blend weights outside of [0, 1] (corners of circular ramps) are clamped, so is the lookup,
+		// and the last element is the chain at weight 1
+		const float lastElement = float(RampBlendChain::BufferSize - 1);
+		frw::Value clampedLookup = m_scope.MaterialSystem().ValueClamp(m_rampLookup);
+		frw::ArithmeticNode bufferLookupMulNode(m_scope.MaterialSystem(), frw::OperatorMultiply, clampedLookup, frw::Value(lastElement, lastElement, lastElement));
+		bufferNode.SetUV(bufferLookupMulNode);
+
+		return bufferNode;
 	}
-	else
+
+private:
+	const FireMaya::Scope& m_scope;
+	const ArithmeticNodesBuffer& m_abuffer;
+	frw::ArithmeticNode m_rampLookup;
+};
+
+frw::Value GetBlendConvertor(const FireMaya::Scope& scope, const frw::ArithmeticNode& rampLookup, const ArithmeticNodesBuffer& abuffer)
+{
+	std::vector<RampBlendChain::Entry> entries(abuffer.size());
+
+	for (size_t idx = 0; idx < abuffer.size(); ++idx)
 	{
-		secondANode = GetNodeFromABuffer(scope, abuffer);
+		entries[idx].isConstant = std::get<MObject>(abuffer[idx]) == MObject::kNullObj;
+
+		MColor color = std::get<MColor>(abuffer[idx]);
+		entries[idx].color[0] = color.r;
+		entries[idx].color[1] = color.g;
+		entries[idx].color[2] = color.b;
 	}
 
-	const auto& nodeTreeGeneratorImpl = m_rampGenerators.find(rampType);
-	assert(nodeTreeGeneratorImpl != m_rampGenerators.end());
-	frw::ArithmeticNode rampNodeTree = nodeTreeGeneratorImpl->second(scope);
-	
-	// create blend node
-	frw::Value blendNode = scope.MaterialSystem().ValueBlend(
-		/*color0*/ firstANode,
-		/*color1*/ secondANode,
-		/*weight*/ rampNodeTree);
-	return blendNode;
+	RampBlendBuilder builder(scope, abuffer, rampLookup);
+	return RampBlendChain::Build(builder, entries, entries.size());
 }
 
 void ArrangeBufferViaRampCtrlPoints(MObject& shaderNodeObject, const FireMaya::Scope& scope, ArithmeticNodesBuffer& abuffer)
@@ -366,7 +398,7 @@ frw::Value GetBufferSamplerConvertor(
 	// the .colorEntryList property is a compound array attribute; it doesn't get a special function set. 
 	// And, confusingly, .colorEntryList is not an MRampAttribute, it's just a regular indexed compound attribute. 
 
-	const unsigned int bufferSize = 256; // same as in Blender
+	const unsigned int bufferSize = RampBlendChain::BufferSize;
 
 	// extract values from ramp node ramp
 	std::vector<RampCtrlPoint<MColor>> rampCtrlPoints;
@@ -481,8 +513,13 @@ frw::Value RampNodeConverter::Convert() const
 		// sort connections array according to their position on the ramp
 		ArrangeBufferViaRampCtrlPoints(shaderNodeObject, m_params.scope, arithmeticsConnectionBuffer);
 
-		// recursevely create node tree from connections array
-		return GetBlendConvertorRecursive(shaderNodeObject, m_params.scope, rampType, arithmeticsConnectionBuffer);
+		// lookup subtree is created once and shared by all blend nodes
+		const auto& nodeTreeGeneratorImpl = m_rampGenerators.find(rampType);
+		assert(nodeTreeGeneratorImpl != m_rampGenerators.end());
+		frw::ArithmeticNode rampLookup = nodeTreeGeneratorImpl->second(m_params.scope);
+
+		// create node tree from connections array
+		return GetBlendConvertor(m_params.scope, rampLookup, arithmeticsConnectionBuffer);
 	}
 
 	// use RPR Nodes
@@ -81,6 +81,9 @@ void NorthStarRenderingHelper::OnContextRenderUpdateCallback(float progress)
 
 	m_currProgress = progress;
 
+	// Frame buffers got new samples in the middle of the render call
+	m_pContext->GetAOVResolveTracker().AdvanceGeneration();
+
 	std::unique_lock<std::mutex> lck(m_DataReadyMutex);
 	m_DataReady = true;
 	m_DataReadyConditionalVariable.notify_one();
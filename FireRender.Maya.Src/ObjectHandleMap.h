@@ -0,0 +1,76 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/** Map keyed by node identity. MObjectHandle::hashCode is not unique, nodes with the same
+	hash code are told apart by comparing the handles. Handle is MObjectHandle, or any type
+	with hashCode() and operator==. */
+template <typename Handle, typename Value>
+class ObjectHandleMap
+{
+public:
+	// nullptr if the node is not in the map, valid until the next insertion
+	Value* Find(const Handle& handle)
+	{
+		auto bucket = m_buckets.find(handle.hashCode());
+		if (bucket == m_buckets.end())
+			return nullptr;
+
+		for (auto& entry : bucket->second)
+		{
+			if (entry.first == handle)
+				return &entry.second;
+		}
+
+		return nullptr;
+	}
+
+	const Value* Find(const Handle& handle) const
+	{
+		return const_cast<ObjectHandleMap*>(this)->Find(handle);
+	}
+
+	// Keeps the existing value and returns false if the node is already in the map
+	bool Insert(const Handle& handle, const Value& value)
+	{
+		auto& bucket = m_buckets[handle.hashCode()];
+
+		for (const auto& entry : bucket)
+		{
+			if (entry.first == handle)
+				return false;
+		}
+
+		bucket.emplace_back(handle, value);
+		m_size++;
+
+		return true;
+	}
+
+	size_t Size() const { return m_size; }
+
+	void Clear()
+	{
+		m_buckets.clear();
+		m_size = 0;
+	}
+
+private:
+	std::unordered_map<unsigned int, std::vector<std::pair<Handle, Value>>> m_buckets;
+	size_t m_size = 0;
+};
@@ -1,4 +1,7 @@
 #include "RenderViewUpdater.h"
+#include "Context/PixelReadback.h"
+
+#include <cassert>
 
 std::vector<RV_PIXEL> RenderViewUpdater::m_pixelData;
 
@@ -10,45 +13,40 @@ void RenderViewUpdater::EnsureBufferIsAllocated(unsigned int width, unsigned int
 	}
 }
 
-void RenderViewUpdater::FlipAndCopyData(
-	RV_PIXEL* inputPixelData, 
+void RenderViewUpdater::UpdateAndRefreshRegion(
+	RV_PIXEL* pixelData,
 	unsigned int srcWidth,
 	unsigned int srcHeight,
 	const RenderRegion& region)
 {
-	//unsigned int dstOffset = 0;
-	unsigned int srcOffset = 0;
-
-	unsigned int dstWidth = region.getWidth();
-	unsigned int dstHeight = region.getHeight();
-
-	for (unsigned int y = 0; y < dstHeight; ++y)
+	unsigned int width = region.getWidth();
+	unsigned int height = region.getHeight();
+
+	EnsureBufferIsAllocated(width, height);
+
+	// render view rows go bottom up, they are read flipped straight into its buffer
+	PixelReadback::Request request;
+	request.source = reinterpret_cast<const float*>(pixelData);
+	request.sourceWidth = srcWidth;
+	request.sourceHeight = srcHeight;
+	request.width = width;
+	request.height = height;
+	request.flipRows = true;
+	request.destination = m_pixelData.data();
+
+	// pixel data holds either the region only or the whole frame
+	if (srcWidth == width && srcHeight == height)
 	{
-		//dstOffset = y * dstWidth;
-		// Case: region is subarea of bigger buffer
-		if (srcHeight > dstHeight)
-		{
-			srcOffset = (y + srcHeight - region.top - 1) * srcWidth + region.left;
-		}
-		// Case: region is the whole buffer
-		else
-		{
-			srcOffset = y * srcWidth;
-		}
-
-		std::copy(&inputPixelData[srcOffset], &inputPixelData[srcOffset + dstWidth], &m_pixelData[(dstHeight - y - 1) * dstWidth]);
+		request.top = srcHeight - 1;
+	}
+	else
+	{
+		request.left = region.left;
+		request.top = region.top;
 	}
-}
 
-void RenderViewUpdater::UpdateAndRefreshRegion(
-	RV_PIXEL* pixelData,
-	unsigned int srcWidth,
-	unsigned int srcHeight,
-	const RenderRegion& region)
-{
-	// as a first solution - just keep a buffer with necessary size
-	EnsureBufferIsAllocated(srcWidth, srcHeight);
-	FlipAndCopyData(pixelData, srcWidth, srcHeight, region);
+	bool success = PixelReadback::Read(request);
+	assert(success);
 
 	// Update the render view pixels.
 	MRenderView::updatePixels(
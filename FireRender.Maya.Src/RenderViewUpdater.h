@@ -16,11 +16,6 @@ public:
 
 private:
 	static void EnsureBufferIsAllocated(unsigned int width, unsigned int height);
-	static void FlipAndCopyData(
-		RV_PIXEL* inputPixelData,
-		unsigned int srcWidth,
-		unsigned int srcHeight,
-		const RenderRegion& region);
 
 private:
 	static std::vector<RV_PIXEL> m_pixelData;
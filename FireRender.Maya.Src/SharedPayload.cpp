@@ -0,0 +1,369 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "SharedPayload.h"
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+namespace SharedPayload
+{
+
+namespace
+{
+	const char PayloadMagic[8] = { 'R', 'P', 'R', 'P', 'A', 'Y', 'L', '1' };
+	const char ManifestMagic[8] = { 'R', 'P', 'R', 'F', 'R', 'M', 'E', '1' };
+
+	// Chunk sizes: 8 KB on average, so a transform or a small parameter block
+	// changing in a frame only costs one chunk next to it
+	const size_t MinChunkSize = 2 * 1024;
+	const size_t MaxChunkSize = 64 * 1024;
+	const uint64_t BoundaryMask = (1ull << 13) - 1;
+
+	// Random values for the gear rolling hash (FastCDC), generated with splitmix64
+	// so they are the same on every platform
+	const std::array<uint64_t, 256>& GearTable()
+	{
+		static const std::array<uint64_t, 256> table = []()
+		{
+			std::array<uint64_t, 256> values;
+			uint64_t state = 0x5250525041594C31ull;
+
+			for (uint64_t& value : values)
+			{
+				state += 0x9E3779B97F4A7C15ull;
+
+				uint64_t z = state;
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+				value = z ^ (z >> 31);
+			}
+
+			return values;
+		}();
+
+		return table;
+	}
+
+	// Length of the next chunk at the start of data
+	size_t FindBoundary(const char* data, size_t size)
+	{
+		if (size <= MinChunkSize)
+			return size;
+
+		const std::array<uint64_t, 256>& gear = GearTable();
+		size_t end = size < MaxChunkSize ? size : MaxChunkSize;
+		uint64_t hash = 0;
+
+		for (size_t i = MinChunkSize; i < end; i++)
+		{
+			hash = (hash << 1) + gear[(unsigned char) data[i]];
+
+			if ((hash & BoundaryMask) == 0)
+				return i + 1;
+		}
+
+		return end;
+	}
+
+	inline uint64_t Rotl(uint64_t x, int r)
+	{
+		return (x << r) | (x >> (64 - r));
+	}
+
+	inline uint64_t Finalize(uint64_t x)
+	{
+		x ^= x >> 33;
+		x *= 0xFF51AFD7ED558CCDull;
+		x ^= x >> 33;
+		x *= 0xC4CEB9FE1A85EC53ull;
+		x ^= x >> 33;
+		return x;
+	}
+
+	template <typename T>
+	void Put(std::ostream& stream, T value)
+	{
+		stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	bool Get(std::istream& stream, T& value)
+	{
+		return bool(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+	}
+
+	struct PayloadRecord
+	{
+		std::streamoff offset;
+		uint32_t size;
+	};
+
+	bool IndexPayload(std::istream& payload, std::map<ChunkId, PayloadRecord>& index)
+	{
+		char magic[sizeof(PayloadMagic)];
+		payload.seekg(0);
+
+		if (!payload.read(magic, sizeof(magic)) || std::memcmp(magic, PayloadMagic, sizeof(magic)) != 0)
+			return false;
+
+		for (;;)
+		{
+			ChunkId id;
+			uint32_t size = 0;
+
+			if (!Get(payload, id.hash1))
+				break;
+
+			if (!Get(payload, id.hash2) || !Get(payload, size))
+				return false;
+
+			index[id] = { std::streamoff(payload.tellg()), size };
+
+			if (!payload.seekg(size, std::ios::cur))
+				return false;
+		}
+
+		// a truncated record is an error, end of file between records is not
+		payload.clear();
+		return true;
+	}
+}
+
+double Stats::Ratio() const
+{
+	unsigned long long written = payloadBytes + manifestBytes;
+	return written > 0 ? double(frameBytes) / double(written) : 1.0;
+}
+
+ChunkId Hash(const char* data, size_t size)
+{
+	// Two 64 bit lanes over alternating words in the style of MurmurHash3 x64_128,
+	// mixed together at the end
+	const uint64_t c1 = 0x87C37B91114253D5ull;
+	const uint64_t c2 = 0x4CF5AD432745937Full;
+
+	uint64_t h1 = 0x9E3779B97F4A7C15ull ^ size;
+	uint64_t h2 = 0xC2B2AE3D27D4EB4Full + size;
+
+	size_t i = 0;
+	for (; i + 16 <= size; i += 16)
+	{
+		uint64_t k1;
+		uint64_t k2;
+		std::memcpy(&k1, data + i, sizeof(k1));
+		std::memcpy(&k2, data + i + 8, sizeof(k2));
+
+		h1 ^= Rotl(k1 * c1, 31) * c2;
+		h1 = (Rotl(h1, 27) + h2) * 5 + 0x52DCE729;
+
+		h2 ^= Rotl(k2 * c2, 33) * c1;
+		h2 = (Rotl(h2, 31) + h1) * 5 + 0x38495AB5;
+	}
+
+	uint64_t tail[2] = { 0, 0 };
+	std::memcpy(tail, data + i, size - i);
+
+	h1 ^= Rotl(tail[0] * c1, 31) * c2;
+	h2 ^= Rotl(tail[1] * c2, 33) * c1;
+
+	h1 += h2;
+	h2 += h1;
+	h1 = Finalize(h1);
+	h2 = Finalize(h2);
+	h1 += h2;
+	h2 += h1;
+
+	ChunkId id;
+	id.hash1 = h1;
+	id.hash2 = h2;
+
+	return id;
+}
+
+Writer::Writer(std::ostream& payload, const std::string& payloadName) :
+	m_payload(payload),
+	m_payloadName(payloadName)
+{
+}
+
+bool Writer::WriteHeader()
+{
+	if (m_headerWritten)
+		return true;
+
+	m_payload.write(PayloadMagic, sizeof(PayloadMagic));
+	m_stats.payloadBytes += sizeof(PayloadMagic);
+	m_headerWritten = true;
+
+	return bool(m_payload);
+}
+
+bool Writer::StoreChunk(const ChunkId& id, const char* data, uint32_t size)
+{
+	auto it = m_chunks.find(id);
+	if (it != m_chunks.end())
+		return it->second == size;
+
+	Put(m_payload, id.hash1);
+	Put(m_payload, id.hash2);
+	Put(m_payload, size);
+	m_payload.write(data, size);
+
+	m_chunks[id] = size;
+
+	m_stats.payloadBytes += sizeof(id.hash1) + sizeof(id.hash2) + sizeof(size) + size;
+	m_stats.storedChunkCount++;
+
+	return bool(m_payload);
+}
+
+bool Writer::WriteFrame(std::istream& frame, std::ostream& manifest)
+{
+	if (!WriteHeader())
+		return false;
+
+	std::vector<std::pair<ChunkId, uint32_t>> chunks;
+	unsigned long long frameSize = 0;
+
+	// frames can be large, they are read through a window of a few chunks
+	std::vector<char> buffer(4 * MaxChunkSize);
+	size_t available = 0;
+	bool eof = false;
+
+	for (;;)
+	{
+		if (!eof && available < MaxChunkSize)
+		{
+			frame.read(buffer.data() + available, std::streamsize(buffer.size() - available));
+			available += size_t(frame.gcount());
+			eof = frame.eof();
+
+			if (frame.bad())
+				return false;
+		}
+
+		if (available == 0)
+			break;
+
+		size_t start = 0;
+
+		// cut while a full maximum chunk is buffered, so boundaries don't depend on read sizes
+		while (available - start >= MaxChunkSize || (eof && start < available))
+		{
+			size_t length = FindBoundary(buffer.data() + start, available - start);
+
+			ChunkId id = Hash(buffer.data() + start, length);
+			if (!StoreChunk(id, buffer.data() + start, uint32_t(length)))
+				return false;
+
+			chunks.emplace_back(id, uint32_t(length));
+			frameSize += length;
+			start += length;
+		}
+
+		std::memmove(buffer.data(), buffer.data() + start, available - start);
+		available -= start;
+	}
+
+	std::streamoff manifestStart = manifest.tellp();
+
+	manifest.write(ManifestMagic, sizeof(ManifestMagic));
+	Put(manifest, uint32_t(m_payloadName.size()));
+	manifest.write(m_payloadName.data(), m_payloadName.size());
+	Put(manifest, uint64_t(frameSize));
+	Put(manifest, uint64_t(chunks.size()));
+
+	for (const auto& chunk : chunks)
+	{
+		Put(manifest, chunk.first.hash1);
+		Put(manifest, chunk.first.hash2);
+		Put(manifest, chunk.second);
+	}
+
+	if (!manifest)
+		return false;
+
+	m_payload.flush();
+
+	m_stats.frameBytes += frameSize;
+	m_stats.chunkCount += chunks.size();
+	m_stats.manifestBytes += (unsigned long long) (manifest.tellp() - manifestStart);
+
+	return bool(m_payload);
+}
+
+bool ReadPayloadName(std::istream& manifest, std::string& payloadName)
+{
+	char magic[sizeof(ManifestMagic)];
+	if (!manifest.read(magic, sizeof(magic)) || std::memcmp(magic, ManifestMagic, sizeof(magic)) != 0)
+		return false;
+
+	uint32_t nameLength = 0;
+	if (!Get(manifest, nameLength) || nameLength > 4096)
+		return false;
+
+	payloadName.resize(nameLength);
+	return nameLength == 0 || bool(manifest.read(&payloadName[0], nameLength));
+}
+
+bool ReadFrame(std::istream& manifest, std::istream& payload, std::ostream& frame)
+{
+	std::string payloadName;
+	if (!ReadPayloadName(manifest, payloadName))
+		return false;
+
+	uint64_t frameSize = 0;
+	uint64_t chunkCount = 0;
+
+	if (!Get(manifest, frameSize) || !Get(manifest, chunkCount))
+		return false;
+
+	std::map<ChunkId, PayloadRecord> index;
+	if (!IndexPayload(payload, index))
+		return false;
+
+	std::vector<char> data;
+	uint64_t written = 0;
+
+	for (uint64_t i = 0; i < chunkCount; i++)
+	{
+		ChunkId id;
+		uint32_t size = 0;
+
+		if (!Get(manifest, id.hash1) || !Get(manifest, id.hash2) || !Get(manifest, size))
+			return false;
+
+		auto it = index.find(id);
+		if (it == index.end() || it->second.size != size)
+			return false;
+
+		data.resize(size);
+		payload.seekg(it->second.offset);
+
+		if (!payload.read(data.data(), size))
+			return false;
+
+		// the payload could have been modified since the export
+		ChunkId stored = Hash(data.data(), size);
+		if (stored.hash1 != id.hash1 || stored.hash2 != id.hash2)
+			return false;
+
+		frame.write(data.data(), size);
+		written += size;
+	}
+
+	return written == frameSize && bool(frame);
+}
+
+}
@@ -0,0 +1,90 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+
+/** Deduplicated storage of exported scene sequences.
+
+	A sequence export writes the whole scene for every frame, although most of it (static meshes,
+	images, materials) is byte for byte the same in each frame. Frame files are cut into chunks at
+	content defined boundaries, so data which doesn't change between frames gives the same chunks
+	even if something before it changed size. Each distinct chunk is stored once in a shared payload
+	file, a frame is kept as a small manifest listing its chunks by content hash.
+	Reading a manifest back gives the original frame file, bit exact.
+*/
+namespace SharedPayload
+{
+	struct ChunkId
+	{
+		uint64_t hash1 = 0;
+		uint64_t hash2 = 0;
+
+		bool operator<(const ChunkId& other) const
+		{
+			return hash1 != other.hash1 ? hash1 < other.hash1 : hash2 < other.hash2;
+		}
+	};
+
+	struct Stats
+	{
+		unsigned long long frameBytes = 0;		// sum of exported frame sizes
+		unsigned long long payloadBytes = 0;	// written into the shared payload
+		unsigned long long manifestBytes = 0;
+		unsigned long long chunkCount = 0;
+		unsigned long long storedChunkCount = 0;
+
+		// how many times less data is written compared to full frames
+		double Ratio() const;
+	};
+
+	class Writer
+	{
+	public:
+		// payloadName is stored in manifests, it is resolved relative to the manifest when reading
+		Writer(std::ostream& payload, const std::string& payloadName);
+
+		bool WriteFrame(std::istream& frame, std::ostream& manifest);
+
+		const Stats& GetStats() const { return m_stats; }
+
+	private:
+		bool WriteHeader();
+		bool StoreChunk(const ChunkId& id, const char* data, uint32_t size);
+
+		std::ostream& m_payload;
+		std::string m_payloadName;
+		bool m_headerWritten = false;
+
+		// stored chunks and their sizes
+		std::map<ChunkId, uint32_t> m_chunks;
+
+		Stats m_stats;
+	};
+
+	// Reads the payload file name from the manifest, the stream is left at the start of the chunk list
+	bool ReadPayloadName(std::istream& manifest, std::string& payloadName);
+
+	// Writes the original frame file; payload has to be seekable
+	bool ReadFrame(std::istream& manifest, std::istream& payload, std::ostream& frame);
+
+	ChunkId Hash(const char* data, size_t size);
+
+	const char* const PayloadExtension = "rprpayload";
+	const char* const ManifestExtension = "rprframe";
+}
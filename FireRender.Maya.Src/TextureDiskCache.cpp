@@ -0,0 +1,451 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "TextureDiskCache.h"
+#include "Fnv1a.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	const char Magic[8] = { 'R', 'P', 'R', 'T', 'E', 'X', '\0', '\0' };
+	const uint32_t Version = 1;
+	const uint64_t PixelsAlignment = 16;
+
+	// temporary files of crashed sessions are removed after a day
+	const std::chrono::hours StaleTemporaryAge(24);
+
+	struct FileHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t width;
+		uint32_t height;
+		uint32_t channels;
+		uint32_t componentType;
+		uint32_t rowPitch;
+		uint32_t keySize;
+		uint32_t reserved;
+		uint64_t pixelsOffset;
+		uint64_t pixelsSize;
+	};
+
+	fs::path ToPath(const std::string& utf8)
+	{
+		return fs::u8path(utf8);
+	}
+
+	void* MapFile(const fs::path& path, size_t& size)
+	{
+		size = 0;
+
+#ifdef _WIN32
+		HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+			nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+			return nullptr;
+
+		LARGE_INTEGER fileSize = {};
+		void* view = nullptr;
+
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+		{
+			if (HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr))
+			{
+				view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				CloseHandle(mapping);
+			}
+		}
+
+		CloseHandle(file);
+
+		if (view)
+			size = size_t(fileSize.QuadPart);
+
+		return view;
+#else
+		int file = open(path.c_str(), O_RDONLY);
+		if (file < 0)
+			return nullptr;
+
+		struct stat info = {};
+		void* view = nullptr;
+
+		if (fstat(file, &info) == 0 && info.st_size > 0)
+		{
+			view = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+			if (view == MAP_FAILED)
+				view = nullptr;
+		}
+
+		close(file);
+
+		if (view)
+			size = size_t(info.st_size);
+
+		return view;
+#endif
+	}
+
+	void UnmapFile(void* view, size_t size)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(view);
+#else
+		munmap(view, size);
+#endif
+	}
+
+	std::string UniqueSuffix()
+	{
+		static std::atomic<unsigned int> counter(0);
+		static const unsigned int seed = std::random_device()();
+
+		std::ostringstream suffix;
+		suffix << std::hex << seed << "-" << std::hash<std::thread::id>()(std::this_thread::get_id()) << "-" << counter++;
+
+		return suffix.str();
+	}
+}
+
+TextureDiskCache::Entry::~Entry()
+{
+	Release();
+}
+
+void TextureDiskCache::Entry::Release()
+{
+	if (m_mapping)
+		UnmapFile(m_mapping, m_mappingSize);
+
+	m_mapping = nullptr;
+	m_mappingSize = 0;
+	m_desc = ImageDesc();
+	m_pixels = nullptr;
+	m_pixelsSize = 0;
+}
+
+std::string TextureDiskCache::Key::ToString() const
+{
+	std::ostringstream text;
+	text << path << "|" << modificationTime << "|" << fileSize << "|" << colorSpace << "|" << format;
+
+	return text.str();
+}
+
+TextureDiskCache& TextureDiskCache::Instance()
+{
+	static TextureDiskCache instance;
+	return instance;
+}
+
+void TextureDiskCache::Configure(const std::string& directory, unsigned long long maxBytes)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_directory = maxBytes > 0 ? directory : std::string();
+	m_maxBytes = maxBytes;
+	m_sizeKnown = false;
+	m_totalBytes = 0;
+
+	if (!m_directory.empty())
+	{
+		std::error_code error;
+		fs::create_directories(ToPath(m_directory), error);
+	}
+}
+
+bool TextureDiskCache::IsEnabled() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return !m_directory.empty();
+}
+
+bool TextureDiskCache::MakeKey(const std::string& path, const std::string& colorSpace, const std::string& format, Key& key)
+{
+	std::error_code error;
+	fs::path sourcePath = ToPath(path);
+
+	auto fileSize = fs::file_size(sourcePath, error);
+	if (error)
+		return false;
+
+	auto modificationTime = fs::last_write_time(sourcePath, error);
+	if (error)
+		return false;
+
+	key.path = fs::absolute(sourcePath, error).u8string();
+	if (error)
+		key.path = path;
+
+	key.modificationTime = (long long) modificationTime.time_since_epoch().count();
+	key.fileSize = fileSize;
+	key.colorSpace = colorSpace;
+	key.format = format;
+
+	return true;
+}
+
+std::string TextureDiskCache::EntryPath(const Key& key) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_directory.empty())
+		return std::string();
+
+	char name[32] = {};
+	snprintf(name, sizeof(name), "%016llx", (unsigned long long) Fnv1a::Hash(key.ToString()));
+
+	return (ToPath(m_directory) / (std::string(name) + Extension())).u8string();
+}
+
+bool TextureDiskCache::Load(const Key& key, Entry& entry)
+{
+	entry.Release();
+
+	std::string path = EntryPath(key);
+	if (path.empty())
+		return false;
+
+	fs::path entryPath = ToPath(path);
+
+	size_t size = 0;
+	void* mapping = MapFile(entryPath, size);
+	if (!mapping)
+		return false;
+
+	entry.m_mapping = mapping;
+	entry.m_mappingSize = size;
+
+	FileHeader header;
+	if (size < sizeof(header))
+	{
+		entry.Release();
+		return false;
+	}
+
+	std::memcpy(&header, mapping, sizeof(header));
+
+	const char* bytes = static_cast<const char*>(mapping);
+	std::string keyText = key.ToString();
+
+	// hash collisions and entries of other versions are misses
+	bool valid = std::memcmp(header.magic, Magic, sizeof(Magic)) == 0 &&
+		header.version == Version &&
+		header.keySize == keyText.size() &&
+		sizeof(header) + uint64_t(header.keySize) <= header.pixelsOffset &&
+		header.pixelsOffset + header.pixelsSize <= size &&
+		uint64_t(header.rowPitch) * header.height <= header.pixelsSize &&
+		std::memcmp(bytes + sizeof(header), keyText.data(), keyText.size()) == 0;
+
+	if (!valid)
+	{
+		entry.Release();
+		return false;
+	}
+
+	entry.m_desc.width = header.width;
+	entry.m_desc.height = header.height;
+	entry.m_desc.channels = header.channels;
+	entry.m_desc.componentType = header.componentType;
+	entry.m_desc.rowPitch = header.rowPitch;
+	entry.m_pixels = bytes + header.pixelsOffset;
+	entry.m_pixelsSize = size_t(header.pixelsSize);
+
+	// recently used entries are kept by Trim
+	std::error_code error;
+	fs::last_write_time(entryPath, fs::file_time_type::clock::now(), error);
+
+	return true;
+}
+
+bool TextureDiskCache::Store(const Key& key, const ImageDesc& desc, const void* pixels)
+{
+	std::string path = EntryPath(key);
+	if (path.empty() || !pixels)
+		return false;
+
+	std::string keyText = key.ToString();
+
+	FileHeader header = {};
+	std::memcpy(header.magic, Magic, sizeof(Magic));
+	header.version = Version;
+	header.width = desc.width;
+	header.height = desc.height;
+	header.channels = desc.channels;
+	header.componentType = desc.componentType;
+	header.rowPitch = desc.rowPitch;
+	header.keySize = uint32_t(keyText.size());
+	header.pixelsOffset = (sizeof(header) + keyText.size() + PixelsAlignment - 1) / PixelsAlignment * PixelsAlignment;
+	header.pixelsSize = uint64_t(desc.rowPitch) * desc.height;
+
+	fs::path entryPath = ToPath(path);
+	fs::path temporaryPath = entryPath;
+	temporaryPath += "." + UniqueSuffix() + ".tmp";
+
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (!file)
+			return false;
+
+		std::vector<char> padding(size_t(header.pixelsOffset - sizeof(header) - keyText.size()), 0);
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(keyText.data(), keyText.size());
+		file.write(padding.data(), padding.size());
+		file.write(static_cast<const char*>(pixels), std::streamsize(header.pixelsSize));
+
+		if (!file)
+		{
+			file.close();
+
+			std::error_code error;
+			fs::remove(temporaryPath, error);
+			return false;
+		}
+	}
+
+	// an entry of another session may be replaced
+	std::error_code error;
+	unsigned long long replacedSize = fs::file_size(entryPath, error);
+	if (error)
+		replacedSize = 0;
+
+	// readers see either the previous entry or the complete new one
+	fs::rename(temporaryPath, entryPath, error);
+
+	if (error)
+	{
+		fs::remove(temporaryPath, error);
+		return false;
+	}
+
+	// the directory is only scanned once and when it may have grown past its size
+	bool needsTrim = false;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		unsigned long long grownSize = m_totalBytes + header.pixelsOffset + header.pixelsSize;
+		m_totalBytes = grownSize > replacedSize ? grownSize - replacedSize : 0;
+
+		needsTrim = !m_sizeKnown || m_totalBytes > m_maxBytes;
+	}
+
+	if (needsTrim)
+		Trim();
+
+	return true;
+}
+
+void TextureDiskCache::Trim()
+{
+	std::string directory;
+	unsigned long long maxBytes = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		directory = m_directory;
+		maxBytes = m_maxBytes;
+	}
+
+	if (directory.empty())
+		return;
+
+	struct CachedFile
+	{
+		fs::path path;
+		fs::file_time_type lastUse;
+		unsigned long long size;
+	};
+
+	std::vector<CachedFile> files;
+	unsigned long long totalSize = 0;
+
+	std::error_code error;
+	auto now = fs::file_time_type::clock::now();
+
+	for (fs::directory_iterator it(ToPath(directory), error), end; !error && it != end; it.increment(error))
+	{
+		const fs::path& path = it->path();
+		std::error_code fileError;
+
+		auto lastUse = fs::last_write_time(path, fileError);
+		if (fileError)
+			continue;
+
+		if (path.extension() == ".tmp" && path.filename().string().find(std::string(Extension()) + ".") != std::string::npos)
+		{
+			// a rename in progress never takes that long
+			if (now - lastUse > StaleTemporaryAge)
+				fs::remove(path, fileError);
+
+			continue;
+		}
+
+		if (path.extension() != Extension())
+			continue;
+
+		auto size = fs::file_size(path, fileError);
+		if (fileError)
+			continue;
+
+		files.push_back({ path, lastUse, size });
+		totalSize += size;
+	}
+
+	if (totalSize > maxBytes)
+	{
+		std::sort(files.begin(), files.end(), [](const CachedFile& a, const CachedFile& b) { return a.lastUse < b.lastUse; });
+
+		for (const CachedFile& file : files)
+		{
+			if (totalSize <= maxBytes)
+				break;
+
+			// entries mapped by another session may fail to be removed on Windows, they are retried next time
+			std::error_code fileError;
+			if (fs::remove(file.path, fileError))
+				totalSize -= file.size;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// the cache may have been configured again meanwhile
+	if (directory == m_directory)
+	{
+		m_totalBytes = totalSize;
+		m_sizeKnown = true;
+	}
+}
@@ -0,0 +1,111 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+/** Local disk cache of texture pixels ready for upload.
+	Decoding, converting and colour space conversion of a texture is done once; later sessions map
+	the stored payload and create the image from it. Entries are addressed by a hash of the source
+	file path, its modification time and size, the colour space and the target format, so an edited
+	texture gets a new entry and the old one ages out. Entries are written to a temporary file and
+	renamed, and the least recently used ones are removed when the cache exceeds its size, which
+	makes it safe for several Maya sessions sharing the folder. */
+class TextureDiskCache
+{
+public:
+	struct Key
+	{
+		std::string path;
+		long long modificationTime = 0;
+		unsigned long long fileSize = 0;
+		std::string colorSpace;
+
+		// payload variant, e.g. full resolution or a size limit
+		std::string format;
+
+		std::string ToString() const;
+	};
+
+	struct ImageDesc
+	{
+		unsigned int width = 0;
+		unsigned int height = 0;
+		unsigned int channels = 0;
+
+		// RPR component type, stored as is
+		unsigned int componentType = 0;
+
+		unsigned int rowPitch = 0;
+	};
+
+	// Memory mapped entry, pixels are valid while it exists
+	class Entry
+	{
+	public:
+		Entry() = default;
+		~Entry();
+
+		Entry(const Entry&) = delete;
+		Entry& operator=(const Entry&) = delete;
+
+		const ImageDesc& Desc() const { return m_desc; }
+		const void* Pixels() const { return m_pixels; }
+		size_t PixelsSize() const { return m_pixelsSize; }
+
+	private:
+		friend class TextureDiskCache;
+
+		void Release();
+
+		void* m_mapping = nullptr;
+		size_t m_mappingSize = 0;
+
+		ImageDesc m_desc;
+		const void* m_pixels = nullptr;
+		size_t m_pixelsSize = 0;
+	};
+
+public:
+	static TextureDiskCache& Instance();
+
+	// Empty directory or zero size disables the cache
+	void Configure(const std::string& directory, unsigned long long maxBytes);
+	bool IsEnabled() const;
+
+	// Returns false if the source file can't be found
+	static bool MakeKey(const std::string& path, const std::string& colorSpace, const std::string& format, Key& key);
+
+	bool Load(const Key& key, Entry& entry);
+	bool Store(const Key& key, const ImageDesc& desc, const void* pixels);
+
+	// Removes least recently used entries until the cache fits into its size.
+	// Store calls it once per configuration and then only when the entries it added exceed the size.
+	void Trim();
+
+	std::string EntryPath(const Key& key) const;
+
+	static const char* Extension() { return ".rprtex"; }
+
+private:
+	mutable std::mutex m_mutex;
+	std::string m_directory;
+	unsigned long long m_maxBytes = 0;
+
+	// size of the cache directory as of the last Trim plus the entries stored since
+	bool m_sizeKnown = false;
+	unsigned long long m_totalBytes = 0;
+};
@@ -0,0 +1,300 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "TextureResolution.h"
+
+#include "HalfFloat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace TextureResolution
+{
+
+namespace
+{
+	// smaller textures are not worth a separate level
+	const unsigned int MinLimit = 256;
+
+	// horizontal field of view of a 35 mm lens on a 36 mm film back (Maya default camera)
+	const double ReferenceFieldOfView = 2.0 * std::atan(18.0 / 35.0);
+
+	unsigned int NextPowerOf2(unsigned int value)
+	{
+		unsigned int result = 1;
+		while (result < value && result < (1u << 31))
+			result <<= 1;
+
+		return result;
+	}
+
+	size_t ComponentSize(ComponentType type)
+	{
+		switch (type)
+		{
+		case ComponentType::Half: return sizeof(uint16_t);
+		case ComponentType::Float: return sizeof(float);
+		default: return sizeof(uint8_t);
+		}
+	}
+
+	void LoadRow(const void* row, size_t count, ComponentType type, float* values)
+	{
+		switch (type)
+		{
+		case ComponentType::Half:
+			for (size_t i = 0; i < count; i++)
+				values[i] = HalfFloat::ToFloat(static_cast<const uint16_t*>(row)[i]);
+			break;
+
+		case ComponentType::Float:
+			std::copy(static_cast<const float*>(row), static_cast<const float*>(row) + count, values);
+			break;
+
+		default:
+			for (size_t i = 0; i < count; i++)
+				values[i] = static_cast<const uint8_t*>(row)[i];
+			break;
+		}
+	}
+
+	void StoreComponent(void* row, size_t index, ComponentType type, float value)
+	{
+		switch (type)
+		{
+		case ComponentType::Half:
+			static_cast<uint16_t*>(row)[index] = HalfFloat::FromFloat(value);
+			break;
+
+		case ComponentType::Float:
+			static_cast<float*>(row)[index] = value;
+			break;
+
+		default:
+			static_cast<uint8_t*>(row)[index] = uint8_t(std::min(255.0f, std::max(0.0f, value + 0.5f)));
+			break;
+		}
+	}
+
+	// Footprint of each destination pixel along one axis
+	std::vector<Footprint> MakeFootprints(unsigned int sourceSize, unsigned int size)
+	{
+		std::vector<Footprint> footprints(size);
+		double scale = double(sourceSize) / size;
+
+		for (unsigned int i = 0; i < size; i++)
+		{
+			double start = i * scale;
+			double end = std::min(double(sourceSize), (i + 1) * scale);
+
+			Footprint& footprint = footprints[i];
+			footprint.first = unsigned(start);
+
+			for (unsigned int s = footprint.first; s < sourceSize && s < end; s++)
+			{
+				double covered = std::min(end, s + 1.0) - std::max(start, double(s));
+				footprint.weights.push_back(float(covered / scale));
+			}
+		}
+
+		return footprints;
+	}
+}
+
+unsigned int SelectLimit(const Policy& policy)
+{
+	if (!policy.interactive || policy.maxSize == 0)
+		return 0;
+
+	if (policy.screenCoverage == 0)
+		return policy.maxSize;
+
+	// zoomed in past the point where the capped texture would be visibly blurry
+	if (policy.screenCoverage > policy.maxSize * policy.upgradeFactor)
+		return 0;
+
+	return std::min(policy.maxSize, std::max(MinLimit, NextPowerOf2(policy.screenCoverage)));
+}
+
+unsigned int SelectLevel(unsigned int width, unsigned int height, unsigned int maxWidth, unsigned int maxHeight)
+{
+	if (maxWidth == 0 || maxHeight == 0)
+		return 0;
+
+	unsigned int level = 0;
+	unsigned int levelWidth = width;
+	unsigned int levelHeight = height;
+
+	while ((levelWidth > maxWidth || levelHeight > maxHeight) && (levelWidth > 1 || levelHeight > 1))
+	{
+		level++;
+		LevelSize(width, height, level, levelWidth, levelHeight);
+	}
+
+	return level;
+}
+
+void LevelSize(unsigned int width, unsigned int height, unsigned int level, unsigned int& levelWidth, unsigned int& levelHeight)
+{
+	level = std::min(level, 31u);
+
+	levelWidth = std::max(1u, width >> level);
+	levelHeight = std::max(1u, height >> level);
+}
+
+double Magnification(double horizontalFieldOfView)
+{
+	if (horizontalFieldOfView <= 0.0)
+		return 1.0;
+
+	return std::tan(ReferenceFieldOfView / 2.0) / std::tan(std::min(horizontalFieldOfView, 3.0) / 2.0);
+}
+
+double Magnification(double horizontalFieldOfView, double boundsRadius, double distance)
+{
+	if (boundsRadius <= 0.0)
+		return Magnification(horizontalFieldOfView);
+
+	double fieldOfView = horizontalFieldOfView > 0.0 ? std::min(horizontalFieldOfView, 3.0) : ReferenceFieldOfView;
+
+	return boundsRadius / (std::max(distance, boundsRadius) * std::tan(fieldOfView / 2.0));
+}
+
+bool Downsample(const ImageData& source, unsigned int width, unsigned int height, void* destination)
+{
+	if (!source.data || !destination || source.channels == 0 || width == 0 || height == 0 ||
+		width > source.width || height > source.height)
+	{
+		return false;
+	}
+
+	const unsigned int channels = source.channels;
+	const size_t componentSize = ComponentSize(source.type);
+	const size_t sourcePitch = source.rowPitch ? source.rowPitch : size_t(source.width) * channels * componentSize;
+	const size_t destinationPitch = size_t(width) * channels * componentSize;
+
+	const std::vector<Footprint> columns = MakeFootprints(source.width, width);
+	const std::vector<Footprint> rows = MakeFootprints(source.height, height);
+
+	const int rowCount = int(height);
+
+#pragma omp parallel for schedule(dynamic, 4)
+	for (int y = 0; y < rowCount; y++)
+	{
+		std::vector<float> accumulated(size_t(width) * channels, 0.0f);
+		std::vector<float> sourceRow(size_t(source.width) * channels);
+		const Footprint& row = rows[y];
+
+		for (size_t r = 0; r < row.weights.size(); r++)
+		{
+			LoadRow(static_cast<const uint8_t*>(source.data) + (row.first + r) * sourcePitch, sourceRow.size(), source.type, sourceRow.data());
+			float rowWeight = row.weights[r];
+
+			for (unsigned int x = 0; x < width; x++)
+			{
+				const Footprint& column = columns[x];
+				float* pixel = &accumulated[size_t(x) * channels];
+
+				for (size_t c = 0; c < column.weights.size(); c++)
+				{
+					float weight = rowWeight * column.weights[c];
+					size_t offset = size_t(column.first + c) * channels;
+
+					for (unsigned int channel = 0; channel < channels; channel++)
+						pixel[channel] += weight * sourceRow[offset + channel];
+				}
+			}
+		}
+
+		void* destinationRow = static_cast<uint8_t*>(destination) + y * destinationPitch;
+
+		for (size_t i = 0; i < accumulated.size(); i++)
+			StoreComponent(destinationRow, i, source.type, accumulated[i]);
+	}
+
+	return true;
+}
+
+RowDownsampler::RowDownsampler(unsigned int sourceWidth, unsigned int sourceHeight, unsigned int channels, ComponentType type,
+	unsigned int width, unsigned int height, void* destination) :
+	m_valid(destination && channels > 0 && width > 0 && height > 0 && width <= sourceWidth && height <= sourceHeight),
+	m_channels(channels),
+	m_type(type),
+	m_sourceRow(0),
+	m_nextRow(0),
+	m_destinationPitch(size_t(width) * channels * ComponentSize(type)),
+	m_destination(destination)
+{
+	if (!m_valid)
+		return;
+
+	m_columns = MakeFootprints(sourceWidth, width);
+	m_rows = MakeFootprints(sourceHeight, height);
+
+	for (std::vector<float>& accumulated : m_accumulated)
+		accumulated.assign(size_t(width) * channels, 0.0f);
+
+	m_sourceRowValues.resize(size_t(sourceWidth) * channels);
+}
+
+void RowDownsampler::AddRow(const void* row)
+{
+	if (!m_valid || m_nextRow == m_rows.size())
+		return;
+
+	LoadRow(row, m_sourceRowValues.size(), m_type, m_sourceRowValues.data());
+
+	// destination rows from the first incomplete one whose footprint contains this source row
+	for (size_t y = m_nextRow; y < m_rows.size() && m_rows[y].first <= m_sourceRow; y++)
+	{
+		const Footprint& footprint = m_rows[y];
+		size_t r = m_sourceRow - footprint.first;
+
+		if (r >= footprint.weights.size())
+			continue;
+
+		std::vector<float>& accumulated = m_accumulated[y % 2];
+		float rowWeight = footprint.weights[r];
+
+		for (size_t x = 0; x < m_columns.size(); x++)
+		{
+			const Footprint& column = m_columns[x];
+			float* pixel = &accumulated[x * m_channels];
+
+			for (size_t c = 0; c < column.weights.size(); c++)
+			{
+				float weight = rowWeight * column.weights[c];
+				size_t offset = size_t(column.first + c) * m_channels;
+
+				for (unsigned int channel = 0; channel < m_channels; channel++)
+					pixel[channel] += weight * m_sourceRowValues[offset + channel];
+			}
+		}
+
+		if (r + 1 == footprint.weights.size())
+		{
+			void* destinationRow = static_cast<uint8_t*>(m_destination) + y * m_destinationPitch;
+
+			for (size_t i = 0; i < accumulated.size(); i++)
+				StoreComponent(destinationRow, i, m_type, accumulated[i]);
+
+			std::fill(accumulated.begin(), accumulated.end(), 0.0f);
+			m_nextRow = y + 1;
+		}
+	}
+
+	m_sourceRow++;
+}
+
+}
@@ -0,0 +1,120 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/** Reduced resolution of textures for interactive rendering.
+	Viewport and IPR rarely show a texture at more than the view resolution, so images are
+	loaded at the smallest mip level covering the screen, capped by a global setting. Full
+	resolution is used by final renders and once the camera zooms in far enough to need it. */
+namespace TextureResolution
+{
+	struct Policy
+	{
+		// final renders always use full resolution
+		bool interactive = false;
+
+		// longest side of interactive textures, 0 for full resolution
+		unsigned int maxSize = 2048;
+
+		// pixels the longest side of a texture may span on screen: view size times camera magnification
+		unsigned int screenCoverage = 0;
+
+		// full resolution is used once the coverage exceeds maxSize by this factor
+		float upgradeFactor = 2.0f;
+	};
+
+	// Limit of the longest texture side, 0 for full resolution
+	unsigned int SelectLimit(const Policy& policy);
+
+	// Mip level at which the texture fits into maxWidth x maxHeight, 0 is full resolution
+	unsigned int SelectLevel(unsigned int width, unsigned int height, unsigned int maxWidth, unsigned int maxHeight);
+
+	// Each level halves the size, rounding down, but never below one pixel
+	void LevelSize(unsigned int width, unsigned int height, unsigned int level, unsigned int& levelWidth, unsigned int& levelHeight);
+
+	// Magnification of a perspective camera against a 35 mm lens on a 36 mm film back
+	double Magnification(double horizontalFieldOfView);
+
+	// Magnification of geometry with the bounding sphere radius at distance from the camera center:
+	// 1 where the sphere fills the view horizontally, growing as the camera dollies in. Inside the
+	// sphere the geometry is taken as seen from its surface.
+	double Magnification(double horizontalFieldOfView, double boundsRadius, double distance);
+
+	enum class ComponentType
+	{
+		UInt8,
+		Half,
+		Float
+	};
+
+	struct ImageData
+	{
+		const void* data = nullptr;
+		unsigned int width = 0;
+		unsigned int height = 0;
+		unsigned int channels = 0;
+		ComponentType type = ComponentType::UInt8;
+
+		// bytes between rows, 0 for packed rows
+		size_t rowPitch = 0;
+	};
+
+	// Area filter: every destination pixel is the mean of the source area it covers.
+	// destination receives packed width x height pixels of the source layout; returns false on invalid input.
+	bool Downsample(const ImageData& source, unsigned int width, unsigned int height, void* destination);
+
+	// Source pixels covered by a destination pixel along one axis with their share of its area
+	struct Footprint
+	{
+		unsigned int first;
+		std::vector<float> weights;
+	};
+
+	/** Area filter fed with source rows from top to bottom, e.g. scanlines as they are decoded,
+		so the full resolution image is never kept in memory. Result is the same as of Downsample. */
+	class RowDownsampler
+	{
+	public:
+		// destination receives packed width x height pixels of the source layout
+		RowDownsampler(unsigned int sourceWidth, unsigned int sourceHeight, unsigned int channels, ComponentType type,
+			unsigned int width, unsigned int height, void* destination);
+
+		// false if the sizes are invalid, rows are ignored then
+		bool IsValid() const { return m_valid; }
+
+		// Next packed source row
+		void AddRow(const void* row);
+
+		// All source rows were added and the destination is written
+		bool IsComplete() const { return m_valid && m_nextRow == m_rows.size(); }
+
+	private:
+		bool m_valid;
+		unsigned int m_channels;
+		ComponentType m_type;
+		unsigned int m_sourceRow;
+		size_t m_nextRow;
+		size_t m_destinationPitch;
+		void* m_destination;
+
+		std::vector<Footprint> m_columns;
+		std::vector<Footprint> m_rows;
+
+		// a source row covers at most two destination rows, accumulated in turns
+		std::vector<float> m_accumulated[2];
+		std::vector<float> m_sourceRowValues;
+	};
+}
@@ -0,0 +1,156 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "DeformationMotionCache.h"
+
+std::vector<double> DeformationMotionCache::ShutterSampleTimes(double startTime, unsigned int sampleCount)
+{
+	std::vector<double> times;
+
+	if (sampleCount < 2)
+		return times;
+
+	times.resize(sampleCount);
+
+	for (unsigned int sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex)
+	{
+		times[sampleIndex] = startTime + (double) sampleIndex / (sampleCount - 1);
+	}
+
+	return times;
+}
+
+void DeformationMotionCache::SetSampleTimes(const std::vector<double>& times)
+{
+	if (times != m_sampleTimes)
+	{
+		Clear();
+		m_sampleTimes = times;
+	}
+}
+
+void DeformationMotionCache::Request(const std::string& meshPath)
+{
+	Entry& entry = m_entries[meshPath];
+
+	if (entry.state == MeshState::Unknown)
+	{
+		entry.state = MeshState::Pending;
+		m_pending.push_back(meshPath);
+	}
+}
+
+void DeformationMotionCache::MarkStatic(const std::string& meshPath)
+{
+	Entry& entry = m_entries[meshPath];
+
+	if (entry.state == MeshState::Unknown)
+	{
+		entry.state = MeshState::Static;
+	}
+}
+
+size_t DeformationMotionCache::Evaluate(Evaluator& evaluator)
+{
+	if (m_pending.empty())
+		return 0;
+
+	std::vector<Entry*> batch;
+	batch.reserve(m_pending.size());
+
+	for (const std::string& meshPath : m_pending)
+	{
+		batch.push_back(&m_entries[meshPath]);
+	}
+
+	size_t timeChanges = 0;
+
+	for (size_t sampleIndex = 0; sampleIndex < m_sampleTimes.size(); sampleIndex++)
+	{
+		evaluator.SetTime(m_sampleTimes[sampleIndex]);
+		timeChanges++;
+
+		for (size_t i = 0; i < batch.size(); i++)
+		{
+			Entry& entry = *batch[i];
+
+			if (entry.state == MeshState::Failed)
+				continue;
+
+			MeshSamples& samples = entry.samples;
+
+			size_t pointsBefore = samples.points.size();
+			size_t normalsBefore = samples.normals.size();
+
+			if (!evaluator.ReadMesh(m_pending[i], samples.points, samples.normals))
+			{
+				entry.state = MeshState::Failed;
+				continue;
+			}
+
+			size_t pointCount = (samples.points.size() - pointsBefore) / 3;
+			size_t normalCount = (samples.normals.size() - normalsBefore) / 3;
+
+			if (sampleIndex == 0)
+			{
+				samples.pointCount = pointCount;
+				samples.normalCount = normalCount;
+			}
+			else if (pointCount != samples.pointCount || normalCount != samples.normalCount)
+			{
+				// topology changes over the shutter interval can't be blurred
+				entry.state = MeshState::Failed;
+			}
+		}
+	}
+
+	for (Entry* entry : batch)
+	{
+		if (entry->state == MeshState::Failed || m_sampleTimes.empty())
+		{
+			entry->state = MeshState::Failed;
+			entry->samples = MeshSamples();
+		}
+		else
+		{
+			entry->state = MeshState::Sampled;
+		}
+	}
+
+	m_pending.clear();
+
+	return timeChanges;
+}
+
+DeformationMotionCache::MeshState DeformationMotionCache::GetState(const std::string& meshPath) const
+{
+	auto it = m_entries.find(meshPath);
+
+	return it != m_entries.end() ? it->second.state : MeshState::Unknown;
+}
+
+const DeformationMotionCache::MeshSamples* DeformationMotionCache::Find(const std::string& meshPath) const
+{
+	auto it = m_entries.find(meshPath);
+
+	if (it == m_entries.end() || it->second.state != MeshState::Sampled)
+		return nullptr;
+
+	return &it->second.samples;
+}
+
+void DeformationMotionCache::Clear()
+{
+	m_sampleTimes.clear();
+	m_entries.clear();
+	m_pending.clear();
+}
@@ -0,0 +1,88 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/** Point and normal samples of deforming meshes for deformation motion blur.
+	Meshes are requested first and evaluated together: the evaluator is moved to each
+	motion sample time once and reads every pending mesh there, so the cost of
+	evaluating the scene at a time is paid per sample, not per mesh and sample. */
+class DeformationMotionCache
+{
+public:
+	class Evaluator
+	{
+	public:
+		virtual ~Evaluator() {}
+
+		// Called once per sample time before meshes are read
+		virtual void SetTime(double time) = 0;
+
+		// Appends mesh points and normals (3 floats each) at the current time
+		virtual bool ReadMesh(const std::string& meshPath, std::vector<float>& points, std::vector<float>& normals) = 0;
+	};
+
+	struct MeshSamples
+	{
+		// samples are stored one after another, the layout used by the mesh translator
+		std::vector<float> points;
+		std::vector<float> normals;
+
+		size_t pointCount = 0;
+		size_t normalCount = 0;
+	};
+
+	enum class MeshState
+	{
+		Unknown,	// not requested
+		Pending,	// requested, waiting for Evaluate
+		Static,		// not deforming, no samples needed
+		Sampled,
+		Failed		// could not be read or changed topology between samples
+	};
+
+	// sampleCount times spread over one frame from startTime, the shutter interval of transform motion blur;
+	// empty for less than 2 samples, when there is no deformation blur
+	static std::vector<double> ShutterSampleTimes(double startTime, unsigned int sampleCount);
+
+	// Sample times in evaluator units; changing them drops all samples
+	void SetSampleTimes(const std::vector<double>& times);
+	const std::vector<double>& SampleTimes() const { return m_sampleTimes; }
+
+	void Request(const std::string& meshPath);
+	void MarkStatic(const std::string& meshPath);
+
+	// Samples all pending meshes. Returns number of SetTime calls made
+	size_t Evaluate(Evaluator& evaluator);
+
+	MeshState GetState(const std::string& meshPath) const;
+
+	// Null if mesh was not sampled
+	const MeshSamples* Find(const std::string& meshPath) const;
+
+	void Clear();
+
+private:
+	struct Entry
+	{
+		MeshState state = MeshState::Unknown;
+		MeshSamples samples;
+	};
+
+	std::vector<double> m_sampleTimes;
+	std::unordered_map<std::string, Entry> m_entries;
+	std::vector<std::string> m_pending;
+};
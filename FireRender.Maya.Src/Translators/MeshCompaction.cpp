@@ -0,0 +1,517 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "MeshCompaction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	const int NoVertex = -1;
+
+	// -0 and 0 weld together
+	uint32_t FloatBits(float value)
+	{
+		value += 0.0f;
+
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		return bits;
+	}
+
+	uint64_t HashWords(const uint32_t* words, size_t count)
+	{
+		uint64_t hash = 0x9E3779B97F4A7C15ull;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			hash ^= words[i];
+			hash *= 0xFF51AFD7ED558CCDull;
+			hash ^= hash >> 32;
+		}
+
+		return hash;
+	}
+
+	float SignNotZero(float value)
+	{
+		return value < 0.0f ? -1.0f : 1.0f;
+	}
+
+	uint32_t ToSnorm16(float value)
+	{
+		value = std::min(1.0f, std::max(-1.0f, value));
+
+		return uint32_t(uint16_t(int16_t(std::lround(value * 32767.0f))));
+	}
+
+	float FromSnorm16(uint32_t value)
+	{
+		return std::max(-1.0f, float(int16_t(uint16_t(value))) / 32767.0f);
+	}
+
+	/** Face order for a FIFO vertex cache, after Sander et al., "Fast Triangle Reordering for
+		Vertex Locality and Reduced Overdraw" (2007). Faces around the current vertex are emitted,
+		then the next vertex is one still in cache with the most faces left, polygons of any size. */
+	std::vector<int> ReorderFaces(const std::vector<int>& vertices, const std::vector<size_t>& faceStarts, size_t vertexCount, unsigned int cacheSize)
+	{
+		const size_t faceCount = faceStarts.size() - 1;
+
+		std::vector<int> live(vertexCount, 0);
+		for (int vertex : vertices)
+			live[vertex]++;
+
+		std::vector<size_t> adjacencyStarts(vertexCount + 1, 0);
+		for (size_t vertex = 0; vertex < vertexCount; vertex++)
+			adjacencyStarts[vertex + 1] = adjacencyStarts[vertex] + live[vertex];
+
+		std::vector<int> adjacency(vertices.size());
+		{
+			std::vector<size_t> fill(adjacencyStarts.begin(), adjacencyStarts.end() - 1);
+
+			for (size_t face = 0; face < faceCount; face++)
+			{
+				for (size_t i = faceStarts[face]; i < faceStarts[face + 1]; i++)
+					adjacency[fill[vertices[i]]++] = int(face);
+			}
+		}
+
+		std::vector<int> cacheTimes(vertexCount, 0);
+		std::vector<char> emitted(faceCount, 0);
+		std::vector<int> deadEnds;
+		std::vector<int> candidates;
+
+		std::vector<int> order;
+		order.reserve(faceCount);
+
+		int timestamp = int(cacheSize) + 1;
+		size_t cursor = 1;
+		int vertex = 0;
+
+		while (vertex != NoVertex)
+		{
+			candidates.clear();
+
+			for (size_t i = adjacencyStarts[vertex]; i < adjacencyStarts[vertex + 1]; i++)
+			{
+				int face = adjacency[i];
+				if (emitted[face])
+					continue;
+
+				emitted[face] = 1;
+				order.push_back(face);
+
+				for (size_t j = faceStarts[face]; j < faceStarts[face + 1]; j++)
+				{
+					int faceVertex = vertices[j];
+
+					deadEnds.push_back(faceVertex);
+					candidates.push_back(faceVertex);
+					live[faceVertex]--;
+
+					if (timestamp - cacheTimes[faceVertex] > int(cacheSize))
+						cacheTimes[faceVertex] = timestamp++;
+				}
+			}
+
+			// a vertex still in cache after its remaining faces are emitted, the oldest first
+			int next = NoVertex;
+			int bestPriority = -1;
+
+			for (int candidate : candidates)
+			{
+				if (live[candidate] <= 0)
+					continue;
+
+				int priority = 0;
+				if (timestamp - cacheTimes[candidate] + 2 * live[candidate] <= int(cacheSize))
+					priority = timestamp - cacheTimes[candidate];
+
+				if (priority > bestPriority)
+				{
+					bestPriority = priority;
+					next = candidate;
+				}
+			}
+
+			// otherwise a recently used vertex, or the next one in input order
+			while (next == NoVertex && !deadEnds.empty())
+			{
+				int candidate = deadEnds.back();
+				deadEnds.pop_back();
+
+				if (live[candidate] > 0)
+					next = candidate;
+			}
+
+			while (next == NoVertex && cursor < vertexCount)
+			{
+				if (live[cursor] > 0)
+					next = int(cursor);
+
+				cursor++;
+			}
+
+			vertex = next;
+		}
+
+		return order;
+	}
+}
+
+uint32_t MeshCompaction::PackNormal(const float* normal)
+{
+	float length = std::fabs(normal[0]) + std::fabs(normal[1]) + std::fabs(normal[2]);
+	if (length <= 0.0f)
+		return ToSnorm16(0.0f) | (ToSnorm16(0.0f) << 16);
+
+	float x = normal[0] / length;
+	float y = normal[1] / length;
+
+	// lower hemisphere is folded over the diagonals
+	if (normal[2] < 0.0f)
+	{
+		float foldedX = (1.0f - std::fabs(y)) * SignNotZero(x);
+		float foldedY = (1.0f - std::fabs(x)) * SignNotZero(y);
+
+		x = foldedX;
+		y = foldedY;
+	}
+
+	return ToSnorm16(x) | (ToSnorm16(y) << 16);
+}
+
+void MeshCompaction::UnpackNormal(uint32_t packed, float* normal)
+{
+	float x = FromSnorm16(packed & 0xFFFF);
+	float y = FromSnorm16(packed >> 16);
+	float z = 1.0f - std::fabs(x) - std::fabs(y);
+
+	if (z < 0.0f)
+	{
+		float unfoldedX = (1.0f - std::fabs(y)) * SignNotZero(x);
+		float unfoldedY = (1.0f - std::fabs(x)) * SignNotZero(y);
+
+		x = unfoldedX;
+		y = unfoldedY;
+	}
+
+	float length = std::sqrt(x * x + y * y + z * z);
+
+	normal[0] = x / length;
+	normal[1] = y / length;
+	normal[2] = z / length;
+}
+
+bool MeshCompaction::Compact(const Input& input, const Options& options, Mesh& mesh)
+{
+	mesh = Mesh();
+
+	if (!input.positions || !input.positionIndices || !input.faceVertexCounts || input.faceCount == 0 ||
+		input.positionSamples == 0 || input.normalSamples == 0)
+	{
+		return false;
+	}
+
+	std::vector<size_t> faceStarts(input.faceCount + 1, 0);
+	for (size_t face = 0; face < input.faceCount; face++)
+	{
+		if (input.faceVertexCounts[face] < 1)
+			return false;
+
+		faceStarts[face + 1] = faceStarts[face] + size_t(input.faceVertexCounts[face]);
+	}
+
+	const size_t faceVertexCount = faceStarts.back();
+
+	const bool hasNormals = input.normals && input.normalIndices && input.normalCount > 0;
+	const bool quantize = hasNormals && options.quantizeNormals && input.normalSamples == 1;
+	const size_t layerCount = std::min(input.uvs.size(), std::min(input.uvCounts.size(), input.uvIndices.size()));
+
+	auto inRange = [faceVertexCount](const int* indices, size_t count)
+	{
+		for (size_t i = 0; i < faceVertexCount; i++)
+		{
+			if (indices[i] < 0 || size_t(indices[i]) >= count)
+				return false;
+		}
+
+		return true;
+	};
+
+	if (!inRange(input.positionIndices, input.positionCount) || (hasNormals && !inRange(input.normalIndices, input.normalCount)))
+		return false;
+
+	for (size_t layer = 0; layer < layerCount; layer++)
+	{
+		if (!input.uvs[layer] || !input.uvIndices[layer] || !inRange(input.uvIndices[layer], input.uvCounts[layer]))
+			return false;
+	}
+
+	// Welding key of a face-vertex. Animated streams are compared by index, the values of other samples may differ.
+	const size_t positionWords = options.keepPositions ? 0 : (input.positionSamples == 1 ? 3 : 1);
+	const size_t normalWords = !hasNormals ? 0 : (quantize ? 1 : (input.normalSamples == 1 ? 3 : 1));
+	const size_t keySize = positionWords + normalWords + 2 * layerCount;
+
+	auto makeKey = [&](size_t faceVertex, uint32_t* key)
+	{
+		int position = input.positionIndices[faceVertex];
+
+		if (positionWords == 3)
+		{
+			for (int i = 0; i < 3; i++)
+				*key++ = FloatBits(input.positions[3 * size_t(position) + i]);
+		}
+		else if (positionWords == 1)
+		{
+			*key++ = uint32_t(position);
+		}
+
+		if (hasNormals)
+		{
+			int normal = input.normalIndices[faceVertex];
+
+			if (quantize)
+			{
+				*key++ = PackNormal(input.normals + 3 * size_t(normal));
+			}
+			else if (normalWords == 3)
+			{
+				for (int i = 0; i < 3; i++)
+					*key++ = FloatBits(input.normals[3 * size_t(normal) + i]);
+			}
+			else
+			{
+				*key++ = uint32_t(normal);
+			}
+		}
+
+		for (size_t layer = 0; layer < layerCount; layer++)
+		{
+			int uv = input.uvIndices[layer][faceVertex];
+
+			*key++ = FloatBits(input.uvs[layer][2 * size_t(uv)]);
+			*key++ = FloatBits(input.uvs[layer][2 * size_t(uv) + 1]);
+		}
+	};
+
+	// open addressing table of unique vertices
+	size_t tableSize = 16;
+	while (tableSize < 2 * faceVertexCount)
+		tableSize <<= 1;
+
+	std::vector<int> table(tableSize, NoVertex);
+	std::vector<uint32_t> keys;
+	std::vector<size_t> representatives;
+	std::vector<int> vertices(faceVertexCount);
+
+	// most meshes weld to about as many vertices as they have points
+	size_t expectedVertices = std::min(faceVertexCount, 2 * input.positionCount);
+	keys.reserve(expectedVertices * keySize);
+	representatives.reserve(expectedVertices);
+
+	std::vector<uint32_t> key(keySize);
+
+	for (size_t faceVertex = 0; faceVertex < faceVertexCount; faceVertex++)
+	{
+		makeKey(faceVertex, key.data());
+
+		size_t slot = size_t(HashWords(key.data(), keySize)) & (tableSize - 1);
+
+		while (table[slot] != NoVertex &&
+			std::memcmp(keys.data() + size_t(table[slot]) * keySize, key.data(), keySize * sizeof(uint32_t)) != 0)
+		{
+			slot = (slot + 1) & (tableSize - 1);
+		}
+
+		if (table[slot] == NoVertex)
+		{
+			table[slot] = int(representatives.size());
+			keys.insert(keys.end(), key.begin(), key.end());
+			representatives.push_back(faceVertex);
+		}
+
+		vertices[faceVertex] = table[slot];
+	}
+
+	const size_t vertexCount = representatives.size();
+
+	if (options.reorderFaces && options.keepPositions)
+	{
+		// points are what the cache sees when positions are indexed on their own
+		std::vector<int> points(input.positionIndices, input.positionIndices + faceVertexCount);
+		mesh.faceOrder = ReorderFaces(points, faceStarts, input.positionCount, std::max(options.cacheSize, 3u));
+	}
+	else if (options.reorderFaces)
+	{
+		mesh.faceOrder = ReorderFaces(vertices, faceStarts, vertexCount, std::max(options.cacheSize, 3u));
+	}
+	else
+	{
+		mesh.faceOrder.resize(input.faceCount);
+		for (size_t face = 0; face < input.faceCount; face++)
+			mesh.faceOrder[face] = int(face);
+	}
+
+	// vertices and kept points are numbered in order of first use
+	std::vector<int> renumbered(vertexCount, NoVertex);
+	std::vector<size_t> sources;
+	sources.reserve(vertexCount);
+
+	std::vector<int> renumberedPositions(options.keepPositions ? input.positionCount : 0, NoVertex);
+	std::vector<int> positionSources;
+
+	mesh.indices.reserve(faceVertexCount);
+	mesh.faceVertexCounts.reserve(input.faceCount);
+
+	if (options.keepPositions)
+		mesh.positionIndices.reserve(faceVertexCount);
+
+	for (int face : mesh.faceOrder)
+	{
+		for (size_t i = faceStarts[face]; i < faceStarts[face + 1]; i++)
+		{
+			int vertex = vertices[i];
+
+			if (renumbered[vertex] == NoVertex)
+			{
+				renumbered[vertex] = int(sources.size());
+				sources.push_back(representatives[vertex]);
+			}
+
+			mesh.indices.push_back(renumbered[vertex]);
+
+			if (options.keepPositions)
+			{
+				int position = input.positionIndices[i];
+
+				if (renumberedPositions[position] == NoVertex)
+				{
+					renumberedPositions[position] = int(positionSources.size());
+					positionSources.push_back(position);
+				}
+
+				mesh.positionIndices.push_back(renumberedPositions[position]);
+			}
+		}
+
+		mesh.faceVertexCounts.push_back(input.faceVertexCounts[face]);
+	}
+
+	if (!options.keepPositions)
+	{
+		positionSources.resize(vertexCount);
+		for (size_t vertex = 0; vertex < vertexCount; vertex++)
+			positionSources[vertex] = input.positionIndices[sources[vertex]];
+	}
+
+	mesh.vertexCount = vertexCount;
+	mesh.positionCount = positionSources.size();
+
+	mesh.positions.resize(3 * mesh.positionCount * input.positionSamples);
+	for (unsigned int sample = 0; sample < input.positionSamples; sample++)
+	{
+		const float* samplePositions = input.positions + 3 * input.positionCount * sample;
+		float* output = &mesh.positions[3 * mesh.positionCount * sample];
+
+		for (size_t position = 0; position < mesh.positionCount; position++)
+			std::memcpy(output + 3 * position, samplePositions + 3 * size_t(positionSources[position]), 3 * sizeof(float));
+	}
+
+	if (hasNormals)
+	{
+		mesh.normals.resize(3 * vertexCount * input.normalSamples);
+
+		if (quantize)
+			mesh.packedNormals.resize(vertexCount);
+
+		for (unsigned int sample = 0; sample < input.normalSamples; sample++)
+		{
+			const float* sampleNormals = input.normals + 3 * input.normalCount * sample;
+			float* output = &mesh.normals[3 * vertexCount * sample];
+
+			for (size_t vertex = 0; vertex < vertexCount; vertex++)
+			{
+				const float* normal = sampleNormals + 3 * size_t(input.normalIndices[sources[vertex]]);
+
+				if (quantize)
+				{
+					mesh.packedNormals[vertex] = PackNormal(normal);
+					UnpackNormal(mesh.packedNormals[vertex], output + 3 * vertex);
+				}
+				else
+				{
+					std::memcpy(output + 3 * vertex, normal, 3 * sizeof(float));
+				}
+			}
+		}
+	}
+
+	mesh.uvs.resize(layerCount);
+	for (size_t layer = 0; layer < layerCount; layer++)
+	{
+		std::vector<float>& output = mesh.uvs[layer];
+		output.resize(2 * vertexCount);
+
+		for (size_t vertex = 0; vertex < vertexCount; vertex++)
+		{
+			int uv = input.uvIndices[layer][sources[vertex]];
+
+			output[2 * vertex] = input.uvs[layer][2 * size_t(uv)];
+			output[2 * vertex + 1] = input.uvs[layer][2 * size_t(uv) + 1];
+		}
+	}
+
+	return true;
+}
+
+void MeshCompaction::RemapFaceData(const Mesh& mesh, std::vector<int>& faceData)
+{
+	std::vector<int> remapped(mesh.faceOrder.size());
+
+	for (size_t face = 0; face < mesh.faceOrder.size(); face++)
+		remapped[face] = faceData[mesh.faceOrder[face]];
+
+	faceData.swap(remapped);
+}
+
+size_t MeshCompaction::InputBytes(const Input& input)
+{
+	size_t faceVertexCount = 0;
+	for (size_t face = 0; face < input.faceCount; face++)
+		faceVertexCount += size_t(std::max(input.faceVertexCounts[face], 0));
+
+	size_t bytes = 3 * sizeof(float) * (input.positionCount * input.positionSamples + input.normalCount * input.normalSamples);
+	size_t indexArrays = 1 + (input.normalIndices ? 1 : 0);
+
+	for (size_t layer = 0; layer < input.uvCounts.size(); layer++)
+	{
+		bytes += 2 * sizeof(float) * input.uvCounts[layer];
+		indexArrays++;
+	}
+
+	return bytes + indexArrays * faceVertexCount * sizeof(int) + input.faceCount * sizeof(int);
+}
+
+size_t MeshCompaction::MeshBytes(const Mesh& mesh)
+{
+	size_t bytes = sizeof(float) * (mesh.positions.size() + mesh.normals.size());
+
+	for (const std::vector<float>& uvs : mesh.uvs)
+		bytes += sizeof(float) * uvs.size();
+
+	// one index array is passed for all streams, or one more for kept positions
+	return bytes + sizeof(int) * (mesh.indices.size() + mesh.positionIndices.size() + mesh.faceVertexCounts.size());
+}
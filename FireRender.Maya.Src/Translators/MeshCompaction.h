@@ -0,0 +1,107 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** Compacts translated meshes before they are uploaded.
+	Translators emit separate position, normal and uv streams, each with its own index per
+	face-vertex, and normals mostly duplicated per face-vertex. Identical (position, normal, uv)
+	tuples are welded into one vertex, so a single index per face-vertex addresses all streams,
+	faces are reordered for vertex cache locality and vertices renumbered in order of first use.
+	With keepPositions points are not split at uv seams and hard edges, they keep their own index
+	array, so subdivision and displacement still see a connected surface.
+	Works on plain arrays, face data (materials) is remapped through faceOrder. */
+class MeshCompaction
+{
+public:
+	struct Options
+	{
+		// Normals are snapped to 16 bit octahedral precision before welding, which merges normals
+		// differing only by float noise, and are also returned packed for backends taking them
+		bool quantizeNormals = false;
+
+		bool reorderFaces = true;
+
+		// Welds only normals and uvs and returns positionIndices, points are never duplicated
+		bool keepPositions = false;
+
+		// FIFO cache size the face order is optimized for
+		unsigned int cacheSize = 16;
+	};
+
+	struct Input
+	{
+		// samples of deformation motion blur are stored one after another
+		const float* positions = nullptr;
+		size_t positionCount = 0;
+		unsigned int positionSamples = 1;
+
+		const float* normals = nullptr;
+		size_t normalCount = 0;
+		unsigned int normalSamples = 1;
+
+		// 2 floats per uv, one array and index array per layer
+		std::vector<const float*> uvs;
+		std::vector<size_t> uvCounts;
+		std::vector<const int*> uvIndices;
+
+		// one per face-vertex; normal indices may be null if there are no normals
+		const int* positionIndices = nullptr;
+		const int* normalIndices = nullptr;
+
+		const int* faceVertexCounts = nullptr;
+		size_t faceCount = 0;
+	};
+
+	struct Mesh
+	{
+		// per vertex, samples one after another as in the input
+		std::vector<float> positions;
+		std::vector<float> normals;
+		std::vector<std::vector<float>> uvs;
+
+		// first sample, only with quantizeNormals
+		std::vector<uint32_t> packedNormals;
+
+		size_t vertexCount = 0;
+		size_t positionCount = 0;
+
+		// one per face-vertex, addresses every stream, or only normals and uvs with keepPositions
+		std::vector<int> indices;
+
+		// one per face-vertex with keepPositions, addresses positions
+		std::vector<int> positionIndices;
+
+		std::vector<int> faceVertexCounts;
+
+		// input face of each output face
+		std::vector<int> faceOrder;
+	};
+
+	// Returns false if the input indices are out of range, the mesh is left empty then
+	static bool Compact(const Input& input, const Options& options, Mesh& mesh);
+
+	// Moves per face values (e.g. material indices) to the output face order
+	static void RemapFaceData(const Mesh& mesh, std::vector<int>& faceData);
+
+	// Unit vector to two 16 bit snorm octahedral coordinates, x in the low half
+	static uint32_t PackNormal(const float* normal);
+	static void UnpackNormal(uint32_t packed, float* normal);
+
+	// Bytes passed to mesh creation, streams and index arrays
+	static size_t InputBytes(const Input& input);
+	static size_t MeshBytes(const Mesh& mesh);
+};
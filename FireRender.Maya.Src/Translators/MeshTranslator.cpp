@@ -19,6 +19,10 @@ limitations under the License.
 
 #include <maya/MFnMesh.h>
 #include <maya/MFnSubd.h>
+#include <maya/MFnMeshData.h>
+#include <maya/MColorArray.h>
+#include <maya/MDoubleArray.h>
+#include <maya/MUintArray.h>
 #include <maya/MFloatPointArray.h>
 #include <maya/MFloatVectorArray.h>
 #include <maya/MFloatArray.h>
@@ -26,8 +30,12 @@ limitations under the License.
 #include <maya/MItMeshPolygon.h>
 #include <maya/MSelectionList.h>
 #include <maya/MAnimControl.h>
+#include <maya/MDGContext.h>
 
+#include <algorithm>
+#include <atomic>
 #include <unordered_map>
+#include <memory>
 
 #include "SingleShaderMeshTranslator.h"
 #include "MultipleShaderMeshTranslator.h"
@@ -46,88 +54,341 @@ FireMaya::MeshTranslator::MeshPolygonData::MeshPolygonData()
 {
 }
 
-void ChangeCurrentTimeAndUpdateMesh(MFnMesh& fnMesh, const MTime& time, MString fullDagPath)
+namespace
 {
-	MGlobal::viewFrame(time);
+	// Reads output geometry of mesh shapes at a given time without changing the current time
+	class MayaDeformationEvaluator : public DeformationMotionCache::Evaluator
+	{
+	public:
+		virtual void SetTime(double time) override
+		{
+			// one context per sample time is shared by all meshes of the batch
+			m_dgContext.reset(new MDGContext(MTime(time, MTime::uiUnit())));
+		}
+
+		virtual bool ReadMesh(const std::string& meshPath, std::vector<float>& points, std::vector<float>& normals) override
+		{
+			MSelectionList sl;
+			MDagPath dagPath;
+
+			if (sl.add(meshPath.c_str()) != MStatus::kSuccess || sl.getDagPath(0, dagPath) != MStatus::kSuccess)
+			{
+				return false;
+			}
+
+			MStatus status;
+			MPlug outMeshPlug = MFnDependencyNode(dagPath.node()).findPlug("outMesh", false, &status);
+			if (status != MStatus::kSuccess || outMeshPlug.isNull())
+			{
+				return false;
+			}
+
+			MObject meshData;
+			if (outMeshPlug.getValue(meshData, *m_dgContext) != MStatus::kSuccess)
+			{
+				return false;
+			}
+
+			MFnMesh fnMesh(meshData, &status);
+			if (status != MStatus::kSuccess)
+			{
+				return false;
+			}
+
+			const float* pPoints = fnMesh.getRawPoints(&status);
+			size_t floatsPoints = 3 * (size_t) fnMesh.numVertices();
+			if (pPoints == nullptr || status != MStatus::kSuccess)
+			{
+				return false;
+			}
+
+			const float* pNormals = fnMesh.getRawNormals(&status);
+			size_t floatsNormals = 3 * (size_t) fnMesh.numNormals();
+			if (pNormals == nullptr || status != MStatus::kSuccess)
+			{
+				return false;
+			}
 
-	// We need to update fnMesh function set in order to apply time change
+			points.insert(points.end(), pPoints, pPoints + floatsPoints);
+			normals.insert(normals.end(), pNormals, pNormals + floatsNormals);
 
-	MDagPath dagPath;
+			return true;
+		}
+
+	private:
+		std::unique_ptr<MDGContext> m_dgContext;
+	};
 
-	MSelectionList sl;
-	sl.add(fullDagPath);
-	if (!sl.isEmpty())
+	// Tessellated or smoothed mesh without a DAG node, translated again when only shading or transform changes
+	class TessellatedMesh : public TessellationCache::Payload
 	{
-		sl.getDagPath(0, dagPath);
-		fnMesh.setObject(dagPath);
+	public:
+		MObject meshData;
+		MIntArray faceMaterialIndices;
+		int materialCount = 1;
+
+		virtual size_t Size() const override { return m_size; }
+
+		static std::shared_ptr<TessellatedMesh> Create(MFnMesh& fnMesh, const MIntArray& faceMaterialIndices, int materialCount)
+		{
+			MStatus status;
+			MFnMeshData fnData;
+			MObject meshData = fnData.create(&status);
+			if (status != MStatus::kSuccess)
+			{
+				return nullptr;
+			}
+
+			fnMesh.copy(fnMesh.object(), meshData, &status);
+			if (status != MStatus::kSuccess)
+			{
+				return nullptr;
+			}
+
+			auto result = std::make_shared<TessellatedMesh>();
+			result->meshData = meshData;
+			result->faceMaterialIndices = faceMaterialIndices;
+			result->materialCount = materialCount;
+
+			// points and normals, face-vertex indices of points, normals and uvs, uvs of each set
+			result->m_size = 12 * size_t(fnMesh.numVertices() + fnMesh.numNormals()) +
+				12 * size_t(fnMesh.numFaceVertices()) +
+				8 * size_t(fnMesh.numUVs()) * std::max(1, fnMesh.numUVSets()) +
+				4 * size_t(faceMaterialIndices.length());
+
+			return result;
+		}
+
+	private:
+		size_t m_size = 0;
+	};
+
+	void AddToKey(TessellationCache::KeyBuilder& builder, const MIntArray& values)
+	{
+		std::vector<int> buffer(values.length());
+		if (!buffer.empty())
+		{
+			values.get(buffer.data());
+		}
+
+		builder.AddValue(buffer.size());
+		builder.Add(buffer.data(), buffer.size() * sizeof(int));
 	}
-	else
+
+	void AddToKey(TessellationCache::KeyBuilder& builder, const MFloatArray& values)
+	{
+		std::vector<float> buffer(values.length());
+		if (!buffer.empty())
+		{
+			values.get(buffer.data());
+		}
+
+		builder.AddValue(buffer.size());
+		builder.Add(buffer.data(), buffer.size() * sizeof(float));
+	}
+
+	void AddToKey(TessellationCache::KeyBuilder& builder, const MDoubleArray& values)
 	{
-		assert(false);
+		std::vector<double> buffer(values.length());
+		if (!buffer.empty())
+		{
+			values.get(buffer.data());
+		}
+
+		builder.AddValue(buffer.size());
+		builder.Add(buffer.data(), buffer.size() * sizeof(double));
 	}
-}
 
-bool FireMaya::MeshTranslator::MeshPolygonData::ProcessDeformationFrameCount(MFnMesh& fnMesh, MString fullDagPath)
-{
-	if (motionSamplesCount < 2 || fullDagPath.length() == 0)
+	void AddToKey(TessellationCache::KeyBuilder& builder, const MString& value)
 	{
-		return false;
+		builder.Add(std::string(value.asChar()));
+	}
+
+	// Points, normals, topology, creases, uvs and colors of a mesh
+	bool GetMeshGeometryKey(MFnMesh& fnMesh, TessellationCache::Key& key)
+	{
+		MStatus status;
+
+		const float* points = fnMesh.getRawPoints(&status);
+		const float* normals = fnMesh.getRawNormals(&status);
+		if (points == nullptr || normals == nullptr)
+		{
+			return false;
+		}
+
+		TessellationCache::KeyBuilder builder;
+
+		builder.AddValue(fnMesh.numVertices());
+		builder.Add(points, 3 * sizeof(float) * fnMesh.numVertices());
+
+		// normals carry hard and soft edges
+		builder.AddValue(fnMesh.numNormals());
+		builder.Add(normals, 3 * sizeof(float) * fnMesh.numNormals());
+
+		MIntArray counts;
+		MIntArray indices;
+		fnMesh.getVertices(counts, indices);
+		AddToKey(builder, counts);
+		AddToKey(builder, indices);
+
+		fnMesh.getNormalIds(counts, indices);
+		AddToKey(builder, indices);
+
+		MUintArray creaseEdges;
+		MDoubleArray creaseData;
+		fnMesh.getCreaseEdges(creaseEdges, creaseData);
+		builder.AddValue(creaseEdges.length());
+		for (unsigned int i = 0; i < creaseEdges.length(); ++i)
+		{
+			builder.AddValue(creaseEdges[i]);
+		}
+		AddToKey(builder, creaseData);
+
+		MUintArray creaseVertices;
+		fnMesh.getCreaseVertices(creaseVertices, creaseData);
+		builder.AddValue(creaseVertices.length());
+		for (unsigned int i = 0; i < creaseVertices.length(); ++i)
+		{
+			builder.AddValue(creaseVertices[i]);
+		}
+		AddToKey(builder, creaseData);
+
+		MStringArray uvSetNames;
+		fnMesh.getUVSetNames(uvSetNames);
+		for (unsigned int i = 0; i < uvSetNames.length(); ++i)
+		{
+			MFloatArray uArray;
+			MFloatArray vArray;
+			fnMesh.getUVs(uArray, vArray, &uvSetNames[i]);
+			fnMesh.getAssignedUVs(counts, indices, &uvSetNames[i]);
+
+			AddToKey(builder, uvSetNames[i]);
+			AddToKey(builder, uArray);
+			AddToKey(builder, vArray);
+			AddToKey(builder, counts);
+			AddToKey(builder, indices);
+		}
+
+		MStringArray colorSetNames;
+		fnMesh.getColorSetNames(colorSetNames);
+		for (unsigned int i = 0; i < colorSetNames.length(); ++i)
+		{
+			MColorArray colors;
+			fnMesh.getFaceVertexColors(colors, &colorSetNames[i]);
+
+			AddToKey(builder, colorSetNames[i]);
+			builder.AddValue(colors.length());
+			for (unsigned int j = 0; j < colors.length(); ++j)
+			{
+				float color[4];
+				colors[j].get(color);
+				builder.Add(color, sizeof(color));
+			}
+		}
+
+		key = builder.Get();
+		return true;
 	}
 
 	// Check if mesh has deformers or rigs inside construction history
+	bool HasDeformerOrRig(const MString& fullDagPath)
+	{
+		MString command;
+		command.format("source common.mel; hasGivenMeshDeformerOrRigAttached(\"^1s\");", fullDagPath);
 
-	MString name = fullDagPath;
-	MString command;
-	command.format("source common.mel; hasGivenMeshDeformerOrRigAttached(\"^1s\");", name);
-	
-	MStatus status;
-	MString result = MGlobal::executeCommandStringResult(command, false, false, &status);
+		MStatus status;
+		MString result = MGlobal::executeCommandStringResult(command, false, false, &status);
 
-	if (result.asInt() == 0)
+		return result.asInt() != 0;
+	}
+
+	// set from render globals when a scene is built, meshes may be translated on the render thread
+	std::atomic<bool> compactionEnabled(false);
+}
+
+void FireMaya::MeshTranslator::SetCompactionEnabled(bool enabled)
+{
+	compactionEnabled = enabled;
+}
+
+bool FireMaya::MeshTranslator::IsCompactionEnabled()
+{
+	return compactionEnabled;
+}
+
+void FireMaya::MeshTranslator::SampleDeformations(const std::vector<MString>& meshPaths, unsigned int motionSamplesCount, DeformationMotionCache& cache)
+{
+	MAIN_THREAD_ONLY;
+
+	if (motionSamplesCount < 2)
 	{
-		return false;
+		return;
 	}
 
 	MTime initialTime = MAnimControl::currentTime();
-	MTime currentTime = initialTime;
 
 	if (initialTime == MAnimControl::maxTime())
 	{
-		return false;
+		return;
 	}
 
-	size_t floatsVertexOneFrame = 3 * countVertices;
-	size_t floatsNormalOneFrame = 3 * countNormals;
+	cache.SetSampleTimes(DeformationMotionCache::ShutterSampleTimes(initialTime.as(MTime::uiUnit()), motionSamplesCount));
 
-	arrVertices.resize(floatsVertexOneFrame * motionSamplesCount);
-	arrNormals.resize(floatsNormalOneFrame * motionSamplesCount);
+	for (const MString& meshPath : meshPaths)
+	{
+		std::string key = meshPath.asChar();
 
-	unsigned int currentTimeIndex = 0;
+		if (cache.GetState(key) != DeformationMotionCache::MeshState::Unknown)
+		{
+			continue;
+		}
 
-	MDagPath dagPath;
+		if (HasDeformerOrRig(meshPath))
+		{
+			cache.Request(key);
+		}
+		else
+		{
+			cache.MarkStatic(key);
+		}
+	}
+
+	MayaDeformationEvaluator evaluator;
+	cache.Evaluate(evaluator);
+}
 
-	for (unsigned int currentTimeIndex = 0; currentTimeIndex < motionSamplesCount; ++currentTimeIndex)
+bool FireMaya::MeshTranslator::MeshPolygonData::ProcessDeformationFrameCount(MString fullDagPath, DeformationMotionCache* deformationCache)
+{
+	if (motionSamplesCount < 2 || fullDagPath.length() == 0)
 	{
-		// positioning on next point of time (starting from currentTime)
-		currentTime += (float)currentTimeIndex / (motionSamplesCount - 1);
+		return false;
+	}
 
-		ChangeCurrentTimeAndUpdateMesh(fnMesh, currentTime, fullDagPath);
+	// mesh wasn't sampled with the rest of the scene, sample it alone without keeping the result
+	DeformationMotionCache localCache;
+	if (deformationCache == nullptr || deformationCache->GetState(fullDagPath.asChar()) == DeformationMotionCache::MeshState::Unknown)
+	{
+		deformationCache = &localCache;
+		SampleDeformations({ fullDagPath }, motionSamplesCount, *deformationCache);
+	}
 
-		const float* pData = fnMesh.getRawPoints(&status);
-		assert(MStatus::kSuccess == status);
-		std::copy(pData, pData + floatsVertexOneFrame, arrVertices.data() + floatsVertexOneFrame * currentTimeIndex);
+	const DeformationMotionCache::MeshSamples* samples = deformationCache->Find(fullDagPath.asChar());
 
-		pData = fnMesh.getRawNormals(&status);
-		assert(MStatus::kSuccess == status);
-		std::copy(pData, pData + floatsNormalOneFrame, arrNormals.data() + floatsNormalOneFrame * currentTimeIndex);
+	if (samples == nullptr ||
+		samples->pointCount != countVertices ||
+		samples->normalCount != countNormals ||
+		samples->points.size() != 3 * countVertices * motionSamplesCount)
+	{
+		return false;
 	}
 
-	ChangeCurrentTimeAndUpdateMesh(fnMesh, initialTime, fullDagPath);
+	arrVertices = samples->points;
+	arrNormals = samples->normals;
 
 	return true;
 }
 
-bool FireMaya::MeshTranslator::MeshPolygonData::Initialize(MFnMesh& fnMesh, unsigned int deformationFrameCount, MString fullDagPath)
+bool FireMaya::MeshTranslator::MeshPolygonData::Initialize(MFnMesh& fnMesh, unsigned int deformationFrameCount, MString fullDagPath, DeformationMotionCache* deformationCache)
 {
 	GetUVCoords(fnMesh, uvSetNames, uvCoords, puvCoords, sizeCoords);
 	unsigned int uvSetCount = uvSetNames.length();
@@ -159,7 +420,7 @@ bool FireMaya::MeshTranslator::MeshPolygonData::Initialize(MFnMesh& fnMesh, unsi
 	assert(MStatus::kSuccess == mstatus);
 
 	motionSamplesCount = deformationFrameCount;
-	if (!ProcessDeformationFrameCount(fnMesh, fullDagPath))
+	if (!ProcessDeformationFrameCount(fullDagPath, deformationCache))
 	{
 		motionSamplesCount = 0;
 	}
@@ -177,7 +438,9 @@ std::vector<frw::Shape> FireMaya::MeshTranslator::TranslateMesh(
 	const frw::Context& context, 
 	const MObject& originalObject, 
 	std::vector<int>& outFaceMaterialIndices,
-	unsigned int deformationFrameCount, MString fullDagPath)
+	unsigned int deformationFrameCount, MString fullDagPath,
+	DeformationMotionCache* deformationCache,
+	GeometryKey* geometryKey)
 {
 	MAIN_THREAD_ONLY;
 
@@ -198,24 +461,45 @@ std::vector<frw::Shape> FireMaya::MeshTranslator::TranslateMesh(
 		return resultShapes;
 	}
 
-	// Create tesselated object
-	MObject tessellated = GetTesselatedObjectIfNecessary(originalObject, mayaStatus);
-	if (MStatus::kSuccess != mayaStatus)
+	// Tessellation or smoothing of unchanged geometry is taken from the cache without creating temporary meshes
+	TessellationCache::Key tessellationKey;
+	bool isTessellationCacheable = GetTessellationKey(originalObject, tessellationKey, geometryKey);
+
+	std::shared_ptr<const TessellatedMesh> cachedMesh;
+	if (isTessellationCacheable)
 	{
-		mayaStatus.perror("Tesselation error");
-		return resultShapes;
+		cachedMesh = std::static_pointer_cast<const TessellatedMesh>(TessellationCache::Instance().Find(tessellationKey));
 	}
 
-	MObject smoothed = GetSmoothedObjectIfNecessary(originalObject, mayaStatus);
-	if (MStatus::kSuccess != mayaStatus)
+	MObject tessellated;
+	MObject smoothed;
+
+	if (!cachedMesh)
 	{
-		mayaStatus.perror("Tesselation error");
-		return resultShapes;
+		// Create tesselated object
+		tessellated = GetTesselatedObjectIfNecessary(originalObject, mayaStatus);
+		if (MStatus::kSuccess != mayaStatus)
+		{
+			mayaStatus.perror("Tesselation error");
+			return resultShapes;
+		}
+
+		smoothed = GetSmoothedObjectIfNecessary(originalObject, mayaStatus);
+		if (MStatus::kSuccess != mayaStatus)
+		{
+			mayaStatus.perror("Tesselation error");
+			return resultShapes;
+		}
 	}
 
 	// Consider geting mesh from tesselated or smoothed objects
 	MObject object = originalObject;
 
+	if (cachedMesh)
+	{
+		object = cachedMesh->meshData;
+	}
+
 	if (!tessellated.isNull())
 	{
 		object = tessellated;
@@ -236,13 +520,28 @@ std::vector<frw::Shape> FireMaya::MeshTranslator::TranslateMesh(
 
 	// get number of materials used in this mesh
 	MIntArray faceMaterialIndices;
-	int materialCount = GetFaceMaterials(fnMesh, faceMaterialIndices);
+	int materialCount = 1;
+
+	if (cachedMesh)
+	{
+		faceMaterialIndices = cachedMesh->faceMaterialIndices;
+		materialCount = cachedMesh->materialCount;
+	}
+	else
+	{
+		materialCount = GetFaceMaterials(fnMesh, faceMaterialIndices);
+
+		if (isTessellationCacheable && object != originalObject)
+		{
+			TessellationCache::Instance().Insert(tessellationKey, TessellatedMesh::Create(fnMesh, faceMaterialIndices, materialCount));
+		}
+	}
 
 	// get common data from mesh
 	MeshPolygonData meshPolygonData;
 
 	/// for tesselated or smoothed mesh disable deformation MB for now
-	bool successfullyInitialized = meshPolygonData.Initialize(fnMesh, object != originalObject ? 0 : deformationFrameCount, fullDagPath);
+	bool successfullyInitialized = meshPolygonData.Initialize(fnMesh, object != originalObject ? 0 : deformationFrameCount, fullDagPath, deformationCache);
 	if (!successfullyInitialized)
 	{
 		std::string nodeName = fnMesh.name().asChar();
@@ -339,7 +638,7 @@ MObject FireMaya::MeshTranslator::Smoothed2ndUV(const MObject& object, MStatus&
 	return clonedSmoothedMesh;
 }
 
-MString GenerateSmoothOptions(const MFnDagNode& dagMesh)
+MString FireMaya::MeshTranslator::GenerateSmoothOptions(const MFnDagNode& dagMesh)
 {
 	std::map<std::string, std::string> optionMap;
 
@@ -574,6 +873,109 @@ MObject FireMaya::MeshTranslator::GetSmoothedObjectIfNecessary(const MObject& or
 	return smoothed;
 }
 
+bool FireMaya::MeshTranslator::GetTessellationKey(const MObject& originalObject, TessellationCache::Key& key, GeometryKey* geometryKey)
+{
+	MStatus status;
+
+	GeometryKey localKey;
+	GeometryKey& geometry = geometryKey ? *geometryKey : localKey;
+
+	if (originalObject.hasFn(MFn::kNurbsSurface))
+	{
+		MFnNurbsSurface surface(originalObject, &status);
+
+		// trim curves can come from other nodes, keep tessellating such surfaces every time
+		if (status != MStatus::kSuccess || surface.isTrimmedSurface())
+		{
+			return false;
+		}
+
+		// tessellation settings are attributes of the surface, so they are part of its geometry key
+		if (!geometry.isValid)
+		{
+			TessellationCache::KeyBuilder builder;
+
+			builder.Add(std::string("nurbs"));
+			builder.AddValue(surface.numCVsInU());
+			builder.AddValue(surface.numCVsInV());
+			builder.AddValue(surface.degreeU());
+			builder.AddValue(surface.degreeV());
+			builder.AddValue(int(surface.formInU()));
+			builder.AddValue(int(surface.formInV()));
+
+			MDoubleArray knots;
+			surface.getKnotsInU(knots);
+			AddToKey(builder, knots);
+			surface.getKnotsInV(knots);
+			AddToKey(builder, knots);
+
+			MPointArray cvs;
+			surface.getCVs(cvs, MSpace::kObject);
+			for (unsigned int i = 0; i < cvs.length(); ++i)
+			{
+				double cv[4];
+				cvs[i].get(cv);
+				builder.Add(cv, sizeof(cv));
+			}
+
+			// same attributes as read by TessellateNurbsSurface
+			DependencyNode attributes(originalObject);
+			builder.AddValue(attributes.getInt("modeU"));
+			builder.AddValue(attributes.getInt("numberU"));
+			builder.AddValue(attributes.getInt("modeV"));
+			builder.AddValue(attributes.getInt("numberV"));
+			builder.AddValue(attributes.getBool("smoothEdge"));
+			builder.AddValue(attributes.getBool("useChordHeightRatio"));
+			builder.AddValue(attributes.getBool("edgeSwap"));
+			builder.AddValue(attributes.getBool("useMinScreen"));
+			builder.AddValue(attributes.getDouble("chordHeightRatio"));
+			builder.AddValue(attributes.getDouble("minScreen"));
+
+			geometry.key = builder.Get();
+			geometry.isValid = true;
+		}
+
+		key = geometry.key;
+		return true;
+	}
+
+	// subdivision surfaces are rare, they are tessellated every time
+	if (!originalObject.hasFn(MFn::kMesh) || !DependencyNode(originalObject).getBool("displaySmoothMesh"))
+	{
+		return false;
+	}
+
+	MFnMesh fnMesh(originalObject, &status);
+	if (status != MStatus::kSuccess)
+	{
+		return false;
+	}
+
+	if (!geometry.isValid)
+	{
+		geometry.isValid = GetMeshGeometryKey(fnMesh, geometry.key);
+		if (!geometry.isValid)
+		{
+			return false;
+		}
+	}
+
+	TessellationCache::KeyBuilder builder;
+	builder.Add(std::string("smoothed"));
+
+	// smoothing type can come from an option var, which doesn't dirty the mesh
+	AddToKey(builder, GenerateSmoothOptions(MFnDagNode(originalObject)));
+	builder.Add(&geometry.key, sizeof(geometry.key));
+
+	// smoothed copy keeps shading group assignments of the faces, they change without dirtying the mesh
+	MIntArray faceMaterialIndices;
+	builder.AddValue(GetFaceMaterials(fnMesh, faceMaterialIndices));
+	AddToKey(builder, faceMaterialIndices);
+
+	key = builder.Get();
+	return true;
+}
+
 MObject FireMaya::MeshTranslator::GetTesselatedObjectIfNecessary(const MObject& originalObject, MStatus& mstatus)
 {
 #ifdef OPTIMIZATION_CLOCK
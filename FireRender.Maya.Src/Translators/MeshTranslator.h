@@ -14,6 +14,8 @@ limitations under the License.
 
 #include "frWrap.h"
 #include "FireRenderUtils.h"
+#include "DeformationMotionCache.h"
+#include "TessellationCache.h"
 
 #include <maya/MItMeshPolygon.h>
 #include <maya/MObject.h>
@@ -45,8 +47,8 @@ namespace FireMaya
 			MeshPolygonData();
 
 			// Initializes mesh and returns error status
-			bool Initialize(MFnMesh& fnMesh, unsigned int deformationFrameCount, MString fullDagPath);
-			bool ProcessDeformationFrameCount(MFnMesh& fnMesh, MString fullDagPath);
+			bool Initialize(MFnMesh& fnMesh, unsigned int deformationFrameCount, MString fullDagPath, DeformationMotionCache* deformationCache = nullptr);
+			bool ProcessDeformationFrameCount(MString fullDagPath, DeformationMotionCache* deformationCache);
 
 			size_t GetTotalVertexCount() { return std::max(arrVertices.size() / 3, countVertices); }
 			size_t GetTotalNormalCount() { return std::max(arrNormals.size() / 3, countNormals); }
@@ -99,12 +101,32 @@ namespace FireMaya
 			std::map<int, MColor> vertexColors;
 		};
 
-		static std::vector<frw::Shape> TranslateMesh(const frw::Context& context, const MObject& originalObject, std::vector<int>& outFaceMaterialIndices, unsigned int deformationFrameCount = 0, MString fullDagPath="");
+		/** Hash of the geometry a tessellation or smoothing result depends on. Owners of a shape keep it
+			between translations and reset it when the shape is dirtied, so unchanged geometry is not hashed again. */
+		struct GeometryKey
+		{
+			TessellationCache::Key key;
+			bool isValid = false;
+		};
+
+		static std::vector<frw::Shape> TranslateMesh(const frw::Context& context, const MObject& originalObject, std::vector<int>& outFaceMaterialIndices, unsigned int deformationFrameCount = 0, MString fullDagPath="", DeformationMotionCache* deformationCache = nullptr, GeometryKey* geometryKey = nullptr);
+
+		/** Samples points and normals of deforming meshes for deformation motion blur into the cache.
+			Each motion sample time is evaluated once for all meshes through MDGContext, current time is not changed.
+			Meshes already known to the cache are skipped. */
+		static void SampleDeformations(const std::vector<MString>& meshPaths, unsigned int motionSamplesCount, DeformationMotionCache& cache);
+
+		/** Meshes translated afterwards are welded and reordered before upload, see MeshCompaction. */
+		static void SetCompactionEnabled(bool enabled);
+		static bool IsCompactionEnabled();
 
 	private:
 
 		static MObject GenerateSmoothMesh(const MObject& object, const MObject& parent, MStatus& status);
 
+		/** polySmooth flags matching the smooth mesh preview settings of the mesh. */
+		static MString GenerateSmoothOptions(const MFnDagNode& dagMesh);
+
 		/** Tessellate a NURBS surface and return the resulting mesh object. */
 		static MObject TessellateNurbsSurface(const MObject& object, const MObject& parent, MStatus& status);
 
@@ -112,6 +134,11 @@ namespace FireMaya
 
 		static MObject GetSmoothedObjectIfNecessary(const MObject& originalObject, MStatus& mstatus);
 
+		/** Builds the tessellation cache key of a NURBS surface or a mesh that is smoothed for rendering.
+			Returns false if the shape isn't tessellated or smoothed, or its result can't be cached.
+			A valid geometryKey is used instead of hashing the shape, an invalid one is filled. */
+		static bool GetTessellationKey(const MObject& originalObject, TessellationCache::Key& key, GeometryKey* geometryKey);
+
 		static void GetUVCoords(
 			const MFnMesh& fnMesh,
 			MStringArray& uvSetNames,
@@ -11,6 +11,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ********************************************************************/
 #include "SingleShaderMeshTranslator.h"
+#include "MeshCompaction.h"
 
 void FireMaya::SingleShaderMeshTranslator::TranslateMesh(
 	const frw::Context& context,
@@ -115,15 +116,84 @@ void FireMaya::SingleShaderMeshTranslator::TranslateMesh(
 		mesh_properties[2] = (rpr_mesh_info)0;
 	}
 
-	elements[0] = context.CreateMeshEx(
-		meshData.GetVertices(), meshData.GetTotalVertexCount(), sizeof(Float3),
-		meshData.GetNormals(), meshData.GetTotalNormalCount(), sizeof(Float3),
-		nullptr, 0, 0,
-		uvSetCount, meshData.puvCoords.data(), meshData.sizeCoords.data(), multiUV_texcoord_strides.data(),
-		faceVertexIndices.data(), sizeof(rpr_int),
-		faceNormalIndices.data(), sizeof(rpr_int),
-		puvIndices.data(), texIndexStride.data(),
-		numFaceVertices.data(), numFaceVertices.size(), mesh_properties, fnMesh.name().asChar());
+	// Vertex colors are indexed by Maya vertices, such meshes are uploaded as they are
+	MeshCompaction::Mesh compacted;
+	bool isCompacted = false;
+
+	if (MeshTranslator::IsCompactionEnabled() && vertexColors.empty() && meshData.countVertices > 0 &&
+		outFaceMaterialIndices.size() == numFaceVertices.size())
+	{
+		MeshCompaction::Input input;
+		input.positions = meshData.GetVertices();
+		input.positionCount = meshData.countVertices;
+		input.positionSamples = (unsigned int) (meshData.GetTotalVertexCount() / meshData.countVertices);
+
+		if (meshData.countNormals > 0 && !faceNormalIndices.empty())
+		{
+			input.normals = meshData.GetNormals();
+			input.normalCount = meshData.countNormals;
+			input.normalSamples = (unsigned int) (meshData.GetTotalNormalCount() / meshData.countNormals);
+			input.normalIndices = faceNormalIndices.data();
+		}
+
+		for (unsigned int idx = 0; idx < uvSetCount; ++idx)
+		{
+			input.uvs.push_back(meshData.puvCoords[idx]);
+			input.uvCounts.push_back(meshData.sizeCoords[idx]);
+			input.uvIndices.push_back(puvIndices[idx]);
+		}
+
+		input.positionIndices = faceVertexIndices.data();
+		input.faceVertexCounts = numFaceVertices.data();
+		input.faceCount = numFaceVertices.size();
+
+		// Displacement and subdivision are set up on the shape later by its shaders and need
+		// the points connected across uv seams and hard edges, so positions are never split
+		MeshCompaction::Options options;
+		options.keepPositions = true;
+
+		// normals that differ at every face-vertex don't weld, the shared index array would only add data then
+		isCompacted = MeshCompaction::Compact(input, options, compacted) &&
+			MeshCompaction::MeshBytes(compacted) < MeshCompaction::InputBytes(input);
+	}
+
+	if (isCompacted)
+	{
+		// one index array addresses normals and every uv set
+		std::vector<const float*> compactedUVs;
+		std::vector<size_t> compactedUVCounts(uvSetCount, compacted.vertexCount);
+		std::vector<const rpr_int*> compactedUVIndices(uvSetCount, compacted.indices.data());
+
+		for (unsigned int idx = 0; idx < uvSetCount; ++idx)
+		{
+			compactedUVs.push_back(compacted.uvs[idx].data());
+		}
+
+		// material of a face follows the face to its new place
+		MeshCompaction::RemapFaceData(compacted, outFaceMaterialIndices);
+
+		elements[0] = context.CreateMeshEx(
+			compacted.positions.data(), compacted.positions.size() / 3, sizeof(Float3),
+			compacted.normals.empty() ? nullptr : compacted.normals.data(), compacted.normals.size() / 3, sizeof(Float3),
+			nullptr, 0, 0,
+			uvSetCount, compactedUVs.data(), compactedUVCounts.data(), multiUV_texcoord_strides.data(),
+			compacted.positionIndices.data(), sizeof(rpr_int),
+			compacted.normals.empty() ? nullptr : compacted.indices.data(), sizeof(rpr_int),
+			compactedUVIndices.data(), texIndexStride.data(),
+			compacted.faceVertexCounts.data(), compacted.faceVertexCounts.size(), mesh_properties, fnMesh.name().asChar());
+	}
+	else
+	{
+		elements[0] = context.CreateMeshEx(
+			meshData.GetVertices(), meshData.GetTotalVertexCount(), sizeof(Float3),
+			meshData.GetNormals(), meshData.GetTotalNormalCount(), sizeof(Float3),
+			nullptr, 0, 0,
+			uvSetCount, meshData.puvCoords.data(), meshData.sizeCoords.data(), multiUV_texcoord_strides.data(),
+			faceVertexIndices.data(), sizeof(rpr_int),
+			faceNormalIndices.data(), sizeof(rpr_int),
+			puvIndices.data(), texIndexStride.data(),
+			numFaceVertices.data(), numFaceVertices.size(), mesh_properties, fnMesh.name().asChar());
+	}
 
 	if (!vertexColors.empty())
 	{
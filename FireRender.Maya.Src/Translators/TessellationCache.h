@@ -0,0 +1,34 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include "ContentCache.h"
+
+/** Results of NURBS tessellation and mesh smoothing, reused between translations.
+	Tessellating or smoothing creates temporary Maya nodes and is the most expensive part of
+	translating such shapes. A shading or transform edit dirties the shape without changing its
+	geometry, so the previous result can be used again. Entries are addressed by a hash of
+	everything the result depends on (topology, points, uvs, settings), which also lets identical
+	shapes share one result. */
+class TessellationCache : public ContentCache
+{
+public:
+	static TessellationCache& Instance();
+
+	explicit TessellationCache(size_t budget = DefaultBudget) :
+		ContentCache(budget)
+	{
+	}
+
+	static const size_t DefaultBudget = size_t(512) << 20;
+};
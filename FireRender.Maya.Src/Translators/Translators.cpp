@@ -667,8 +667,15 @@ namespace FireMaya
 					return false;
 				}
 
+				// triangles are kept until the mesh is dirtied or another mesh is used
+				if (!(frlight.meshAreaNode == shapeDagPath.node()))
+				{
+					frlight.meshArea.reset();
+					frlight.meshAreaNode = shapeDagPath.node();
+				}
+
 				transformMatrix = trm.asMatrix() * shapeDagPath.inclusiveMatrix();
-				calculatedArea = PhysicalLightGeometryUtility::GetAreaOfMesh(shapeDagPath.node(), transformMatrix);
+				calculatedArea = PhysicalLightGeometryUtility::GetAreaOfMesh(shapeDagPath.node(), transformMatrix, frlight.meshArea);
 			}
 
 			frlight.areaLight.SetShader(frlight.emissive);
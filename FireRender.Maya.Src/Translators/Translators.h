@@ -15,8 +15,10 @@ limitations under the License.
 #include "frWrap.h"
 #include "FireMaya.h"
 #include "MeshTranslator.h"
+#include "Lights/PhysicalLight/MeshLightArea.h"
 
 #include <maya/MObject.h>
+#include <maya/MObjectHandle.h>
 #include <maya/MFnCamera.h>
 #include <maya/MMatrix.h>
 #include <maya/MColor.h>
@@ -65,6 +67,8 @@ public:
 		scaleX = other.scaleX;
 		scaleY = other.scaleY;
 		scaleZ = other.scaleZ;
+		meshArea = other.meshArea;
+		meshAreaNode = other.meshAreaNode;
 	}
 
 	FrLight& operator=(const FrLight& other)
@@ -79,6 +83,8 @@ public:
 		scaleX = other.scaleX;
 		scaleY = other.scaleY;
 		scaleZ = other.scaleZ;
+		meshArea = other.meshArea;
+		meshAreaNode = other.meshAreaNode;
 		return *this;
 	}
 
@@ -107,6 +113,10 @@ public:
 	float scaleZ;
 
 	bool isAreaLight;
+
+	// triangles of a mesh area light and the mesh they were built from
+	std::shared_ptr<const MeshLightArea::Triangles> meshArea;
+	MObjectHandle meshAreaNode;
 };
 
 namespace FireMaya
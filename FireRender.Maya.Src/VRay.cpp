@@ -21,8 +21,7 @@ limitations under the License.
 #include "Translators/Translators.h"
 #include <functional>
 
-#include "IESLight/IESprocessor.h"
-#include "IESLight/IESLightRepresentationCalc.h"
+#include "Lights/IES/IESProfileCache.h"
 
 
 namespace FireMaya
@@ -720,15 +719,19 @@ namespace FireMaya
 			else
 			{
 				auto iesFile = data.filePath;
-				IESProcessor processor;
-				IESLightRepresentationParams params;
 
-				if (iesFile.length() && 
-					processor.Parse(params.data, iesFile.asWChar()) == IESProcessor::ErrorCode::SUCCESS)
+				// Lights sharing the file share its parsed data
+				std::shared_ptr<const IESProfileCache::Profile> profile;
+				if (iesFile.length())
+				{
+					profile = IESProfileCache::Instance().Get(iesFile.asWChar());
+				}
+
+				if (profile && profile->isParsed)
 				{
 					auto iesLight = frcontext.CreateIESLight();
 
-					rpr_int res = iesLight.SetIESData(processor.ToString(params.data).c_str(), 256, 256);
+					rpr_int res = iesLight.SetIESData(profile->iesData.c_str(), 256, 256);
 					assert(res == RPR_SUCCESS);
 
 					if (res == RPR_SUCCESS)
@@ -0,0 +1,388 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "VRayConversionPlan.h"
+
+#include <map>
+
+namespace VRayConversion
+{
+
+namespace
+{
+	// FireMaya::Material::kEmissive
+	const int EmissiveMaterialType = 6;
+
+	// Used by the batch plan and the per object conversion of FireRenderConvertVRayCmd
+	const ShaderRule ShaderRules[] =
+	{
+		{ "VRayMtl", "RPRUberMaterial", true,
+			{
+				{ Operation::Kind::SetBool, "reflections", 1 },
+				{ Operation::Kind::SetBool, "clearCoat", 1 },
+			},
+			{
+				{ "dc", "diffuseColor", Transform::Copy },
+				{ "rlc", "reflectColor", Transform::Copy },
+				{ "rlca", "reflectIOR", Transform::Copy },
+				{ "ra", "reflectRoughnessX", Transform::Copy },
+				{ "rlc", "coatColor", Transform::Copy },
+				{ "fior", "coatIOR", Transform::Copy },
+				{ "rrc", "refractColor", Transform::Copy },
+				{ "rrcr", "refraction", Transform::Enabled },
+				{ "rrcr", "refractWeight", Transform::Copy },
+				{ "rrg", "refractRoughness", Transform::OneMinus },
+				{ "rior", "refractIOR", Transform::Copy },
+				{ "an", "reflectAnisotropy", Transform::Copy },
+				{ "anr", "reflectAnisotropyRotation", Transform::Copy },
+				{ "ssson", "sssEnable", Transform::AsBool },
+				{ "tlc", "sssColor", Transform::Copy },
+				{ "scdir", "scatteringDirection", Transform::Copy },
+				{ "sclvl", "sssWeight", Transform::Copy },
+				{ "omr", "transparencyLevel", Transform::OneMinus },
+			}
+		},
+		{ "VRayAlSurface", "RPRUberMaterial", false,
+			{
+				{ Operation::Kind::SetBool, "reflections", 1 },
+			},
+			{
+				{ "diffuse", "diffuseColor", Transform::Copy },
+				{ "diffuseBumpMap", "diffuseNormal", Transform::Copy },
+				{ "reflect1", "reflectColor", Transform::Copy },
+				{ "reflect1IOR", "reflectIOR", Transform::Copy },
+				{ "reflect1Roughness", "reflectRoughnessX", Transform::Copy },
+				{ "reflect1BumpMap", "reflectNormal", Transform::Copy },
+				{ "opacity", "transparencyLevel", Transform::OneMinus },
+			}
+		},
+		{ "VRayCarPaintMtl", "RPRUberMaterial", false,
+			{
+				{ Operation::Kind::SetBool, "reflections", 1 },
+				{ Operation::Kind::SetBool, "clearCoat", 1 },
+			},
+			{
+				{ "bcol", "diffuseColor", Transform::Copy },
+				{ "bbm", "diffuseNormal", Transform::Copy },
+				{ "bcol", "reflectColor", Transform::Copy },
+				{ "brfl", "reflectIOR", Transform::IorFromReflection },
+				{ "ctcol", "coatColor", Transform::Copy },
+			}
+		},
+		{ "VRayFastSSS2", "RPRSubsurfaceMaterial", false,
+			{},
+			{
+				{ "df", "surfaceColor", Transform::Copy },
+				{ "dfa", "surfaceIntensity", Transform::Copy },
+				{ "ssc", "subsurfaceColor", Transform::Copy },
+				{ "scrc", "scatterColor", Transform::Copy },
+				{ "scrm", "scatterAmount", Transform::Copy },
+				{ "phf", "scatteringDirection", Transform::Copy },
+			}
+		},
+		{ "VRayLightMtl", "RPRMaterial", false,
+			{
+				{ Operation::Kind::SetInt, "type", EmissiveMaterialType },
+			},
+			{
+				{ "cl", "color", Transform::Copy },
+			}
+		},
+		{ "VRayBlendMtl", "RPRBlendMaterial", false, {}, {} },
+	};
+
+	const char* const VRayMaterialTypes[] =
+	{
+		"VRayBlendMtl", "VRayAlSurface", "VRayBumpMtl", "VRayCarPaintMtl", "VRayFastSSS2", "VRayFlakesMtl", "VRayLightMtl",
+		"VRayMeshMaterial", "VRayMtl", "VRayMtl2Sided", "VRayMtlHair3", "VRayMtlOSL", "VRayMtlWrapper",
+	};
+
+	const char* const WrapperType = "VRayMtlWrapper";
+	const char* const WrappedAttribute = "bm";
+
+	const char* const ShadingEngineType = "shadingEngine";
+	const char* const SurfaceShaderAttribute = "ss";
+	const char* const MembersAttribute = "dsm";
+
+	bool IsAnimCurve(const std::string& type)
+	{
+		return type.compare(0, 9, "animCurve") == 0;
+	}
+
+	class Planner
+	{
+	public:
+		Planner(const Index& index, Plan& plan) :
+			m_index(index),
+			m_plan(plan)
+		{
+		}
+
+		// Index of the shader converted from the material, -1 if it can't be converted
+		int Convert(NodeId material)
+		{
+			auto it = m_shaders.find(material);
+			if (it != m_shaders.end())
+			{
+				if (it->second >= 0)
+					m_plan.memoizedShaders++;
+
+				return it->second;
+			}
+
+			// wrapped material is converted in place of the wrapper, and named after it
+			NodeId source = material;
+			while (source != NoNode && m_index.Type(source) == WrapperType)
+			{
+				const Connection* wrapped = m_index.Input(source, WrappedAttribute);
+				source = wrapped && !IsAnimCurve(m_index.Type(wrapped->source)) ? wrapped->source : NoNode;
+			}
+
+			int shader = -1;
+
+			const ShaderRule* rule = source != NoNode ? FindRule(m_index.Type(source)) : nullptr;
+			if (rule)
+			{
+				auto converted = m_shaders.find(source);
+				if (converted != m_shaders.end())
+				{
+					shader = converted->second;
+					m_plan.memoizedShaders++;
+				}
+				else
+				{
+					shader = int(m_plan.shaders.size());
+					m_plan.shaders.push_back(MakeShader(*rule, source, material));
+					m_shaders[source] = shader;
+				}
+			}
+			else
+			{
+				m_plan.unsupported++;
+			}
+
+			m_shaders[material] = shader;
+
+			return shader;
+		}
+
+	private:
+		Shader MakeShader(const ShaderRule& rule, NodeId source, NodeId material)
+		{
+			Shader shader;
+			shader.source = source;
+			shader.type = rule.rprType;
+
+			if (rule.keepName)
+				shader.name = m_index.Name(material);
+
+			for (const ConstantRule& constant : rule.constants)
+			{
+				Operation operation;
+				operation.kind = constant.kind;
+				operation.destinationAttribute = constant.destination;
+				operation.value = constant.value;
+
+				shader.operations.push_back(std::move(operation));
+			}
+
+			for (const AttributeRule& attribute : rule.attributes)
+			{
+				Operation operation;
+				operation.destinationAttribute = attribute.destination;
+
+				const Connection* input = attribute.transform == Transform::Copy ? m_index.Input(source, attribute.source) : nullptr;
+
+				if (input && !IsAnimCurve(m_index.Type(input->source)))
+				{
+					operation.kind = Operation::Kind::Connect;
+					operation.upstream = FindUpstream(input->source, input->sourceAttribute);
+				}
+				else
+				{
+					operation.kind = Operation::Kind::FromSource;
+					operation.sourceAttribute = attribute.source;
+					operation.transform = attribute.transform;
+				}
+
+				shader.operations.push_back(std::move(operation));
+			}
+
+			return shader;
+		}
+
+		// Textures feeding many materials are resolved once by the command
+		size_t FindUpstream(NodeId node, const std::string& attribute)
+		{
+			auto key = std::make_pair(node, attribute);
+
+			auto it = m_upstream.find(key);
+			if (it != m_upstream.end())
+			{
+				m_plan.memoizedUpstream++;
+				return it->second;
+			}
+
+			size_t upstream = m_plan.upstream.size();
+			m_plan.upstream.push_back({ node, attribute });
+			m_upstream[key] = upstream;
+
+			return upstream;
+		}
+
+		const Index& m_index;
+		Plan& m_plan;
+
+		std::unordered_map<NodeId, int> m_shaders;
+		std::map<std::pair<NodeId, std::string>, size_t> m_upstream;
+	};
+
+	// Material still assigned after the plan: it is the surface shader of a shading engine with members
+	// which is kept, or an input of such a material
+	bool IsStillAssigned(const Index& index, NodeId material, const std::vector<bool>& reassigned, std::vector<int>& state)
+	{
+		// 0 unknown, 1 in progress, 2 assigned, 3 not assigned
+		if (state[material] != 0)
+			return state[material] == 2;
+
+		state[material] = 1;
+		bool assigned = false;
+
+		for (size_t c : index.Outputs(material))
+		{
+			const Connection& connection = index.GetConnection(c);
+			NodeId destination = connection.destination;
+
+			if (index.Type(destination) == ShadingEngineType)
+			{
+				if (connection.destinationAttribute != SurfaceShaderAttribute || reassigned[destination])
+					continue;
+
+				for (size_t m : index.Inputs(destination))
+				{
+					if (index.GetConnection(m).destinationAttribute == MembersAttribute)
+					{
+						assigned = true;
+						break;
+					}
+				}
+			}
+			else if (IsVRayMaterial(index.Type(destination)))
+			{
+				assigned = IsStillAssigned(index, destination, reassigned, state);
+			}
+
+			if (assigned)
+				break;
+		}
+
+		state[material] = assigned ? 2 : 3;
+
+		return assigned;
+	}
+}
+
+NodeId Index::AddNode(const std::string& name, const std::string& type)
+{
+	Node node;
+	node.name = name;
+	node.type = type;
+
+	m_nodes.push_back(std::move(node));
+
+	return NodeId(m_nodes.size() - 1);
+}
+
+void Index::AddConnection(NodeId source, const std::string& sourceAttribute, NodeId destination, const std::string& destinationAttribute)
+{
+	size_t connection = m_connections.size();
+	m_connections.push_back({ source, sourceAttribute, destination, destinationAttribute });
+
+	m_nodes[source].outputs.push_back(connection);
+	m_nodes[destination].inputs.push_back(connection);
+}
+
+const Connection* Index::Input(NodeId node, const std::string& attribute) const
+{
+	for (size_t c : m_nodes[node].inputs)
+	{
+		if (m_connections[c].destinationAttribute == attribute)
+			return &m_connections[c];
+	}
+
+	return nullptr;
+}
+
+const ShaderRule* FindRule(const std::string& vrayType)
+{
+	for (const ShaderRule& rule : ShaderRules)
+	{
+		if (vrayType == rule.vrayType)
+			return &rule;
+	}
+
+	return nullptr;
+}
+
+bool IsVRayMaterial(const std::string& type)
+{
+	for (const char* vrayType : VRayMaterialTypes)
+	{
+		if (type == vrayType)
+			return true;
+	}
+
+	return false;
+}
+
+Plan MakePlan(const Index& index)
+{
+	Plan plan;
+	Planner planner(index, plan);
+
+	std::vector<bool> reassigned(index.NodeCount(), false);
+	std::vector<NodeId> converted;
+
+	for (NodeId node = 0; node < NodeId(index.NodeCount()); node++)
+	{
+		if (index.Type(node) != ShadingEngineType)
+			continue;
+
+		const Connection* surface = index.Input(node, SurfaceShaderAttribute);
+		if (!surface || !IsVRayMaterial(index.Type(surface->source)))
+			continue;
+
+		int shader = planner.Convert(surface->source);
+		if (shader < 0)
+			continue;
+
+		plan.assignments.push_back({ node, surface->source, surface->sourceAttribute, size_t(shader) });
+		reassigned[node] = true;
+		converted.push_back(surface->source);
+	}
+
+	std::vector<int> state(index.NodeCount(), 0);
+	std::vector<bool> deleted(index.NodeCount(), false);
+
+	for (NodeId material : converted)
+	{
+		if (!deleted[material] && !IsStillAssigned(index, material, reassigned, state))
+		{
+			deleted[material] = true;
+			plan.deletions.push_back(material);
+		}
+	}
+
+	return plan;
+}
+
+}
@@ -0,0 +1,191 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/** Planning of the batch conversion of VRay materials.
+	The command indexes the shading engines of the scene, their materials and the inputs of
+	the materials in one pass; the plan is made from that index only, without querying Maya
+	again, and is then applied with a single modifier. Nodes are identified by indices into
+	the index, attributes by their short names without array indices. */
+namespace VRayConversion
+{
+	typedef int NodeId;
+
+	const NodeId NoNode = -1;
+
+	struct Connection
+	{
+		NodeId source;
+		std::string sourceAttribute;
+		NodeId destination;
+		std::string destinationAttribute;
+	};
+
+	class Index
+	{
+	public:
+		// Names are only used for naming converted shaders, the caller adds each node once
+		NodeId AddNode(const std::string& name, const std::string& type);
+
+		void AddConnection(NodeId source, const std::string& sourceAttribute, NodeId destination, const std::string& destinationAttribute);
+
+		size_t NodeCount() const { return m_nodes.size(); }
+		const std::string& Name(NodeId node) const { return m_nodes[node].name; }
+		const std::string& Type(NodeId node) const { return m_nodes[node].type; }
+
+		// Connection into the attribute, nullptr if it is not connected
+		const Connection* Input(NodeId node, const std::string& attribute) const;
+
+		const std::vector<size_t>& Inputs(NodeId node) const { return m_nodes[node].inputs; }
+		const std::vector<size_t>& Outputs(NodeId node) const { return m_nodes[node].outputs; }
+		const Connection& GetConnection(size_t connection) const { return m_connections[connection]; }
+
+	private:
+		struct Node
+		{
+			std::string name;
+			std::string type;
+			std::vector<size_t> inputs;
+			std::vector<size_t> outputs;
+		};
+
+		std::vector<Node> m_nodes;
+		std::vector<Connection> m_connections;
+	};
+
+	// How the destination value is made from the source attribute
+	enum class Transform
+	{
+		Copy,			// connected upstream node is connected, otherwise the value is copied
+		OneMinus,		// 1 - value
+		Enabled,		// value >= epsilon
+		AsBool,
+		IorFromReflection,	// 2 / (sqrt(value) + 1) - 1
+	};
+
+	struct Operation
+	{
+		enum class Kind
+		{
+			Connect,		// upstream plug to destination
+			FromSource,		// value of the source attribute, transformed
+			SetBool,
+			SetInt,
+		};
+
+		Kind kind;
+		std::string destinationAttribute;
+
+		// Connect: index into Plan::upstream
+		size_t upstream = 0;
+
+		// FromSource
+		std::string sourceAttribute;
+		Transform transform = Transform::Copy;
+
+		// SetBool, SetInt
+		int value = 0;
+	};
+
+	struct AttributeRule
+	{
+		const char* source;
+		const char* destination;
+		Transform transform;
+	};
+
+	struct ConstantRule
+	{
+		// SetBool or SetInt
+		Operation::Kind kind;
+		const char* destination;
+		int value;
+	};
+
+	/** Mapping of a VRay material type to an RPR shader, used by the batch plan and the per object conversion */
+	struct ShaderRule
+	{
+		const char* vrayType;
+		const char* rprType;
+
+		// converted shader is named after the VRay material
+		bool keepName;
+
+		std::vector<ConstantRule> constants;
+		std::vector<AttributeRule> attributes;
+	};
+
+	// nullptr if the type can't be converted by a rule
+	const ShaderRule* FindRule(const std::string& vrayType);
+
+	struct Shader
+	{
+		// material the values are read from, may differ from the converted node for wrappers
+		NodeId source;
+
+		std::string type;
+
+		// empty to keep the default name of the type
+		std::string name;
+
+		std::vector<Operation> operations;
+	};
+
+	struct Upstream
+	{
+		NodeId node;
+		std::string attribute;
+	};
+
+	struct Assignment
+	{
+		NodeId shadingEngine;
+
+		// connection of the VRay material to the shading engine
+		NodeId material;
+		std::string materialAttribute;
+
+		size_t shader;
+	};
+
+	struct Plan
+	{
+		std::vector<Shader> shaders;
+
+		// outputs of upstream nodes connected to new shaders, each listed once
+		std::vector<Upstream> upstream;
+
+		std::vector<Assignment> assignments;
+
+		// VRay materials left without assigned shading engines
+		std::vector<NodeId> deletions;
+
+		// shaders reused for another shading engine or wrapper
+		size_t memoizedShaders = 0;
+
+		// upstream connections found in the list for another shader
+		size_t memoizedUpstream = 0;
+
+		// VRay materials of a type that can't be converted
+		size_t unsupported = 0;
+	};
+
+	bool IsVRayMaterial(const std::string& type);
+
+	// Shading engines of the index with a VRay material get a converted shader
+	Plan MakePlan(const Index& index);
+}
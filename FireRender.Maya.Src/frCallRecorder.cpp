@@ -0,0 +1,261 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#include "frCallRecorder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace frw
+{
+namespace CallLog
+{
+
+namespace
+{
+	const char Magic[8] = { 'F', 'R', 'W', 'C', 'A', 'L', 'L', 'S' };
+	const uint8_t Version = 1;
+
+	bool CreatesTarget(Call call)
+	{
+		switch (call)
+		{
+		case Call::CreateMesh:
+		case Call::CreateImage:
+		case Call::CreateFrameBuffer:
+		case Call::CreateMaterialNode:
+		case Call::CreateLight:
+			return true;
+		default:
+			return false;
+		}
+	}
+}
+
+const char* CallName(Call call)
+{
+	static const char* names[] =
+	{
+		"CreateMesh",
+		"CreateImage",
+		"CreateFrameBuffer",
+		"CreateMaterialNode",
+		"CreateLight",
+		"SetParameter",
+		"SetTransform",
+		"SetMaterialNodeInput",
+		"SetShapeMaterial",
+		"SceneAttach",
+		"SceneDetach",
+		"ObjectDelete",
+		"Render",
+		"ResolveFrameBuffer",
+		"ClearFrameBuffer"
+	};
+
+	static_assert(sizeof(names) / sizeof(names[0]) == size_t(Call::Count), "Call names are out of sync with Call enum");
+
+	return size_t(call) < size_t(Call::Count) ? names[size_t(call)] : "Unknown";
+}
+
+Writer::Writer(std::ostream& out) :
+	m_out(out)
+{
+	m_out.write(Magic, sizeof(Magic));
+	m_out.put(char(Version));
+}
+
+uint64_t Writer::GetId(const void* handle, bool created)
+{
+	if (!handle)
+		return 0;
+
+	// a created object always gets a new id, its handle may be a reused address of a deleted one
+	if (created)
+		return m_ids[handle] = ++m_lastId;
+
+	auto it = m_ids.find(handle);
+	if (it != m_ids.end())
+		return it->second;
+
+	return m_ids[handle] = ++m_lastId;
+}
+
+void Writer::Write(Call call, uint64_t timeUs, const void* object, const void* target, uint64_t key, uint64_t bytes)
+{
+	Record record;
+	record.call = call;
+	record.timeDeltaUs = timeUs > m_lastTimeUs ? timeUs - m_lastTimeUs : 0;
+	record.object = GetId(object, false);
+	record.target = GetId(target, CreatesTarget(call));
+	record.key = key;
+	record.bytes = bytes;
+
+	m_lastTimeUs = std::max(m_lastTimeUs, timeUs);
+
+	if (call == Call::ObjectDelete)
+		m_ids.erase(object);
+
+	Write(record);
+}
+
+void Writer::Write(const Record& record)
+{
+	m_out.put(char(record.call));
+	WriteVarint(record.timeDeltaUs);
+	WriteVarint(record.object);
+	WriteVarint(record.target);
+	WriteVarint(record.key);
+	WriteVarint(record.bytes);
+
+	m_recordCount++;
+}
+
+void Writer::WriteVarint(uint64_t value)
+{
+	// LEB128: 7 bits per byte, high bit set on all but the last byte
+	char buffer[10];
+	int size = 0;
+
+	do
+	{
+		uint8_t byte = value & 0x7f;
+		value >>= 7;
+
+		buffer[size++] = char(value ? (byte | 0x80) : byte);
+	} while (value);
+
+	m_out.write(buffer, size);
+}
+
+Reader::Reader(std::istream& in) :
+	m_in(in)
+{
+	char magic[sizeof(Magic)] = {};
+	m_in.read(magic, sizeof(magic));
+
+	int version = m_in.get();
+
+	m_valid = m_in && std::memcmp(magic, Magic, sizeof(Magic)) == 0 && version == Version;
+}
+
+bool Reader::Next(Record& record)
+{
+	if (!m_valid)
+		return false;
+
+	int call = m_in.get();
+	if (call == std::char_traits<char>::eof() || call >= int(Call::Count))
+		return false;
+
+	record.call = Call(call);
+
+	return ReadVarint(record.timeDeltaUs) &&
+		ReadVarint(record.object) &&
+		ReadVarint(record.target) &&
+		ReadVarint(record.key) &&
+		ReadVarint(record.bytes);
+}
+
+bool Reader::ReadVarint(uint64_t& value)
+{
+	value = 0;
+
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		int byte = m_in.get();
+		if (byte == std::char_traits<char>::eof())
+			return false;
+
+		value |= uint64_t(byte & 0x7f) << shift;
+
+		if (!(byte & 0x80))
+			return true;
+	}
+
+	return false;
+}
+
+}
+
+CallRecorder& CallRecorder::Instance()
+{
+	static CallRecorder instance;
+	return instance;
+}
+
+CallRecorder::CallRecorder() :
+	m_enabled(false),
+	m_startTime(std::chrono::steady_clock::now())
+{
+}
+
+CallRecorder::~CallRecorder()
+{
+	Disable();
+}
+
+void CallRecorder::EnableFromEnvironment()
+{
+	const char* path = std::getenv("RPR_MAYA_CALL_LOG_OUTPUT");
+
+	if (path && path[0] != '\0')
+	{
+		Enable(path);
+	}
+}
+
+bool CallRecorder::Enable(const std::string& outputPath)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_writer.reset();
+	m_file.close();
+
+	m_file.open(outputPath, std::ios::binary | std::ios::trunc);
+	if (!m_file)
+	{
+		m_enabled = false;
+		return false;
+	}
+
+	m_writer.reset(new CallLog::Writer(m_file));
+	m_startTime = std::chrono::steady_clock::now();
+	m_enabled = true;
+
+	return true;
+}
+
+void CallRecorder::Disable()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	m_enabled = false;
+	m_writer.reset();
+	m_file.close();
+}
+
+void CallRecorder::AddRecord(CallLog::Call call, const void* object, const void* target, uint64_t key, uint64_t bytes)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// disabled while waiting for the lock
+	if (!m_writer)
+		return;
+
+	uint64_t timeUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_startTime).count();
+
+	m_writer->Write(call, timeUs, object, target, key, bytes);
+}
+
+}
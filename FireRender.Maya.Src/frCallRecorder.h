@@ -0,0 +1,158 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace frw
+{
+	/** Binary log of the RPR calls issued through frw wrappers.
+
+		Only what is needed to reproduce the load of a sync is kept: which call, which objects,
+		the parameter key and the payload size. Handles are replaced by ids numbered in the order
+		objects were first seen (0 is null), so a log doesn't depend on addresses and can be fed
+		into another backend. Records are a call byte followed by varints: time since the
+		previous record in microseconds, object id, target id, key and payload bytes. */
+	namespace CallLog
+	{
+		enum class Call : uint8_t
+		{
+			CreateMesh = 0,			// target: new shape
+			CreateImage,			// target: new image
+			CreateFrameBuffer,		// target: new frame buffer
+			CreateMaterialNode,		// target: new node, key: node type
+			CreateLight,			// target: new light, key: light type
+			SetParameter,			// key: parameter
+			SetTransform,
+			SetMaterialNodeInput,	// key: input
+			SetShapeMaterial,		// target: material, null when removed
+			SceneAttach,			// object: scene, target: attached object
+			SceneDetach,			// object: scene, target: detached object
+			ObjectDelete,
+			Render,
+			ResolveFrameBuffer,		// target: destination frame buffer
+			ClearFrameBuffer,
+
+			Count
+		};
+
+		struct Record
+		{
+			Call call = Call::Render;
+			uint64_t timeDeltaUs = 0;
+			uint64_t object = 0;
+			uint64_t target = 0;
+			uint64_t key = 0;
+			uint64_t bytes = 0;
+		};
+
+		const char* CallName(Call call);
+
+		class Writer
+		{
+		public:
+			explicit Writer(std::ostream& out);
+
+			// object and target are handles, mapped to ids here
+			void Write(Call call, uint64_t timeUs, const void* object, const void* target, uint64_t key, uint64_t bytes);
+
+			// Writes a record with ids already assigned
+			void Write(const Record& record);
+
+			uint64_t GetRecordCount() const { return m_recordCount; }
+
+		private:
+			uint64_t GetId(const void* handle, bool created);
+			void WriteVarint(uint64_t value);
+
+		private:
+			std::ostream& m_out;
+			std::unordered_map<const void*, uint64_t> m_ids;
+			uint64_t m_lastId = 0;
+			uint64_t m_lastTimeUs = 0;
+			uint64_t m_recordCount = 0;
+		};
+
+		class Reader
+		{
+		public:
+			explicit Reader(std::istream& in);
+
+			// False for a stream which is not a call log or has an unsupported version
+			bool IsValid() const { return m_valid; }
+
+			// False at the end of the log; a truncated last record is dropped
+			bool Next(Record& record);
+
+		private:
+			bool ReadVarint(uint64_t& value);
+
+		private:
+			std::istream& m_in;
+			bool m_valid = false;
+		};
+	}
+
+	/** Records calls of all contexts into one log file.
+
+		Off by default. It is switched on by setting RPR_MAYA_CALL_LOG_OUTPUT environment variable
+		to the output file path before plugin load. While disabled Add() returns after a single
+		relaxed atomic load, so the hooks can stay in frw setters. */
+	class CallRecorder
+	{
+	public:
+		static CallRecorder& Instance();
+
+		static bool IsEnabled() { return Instance().m_enabled.load(std::memory_order_relaxed); }
+
+		static void Add(CallLog::Call call, const void* object, const void* target = nullptr, uint64_t key = 0, uint64_t bytes = 0)
+		{
+			if (IsEnabled())
+				Instance().AddRecord(call, object, target, key, bytes);
+		}
+
+		// Reads RPR_MAYA_CALL_LOG_OUTPUT and enables recording if it is set
+		void EnableFromEnvironment();
+
+		bool Enable(const std::string& outputPath);
+
+		// Stops recording and closes the log
+		void Disable();
+
+	private:
+		CallRecorder();
+		~CallRecorder();
+
+		CallRecorder(const CallRecorder&) = delete;
+		CallRecorder& operator=(const CallRecorder&) = delete;
+
+		void AddRecord(CallLog::Call call, const void* object, const void* target, uint64_t key, uint64_t bytes);
+
+	private:
+		std::atomic<bool> m_enabled;
+
+		std::mutex m_mutex;
+		std::ofstream m_file;
+		std::unique_ptr<CallLog::Writer> m_writer;
+		std::chrono::steady_clock::time_point m_startTime;
+	};
+}
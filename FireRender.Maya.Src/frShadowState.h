@@ -0,0 +1,201 @@
+/**********************************************************************
+Copyright 2020 Advanced Micro Devices, Inc
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+********************************************************************/
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace frw
+{
+	/** Last values sent to RPR through the setters of one object.
+		A setter asks Update() before calling RPR; identical values are not sent again,
+		so a repeated sync of an unchanged scene doesn't touch RPR objects (and doesn't reset
+		accumulation). Has to be cleared when the object gets another handle. Values set
+		past the wrapper must be dropped with Forget(). */
+	class ShadowState
+	{
+	public:
+		enum class Setter : uint32_t
+		{
+			MaterialInput,	// all input types share the slot of a key
+			ShapeVisibility,
+			ShapeVisibilityFlag,
+			ShapeTransform,
+			ShapeMotionTransform,
+			ShapeObjectId,
+			ShapeLightGroupId,
+			ShapeLinearMotion,
+			ShapeAngularMotion,
+			ShapeContourIgnore,
+			LightTransform,
+			LightGroupId,
+			CameraLinearMotion,
+			CameraAngularMotion,
+		};
+
+		// Distinguishes values of different types set to the same material input
+		enum ValueType : uint32_t
+		{
+			ValueFloat4,
+			ValueNode,
+			ValueUInt,
+			ValueBuffer,
+		};
+
+		// Largest value which can be cached, a 4x4 float matrix
+		static const uint32_t MaxValueSize = 64;
+
+		// Returns true if the value has to be sent: it differs from the last one or isn't cached
+		bool Update(Setter setter, uint32_t key, const void* value, uint32_t size, uint32_t valueType = 0)
+		{
+			if (!IsEnabled() || size > MaxValueSize)
+			{
+				Forget(setter, key);
+				CountForwarded();
+				return true;
+			}
+
+			uint64_t slot = Slot(setter, key);
+
+			for (Entry& entry : m_entries)
+			{
+				if (entry.slot != slot)
+					continue;
+
+				if (entry.valueType == valueType && entry.size == size && std::memcmp(entry.value, value, size) == 0)
+				{
+					GetCounters().skipped.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+
+				Store(entry, value, size, valueType);
+				CountForwarded();
+				return true;
+			}
+
+			m_entries.emplace_back();
+			m_entries.back().slot = slot;
+			Store(m_entries.back(), value, size, valueType);
+			CountForwarded();
+			return true;
+		}
+
+		template <class T>
+		bool Update(Setter setter, uint32_t key, const T& value, uint32_t valueType = 0)
+		{
+			return Update(setter, key, &value, (uint32_t) sizeof(T), valueType);
+		}
+
+		// The value is unknown now, e.g. the call failed or it was set without the wrapper
+		void Forget(Setter setter, uint32_t key)
+		{
+			uint64_t slot = Slot(setter, key);
+
+			for (size_t i = 0; i < m_entries.size(); i++)
+			{
+				if (m_entries[i].slot == slot)
+				{
+					m_entries[i] = m_entries.back();
+					m_entries.pop_back();
+					return;
+				}
+			}
+		}
+
+		// Drops the values of all keys of the setter
+		void Forget(Setter setter)
+		{
+			for (size_t i = 0; i < m_entries.size(); )
+			{
+				if ((m_entries[i].slot >> 32) == uint64_t(setter))
+				{
+					m_entries[i] = m_entries.back();
+					m_entries.pop_back();
+				}
+				else
+				{
+					i++;
+				}
+			}
+		}
+
+		void Clear()
+		{
+			m_entries.clear();
+		}
+
+		size_t Size() const { return m_entries.size(); }
+
+		// Process wide statistics
+		static uint64_t GetSkippedCount() { return GetCounters().skipped.load(std::memory_order_relaxed); }
+		static uint64_t GetForwardedCount() { return GetCounters().forwarded.load(std::memory_order_relaxed); }
+
+		static void ResetCounters()
+		{
+			GetCounters().skipped = 0;
+			GetCounters().forwarded = 0;
+		}
+
+		// Disabled state forwards every call, for comparisons
+		static bool IsEnabled() { return GetEnabledFlag().load(std::memory_order_relaxed); }
+		static void SetEnabled(bool enabled) { GetEnabledFlag() = enabled; }
+
+	private:
+		struct Entry
+		{
+			uint64_t slot;
+			uint32_t size;
+			uint32_t valueType;
+			unsigned char value[MaxValueSize];
+		};
+
+		struct Counters
+		{
+			std::atomic<uint64_t> skipped;
+			std::atomic<uint64_t> forwarded;
+		};
+
+		static uint64_t Slot(Setter setter, uint32_t key)
+		{
+			return (uint64_t(setter) << 32) | key;
+		}
+
+		static void Store(Entry& entry, const void* value, uint32_t size, uint32_t valueType)
+		{
+			entry.size = size;
+			entry.valueType = valueType;
+			std::memcpy(entry.value, value, size);
+		}
+
+		static void CountForwarded()
+		{
+			GetCounters().forwarded.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		static Counters& GetCounters()
+		{
+			static Counters counters = {};
+			return counters;
+		}
+
+		static std::atomic<bool>& GetEnabledFlag()
+		{
+			static std::atomic<bool> enabled(true);
+			return enabled;
+		}
+
+		std::vector<Entry> m_entries;
+	};
+}
@@ -147,6 +147,7 @@ namespace frw
 		if (shader)
 		{
 			AddReference(shader);
+			ShadowForget(ShadowState::Setter::MaterialInput, key);
 			shader.AttachToMaterialInput(Handle(), key);
 		}
 	}
@@ -39,6 +39,8 @@ limitations under the License.
 #include <maya/MColor.h>
 #include "FireRenderMath.h"
 #include "ProRenderGLTF.h"
+#include "frShadowState.h"
+#include "frCallRecorder.h"
 
 //#define FRW_LOGGING 1
 
@@ -74,6 +76,7 @@ limitations under the License.
 */
 
 #include <algorithm>
+#include <numeric>
 
 namespace frw
 {
@@ -459,6 +462,7 @@ namespace frw
 			DataPtr					context;
 			std::set<DataPtr>		references;	// list of references to objects used by this object
 			size_t					userData = 0;	// simple l-value for user reference
+			ShadowState				shadowState;	// last values sent through the wrapper setters
 
 			Data() {}
 			Data(void* h, const Context& context, bool destroyOnDelete = true)
@@ -472,8 +476,11 @@ namespace frw
 
 			void DeleteAndClear()
 			{
+				CallRecorder::Add(CallLog::Call::ObjectDelete, handle);
+
 				rpr_int res = rprObjectDelete(handle);
 				handle = nullptr;
+				shadowState.Clear();
 				checkStatus(res);
 			}
 
@@ -545,6 +552,34 @@ namespace frw
 		void RemoveAllReferences()
 		{
 			m->references.clear();
+
+			// released nodes may be deleted and their handles reused
+			m->shadowState.Clear();
+		}
+
+		// Returns false if the value equals the one last sent for this setter and key
+		template <class T>
+		bool ShadowUpdate(ShadowState::Setter setter, rpr_uint key, const T& value, rpr_uint valueType = 0) const
+		{
+			return m->shadowState.Update(setter, key, value, valueType);
+		}
+
+		void ShadowForget(ShadowState::Setter setter, rpr_uint key) const
+		{
+			m->shadowState.Forget(setter, key);
+		}
+
+		void ShadowForgetAll(ShadowState::Setter setter) const
+		{
+			m->shadowState.Forget(setter);
+		}
+
+		// Failed call leaves the RPR value unknown
+		rpr_int ShadowResult(rpr_int res, ShadowState::Setter setter, rpr_uint key = 0) const
+		{
+			if (res != RPR_SUCCESS)
+				ShadowForget(setter, key);
+			return res;
 		}
 
 		long ReferenceCount() const { return (long)m->references.size(); }
@@ -930,9 +965,24 @@ namespace frw
 		void SetVolumeShader( const Shader& shader );
 		Shader GetVolumeShader() const;
 
+		rpr_int SetVisibilityFlag(rpr_shape_info flag, bool visible)
+		{
+			if (!ShadowUpdate(ShadowState::Setter::ShapeVisibilityFlag, flag, visible))
+				return RPR_SUCCESS;
+
+			CallRecorder::Add(CallLog::Call::SetParameter, Handle(), nullptr, flag, sizeof(rpr_bool));
+			return ShadowResult(rprShapeSetVisibilityFlag(Handle(), flag, visible), ShadowState::Setter::ShapeVisibilityFlag, flag);
+		}
+
 		void SetVisibility(bool visible)
 		{
-			auto res = rprShapeSetVisibility(Handle(), visible);
+			if (!ShadowUpdate(ShadowState::Setter::ShapeVisibility, 0, visible))
+				return;
+
+			// overrides the visibility flags
+			ShadowForgetAll(ShadowState::Setter::ShapeVisibilityFlag);
+
+			auto res = ShadowResult(rprShapeSetVisibility(Handle(), visible), ShadowState::Setter::ShapeVisibility);
 
 			if (res == RPR_ERROR_UNSUPPORTED)
 			{
@@ -945,7 +995,7 @@ namespace frw
 		}
 		void SetPrimaryVisibility(bool visible)
 		{
-			auto res = rprShapeSetVisibilityFlag(Handle(), RPR_SHAPE_VISIBILITY_PRIMARY_ONLY_FLAG, visible);
+			auto res = SetVisibilityFlag(RPR_SHAPE_VISIBILITY_PRIMARY_ONLY_FLAG, visible);
 
 			if (res == RPR_ERROR_UNSUPPORTED)
 			{
@@ -958,7 +1008,7 @@ namespace frw
 		}
 		void SetReflectionVisibility(bool visible)
 		{
-			auto res = rprShapeSetVisibilityFlag(Handle(), RPR_SHAPE_VISIBILITY_REFLECTION, visible);
+			auto res = SetVisibilityFlag(RPR_SHAPE_VISIBILITY_REFLECTION, visible);
 			if (res == RPR_ERROR_UNSUPPORTED)
 			{
 				return;
@@ -968,7 +1018,7 @@ namespace frw
 				checkStatus(res);
 			}
 
-			res = rprShapeSetVisibilityFlag(Handle(), RPR_SHAPE_VISIBILITY_GLOSSY_REFLECTION, visible);
+			res = SetVisibilityFlag(RPR_SHAPE_VISIBILITY_GLOSSY_REFLECTION, visible);
 
 			if (res == RPR_ERROR_UNSUPPORTED)
 			{
@@ -982,7 +1032,7 @@ namespace frw
 
 		void setRefractionVisibility(bool visible)
 		{
-			auto res = rprShapeSetVisibilityFlag(Handle(), RPR_SHAPE_VISIBILITY_REFRACTION, visible);
+			auto res = SetVisibilityFlag(RPR_SHAPE_VISIBILITY_REFRACTION, visible);
 			if (res == RPR_ERROR_UNSUPPORTED)
 			{
 				return;
@@ -992,7 +1042,7 @@ namespace frw
 				checkStatus(res);
 			}
 
-			res = rprShapeSetVisibilityFlag(Handle(), RPR_SHAPE_VISIBILITY_GLOSSY_REFRACTION, visible);
+			res = SetVisibilityFlag(RPR_SHAPE_VISIBILITY_GLOSSY_REFRACTION, visible);
 			if (res == RPR_ERROR_UNSUPPORTED)
 			{
 				return;
@@ -1005,7 +1055,7 @@ namespace frw
 
 		void SetLightShapeVisibilityEx(bool visible)
 		{
-			auto res = rprShapeSetVisibilityFlag(Handle(), RPR_SHAPE_VISIBILITY_LIGHT, visible);
+			auto res = SetVisibilityFlag(RPR_SHAPE_VISIBILITY_LIGHT, visible);
 			if (res == RPR_ERROR_UNSUPPORTED)
 			{
 				return;
@@ -1016,35 +1066,64 @@ namespace frw
 
 		void SetLightGroupId(rpr_uint id)
 		{
-			rpr_status res = rprShapeSetLightGroupID(Handle(), id);
+			if (!ShadowUpdate(ShadowState::Setter::ShapeLightGroupId, 0, id))
+				return;
+
+			CallRecorder::Add(CallLog::Call::SetParameter, Handle(), nullptr, RPR_SHAPE_LIGHTGROUP_ID, sizeof(rpr_uint));
+			rpr_status res = ShadowResult(rprShapeSetLightGroupID(Handle(), id), ShadowState::Setter::ShapeLightGroupId);
 			checkStatus(res);
 		}
 
 		Shape CreateInstance(Context context) const;
 		void SetTransform(const float* tm, bool transpose = false)
 		{
-			auto res = rprShapeSetTransform(Handle(), transpose, tm);
+			std::array<float, 16> matrix;
+			std::copy(tm, tm + 16, matrix.begin());
+
+			// both layouts share the value, so the key tells which one is cached
+			ShadowForget(ShadowState::Setter::ShapeTransform, !transpose);
+			if (!ShadowUpdate(ShadowState::Setter::ShapeTransform, transpose, matrix))
+				return;
+
+			CallRecorder::Add(CallLog::Call::SetTransform, Handle(), nullptr, 0, sizeof(matrix));
+			auto res = ShadowResult(rprShapeSetTransform(Handle(), transpose, tm), ShadowState::Setter::ShapeTransform, transpose);
 			checkStatus(res);
 		}
 
 		void SetMotionTransform(const float* tm, bool transpose = false)
 		{
-			rpr_status res = rprShapeSetMotionTransform(Handle(), false, tm, 1); // matrix at time=1
+			std::array<float, 16> matrix;
+			std::copy(tm, tm + 16, matrix.begin());
+
+			if (!ShadowUpdate(ShadowState::Setter::ShapeMotionTransform, 0, matrix))
+				return;
+
+			CallRecorder::Add(CallLog::Call::SetParameter, Handle(), nullptr, RPR_SHAPE_MOTION_TRANSFORMS, sizeof(matrix));
+			rpr_status res = ShadowResult(rprShapeSetMotionTransform(Handle(), false, tm, 1), ShadowState::Setter::ShapeMotionTransform); // matrix at time=1
 			checkStatus(res);
 
-			res = rprShapeSetMotionTransformCount(Handle(), 1);
+			CallRecorder::Add(CallLog::Call::SetParameter, Handle(), nullptr, RPR_SHAPE_MOTION_TRANSFORMS_COUNT, sizeof(rpr_uint));
+			res = ShadowResult(rprShapeSetMotionTransformCount(Handle(), 1), ShadowState::Setter::ShapeMotionTransform);
 			checkStatus(res);
 		}
 
 		void SetObjectId(rpr_uint id)
 		{
-			auto res = rprShapeSetObjectID(Handle(), id);
+			if (!ShadowUpdate(ShadowState::Setter::ShapeObjectId, 0, id))
+				return;
+
+			CallRecorder::Add(CallLog::Call::SetParameter, Handle(), nullptr, RPR_SHAPE_OBJECT_ID, sizeof(rpr_uint));
+			auto res = ShadowResult(rprShapeSetObjectID(Handle(), id), ShadowState::Setter::ShapeObjectId);
 			checkStatus(res);
 		}
 
 		void SetLinearMotion(float x, float y, float z)
 		{
-			auto res = rprShapeSetLinearMotion(Handle(), x, y, z);
+			if (!ShadowUpdate(ShadowState::Setter::ShapeLinearMotion, 0, std::array<float, 3>{ x, y, z }))
+				return;
+
+			CallRecorder::Add(CallLog::Call::SetParameter, Handle(), nullptr, RPR_SHAPE_LINEAR_MOTION, 3 * sizeof(rpr_float));
+			auto res = ShadowResult(rprShapeSetLinearMotion(Handle(), x, y, z), ShadowState::Setter::ShapeLinearMotion);
 
 			if (res == RPR_ERROR_UNSUPPORTED)
 			{
@@ -1058,7 +1137,11 @@ namespace frw
 
 		void SetAngularMotion(float x, float y, float z, float w)
 		{
-			auto res = rprShapeSetAngularMotion(Handle(), x, y, z, w);
+			if (!ShadowUpdate(ShadowState::Setter::ShapeAngularMotion, 0, std::array<float, 4>{ x, y, z, w }))
+				return;
+
+			CallRecorder::Add(CallLog::Call::SetParameter, Handle(), nullptr, RPR_SHAPE_ANGULAR_MOTION, 4 * sizeof(rpr_float));
+			auto res = ShadowResult(rprShapeSetAngularMotion(Handle(), x, y, z, w), ShadowState::Setter::ShapeAngularMotion);
 
 			if (res == RPR_ERROR_UNSUPPORTED)
 			{
@@ -1117,7 +1200,7 @@ namespace frw
 #endif
 		void SetShadowFlag(bool castsShadows)
 		{
-			auto res = rprShapeSetVisibilityFlag(Handle(), RPR_SHAPE_VISIBILITY_SHADOW, castsShadows);
+			auto res = SetVisibilityFlag(RPR_SHAPE_VISIBILITY_SHADOW, castsShadows);
 
 			if (res == RPR_ERROR_UNSUPPORTED)
 			{
@@ -1131,7 +1214,11 @@ namespace frw
 
 		void SetContourVisibilityFlag(bool isContourVisible)
 		{
-			auto res = rprShapeSetContourIgnore(Handle(), !isContourVisible);
+			if (!ShadowUpdate(ShadowState::Setter::ShapeContourIgnore, 0, isContourVisible))
+				return;
+
+			CallRecorder::Add(CallLog::Call::SetParameter, Handle(), nullptr, RPR_SHAPE_CONTOUR_IGNORE, sizeof(rpr_bool));
+			auto res = ShadowResult(rprShapeSetContourIgnore(Handle(), !isContourVisible), ShadowState::Setter::ShapeContourIgnore);
 
 			if (res == RPR_ERROR_UNSUPPORTED)
 			{
@@ -1217,13 +1304,24 @@ namespace frw
 		Light(rpr_light h, const Context &context, Data* data = nullptr) : Object(h, context, true, data ? data : new Data()) {}
 		void SetTransform(const float* tm, bool transpose = false)
 		{
-			auto res = rprLightSetTransform(Handle(), transpose, tm);
+			std::array<float, 16> matrix;
+			std::copy(tm, tm + 16, matrix.begin());
+
+			ShadowForget(ShadowState::Setter::LightTransform, !transpose);
+			if (!ShadowUpdate(ShadowState::Setter::LightTransform, transpose, matrix))
+				return;
+
+			CallRecorder::Add(CallLog::Call::SetTransform, Handle(), nullptr, 0, sizeof(matrix));
+			auto res = ShadowResult(rprLightSetTransform(Handle(), transpose, tm), ShadowState::Setter::LightTransform, transpose);
 			checkStatus(res);
 		}
 
 		void SetLightGroupId(rpr_uint id)
 		{
-			rpr_status res = rprLightSetGroupId(Handle(), id);
+			if (!ShadowUpdate(ShadowState::Setter::LightGroupId, 0, id))
+				return;
+
+			rpr_status res = ShadowResult(rprLightSetGroupId(Handle(), id), ShadowState::Setter::LightGroupId);
 			checkStatus(res);
 		}
 
@@ -1603,7 +1701,10 @@ namespace frw
 
 		void SetLinearMotion(float x, float y, float z)
 		{
-			auto res = rprCameraSetLinearMotion(Handle(), x, y, z);
+			if (!ShadowUpdate(ShadowState::Setter::CameraLinearMotion, 0, std::array<float, 3>{ x, y, z }))
+				return;
+
+			auto res = ShadowResult(rprCameraSetLinearMotion(Handle(), x, y, z), ShadowState::Setter::CameraLinearMotion);
 
 			if (res == RPR_ERROR_UNSUPPORTED)
 			{
@@ -1617,7 +1718,10 @@ namespace frw
 
 		void SetAngularMotion(float x, float y, float z, float w)
 		{
-			auto res = rprCameraSetAngularMotion(Handle(), x, y, z, w);
+			if (!ShadowUpdate(ShadowState::Setter::CameraAngularMotion, 0, std::array<float, 4>{ x, y, z, w }))
+				return;
+
+			auto res = ShadowResult(rprCameraSetAngularMotion(Handle(), x, y, z, w), ShadowState::Setter::CameraAngularMotion);
 
 			if (res == RPR_ERROR_UNSUPPORTED)
 			{
@@ -1683,6 +1787,7 @@ namespace frw
 		void Attach(Shape v)
 		{
 			AddReference(v);
+			CallRecorder::Add(CallLog::Call::SceneAttach, Handle(), v.Handle());
 			auto res = rprSceneAttachShape(Handle(), v.Handle());
 			checkStatus(res);
 
@@ -1696,6 +1801,7 @@ namespace frw
 		void Attach(Light v)
 		{
 			AddReference(v);
+			CallRecorder::Add(CallLog::Call::SceneAttach, Handle(), v.Handle());
 			auto res = rprSceneAttachLight(Handle(), v.Handle());
 			checkStatus(res);
 
@@ -1704,6 +1810,7 @@ namespace frw
 		void Attach(Volume v)
 		{
 			AddReference(v);
+			CallRecorder::Add(CallLog::Call::SceneAttach, Handle(), v.Handle());
 			auto res = rprSceneAttachHeteroVolume(Handle(), v.Handle());
 			checkStatus(res);
 			// need to create fake shape for this volume that it needs to be attached to exist
@@ -1713,12 +1820,14 @@ namespace frw
 		void Attach(Curve crv)
 		{
 			AddReference(crv);
+			CallRecorder::Add(CallLog::Call::SceneAttach, Handle(), crv.Handle());
 			auto res = rprSceneAttachCurve(Handle(), crv.Handle());
 			checkStatus(res);
 		}
 		void Detach(Shape v)
 		{
 			RemoveReference(v);
+			CallRecorder::Add(CallLog::Call::SceneDetach, Handle(), v.Handle());
 			auto res = rprSceneDetachShape(Handle(), v.Handle());
 			checkStatus(res);
 
@@ -1728,12 +1837,14 @@ namespace frw
 		void Detach(Volume v)
 		{
 			RemoveReference(v);
+			CallRecorder::Add(CallLog::Call::SceneDetach, Handle(), v.Handle());
 			auto res = rprSceneDetachHeteroVolume(Handle(), v.Handle());
 			checkStatus(res);
 		}
 		void Detach(Light v)
 		{
 			RemoveReference(v);
+			CallRecorder::Add(CallLog::Call::SceneDetach, Handle(), v.Handle());
 			auto res = rprSceneDetachLight(Handle(), v.Handle());
 			checkStatus(res);
 
@@ -1742,6 +1853,7 @@ namespace frw
 		void Detach(Curve crv)
 		{
 			RemoveReference(crv);
+			CallRecorder::Add(CallLog::Call::SceneDetach, Handle(), crv.Handle());
 			auto res = rprSceneDetachCurve(Handle(), crv.Handle());
 			checkStatus(res);
 		}
@@ -1800,6 +1912,7 @@ namespace frw
 
 			for (auto& it : items)
 			{
+				CallRecorder::Add(CallLog::Call::SceneDetach, Handle(), it);
 				res = rprSceneDetachShape(Handle(), it);
 				checkStatus(res);
 				RemoveReference(it);
@@ -1851,6 +1964,7 @@ namespace frw
 			checkStatus(res);
 			for (auto& it : items)
 			{
+				CallRecorder::Add(CallLog::Call::SceneDetach, Handle(), it);
 				res = rprSceneDetachLight(Handle(), it);
 				checkStatus(res);
 				RemoveReference(it);
@@ -2044,6 +2158,7 @@ namespace frw
 			rpr_light h;
 			auto status = rprContextCreatePointLight(Handle(), &h);
 			checkStatusThrow(status, "Unable to create point light");
+			CallRecorder::Add(CallLog::Call::CreateLight, Handle(), h, RPR_LIGHT_TYPE_POINT);
 
 			return PointLight(h, *this);
 		}
@@ -2054,6 +2169,7 @@ namespace frw
 			rpr_light h;
 			auto status = rprContextCreateSphereLight(Handle(), &h);
 			checkStatusThrow(status, "Unable to create sphere light");
+			CallRecorder::Add(CallLog::Call::CreateLight, Handle(), h, RPR_LIGHT_TYPE_SPHERE);
 
 			return SphereLight(h, *this);
 		}
@@ -2064,6 +2180,7 @@ namespace frw
 			rpr_light h;
 			auto status = rprContextCreateSpotLight(Handle(), &h);
 			checkStatusThrow(status, "Unable to create spot light");
+			CallRecorder::Add(CallLog::Call::CreateLight, Handle(), h, RPR_LIGHT_TYPE_SPOT);
 
 			return SpotLight(h, *this);
 		}
@@ -2074,6 +2191,7 @@ namespace frw
 			rpr_light h;
 			auto status = rprContextCreateDiskLight(Handle(), &h);
 			checkStatusThrow(status, "Unable to create disk light");
+			CallRecorder::Add(CallLog::Call::CreateLight, Handle(), h, RPR_LIGHT_TYPE_DISK);
 
 			return DiskLight(h, *this);
 		}
@@ -2084,6 +2202,7 @@ namespace frw
 			rpr_light h;
 			auto status = rprContextCreateEnvironmentLight(Handle(), &h);
 			checkStatusThrow(status, "Unable to create environment light");
+			CallRecorder::Add(CallLog::Call::CreateLight, Handle(), h, RPR_LIGHT_TYPE_ENVIRONMENT);
 
 			return EnvironmentLight(h, *this);
 		}
@@ -2094,6 +2213,7 @@ namespace frw
 			rpr_light h;
 			auto status = rprContextCreateDirectionalLight(Handle(), &h);
 			checkStatusThrow(status, "Unable to create directional light");
+			CallRecorder::Add(CallLog::Call::CreateLight, Handle(), h, RPR_LIGHT_TYPE_DIRECTIONAL);
 
 			return DirectionalLight(h, *this);
 		}
@@ -2104,6 +2224,7 @@ namespace frw
 			rpr_light h;
 			auto status = rprContextCreateIESLight(Handle(), &h);
 			checkStatusThrow(status, "Unable to create IES light");
+			CallRecorder::Add(CallLog::Call::CreateLight, Handle(), h, RPR_LIGHT_TYPE_IES);
 
 			return IESLight(h, *this);
 		}
@@ -2372,6 +2493,7 @@ namespace frw
 
 		void Render()
 		{
+			CallRecorder::Add(CallLog::Call::Render, Handle());
 			auto status = rprContextRender(Handle());
 
 			if (RPR_ERROR_ABORTED == status)
@@ -2403,6 +2525,7 @@ namespace frw
 
 		void RenderTile(int rxmin, int rxmax, int rymin, int rymax)
 		{
+			CallRecorder::Add(CallLog::Call::Render, Handle());
 			auto status = rprContextRenderTile(Handle(), rxmin, rxmax, rymin, rymax);
 
 			if (RPR_ERROR_ABORTED == status)
@@ -2513,6 +2636,8 @@ namespace frw
 		rpr_int SetMap(Image v)
 		{
 			AddReference(v);
+			ShadowForget(ShadowState::Setter::MaterialInput, RPR_MATERIAL_INPUT_DATA);
+			CallRecorder::Add(CallLog::Call::SetMaterialNodeInput, Handle(), v.Handle(), RPR_MATERIAL_INPUT_DATA, sizeof(rpr_image));
 			return rprMaterialNodeSetInputImageDataByKey(Handle(), RPR_MATERIAL_INPUT_DATA, v.Handle());
 		}
 	};
@@ -2581,6 +2706,8 @@ namespace frw
 			{
 				Node n = v.GetNode();
 				AddReference(n);
+				ShadowForget(ShadowState::Setter::MaterialInput, RPR_MATERIAL_INPUT_COLOR);
+				CallRecorder::Add(CallLog::Call::SetMaterialNodeInput, Handle(), n.Handle(), RPR_MATERIAL_INPUT_COLOR, sizeof(rpr_material_node));
 				auto res = rprMaterialNodeSetInputNByKey(Handle(), RPR_MATERIAL_INPUT_COLOR, n.Handle());
 				checkStatus(res);
 			}
@@ -2626,6 +2753,8 @@ namespace frw
 			{
 				Node n = v.GetNode();
 				AddReference(n);
+				ShadowForget(ShadowState::Setter::MaterialInput, RPR_MATERIAL_INPUT_COLOR);
+				CallRecorder::Add(CallLog::Call::SetMaterialNodeInput, Handle(), n.Handle(), RPR_MATERIAL_INPUT_COLOR, sizeof(rpr_material_node));
 				auto res = rprMaterialNodeSetInputNByKey(Handle(), RPR_MATERIAL_INPUT_COLOR, n.Handle());
 				checkStatus(res);
 			}
@@ -2656,6 +2785,10 @@ namespace frw
 				checkStatus(res);
 			}
 
+			// unsupported node types leave no node behind, a replay would reference an unknown id
+			if (res == RPR_SUCCESS)
+				CallRecorder::Add(CallLog::Call::CreateMaterialNode, Handle(), node, type);
+
 			return node;
 		}
 
@@ -3241,6 +3374,7 @@ namespace frw
 			rpr_framebuffer_desc desc = { rpr_uint(width), rpr_uint(height) };
 			auto res = rprContextCreateFrameBuffer(context.Handle(), format, &desc, &h);
 			checkStatusThrow(res);
+			CallRecorder::Add(CallLog::Call::CreateFrameBuffer, context.Handle(), h, 0, uint64_t(width) * height * format.num_components * sizeof(float));
 			m->Attach(h);
 		}
 
@@ -3248,12 +3382,14 @@ namespace frw
 
 		void Resolve(FrameBuffer dest, bool normalizeOnly)
 		{
+			CallRecorder::Add(CallLog::Call::ResolveFrameBuffer, Handle(), dest.Handle());
 			auto status = rprContextResolveFrameBuffer(GetContext().Handle(), Handle(), dest.Handle(), normalizeOnly);
 			checkStatusThrow(status, "Unable to resolve frame buffer");
 		}
 
 		void Clear()
 		{
+			CallRecorder::Add(CallLog::Call::ClearFrameBuffer, Handle());
 			auto status = rprFrameBufferClear(Handle());
 			checkStatusThrow(status, "Unable to clear frame buffer");
 		}
@@ -3399,6 +3535,7 @@ namespace frw
 			if (Handle())
 			{
 				FRW_PRINT_DEBUG("\tShape.AttachMaterial: d: 0x%016llX - numAttachedShapes: %d shape=0x%016llX x_material=0x%016llX", &d, d.numAttachedShapes, shape.Handle(), Handle());
+				CallRecorder::Add(CallLog::Call::SetShapeMaterial, shape.Handle(), Handle());
 				res = rprShapeSetMaterial(shape.Handle(), Handle());
 				checkStatus(res);
 
@@ -3426,6 +3563,7 @@ namespace frw
 			FRW_PRINT_DEBUG("\tShape.DetachMaterial: d: 0x%016llX - numAttachedShapes: %d shape=0x%016llX, material=0x%016llX", &d, d.numAttachedShapes, shape.Handle(), Handle());
 			if (Handle())
 			{
+				CallRecorder::Add(CallLog::Call::SetShapeMaterial, shape.Handle());
 				rpr_int res = rprShapeSetMaterial(shape.Handle(), nullptr);
 				checkStatus(res);
 
@@ -3451,6 +3589,7 @@ namespace frw
 				return;
 
 			FRW_PRINT_DEBUG("\tShape.AttachMaterial: d: 0x%016llX - numAttachedShapes: %d shape=0x%016llX x_material=0x%016llX", &d, d.numAttachedShapes, shape.Handle(), Handle());
+			CallRecorder::Add(CallLog::Call::SetShapeMaterial, shape.Handle(), Handle(), 0, face_ids.size() * sizeof(rpr_int));
 			res = rprShapeSetMaterialFaces(shape.Handle(), Handle(), face_ids.data(), face_ids.size());
 			checkStatus(res);
 
@@ -3515,7 +3654,11 @@ namespace frw
 		void xSetParameterN(rpr_material_node_input parameter, rpr_material_node node)
 		{
 			const Data& d = data();
-			rpr_int res = rprMaterialNodeSetInputNByKey(Handle(), parameter, node);
+			if (!ShadowUpdate(ShadowState::Setter::MaterialInput, parameter, node, ShadowState::ValueNode))
+				return;
+
+			CallRecorder::Add(CallLog::Call::SetMaterialNodeInput, Handle(), node, parameter, sizeof(node));
+			rpr_int res = ShadowResult(rprMaterialNodeSetInputNByKey(Handle(), parameter, node), ShadowState::Setter::MaterialInput, parameter);
 
 			if (res == RPR_ERROR_UNSUPPORTED ||
 				res == RPR_ERROR_INVALID_PARAMETER)
@@ -3531,7 +3674,11 @@ namespace frw
 		void xSetParameterU(rpr_material_node_input parameter, rpr_uint value)
 		{
 			const Data& d = data();
-			rpr_int res = rprMaterialNodeSetInputUByKey(Handle(), parameter, value);
+			if (!ShadowUpdate(ShadowState::Setter::MaterialInput, parameter, value, ShadowState::ValueUInt))
+				return;
+
+			CallRecorder::Add(CallLog::Call::SetMaterialNodeInput, Handle(), nullptr, parameter, sizeof(value));
+			rpr_int res = ShadowResult(rprMaterialNodeSetInputUByKey(Handle(), parameter, value), ShadowState::Setter::MaterialInput, parameter);
 			if (res == RPR_ERROR_UNSUPPORTED ||
 				res == RPR_ERROR_INVALID_PARAMETER)
 			{
@@ -3547,7 +3694,11 @@ namespace frw
 		void xSetParameterF(rpr_material_node_input parameter, rpr_float x, rpr_float y, rpr_float z, rpr_float w)
 		{
 			const Data& d = data();
-			rpr_int res = rprMaterialNodeSetInputFByKey(Handle(), parameter, x, y, z, w);
+			if (!ShadowUpdate(ShadowState::Setter::MaterialInput, parameter, std::array<rpr_float, 4>{ x, y, z, w }, ShadowState::ValueFloat4))
+				return;
+
+			CallRecorder::Add(CallLog::Call::SetMaterialNodeInput, Handle(), nullptr, parameter, 4 * sizeof(rpr_float));
+			rpr_int res = ShadowResult(rprMaterialNodeSetInputFByKey(Handle(), parameter, x, y, z, w), ShadowState::Setter::MaterialInput, parameter);
 			if (res == RPR_ERROR_UNSUPPORTED ||
 				res == RPR_ERROR_INVALID_PARAMETER)
 			{
@@ -3650,6 +3801,7 @@ namespace frw
 
 	inline void Object::Data::Init(void* h, const Context& c, bool destroy)
 	{
+		shadowState.Clear();
 		handle = h;
 		context = c.m;
 		destroyOnDelete = destroy;
@@ -3701,6 +3853,7 @@ namespace frw
 		{
 			destroyOnDelete = destroy;
 			handle = h;
+			shadowState.Clear();
 			allocatedObjects++;
 
 #if FRW_LOGGING
@@ -3727,13 +3880,26 @@ namespace frw
 		switch (v.type)
 		{
 			case Value::FLOAT:
-				return RPR_SUCCESS == rprMaterialNodeSetInputFByKey(Handle(), key, v.x, v.y, v.z, v.w);
+			{
+				if (!ShadowUpdate(ShadowState::Setter::MaterialInput, key, std::array<rpr_float, 4>{ v.x, v.y, v.z, v.w }, ShadowState::ValueFloat4))
+					return true;
+
+				CallRecorder::Add(CallLog::Call::SetMaterialNodeInput, Handle(), nullptr, key, 4 * sizeof(rpr_float));
+				rpr_int res = rprMaterialNodeSetInputFByKey(Handle(), key, v.x, v.y, v.z, v.w);
+				return RPR_SUCCESS == ShadowResult(res, ShadowState::Setter::MaterialInput, key);
+			}
 			case Value::NODE:
 			{
 				if (!v.node)	// in theory we should now allow this, as setting a NULL input is legal (as of FRSDK 1.87)
 					return false;
 				AddReference(v.node);
-				return RPR_SUCCESS == rprMaterialNodeSetInputNByKey(Handle(), key, v.node.Handle());	// should be ok to set null here now
+
+				if (!ShadowUpdate(ShadowState::Setter::MaterialInput, key, v.node.Handle(), ShadowState::ValueNode))
+					return true;
+
+				CallRecorder::Add(CallLog::Call::SetMaterialNodeInput, Handle(), v.node.Handle(), key, sizeof(rpr_material_node));
+				rpr_int res = rprMaterialNodeSetInputNByKey(Handle(), key, v.node.Handle());	// should be ok to set null here now
+				return RPR_SUCCESS == ShadowResult(res, ShadowState::Setter::MaterialInput, key);
 			}
 		}
 		assert(!"bad type");
@@ -3743,12 +3909,20 @@ namespace frw
 
 	inline bool Node::SetValueInt(rpr_material_node_input key, int v)
 	{
-		return RPR_SUCCESS == rprMaterialNodeSetInputUByKey(Handle(), key, v);
+		if (!ShadowUpdate(ShadowState::Setter::MaterialInput, key, rpr_uint(v), ShadowState::ValueUInt))
+			return true;
+
+		CallRecorder::Add(CallLog::Call::SetMaterialNodeInput, Handle(), nullptr, key, sizeof(rpr_uint));
+		return RPR_SUCCESS == ShadowResult(rprMaterialNodeSetInputUByKey(Handle(), key, v), ShadowState::Setter::MaterialInput, key);
 	}
 
 	inline bool Node::SetValueBuffer(rpr_material_node_input key, rpr_buffer buffer)
 	{
-		return RPR_SUCCESS == rprMaterialNodeSetInputBufferDataByKey(Handle(), key, buffer);
+		if (!ShadowUpdate(ShadowState::Setter::MaterialInput, key, buffer, ShadowState::ValueBuffer))
+			return true;
+
+		CallRecorder::Add(CallLog::Call::SetMaterialNodeInput, Handle(), buffer, key, sizeof(rpr_buffer));
+		return RPR_SUCCESS == ShadowResult(rprMaterialNodeSetInputBufferDataByKey(Handle(), key, buffer), ShadowState::Setter::MaterialInput, key);
 	}
 
 	inline MaterialSystem Node::GetMaterialSystem() const
@@ -4028,6 +4202,23 @@ namespace frw
 			m->Attach(h);
 	}
 
+	// Size of the pixel data read by rprContextCreateImage
+	inline uint64_t GetImageDataSize(const rpr_image_format& format, const rpr_image_desc& desc)
+	{
+		uint64_t depth = std::max<rpr_uint>(desc.image_depth, 1);
+
+		if (desc.image_row_pitch)
+			return uint64_t(desc.image_row_pitch) * desc.image_height * depth;
+
+		uint64_t componentSize = 4;
+		if (format.type == RPR_COMPONENT_TYPE_UINT8)
+			componentSize = 1;
+		else if (format.type == RPR_COMPONENT_TYPE_FLOAT16)
+			componentSize = 2;
+
+		return uint64_t(desc.image_width) * desc.image_height * depth * format.num_components * componentSize;
+	}
+
 	inline Image::Image(Context context, float r, float g, float b)
 		: Object(nullptr, context, true, new Data())
 	{
@@ -4041,6 +4232,7 @@ namespace frw
 		auto res = rprContextCreateImage(context.Handle(), format, &image_desc, data, &h);
 		if (checkStatus(res, "Unable to create image"))
 		{
+			CallRecorder::Add(CallLog::Call::CreateImage, context.Handle(), h, 0, sizeof(data));
 			m->Attach(h);
 		}
 	}
@@ -4053,6 +4245,7 @@ namespace frw
 		auto res = rprContextCreateImage(context.Handle(), format, &image_desc, data, &h);
 		if (checkStatus(res, "Unable to create image"))
 		{
+			CallRecorder::Add(CallLog::Call::CreateImage, context.Handle(), h, 0, data ? GetImageDataSize(format, image_desc) : 0);
 			m->Attach(h);
 		}
 	}
@@ -4065,6 +4258,7 @@ namespace frw
 		auto res = rprContextCreateImage(context.Handle(), format, nullptr, nullptr, &h);
 		if (checkStatus(res, "Unable to create image"))
 		{
+			CallRecorder::Add(CallLog::Call::CreateImage, context.Handle(), h);
 			m->Attach(h);
 		}
 	}
@@ -4090,7 +4284,11 @@ namespace frw
 		if (ErrorUnsupportedImageFormat != res) {
 			//^ we don't want to give Error messages to the user about unsupported image formats, since we support them through the plugin.
 			if (checkStatus(res, "Unable to load: " + MString(filename)))
+			{
+				// pixels are read by RPR, payload is unknown here
+				CallRecorder::Add(CallLog::Call::CreateImage, context.Handle(), h);
 				m->Attach(h);
+			}
 		}
 	}
 
@@ -4180,6 +4378,15 @@ namespace frw
 
 		checkStatusThrow(status, "Unable to create mesh");
 
+		if (CallRecorder::IsEnabled())
+		{
+			size_t indexCount = std::accumulate(num_face_vertices, num_face_vertices + num_faces, size_t(0));
+			uint64_t bytes = num_vertices * vertex_stride + num_normals * normal_stride + num_texcoords * texcoord_stride +
+				indexCount * (vidx_stride + (normal_indices ? nidx_stride : 0) + (texcoord_indices ? tidx_stride : 0)) + num_faces * sizeof(rpr_int);
+
+			CallRecorder::Add(CallLog::Call::CreateMesh, Handle(), shape, 0, bytes);
+		}
+
 		Shape shapeObj(shape, *this);
 
 		shapeObj.SetUVCoordinatesSetFlag(texcoords != nullptr && num_texcoords > 0);
@@ -4216,6 +4423,18 @@ namespace frw
 
 		checkStatusThrow(status, ("Unable to create mesh: " + optionalMeshName).c_str());
 
+		if (CallRecorder::IsEnabled())
+		{
+			size_t indexCount = std::accumulate(num_face_vertices, num_face_vertices + num_faces, size_t(0));
+			uint64_t bytes = num_vertices * vertex_stride + num_normals * normal_stride + num_perVertexFlags * perVertexFlag_stride +
+				indexCount * (vidx_stride + (normal_indices ? nidx_stride : 0)) + num_faces * sizeof(rpr_int);
+
+			for (rpr_int layer = 0; layer < numberOfTexCoordLayers; layer++)
+				bytes += num_texcoords[layer] * texcoord_stride[layer] + indexCount * tidx_stride[layer];
+
+			CallRecorder::Add(CallLog::Call::CreateMesh, Handle(), shape, 0, bytes);
+		}
+
 		Shape shapeObj (shape, *this);
 		shapeObj.SetUVCoordinatesSetFlag(numberOfTexCoordLayers > 0);
 
@@ -93,6 +93,9 @@ limitations under the License.
 
 #include "GLTFTranslator.h"
 #include "StartupContextChecker.h"
+#include "Context/ContextWorkTracer.h"
+#include "Translators/TessellationCache.h"
+#include "frCallRecorder.h"
 
 #ifdef _WIN32
 #pragma warning( disable : 4091 )
@@ -568,6 +571,9 @@ MStatus initializePlugin(MObject obj)
 	FireMaya::gMainThreadId = std::this_thread::get_id();
 	FireRenderThread::RunTheThread(true);
 
+	ContextWorkTracer::Instance().EnableFromEnvironment();
+	frw::CallRecorder::Instance().EnableFromEnvironment();
+
 #ifdef OSMac_
 	auto tracePath = std::getenv("FR_TRACE_OUTPUT");
 	if (tracePath)
@@ -987,8 +993,18 @@ MStatus uninitializePlugin(MObject obj)
 
 	FireRenderViewportManager::instance().clear();
 	FireRenderThread::RunTheThread(false);
+
+	// cached meshes hold Maya data, release it while Maya is still alive
+	TessellationCache::Instance().Clear();
 	std::this_thread::yield();
 
+	if (ContextWorkTracer::IsEnabled())
+	{
+		ContextWorkTracer::Instance().Flush();
+	}
+
+	frw::CallRecorder::Instance().Disable();
+
 	CHECK_MSTATUS(plugin.deregisterCommand("fireRender"));
 	CHECK_MSTATUS(plugin.deregisterCommand("fireRenderViewport"));
 	CHECK_MSTATUS(plugin.deregisterCommand("fireRenderExport"));